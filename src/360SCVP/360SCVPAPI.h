@@ -43,6 +43,7 @@ extern "C" {
 #define ID_SCVP_PARAM_SEI_NOVELVIEW        1007
 #define ID_SCVP_BITSTREAMS_HEADER          1008
 #define ID_SCVP_RWPK_INFO                  1009
+#define ID_SCVP_PARAM_VIEWPORT_CACHE       1010
 #define DEFAULT_REGION_NUM                 1000
 
 /*!
@@ -101,6 +102,12 @@ typedef enum UsageType
     E_PARSER_TYPE_NUM,
 }UsageType;
 
+typedef enum NaluCodec
+{
+    E_NALU_CODEC_HEVC = 0,
+    E_NALU_CODEC_AVC,
+}NaluCodec;
+
 /*!
 *
 *  currently the library can support five SEI types,
@@ -505,6 +512,28 @@ typedef struct PARAM_VIEWPORT_OUTPUT
     int32_t yTopLeftNet;
 }Param_ViewportOutput;
 
+//!
+//! \brief  This structure is for the quantized viewport tile selection cache,
+//!         set by ID_SCVP_PARAM_VIEWPORT_CACHE to enable the cache for one handle
+//!         and got by the same ID to query the process-wide cache statistic.
+//!         Poses falling into the same angularResolution x angularResolution
+//!         bucket share the tiles and viewport output of the first pose computed
+//!         in the bucket.
+//!
+//! \param    angularResolution,     input,     the bucket size in degree for yaw and pitch, 0 means disable the cache
+//! \param    maxEntriesNum,         input,     the maximum number of cached poses in the process, 0 means keep the current bound
+//! \param    entriesNum,            output,    the number of cached poses
+//! \param    hitsNum,               output,    the number of lookups served by the cache
+//! \param    missesNum,             output,    the number of lookups going through the exact path
+typedef struct PARAM_VIEWPORT_CACHE
+{
+    float    angularResolution;
+    uint32_t maxEntriesNum;
+    uint32_t entriesNum;
+    uint64_t hitsNum;
+    uint64_t missesNum;
+}Param_ViewportCache;
+
 //!
 //! \brief  This structure is for the view port parameters
 //!
@@ -738,6 +767,22 @@ int32_t I360SCVP_getTilesInViewport(TileDef* pOutTile, Param_ViewportOutput* pPa
 //!
 int32_t I360SCVP_ParseNAL(Nalu* pNALU, void* p360SCVPHandle);
 
+//!
+//! \brief    This function locates all NALs of the bitstream in one pass, without parsing NAL payload,
+//!           only data, dataSize, startCodesSize and naluType are filled for each NAL
+//! \param    uint8_t*  pBitstream,        input, the bitstream starting with a start code
+//! \param    uint32_t  bitstreamLen,      input, the bitstream length
+//! \param    NaluCodec codec,             input, the codec which decides the NAL header format
+//! \param    Nalu*     pNALUs,            output, NAL information array, can be NULL to only count NALs
+//! \param    uint32_t  maxNaluNum,        input, the size of pNALUs array
+//! \param    uint32_t* pNaluNum,          output, the number of NALs located
+//!
+//! \return   int32_t, the status of the function.
+//!           0,     if succeed
+//!           not 0, if fail
+//!
+int32_t I360SCVP_ScanNALUs(uint8_t* pBitstream, uint32_t bitstreamLen, NaluCodec codec, Nalu* pNALUs, uint32_t maxNaluNum, uint32_t* pNaluNum);
+
 //!
 //! \brief    geneate the new SPS bitstream, input include start code, output without startcode
 //!
@@ -33,6 +33,7 @@
 #include "360SCVPAPI.h"
 #include "360SCVPCommonDef.h"
 #include "360SCVPHevcEncHdr.h"
+#include "360SCVPNaluScanner.h"
 #include "360SCVPLog.h"
 #include "360SCVPImpl.h"
 
@@ -184,6 +185,16 @@ int32_t I360SCVP_ParseNAL(Nalu* pNALU, void* p360SCVPHandle)
     return 0;
 }
 
+int32_t I360SCVP_ScanNALUs(uint8_t* pBitstream, uint32_t bitstreamLen, NaluCodec codec, Nalu* pNALUs, uint32_t maxNaluNum, uint32_t* pNaluNum)
+{
+    if (!pBitstream || !bitstreamLen || !pNaluNum)
+        return 1;
+
+    *pNaluNum = gts_media_nalu_scan(pBitstream, bitstreamLen, codec == E_NALU_CODEC_AVC, pNALUs, maxNaluNum);
+
+    return 0;
+}
+
 int32_t I360SCVP_GenerateSPS(param_360SCVP* pParam360SCVP, void* p360SCVPHandle)
 {
     int32_t ret = 0;
@@ -341,6 +352,7 @@ int32_t I360SCVP_GetParameter(void* p360SCVPHandle, int32_t paramID, void** pVal
     Param_PicInfo* pPicInfo = NULL;
     Param_BSHeader* bsHeader = NULL;
     RegionWisePacking* pRWPK = NULL;
+    Param_ViewportCache* pViewportCache = NULL;
     switch (paramID)
     {
         case ID_SCVP_PARAM_PICINFO:
@@ -358,6 +370,10 @@ int32_t I360SCVP_GetParameter(void* p360SCVPHandle, int32_t paramID, void** pVal
             pRWPK = (RegionWisePacking *)*pValue;
             ret = pStitch->getRWPKInfo(pRWPK);
             break;
+        case ID_SCVP_PARAM_VIEWPORT_CACHE:
+            pViewportCache = (Param_ViewportCache *)*pValue;
+            ret = pStitch->getViewportCacheStatistic(pViewportCache);
+            break;
         default:
             break;
     }
@@ -376,6 +392,7 @@ int32_t I360SCVP_SetParameter(void* p360SCVPHandle, int32_t paramID, void* pValu
     FramePacking*       pFramePacking = NULL;
     OMNIViewPort*       pSeiViewport = NULL;
     NovelViewSEI*       pNovelView = NULL;
+    Param_ViewportCache* pViewportCache = NULL;
 
     int32_t             projType = 0;
     switch (paramID)
@@ -408,6 +425,10 @@ int32_t I360SCVP_SetParameter(void* p360SCVPHandle, int32_t paramID, void* pValu
         pNovelView = (NovelViewSEI*)pValue;
         ret = pStitch->setSEINovelView(pNovelView);
         break;
+    case ID_SCVP_PARAM_VIEWPORT_CACHE:
+        pViewportCache = (Param_ViewportCache*)pValue;
+        ret = pStitch->setViewportCache(pViewportCache);
+        break;
     default:
         break;
     }
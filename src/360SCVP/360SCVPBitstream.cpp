@@ -232,9 +232,74 @@ uint8_t gf_bs_read_bit(GTS_BitStream *bs)
 }
 
 
+/*loads the bytes following the current position as a big endian 64 bits cache word,
+bytes beyond the end of the buffer are read as 0*/
+static uint64_t BS_LoadCacheWord(GTS_BitStream *bs)
+{
+    const uint8_t *data = (const uint8_t *)bs->original + bs->position;
+    uint64_t word = 0;
+    if (bs->position + 8 <= bs->size) {
+#if defined(__GNUC__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        memcpy_s(&word, sizeof(uint64_t), data, sizeof(uint64_t));
+        word = __builtin_bswap64(word);
+#else
+        for (uint32_t i = 0; i < 8; i++)
+            word = (word << 8) | data[i];
+#endif
+    } else {
+        for (uint32_t i = 0; i < 8; i++) {
+            word <<= 8;
+            if (bs->position + i < bs->size)
+                word |= data[i];
+        }
+    }
+    return word;
+}
+
+/*skips bits in memory read mode, the bitstream state (position, current
+and nbBits) is left exactly as the bit by bit reader does*/
+static inline void BS_SkipBitsFast(GTS_BitStream *bs, uint32_t nBits)
+{
+    uint32_t avail = 8 - bs->nbBits;
+    if (nBits <= avail) {
+        bs->nbBits += nBits;
+        bs->current <<= nBits;
+        return;
+    }
+
+    uint32_t need = nBits - avail;
+    uint32_t nbBytes = (need + 7) >> 3;
+    bs->position += nbBytes;
+    bs->nbBits = need - ((nbBytes - 1) << 3);
+    bs->current = ((uint32_t)(uint8_t)bs->original[bs->position - 1]) << bs->nbBits;
+}
+
+/*returns the 64 bits following the current bit position in memory read mode*/
+static inline uint64_t BS_PeekCacheWord(GTS_BitStream *bs)
+{
+    uint32_t avail = 8 - bs->nbBits;
+    uint64_t word = BS_LoadCacheWord(bs);
+    if (avail)
+        word = ((uint64_t)((bs->current & 0xFF) >> bs->nbBits) << (64 - avail)) | (word >> avail);
+    return word;
+}
+
+/*checks all bytes needed to read nBits are in the buffer*/
+static inline bool BS_HasBits(GTS_BitStream *bs, uint32_t nBits)
+{
+    return bs->position + ((nBits + bs->nbBits - 1) >> 3) <= bs->size;
+}
+
 uint32_t gts_bs_read_int(GTS_BitStream *bs, uint32_t nBits)
 {
     uint32_t ret = 0;
+    /*the cache word is only used when all needed bytes are in the buffer, so that
+    the end of stream is still reported byte per byte*/
+    if ((bs->bsmode == GTS_BITSTREAM_READ) && (nBits <= 32) && nBits && BS_HasBits(bs, nBits)) {
+        ret = (uint32_t)(BS_PeekCacheWord(bs) >> (64 - nBits));
+        BS_SkipBitsFast(bs, nBits);
+        return ret;
+    }
     while (nBits-- > 0) {
         ret <<= 1;
         ret |= gf_bs_read_bit(bs);
@@ -263,16 +328,70 @@ uint64_t gts_bs_read_long_int(GTS_BitStream *bs, uint32_t nBits)
     if (nBits>64) {
         gts_bs_read_long_int(bs, nBits-64);
         ret = gts_bs_read_long_int(bs, 64);
+    } else if (nBits > 32) {
+        ret = (uint64_t)gts_bs_read_int(bs, nBits - 32) << 32;
+        ret |= gts_bs_read_int(bs, 32);
     } else {
-        while (nBits-- > 0) {
-            ret <<= 1;
-            ret |= gf_bs_read_bit(bs);
-        }
+        ret = gts_bs_read_int(bs, nBits);
     }
     return ret;
 }
 
 
+static uint8_t digits_of_agm[128] = {
+    8, 7, 6, 6, 5, 5, 5, 5,  4, 4, 4, 4, 4, 4, 4, 4,
+    3, 3, 3, 3, 3, 3, 3, 3,  3, 3, 3, 3, 3, 3, 3, 3,
+    2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2,
+    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1
+};
+
+uint32_t gts_bs_read_ue(GTS_BitStream *bs)
+{
+    uint8_t flag_c;
+    uint32_t data = 0, flag_r = 0;
+
+    /*codes up to 31 bits are decoded from the 32 bits window following the current bit*/
+    if (bs->bsmode == GTS_BITSTREAM_READ) {
+        uint32_t window = (uint32_t)(BS_PeekCacheWord(bs) >> 32);
+        if (window) {
+            uint32_t codeLen = 2 * (uint32_t)__builtin_clz(window) + 1;
+            if (codeLen < 32 && BS_HasBits(bs, codeLen)) {
+                BS_SkipBitsFast(bs, codeLen);
+                return (window >> (32 - codeLen)) - 1;
+            }
+        }
+    }
+
+    while (1) {
+        flag_r = gts_bs_peek_bits(bs, 8, 0);
+        if (flag_r) break;
+        //check whether we still have data once the peek is done since we may have less than 8 data available
+        if (!gts_bs_available(bs)) {
+            return 0;
+        }
+        gts_bs_read_int(bs, 8);
+        data += 8;
+    }
+    if (flag_r < 128)
+        flag_c = digits_of_agm[flag_r];
+    else
+        flag_c = 0;
+    gts_bs_read_int(bs, flag_c);
+    data += flag_c;
+    return gts_bs_read_int(bs, data + 1) - 1;
+}
+
+int32_t gts_bs_read_se(GTS_BitStream *bs)
+{
+    uint32_t v = gts_bs_read_ue(bs);
+    if ((v & 0x1) == 0) return (int32_t)(0 - (v >> 1));
+    return (v + 1) >> 1;
+}
+
 float bs_read_float(GTS_BitStream* bs, unsigned int precision)
 {
     seifloat var;
@@ -376,23 +495,28 @@ static void BS_WriteByte(GTS_BitStream *bs, uint8_t val)
     bs->position += 1;
 }
 
-static void BS_WriteBit(GTS_BitStream *bs, uint32_t bit)
+/*writes one completed byte, inserting the emulation prevention byte when needed*/
+static inline void BS_WriteByteEP(GTS_BitStream *bs, uint8_t val)
 {
     const uint8_t emulation_prevention_three_byte = 0x03;
 
+    if (bs->zeroCount == 2 && val < 4)
+    {
+        BS_WriteByte(bs, emulation_prevention_three_byte);
+        bs->zeroCount = 0;
+    }
+    bs->zeroCount = val == 0 ? bs->zeroCount+1 : 0;
+
+    BS_WriteByte(bs, val);
+}
+
+static void BS_WriteBit(GTS_BitStream *bs, uint32_t bit)
+{
     bs->current <<= 1;
     bs->current |= bit;
     if (++ bs->nbBits == 8) {
         bs->nbBits = 0;
-
-        if((bs->zeroCount == 2) && ((uint8_t) bs->current < 4))
-        {
-            BS_WriteByte(bs, emulation_prevention_three_byte);
-            bs->zeroCount = 0;
-        }
-        bs->zeroCount = ((uint8_t) bs->current) == 0 ? bs->zeroCount+1 : 0;
-
-        BS_WriteByte(bs, (uint8_t) bs->current);
+        BS_WriteByteEP(bs, (uint8_t) bs->current);
         bs->current = 0;
     }
 }
@@ -404,6 +528,26 @@ void gts_bs_write_int(GTS_BitStream *bs, int32_t _value, int32_t nBits)
     uint32_t value, nb_shift;
     if (!nBits) return;
     value = (uint32_t) _value;
+
+    /*pending bits and new bits are gathered in one 64 bits cache word and only
+    completed bytes are flushed, remaining bits are kept in current as before*/
+    if (nBits > 0 && nBits <= 32) {
+        uint32_t total = bs->nbBits + (uint32_t)nBits;
+        uint64_t word = ((uint64_t)bs->current << nBits) |
+            (nBits == 32 ? value : (value & ((1U << nBits) - 1)));
+        if (total < 8) {
+            bs->current = (uint32_t)word;
+            bs->nbBits = total;
+            return;
+        }
+        bs->nbBits = total & 7;
+        while (total >= 8) {
+            total -= 8;
+            BS_WriteByteEP(bs, (uint8_t)(word >> total));
+        }
+        bs->current = (uint32_t)(word & ((1U << bs->nbBits) - 1));
+        return;
+    }
     nb_shift = sizeof (int32_t) * 8 - nBits;
     if (nb_shift)
         value <<= nb_shift;
@@ -522,6 +666,32 @@ float bs_write_float(GTS_BitStream* bs, float value, unsigned int precision)
 
 }
 
+void gts_bs_write_ue(GTS_BitStream *bs, uint32_t code_num)
+{
+    uint64_t value = (uint64_t)code_num + 1;
+    uint32_t code_num_log2 = 63 - (uint32_t)__builtin_clzll(value);
+
+    /*prefix zeros, the leading one and the suffix fit in one write up to 31 bits*/
+    if (code_num_log2 < 16) {
+        gts_bs_write_int(bs, (int32_t)value, code_num_log2 * 2 + 1);
+        return;
+    }
+    gts_bs_write_int(bs, 0, code_num_log2);
+    if (code_num_log2 < 32) {
+        gts_bs_write_int(bs, (int32_t)value, code_num_log2 + 1);
+    } else {
+        gts_bs_write_int(bs, 1, 1);
+        gts_bs_write_int(bs, (int32_t)value, 32);
+    }
+}
+
+void gts_bs_write_se(GTS_BitStream *bs, int32_t data)
+{
+    // Map positive values to even and negative to odd values.
+    uint32_t code_num = data <= 0 ? (0 - (uint32_t)data) << 1 : ((uint32_t)data << 1) - 1;
+    gts_bs_write_ue(bs, code_num);
+}
+
 uint32_t gts_bs_write_data(GTS_BitStream *bs, const int8_t *data, uint32_t nbBytes)
 {
     if (!bs || !data) return 0;
@@ -707,6 +877,19 @@ uint32_t gts_bs_peek_bits(GTS_BitStream *bs, uint32_t numBits, uint64_t byte_off
     curBits = bs->nbBits;
     current = bs->current;
 
+    /*in memory mode, the state is simply restored after reading*/
+    if (bs->bsmode == GTS_BITSTREAM_READ) {
+        if (byte_offset) {
+            bs->position += byte_offset;
+            bs->nbBits = 8;
+        }
+        ret = gts_bs_read_int(bs, numBits);
+        bs->position = curPos;
+        bs->nbBits = curBits;
+        bs->current = current;
+        return ret;
+    }
+
     if (byte_offset) gts_bs_seek(bs, bs->position + byte_offset);
     ret = gts_bs_read_int(bs, numBits);
 
@@ -197,6 +197,24 @@ uint32_t gts_bs_read_int(GTS_BitStream *bs, uint32_t nBits);
  */
 uint64_t gts_bs_read_long_int(GTS_BitStream *bs, uint32_t nBits);
 
+/*!
+ *    \brief Reads an unsigned integer coded with Exp-Golomb code
+ *
+ *    \param GTS_BitStream *bs      input  the target bitstream
+ *
+ *    \return uint32_t the integer value read, 0 if not enough data.
+ */
+uint32_t gts_bs_read_ue(GTS_BitStream *bs);
+
+/*!
+ *    \brief Reads a signed integer coded with Exp-Golomb code
+ *
+ *    \param GTS_BitStream *bs      input  the target bitstream
+ *
+ *    \return int32_t the integer value read.
+ */
+int32_t gts_bs_read_se(GTS_BitStream *bs);
+
 /*!
  *    \brief Reads a data buffer
  *
@@ -258,6 +276,22 @@ uint32_t gts_bs_get_bit_position(GTS_BitStream *bs);
  */
 void gts_bs_write_int(GTS_BitStream *bs, int32_t value, int32_t nBits);
 
+/*!
+ *    \brief  Writes an unsigned integer with Exp-Golomb code.
+ *
+ *    \param GTS_BitStream *bs      input  the target bitstream
+ *    \param uint32_t code_num      input  the integer to write
+ */
+void gts_bs_write_ue(GTS_BitStream *bs, uint32_t code_num);
+
+/*!
+ *    \brief  Writes a signed integer with Exp-Golomb code.
+ *
+ *    \param GTS_BitStream *bs      input  the target bitstream
+ *    \param int32_t data           input  the integer to write
+ */
+void gts_bs_write_se(GTS_BitStream *bs, int32_t data);
+
 /*!
  *    \brief Writes a data buffer.
  *
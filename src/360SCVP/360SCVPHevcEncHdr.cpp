@@ -151,13 +151,7 @@ void hevc_bitstream_add_rbsp_trailing_bits(GTS_BitStream * const stream)
 */
 static void bitstream_put_ue(GTS_BitStream *stream, uint32_t code_num)
 {
-    uint32_t code_num_log2 = math_floor_log2(code_num + 1);
-    uint32_t prefix = 1 << code_num_log2;
-    uint32_t suffix = code_num + 1 - prefix;
-    uint32_t num_bits = code_num_log2 * 2 + 1;
-    uint32_t value = prefix | suffix;
-
-    gts_bs_write_int(stream, value, num_bits);
+    gts_bs_write_ue(stream, code_num);
 }
 
 /**
@@ -165,9 +159,7 @@ static void bitstream_put_ue(GTS_BitStream *stream, uint32_t code_num)
 */
 static void bitstream_put_se(GTS_BitStream *stream, int32_t data)
 {
-    // Map positive values to even and negative to odd values.
-    uint32_t code_num = data <= 0 ? (-data) << 1 : (data << 1) - 1;
-    bitstream_put_ue(stream, code_num);
+    gts_bs_write_se(stream, data);
 }
 
 static void hevc_write_bitstream_PTL(GTS_BitStream *stream,
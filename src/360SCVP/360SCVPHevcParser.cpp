@@ -24,7 +24,11 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "assert.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "360SCVPHevcParser.h"
+#include "360SCVPNaluScanner.h"
 #include "360SCVPHevcTilestream.h"
 
 inline uint32_t ceil_log2(uint32_t x)
@@ -44,23 +48,64 @@ template<class T> inline void set_bit(T& f, uint32_t i, bool b)
     else f &= ~mask;
 }
 
+/*finds the first 0x00 0x00 0x03 pattern whose 0x03 is at or after start,
+returns the position of the 0x03 byte or size_nal if there is none*/
+static uint32_t find_emulation_pattern(const uint8_t *buffer, uint32_t start, uint32_t size_nal)
+{
+    uint32_t n = start < 2 ? 0 : start - 2;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i three = _mm_set1_epi8(0x03);
+    while (n + 18 <= size_nal)
+    {
+        __m128i b0 = _mm_loadu_si128((const __m128i *)(buffer + n));
+        __m128i b1 = _mm_loadu_si128((const __m128i *)(buffer + n + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i *)(buffer + n + 2));
+        __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                      _mm_cmpeq_epi8(b2, three));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(match);
+        if (mask)
+            return n + 2 + (uint32_t)__builtin_ctz(mask);
+        n += 16;
+    }
+#endif
+
+    while (n + 2 < size_nal)
+    {
+        if (!buffer[n] && !buffer[n + 1] && buffer[n + 2] == 0x03)
+            return n + 2;
+        n++;
+    }
+    return size_nal;
+}
+
+/*finds the next emulation prevention byte to remove at or after start, zeros are
+counted from start, i.e. the beginning of nalu or the byte after the last removed one*/
+static uint32_t find_emulation_byte(const int8_t *buffer, uint32_t start, uint32_t size_nal)
+{
+    const uint8_t *data = (const uint8_t *)buffer;
+    uint32_t n = start;
+
+    while (1)
+    {
+        n = find_emulation_pattern(data, n, size_nal);
+        if (n + 1 >= size_nal)
+            return size_nal;
+        /*exactly two zeros are counted before 0x03, and the next byte is compared as signed*/
+        if ((n - 2 == start || data[n - 3]) && buffer[n + 1] < 0x04)
+            return n;
+        n++;
+    }
+}
+
 uint32_t gts_media_nalu_emulation_bytes_remove_count(const int8_t *buffer, uint32_t size_nal)
 {
     uint32_t n = 0, emulation_bytes_count = 0;
-    uint8_t zero_counter = 0;
 
-    while (n < size_nal)
+    while ((n = find_emulation_byte(buffer, n, size_nal)) < size_nal)
     {
-        if (zero_counter == 2 && buffer[n] == 0x03 && n + 1 < size_nal && buffer[n + 1] < 0x04)
-        {
-            zero_counter = 0;
-            emulation_bytes_count++;
-            n++;
-        }
-        if (!buffer[n])
-            zero_counter++;
-        else
-            zero_counter = 0;
+        emulation_bytes_count++;
         n++;
     }
 
@@ -70,68 +115,30 @@ uint32_t gts_media_nalu_emulation_bytes_remove_count(const int8_t *buffer, uint3
 uint32_t gts_media_nalu_remove_emulation_bytes(const int8_t *src_buffer, int8_t *dst_buffer, uint32_t size_nal)
 {
     uint32_t n = 0, emulation_bytes_count = 0;
-    uint8_t zero_counter = 0;
+
     while (n < size_nal)
     {
-        if (zero_counter == 2 && src_buffer[n] == 0x03 && n + 1 < size_nal && src_buffer[n + 1] < 0x04)
-        {
-            zero_counter = 0;
-            emulation_bytes_count++;
-            n++;
-        }
-        dst_buffer[n - emulation_bytes_count] = src_buffer[n];
-        if (!src_buffer[n])
-            zero_counter++;
-        else
-            zero_counter = 0;
-
-        n++;
+        uint32_t emulation_pos = find_emulation_byte(src_buffer, n, size_nal);
+        if (emulation_pos > n)
+            memcpy_s(dst_buffer + n - emulation_bytes_count, emulation_pos - n, src_buffer + n, emulation_pos - n);
+        if (emulation_pos == size_nal)
+            break;
+        emulation_bytes_count++;
+        n = emulation_pos + 1;
     }
 
     return size_nal - emulation_bytes_count;
 }
 
 
-static uint8_t digits_of_agm[128] = {
-    8, 7, 6, 6, 5, 5, 5, 5,  4, 4, 4, 4, 4, 4, 4, 4,
-    3, 3, 3, 3, 3, 3, 3, 3,  3, 3, 3, 3, 3, 3, 3, 3,
-    2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2,
-    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1
-};
-
 static uint32_t bs_get_ue(GTS_BitStream *gts_bitstream)
 {
-    uint8_t flag_c;
-    uint32_t data = 0, flag_r = 0;
-    while (1) {
-        flag_r = gts_bs_peek_bits(gts_bitstream, 8, 0);
-        if (flag_r) break;
-        //check whether we still have data once the peek is done since we may have less than 8 data available
-        if (!gts_bs_available(gts_bitstream)) {
-            //GF_LOG(GF_LOG_ERROR, GF_LOG_CODING, ("[AVC/HEVC] Not enough data in bitstream !!\n"));
-            return 0;
-        }
-        gts_bs_read_int(gts_bitstream, 8);
-        data += 8;
-    }
-    if (flag_r < 128)
-        flag_c = digits_of_agm[flag_r];
-    else
-        flag_c = 0;
-    gts_bs_read_int(gts_bitstream, flag_c);
-    data += flag_c;
-    return gts_bs_read_int(gts_bitstream, data + 1) - 1;
+    return gts_bs_read_ue(gts_bitstream);
 }
 
 static int32_t bs_get_se(GTS_BitStream *bs)
 {
-    uint32_t v = bs_get_ue(bs);
-    if ((v & 0x1) == 0) return (int32_t)(0 - (v >> 1));
-    return (v + 1) >> 1;
+    return gts_bs_read_se(bs);
 }
 
 uint32_t gts_media_nalu_is_start_code(GTS_BitStream *bs)
@@ -688,6 +695,18 @@ static uint32_t gts_media_nalu_locate_start_code_bs(GTS_BitStream *bs, bool loca
     uint64_t start = gts_bs_get_position(bs);
     if (start<3) return 0;
 
+    /*memory bitstream is scanned in place with the SIMD start code scanner*/
+    if (bs->bsmode == GTS_BITSTREAM_READ && bs->original && gts_bs_is_align(bs)) {
+        const uint8_t *data = (const uint8_t *)bs->original;
+        end = gts_media_nalu_find_start_code(data, bs->size, start);
+        if (locate_trailing && end == bs->size) {
+            while (nb_cons_zeros < end - start && !data[end - 1 - nb_cons_zeros]) nb_cons_zeros++;
+            if (nb_cons_zeros >= 3)
+                return (uint32_t)(end - start - nb_cons_zeros);
+        }
+        return (uint32_t)(end - start);
+    }
+
     load_size = 0;
     bpos = 0;
     cache_start = 0;
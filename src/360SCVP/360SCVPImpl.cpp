@@ -109,6 +109,10 @@ TstitchStream::TstitchStream()
     m_bNeedPlugin = false;
     m_tilesInfo = new ITileInfo[MAX_TILE_NUM];
     m_mapFaceInfo = new MapFaceInfo[6];
+    m_cacheResolution = 0;
+    m_bCacheKeyValid = false;
+    m_bViewportCached = false;
+    m_bGeometryStale = false;
 }
 
 TstitchStream::TstitchStream(TstitchStream& other)
@@ -194,6 +198,11 @@ TstitchStream::TstitchStream(TstitchStream& other)
     memcpy_s(m_tilesInfo, MAX_TILE_NUM * sizeof(ITileInfo), other.m_tilesInfo, MAX_TILE_NUM * sizeof(ITileInfo));
     m_mapFaceInfo = new MapFaceInfo[6];
     memcpy_s(m_mapFaceInfo, 6 * sizeof(int32_t), other.m_mapFaceInfo, 6 * sizeof(int32_t));
+    m_cacheResolution = other.m_cacheResolution;
+    m_cacheSignature = other.m_cacheSignature;
+    m_bCacheKeyValid = false;
+    m_bViewportCached = false;
+    m_bGeometryStale = false;
 }
 
 TstitchStream& TstitchStream::operator=(const TstitchStream& other)
@@ -291,6 +300,11 @@ TstitchStream& TstitchStream::operator=(const TstitchStream& other)
     SAFE_DELETE_ARRAY(m_mapFaceInfo);
     m_mapFaceInfo = new MapFaceInfo[6];
     memcpy_s(m_mapFaceInfo, 6 * sizeof(int32_t), other.m_mapFaceInfo, 6 * sizeof(int32_t));
+    m_cacheResolution = other.m_cacheResolution;
+    m_cacheSignature = other.m_cacheSignature;
+    m_bCacheKeyValid = false;
+    m_bViewportCached = false;
+    m_bGeometryStale = false;
 
     return *this;
 }
@@ -1210,6 +1224,9 @@ int32_t TstitchStream::getViewPortTiles()
 {
     if (!m_pViewport)
         return -1;
+    // the viewport output of the cached pose is already restored in setViewPort
+    if (m_bViewportCached)
+        return 0;
     int32_t ret = 0;
 
     for (int i = 0; i < 6; i++)
@@ -1295,7 +1312,110 @@ int32_t TstitchStream::setViewPort(HeadPose *pose)
     else if (m_bNeedPlugin)
         return SCVP_ERROR_PLUGIN_NOEXIST;
     else
+    {
+        if (isViewportCacheUsed())
+        {
+            m_cacheKey = ViewportCache::BuildKey(m_cacheSignature, m_cacheResolution, pose->yaw, pose->pitch);
+            m_bViewportCached = ViewportCache::GetInstance()->Lookup(m_cacheKey, &m_cachedEntry);
+            m_bCacheKeyValid = !m_bViewportCached;
+            m_bGeometryStale = m_bViewportCached;
+            if (m_bViewportCached)
+            {
+                m_pViewportParam.m_viewportDestWidth = m_cachedEntry.viewportDestWidth;
+                m_pViewportParam.m_viewportDestHeight = m_cachedEntry.viewportDestHeight;
+                m_pViewportParam.m_numFaces = m_cachedEntry.numFaces;
+                memcpy_s(m_pUpLeft, 6 * sizeof(point), m_cachedEntry.upLeft, 6 * sizeof(point));
+                memcpy_s(m_pDownRight, 6 * sizeof(point), m_cachedEntry.downRight, 6 * sizeof(point));
+                m_dstWidthNet = m_cachedEntry.dstWidthNet;
+                m_dstHeightNet = m_cachedEntry.dstHeightNet;
+                m_xTopLeftNet = m_cachedEntry.xTopLeftNet;
+                m_yTopLeftNet = m_cachedEntry.yTopLeftNet;
+            }
+        }
+        // the pose is always recorded so that the geometry can be calculated on demand
         return genViewport_setViewPort(m_pViewport, pose->yaw, pose->pitch);
+    }
+}
+
+bool TstitchStream::isViewportCacheUsed()
+{
+    return (m_cacheResolution > 0) && m_pViewport && !m_pTileSelection && !m_bNeedPlugin
+        && (m_usedType != E_MERGE_AND_VIEWPORT);
+}
+
+void TstitchStream::updateViewportCacheSignature()
+{
+    int32_t config[12];
+    config[0] = m_usedType;
+    config[1] = m_pViewportParam.m_usageType;
+    config[2] = m_pViewportParam.m_input_geoType;
+    config[3] = m_pViewportParam.m_output_geoType;
+    config[4] = m_pViewportParam.m_iInputWidth;
+    config[5] = m_pViewportParam.m_iInputHeight;
+    config[6] = m_pViewportParam.m_iViewportWidth;
+    config[7] = m_pViewportParam.m_iViewportHeight;
+    config[8] = (int32_t)m_pViewportParam.m_tileNumCol;
+    config[9] = (int32_t)m_pViewportParam.m_tileNumRow;
+    config[10] = m_pViewportParam.m_paramVideoFP.rows;
+    config[11] = m_pViewportParam.m_paramVideoFP.cols;
+
+    m_cacheSignature.assign((const char*)config, sizeof(config));
+    m_cacheSignature.append((const char*)&m_pViewportParam.m_viewPort_hFOV, sizeof(float));
+    m_cacheSignature.append((const char*)&m_pViewportParam.m_viewPort_vFOV, sizeof(float));
+    for (int32_t i = 0; i < m_pViewportParam.m_paramVideoFP.rows && i < 6; i++)
+    {
+        for (int32_t j = 0; j < m_pViewportParam.m_paramVideoFP.cols && j < 6; j++)
+        {
+            Param_FaceProperty *face = &(m_pViewportParam.m_paramVideoFP.faces[i][j]);
+            int32_t faceConfig[4] = { face->faceWidth, face->faceHeight, face->idFace, (int32_t)face->rotFace };
+            m_cacheSignature.append((const char*)faceConfig, sizeof(faceConfig));
+        }
+    }
+    m_bCacheKeyValid = false;
+    m_bViewportCached = false;
+    m_bGeometryStale = false;
+}
+
+int32_t TstitchStream::syncViewportGeometry()
+{
+    if (!m_bGeometryStale)
+        return 0;
+    m_bGeometryStale = false;
+
+    for (int i = 0; i < 6; i++)
+    {
+        m_pUpLeft[i].faceId = -1;
+        m_pDownRight[i].faceId = -1;
+    }
+    if (genViewport_postprocess(&m_pViewportParam, m_pViewport))
+    {
+        SCVP_LOG(LOG_ERROR, "gen viewport process error!\n");
+        return -1;
+    }
+    return 0;
+}
+
+int32_t TstitchStream::setViewportCache(Param_ViewportCache* pViewportCache)
+{
+    if (!pViewportCache || pViewportCache->angularResolution < 0)
+        return -1;
+
+    if (pViewportCache->maxEntriesNum)
+        ViewportCache::GetInstance()->SetMaxEntriesNum(pViewportCache->maxEntriesNum);
+
+    m_cacheResolution = pViewportCache->angularResolution;
+    updateViewportCacheSignature();
+    return 0;
+}
+
+int32_t TstitchStream::getViewportCacheStatistic(Param_ViewportCache* pViewportCache)
+{
+    if (!pViewportCache)
+        return -1;
+
+    ViewportCache::GetInstance()->GetStatistic(pViewportCache);
+    pViewportCache->angularResolution = m_cacheResolution;
+    return 0;
 }
 
 int32_t TstitchStream::doMerge(param_360SCVP* pParamStitchStream)
@@ -1777,6 +1897,8 @@ int32_t TstitchStream::getFixedNumTiles(TileDef* pOutTile)
     int32_t ret = 0;
     if (pOutTile == NULL)
         return -1;
+    if (syncViewportGeometry())
+        return -1;
     ret = genViewport_getFixedNumTiles(m_pViewport, pOutTile);
     m_viewportDestWidth = m_pViewportParam.m_viewportDestWidth;
     m_viewportDestHeight = m_pViewportParam.m_viewportDestHeight;
@@ -1796,11 +1918,37 @@ int32_t TstitchStream::getTilesInViewport(TileDef* pOutTile)
     }
     else if (m_bNeedPlugin)
         return SCVP_ERROR_PLUGIN_NOEXIST;
+    else if (m_bViewportCached)
+    {
+        if (m_cachedEntry.tiles.size())
+            memcpy_s(pOutTile, m_cachedEntry.tiles.size() * sizeof(TileDef), m_cachedEntry.tiles.data(), m_cachedEntry.tiles.size() * sizeof(TileDef));
+        ret = m_cachedEntry.tilesNum;
+        m_viewportDestWidth = m_cachedEntry.viewportDestWidth;
+        m_viewportDestHeight = m_cachedEntry.viewportDestHeight;
+    }
     else
     {
         ret = genViewport_getTilesInViewport(m_pViewport, pOutTile);
         m_viewportDestWidth = m_pViewportParam.m_viewportDestWidth;
         m_viewportDestHeight = m_pViewportParam.m_viewportDestHeight;
+        if (m_bCacheKeyValid && ret >= 0 && ret <= MAX_TILE_NUM)
+        {
+            ViewportCacheEntry entry;
+            entry.tiles.assign(pOutTile, pOutTile + ret);
+            entry.tilesNum = ret;
+            entry.viewportDestWidth = m_pViewportParam.m_viewportDestWidth;
+            entry.viewportDestHeight = m_pViewportParam.m_viewportDestHeight;
+            entry.dstWidthNet = m_dstWidthNet;
+            entry.dstHeightNet = m_dstHeightNet;
+            entry.xTopLeftNet = m_xTopLeftNet;
+            entry.yTopLeftNet = m_yTopLeftNet;
+            entry.numFaces = m_pViewportParam.m_numFaces;
+            memcpy_s(entry.upLeft, 6 * sizeof(point), m_pUpLeft, 6 * sizeof(point));
+            memcpy_s(entry.downRight, 6 * sizeof(point), m_pDownRight, 6 * sizeof(point));
+            entry.hasCoverage = false;
+            memset_s(&entry.coverage, sizeof(CCDef), 0);
+            ViewportCache::GetInstance()->Insert(m_cacheKey, entry);
+        }
     }
     return ret;
 }
@@ -2087,6 +2235,7 @@ int32_t TstitchStream::setViewPortInfo(Param_ViewPortInfo* pViewPortInfo)
 
     // Init the viewport library
     ret = initViewport(pViewPortInfo, pViewPortInfo->tileNumCol, pViewPortInfo->tileNumRow);
+    updateViewportCacheSignature();
     // do the process to calculate the tiles
     ret = getViewPortTiles();
     // the ret is the tile number, if there is something wrong, the ret will be less than 0
@@ -2158,7 +2307,21 @@ int32_t  TstitchStream::getContentCoverage(CCDef* pOutCC)
     int32_t ret = 0;
     if (pOutCC == NULL)
         return -1;
+    if (m_bViewportCached && m_cachedEntry.hasCoverage)
+    {
+        *pOutCC = m_cachedEntry.coverage;
+        return 0;
+    }
+    ret = syncViewportGeometry();
+    if (ret)
+        return ret;
     ret = genViewport_getContentCoverage(m_pViewport, pOutCC);
+    if (!ret && (m_bViewportCached || m_bCacheKeyValid))
+    {
+        ViewportCache::GetInstance()->UpdateCoverage(m_cacheKey, *pOutCC);
+        m_cachedEntry.coverage = *pOutCC;
+        m_cachedEntry.hasCoverage = true;
+    }
     return ret;
 }
 
@@ -29,6 +29,7 @@
 #include "../utils/data_type.h"
 #include "TileSelectionPlugins_API.h"
 #include "360SCVPViewportImpl.h"
+#include "360SCVPViewportCache.h"
 
 #define MAX_TILE_NUM 1000
 //!
@@ -158,6 +159,8 @@ public:
     TileDef* getSelectedTile();
     int32_t  getTilesByLegacyWay(TileDef* pOutTile);
     int32_t  SetLogCallBack(LogFunction logFunction);
+    int32_t  setViewportCache(Param_ViewportCache* pViewportCache);
+    int32_t  getViewportCacheStatistic(Param_ViewportCache* pViewportCache);
 
 protected:
     int32_t initMerge(param_360SCVP* pParamStitchStream, int32_t sliceSize);
@@ -165,6 +168,9 @@ protected:
     int32_t merge_partstream_into1bitstream(int32_t totalInputLen);
     int32_t ConvertTilesIdx(uint16_t tilesNum);
     int32_t initTileInfo(param_360SCVP* pParamStitchStream);
+    bool    isViewportCacheUsed();
+    void    updateViewportCacheSignature();
+    int32_t syncViewportGeometry();
 
 private:
     void* m_pluginLibHdl;
@@ -173,6 +179,15 @@ private:
     bool  m_bNeedPlugin;
     ITileInfo* m_tilesInfo;
     MapFaceInfo* m_mapFaceInfo;
+
+    // quantized viewport cache, the angular resolution 0 means disabled
+    float               m_cacheResolution;
+    std::string         m_cacheSignature;   //viewport configuration part of the cache key
+    std::string         m_cacheKey;         //cache key of the current pose
+    bool                m_bCacheKeyValid;   //current pose is computed by the exact path and can be inserted
+    bool                m_bViewportCached;  //current pose is served from the cache
+    bool                m_bGeometryStale;   //viewport geometry is not calculated for the current pose
+    ViewportCacheEntry  m_cachedEntry;
 };// END CLASS DEFINITION
 
 #endif // _360SCVP_IMPL_H_
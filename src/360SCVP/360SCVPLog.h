@@ -42,8 +42,12 @@ extern LogFunction logCallBack;
 
 #define FILE_NAME(x) (strrchr(x, '/') ? strrchr(x, '/')+1:x)
 
-#define PRINT_LOG(logLevel, source, line, fmt, args...)   \
-    logCallBack(logLevel, source, line, fmt, ##args);    \
+//levels below OMAF_LOG_MIN_LEVEL are removed at compile time
+#define PRINT_LOG(logLevel, source, line, fmt, args...)           \
+    do {                                                          \
+        if ((logLevel) >= OMAF_LOG_MIN_LEVEL)                     \
+            logCallBack(logLevel, source, line, fmt, ##args);     \
+    } while (0);                                                  \
 
 #define SCVP_LOG(logLevel, fmt, args...)                             \
     PRINT_LOG(logLevel, FILE_NAME(__FILE__), __LINE__, fmt, ##args)  \
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "360SCVPNaluScanner.h"
+
+#if GTS_NALU_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+typedef uint64_t (*NaluFindStartCodeFunc)(const uint8_t *data, uint64_t size, uint64_t start);
+
+/*pos is the first zero of 00 00 01, one more zero before it makes a 4 bytes start code*/
+static inline uint64_t nalu_start_code_begin(const uint8_t *data, uint64_t start, uint64_t pos)
+{
+    return (pos > start && !data[pos - 1]) ? pos - 1 : pos;
+}
+
+static uint64_t nalu_find_start_code_from(const uint8_t *data, uint64_t size, uint64_t start, uint64_t from)
+{
+    uint64_t i = from;
+    while (i + 2 < size) {
+        uint8_t third = data[i + 2];
+        if (third > 1) {
+            /*no start code can cover this byte*/
+            i += 3;
+        } else if (third == 1) {
+            if (!data[i] && !data[i + 1])
+                return nalu_start_code_begin(data, start, i);
+            i += 3;
+        } else {
+            i++;
+        }
+    }
+    return size;
+}
+
+uint64_t gts_media_nalu_find_start_code_c(const uint8_t *data, uint64_t size, uint64_t start)
+{
+    return nalu_find_start_code_from(data, size, start, start);
+}
+
+#if GTS_NALU_SCANNER_X86
+uint64_t gts_media_nalu_find_start_code_sse2(const uint8_t *data, uint64_t size, uint64_t start)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    uint64_t i = start;
+    /*compare 16 candidate positions at once, each needs 3 bytes*/
+    while (i + 18 <= size) {
+        __m128i b0 = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i b1 = _mm_loadu_si128((const __m128i *)(data + i + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i *)(data + i + 2));
+        __m128i hit = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                    _mm_cmpeq_epi8(b2, one));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hit);
+        if (mask)
+            return nalu_start_code_begin(data, start, i + __builtin_ctz(mask));
+        i += 16;
+    }
+    return nalu_find_start_code_from(data, size, start, i);
+}
+
+__attribute__((target("avx2")))
+uint64_t gts_media_nalu_find_start_code_avx2(const uint8_t *data, uint64_t size, uint64_t start)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    uint64_t i = start;
+    /*compare 32 candidate positions at once, each needs 3 bytes*/
+    while (i + 34 <= size) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(data + i + 1));
+        __m256i b2 = _mm256_loadu_si256((const __m256i *)(data + i + 2));
+        __m256i hit = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero), _mm256_cmpeq_epi8(b1, zero)),
+                                       _mm256_cmpeq_epi8(b2, one));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hit);
+        if (mask)
+            return nalu_start_code_begin(data, start, i + __builtin_ctz(mask));
+        i += 32;
+    }
+    return nalu_find_start_code_from(data, size, start, i);
+}
+#endif
+
+typedef struct NALU_SCANNER
+{
+    NaluFindStartCodeFunc findStartCode;
+    const char           *name;
+}NaluScanner;
+
+static NaluScanner nalu_select_scanner()
+{
+    NaluScanner scanner;
+#if GTS_NALU_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scanner.findStartCode = gts_media_nalu_find_start_code_avx2;
+        scanner.name = "avx2";
+    } else {
+        scanner.findStartCode = gts_media_nalu_find_start_code_sse2;
+        scanner.name = "sse2";
+    }
+#else
+    scanner.findStartCode = gts_media_nalu_find_start_code_c;
+    scanner.name = "c";
+#endif
+    return scanner;
+}
+
+/*selected once and thread safe, so that it can be used by any parser instance*/
+static const NaluScanner &nalu_get_scanner()
+{
+    static const NaluScanner scanner = nalu_select_scanner();
+    return scanner;
+}
+
+uint64_t gts_media_nalu_find_start_code(const uint8_t *data, uint64_t size, uint64_t start)
+{
+    if (!data || start >= size) return size;
+    return nalu_get_scanner().findStartCode(data, size, start);
+}
+
+const char *gts_media_nalu_scanner_name()
+{
+    return nalu_get_scanner().name;
+}
+
+uint32_t gts_media_nalu_scan(const uint8_t *data, uint64_t size, bool isAVC, Nalu *nalus, uint32_t maxNum)
+{
+    uint32_t num = 0;
+    if (!data || !size) return 0;
+
+    uint64_t pos = gts_media_nalu_find_start_code(data, size, 0);
+    while (pos < size) {
+        uint8_t startCodesSize = data[pos + 2] ? 3 : 4;
+        uint64_t header = pos + startCodesSize;
+        if (header >= size) break;
+
+        uint64_t next = gts_media_nalu_find_start_code(data, size, header);
+        if (nalus) {
+            if (num >= maxNum) break;
+            Nalu *nalu = &nalus[num];
+            nalu->data = (uint8_t *)data + pos;
+            nalu->dataSize = (int32_t)(next - pos);
+            nalu->startCodesSize = startCodesSize;
+            nalu->naluType = isAVC ? (data[header] & 0x1f) : ((data[header] >> 1) & 0x3f);
+            nalu->seiPayloadType = 0;
+            nalu->sliceHeaderLen = 0;
+        }
+        num++;
+        pos = next;
+    }
+    return num;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _360SCVP_NALU_SCANNER_H_
+#define _360SCVP_NALU_SCANNER_H_
+
+#include <stdint.h>
+#include "360SCVPAPI.h"
+
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define GTS_NALU_SCANNER_X86 1
+#else
+#define GTS_NALU_SCANNER_X86 0
+#endif
+
+/*!
+ *    \brief find the next 00 00 01 or 00 00 00 01 start code in the buffer
+ *
+ *    \param const uint8_t *data   input buffer
+ *    \param uint64_t       size   input size of the buffer
+ *    \param uint64_t       start  input offset where the search begins
+ *
+ *    \return uint64_t offset of the first byte of the start code, size if no start code is found
+ *
+ *    \note the best implementation for current CPU (AVX2, SSE2 or C) is selected at the first call
+ */
+uint64_t gts_media_nalu_find_start_code(const uint8_t *data, uint64_t size, uint64_t start);
+
+/*!
+ *    \brief locate all nalus in the buffer in one pass
+ *
+ *    \param const uint8_t *data     input buffer which starts with a start code
+ *    \param uint64_t       size     input size of the buffer
+ *    \param bool           isAVC    input true if nalu header is AVC one, else HEVC one
+ *    \param Nalu          *nalus    output nalus information, can be NULL to only count nalus
+ *    \param uint32_t       maxNum   input max nalus number which can be filled into nalus
+ *
+ *    \return uint32_t the number of nalus found, which is no more than maxNum if nalus is not NULL
+ */
+uint32_t gts_media_nalu_scan(const uint8_t *data, uint64_t size, bool isAVC, Nalu *nalus, uint32_t maxNum);
+
+/*!
+ *    \brief get the name of start code scanner implementation selected for current CPU
+ *
+ *    \return const char* "avx2", "sse2" or "c"
+ */
+const char *gts_media_nalu_scanner_name();
+
+/*implementations for each instruction set, exposed for test and benchmark*/
+uint64_t gts_media_nalu_find_start_code_c(const uint8_t *data, uint64_t size, uint64_t start);
+#if GTS_NALU_SCANNER_X86
+uint64_t gts_media_nalu_find_start_code_sse2(const uint8_t *data, uint64_t size, uint64_t start);
+uint64_t gts_media_nalu_find_start_code_avx2(const uint8_t *data, uint64_t size, uint64_t start);
+#endif
+
+#endif // _360SCVP_NALU_SCANNER_H_
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <math.h>
+#include "360SCVPSphereMath.h"
+
+#if GTS_SPHERE_MATH_X86
+#include <immintrin.h>
+#endif
+
+/* The float approximations follow the cephes single precision library.   *
+ * sin/cos reduce the angle to [-45, 45] degree, which is exact in degree,  *
+ * then use minimax polynomials, atan reduces the input to                  *
+ * [-tan(pi/8), tan(pi/8)]. Latitudes are got through atan of the tangent   *
+ * instead of asin of the sine, which keeps the float error bounded near    *
+ * the poles. C and AVX2 share the same steps, the AVX2 one may differ in   *
+ * the last bits as it uses FMA.                                            */
+#define SPHERE_DEG2RAD        0.0174532925199432958f
+#define SPHERE_RAD2DEG        57.295779513082320876f
+#define SPHERE_1_OVER_90      0.0111111111111111111f
+#define SPHERE_PI_2           1.57079632679489661923f
+#define SPHERE_PI_4           0.785398163397448309616f
+#define SPHERE_TAN_3PI_8      2.414213562373095f
+#define SPHERE_TAN_PI_8       0.4142135623730950f
+#define SPHERE_MIN_COS        1e-30f
+
+#define SPHERE_SIN_P0         -1.9515295891e-4f
+#define SPHERE_SIN_P1         8.3321608736e-3f
+#define SPHERE_SIN_P2         -1.6666654611e-1f
+#define SPHERE_COS_P0         2.443315711809948e-5f
+#define SPHERE_COS_P1         -1.388731625493765e-3f
+#define SPHERE_COS_P2         4.166664568298827e-2f
+#define SPHERE_ATAN_P0        8.05374449538e-2f
+#define SPHERE_ATAN_P1        -1.38776856032e-1f
+#define SPHERE_ATAN_P2        1.99777106478e-1f
+#define SPHERE_ATAN_P3        -3.33329491539e-1f
+
+/* sin and cos of the angle in degree */
+static inline void sphere_sin_cos(float x, float *sinOut, float *cosOut)
+{
+    float j = rintf(x * SPHERE_1_OVER_90);
+    int32_t quadrant = (int32_t)j;
+    float r = (x - j * 90.0f) * SPHERE_DEG2RAD;
+    float r2 = r * r;
+
+    float s = ((SPHERE_SIN_P0 * r2 + SPHERE_SIN_P1) * r2 + SPHERE_SIN_P2) * r2 * r + r;
+    float c = ((SPHERE_COS_P0 * r2 + SPHERE_COS_P1) * r2 + SPHERE_COS_P2) * r2 * r2 - 0.5f * r2 + 1.0f;
+
+    if (quadrant & 1)
+    {
+        float t = s;
+        s = c;
+        c = t;
+    }
+    *sinOut = (quadrant & 2) ? -s : s;
+    *cosOut = ((quadrant + 1) & 2) ? -c : c;
+}
+
+/* atan of the input, in radian */
+static inline float sphere_atan(float x)
+{
+    float a = fabsf(x);
+    float y = 0;
+    if (a > SPHERE_TAN_3PI_8)
+    {
+        y = SPHERE_PI_2;
+        a = -1.0f / a;
+    }
+    else if (a > SPHERE_TAN_PI_8)
+    {
+        y = SPHERE_PI_4;
+        a = (a - 1.0f) / (a + 1.0f);
+    }
+    float z = a * a;
+    y += (((SPHERE_ATAN_P0 * z + SPHERE_ATAN_P1) * z + SPHERE_ATAN_P2) * z + SPHERE_ATAN_P3) * z * a + a;
+    return (x < 0) ? -y : y;
+}
+
+void gts_sphere_polar_to_cartesian_c(SpherePointsSoA *points)
+{
+    for (int32_t i = 0; i < points->num; i++)
+    {
+        float sinThita, cosThita, sinAlpha, cosAlpha;
+        sphere_sin_cos(points->thita[i], &sinThita, &cosThita);
+        sphere_sin_cos(points->alpha[i], &sinAlpha, &cosAlpha);
+        points->x[i] = cosThita * cosAlpha;
+        points->y[i] = sinThita;
+        points->z[i] = -cosThita * sinAlpha;
+    }
+}
+
+void gts_sphere_cartesian_to_polar_c(SpherePointsSoA *points)
+{
+    for (int32_t i = 0; i < points->num; i++)
+    {
+        float x = points->x[i];
+        float y = points->y[i];
+        float z = points->z[i];
+        float alpha = sphere_atan(-z / x) * SPHERE_RAD2DEG;
+        if (x < 0)
+            alpha += 180.0f;
+        if (alpha > 180.0f)
+            alpha -= 360.0f;
+        points->thita[i] = sphere_atan(y / sqrtf(x * x + z * z)) * SPHERE_RAD2DEG;
+        points->alpha[i] = alpha;
+    }
+}
+
+void gts_sphere_sample_boundary_c(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num)
+{
+    for (int32_t i = 0; i < num; i++)
+    {
+        float sinPhi, cosPhi, sinTop, cosTop;
+        sphere_sin_cos(phi[i], &sinPhi, &cosPhi);
+        sphere_sin_cos(top[i], &sinTop, &cosTop);
+        float horz = cosPhi * fabsf(cosTop);
+        float cosThita = sqrtf(sinPhi * sinPhi + horz * horz);
+        thita[i] = sphere_atan(cosPhi * sinTop / cosThita) * SPHERE_RAD2DEG;
+        alphaOffset[i] = sphere_atan(sinPhi / fmaxf(horz, SPHERE_MIN_COS)) * SPHERE_RAD2DEG;
+    }
+}
+
+#if GTS_SPHERE_MATH_X86
+#define SPHERE_AVX2 __attribute__((target("avx2,fma")))
+
+SPHERE_AVX2
+static inline void sphere_sin_cos_avx2(__m256 x, __m256 *sinOut, __m256 *cosOut)
+{
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(SPHERE_1_OVER_90)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256i quadrant = _mm256_cvtps_epi32(j);
+    __m256 r = _mm256_mul_ps(_mm256_fnmadd_ps(j, _mm256_set1_ps(90.0f), x), _mm256_set1_ps(SPHERE_DEG2RAD));
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 s = _mm256_fmadd_ps(_mm256_set1_ps(SPHERE_SIN_P0), r2, _mm256_set1_ps(SPHERE_SIN_P1));
+    s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(SPHERE_SIN_P2));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+    __m256 c = _mm256_fmadd_ps(_mm256_set1_ps(SPHERE_COS_P0), r2, _mm256_set1_ps(SPHERE_COS_P1));
+    c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(SPHERE_COS_P2));
+    c = _mm256_fmadd_ps(_mm256_mul_ps(c, r2), r2, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2, _mm256_set1_ps(1.0f)));
+
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    *sinOut = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+    *cosOut = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+SPHERE_AVX2
+static inline __m256 sphere_atan_avx2(__m256 x)
+{
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 a = _mm256_andnot_ps(signMask, x);
+    __m256 big = _mm256_cmp_ps(a, _mm256_set1_ps(SPHERE_TAN_3PI_8), _CMP_GT_OQ);
+    __m256 middle = _mm256_andnot_ps(big, _mm256_cmp_ps(a, _mm256_set1_ps(SPHERE_TAN_PI_8), _CMP_GT_OQ));
+
+    __m256 y = _mm256_and_ps(big, _mm256_set1_ps(SPHERE_PI_2));
+    y = _mm256_blendv_ps(y, _mm256_set1_ps(SPHERE_PI_4), middle);
+    a = _mm256_blendv_ps(a, _mm256_div_ps(_mm256_sub_ps(a, one), _mm256_add_ps(a, one)), middle);
+    a = _mm256_blendv_ps(a, _mm256_div_ps(_mm256_set1_ps(-1.0f), a), big);
+
+    __m256 z = _mm256_mul_ps(a, a);
+    __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(SPHERE_ATAN_P0), z, _mm256_set1_ps(SPHERE_ATAN_P1));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(SPHERE_ATAN_P2));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(SPHERE_ATAN_P3));
+    y = _mm256_add_ps(y, _mm256_fmadd_ps(_mm256_mul_ps(p, z), a, a));
+    return _mm256_xor_ps(y, _mm256_and_ps(x, signMask));
+}
+
+SPHERE_AVX2
+void gts_sphere_polar_to_cartesian_avx2(SpherePointsSoA *points)
+{
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    int32_t i = 0;
+    for (; i + 8 <= points->num; i += 8)
+    {
+        __m256 sinThita, cosThita, sinAlpha, cosAlpha;
+        sphere_sin_cos_avx2(_mm256_loadu_ps(points->thita + i), &sinThita, &cosThita);
+        sphere_sin_cos_avx2(_mm256_loadu_ps(points->alpha + i), &sinAlpha, &cosAlpha);
+        _mm256_storeu_ps(points->x + i, _mm256_mul_ps(cosThita, cosAlpha));
+        _mm256_storeu_ps(points->y + i, sinThita);
+        _mm256_storeu_ps(points->z + i, _mm256_xor_ps(_mm256_mul_ps(cosThita, sinAlpha), signMask));
+    }
+    if (i < points->num)
+    {
+        SpherePointsSoA tail = { points->alpha + i, points->thita + i, points->x + i, points->y + i, points->z + i, points->num - i };
+        gts_sphere_polar_to_cartesian_c(&tail);
+    }
+}
+
+SPHERE_AVX2
+void gts_sphere_cartesian_to_polar_avx2(SpherePointsSoA *points)
+{
+    __m256 rad2deg = _mm256_set1_ps(SPHERE_RAD2DEG);
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 halfCircle = _mm256_set1_ps(180.0f);
+    int32_t i = 0;
+    for (; i + 8 <= points->num; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(points->x + i);
+        __m256 y = _mm256_loadu_ps(points->y + i);
+        __m256 z = _mm256_loadu_ps(points->z + i);
+        __m256 alpha = _mm256_mul_ps(sphere_atan_avx2(_mm256_div_ps(_mm256_xor_ps(z, signMask), x)), rad2deg);
+        alpha = _mm256_add_ps(alpha, _mm256_and_ps(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), halfCircle));
+        alpha = _mm256_sub_ps(alpha, _mm256_and_ps(_mm256_cmp_ps(alpha, halfCircle, _CMP_GT_OQ), _mm256_set1_ps(360.0f)));
+        __m256 horz = _mm256_sqrt_ps(_mm256_fmadd_ps(x, x, _mm256_mul_ps(z, z)));
+        _mm256_storeu_ps(points->thita + i, _mm256_mul_ps(sphere_atan_avx2(_mm256_div_ps(y, horz)), rad2deg));
+        _mm256_storeu_ps(points->alpha + i, alpha);
+    }
+    if (i < points->num)
+    {
+        SpherePointsSoA tail = { points->alpha + i, points->thita + i, points->x + i, points->y + i, points->z + i, points->num - i };
+        gts_sphere_cartesian_to_polar_c(&tail);
+    }
+}
+
+SPHERE_AVX2
+void gts_sphere_sample_boundary_avx2(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num)
+{
+    __m256 rad2deg = _mm256_set1_ps(SPHERE_RAD2DEG);
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    int32_t i = 0;
+    for (; i + 8 <= num; i += 8)
+    {
+        __m256 sinPhi, cosPhi, sinTop, cosTop;
+        sphere_sin_cos_avx2(_mm256_loadu_ps(phi + i), &sinPhi, &cosPhi);
+        sphere_sin_cos_avx2(_mm256_loadu_ps(top + i), &sinTop, &cosTop);
+        __m256 horz = _mm256_mul_ps(cosPhi, _mm256_andnot_ps(signMask, cosTop));
+        __m256 cosThita = _mm256_sqrt_ps(_mm256_fmadd_ps(sinPhi, sinPhi, _mm256_mul_ps(horz, horz)));
+        __m256 pointThita = sphere_atan_avx2(_mm256_div_ps(_mm256_mul_ps(cosPhi, sinTop), cosThita));
+        __m256 offset = sphere_atan_avx2(_mm256_div_ps(sinPhi, _mm256_max_ps(horz, _mm256_set1_ps(SPHERE_MIN_COS))));
+        _mm256_storeu_ps(thita + i, _mm256_mul_ps(pointThita, rad2deg));
+        _mm256_storeu_ps(alphaOffset + i, _mm256_mul_ps(offset, rad2deg));
+    }
+    if (i < num)
+        gts_sphere_sample_boundary_c(phi + i, top + i, thita + i, alphaOffset + i, num - i);
+}
+#endif
+
+typedef struct SPHERE_MATH_IMPL
+{
+    void (*polarToCartesian)(SpherePointsSoA *points);
+    void (*cartesianToPolar)(SpherePointsSoA *points);
+    void (*sampleBoundary)(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num);
+    const char *name;
+}SphereMathImpl;
+
+static SphereMathImpl sphere_math_select_impl()
+{
+    SphereMathImpl impl;
+    impl.polarToCartesian = gts_sphere_polar_to_cartesian_c;
+    impl.cartesianToPolar = gts_sphere_cartesian_to_polar_c;
+    impl.sampleBoundary = gts_sphere_sample_boundary_c;
+    impl.name = "c";
+#if GTS_SPHERE_MATH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        impl.polarToCartesian = gts_sphere_polar_to_cartesian_avx2;
+        impl.cartesianToPolar = gts_sphere_cartesian_to_polar_avx2;
+        impl.sampleBoundary = gts_sphere_sample_boundary_avx2;
+        impl.name = "avx2";
+    }
+#endif
+    return impl;
+}
+
+/*selected once and thread safe, so that it can be used by any viewport instance*/
+static const SphereMathImpl &sphere_math_get_impl()
+{
+    static const SphereMathImpl impl = sphere_math_select_impl();
+    return impl;
+}
+
+void gts_sphere_polar_to_cartesian(SpherePointsSoA *points)
+{
+    if (!points || points->num <= 0) return;
+    sphere_math_get_impl().polarToCartesian(points);
+}
+
+void gts_sphere_cartesian_to_polar(SpherePointsSoA *points)
+{
+    if (!points || points->num <= 0) return;
+    sphere_math_get_impl().cartesianToPolar(points);
+}
+
+void gts_sphere_sample_boundary(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num)
+{
+    if (!phi || !top || !thita || !alphaOffset || num <= 0) return;
+    sphere_math_get_impl().sampleBoundary(phi, top, thita, alphaOffset, num);
+}
+
+const char *gts_sphere_math_name()
+{
+    return sphere_math_get_impl().name;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _360SCVP_SPHERE_MATH_H_
+#define _360SCVP_SPHERE_MATH_H_
+
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GTS_SPHERE_MATH_X86 1
+#else
+#define GTS_SPHERE_MATH_X86 0
+#endif
+
+/*!
+ *    \brief structure of arrays for a batch of sphere points, all angles are in degree
+ *
+ *    \param float   *alpha   longitude (yaw) of the points
+ *    \param float   *thita   latitude (pitch) of the points
+ *    \param float   *x       Cartesian x of the points on the unit sphere
+ *    \param float   *y       Cartesian y of the points on the unit sphere
+ *    \param float   *z       Cartesian z of the points on the unit sphere
+ *    \param int32_t  num     number of the points
+ */
+typedef struct SPHERE_POINTS_SOA
+{
+    float   *alpha;
+    float   *thita;
+    float   *x;
+    float   *y;
+    float   *z;
+    int32_t  num;
+}SpherePointsSoA;
+
+/*!
+ *    \brief the absolute error bound of the float approximations in degree,
+ *           which holds for angles within [-720, 720] degree, including the
+ *           latitudes close to the poles
+ */
+#define GTS_SPHERE_MATH_MAX_ERROR_DEGREE 1e-4
+
+/*!
+ *    \brief convert the points from polar to Cartesian coordinates
+ *           x = cos(thita) * cos(alpha), y = sin(thita), z = -cos(thita) * sin(alpha)
+ *
+ *    \param SpherePointsSoA *points  input alpha and thita, output x, y and z
+ *
+ *    \note the best implementation for current CPU (AVX2 or C) is selected at the first call
+ */
+void gts_sphere_polar_to_cartesian(SpherePointsSoA *points);
+
+/*!
+ *    \brief convert the points from Cartesian to polar coordinates
+ *           thita = asin(y / |p|) got as atan(y / sqrt(x^2 + z^2)), alpha = atan(-z / x), plus 180 when x < 0, clamped into [-180, 180]
+ *
+ *    \param SpherePointsSoA *points  input x, y and z, output alpha and thita
+ */
+void gts_sphere_cartesian_to_polar(SpherePointsSoA *points);
+
+/*!
+ *    \brief sample the points on a viewport boundary great circle
+ *           thita = asin(cos(phi) * sin(top)), alphaOffset = asin(min(1, sin(phi) / cos(thita))),
+ *           both got through atan of the tangent as cos(thita)^2 = sin(phi)^2 + (cos(phi) * cos(top))^2
+ *
+ *    \param const float *phi          input half open angle between the point and the circle top point
+ *    \param const float *top          input latitude of the circle top point
+ *    \param float       *thita        output latitude of the point
+ *    \param float       *alphaOffset  output longitude offset of the point to the circle top point
+ *    \param int32_t      num          input number of the points
+ */
+void gts_sphere_sample_boundary(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num);
+
+/*!
+ *    \brief get the name of sphere math implementation selected for current CPU
+ *
+ *    \return const char* "avx2" or "c"
+ */
+const char *gts_sphere_math_name();
+
+/*implementations for each instruction set, exposed for test and benchmark*/
+void gts_sphere_polar_to_cartesian_c(SpherePointsSoA *points);
+void gts_sphere_cartesian_to_polar_c(SpherePointsSoA *points);
+void gts_sphere_sample_boundary_c(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num);
+#if GTS_SPHERE_MATH_X86
+void gts_sphere_polar_to_cartesian_avx2(SpherePointsSoA *points);
+void gts_sphere_cartesian_to_polar_avx2(SpherePointsSoA *points);
+void gts_sphere_sample_boundary_avx2(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num);
+#endif
+
+#endif // _360SCVP_SPHERE_MATH_H_
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <math.h>
+#include "360SCVPViewportCache.h"
+
+ViewportCache::ViewportCache()
+{
+    m_maxEntriesNum = VIEWPORT_CACHE_DEFAULT_ENTRIES;
+    m_hitsNum = 0;
+    m_missesNum = 0;
+}
+
+ViewportCache* ViewportCache::GetInstance()
+{
+    static ViewportCache instance;
+    return &instance;
+}
+
+std::string ViewportCache::BuildKey(const std::string &signature, float angularResolution, float yaw, float pitch)
+{
+    int32_t quantized[2];
+    quantized[0] = (int32_t)floorf(yaw / angularResolution + 0.5f);
+    quantized[1] = (int32_t)floorf(pitch / angularResolution + 0.5f);
+
+    std::string key(signature);
+    key.append((const char*)&angularResolution, sizeof(angularResolution));
+    key.append((const char*)quantized, sizeof(quantized));
+    return key;
+}
+
+void ViewportCache::SetMaxEntriesNum(uint32_t maxEntriesNum)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxEntriesNum = maxEntriesNum;
+    EvictLocked();
+}
+
+bool ViewportCache::Lookup(const std::string &key, ViewportCacheEntry *pEntry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+    {
+        m_missesNum++;
+        return false;
+    }
+    m_hitsNum++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    *pEntry = it->second->second;
+    return true;
+}
+
+void ViewportCache::Insert(const std::string &key, const ViewportCacheEntry &entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        it->second->second = entry;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+    if (!m_maxEntriesNum)
+        return;
+    m_entries.push_front(std::make_pair(key, entry));
+    m_index[key] = m_entries.begin();
+    EvictLocked();
+}
+
+void ViewportCache::UpdateCoverage(const std::string &key, const CCDef &coverage)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return;
+    it->second->second.coverage = coverage;
+    it->second->second.hasCoverage = true;
+}
+
+void ViewportCache::GetStatistic(Param_ViewportCache *pStatistic)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    pStatistic->maxEntriesNum = m_maxEntriesNum;
+    pStatistic->entriesNum = (uint32_t)m_entries.size();
+    pStatistic->hitsNum = m_hitsNum;
+    pStatistic->missesNum = m_missesNum;
+}
+
+void ViewportCache::EvictLocked()
+{
+    while (m_entries.size() > m_maxEntriesNum)
+    {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _360SCVP_VIEWPORT_CACHE_H_
+#define _360SCVP_VIEWPORT_CACHE_H_
+
+#include <stdint.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "360SCVPAPI.h"
+#include "360SCVPViewportAPI.h"
+
+#define VIEWPORT_CACHE_DEFAULT_ENTRIES 4096
+
+//!
+//! \struct: ViewportCacheEntry
+//! \brief:  the tile selection result of one quantized viewport,
+//!          including the selected tiles, the viewport output and
+//!          the face boundary points written back to the viewport
+//!          parameters, the content coverage is filled lazily
+//!
+typedef struct ViewportCacheEntry
+{
+    std::vector<TileDef> tiles;
+    int32_t  tilesNum;
+    int32_t  viewportDestWidth;
+    int32_t  viewportDestHeight;
+    int32_t  dstWidthNet;
+    int32_t  dstHeightNet;
+    int32_t  xTopLeftNet;
+    int32_t  yTopLeftNet;
+    int32_t  numFaces;
+    point    upLeft[6];
+    point    downRight[6];
+    bool     hasCoverage;
+    CCDef    coverage;
+}ViewportCacheEntry;
+
+//!
+//! \class:  ViewportCache
+//! \brief:  process-wide LRU cache of tile selection results, keyed by
+//!          the viewport configuration signature and the quantized pose,
+//!          so handles created with the same configuration share it
+//!
+class ViewportCache
+{
+public:
+    static ViewportCache* GetInstance();
+
+    //!
+    //! \brief  build the lookup key from the configuration signature
+    //!         and the pose quantized by the angular resolution
+    //!
+    static std::string BuildKey(const std::string &signature, float angularResolution, float yaw, float pitch);
+
+    //!
+    //! \brief  set the maximum entries number, the least recently
+    //!         used entries are evicted when the bound is lowered
+    //!
+    void SetMaxEntriesNum(uint32_t maxEntriesNum);
+
+    //!
+    //! \brief  copy the entry for the key into pEntry
+    //!
+    //! \return bool, true if the key is cached
+    //!
+    bool Lookup(const std::string &key, ViewportCacheEntry *pEntry);
+
+    void Insert(const std::string &key, const ViewportCacheEntry &entry);
+
+    //!
+    //! \brief  attach the content coverage to an existing entry
+    //!
+    void UpdateCoverage(const std::string &key, const CCDef &coverage);
+
+    void GetStatistic(Param_ViewportCache *pStatistic);
+
+private:
+    ViewportCache();
+    ViewportCache(const ViewportCache&);
+    ViewportCache& operator=(const ViewportCache&);
+
+    void EvictLocked();
+
+    typedef std::list<std::pair<std::string, ViewportCacheEntry>> EntryList;
+
+    std::mutex                                              m_mutex;
+    EntryList                                               m_entries;   //most recently used at front
+    std::unordered_map<std::string, EntryList::iterator>    m_index;
+    uint32_t                                                m_maxEntriesNum;
+    uint64_t                                                m_hitsNum;
+    uint64_t                                                m_missesNum;
+};
+
+#endif // _360SCVP_VIEWPORT_CACHE_H_
@@ -37,6 +37,7 @@
 #include "360SCVPViewPort.h"
 #include "360SCVPViewportImpl.h"
 #include "360SCVPViewportAPI.h"
+#include "360SCVPSphereMath.h"
 #include "360SCVPLog.h"
 
 #ifdef WIN32
@@ -729,6 +730,10 @@ TgenViewport::TgenViewport()
     m_srd = NULL;
     m_pViewportHorizontalBoundaryPoints = NULL;
     m_pViewportVerticalBoundaryPoints = NULL;
+    m_boundaryFOVH = -1;
+    m_boundaryFOVV = -1;
+    m_vertBoundaryPointsNum = 0;
+    m_horzBoundaryPointsNum = 0;
     m_paramVideoFP.cols = 0;
     m_paramVideoFP.rows = 0;
 }
@@ -757,6 +762,10 @@ TgenViewport::TgenViewport(TgenViewport& src)
     m_srd = NULL;
     m_pViewportHorizontalBoundaryPoints = NULL;
     m_pViewportVerticalBoundaryPoints = NULL;
+    m_boundaryFOVH = -1;
+    m_boundaryFOVV = -1;
+    m_vertBoundaryPointsNum = 0;
+    m_horzBoundaryPointsNum = 0;
     m_paramVideoFP.cols = src.m_paramVideoFP.cols;
     m_paramVideoFP.rows = src.m_paramVideoFP.rows;
 }
@@ -804,7 +813,7 @@ int32_t TgenViewport::create(uint32_t tileNumRow, uint32_t tileNumCol)
     m_tileNumCol = tileNumCol;
     if (!m_srd)
     {
-        m_srd = new ITileInfo[FACE_NUMBER*m_tileNumRow*m_tileNumCol];
+        m_srd = new ITileInfo[FACE_NUMBER*m_tileNumRow*m_tileNumCol]();
         if (!m_srd)
             return -1;
     }
@@ -952,7 +961,6 @@ static float clampAngle(float angleIn, float minDegree, float maxDegree)
 int32_t TgenViewport::CubemapCalcTilesGrid()
 {
     uint32_t i, j, face;
-    POSType x, y, z;
     POSType pu, pv;
     ITileInfo* pTileGridCMP = m_srd;
 
@@ -1001,75 +1009,49 @@ int32_t TgenViewport::CubemapCalcTilesGrid()
             pTileGrid->z = -1.0;
         }
     }
-    pTileGrid = gridPoint3D;
+
+    /* Convert all grid points to polar coordinates in batch, the tile *
+     * corners below are read with a row stride of m_tileNumRow + 1,   *
+     * so pad the points to cover the farthest one                     */
+    int32_t planeSize = (m_tileNumRow + 1) * (m_tileNumCol + 1);
+    int32_t pointsNum = FACE_NUMBER * planeSize;
+    int32_t lastIdx = (FACE_NUMBER - 1) * planeSize + (m_tileNumRow - 1) * (m_tileNumRow + 1) + 2 * m_tileNumCol + 1;
+    int32_t paddedNum = (lastIdx + 1 > pointsNum) ? (lastIdx + 1) : pointsNum;
+    std::vector<float> gridAlpha(paddedNum), gridThita(paddedNum), gridX(paddedNum), gridY(paddedNum), gridZ(paddedNum);
+    for (int32_t idx = 0; idx < pointsNum; idx++) {
+        gridX[idx] = gridPoint3D[idx].x;
+        gridY[idx] = gridPoint3D[idx].y;
+        gridZ[idx] = gridPoint3D[idx].z;
+    }
+    SpherePointsSoA gridPoints = { gridAlpha.data(), gridThita.data(), gridX.data(), gridY.data(), gridZ.data(), paddedNum };
+    gts_sphere_cartesian_to_polar(&gridPoints);
+
     pTileGridCMP = m_srd;
     for (face = 0; face < FACE_NUMBER; face++)
         for (i = 0; i < m_tileNumRow; i++)
             for (j = 0; j < m_tileNumCol; j++) {
-                pTileGrid = &gridPoint3D[face * (m_tileNumRow + 1) * (m_tileNumCol + 1) + i * (m_tileNumRow + 1) + j];
-                x = pTileGrid->x;
-                y = pTileGrid->y;
-                z = pTileGrid->z;
-                pTileGridCMP->vertPos = HALF_PI_IN_DEGREE * sasin(y / ssqrt(x * x + y * y + z * z))/ S_PI_2;
-                pTileGridCMP->horzPos = HALF_PI_IN_DEGREE * satan(-z / x) / S_PI_2;
-                if (x < 0)
-                    pTileGridCMP->horzPos += PI_IN_DEGREE;
-                pTileGridCMP->horzPos = clampAngle(pTileGridCMP->horzPos, -180, 180);
-
-                pTileGrid++;
-                x = pTileGrid->x;
-                y = pTileGrid->y;
-                z = pTileGrid->z;
-                pTileGridCMP->vertPosTopRight = HALF_PI_IN_DEGREE * sasin(y / ssqrt(x * x + y * y + z * z)) / S_PI_2;
-                pTileGridCMP->horzPosTopRight = HALF_PI_IN_DEGREE * satan(-z / x) / S_PI_2;
-                if (x < 0)
-                    pTileGridCMP->horzPosTopRight += PI_IN_DEGREE;
-                pTileGridCMP->horzPosTopRight = clampAngle(pTileGridCMP->horzPosTopRight, -180, 180);
-
-                pTileGrid += m_tileNumCol;
-                x = pTileGrid->x;
-                y = pTileGrid->y;
-                z = pTileGrid->z;
-                pTileGridCMP->vertPosBottomLeft = HALF_PI_IN_DEGREE * sasin(y / ssqrt(x * x + y * y + z * z)) / S_PI_2;
-                pTileGridCMP->horzPosBottomLeft = HALF_PI_IN_DEGREE * satan(-z / x) / S_PI_2;
-                if (x < 0)
-                    pTileGridCMP->horzPosBottomLeft += PI_IN_DEGREE;
-                pTileGridCMP->horzPosBottomLeft = clampAngle(pTileGridCMP->horzPosBottomLeft, -180, 180);
-
-                pTileGrid++;
-                x = pTileGrid->x;
-                y = pTileGrid->y;
-                z = pTileGrid->z;
-                pTileGridCMP->vertPosBottomRight = HALF_PI_IN_DEGREE * sasin(y / ssqrt(x * x + y * y + z * z)) / S_PI_2;
-                pTileGridCMP->horzPosBottomRight = HALF_PI_IN_DEGREE * satan(-z / x) / S_PI_2;
-                if (x < 0)
-                    pTileGridCMP->horzPosBottomRight += PI_IN_DEGREE;
-                pTileGridCMP->horzPosBottomRight = clampAngle(pTileGridCMP->horzPosBottomRight, -180, 180);
-
-                pTileGrid -= m_tileNumCol + 2;
+                int32_t idx = face * planeSize + i * (m_tileNumRow + 1) + j;
+                pTileGridCMP->vertPos = gridThita[idx];
+                pTileGridCMP->horzPos = gridAlpha[idx];
+
+                idx++;
+                pTileGridCMP->vertPosTopRight = gridThita[idx];
+                pTileGridCMP->horzPosTopRight = gridAlpha[idx];
+
+                idx += m_tileNumCol;
+                pTileGridCMP->vertPosBottomLeft = gridThita[idx];
+                pTileGridCMP->horzPosBottomLeft = gridAlpha[idx];
+
+                idx++;
+                pTileGridCMP->vertPosBottomRight = gridThita[idx];
+                pTileGridCMP->horzPosBottomRight = gridAlpha[idx];
+
                 pTileGridCMP++;
             }
     SAFE_DELETE_ARRAY(gridPoint3D);
     return 0;
 }
 
-double TgenViewport::calculateLongitudeFromThita(double Latti, double phi, double maxLongiOffset) //Latti is the point lattitude we're interested
-{
-    double longi = 0;
-    if (fabs(Latti) < 90 - phi)
-        longi = sasin(ssin(DEG2RAD_FACTOR * phi) / scos(DEG2RAD_FACTOR * Latti)) * RAD2DEG_FACTOR;
-    else
-        longi = maxLongiOffset;
-    return longi;
-}
-
-double TgenViewport::calculateLattitudeFromPhi(double phi, double pitch) //pitch is the top point lattitude
-{
-    double latti = 0;
-    latti = sasin(ssin(DEG2RAD_FACTOR * pitch) * scos(DEG2RAD_FACTOR * phi)) * RAD2DEG_FACTOR;
-    return latti;
-}
-
 double TgenViewport::calculateLatti(double pitch, double hFOV) //pitch is the top point lattitude when yaw=pitch=0
 {
     double fDen, fNum;
@@ -1135,13 +1117,74 @@ int32_t TgenViewport::ERPselectTilesInsideOnOneRow(ITileInfo *pTileInfo, int32_t
 }
 
 
+int32_t TgenViewport::CalculateBoundaryPhi(float hFOV, float vFOV)
+{
+    std::vector<float> vertPhi, vertOffset, horzPhi, horzOffset;
+
+    /* Vertical boundary, the top and the bottom ones share the same points */
+    for (double offsetAngle = hFOV / 2; offsetAngle >= 0; offsetAngle -= VERT_BOUNDING_STEP) {
+        /* Suppose hFOV is offsetAngle*2, then calculate the crosspoint of the great circles */
+        /* Calculate the topLeft point lattitude when yaw=pitch=0 */
+        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
+        /* Phi is half of the open angle of the topLeft/topRight point with the sphere center, which won't change under different pitch/yaw */
+        vertPhi.push_back(sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR);
+        vertOffset.push_back(offsetAngle);
+    }
+    for (double offsetAngle = -VERT_BOUNDING_STEP; offsetAngle >= -hFOV/2; offsetAngle -= VERT_BOUNDING_STEP) {
+        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
+        vertPhi.push_back(sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR);
+        vertOffset.push_back(offsetAngle);
+    }
+
+    /* Horizontal boundary, the right and the left ones share the same points */
+    for (double offsetAngle = vFOV / 2; offsetAngle >= -vFOV / 2; offsetAngle -= HORZ_BOUNDING_STEP) {
+        double instantThita = calculateLatti(offsetAngle, hFOV);
+        double instantPhi;
+        if (fabs(offsetAngle) <= 1e-9)
+            instantPhi = hFOV / 2;
+        else
+            instantPhi = sacos(ssin(instantThita * DEG2RAD_FACTOR) / ssin((fabs(offsetAngle)) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
+        horzPhi.push_back(instantPhi);
+        horzOffset.push_back(offsetAngle);
+    }
+
+    if (vertPhi.size() > (uint32_t)(ERP_HORZ_ANGLE / VERT_BOUNDING_STEP + 1) || horzPhi.size() > (uint32_t)(ERP_VERT_ANGLE / HORZ_BOUNDING_STEP + 1)) {
+        SCVP_LOG(LOG_ERROR, "Invalid viewport FOV %f x %f\n", hFOV, vFOV);
+        return ERROR_INVALID;
+    }
+
+    /* Points are laid out as top, bottom, right and left boundary */
+    m_vertBoundaryPointsNum = vertPhi.size();
+    m_horzBoundaryPointsNum = horzPhi.size();
+    m_boundaryPhi.clear();
+    m_boundaryOffset.clear();
+    for (int32_t i = 0; i < 2; i++) {
+        m_boundaryPhi.insert(m_boundaryPhi.end(), vertPhi.begin(), vertPhi.end());
+        m_boundaryOffset.insert(m_boundaryOffset.end(), vertOffset.begin(), vertOffset.end());
+    }
+    for (int32_t i = 0; i < 2; i++) {
+        m_boundaryPhi.insert(m_boundaryPhi.end(), horzPhi.begin(), horzPhi.end());
+        m_boundaryOffset.insert(m_boundaryOffset.end(), horzOffset.begin(), horzOffset.end());
+    }
+
+    uint32_t pointsNum = m_boundaryPhi.size();
+    m_boundaryTop.resize(pointsNum);
+    m_boundaryAlpha.resize(pointsNum);
+    m_boundaryThita.resize(pointsNum);
+    m_boundaryAlphaOffset.resize(pointsNum);
+    m_boundaryX.resize(pointsNum);
+    m_boundaryY.resize(pointsNum);
+    m_boundaryZ.resize(pointsNum);
+    m_boundaryFOVH = hFOV;
+    m_boundaryFOVV = vFOV;
+    return ERROR_NONE;
+}
+
 int32_t TgenViewport::CalculateViewportBoundaryPoints()
 {
     double fYaw = m_codingSVideoInfo.viewPort.fYaw;
     double fPitch = m_codingSVideoInfo.viewPort.fPitch;
     double vFOV = m_codingSVideoInfo.viewPort.vFOV;
-    double hFOV = m_codingSVideoInfo.viewPort.hFOV;
-    std::list<SpherePoint> referencePoints;
 
     SCVP_LOG(LOG_INFO, "Yaw is %f and Pitch is %f\n", fYaw, fPitch);
 
@@ -1149,168 +1192,73 @@ int32_t TgenViewport::CalculateViewportBoundaryPoints()
     double dResult;
     clock_t lBefore = clock();
 
-    /* Get viewport vertical boundary points */
-    SpherePoint* pVertBoundaryPoint = m_pViewportVerticalBoundaryPoints;
-    /* Top Boundary */
-    for (double offsetAngle = hFOV / 2; offsetAngle >= 0; offsetAngle -= VERT_BOUNDING_STEP) {
-        /* Suppose hFOV is offsetAngle*2, then calculate the crosspoint of the great circles */
-        /* Calculate the topLeft point lattitude when yaw=pitch=0 */
-        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
-        /* Phi is half of the open angle of the topLeft/topRight point with the sphere center, which won't change under different pitch/yaw */
-        double phi = sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR;
-        /* Calculate the topLeft/topRight point position with current pitch */
-        pVertBoundaryPoint->thita = sasin(scos(phi * DEG2RAD_FACTOR) * ssin((fPitch + vFOV / 2) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        double tempValue = ssin(phi * DEG2RAD_FACTOR) / scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        if (tempValue > 1)
-            tempValue = 1;
-        else if (tempValue < -1)
-            tempValue = -1;
-        tempValue = fabs(sasin(tempValue)) * RAD2DEG_FACTOR;
-        if (fPitch + vFOV / 2 < ERP_VERT_ANGLE / 2)
-            pVertBoundaryPoint->alpha = fYaw - tempValue;
-        else
-            pVertBoundaryPoint->alpha = clampAngle(fYaw - (ERP_HORZ_ANGLE / 2 - tempValue), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        pVertBoundaryPoint++;
-    }
-    for (double offsetAngle = -VERT_BOUNDING_STEP; offsetAngle >= -hFOV/2; offsetAngle -= VERT_BOUNDING_STEP) {
-        /* Suppose hFOV is offsetAngle*2, then calculate the crosspoint of the great circles */
-        /* Calculate the topLeft point lattitude when yaw=pitch=0 */
-        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
-        /* Phi is half of the open angle of the topLeft/topRight point with the sphere center, which won't change under different pitch/yaw */
-        double phi = sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR;
-        /* Calculate the topLeft/topRight point position with current pitch */
-        pVertBoundaryPoint->thita = sasin(scos(phi * DEG2RAD_FACTOR) * ssin((fPitch + vFOV / 2) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        double tempValue = ssin(phi * DEG2RAD_FACTOR) / scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        if (tempValue > 1)
-            tempValue = 1;
-        else if (tempValue < -1)
-            tempValue = -1;
-        tempValue = fabs(sasin(tempValue)) * RAD2DEG_FACTOR;
-        if (fPitch + vFOV / 2 < ERP_VERT_ANGLE / 2)
-            pVertBoundaryPoint->alpha = fYaw + tempValue;
-        else
-            pVertBoundaryPoint->alpha = clampAngle(fYaw + (ERP_HORZ_ANGLE / 2 - tempValue), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        pVertBoundaryPoint++;
+    if (m_codingSVideoInfo.viewPort.hFOV != m_boundaryFOVH || m_codingSVideoInfo.viewPort.vFOV != m_boundaryFOVV) {
+        int32_t ret = CalculateBoundaryPhi(m_codingSVideoInfo.viewPort.hFOV, m_codingSVideoInfo.viewPort.vFOV);
+        if (ret != ERROR_NONE)
+            return ret;
     }
 
-    /* Bottom Boundary */
-    for (double offsetAngle = hFOV / 2; offsetAngle >= 0; offsetAngle -= VERT_BOUNDING_STEP) {
-        /* Suppose hFOV is offsetAngle*2, then calculate the crosspoint of the great circles */
-        /* Calculate the topLeft point lattitude when yaw=pitch=0 */
-        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
-        /* Phi is half of the open angle of the topLeft/topRight point with the sphere center, which won't change under different pitch/yaw */
-        double phi = sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR;
-        /* Calculate the topLeft/topRight point position with current pitch */
-        pVertBoundaryPoint->thita = sasin(scos(phi * DEG2RAD_FACTOR) * ssin((fPitch - vFOV / 2) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        double tempValue = ssin(phi * DEG2RAD_FACTOR) / scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        if (tempValue > 1)
-            tempValue = 1;
-        else if (tempValue < -1)
-            tempValue = -1;
-        tempValue = fabs(sasin(tempValue)) * RAD2DEG_FACTOR;
-        if (fPitch - vFOV / 2 > -ERP_VERT_ANGLE / 2)
-            pVertBoundaryPoint->alpha = fYaw - tempValue;
-        else
-            pVertBoundaryPoint->alpha = clampAngle(fYaw - (ERP_HORZ_ANGLE / 2 - tempValue), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
+    int32_t vertNum = m_vertBoundaryPointsNum;
+    int32_t horzNum = m_horzBoundaryPointsNum;
+    int32_t pointsNum = 2 * (vertNum + horzNum);
 
-        pVertBoundaryPoint++;
+    /* Top point lattitude of the great circle which each boundary point is on */
+    for (int32_t i = 0; i < vertNum; i++) {
+        m_boundaryTop[i] = fPitch + vFOV / 2;
+        m_boundaryTop[vertNum + i] = fPitch - vFOV / 2;
     }
-    for (double offsetAngle = -VERT_BOUNDING_STEP; offsetAngle >= -hFOV/2; offsetAngle -= VERT_BOUNDING_STEP) {
-        /* Suppose hFOV is offsetAngle*2, then calculate the crosspoint of the great circles */
-        /* Calculate the topLeft point lattitude when yaw=pitch=0 */
-        double thita = calculateLatti(vFOV / 2, offsetAngle * 2);
-        /* Phi is half of the open angle of the topLeft/topRight point with the sphere center, which won't change under different pitch/yaw */
-        double phi = sacos(fmin(1, ssin(thita * DEG2RAD_FACTOR) / ssin((vFOV / 2) * DEG2RAD_FACTOR))) * RAD2DEG_FACTOR;
-        /* Calculate the topLeft/topRight point position with current pitch */
-        pVertBoundaryPoint->thita = sasin(scos(phi * DEG2RAD_FACTOR) * ssin((fPitch - vFOV / 2) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        double tempValue = ssin(phi * DEG2RAD_FACTOR) / scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        if (tempValue > 1)
-            tempValue = 1;
-        else if (tempValue < -1)
-            tempValue = -1;
-        tempValue = fabs(sasin(tempValue)) * RAD2DEG_FACTOR;
-        if (fPitch - vFOV / 2 > -ERP_VERT_ANGLE / 2)
-            pVertBoundaryPoint->alpha = fYaw + tempValue;
+    for (int32_t i = 2 * vertNum; i < pointsNum; i++)
+        m_boundaryTop[i] = fPitch + m_boundaryOffset[i];
+
+    /* Calculate the lattitude and the longitude offset of all boundary points in batch */
+    gts_sphere_sample_boundary(m_boundaryPhi.data(), m_boundaryTop.data(), m_boundaryThita.data(), m_boundaryAlphaOffset.data(), pointsNum);
+
+    /* Get viewport vertical boundary points */
+    SpherePoint* pVertBoundaryPoint = m_pViewportVerticalBoundaryPoints;
+    for (int32_t i = 0; i < 2 * vertNum; i++) {
+        bool isTop = (i < vertNum);
+        bool crossPole = isTop ? (fPitch + vFOV / 2 >= ERP_VERT_ANGLE / 2) : (fPitch - vFOV / 2 <= -ERP_VERT_ANGLE / 2);
+        double tempValue = fabs(m_boundaryAlphaOffset[i]);
+        /* Left half is on the positive offset, right half is on the negative one */
+        double sign = (m_boundaryOffset[i] >= 0) ? -1 : 1;
+        pVertBoundaryPoint->thita = m_boundaryThita[i];
+        if (!crossPole)
+            pVertBoundaryPoint->alpha = fYaw + sign * tempValue;
         else
-            pVertBoundaryPoint->alpha = clampAngle(fYaw + (ERP_HORZ_ANGLE / 2 - tempValue), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
+            pVertBoundaryPoint->alpha = clampAngle(fYaw + sign * (ERP_HORZ_ANGLE / 2 - tempValue), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
         pVertBoundaryPoint++;
     }
 
     /* Get viewport horizontal boundary points */
-    /* Right Boundary */
     SpherePoint* pHorzBoundaryPoint = m_pViewportHorizontalBoundaryPoints;
-    for (double offsetAngle = vFOV / 2; offsetAngle >= -vFOV / 2; offsetAngle -= HORZ_BOUNDING_STEP) {
-        double instantThita = calculateLatti(offsetAngle, hFOV);
-        double instantPhi;
-        double tempThita, tempAlphaOffset;
-        if (fabs(offsetAngle) <= 1e-9)
-            instantPhi = hFOV / 2;
-        else
-            instantPhi = sacos(ssin(instantThita * DEG2RAD_FACTOR) / ssin((fabs(offsetAngle)) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        tempThita = calculateLattitudeFromPhi(instantPhi, fPitch + offsetAngle);
-        pHorzBoundaryPoint->thita = tempThita;
-        tempAlphaOffset = calculateLongitudeFromThita(pHorzBoundaryPoint->thita, instantPhi, ERP_HORZ_ANGLE / 4);
-        if (fPitch + offsetAngle > ERP_VERT_ANGLE / 2)
-            pHorzBoundaryPoint->alpha = clampAngle(fYaw + (ERP_HORZ_ANGLE / 2 - tempAlphaOffset), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        else if (fPitch + offsetAngle < -ERP_VERT_ANGLE / 2)
-            pHorzBoundaryPoint->alpha = clampAngle(fYaw + (ERP_HORZ_ANGLE / 2 - tempAlphaOffset), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        else
-            pHorzBoundaryPoint->alpha = fYaw + tempAlphaOffset;
-        pHorzBoundaryPoint++;
-    }
-    /* Left Boundary */
-    for (double offsetAngle = vFOV / 2; offsetAngle >= -vFOV / 2; offsetAngle -= HORZ_BOUNDING_STEP)
-    {
-        double instantThita = calculateLatti(offsetAngle, hFOV);
-        double instantPhi;
-        double tempThita, tempAlphaOffset;
-        if (fabs(offsetAngle) <= 1e-9)
-            instantPhi = hFOV / 2;
+    for (int32_t i = 2 * vertNum; i < pointsNum; i++) {
+        bool isRight = (i < 2 * vertNum + horzNum);
+        double top = fPitch + m_boundaryOffset[i];
+        bool crossPole = isRight ? (top > ERP_VERT_ANGLE / 2 || top < -ERP_VERT_ANGLE / 2) : (top >= ERP_VERT_ANGLE / 2 || top <= -ERP_VERT_ANGLE / 2);
+        double tempAlphaOffset = m_boundaryAlphaOffset[i];
+        double sign = isRight ? 1 : -1;
+        pHorzBoundaryPoint->thita = m_boundaryThita[i];
+        if (crossPole)
+            pHorzBoundaryPoint->alpha = clampAngle(fYaw + sign * (ERP_HORZ_ANGLE / 2 - tempAlphaOffset), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
         else
-            instantPhi = sacos(ssin(instantThita * DEG2RAD_FACTOR) / ssin((fabs(offsetAngle)) * DEG2RAD_FACTOR)) * RAD2DEG_FACTOR;
-        tempThita = calculateLattitudeFromPhi(instantPhi, fPitch + offsetAngle);
-        pHorzBoundaryPoint->thita = tempThita;
-        tempAlphaOffset = calculateLongitudeFromThita(pHorzBoundaryPoint->thita, instantPhi, ERP_HORZ_ANGLE / 4);
-        if (fPitch + offsetAngle >= ERP_VERT_ANGLE / 2)
-            pHorzBoundaryPoint->alpha = clampAngle(fYaw - (ERP_HORZ_ANGLE / 2 - tempAlphaOffset), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        else if (fPitch + offsetAngle <= -ERP_VERT_ANGLE / 2)
-            pHorzBoundaryPoint->alpha = clampAngle(fYaw - (ERP_HORZ_ANGLE / 2 - tempAlphaOffset), -ERP_HORZ_ANGLE / 2, ERP_HORZ_ANGLE / 2);
-        else
-            pHorzBoundaryPoint->alpha = fYaw - tempAlphaOffset;
+            pHorzBoundaryPoint->alpha = fYaw + sign * tempAlphaOffset;
         pHorzBoundaryPoint++;
     }
 
-    /* Calculate the 3D (x,y,z) axis of boundaries */
+    /* Calculate the 3D (x,y,z) axis of boundaries in batch */
     pVertBoundaryPoint = m_pViewportVerticalBoundaryPoints;
-    /* Top Boundary */
-    for (double offsetAngle = hFOV / 2; offsetAngle >= -hFOV / 2; offsetAngle -= VERT_BOUNDING_STEP) {
-        pVertBoundaryPoint->cord3D.x = scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR)*scos(pVertBoundaryPoint->alpha*DEG2RAD_FACTOR);
-        pVertBoundaryPoint->cord3D.y = ssin(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        pVertBoundaryPoint->cord3D.z = -scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR)*ssin(pVertBoundaryPoint->alpha*DEG2RAD_FACTOR);
-        pVertBoundaryPoint++;
-    }
-    /* Bottom Boundary */
-    for (double offsetAngle = hFOV / 2; offsetAngle >= -hFOV / 2; offsetAngle -= VERT_BOUNDING_STEP) {
-        pVertBoundaryPoint->cord3D.x = scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR) * scos(pVertBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pVertBoundaryPoint->cord3D.y = ssin(pVertBoundaryPoint->thita * DEG2RAD_FACTOR);
-        pVertBoundaryPoint->cord3D.z = -scos(pVertBoundaryPoint->thita * DEG2RAD_FACTOR) * ssin(pVertBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pVertBoundaryPoint++;
-    }
-
     pHorzBoundaryPoint = m_pViewportHorizontalBoundaryPoints;
-    /* Right Boundary */
-    for (double offsetAngle = vFOV / 2; offsetAngle >= -vFOV / 2; offsetAngle -= HORZ_BOUNDING_STEP) {
-        pHorzBoundaryPoint->cord3D.x = scos(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR) * scos(pHorzBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint->cord3D.y = ssin(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint->cord3D.z = -scos(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR) * ssin(pHorzBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint++;
+    for (int32_t i = 0; i < pointsNum; i++) {
+        SpherePoint* pPoint = (i < 2 * vertNum) ? &pVertBoundaryPoint[i] : &pHorzBoundaryPoint[i - 2 * vertNum];
+        m_boundaryAlpha[i] = pPoint->alpha;
     }
-    /* Left Boundary */
-    for (double offsetAngle = vFOV / 2; offsetAngle >= -vFOV / 2; offsetAngle -= HORZ_BOUNDING_STEP) {
-        pHorzBoundaryPoint->cord3D.x = scos(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR) * scos(pHorzBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint->cord3D.y = ssin(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint->cord3D.z = -scos(pHorzBoundaryPoint->thita * DEG2RAD_FACTOR) * ssin(pHorzBoundaryPoint->alpha * DEG2RAD_FACTOR);
-        pHorzBoundaryPoint++;
+    SpherePointsSoA points = { m_boundaryAlpha.data(), m_boundaryThita.data(), m_boundaryX.data(), m_boundaryY.data(), m_boundaryZ.data(), pointsNum };
+    gts_sphere_polar_to_cartesian(&points);
+    for (int32_t i = 0; i < pointsNum; i++) {
+        SpherePoint* pPoint = (i < 2 * vertNum) ? &pVertBoundaryPoint[i] : &pHorzBoundaryPoint[i - 2 * vertNum];
+        pPoint->cord3D.x = m_boundaryX[i];
+        pPoint->cord3D.y = m_boundaryY[i];
+        pPoint->cord3D.z = m_boundaryZ[i];
     }
 
     dResult = (double)(clock() - lBefore) / CLOCKS_PER_SEC;
@@ -2086,11 +2034,20 @@ int32_t TgenViewport::CubemapPolar2Cartesian(SpherePoint* pPoint)
     pPoint->cord3D.y = ssin(pPoint->thita * DEG2RAD_FACTOR);
     pPoint->cord3D.z = -scos(pPoint->thita * DEG2RAD_FACTOR) * ssin(pPoint->alpha * DEG2RAD_FACTOR);
 
+    return CubemapCartesian2Face(pPoint);
+}
+
+int32_t TgenViewport::CubemapCartesian2Face(SpherePoint* pPoint)
+{
+    if (!pPoint) {
+        SCVP_LOG(LOG_ERROR, "The input spherer point is NULL!\n");
+        return ERROR_NULL_PTR;
+    }
     POSType aX = sfabs(pPoint->cord3D.x);
     POSType aY = sfabs(pPoint->cord3D.y);
     POSType aZ = sfabs(pPoint->cord3D.z);
     POSType pu, pv;
-    if (((aX - aY) >= DOUBLE_COMPARE_THRESH) && ((aX - aZ) >= DOUBLE_COMPARE_THRESH))
+    if (((aX - aY) >= SPHERE_COMPARE_THRESH) && ((aX - aZ) >= SPHERE_COMPARE_THRESH))
     {
         if (pPoint->cord3D.x > 0)
         {
@@ -2105,7 +2062,7 @@ int32_t TgenViewport::CubemapPolar2Cartesian(SpherePoint* pPoint)
             pv = -pPoint->cord3D.y / aX;
         }
     }
-    else if (((aY - aX) >= DOUBLE_COMPARE_THRESH) && ((aY - aZ) >= DOUBLE_COMPARE_THRESH))
+    else if (((aY - aX) >= SPHERE_COMPARE_THRESH) && ((aY - aZ) >= SPHERE_COMPARE_THRESH))
     {
         if (pPoint->cord3D.y > 0)
         {
@@ -2175,19 +2132,20 @@ int32_t TgenViewport::cubemapSelectRegion()
     CubemapPolar2Cartesian(&centerPoint);
     referencePoints.push_back(centerPoint);
 
-    /* Add the points on the viewport horizontal boudary into reference list */
+    /* Add the points on the viewport horizontal boudary into reference list, *
+     * their 3D axis are calculated with the boundary points in batch         */
     pPoint = m_pViewportHorizontalBoundaryPoints;
     /* Right Boundary */
     for (float offsetAngle = vFOV/2; offsetAngle >= -vFOV/2; offsetAngle -= HORZ_BOUNDING_STEP)
     {
-        CubemapPolar2Cartesian(pPoint);
+        CubemapCartesian2Face(pPoint);
         referencePoints.push_back(*pPoint);
         pPoint++;
     }
     /* Left Boundary */
     for (float offsetAngle = vFOV/2; offsetAngle >= -vFOV/2; offsetAngle -= HORZ_BOUNDING_STEP)
     {
-        CubemapPolar2Cartesian(pPoint);
+        CubemapCartesian2Face(pPoint);
         referencePoints.push_back(*pPoint);
         pPoint++;
     }
@@ -2196,14 +2154,14 @@ int32_t TgenViewport::cubemapSelectRegion()
     pPoint = m_pViewportVerticalBoundaryPoints;
     for (float offsetAngle = hFOV/2; offsetAngle >= -hFOV/2; offsetAngle -= VERT_BOUNDING_STEP)
     {
-        CubemapPolar2Cartesian(pPoint);
+        CubemapCartesian2Face(pPoint);
         referencePoints.push_back(*pPoint);
         pPoint++;
     }
     /* Bottom Boundary */
     for (float offsetAngle = hFOV/2; offsetAngle >= -hFOV/2; offsetAngle -= VERT_BOUNDING_STEP)
     {
-        CubemapPolar2Cartesian(pPoint);
+        CubemapCartesian2Face(pPoint);
         referencePoints.push_back(*pPoint);
         pPoint++;
     }
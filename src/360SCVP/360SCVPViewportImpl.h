@@ -35,6 +35,8 @@
 
 /* The compare threshold of two double variables */
 #define DOUBLE_COMPARE_THRESH (-double(1e-8))
+/* The compare threshold of two coordinates got from float sphere math */
+#define SPHERE_COMPARE_THRESH (-double(1e-6))
 
 ///< for cubemap, given the facesize (960x960), the maxsimum viewport size is defined in the below table
 typedef struct SIZE_DEF
@@ -125,6 +127,19 @@ public:
     Param_VideoFPStruct m_paramVideoFP;
     SpherePoint   *m_pViewportHorizontalBoundaryPoints;
     SpherePoint   *m_pViewportVerticalBoundaryPoints;
+    float          m_boundaryFOVH;                                  ///< hFOV which the boundary phi angles are calculated for
+    float          m_boundaryFOVV;                                  ///< vFOV which the boundary phi angles are calculated for
+    int32_t        m_vertBoundaryPointsNum;                         ///< points number on the top (or bottom) boundary
+    int32_t        m_horzBoundaryPointsNum;                         ///< points number on the right (or left) boundary
+    std::vector<float> m_boundaryPhi;                               ///< half open angle of each boundary point, only depends on FOV
+    std::vector<float> m_boundaryOffset;                            ///< offset angle of each boundary point, only depends on FOV
+    std::vector<float> m_boundaryTop;                               ///< top point lattitude of the great circle of each boundary point
+    std::vector<float> m_boundaryAlpha;
+    std::vector<float> m_boundaryThita;
+    std::vector<float> m_boundaryAlphaOffset;
+    std::vector<float> m_boundaryX;
+    std::vector<float> m_boundaryY;
+    std::vector<float> m_boundaryZ;
     inline int32_t round(POSType t) { return (int32_t)(t+ (t>=0? 0.5 :-0.5)); }
 
 public:
@@ -149,22 +164,6 @@ public:
     int32_t  getContentCoverage(CCDef* pOutCC, int32_t coverageShapeType);
 
 private:
-    /* calculateLongitudeFromThita:                              *
-     *    Param:                                                 *
-     *        Latti: Point spherial lattitude                    *
-     *        Phi:   The angle to the sphere center              *
-     *        maxLongiOffset: The maximum longitude offset       *
-     *    Return:                                                *
-     *        The point longitude                                */
-    double    calculateLongitudeFromThita(double Latti, double phi, double maxLongiOffset);
-    /* calculateLattitudeFromPhi:                                *
-     *    Param:                                                 *
-     *        phi:   The angle to the sphere center              *
-     *        pitch: The lattitude of the center point of the    *
-     *               current great circle                        *
-     *    Return:                                                *
-     *        The point lattitude                                */
-    double    calculateLattitudeFromPhi(double phi, double pitch);
     /* calculateLatti:                                *
      *    Param:                                                 *
      *        pitch: The lattitude of the center point of the    *
@@ -193,6 +192,15 @@ private:
      *    Return:                                                   *
      *        Error code.                                           */
     int32_t  ERPselectTilesInsideOnOneRow(ITileInfo* pTileInfo, int32_t tileNumCol, float leftCol, float rightCol, int32_t row);
+    /* CalculateBoundaryPhi: Calculate the half open angle of each   *
+     *                       boundary point, which won't change      *
+     *                       under different pitch/yaw               *
+     *    Param:                                                    *
+     *        hFOV: The horizontal FOV of the viewport              *
+     *        vFOV: The vertical FOV of the viewport                *
+     *    Return:                                                   *
+     *        Error code.                                           */
+    int32_t  CalculateBoundaryPhi(float hFOV, float vFOV);
     /* CubemapPolar2Cartesian:  Convert point coordinates from polar to *
      *                          cartesian expression in both 2D and 3D  *
      *    Param:                                                        *
@@ -200,6 +208,13 @@ private:
      *    Return:                                                       *
      *        Error code                                                */
     int32_t CubemapPolar2Cartesian(SpherePoint* pPoint);
+    /* CubemapCartesian2Face:  Project the point with 3D cartesian  *
+     *                         coordinates into 2D face coordinates *
+     *    Param:                                                        *
+     *        pPoint: Point with 3D cartesian coordinates expression    *
+     *    Return:                                                       *
+     *        Error code                                                */
+    int32_t CubemapCartesian2Face(SpherePoint* pPoint);
     /* CubemapGetFaceBoundaryCrossingPoints:                          *
      *                 Calculate cross point axis of the face         *
      *                 boundary and the connection line of two given  *
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../360SCVPBitstream.h"
+
+uint32_t gts_media_nalu_emulation_bytes_remove_count(const int8_t *buffer, uint32_t size_nal);
+uint32_t gts_media_nalu_remove_emulation_bytes(const int8_t *src_buffer, int8_t *dst_buffer, uint32_t size_nal);
+
+namespace{
+
+#define VALUES_NUM 200000
+
+// bit by bit reader and writer, used as reference for the cache word ones
+typedef struct RefBitStream {
+    std::vector<uint8_t> data;
+    uint64_t position = 0;
+    uint32_t current = 0;
+    uint32_t nbBits = 8;
+    uint8_t  zeroCount = 0;
+} RefBitStream;
+
+static uint32_t ref_read_bit(RefBitStream &bs)
+{
+    if (bs.nbBits == 8) {
+        bs.current = bs.position < bs.data.size() ? bs.data[bs.position++] : 0;
+        bs.nbBits = 0;
+    }
+    bs.current <<= 1;
+    bs.nbBits++;
+    return (bs.current & 0x100) >> 8;
+}
+
+static uint32_t ref_read_int(RefBitStream &bs, uint32_t nBits)
+{
+    uint32_t ret = 0;
+    while (nBits-- > 0) {
+        ret = (ret << 1) | ref_read_bit(bs);
+    }
+    return ret;
+}
+
+static uint32_t ref_read_ue(RefBitStream &bs)
+{
+    uint32_t leadingZeros = 0;
+    while (!ref_read_bit(bs) && leadingZeros < 32)
+        leadingZeros++;
+    return ((1U << leadingZeros) | ref_read_int(bs, leadingZeros)) - 1;
+}
+
+static void ref_write_bit(RefBitStream &bs, uint32_t bit, bool emulation)
+{
+    bs.current = (bs.current << 1) | bit;
+    if (++bs.nbBits == 8) {
+        uint8_t byte = (uint8_t)bs.current;
+        if (emulation && bs.zeroCount == 2 && byte < 4) {
+            bs.data.push_back(0x03);
+            bs.zeroCount = 0;
+        }
+        bs.zeroCount = byte ? 0 : bs.zeroCount + 1;
+        bs.data.push_back(byte);
+        bs.nbBits = 0;
+        bs.current = 0;
+    }
+}
+
+static void ref_write_int(RefBitStream &bs, uint32_t value, uint32_t nBits, bool emulation)
+{
+    while (nBits-- > 0) {
+        ref_write_bit(bs, (value >> nBits) & 1, emulation);
+    }
+}
+
+static void ref_write_ue(RefBitStream &bs, uint32_t value, bool emulation)
+{
+    uint32_t codeNum = value + 1;
+    uint32_t log2 = 0;
+    while ((codeNum >> log2) > 1)
+        log2++;
+    ref_write_int(bs, 0, log2, emulation);
+    ref_write_int(bs, codeNum, log2 + 1, emulation);
+}
+
+static uint32_t ref_remove_emulation_bytes(const int8_t *src, int8_t *dst, uint32_t size)
+{
+    uint32_t n = 0, count = 0;
+    uint8_t zeros = 0;
+    while (n < size) {
+        if (zeros == 2 && src[n] == 0x03 && n + 1 < size && src[n + 1] < 0x04) {
+            zeros = 0;
+            count++;
+            n++;
+        }
+        dst[n - count] = src[n];
+        zeros = src[n] ? 0 : zeros + 1;
+        n++;
+    }
+    return size - count;
+}
+
+class I360SCVPTest_bitstream : public testing::Test {
+public:
+
+    virtual void SetUp()
+    {
+        std::mt19937 gen(2020);
+        std::geometric_distribution<uint32_t> small(0.2);
+        std::uniform_int_distribution<uint32_t> large(0, 0xFFFF);
+        for (uint32_t i = 0; i < VALUES_NUM; i++) {
+            values.push_back((i % 8) ? small(gen) : large(gen));
+        }
+    }
+    virtual void TearDown()
+    {
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::vector<uint32_t> values;
+};
+
+TEST_F(I360SCVPTest_bitstream, ExpGolombWriteMatchesReference)
+{
+    GTS_BitStream *bs = gts_bs_new(NULL, 0, GTS_BITSTREAM_WRITE);
+    ASSERT_TRUE(bs != NULL);
+    RefBitStream ref;
+    ref.nbBits = 0;
+
+    for (uint32_t i = 0; i < values.size(); i++) {
+        // mix Exp-Golomb codes with fixed length fields of all sizes
+        gts_bs_write_ue(bs, values[i]);
+        ref_write_ue(ref, values[i], true);
+        uint32_t nBits = i % 33;
+        gts_bs_write_int(bs, (int32_t)(values[i] * 2654435761U), nBits);
+        ref_write_int(ref, nBits ? (values[i] * 2654435761U) & (0xFFFFFFFF >> (32 - nBits)) : 0, nBits, true);
+        // runs of zero bytes exercise the emulation prevention
+        if (i % 1000 == 0) {
+            gts_bs_write_int(bs, 0, 24);
+            ref_write_int(ref, 0, 24, true);
+        }
+    }
+    gts_bs_write_se(bs, -5);
+    ref_write_ue(ref, 10, true);
+    gts_bs_write_se(bs, 5);
+    ref_write_ue(ref, 9, true);
+
+    EXPECT_EQ(bs->nbBits, ref.nbBits);
+    ASSERT_EQ(bs->position, ref.data.size());
+    EXPECT_TRUE(memcmp(bs->original, ref.data.data(), ref.data.size()) == 0);
+    gts_bs_del(bs);
+}
+
+TEST_F(I360SCVPTest_bitstream, ExpGolombReadMatchesReference)
+{
+    RefBitStream ref;
+    ref.nbBits = 0;
+    for (uint32_t i = 0; i < values.size(); i++) {
+        ref_write_ue(ref, values[i], false);
+        ref_write_int(ref, values[i], i % 17, false);
+    }
+    ref_write_ue(ref, 10, false);
+    ref_write_int(ref, 1, 1, false);
+    std::vector<uint8_t> data = ref.data;
+
+    GTS_BitStream *bs = gts_bs_new((const int8_t *)data.data(), data.size(), GTS_BITSTREAM_READ);
+    ASSERT_TRUE(bs != NULL);
+    for (uint32_t i = 0; i < values.size(); i++) {
+        uint32_t nBits = i % 17;
+        ASSERT_EQ(gts_bs_read_ue(bs), values[i]);
+        ASSERT_EQ(gts_bs_read_int(bs, nBits), nBits ? (values[i] & ((1U << nBits) - 1)) : 0);
+    }
+    EXPECT_EQ(gts_bs_read_se(bs), -5);
+    EXPECT_EQ(gts_bs_read_int(bs, 1), 1U);
+    gts_bs_del(bs);
+
+    // the bitstream state stays the same as the bit by bit reader one
+    bs = gts_bs_new((const int8_t *)data.data(), data.size(), GTS_BITSTREAM_READ);
+    ASSERT_TRUE(bs != NULL);
+    ref.position = 0;
+    ref.nbBits = 8;
+    ref.current = 0;
+    for (uint32_t i = 0; i < 100000; i++) {
+        uint32_t nBits = (i * 7) % 33;
+        RefBitStream peek = ref;
+        ASSERT_EQ(gts_bs_peek_bits(bs, 32, 0), ref_read_int(peek, 32));
+        ASSERT_EQ(gts_bs_read_int(bs, nBits), ref_read_int(ref, nBits));
+        ASSERT_EQ(bs->position, ref.position);
+        ASSERT_EQ(bs->nbBits, ref.nbBits);
+        ASSERT_EQ(bs->current, ref.current);
+    }
+    gts_bs_del(bs);
+}
+
+TEST_F(I360SCVPTest_bitstream, EmulationBytesRemoval)
+{
+    std::mt19937 gen(360);
+    for (uint32_t round = 0; round < 200; round++) {
+        uint32_t size = 1 + gen() % 2000;
+        std::vector<int8_t> src(size);
+        for (uint32_t i = 0; i < size; i++) {
+            uint32_t r = gen() % 8;
+            src[i] = (int8_t)(r < 4 ? 0 : (r < 6 ? 3 : gen()));
+        }
+        std::vector<int8_t> dst(size), refDst(size);
+        uint32_t refSize = ref_remove_emulation_bytes(src.data(), refDst.data(), size);
+        EXPECT_EQ(gts_media_nalu_emulation_bytes_remove_count(src.data(), size), size - refSize);
+        ASSERT_EQ(gts_media_nalu_remove_emulation_bytes(src.data(), dst.data(), size), refSize);
+        EXPECT_TRUE(memcmp(dst.data(), refDst.data(), refSize) == 0);
+    }
+}
+
+TEST_F(I360SCVPTest_bitstream, ExpGolombThroughput)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    RefBitStream ref;
+    ref.nbBits = 0;
+    for (auto value : values)
+        ref_write_ue(ref, value, true);
+    ref_write_int(ref, 0, (8 - ref.nbBits) % 8, true);
+    double refEncodeMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    GTS_BitStream *bs = gts_bs_new(NULL, 0, GTS_BITSTREAM_WRITE);
+    ASSERT_TRUE(bs != NULL);
+    for (auto value : values)
+        gts_bs_write_ue(bs, value);
+    gts_bs_align(bs);
+    double encodeMs = elapsedMs(start);
+    ASSERT_EQ(bs->position, ref.data.size());
+
+    std::vector<uint8_t> data(ref.data.size());
+    uint32_t size = gts_media_nalu_remove_emulation_bytes((const int8_t *)ref.data.data(), (int8_t *)data.data(), ref.data.size());
+    data.resize(size);
+    gts_bs_del(bs);
+
+    start = std::chrono::steady_clock::now();
+    RefBitStream refRead;
+    refRead.data = data;
+    uint64_t refSum = 0;
+    for (uint32_t i = 0; i < values.size(); i++)
+        refSum += ref_read_ue(refRead);
+    double refDecodeMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    bs = gts_bs_new((const int8_t *)data.data(), data.size(), GTS_BITSTREAM_READ);
+    ASSERT_TRUE(bs != NULL);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < values.size(); i++)
+        sum += gts_bs_read_ue(bs);
+    double decodeMs = elapsedMs(start);
+    gts_bs_del(bs);
+    EXPECT_EQ(sum, refSum);
+
+    printf("Exp-Golomb %u values: encode %.2f ms (bit by bit %.2f ms), decode %.2f ms (bit by bit %.2f ms)\n",
+        VALUES_NUM, encodeMs, refEncodeMs, decodeMs, refDecodeMs);
+}
+}
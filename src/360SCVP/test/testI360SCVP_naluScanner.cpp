@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "../360SCVPNaluScanner.h"
+
+namespace{
+
+typedef uint64_t (*FindStartCodeFunc)(const uint8_t *data, uint64_t size, uint64_t start);
+
+typedef struct ScannerImpl {
+    const char        *name;
+    FindStartCodeFunc  func;
+} ScannerImpl;
+
+static std::vector<ScannerImpl> GetScanners()
+{
+    std::vector<ScannerImpl> scanners;
+    scanners.push_back({"c", gts_media_nalu_find_start_code_c});
+#if GTS_NALU_SCANNER_X86
+    scanners.push_back({"sse2", gts_media_nalu_find_start_code_sse2});
+    if (__builtin_cpu_supports("avx2"))
+        scanners.push_back({"avx2", gts_media_nalu_find_start_code_avx2});
+#endif
+    scanners.push_back({"dispatched", gts_media_nalu_find_start_code});
+    return scanners;
+}
+
+// byte by byte search, same as the one used by nalu parser before
+static uint64_t ref_find_start_code(const uint8_t *data, uint64_t size, uint64_t start)
+{
+    uint32_t v = 0xffffffff;
+    for (uint64_t i = start; i < size; i++) {
+        v = (v << 8) | data[i];
+        if (v == 0x00000001) return i - 3;
+        if ((v & 0x00FFFFFF) == 0x00000001) return i - 2;
+    }
+    return size;
+}
+
+// random payload with many zeros, start codes are inserted at random positions
+static std::vector<uint8_t> GenerateStream(uint64_t size, uint32_t startCodesNum, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> byteDist(0, 7);
+    std::vector<uint8_t> data(size);
+    for (uint64_t i = 0; i < size; i++) {
+        uint32_t r = byteDist(gen);
+        data[i] = (r < 3) ? 0 : (r == 3 ? 1 : (uint8_t)(gen() & 0xff));
+    }
+    std::uniform_int_distribution<uint64_t> posDist(0, size - 4);
+    for (uint32_t i = 0; i < startCodesNum; i++) {
+        uint64_t pos = posDist(gen);
+        data[pos] = 0;
+        data[pos + 1] = 0;
+        if (gen() & 1) {
+            data[pos + 2] = 0;
+            data[pos + 3] = 1;
+        } else {
+            data[pos + 2] = 1;
+        }
+    }
+    return data;
+}
+
+TEST(I360SCVPNaluScannerTest, FindStartCodeMatchesReference)
+{
+    std::vector<ScannerImpl> scanners = GetScanners();
+    for (uint32_t seed = 0; seed < 20; seed++) {
+        std::vector<uint8_t> data = GenerateStream(1000 + seed * 37, 8, seed);
+        const uint8_t *buf = data.data();
+        uint64_t size = data.size();
+        for (uint64_t start = 0; start < size; start += 7) {
+            uint64_t expected = ref_find_start_code(buf, size, start);
+            for (auto &scanner : scanners) {
+                EXPECT_EQ(expected, scanner.func(buf, size, start)) << scanner.name << " start " << start;
+            }
+        }
+        // all sizes around the vector width are covered by the tail handling
+        for (uint64_t len = 0; len < 80 && len <= size; len++) {
+            uint64_t expected = ref_find_start_code(buf, len, 0);
+            for (auto &scanner : scanners) {
+                EXPECT_EQ(expected, scanner.func(buf, len, 0)) << scanner.name << " len " << len;
+            }
+        }
+    }
+}
+
+TEST(I360SCVPNaluScannerTest, ScanNALUsOnStream)
+{
+    std::ifstream in("./test.265", std::ios::binary);
+    ASSERT_TRUE(in.is_open());
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_TRUE(data.size() > 0);
+
+    uint32_t nalusNum = 0;
+    EXPECT_EQ(0, I360SCVP_ScanNALUs(data.data(), data.size(), E_NALU_CODEC_HEVC, NULL, 0, &nalusNum));
+    ASSERT_TRUE(nalusNum > 3);
+
+    std::vector<Nalu> nalus(nalusNum);
+    uint32_t filledNum = 0;
+    EXPECT_EQ(0, I360SCVP_ScanNALUs(data.data(), data.size(), E_NALU_CODEC_HEVC, nalus.data(), nalus.size(), &filledNum));
+    EXPECT_EQ(nalusNum, filledNum);
+
+    // nalus are contiguous and cover the whole stream
+    EXPECT_EQ(data.data(), nalus[0].data);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < filledNum; i++) {
+        if (i > 0) {
+            EXPECT_EQ(nalus[i - 1].data + nalus[i - 1].dataSize, nalus[i].data);
+        }
+        uint8_t *header = nalus[i].data + nalus[i].startCodesSize;
+        EXPECT_EQ(1, header[-1]);
+        EXPECT_EQ((header[0] >> 1) & 0x3f, nalus[i].naluType);
+        total += nalus[i].dataSize;
+    }
+    EXPECT_EQ(data.size(), total);
+
+    // VPS, SPS and PPS come first
+    EXPECT_EQ(32, nalus[0].naluType);
+    EXPECT_EQ(33, nalus[1].naluType);
+    EXPECT_EQ(34, nalus[2].naluType);
+
+    // same sizes are given by nalu parser
+    param_360SCVP param;
+    memset(&param, 0, sizeof(param_360SCVP));
+    param.usedType = E_PARSER_ONENAL;
+    param.pInputBitstream = data.data();
+    param.inputBitstreamLen = data.size();
+    void *handle = I360SCVP_Init(&param);
+    ASSERT_TRUE(handle != NULL);
+    uint8_t *pos = data.data();
+    uint32_t rest = data.size();
+    for (uint32_t i = 0; i < 3; i++) {
+        Nalu nalu;
+        memset(&nalu, 0, sizeof(Nalu));
+        nalu.data = pos;
+        nalu.dataSize = rest;
+        EXPECT_EQ(0, I360SCVP_ParseNAL(&nalu, handle));
+        EXPECT_EQ(nalus[i].dataSize, nalu.dataSize);
+        EXPECT_EQ(nalus[i].naluType, nalu.naluType);
+        pos += nalu.dataSize;
+        rest -= nalu.dataSize;
+    }
+    I360SCVP_unInit(handle);
+
+    // array is filled up to its size
+    EXPECT_EQ(0, I360SCVP_ScanNALUs(data.data(), data.size(), E_NALU_CODEC_HEVC, nalus.data(), 2, &filledNum));
+    EXPECT_EQ(2u, filledNum);
+}
+
+TEST(I360SCVPNaluScannerTest, ScannerThroughput)
+{
+    // 64MB slice data with one start code every 64KB, like tiles of one 8K frame
+    const uint64_t size = 64 * 1024 * 1024;
+    std::vector<uint8_t> data = GenerateStream(size, 0, 1);
+    for (uint64_t i = 0; i < size; i++) {
+        if (data[i] < 2) data[i] = 0x80;
+    }
+    uint32_t startCodesNum = 0;
+    for (uint64_t pos = 0; pos + 4 <= size; pos += 64 * 1024) {
+        data[pos] = 0;
+        data[pos + 1] = 0;
+        data[pos + 2] = 0;
+        data[pos + 3] = 1;
+        startCodesNum++;
+    }
+
+    printf("Selected start code scanner: %s\n", gts_media_nalu_scanner_name());
+    std::vector<ScannerImpl> scanners = GetScanners();
+    scanners.insert(scanners.begin(), {"reference", ref_find_start_code});
+    for (auto &scanner : scanners) {
+        uint32_t found = 0;
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (uint32_t loop = 0; loop < 4; loop++) {
+            uint64_t pos = scanner.func(data.data(), size, 0);
+            while (pos < size) {
+                if (!loop) found++;
+                pos = scanner.func(data.data(), size, pos + 4);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        printf("%-10s scanned %.2f GB/s\n", scanner.name, (double)size * 4 / seconds / 1e9);
+        EXPECT_EQ(startCodesNum, found) << scanner.name;
+    }
+}
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gtest/gtest.h"
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../360SCVPAPI.h"
+#include "../360SCVPSphereMath.h"
+
+#include "../../utils/safe_mem.h"
+
+namespace{
+
+typedef struct SphereMathVariant {
+    const char *name;
+    void (*polarToCartesian)(SpherePointsSoA *points);
+    void (*cartesianToPolar)(SpherePointsSoA *points);
+    void (*sampleBoundary)(const float *phi, const float *top, float *thita, float *alphaOffset, int32_t num);
+} SphereMathVariant;
+
+static std::vector<SphereMathVariant> GetVariants()
+{
+    std::vector<SphereMathVariant> impls;
+    impls.push_back({"c", gts_sphere_polar_to_cartesian_c, gts_sphere_cartesian_to_polar_c, gts_sphere_sample_boundary_c});
+#if GTS_SPHERE_MATH_X86
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        impls.push_back({"avx2", gts_sphere_polar_to_cartesian_avx2, gts_sphere_cartesian_to_polar_avx2, gts_sphere_sample_boundary_avx2});
+#endif
+    impls.push_back({"dispatched", gts_sphere_polar_to_cartesian, gts_sphere_cartesian_to_polar, gts_sphere_sample_boundary});
+    return impls;
+}
+
+static const double DEG2RAD = M_PI / 180;
+static const double RAD2DEG = 180 / M_PI;
+// error bound of the unit sphere coordinates derived from the angle one
+static const double MAX_ERROR_COORD = GTS_SPHERE_MATH_MAX_ERROR_DEGREE * DEG2RAD;
+
+// the points number is not a multiple of the vector width to cover the tail
+static const int32_t POINTS_NUM = 100003;
+
+TEST(I360SCVPTest_sphereMath, PolarToCartesian)
+{
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> alphaDist(-540.0f, 540.0f);
+    std::uniform_real_distribution<float> thitaDist(-90.0f, 90.0f);
+    std::vector<float> alpha(POINTS_NUM), thita(POINTS_NUM), x(POINTS_NUM), y(POINTS_NUM), z(POINTS_NUM);
+    for (int32_t i = 0; i < POINTS_NUM; i++)
+    {
+        alpha[i] = alphaDist(gen);
+        thita[i] = thitaDist(gen);
+    }
+    for (auto &impl : GetVariants())
+    {
+        SpherePointsSoA points = { alpha.data(), thita.data(), x.data(), y.data(), z.data(), POINTS_NUM };
+        impl.polarToCartesian(&points);
+        double maxError = 0;
+        for (int32_t i = 0; i < POINTS_NUM; i++)
+        {
+            double refX = cos(thita[i] * DEG2RAD) * cos(alpha[i] * DEG2RAD);
+            double refY = sin(thita[i] * DEG2RAD);
+            double refZ = -cos(thita[i] * DEG2RAD) * sin(alpha[i] * DEG2RAD);
+            maxError = fmax(maxError, fabs(refX - x[i]));
+            maxError = fmax(maxError, fabs(refY - y[i]));
+            maxError = fmax(maxError, fabs(refZ - z[i]));
+        }
+        printf("%-10s polar to Cartesian max error %g\n", impl.name, maxError);
+        EXPECT_LT(maxError, MAX_ERROR_COORD) << impl.name;
+    }
+}
+
+TEST(I360SCVPTest_sphereMath, CartesianToPolar)
+{
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> alpha(POINTS_NUM), thita(POINTS_NUM), x(POINTS_NUM), y(POINTS_NUM), z(POINTS_NUM);
+    for (int32_t i = 0; i < POINTS_NUM; i++)
+    {
+        // points on the cube faces as used by the cubemap tiles grid
+        x[i] = dist(gen);
+        y[i] = dist(gen);
+        z[i] = dist(gen);
+        float *axis = (i % 3 == 0) ? &x[i] : ((i % 3 == 1) ? &y[i] : &z[i]);
+        *axis = (*axis < 0) ? -1.0f : 1.0f;
+    }
+    for (auto &impl : GetVariants())
+    {
+        SpherePointsSoA points = { alpha.data(), thita.data(), x.data(), y.data(), z.data(), POINTS_NUM };
+        impl.cartesianToPolar(&points);
+        double maxError = 0;
+        for (int32_t i = 0; i < POINTS_NUM; i++)
+        {
+            double refThita = asin(y[i] / sqrt((double)x[i] * x[i] + (double)y[i] * y[i] + (double)z[i] * z[i])) * RAD2DEG;
+            double refAlpha = atan(-(double)z[i] / x[i]) * RAD2DEG;
+            if (x[i] < 0)
+                refAlpha += 180;
+            if (refAlpha > 180)
+                refAlpha -= 360;
+            double alphaError = fabs(refAlpha - alpha[i]);
+            // -180 and 180 are the same longitude
+            alphaError = fmin(alphaError, fabs(alphaError - 360));
+            maxError = fmax(maxError, fabs(refThita - thita[i]));
+            maxError = fmax(maxError, alphaError);
+            EXPECT_TRUE(alpha[i] >= -180.0f && alpha[i] <= 180.0f);
+        }
+        printf("%-10s Cartesian to polar max error %g degree\n", impl.name, maxError);
+        EXPECT_LT(maxError, GTS_SPHERE_MATH_MAX_ERROR_DEGREE) << impl.name;
+    }
+}
+
+TEST(I360SCVPTest_sphereMath, SampleBoundary)
+{
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> phiDist(0.0f, 90.0f);
+    std::uniform_real_distribution<float> topDist(-180.0f, 180.0f);
+    std::vector<float> phi(POINTS_NUM), top(POINTS_NUM), thita(POINTS_NUM), alphaOffset(POINTS_NUM);
+    for (int32_t i = 0; i < POINTS_NUM; i++)
+    {
+        phi[i] = phiDist(gen);
+        top[i] = topDist(gen);
+    }
+    // the circle top point at the pole and the circle top point itself
+    phi[0] = 0;
+    top[0] = 90;
+    phi[1] = 0;
+    top[1] = 30;
+    for (auto &impl : GetVariants())
+    {
+        impl.sampleBoundary(phi.data(), top.data(), thita.data(), alphaOffset.data(), POINTS_NUM);
+        double maxError = 0;
+        for (int32_t i = 0; i < POINTS_NUM; i++)
+        {
+            double refThita = asin(cos(phi[i] * DEG2RAD) * sin(top[i] * DEG2RAD)) * RAD2DEG;
+            double ratio = sin(phi[i] * DEG2RAD) / cos(refThita * DEG2RAD);
+            double refOffset = asin(fmin(1, fmax(-1, ratio))) * RAD2DEG;
+            maxError = fmax(maxError, fabs(refThita - thita[i]));
+            maxError = fmax(maxError, fabs(refOffset - alphaOffset[i]));
+        }
+        EXPECT_NEAR(thita[0], 90.0f, GTS_SPHERE_MATH_MAX_ERROR_DEGREE);
+        EXPECT_NEAR(alphaOffset[0], 0.0f, GTS_SPHERE_MATH_MAX_ERROR_DEGREE);
+        EXPECT_NEAR(thita[1], 30.0f, GTS_SPHERE_MATH_MAX_ERROR_DEGREE);
+        EXPECT_NEAR(alphaOffset[1], 0.0f, GTS_SPHERE_MATH_MAX_ERROR_DEGREE);
+        printf("%-10s boundary sampling max error %g degree\n", impl.name, maxError);
+        EXPECT_LT(maxError, GTS_SPHERE_MATH_MAX_ERROR_DEGREE) << impl.name;
+    }
+}
+
+TEST(I360SCVPTest_sphereMath, BatchThroughput)
+{
+    std::vector<float> alpha(POINTS_NUM), thita(POINTS_NUM), x(POINTS_NUM), y(POINTS_NUM), z(POINTS_NUM);
+    for (int32_t i = 0; i < POINTS_NUM; i++)
+    {
+        alpha[i] = (float)(i % 360) - 180;
+        thita[i] = (float)(i % 180) - 90;
+    }
+    printf("Selected sphere math: %s\n", gts_sphere_math_name());
+    for (auto &impl : GetVariants())
+    {
+        SpherePointsSoA points = { alpha.data(), thita.data(), x.data(), y.data(), z.data(), POINTS_NUM };
+        impl.polarToCartesian(&points);
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int32_t loop = 0; loop < 20; loop++)
+            impl.polarToCartesian(&points);
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        printf("%-10s polar to Cartesian %.1f Mpoints/s\n", impl.name, (double)POINTS_NUM * 20 / seconds / 1e6);
+    }
+}
+
+class I360SCVPTest_sphereMathViewport : public testing::Test {
+public:
+    virtual void SetUp()
+    {
+      memset_s((void*)&param, sizeof(param_360SCVP), 0);
+      param.usedType = E_VIEWPORT_ONLY;
+      param.paramViewPort.geoTypeOutput = E_SVIDEO_VIEWPORT;
+      param.paramViewPort.viewPortFOVH = 80;
+      param.paramViewPort.viewPortFOVV = 90;
+      param.paramViewPort.viewportHeight = 1024;
+      param.paramViewPort.viewportWidth = 1024;
+    }
+
+    // viewports computed per second by going through the whole sphere
+    void runViewports(const char *name)
+    {
+      void* pI360SCVP = I360SCVP_Init(&param);
+      ASSERT_TRUE(pI360SCVP != NULL);
+      TileDef pOutTile[1024];
+      Param_ViewportOutput paramViewportOutput;
+      int32_t viewportsNum = 0;
+      auto begin = std::chrono::high_resolution_clock::now();
+      for (int yaw = -180; yaw < 180; yaw += 3)
+      {
+        for (int pitch = -90; pitch <= 90; pitch += 3)
+        {
+          I360SCVP_setViewPort(pI360SCVP, yaw, pitch);
+          int32_t tilesNum = I360SCVP_getTilesInViewport(pOutTile, &paramViewportOutput, pI360SCVP);
+          EXPECT_TRUE(tilesNum > 0);
+          viewportsNum++;
+        }
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      double seconds = std::chrono::duration<double>(end - begin).count();
+      printf("%s: %.0f viewports/s\n", name, viewportsNum / seconds);
+      I360SCVP_unInit(pI360SCVP);
+    }
+
+    param_360SCVP param;
+};
+
+TEST_F(I360SCVPTest_sphereMathViewport, ERPViewportsPerSecond)
+{
+    param.paramViewPort.faceWidth = 7680;
+    param.paramViewPort.faceHeight = 3840;
+    param.paramViewPort.geoTypeInput = EGeometryType(E_SVIDEO_EQUIRECT);
+    param.paramViewPort.tileNumCol = 20;
+    param.paramViewPort.tileNumRow = 10;
+    param.paramViewPort.paramVideoFP.cols = 1;
+    param.paramViewPort.paramVideoFP.rows = 1;
+    param.paramViewPort.paramVideoFP.faces[0][0].faceWidth = param.paramViewPort.faceWidth;
+    param.paramViewPort.paramVideoFP.faces[0][0].faceHeight = param.paramViewPort.faceHeight;
+    param.paramViewPort.paramVideoFP.faces[0][0].idFace = 1;
+    param.paramViewPort.paramVideoFP.faces[0][0].rotFace = NO_TRANSFORM;
+    runViewports("ERP");
+}
+
+TEST_F(I360SCVPTest_sphereMathViewport, CubemapViewportsPerSecond)
+{
+    int32_t faceIds[2][3] = { {4, 0, 5}, {3, 1, 2} };
+    param.paramViewPort.faceWidth = 512 * 4;
+    param.paramViewPort.faceHeight = 512 * 4;
+    param.paramViewPort.geoTypeInput = EGeometryType(E_SVIDEO_CUBEMAP);
+    param.paramViewPort.viewPortFOVV = 80;
+    param.paramViewPort.tileNumCol = 4;
+    param.paramViewPort.tileNumRow = 4;
+    param.paramViewPort.paramVideoFP.cols = 3;
+    param.paramViewPort.paramVideoFP.rows = 2;
+    for (int i = 0; i < 2; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        param.paramViewPort.paramVideoFP.faces[i][j].faceWidth = 512;
+        param.paramViewPort.paramVideoFP.faces[i][j].faceHeight = 512;
+        param.paramViewPort.paramVideoFP.faces[i][j].idFace = faceIds[i][j];
+        param.paramViewPort.paramVideoFP.faces[i][j].rotFace = NO_TRANSFORM;
+      }
+    }
+    runViewports("Cubemap");
+}
+
+}
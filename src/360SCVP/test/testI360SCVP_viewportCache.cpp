@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gtest/gtest.h"
+#include <string>
+#include "../360SCVPAPI.h"
+
+#include "../../utils/safe_mem.h"
+
+namespace{
+class I360SCVPTest_viewportCache : public testing::Test {
+public:
+    virtual void SetUp()
+    {
+      memset_s((void*)&param, sizeof(param_360SCVP), 0);
+      param.usedType = E_VIEWPORT_ONLY;
+      param.paramViewPort.geoTypeOutput = E_SVIDEO_VIEWPORT;
+    }
+
+    void setERP()
+    {
+      param.paramViewPort.faceWidth = 7680;
+      param.paramViewPort.faceHeight = 3840;
+      param.paramViewPort.geoTypeInput = EGeometryType(E_SVIDEO_EQUIRECT);
+      param.paramViewPort.viewportHeight = 1024;
+      param.paramViewPort.viewportWidth = 1024;
+      param.paramViewPort.tileNumCol = 20;
+      param.paramViewPort.tileNumRow = 10;
+      param.paramViewPort.viewPortFOVH = 80;
+      param.paramViewPort.viewPortFOVV = 90;
+      param.paramViewPort.paramVideoFP.cols = 1;
+      param.paramViewPort.paramVideoFP.rows = 1;
+      param.paramViewPort.paramVideoFP.faces[0][0].faceWidth = param.paramViewPort.faceWidth;
+      param.paramViewPort.paramVideoFP.faces[0][0].faceHeight = param.paramViewPort.faceHeight;
+      param.paramViewPort.paramVideoFP.faces[0][0].idFace = 1;
+      param.paramViewPort.paramVideoFP.faces[0][0].rotFace = NO_TRANSFORM;
+    }
+
+    void setCubemap()
+    {
+      int32_t faceIds[2][3] = { {4, 0, 5}, {3, 1, 2} };
+      E_TransformType faceRots[2][3] = { {NO_TRANSFORM, NO_TRANSFORM, NO_TRANSFORM},
+                                         {ROTATION_180_ANTICLOCKWISE, ROTATION_270_ANTICLOCKWISE, NO_TRANSFORM} };
+      param.paramViewPort.faceWidth = 512 * 4;
+      param.paramViewPort.faceHeight = 512 * 4;
+      param.paramViewPort.geoTypeInput = EGeometryType(E_SVIDEO_CUBEMAP);
+      param.paramViewPort.viewportHeight = 960;
+      param.paramViewPort.viewportWidth = 960;
+      param.paramViewPort.tileNumCol = 4;
+      param.paramViewPort.tileNumRow = 4;
+      param.paramViewPort.viewPortFOVH = 80;
+      param.paramViewPort.viewPortFOVV = 80;
+      param.paramViewPort.paramVideoFP.cols = 3;
+      param.paramViewPort.paramVideoFP.rows = 2;
+      for (int i = 0; i < 2; i++)
+      {
+        for (int j = 0; j < 3; j++)
+        {
+          param.paramViewPort.paramVideoFP.faces[i][j].faceWidth = 512;
+          param.paramViewPort.paramVideoFP.faces[i][j].faceHeight = 512;
+          param.paramViewPort.paramVideoFP.faces[i][j].idFace = faceIds[i][j];
+          param.paramViewPort.paramVideoFP.faces[i][j].rotFace = faceRots[i][j];
+        }
+      }
+    }
+
+    void* initHandle(float angularResolution, uint32_t maxEntriesNum)
+    {
+      void* pI360SCVP = I360SCVP_Init(&param);
+      if (pI360SCVP && angularResolution > 0)
+      {
+        Param_ViewportCache cacheParam;
+        memset_s((void*)&cacheParam, sizeof(Param_ViewportCache), 0);
+        cacheParam.angularResolution = angularResolution;
+        cacheParam.maxEntriesNum = maxEntriesNum;
+        EXPECT_TRUE(I360SCVP_SetParameter(pI360SCVP, ID_SCVP_PARAM_VIEWPORT_CACHE, &cacheParam) == 0);
+      }
+      return pI360SCVP;
+    }
+
+    Param_ViewportCache getStatistic(void* pI360SCVP)
+    {
+      Param_ViewportCache cacheParam;
+      memset_s((void*)&cacheParam, sizeof(Param_ViewportCache), 0);
+      void* pValue = &cacheParam;
+      EXPECT_TRUE(I360SCVP_GetParameter(pI360SCVP, ID_SCVP_PARAM_VIEWPORT_CACHE, &pValue) == 0);
+      return cacheParam;
+    }
+
+    // selected tiles, viewport output and content coverage of one pose
+    struct SelectResult
+    {
+      int32_t              tilesNum;
+      TileDef              tiles[1024];
+      Param_ViewportOutput output;
+      CCDef                coverage;
+    };
+
+    void selectTiles(void* pI360SCVP, float yaw, float pitch, SelectResult* result)
+    {
+      memset_s((void*)result, sizeof(SelectResult), 0);
+      I360SCVP_setViewPort(pI360SCVP, yaw, pitch);
+      I360SCVP_process(&param, pI360SCVP);
+      result->tilesNum = I360SCVP_getTilesInViewport(result->tiles, &result->output, pI360SCVP);
+      I360SCVP_getContentCoverage(pI360SCVP, &result->coverage);
+    }
+
+    void expectSameResult(const SelectResult& exact, const SelectResult& cached)
+    {
+      ASSERT_EQ(exact.tilesNum, cached.tilesNum);
+      for (int32_t i = 0; i < exact.tilesNum && i < 1024; i++)
+      {
+        EXPECT_EQ(exact.tiles[i].x, cached.tiles[i].x);
+        EXPECT_EQ(exact.tiles[i].y, cached.tiles[i].y);
+        EXPECT_EQ(exact.tiles[i].idx, cached.tiles[i].idx);
+        EXPECT_EQ(exact.tiles[i].faceId, cached.tiles[i].faceId);
+      }
+      EXPECT_EQ(exact.output.dstWidthAlignTile, cached.output.dstWidthAlignTile);
+      EXPECT_EQ(exact.output.dstHeightAlignTile, cached.output.dstHeightAlignTile);
+      // the net region of cubemap is accumulated over the faces touched by the
+      // previous poses as well, so it is only a function of the pose for ERP
+      if (param.paramViewPort.geoTypeInput == E_SVIDEO_EQUIRECT)
+      {
+        EXPECT_EQ(exact.output.dstWidthNet, cached.output.dstWidthNet);
+        EXPECT_EQ(exact.output.dstHeightNet, cached.output.dstHeightNet);
+        EXPECT_EQ(exact.output.xTopLeftNet, cached.output.xTopLeftNet);
+        EXPECT_EQ(exact.output.yTopLeftNet, cached.output.yTopLeftNet);
+      }
+      EXPECT_EQ(0, memcmp(&exact.coverage, &cached.coverage, sizeof(CCDef)));
+    }
+
+    void compareWithExactPath()
+    {
+      void* pExact = initHandle(0, 0);
+      void* pCached = initHandle(1.0f, 0);
+      ASSERT_TRUE(pExact != NULL);
+      ASSERT_TRUE(pCached != NULL);
+
+      SelectResult* exact = new SelectResult;
+      SelectResult* cached = new SelectResult;
+      Param_ViewportCache before = getStatistic(pCached);
+      uint32_t posesNum = 0;
+      // the second pass is served from the cache
+      for (int pass = 0; pass < 2; pass++)
+      {
+        for (int yaw = -180; yaw <= 180; yaw += 15)
+        {
+          for (int pitch = -90; pitch <= 90; pitch += 15)
+          {
+            selectTiles(pExact, yaw, pitch, exact);
+            selectTiles(pCached, yaw, pitch, cached);
+            expectSameResult(*exact, *cached);
+            if (!pass)
+              posesNum++;
+          }
+        }
+      }
+      Param_ViewportCache after = getStatistic(pCached);
+      EXPECT_EQ(after.missesNum - before.missesNum, posesNum);
+      EXPECT_EQ(after.hitsNum - before.hitsNum, posesNum);
+      EXPECT_EQ(after.angularResolution, 1.0f);
+
+      delete exact;
+      delete cached;
+      I360SCVP_unInit(pExact);
+      I360SCVP_unInit(pCached);
+    }
+
+    param_360SCVP           param;
+};
+
+TEST_F(I360SCVPTest_viewportCache, ERPMatchesExactPath)
+{
+    setERP();
+    compareWithExactPath();
+}
+
+TEST_F(I360SCVPTest_viewportCache, CubemapMatchesExactPath)
+{
+    setCubemap();
+    compareWithExactPath();
+}
+
+TEST_F(I360SCVPTest_viewportCache, PosesInOneBucketShareResult)
+{
+    setERP();
+    param.paramViewPort.viewPortFOVH = 70;
+    void* pExact = initHandle(0, 0);
+    void* pCached = initHandle(10.0f, 0);
+    // another handle with the same configuration shares the cache
+    void* pShared = initHandle(10.0f, 0);
+    ASSERT_TRUE(pExact != NULL);
+    ASSERT_TRUE(pCached != NULL);
+    ASSERT_TRUE(pShared != NULL);
+
+    SelectResult* exact = new SelectResult;
+    SelectResult* cached = new SelectResult;
+    Param_ViewportCache before = getStatistic(pCached);
+
+    selectTiles(pExact, 32.5f, 12.0f, exact);
+    selectTiles(pCached, 32.5f, 12.0f, cached);
+    expectSameResult(*exact, *cached);
+    selectTiles(pCached, 28.0f, 14.9f, cached);
+    expectSameResult(*exact, *cached);
+    selectTiles(pShared, 34.9f, 5.0f, cached);
+    expectSameResult(*exact, *cached);
+
+    Param_ViewportCache after = getStatistic(pCached);
+    EXPECT_EQ(after.missesNum - before.missesNum, 1u);
+    EXPECT_EQ(after.hitsNum - before.hitsNum, 2u);
+
+    delete exact;
+    delete cached;
+    I360SCVP_unInit(pExact);
+    I360SCVP_unInit(pCached);
+    I360SCVP_unInit(pShared);
+}
+
+TEST_F(I360SCVPTest_viewportCache, EntriesAreBounded)
+{
+    setERP();
+    param.paramViewPort.viewPortFOVH = 60;
+    void* pCached = initHandle(1.0f, 16);
+    ASSERT_TRUE(pCached != NULL);
+
+    SelectResult* cached = new SelectResult;
+    for (int yaw = 0; yaw < 100; yaw++)
+    {
+      selectTiles(pCached, yaw, 0, cached);
+    }
+    Param_ViewportCache statistic = getStatistic(pCached);
+    EXPECT_EQ(statistic.maxEntriesNum, 16u);
+    EXPECT_TRUE(statistic.entriesNum <= 16);
+
+    // the most recent poses are kept and the oldest ones are evicted
+    Param_ViewportCache before = getStatistic(pCached);
+    selectTiles(pCached, 99, 0, cached);
+    selectTiles(pCached, 90, 0, cached);
+    Param_ViewportCache after = getStatistic(pCached);
+    EXPECT_EQ(after.hitsNum - before.hitsNum, 2u);
+    selectTiles(pCached, 0, 0, cached);
+    before = after;
+    after = getStatistic(pCached);
+    EXPECT_EQ(after.missesNum - before.missesNum, 1u);
+
+    // disabling the cache on the handle bypasses it
+    Param_ViewportCache cacheParam;
+    memset_s((void*)&cacheParam, sizeof(Param_ViewportCache), 0);
+    cacheParam.maxEntriesNum = 4096;
+    EXPECT_TRUE(I360SCVP_SetParameter(pCached, ID_SCVP_PARAM_VIEWPORT_CACHE, &cacheParam) == 0);
+    before = getStatistic(pCached);
+    selectTiles(pCached, 50, 0, cached);
+    after = getStatistic(pCached);
+    EXPECT_EQ(after.hitsNum, before.hitsNum);
+    EXPECT_EQ(after.missesNum, before.missesNum);
+    EXPECT_EQ(after.maxEntriesNum, 4096u);
+
+    delete cached;
+    I360SCVP_unInit(pCached);
+}
+
+}
@@ -49,6 +49,7 @@
 #include "../../OmafDashAccess/OmafDashAccessApi.h"
 #include "../../OmafDashAccess/general.h"
 #include "KeyEvent.h"
+#include "LoadGenerator.h"
 
 #define WAIT_PACKET_TIME_OUT 10000 // 10s
 
@@ -126,34 +127,7 @@ int32_t DashAccessWrapper::Init(DashStreamingClient *pCtxDashStreaming) {
     if (nullptr == pCtxDashStreaming) {
         return ERROR_NULL_PTR;
     }
-    pCtxDashStreaming->media_url = m_params->url;
-    pCtxDashStreaming->cache_path = "/tmp/cache";
-    pCtxDashStreaming->source_type = MultiResSource;
-    pCtxDashStreaming->enable_extractor = false;
-    pCtxDashStreaming->log_callback = nullptr;
-    pCtxDashStreaming->bSync_time = false;
-
-    // init the omaf params
-    memset(&pCtxDashStreaming->omaf_params, 0, sizeof(pCtxDashStreaming->omaf_params));
-    pCtxDashStreaming->omaf_params.http_params.ssl_verify_host = 0;
-    pCtxDashStreaming->omaf_params.http_params.ssl_verify_peer = 0;
-    pCtxDashStreaming->omaf_params.http_params.conn_timeout = -1;  // not set
-    pCtxDashStreaming->omaf_params.http_params.retry_times = 3;
-    pCtxDashStreaming->omaf_params.http_params.total_timeout = -1;  // not set
-
-    pCtxDashStreaming->omaf_params.max_parallel_transfers = 256;
-    pCtxDashStreaming->omaf_params.segment_open_timeout_ms = 3000;           // ms
-    pCtxDashStreaming->omaf_params.statistic_params.enable = 0;              // enable statistic
-    pCtxDashStreaming->omaf_params.statistic_params.window_size_ms = 10000;  // ms
-
-    pCtxDashStreaming->omaf_params.synchronizer_params.enable = 0;               //  enable dash segment number syncer
-    pCtxDashStreaming->omaf_params.synchronizer_params.segment_range_size = 20;  // 20
-    pCtxDashStreaming->omaf_params.max_decode_width = 3840;
-    pCtxDashStreaming->omaf_params.max_decode_height = 2560;
-    pCtxDashStreaming->omaf_params.enable_in_time_viewport_update = false;
-    pCtxDashStreaming->omaf_params.max_response_times_in_seg = 0;
-    pCtxDashStreaming->omaf_params.max_catchup_width = 3840;
-    pCtxDashStreaming->omaf_params.max_catchup_height = 2560;
+    SetupStreamingClient(pCtxDashStreaming, m_params->url, "/tmp/cache");
 
     m_handler = OmafAccess_Init(pCtxDashStreaming);
     if (nullptr == m_handler) {
@@ -384,6 +358,11 @@ void Help() {
     cout << " --mode                     assigned motion mode: fixed, horizontal, vertical, slope." << endl;
     cout << " --initpose                 an initial pose coordinate." << endl;
     cout << " -o, --out                  data output path." << endl;
+    cout << " --sessions                 run N concurrent sessions as a load generator, reports go to --out." << endl;
+    cout << " --trace                    head motion trace of load sessions, one time_ms,yaw,pitch per line." << endl;
+    cout << "                            randomized traces are used if not set." << endl;
+    cout << " --seed                     seed of randomized traces, 1 by default." << endl;
+    cout << " --duration                 seconds to run load sessions, 0 for until end of stream." << endl;
     cout << " press [q] to quit." << endl;
 }
 
@@ -397,6 +376,10 @@ int main(int argc, char* argv[]) {
         { "mode", required_argument, &lopt, 3 },
         { "initpose", required_argument, &lopt, 4 },
         { "out", required_argument, nullptr, 'o' },
+        { "sessions", required_argument, &lopt, 5 },
+        { "trace", required_argument, &lopt, 6 },
+        { "seed", required_argument, &lopt, 7 },
+        { "duration", required_argument, &lopt, 8 },
         { 0, 0, 0, 0 }
     };
     //input params
@@ -405,6 +388,10 @@ int main(int argc, char* argv[]) {
     char *mode = nullptr;
     char *initpose = nullptr;
     char *out = nullptr;
+    uint32_t sessions = 0;
+    char *trace = nullptr;
+    uint32_t seed = 1;
+    uint32_t duration = 0;
     //params analysis
     if (argc == 1) return 0;
     while(1) {
@@ -421,6 +408,10 @@ int main(int argc, char* argv[]) {
                 case 2: viewport = optarg; break;
                 case 3: mode = optarg; break;
                 case 4: initpose = optarg; break;
+                case 5: sessions = atoi(optarg); break;
+                case 6: trace = optarg; break;
+                case 7: seed = atoi(optarg); break;
+                case 8: duration = atoi(optarg); break;
                 default: cout << "input parameters invalid!" << endl; break;
                 }
         }
@@ -428,6 +419,33 @@ int main(int argc, char* argv[]) {
     // cout << "url " << url << " viewport " << viewport << " mode " << mode << " initpose " << initpose << " out " << out << endl;
 
     GlogWrapper m_glogWrapper((char*)"glogClient");
+    if (sessions > 0) {
+        if (nullptr == url || nullptr == viewport) {
+            cout << "url and viewport are required!" << endl;
+            return ERROR_INVALID;
+        }
+        LoadParams loadParams;
+        sscanf(viewport, "%d,%d,%d,%d", &loadParams.fov.first, &loadParams.fov.second, &loadParams.viewport_w, &loadParams.viewport_h);
+        loadParams.url = url;
+        loadParams.sessions = sessions;
+        loadParams.trace = trace;
+        loadParams.seed = seed;
+        loadParams.duration = duration;
+        loadParams.out = out;
+
+        LoadGenerator loadGenerator(&loadParams);
+        int32_t res = loadGenerator.Start();
+        if (res != ERROR_NONE) {
+            LOG(ERROR) << "Load generator start failed!" << endl;
+            return ERROR_INVALID;
+        }
+        KeyEvent keyEvent;
+        while (!loadGenerator.IsDone() && !keyEvent.Is_quit()) {
+            usleep(100 * 1000);
+        }
+        loadGenerator.Stop();
+        return loadGenerator.Report();
+    }
     //Call OmafDashAccess APIs to simulate
     InputParams params;
     sscanf(viewport, "%d,%d,%d,%d", &params.fov.first, &params.fov.second, &params.viewport_w, &params.viewport_h);
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2022, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file     LoadGenerator.cpp
+//! \brief    Implement multiple sessions load generator of the client simulator.
+//!
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "../../utils/error.h"
+#include "../../utils/ns_def.h"
+#include "../../utils/GlogWrapper.h"
+#include "../../OmafDashAccess/OmafDashMetrics.h"
+#include "../../OmafDashAccess/general.h"
+#include "LoadGenerator.h"
+
+using namespace std;
+
+static uint64_t GetTimeUs() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SetupStreamingClient(DashStreamingClient *client, const char *url, const char *cachePath) {
+    memset(client, 0, sizeof(DashStreamingClient));
+    client->media_url = url;
+    client->cache_path = cachePath;
+    client->source_type = MultiResSource;
+    client->enable_extractor = false;
+    client->log_callback = nullptr;
+    client->bSync_time = false;
+
+    // init the omaf params
+    client->omaf_params.http_params.ssl_verify_host = 0;
+    client->omaf_params.http_params.ssl_verify_peer = 0;
+    client->omaf_params.http_params.conn_timeout = -1;  // not set
+    client->omaf_params.http_params.retry_times = 3;
+    client->omaf_params.http_params.total_timeout = -1;  // not set
+
+    client->omaf_params.max_parallel_transfers = 256;
+    client->omaf_params.segment_open_timeout_ms = 3000;           // ms
+    client->omaf_params.statistic_params.enable = 0;              // enable statistic
+    client->omaf_params.statistic_params.window_size_ms = 10000;  // ms
+
+    client->omaf_params.synchronizer_params.enable = 0;               //  enable dash segment number syncer
+    client->omaf_params.synchronizer_params.segment_range_size = 20;  // 20
+    client->omaf_params.max_decode_width = 3840;
+    client->omaf_params.max_decode_height = 2560;
+    client->omaf_params.enable_in_time_viewport_update = false;
+    client->omaf_params.max_response_times_in_seg = 0;
+    client->omaf_params.max_catchup_width = 3840;
+    client->omaf_params.max_catchup_height = 2560;
+}
+
+int32_t HeadMotionTrace::Load(const char *path) {
+    ifstream trace(path);
+    if (!trace.is_open()) {
+        LOG(ERROR) << "Failed to open head motion trace " << path << endl;
+        return ERROR_INVALID;
+    }
+    m_poses.clear();
+    string line;
+    while (getline(trace, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        TracePose pose;
+        if (sscanf(line.c_str(), "%u,%f,%f", &pose.timeMs, &pose.yaw, &pose.pitch) != 3) {
+            LOG(ERROR) << "Invalid head motion trace line: " << line << endl;
+            return ERROR_INVALID;
+        }
+        if (!m_poses.empty() && pose.timeMs < m_poses.back().timeMs) {
+            LOG(ERROR) << "Head motion trace time must be ascending: " << line << endl;
+            return ERROR_INVALID;
+        }
+        m_poses.push_back(pose);
+    }
+    if (m_poses.empty()) {
+        LOG(ERROR) << "Empty head motion trace " << path << endl;
+        return ERROR_INVALID;
+    }
+    // the last pose lasts as long as the average step before looping
+    uint32_t lastMs = m_poses.back().timeMs;
+    m_lengthMs = lastMs + (m_poses.size() > 1 ? lastMs / (m_poses.size() - 1) : 1);
+    if (m_lengthMs == lastMs) m_lengthMs++;
+    return ERROR_NONE;
+}
+
+void HeadMotionTrace::Randomize(uint32_t seed, uint32_t lengthMs, uint32_t stepMs) {
+    // random walk with the head speed up to 90 degree/s in yaw and 45 degree/s in pitch
+    mt19937 gen(seed);
+    uniform_real_distribution<float> yawSpeed(-90.0f, 90.0f);
+    uniform_real_distribution<float> pitchSpeed(-45.0f, 45.0f);
+    uniform_real_distribution<float> start(-1.0f, 1.0f);
+    m_poses.clear();
+    float yaw = start(gen) * 180;
+    float pitch = start(gen) * 30;
+    for (uint32_t timeMs = 0; timeMs < lengthMs; timeMs += stepMs) {
+        TracePose pose = { timeMs, yaw, pitch };
+        m_poses.push_back(pose);
+        yaw += yawSpeed(gen) * stepMs / 1000;
+        pitch += pitchSpeed(gen) * stepMs / 1000;
+        if (yaw >= 180) yaw -= 360;
+        if (yaw < -180) yaw += 360;
+        pitch = fmaxf(-90.0f, fminf(90.0f, pitch));
+    }
+    m_lengthMs = lengthMs;
+}
+
+void HeadMotionTrace::GetPose(uint64_t timeMs, HeadPose *pose) {
+    memset(pose, 0, sizeof(HeadPose));
+    if (m_poses.empty()) return;
+    uint32_t loopMs = timeMs % m_lengthMs;
+    auto it = upper_bound(m_poses.begin(), m_poses.end(), loopMs,
+                          [](uint32_t t, const TracePose &p) { return t < p.timeMs; });
+    if (it != m_poses.begin()) it--;
+    pose->yaw = it->yaw;
+    pose->pitch = it->pitch;
+    pose->zoomFactor = 1.0f;
+    pose->viewOrient.mode = ORIENT_NONE;
+}
+
+LoadSession::LoadSession(uint32_t id, LoadParams *params, HeadMotionTrace *trace, LatencyHistogram *aggregate) {
+    m_id = id;
+    m_params = params;
+    m_trace = trace;
+    m_aggregate = aggregate;
+    m_handler = nullptr;
+    m_framerate = 0;
+    m_stop = nullptr;
+    m_bDone = false;
+    memset(&m_report, 0, sizeof(m_report));
+    m_report.id = id;
+    SetupStreamingClient(&m_client, params->url, "/tmp/cache");
+}
+
+LoadSession::~LoadSession() {
+    Close();
+}
+
+int32_t LoadSession::Open() {
+    m_handler = OmafAccess_Init(&m_client);
+    if (nullptr == m_handler) {
+        LOG(ERROR) << "Session " << m_id << " handler init failed!" << endl;
+        return ERROR_NULL_PTR;
+    }
+
+    HeadSetInfo clientInfo;
+    HeadPose pose;
+    m_trace->GetPose(0, &pose);
+    clientInfo.pose = &pose;
+    clientInfo.viewPort_hFOV = m_params->fov.first;
+    clientInfo.viewPort_vFOV = m_params->fov.second;
+    clientInfo.viewPort_Width = m_params->viewport_w;
+    clientInfo.viewPort_Height = m_params->viewport_h;
+    OmafAccess_SetupHeadSetInfo(m_handler, &clientInfo);
+
+    if (ERROR_NONE != OmafAccess_OpenMedia(m_handler, &m_client, false, (char *)"", (char *)"")) {
+        LOG(ERROR) << "Session " << m_id << " open media failed!" << endl;
+        return ERROR_INVALID;
+    }
+    DashMediaInfo mediaInfo;
+    OmafAccess_GetMediaInfo(m_handler, &mediaInfo);
+    if (mediaInfo.stream_info[0].framerate_den != 0)
+        m_framerate = round(float(mediaInfo.stream_info[0].framerate_num) / mediaInfo.stream_info[0].framerate_den);
+    if (0 == m_framerate) m_framerate = 30;
+    return ERROR_NONE;
+}
+
+int32_t LoadSession::Start(atomic<bool> *stop) {
+    m_stop = stop;
+    int32_t ret = OmafAccess_StartStreaming(m_handler);
+    if (ERROR_NONE != ret) {
+        LOG(ERROR) << "Session " << m_id << " start streaming failed!" << endl;
+        return ret;
+    }
+    m_thread = thread(&LoadSession::Run, this);
+    return ERROR_NONE;
+}
+
+int32_t LoadSession::WaitFrame(uint64_t *bytes, bool *eos) {
+    uint64_t start = GetTimeUs();
+    while (!m_stop->load()) {
+        DashPacket dashPkt[16];
+        memset(dashPkt, 0, 16 * sizeof(DashPacket));
+        int dashPktNum = 0;
+        uint64_t pts = 0;
+        int ret = OmafAccess_GetPacket(m_handler, 0, &(dashPkt[0]), &dashPktNum, &pts, true, false);
+        if (ERROR_NONE == ret) {
+            *eos = dashPkt[0].bEOS && !dashPkt[0].bCatchup;
+            *bytes = 0;
+            for (int i = 0; i < dashPktNum; i++) {
+                *bytes += dashPkt[i].size;
+                SAFE_FREE(dashPkt[i].buf);
+                if (dashPkt[i].rwpk) SAFE_DELARRAY(dashPkt[i].rwpk->rectRegionPacking);
+                SAFE_DELETE(dashPkt[i].rwpk);
+                SAFE_DELETE(dashPkt[i].prft);
+                SAFE_DELARRAY(dashPkt[i].qtyResolution);
+            }
+            return ERROR_NONE;
+        }
+        if (GetTimeUs() - start > (uint64_t)LOAD_WAIT_PACKET_TIMEOUT * 1000) return OMAF_ERROR_TIMED_OUT;
+        usleep(LOAD_POLL_INTERVAL * 1000);
+    }
+    return ERROR_INVALID;
+}
+
+void LoadSession::Run() {
+    uint64_t intervalUs = 1000000 / m_framerate;
+    uint64_t startUs = GetTimeUs();
+    uint64_t slotUs = startUs;
+    // sessions start at different places of a shared trace
+    uint64_t traceOffsetMs = (uint64_t)m_id * 1000;
+
+    while (!m_stop->load()) {
+        HeadPose pose;
+        m_trace->GetPose((slotUs - startUs) / 1000 + traceOffsetMs, &pose);
+        OmafAccess_ChangeViewport(m_handler, &pose);
+
+        uint64_t bytes = 0;
+        bool eos = false;
+        int32_t ret = WaitFrame(&bytes, &eos);
+        uint64_t nowUs = GetTimeUs();
+        if (OMAF_ERROR_TIMED_OUT == ret) {
+            LOG(WARNING) << "Session " << m_id << " wait too long to get packet, quit!" << endl;
+            m_report.timeouts++;
+            break;
+        }
+        if (ERROR_NONE != ret) break;
+
+        // frame delivery latency is from the time the frame is due to the time it is got
+        uint64_t latency = nowUs > slotUs ? nowUs - slotUs : 0;
+        if (0 == m_report.frames) m_report.startupMs = (nowUs - startUs) / 1000;
+        else {
+            m_latency.Record(latency);
+            m_aggregate->Record(latency);
+            if (latency > intervalUs) {
+                m_report.stalls++;
+                m_report.stallMs += (latency - intervalUs) / 1000;
+            }
+        }
+        m_report.frames++;
+        m_report.bytes += bytes;
+        if (eos) break;
+
+        // the playback is rebased after a stall as a player does
+        slotUs = (nowUs > slotUs + intervalUs) ? nowUs : slotUs + intervalUs;
+        nowUs = GetTimeUs();
+        if (slotUs > nowUs) usleep(slotUs - nowUs);
+    }
+    m_bDone = true;
+}
+
+void LoadSession::Close() {
+    if (m_thread.joinable()) m_thread.join();
+    if (m_handler) {
+        OmafAccess_CloseMedia(m_handler);
+        OmafAccess_Close(m_handler);
+        m_handler = nullptr;
+    }
+}
+
+void LoadSession::GetReport(SessionReport *report) {
+    *report = m_report;
+    m_latency.GetSnapshot(&report->latency);
+}
+
+LoadGenerator::LoadGenerator(LoadParams *params) {
+    m_params = params;
+    m_stop = false;
+    m_startMs = 0;
+    m_elapsedMs = 0;
+}
+
+LoadGenerator::~LoadGenerator() {
+    Stop();
+    for (auto session : m_sessions) {
+        SAFE_DELETE(session);
+    }
+    m_sessions.clear();
+}
+
+int32_t LoadGenerator::Start() {
+    if (0 == m_params->sessions || m_params->sessions > LOAD_MAX_SESSIONS) {
+        LOG(ERROR) << "Sessions number should be in [1, " << LOAD_MAX_SESSIONS << "]" << endl;
+        return ERROR_INVALID;
+    }
+    // a scripted trace is shared by all sessions, each randomized session has its own
+    m_traces.resize(m_params->trace ? 1 : m_params->sessions);
+    for (uint32_t i = 0; i < m_traces.size(); i++) {
+        if (m_params->trace) {
+            int32_t ret = m_traces[i].Load(m_params->trace);
+            if (ERROR_NONE != ret) return ret;
+        } else {
+            m_traces[i].Randomize(m_params->seed + i, LOAD_RANDOM_TRACE_LENGTH, LOAD_RANDOM_TRACE_STEP);
+        }
+    }
+
+    for (uint32_t i = 0; i < m_params->sessions; i++) {
+        HeadMotionTrace *trace = &m_traces[m_params->trace ? 0 : i];
+        LoadSession *session = new LoadSession(i, m_params, trace, &m_aggregate);
+        if (nullptr == session) return ERROR_NULL_PTR;
+        m_sessions.push_back(session);
+        int32_t ret = session->Open();
+        if (ERROR_NONE != ret) return ret;
+    }
+
+    m_startMs = GetTimeUs() / 1000;
+    for (auto session : m_sessions) {
+        int32_t ret = session->Start(&m_stop);
+        if (ERROR_NONE != ret) return ret;
+    }
+    LOG(INFO) << "Load generator started " << m_sessions.size() << " sessions" << endl;
+    return ERROR_NONE;
+}
+
+bool LoadGenerator::IsDone() {
+    if (m_params->duration && GetTimeUs() / 1000 - m_startMs >= (uint64_t)m_params->duration * 1000) return true;
+    for (auto session : m_sessions) {
+        if (!session->IsDone()) return false;
+    }
+    return true;
+}
+
+void LoadGenerator::Stop() {
+    if (m_stop.exchange(true)) return;
+    m_elapsedMs = GetTimeUs() / 1000 - m_startMs;
+    for (auto session : m_sessions) {
+        session->Close();
+    }
+}
+
+int32_t LoadGenerator::Report() {
+    ostringstream report;
+    report << "session,frames,stalls,stall_ms,timeouts,bytes,startup_ms,latency_p50_us,latency_p90_us,latency_p99_us,latency_p999_us,latency_max_us" << endl;
+    SessionReport total;
+    memset(&total, 0, sizeof(total));
+    for (auto session : m_sessions) {
+        SessionReport one;
+        session->GetReport(&one);
+        report << one.id << "," << one.frames << "," << one.stalls << "," << one.stallMs << "," << one.timeouts << ","
+               << one.bytes << "," << one.startupMs << "," << one.latency.p50 << "," << one.latency.p90 << ","
+               << one.latency.p99 << "," << one.latency.p999 << "," << one.latency.max << endl;
+        total.frames += one.frames;
+        total.stalls += one.stalls;
+        total.stallMs += one.stallMs;
+        total.timeouts += one.timeouts;
+        total.bytes += one.bytes;
+        total.startupMs = (one.startupMs > total.startupMs) ? one.startupMs : total.startupMs;
+    }
+    m_aggregate.GetSnapshot(&total.latency);
+    report << "all," << total.frames << "," << total.stalls << "," << total.stallMs << "," << total.timeouts << ","
+           << total.bytes << "," << total.startupMs << "," << total.latency.p50 << "," << total.latency.p90 << ","
+           << total.latency.p99 << "," << total.latency.p999 << "," << total.latency.max << endl;
+
+    uint64_t elapsedMs = m_elapsedMs ? m_elapsedMs : 1;
+    uint64_t fetchedBytes = MetricsRegistry::GetInstance()->GetCounterValue(CLIENT_DOWNLOADED_BYTES);
+    report << "# sessions " << m_sessions.size() << ", elapsed " << elapsedMs << " ms, " << fixed << setprecision(1)
+           << total.frames * 1000.0 / elapsedMs << " frames/s, fetched " << fetchedBytes << " bytes ("
+           << fetchedBytes * 8.0 / 1000 / elapsedMs << " Mbps)" << endl;
+
+    cout << report.str();
+    if (m_params->out) {
+        ofstream out(m_params->out, ios::out);
+        if (!out.is_open()) {
+            LOG(ERROR) << "Failed to open report file " << m_params->out << endl;
+            return ERROR_INVALID;
+        }
+        out << report.str();
+    }
+    return ERROR_NONE;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2022, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file     LoadGenerator.h
+//! \brief    Multiple sessions load generator of the client simulator.
+//!
+
+#ifndef _LOADGENERATOR_H_
+#define _LOADGENERATOR_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../utils/data_type.h"
+#include "../../utils/MetricsRegistry.h"
+#include "../../OmafDashAccess/OmafDashAccessApi.h"
+
+#define LOAD_MAX_SESSIONS        256
+#define LOAD_WAIT_PACKET_TIMEOUT 10000  // ms
+#define LOAD_POLL_INTERVAL       1      // ms
+#define LOAD_RANDOM_TRACE_LENGTH 60000  // ms
+#define LOAD_RANDOM_TRACE_STEP   100    // ms
+
+struct _loadParams {
+    char *url;
+    std::pair<uint32_t, uint32_t> fov;
+    uint32_t viewport_w;
+    uint32_t viewport_h;
+    uint32_t sessions;
+    char *trace;        //!< head motion trace file, randomized trace if null
+    uint32_t seed;      //!< seed of randomized traces, session i uses seed + i
+    uint32_t duration;  //!< seconds to run, 0 for until end of stream
+    char *out;          //!< report path
+};
+
+using LoadParams = _loadParams;
+
+//!
+//! \brief  Fill the streaming client with the default settings of the simulator
+//!
+//! \param  [out] client
+//!         the streaming client to fill
+//! \param  [in] url
+//!         mpd url, http(s) or local path
+//! \param  [in] cachePath
+//!         directory for downloaded segments
+//!
+//! \return void
+//!
+void SetupStreamingClient(DashStreamingClient *client, const char *url, const char *cachePath);
+
+typedef struct TRACEPOSE {
+    uint32_t timeMs;
+    float yaw;
+    float pitch;
+} TracePose;
+
+//!
+//! \class HeadMotionTrace
+//! \brief Head motion poses along time, looped when replayed past the end
+//!
+class HeadMotionTrace
+{
+public:
+    HeadMotionTrace() = default;
+
+    ~HeadMotionTrace() = default;
+
+    //!
+    //! \brief  Load a scripted trace, one "time_ms,yaw,pitch" pose per line
+    //!         in ascending time, lines starting with '#' are skipped
+    //!
+    //! \param  [in] path
+    //!         trace file path
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Load(const char *path);
+
+    //!
+    //! \brief  Generate a randomized trace as a random walk of yaw and pitch
+    //!
+    //! \param  [in] seed
+    //!         seed of the random generator
+    //! \param  [in] lengthMs
+    //!         length of the trace
+    //! \param  [in] stepMs
+    //!         time between two poses
+    //!
+    //! \return void
+    //!
+    void Randomize(uint32_t seed, uint32_t lengthMs, uint32_t stepMs);
+
+    //!
+    //! \brief  Get the pose at the given time, the latest one not after it
+    //!
+    //! \param  [in] timeMs
+    //!         time since the replay starts
+    //! \param  [out] pose
+    //!         head pose with yaw and pitch filled
+    //!
+    //! \return void
+    //!
+    void GetPose(uint64_t timeMs, HeadPose *pose);
+
+    size_t GetPosesNum() { return m_poses.size(); };
+
+private:
+    std::vector<TracePose> m_poses;
+    uint32_t               m_lengthMs = 0;
+};
+
+typedef struct SESSIONREPORT {
+    uint32_t id;
+    uint64_t frames;            //!< delivered frames
+    uint64_t stalls;            //!< frames delivered later than one frame interval
+    uint64_t stallMs;           //!< time spent on waiting beyond the frame interval
+    uint64_t timeouts;          //!< frames never delivered in LOAD_WAIT_PACKET_TIMEOUT
+    uint64_t bytes;             //!< delivered bitstream bytes
+    uint64_t startupMs;         //!< time from streaming start to the first frame
+    HistogramSnapshot latency;  //!< frame delivery latency in microsecond
+} SessionReport;
+
+//!
+//! \class LoadSession
+//! \brief One independent OmafAccess session replaying a head motion trace
+//!
+class LoadSession
+{
+public:
+    LoadSession(uint32_t id, LoadParams *params, HeadMotionTrace *trace, LatencyHistogram *aggregate);
+
+    ~LoadSession();
+
+    //!
+    //! \brief  Init, open media and start streaming
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Open();
+
+    //!
+    //! \brief  Start the session thread pulling frames at the frame rate
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Start(std::atomic<bool> *stop);
+
+    //!
+    //! \brief  Wait for the session thread, then close media
+    //!
+    //! \return void
+    //!
+    void Close();
+
+    bool IsDone() { return m_bDone; };
+
+    void GetReport(SessionReport *report);
+
+private:
+    void Run();
+
+    int32_t WaitFrame(uint64_t *bytes, bool *eos);
+
+    uint32_t            m_id;
+    LoadParams          *m_params;
+    HeadMotionTrace     *m_trace;
+    LatencyHistogram    *m_aggregate;
+    LatencyHistogram    m_latency;
+    DashStreamingClient m_client;
+    void                *m_handler;
+    uint32_t            m_framerate;
+    std::atomic<bool>   *m_stop;
+    std::atomic<bool>   m_bDone;
+    std::thread         m_thread;
+    SessionReport       m_report;
+};
+
+//!
+//! \class LoadGenerator
+//! \brief Run N sessions in one process, thread per session, and report
+//!        the per session and the aggregate frame delivery statistics
+//!
+class LoadGenerator
+{
+public:
+    LoadGenerator(LoadParams *params);
+
+    ~LoadGenerator();
+
+    //!
+    //! \brief  Open all sessions and start them
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Start();
+
+    //!
+    //! \brief  Check whether the run is over, either all sessions reach
+    //!         the end of stream or the duration is reached
+    //!
+    bool IsDone();
+
+    //!
+    //! \brief  Stop and close all sessions
+    //!
+    //! \return void
+    //!
+    void Stop();
+
+    //!
+    //! \brief  Write the per session and the aggregate report
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Report();
+
+private:
+    LoadParams                   *m_params;
+    std::vector<HeadMotionTrace> m_traces;
+    std::vector<LoadSession*>    m_sessions;
+    LatencyHistogram             m_aggregate;
+    std::atomic<bool>            m_stop;
+    uint64_t                     m_startMs;
+    uint64_t                     m_elapsedMs;
+};
+
+#endif /* _LOADGENERATOR_H_ */
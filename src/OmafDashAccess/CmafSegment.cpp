@@ -34,6 +34,7 @@
  */
 
 #include "CmafSegment.h"
+#include "OmafDashMetrics.h"
 #include <algorithm>
 
 VCD_OMAF_BEGIN
@@ -78,13 +79,17 @@ int CmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexce
         //dcb
         ds_params_, [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {
           // LOG(INFO) << "Receive sb size " << sb->size() << "for " << this->ds_params_.dash_url_ << endl;
-          this->dash_stream_.push_back(std::move(sb));
+          this->ReceiveStreamBlock(std::move(sb));
           this->GenerateChunkStream();
         },
         //cdcb
         [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb, map<uint32_t, uint32_t> &indexRange) {
           this->UpdateIndexStream(std::move(sb));
           indexRange = this->GetIndexRange();
+          // the chunks arrived before the index are ready now
+          if (!indexRange.empty()) {
+            this->GenerateChunkStream();
+          }
         },
         //scb
         [this](OmafDashSegmentClient::State s) {
@@ -151,7 +156,15 @@ int32_t CmafSegment::GetSegmentIndexRange(char* indexBuf, size_t size, std::map<
     }
 }
 
+void CmafSegment::ReceiveStreamBlock(std::unique_ptr<StreamBlock> sb) {
+  std::lock_guard<std::mutex> lock(recv_mutex_);
+  recv_blocks_.push_back(std::move(sb));
+}
+
 int32_t CmafSegment::GenerateChunkStream() {
+  static LatencyHistogram *chunkReadyLatency = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_CHUNK_READY_LATENCY);
+
+  std::lock_guard<std::mutex> lock(recv_mutex_);
   // 1. check data validation
   if (index_range_.empty()) {
     OMAF_LOG(LOG_WARNING, "Index range map is empty!\n");
@@ -162,31 +175,26 @@ int32_t CmafSegment::GenerateChunkStream() {
     OMAF_LOG(LOG_WARNING, "available chunk id %d is greater than chunk num %d\n", processed_chunk_id_, chunk_num_);
     return ERROR_INVALID;
   }
-  // 2. generate chunk stream from dash stream
-  // 2.1 get processed bytes
-  size_t bytesProcessed = 0;
-  for (int32_t i = start_chunk_id_; i <= processed_chunk_id_; i++) {
-    bytesProcessed += index_range_[i];
-  }
 
-  // 2.2 generate chunk stream
-  while (processed_chunk_id_ < (int32_t)chunk_num_ - 1 &&
-          dash_stream_.GetStreamSize() - bytesProcessed >= index_range_[processed_chunk_id_ + 1] &&
-          index_range_[processed_chunk_id_ + 1] != 0) {
-
-    uint32_t cur_chunk_size = index_range_[processed_chunk_id_ + 1];
-    char *buf = new char[cur_chunk_size];
-    size_t readSize = dash_stream_.ReadStreamFromOffset(buf, bytesProcessed, cur_chunk_size);
-    // LOG(INFO) << "readSize " << readSize <<" cur_chunk_size " << cur_chunk_size << endl;
-    if (readSize != cur_chunk_size) {
-      DELETE_ARRAY(buf);
-      OMAF_LOG(LOG_WARNING, "dash stream has not enough data\n");
-      return ERROR_NO_VALUE;
+  // 2. generate chunk stream from the received blocks once the last byte of the chunk arrives
+  while (processed_chunk_id_ < (int32_t)chunk_num_ - 1) {
+    auto range = index_range_.find(processed_chunk_id_ + 1);
+    if (range == index_range_.end() || range->second == 0) {
+      break;
+    }
+    // 2.1 slice the chunk as views into the blocks once its last byte arrives, no data copy
+    std::vector<std::unique_ptr<StreamBlock>> chunk;
+    std::chrono::steady_clock::time_point last_recv_time;
+    if (!recv_blocks_.slice(range->second, chunk, last_recv_time)) {
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> chunk_lock(chunk_stream_mutex_);
+      chunk_stream_.push_back(std::move(chunk));
     }
-    std::unique_ptr<StreamBlock> chunk_sb = make_unique_vcd<StreamBlock>(std::move(buf), cur_chunk_size);
-    chunk_stream_.push_back(std::move(chunk_sb));
-    bytesProcessed += readSize;
     processed_chunk_id_++;
+    chunkReadyLatency->Record(MetricsElapsedUs(last_recv_time));
     // chunk state change: generate node from chunk stream
     if (this->state_change_cb_) {
       this->state_change_cb_(this->shared_from_this(), State::OPEN_SUCCES);
@@ -194,7 +202,7 @@ int32_t CmafSegment::GenerateChunkStream() {
   }
 
   if (processed_chunk_id_ == (int32_t)chunk_num_ - 1) {
-    dash_stream_.clear();
+    recv_blocks_.clear();
   }
 
   return ERROR_NONE;
@@ -203,6 +211,7 @@ int32_t CmafSegment::GenerateChunkStream() {
 int32_t CmafSegment::UpdateIndexStream(std::unique_ptr<StreamBlock> sb)
 {
   if (reader_ == nullptr) return ERROR_NULL_PTR;
+  std::lock_guard<std::mutex> lock(recv_mutex_);
   int64_t sb_size = sb->size();
   index_stream_.clear();
   index_stream_.push_back(std::move(sb));
@@ -72,17 +72,24 @@ class CmafSegment : public OmafSegment {
   // @brief calling success or not
   virtual int Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexcept;
 
-  virtual std::unique_ptr<StreamBlock> PopOneStreamBlock() noexcept {
-    if (chunk_stream_.GetStreamBlockSize() != 0) {
-      return chunk_stream_.pop_front();
+  virtual bool PopOneChunk(std::vector<std::unique_ptr<StreamBlock>>& chunk) noexcept {
+    std::lock_guard<std::mutex> lock(chunk_stream_mutex_);
+    if (chunk_stream_.empty()) {
+      return false;
     }
-    return nullptr;
+    chunk = std::move(chunk_stream_.front());
+    chunk_stream_.pop_front();
+    return true;
   }
 
-  inline map<uint32_t, uint32_t> GetIndexRange() { return index_range_; };
+  inline map<uint32_t, uint32_t> GetIndexRange() {
+    std::lock_guard<std::mutex> lock(recv_mutex_);
+    return index_range_;
+  };
 
   //!
-  //! \brief  generate chunk stream from dash stream thread function
+  //! \brief  generate chunk stream from the received blocks, each chunk
+  //!         is made of the views into the blocks holding its data
   //!
   int32_t GenerateChunkStream();
 
@@ -110,10 +117,20 @@ private:
   //!
   bool CheckIndexBuf(char *index_buf, size_t index_size);
 
+  //!
+  //! \brief  append the stream block received for the segment
+  //!
+  void ReceiveStreamBlock(std::unique_ptr<StreamBlock> sb);
+
  private:
 
   StreamBlocks index_stream_; //<! segment index stream
-  StreamBlocks chunk_stream_; //<! output chunk stream
+
+  std::deque<std::vector<std::unique_ptr<StreamBlock>>> chunk_stream_; //<! output chunks, views into the received blocks
+  std::mutex chunk_stream_mutex_; //<! for chunk_stream_
+
+  StreamChunkSlicer recv_blocks_; //<! received blocks not sliced up yet
+  std::mutex recv_mutex_; //<! for received blocks and index range
 
   int64_t index_length_ = 0; //<! index box size
 
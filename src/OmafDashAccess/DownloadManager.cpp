@@ -63,9 +63,21 @@ DownloadManager::DownloadManager() {
   // same random file name, so ignore 0
   m_count = 1;
   mUseCache = false;
+  mCachedSize = 0;
+  mCacheHits = 0;
+  mCacheMisses = 0;
+  mCacheSavedBytes = 0;
+  mWriterStop = false;
 }
 
-DownloadManager::~DownloadManager() { }
+DownloadManager::~DownloadManager() {
+  {
+    std::lock_guard<std::mutex> lock(mTaskMutex);
+    mWriterStop = true;
+  }
+  mTaskCond.notify_all();
+  if (mCacheWriter.joinable()) mCacheWriter.join();
+}
 
 int DownloadManager::DeleteCacheFile(std::string url) {
   if (remove(url.c_str())) {
@@ -93,6 +105,126 @@ std::string DownloadManager::AssignCacheFileName() {
   return file_name;
 }
 
+bool DownloadManager::LookupCache(const std::string &url, std::string &cacheFile) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto it = mCacheIndex.find(url);
+  if (it == mCacheIndex.end()) {
+    mCacheMisses++;
+    return false;
+  }
+
+  // move to the front as the most recently used one
+  mCacheList.splice(mCacheList.begin(), mCacheList, it->second);
+  it->second->refCount++;
+  cacheFile = it->second->file;
+  mCacheHits++;
+  mCacheSavedBytes += it->second->size;
+  return true;
+}
+
+bool DownloadManager::IsCached(const std::string &url) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mCacheIndex.find(url) != mCacheIndex.end();
+}
+
+int DownloadManager::InsertCache(const std::string &url, const std::string &cacheFile, uint64_t size) {
+  std::list<std::string> evictedFiles;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mCacheIndex.find(url);
+    if (it != mCacheIndex.end()) {
+      // cached by another download of the same url, keep the existing one
+      if (it->second->file != cacheFile) evictedFiles.push_back(cacheFile);
+    } else {
+      CacheEntry entry;
+      entry.url = url;
+      entry.file = cacheFile;
+      entry.size = size;
+      entry.refCount = 0;
+      mCacheList.push_front(entry);
+      mCacheIndex[url] = mCacheList.begin();
+      mCachedSize += size;
+      EvictCache(evictedFiles);
+    }
+  }
+
+  // delete files out of the lock, they are not reachable from the index any more
+  for (auto &file : evictedFiles) {
+    DeleteCacheFile(file);
+  }
+  return ERROR_NONE;
+}
+
+void DownloadManager::ReleaseCacheFile(const std::string &url) {
+  std::list<std::string> evictedFiles;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mCacheIndex.find(url);
+    if (it == mCacheIndex.end() || it->second->refCount == 0) return;
+
+    it->second->refCount--;
+    // the pinned files may have kept the cache over size
+    if (mCachedSize > mMaxCacheSize) EvictCache(evictedFiles);
+  }
+
+  for (auto &file : evictedFiles) {
+    DeleteCacheFile(file);
+  }
+}
+
+void DownloadManager::EvictCache(std::list<std::string> &evictedFiles) {
+  auto it = mCacheList.end();
+  while (mCachedSize > mMaxCacheSize && it != mCacheList.begin()) {
+    --it;
+    if (it->refCount) continue;
+
+    evictedFiles.push_back(it->file);
+    mCachedSize -= it->size;
+    mCacheIndex.erase(it->url);
+    it = mCacheList.erase(it);
+  }
+}
+
+bool DownloadManager::PostCacheTask(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mTaskMutex);
+    if (mWriterStop) return false;
+    // drop the task instead of blocking the download when the disk is slow
+    if (mCacheTasks.size() >= MAX_PENDING_CACHE_TASKS) {
+      OMAF_LOG(LOG_WARNING, "Too many segments are pending to be cached, skip caching one!\n");
+      return false;
+    }
+    if (!mCacheWriter.joinable()) {
+      mCacheWriter = std::thread(&DownloadManager::CacheWriterLoop, this);
+    }
+    mCacheTasks.push_back(std::move(task));
+  }
+  mTaskCond.notify_one();
+  return true;
+}
+
+void DownloadManager::CacheWriterLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mTaskMutex);
+      mTaskCond.wait(lock, [this]() { return mWriterStop || !mCacheTasks.empty(); });
+      // the pending tasks are dropped on stop, the cache is cleaned with the process
+      if (mWriterStop) return;
+      task = std::move(mCacheTasks.front());
+      mCacheTasks.pop_front();
+    }
+    task();
+  }
+}
+
+void DownloadManager::GetCacheStatistics(uint64_t &hits, uint64_t &misses, uint64_t &savedBytes) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  hits = mCacheHits;
+  misses = mCacheMisses;
+  savedBytes = mCacheSavedBytes;
+}
+
 /// get download bit rate
 int DownloadManager::GetImmediateBitrate() { return 0; }
 
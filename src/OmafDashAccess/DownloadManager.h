@@ -38,7 +38,15 @@
 #define _DOWNLOADMANAGER_H
 
 #include "general.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#define MAX_PENDING_CACHE_TASKS 64  //<! max number of segments queued for writing to cache
 
 typedef bool (*enum_dir_item)(void *cbck, std::string item_name, std::string item_path);
 
@@ -77,6 +85,76 @@ public:
     //!
     std::string AssignCacheFileName();
 
+    //!
+    //! \brief  Look up the cached file of a segment url. The hit file
+    //!         becomes the most recently used one and is pinned against
+    //!         eviction until ReleaseCacheFile is called for the url
+    //!
+    //! \param  [in] url
+    //!         the url of the segment
+    //! \param  [out] cacheFile
+    //!         the cached file of the segment
+    //!
+    //! \return bool
+    //!         true if the segment is cached, else false
+    //!
+    bool LookupCache(const std::string& url, std::string& cacheFile);
+
+    //!
+    //! \brief  Check whether a segment url is cached, the lookup statistics
+    //!         and the recently used order are not changed
+    //!
+    bool IsCached(const std::string& url);
+
+    //!
+    //! \brief  Add a downloaded segment file to cache, then evict the least
+    //!         recently used files which aren't pinned until the total cached
+    //!         size is no more than the max cache size
+    //!
+    //! \param  [in] url
+    //!         the url of the segment
+    //! \param  [in] cacheFile
+    //!         the file holding the segment, owned by the cache from now on
+    //! \param  [in] size
+    //!         the file size
+    //!
+    //! \return int
+    //!         ERROR_NONE if success, else ERROR_INVALID
+    //!
+    int InsertCache(const std::string& url, const std::string& cacheFile, uint64_t size);
+
+    //!
+    //! \brief  Unpin the cached file got from LookupCache
+    //!
+    void ReleaseCacheFile(const std::string& url);
+
+    //!
+    //! \brief  Queue a task writing a segment to cache, the tasks run in
+    //!         order on the cache writer thread, so that segment files are
+    //!         not written on the download callback thread. The writer
+    //!         thread is launched with the first task.
+    //!
+    //! \param  [in] task
+    //!         the task to write the segment file and insert it to cache
+    //!
+    //! \return bool
+    //!         true if the task is queued, false if it is dropped since
+    //!         too many tasks are pending
+    //!
+    bool PostCacheTask(std::function<void()> task);
+
+    //!
+    //! \brief  Get the statistics of cache lookups
+    //!
+    //! \param  [out] hits
+    //!         the number of lookups hit in cache
+    //! \param  [out] misses
+    //!         the number of lookups missed in cache
+    //! \param  [out] savedBytes
+    //!         the bytes of hit segments which needn't to be downloaded
+    //!
+    void GetCacheStatistics(uint64_t& hits, uint64_t& misses, uint64_t& savedBytes);
+
     //!
     //! \brief  Get a downloading bit rate
     //!
@@ -95,6 +173,7 @@ public:
     void        SetStartTime(uint64_t size)             { mStartTime = size;           };
     uint64_t    GetStartTime()                          { return mStartTime;           };
     uint64_t    GetDownloadBytes()                      { return mDownloadedBytes;     };
+    uint64_t    GetCachedSize()                         { std::lock_guard<std::mutex> lock(mMutex); return mCachedSize; };
     std::string GetCacheFolder()                        { return mCacheDir;            };
     int         SetCacheFolder( std::string cache_dir );
     void        SetFilePrefix(std::string prefix)       { mFilePrefix = prefix;        };
@@ -142,7 +221,33 @@ private:
     //!
     std::string GetRandomString(int size);
 
+    //!
+    //! \brief  take out the least recently used entries which aren't pinned
+    //!         until the cached size fits, mMutex must be held
+    //!
+    //! \param  [out] evictedFiles
+    //!         the files to delete after releasing the lock
+    //!
+    void EvictCache(std::list<std::string>& evictedFiles);
+
+    //!
+    //! \brief  the cache writer thread, run the queued tasks until stopped
+    //!
+    void CacheWriterLoop();
+
 private:
+    //!
+    //! \brief  the cached segment file of one url
+    //!
+    struct CacheEntry {
+        std::string url;      //<! the url of the segment
+        std::string file;     //<! the cached file
+        uint64_t    size;     //<! the file size
+        uint32_t    refCount; //<! the number of segments reading the file
+    };
+
+    typedef std::list<CacheEntry> CacheList;
+
     int                            mDownloadedBytes;    //<! the total downloaded bytes
     int                            mDownloadedFiles;    //<! the total downloaded files
     std::string                    mCacheDir;           //<! the directory of the cache file
@@ -153,6 +258,17 @@ private:
     bool                           mUseCache;           //<! the flag to indicate whether using file caching
     int32_t                        m_count;             //<! count for random file name
     std::mutex                     mCacheMtx;                //<! mutex for cache clear
+    CacheList                      mCacheList;          //<! cached files, the most recently used first
+    std::unordered_map<std::string, CacheList::iterator> mCacheIndex; //<! index of cached files by url
+    uint64_t                       mCachedSize;         //<! the total size of cached files
+    uint64_t                       mCacheHits;          //<! the number of lookups hit in cache
+    uint64_t                       mCacheMisses;        //<! the number of lookups missed in cache
+    uint64_t                       mCacheSavedBytes;    //<! the bytes of hit segments
+    std::thread                    mCacheWriter;        //<! the thread writing segments to cache
+    std::mutex                     mTaskMutex;          //<! mutex for the cache tasks
+    std::condition_variable        mTaskCond;           //<! signaled when a task is queued or on stop
+    std::deque<std::function<void()>> mCacheTasks;      //<! the pending cache tasks
+    bool                           mWriterStop;         //<! flag to stop the cache writer thread
 };
 
 typedef VCD::VRVideo::Singleton<DownloadManager> DOWNLOADMANAGER;    //<! singleton of DownloadManager
@@ -41,8 +41,10 @@
 #include "common.h"
 #include "general.h"
 #include "iso_structure.h"
+#include "MediaPacketPool.h"
 
 #include <memory>
+#include <new>
 
 namespace VCD {
 namespace OMAF {
@@ -69,9 +71,7 @@ class MediaPacket : public VCD::NonCopyable {
   //!
   virtual ~MediaPacket() {
     if (nullptr != m_pPayload) {
-      free(m_pPayload);
-      m_pPayload = nullptr;
-      m_nAllocSize = 0;
+      releaseBuffer();
       m_type = -1;
       mPts = 0;
       m_nRealSize = 0;
@@ -81,53 +81,16 @@ class MediaPacket : public VCD::NonCopyable {
     if (m_rwpk) deleteRwpk();
   };
 
-  MediaPacket* InsertParams(std::vector<uint8_t> params) {
-    char* new_dest = nullptr;
-    // FIXME align size?
-    if (m_nAllocSize >= m_nRealSize + params.size()) {
-      new_dest = m_pPayload;
-    } else {
-      void* tmp = malloc(m_nRealSize + params.size());
-      new_dest = reinterpret_cast<char*>(tmp);
-      m_nAllocSize = m_nRealSize + params.size();
-    }
-
-    // 1. move origin payload
-    memmove(new_dest + params.size(), m_pPayload, m_nRealSize);
-    memcpy_s(new_dest, m_nAllocSize - m_nRealSize, params.data(), params.size());
-    m_nRealSize += params.size();
-
-    // this is a new buffer
-    if (new_dest != m_pPayload) {
-      free(m_pPayload);
-      m_pPayload = new_dest;
-    }
-    return this;
-  }
-
-  MediaPacket* InsertADTSHdr() {
-    char* new_dest = nullptr;
-    // FIXME align size?
-    if (m_nAllocSize >= m_nRealSize + m_audioADTSHdr.size()) {
-      new_dest = m_pPayload;
-    } else {
-      void* tmp = malloc(m_nRealSize + m_audioADTSHdr.size());
-      new_dest = reinterpret_cast<char*>(tmp);
-      m_nAllocSize = m_nRealSize + m_audioADTSHdr.size();
-    }
-
-    // 1. move origin payload
-    memmove(new_dest + m_audioADTSHdr.size(), m_pPayload, m_nRealSize);
-    memcpy_s(new_dest, m_nAllocSize - m_nRealSize, m_audioADTSHdr.data(), m_audioADTSHdr.size());
-    m_nRealSize += m_audioADTSHdr.size();
+  //!
+  //! \brief  prepend the VPS/SPS/PPS to the payload, the reserved headroom
+  //!         is used if it is big enough, or the payload is moved
+  //!
+  MediaPacket* InsertParams(const std::vector<uint8_t>& params) { return prependData(params.data(), params.size()); }
 
-    // this is a new buffer
-    if (new_dest != m_pPayload) {
-      free(m_pPayload);
-      m_pPayload = new_dest;
-    }
-    return this;
-  }
+  //!
+  //! \brief  prepend the ADTS header to the audio payload
+  //!
+  MediaPacket* InsertADTSHdr() { return prependData(m_audioADTSHdr.data(), m_audioADTSHdr.size()); }
 
   //!
   //! \brief  Allocate the packet buffer, and fill the buffer with fill
@@ -136,23 +99,39 @@ class MediaPacket : public VCD::NonCopyable {
   //!         the buffer size to be allocated
   //! \param  [in] fill
   //!         the init value for the buffer
+  //! \param  [in] headroom
+  //!         the size reserved in front of the payload for the headers
+  //!         inserted later
   //!
   //! \return
   //!         size of new allocated packet
   //!
-  int AllocatePacket(int size, char fill = 0) {
+  int AllocatePacket(int size, char fill = 0, size_t headroom = 0) {
     if (nullptr != m_pPayload) {
-      free(m_pPayload);
-      m_pPayload = nullptr;
-      m_nAllocSize = 0;
+      releaseBuffer();
     }
 
-    m_pPayload = (char*)malloc(size);
+    if (!acquireBuffer(size, headroom)) return -1;
 
-    if (nullptr == m_pPayload) return -1;
+    memset(m_pPayload, fill, size);
+    m_nRealSize = 0;
+    return size;
+  };
+
+  //!
+  //! \brief  Allocate the packet buffer without initialization, for the
+  //!         payload which is written right after, like the sample data
+  //!
+  //! \return
+  //!         size of new allocated packet
+  //!
+  int AllocatePayload(size_t size, size_t headroom = 0) {
+    if (nullptr != m_pPayload) {
+      releaseBuffer();
+    }
+
+    if (!acquireBuffer(size, headroom)) return -1;
 
-    m_nAllocSize = size;
-    memset(m_pPayload, fill, m_nAllocSize);
     m_nRealSize = 0;
     return size;
   };
@@ -164,12 +143,68 @@ class MediaPacket : public VCD::NonCopyable {
   //!         the buffer pointer
   //!
   char* Payload() { return m_pPayload; };
+  //!
+  //! \brief  move the payload out of the packet, it is freed by the caller
+  //!         with free()
+  //!
   char* MovePayload() {
+    if (nullptr == m_pPayload) return nullptr;
+
+    // the caller frees the buffer start, so drop the unused headroom
+    if (m_pPayload != m_pBuffer) {
+      memmove(m_pBuffer, m_pPayload, m_nRealSize);
+    }
+    PACKETPOOL::GetInstance()->Detach(m_nCapacity);
+
+    char* tmp = m_pBuffer;
+    m_pBuffer = nullptr;
+    m_pPayload = nullptr;
+    m_nCapacity = 0;
+    m_nAllocSize = 0;
+    return tmp;
+  }
+  //!
+  //! \brief  share the payload out of the packet without moving it, the
+  //!         buffer goes back to the packet pool when ReleasePayload is
+  //!         called with the returned opaque. the payload is followed by
+  //!         DASH_PACKET_PADDING_SIZE zeroed bytes
+  //!
+  //! \param  [out] opaque
+  //!         the opaque to be passed to ReleasePayload
+  //!
+  //! \return
+  //!         the payload, or nullptr if failed
+  //!
+  char* SharePayload(void** opaque) {
+    if (nullptr == m_pPayload || nullptr == opaque) return nullptr;
+
+    PayloadRef* ref = new (std::nothrow) PayloadRef;
+    if (nullptr == ref) return nullptr;
+    ref->buffer = m_pBuffer;
+    ref->capacity = m_nCapacity;
+    *opaque = ref;
+
+    memset(m_pPayload + m_nRealSize, 0, DASH_PACKET_PADDING_SIZE);
     char* tmp = m_pPayload;
+    m_pBuffer = nullptr;
     m_pPayload = nullptr;
+    m_nCapacity = 0;
+    m_nHeadroom = 0;
+    m_nAllocSize = 0;
     return tmp;
   }
   //!
+  //! \brief  give the payload shared by SharePayload back to the packet
+  //!         pool, it matches the release callback of DashPacket
+  //!
+  static void ReleasePayload(void* opaque, uint8_t* data) {
+    PayloadRef* ref = static_cast<PayloadRef*>(opaque);
+    if (nullptr == ref) return;
+
+    PACKETPOOL::GetInstance()->Release(ref->buffer, ref->capacity);
+    delete ref;
+  }
+  //!
   //! \brief  get the size of the buffer
   //!
   //! \return
@@ -184,22 +219,25 @@ class MediaPacket : public VCD::NonCopyable {
   //! \return
   //!         size of new allocated packet
   //!
-  int ReAllocatePacket(size_t size) {
-    if (nullptr == m_pPayload) return AllocatePacket(size);
-
-    if (size < m_nAllocSize) return AllocatePacket(size);
+  int ReAllocatePacket(size_t size, size_t headroom = 0) {
+    if (nullptr == m_pPayload) return AllocatePacket(size, 0, headroom);
 
-    char* buf = m_pPayload;
+    if (size < m_nAllocSize) return AllocatePacket(size, 0, headroom);
 
-    m_pPayload = (char*)malloc(size);
+    char* buf = m_pBuffer;
+    char* payload = m_pPayload;
+    size_t capacity = m_nCapacity;
+    size_t allocSize = m_nAllocSize;
 
-    if (nullptr == m_pPayload) return -1;
+    if (!acquireBuffer(size, headroom)) {
+      PACKETPOOL::GetInstance()->Release(buf, capacity);
+      return -1;
+    }
 
-    memcpy_s(m_pPayload, m_nAllocSize, buf, m_nAllocSize);
+    memcpy_s(m_pPayload, allocSize, payload, allocSize);
 
-    free(buf);
+    PACKETPOOL::GetInstance()->Release(buf, capacity);
 
-    m_nAllocSize = size;
     m_nRealSize = 0;
     return 0;
   };
@@ -373,11 +411,82 @@ class MediaPacket : public VCD::NonCopyable {
   void     SetViewId(pair<int32_t, int32_t> view_id) { m_viewID = view_id; };
   pair<int32_t, int32_t> GetViewId() { return m_viewID; };
 
+private:
+  //!
+  //! \brief  get a buffer from the packet pool for size bytes of payload
+  //!         behind headroom bytes, the old buffer should be released
+  //!
+  bool acquireBuffer(size_t size, size_t headroom) {
+    m_pBuffer = PACKETPOOL::GetInstance()->Acquire(size + headroom + DASH_PACKET_PADDING_SIZE, m_nCapacity);
+    if (nullptr == m_pBuffer) {
+      m_pPayload = nullptr;
+      m_nCapacity = 0;
+      m_nHeadroom = 0;
+      m_nAllocSize = 0;
+      return false;
+    }
+    m_nHeadroom = headroom;
+    m_pPayload = m_pBuffer + m_nHeadroom;
+    // the padding behind the payload is kept for the decoders reading ahead
+    m_nAllocSize = m_nCapacity - m_nHeadroom - DASH_PACKET_PADDING_SIZE;
+    return true;
+  }
+
+  void releaseBuffer() {
+    PACKETPOOL::GetInstance()->Release(m_pBuffer, m_nCapacity);
+    m_pBuffer = nullptr;
+    m_pPayload = nullptr;
+    m_nCapacity = 0;
+    m_nHeadroom = 0;
+    m_nAllocSize = 0;
+  }
+
+  MediaPacket* prependData(const uint8_t* data, size_t size) {
+    if (nullptr == m_pPayload || size == 0) return this;
+
+    if (m_nHeadroom >= size) {
+      // 1. enough headroom, just write the data in front of the payload
+      m_pPayload -= size;
+      m_nHeadroom -= size;
+      m_nAllocSize += size;
+    } else if (m_nAllocSize >= m_nRealSize + size) {
+      // 2. enough room in the payload, move the origin payload
+      memmove(m_pPayload + size, m_pPayload, m_nRealSize);
+    } else {
+      // 3. move the origin payload to a new buffer
+      char* buf = m_pBuffer;
+      char* payload = m_pPayload;
+      size_t capacity = m_nCapacity;
+      if (!acquireBuffer(m_nRealSize + size, 0)) {
+        PACKETPOOL::GetInstance()->Release(buf, capacity);
+        m_nRealSize = 0;
+        return this;
+      }
+      memcpy_s(m_pPayload + size, m_nAllocSize - size, payload, m_nRealSize);
+      PACKETPOOL::GetInstance()->Release(buf, capacity);
+    }
+
+    memcpy_s(m_pPayload, size, data, size);
+    m_nRealSize += size;
+    return this;
+  }
+
+  //!
+  //! \brief  the pool buffer owning a payload shared out of the packet
+  //!
+  struct PayloadRef {
+    char* buffer;
+    size_t capacity;
+  };
+
 private:
     MediaPacket& operator=(const MediaPacket& other) { return *this; };
     MediaPacket(const MediaPacket& other) { /* do not create copies */ };
 
  private:
+  char* m_pBuffer = nullptr;   //!< the buffer from packet pool
+  size_t m_nCapacity = 0;      //!< the size of the buffer
+  size_t m_nHeadroom = 0;      //!< the unused size in front of the payload
   char* m_pPayload = nullptr;  //!< the payload buffer of the packet
   size_t m_nAllocSize = 0;     //!< the allocated size of packet
   size_t m_nRealSize = 0;      //!< real size of packet
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MediaPacketPool.cpp
+//! \brief:  size classed buffer pool for media packet payloads
+//!
+
+#include "MediaPacketPool.h"
+
+#include <cstdlib>
+
+namespace VCD {
+namespace OMAF {
+
+MediaPacketPool::~MediaPacketPool() { Shrink(); }
+
+int32_t MediaPacketPool::sizeClass(size_t size, size_t &classSize) noexcept {
+  if (size <= (static_cast<size_t>(1) << PACKET_POOL_MIN_CLASS_SHIFT)) {
+    classSize = static_cast<size_t>(1) << PACKET_POOL_MIN_CLASS_SHIFT;
+    return 0;
+  }
+
+  // find 2^shift < size <= 2^(shift + 1), then round up to the quarter steps
+  uint32_t shift = PACKET_POOL_MIN_CLASS_SHIFT;
+  while (shift < PACKET_POOL_MAX_CLASS_SHIFT && (static_cast<size_t>(1) << (shift + 1)) < size) {
+    shift++;
+  }
+  if (shift >= PACKET_POOL_MAX_CLASS_SHIFT) {
+    classSize = size;
+    return -1;
+  }
+  size_t base = static_cast<size_t>(1) << shift;
+  size_t step = base / PACKET_POOL_CLASS_STEPS;
+  size_t steps = (size - base + step - 1) / step;
+  classSize = base + steps * step;
+  return static_cast<int32_t>((shift - PACKET_POOL_MIN_CLASS_SHIFT) * PACKET_POOL_CLASS_STEPS + steps);
+}
+
+char *MediaPacketPool::Acquire(size_t size, size_t &capacity) noexcept {
+  size_t classSize = 0;
+  int32_t idx = sizeClass(size, classSize);
+
+  char *buf = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    stats_.acquire_count_++;
+    if (idx >= 0 && !free_buffers_[idx].empty()) {
+      buf = free_buffers_[idx].back();
+      free_buffers_[idx].pop_back();
+      stats_.hit_count_++;
+      stats_.cached_bytes_ -= classSize;
+      stats_.in_use_bytes_ += classSize;
+      capacity = classSize;
+      return buf;
+    }
+  }
+
+  buf = static_cast<char *>(malloc(classSize));
+  if (buf == nullptr) {
+    OMAF_LOG(LOG_ERROR, "Failed to allocate packet buffer with size %lu\n", classSize);
+    capacity = 0;
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  stats_.in_use_bytes_ += classSize;
+  if (stats_.in_use_bytes_ + stats_.cached_bytes_ > stats_.peak_bytes_) {
+    stats_.peak_bytes_ = stats_.in_use_bytes_ + stats_.cached_bytes_;
+  }
+  capacity = classSize;
+  return buf;
+}
+
+void MediaPacketPool::Release(char *buf, size_t capacity) noexcept {
+  if (buf == nullptr) return;
+
+  size_t classSize = 0;
+  int32_t idx = sizeClass(capacity, classSize);
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    stats_.in_use_bytes_ -= capacity;
+    if (idx >= 0 && classSize == capacity && free_buffers_[idx].size() < PACKET_POOL_MAX_CACHED_PER_CLASS &&
+        stats_.cached_bytes_ + capacity <= PACKET_POOL_MAX_CACHED_BYTES) {
+      free_buffers_[idx].push_back(buf);
+      stats_.cached_bytes_ += capacity;
+      return;
+    }
+  }
+
+  free(buf);
+}
+
+void MediaPacketPool::Detach(size_t capacity) noexcept {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  stats_.in_use_bytes_ -= capacity;
+}
+
+void MediaPacketPool::Shrink() noexcept {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  for (auto &buffers : free_buffers_) {
+    for (auto buf : buffers) {
+      free(buf);
+    }
+    buffers.clear();
+  }
+  stats_.cached_bytes_ = 0;
+}
+
+PacketPoolStatistics MediaPacketPool::GetStatistics() noexcept {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  return stats_;
+}
+
+}  // namespace OMAF
+}  // namespace VCD
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MediaPacketPool.h
+//! \brief:  size classed buffer pool for media packet payloads
+//! \detail: payload buffers are rounded up to size classes of quarter steps
+//!          between powers of two, so no more than 25% is wasted, and
+//!          released buffers are cached for the coming packets.
+//!
+
+#ifndef MEDIAPACKETPOOL_H_
+#define MEDIAPACKETPOOL_H_
+
+#include "common.h"
+#include "general.h"
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace VCD {
+namespace OMAF {
+
+const uint32_t PACKET_POOL_MIN_CLASS_SHIFT = 10;               //!< 1KB, the smallest size class
+const uint32_t PACKET_POOL_MAX_CLASS_SHIFT = 26;               //!< 64MB, larger buffers are not cached
+const uint32_t PACKET_POOL_CLASS_STEPS = 4;                    //!< size classes from one power of two to the next
+const size_t PACKET_POOL_MAX_CACHED_PER_CLASS = 64;            //!< max cached buffers in one size class
+const uint64_t PACKET_POOL_MAX_CACHED_BYTES = 256 * 1024 * 1024;  //!< max cached bytes of the pool
+
+class PacketPoolStatistics {
+ public:
+  uint64_t acquire_count_ = 0;  //!< buffers acquired from the pool
+  uint64_t hit_count_ = 0;      //!< buffers served from the cached ones
+  uint64_t in_use_bytes_ = 0;   //!< bytes of buffers owned by packets
+  uint64_t cached_bytes_ = 0;   //!< bytes of buffers cached for reuse
+  uint64_t peak_bytes_ = 0;     //!< peak of in use and cached bytes
+
+  double hitRate() const { return acquire_count_ ? static_cast<double>(hit_count_) / acquire_count_ : 0.0; }
+
+  std::string to_string() const {
+    std::stringstream ss;
+    ss << "packet pool: {" << std::endl;
+    ss << "\tacquired: " << acquire_count_ << ", hit: " << hit_count_ << ", hit rate: " << hitRate() << std::endl;
+    ss << "\tin use bytes: " << in_use_bytes_ << ", cached bytes: " << cached_bytes_
+       << ", peak bytes: " << peak_bytes_ << std::endl;
+    ss << "}";
+    return ss.str();
+  }
+};
+
+//!
+//! \class  MediaPacketPool
+//! \brief  buffer pool for MediaPacket payloads, the buffers are allocated
+//!         with malloc, so one buffer can be detached from the pool and
+//!         freed by the owner outside
+//!
+class MediaPacketPool {
+ public:
+  MediaPacketPool() = default;
+  ~MediaPacketPool();
+
+ public:
+  //!
+  //! \brief  acquire one buffer no smaller than size
+  //!
+  //! \param  [in] size
+  //!         the required buffer size
+  //! \param  [out] capacity
+  //!         the real size of the buffer, required in Release/Detach
+  //!
+  //! \return char*
+  //!         the buffer, or nullptr if failed
+  //!
+  char *Acquire(size_t size, size_t &capacity) noexcept;
+
+  //!
+  //! \brief  give the buffer back to the pool, it is cached or freed
+  //!
+  void Release(char *buf, size_t capacity) noexcept;
+
+  //!
+  //! \brief  the buffer leaves the pool and the owner frees it
+  //!
+  void Detach(size_t capacity) noexcept;
+
+  //!
+  //! \brief  drop all the cached buffers
+  //!
+  void Shrink() noexcept;
+
+  PacketPoolStatistics GetStatistics() noexcept;
+
+ private:
+  MediaPacketPool(const MediaPacketPool &) = delete;
+  MediaPacketPool &operator=(const MediaPacketPool &) = delete;
+
+  //!
+  //! \brief  get the size class index and its buffer size, returns -1
+  //!         if the size is larger than the max class
+  //!
+  static int32_t sizeClass(size_t size, size_t &classSize) noexcept;
+
+ private:
+  std::mutex pool_mutex_;
+  std::vector<char *> free_buffers_[(PACKET_POOL_MAX_CLASS_SHIFT - PACKET_POOL_MIN_CLASS_SHIFT) * PACKET_POOL_CLASS_STEPS + 1];
+  PacketPoolStatistics stats_;
+};
+
+typedef VCD::VRVideo::Singleton<MediaPacketPool> PACKETPOOL;  //<! singleton of MediaPacketPool
+
+}  // namespace OMAF
+}  // namespace VCD
+
+#endif  // MEDIAPACKETPOOL_H_
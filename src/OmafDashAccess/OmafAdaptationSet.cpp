@@ -36,6 +36,7 @@
 #include "OmafAdaptationSet.h"
 #include "OmafReaderManager.h"
 #include "CmafSegment.h"
+#include "DownloadManager.h"
 
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
@@ -63,6 +64,8 @@ OmafAdaptationSet::OmafAdaptationSet() {
   m_bMain = false;
   mActiveSegNum = 1;
   mSegNum = 1;
+  mLocalPrefetchNum = LOCAL_SEGMENT_PREFETCH_NUM;
+  mPrefetchedSegNum = 0;
   mStartSegNum = 1;
   mStartChunkId = 0;
   mChunkInfoType = ChunkInfoType::NO_CHUNKINFO;
@@ -383,9 +386,36 @@ OmafSegment::Ptr OmafAdaptationSet::LoadAssignedSegment(std::string assignedSegm
   newSeg->SetSegmentCacheFile(assignedSegment);
   newSeg->SetSegStored();
 
+  PrefetchLocalSegments(assignedSegment, newSeg->GetSegID());
+
   return newSeg;
 }
 
+void OmafAdaptationSet::PrefetchLocalSegments(const std::string& assignedSegment, int segNum) {
+  if (mLocalPrefetchNum <= 0 || nullptr == mRepresentation || mBaseURL.empty()) return;
+
+  SegmentElement* seg = mRepresentation->GetSegment();
+  if (nullptr == seg) return;
+
+  size_t pos = assignedSegment.rfind('/');
+  std::string folder = (pos == std::string::npos) ? "" : assignedSegment.substr(0, pos + 1);
+  auto repID = mRepresentation->GetId();
+  auto fileNameOf = [&](int number) {
+    std::string url = seg->GenerateCompleteURL(mBaseURL, repID, number);
+    size_t sep = url.rfind('/');
+    return (sep == std::string::npos) ? url : url.substr(sep + 1);
+  };
+
+  // the assigned files are not named by the media template, so the next
+  // files can't be located
+  if (folder + fileNameOf(segNum) != assignedSegment) return;
+
+  for (int number = std::max(segNum, mPrefetchedSegNum) + 1; number <= segNum + mLocalPrefetchNum; number++) {
+    if (!OmafMappedFile::Prefetch(folder + fileNameOf(number))) break;
+    mPrefetchedSegNum = number;
+  }
+}
+
 /////Download relative methods
 
 int OmafAdaptationSet::DownloadInitializeSegment() {
@@ -526,7 +556,17 @@ int OmafAdaptationSet::DownloadSegment(bool enableCMAF) {
     pSegment->SetExtractor(IsExtractor());
     pSegment->SetCatchup(false);
     pSegment->SetViewId(mViewID);
-    ret = omaf_reader_mgr_->OpenSegment(std::move(pSegment), IsExtractor());
+
+    // the segment downloaded before, e.g. after seeking backward, is read from the cache
+    DownloadManager* pDM = DOWNLOADMANAGER::GetInstance();
+    std::string cacheFile;
+    if (!enableCMAF && pDM->UseCache() && pDM->LookupCache(params.dash_url_, cacheFile)) {
+      OMAF_LOG(LOG_INFO, "Hit cached file %s for segment %s\n", cacheFile.c_str(), params.dash_url_.c_str());
+      pSegment->SetSegCached(cacheFile);
+      ret = omaf_reader_mgr_->OpenLocalSegment(std::move(pSegment), IsExtractor());
+    } else {
+      ret = omaf_reader_mgr_->OpenSegment(std::move(pSegment), IsExtractor());
+    }
 
     if (ERROR_NONE != ret) {
       OMAF_LOG(LOG_ERROR, "Fail to Download OmafSegment for AdaptationSet: %d\n", this->mID);
@@ -716,6 +756,61 @@ int OmafAdaptationSet::UpdateStartNumberByTime(uint64_t nAvailableStartTime) {
   return mActiveSegNum;
 }
 
+int OmafAdaptationSet::UpdateFromMPD(AdaptationSetElement* pAdaptationSet) {
+  if (nullptr == pAdaptationSet || nullptr == mRepresentation) return ERROR_NULL_PTR;
+
+  std::vector<RepresentationElement*> pRep = pAdaptationSet->GetRepresentations();
+  if (pRep.empty()) return ERROR_INVALID;
+
+  RepresentationElement* newRep = pRep[0];
+  for (auto rep : pRep) {
+    if (rep->GetId() == mRepresentation->GetId()) {
+      newRep = rep;
+      break;
+    }
+  }
+
+  SegmentElement* segment = mRepresentation->GetSegment();
+  SegmentElement* newSegment = newRep->GetSegment();
+  if (segment && newSegment) {
+    if (segment->GetStartNumber() != newSegment->GetStartNumber()) {
+      OMAF_LOG(LOG_INFO, "AdaptationSet %d start number is updated to %d\n", mID, newSegment->GetStartNumber());
+      segment->SetStartNumber(newSegment->GetStartNumber());
+    }
+    if (segment->GetDuration() != newSegment->GetDuration() ||
+        segment->GetTimescale() != newSegment->GetTimescale()) {
+      OMAF_LOG(LOG_INFO, "AdaptationSet %d segment duration is updated to %d\n", mID, newSegment->GetDuration());
+      segment->SetDuration(newSegment->GetDuration());
+      segment->SetTimescale(newSegment->GetTimescale());
+    }
+    if (segment->GetMedia() != newSegment->GetMedia()) {
+      OMAF_LOG(LOG_INFO, "AdaptationSet %d media template is updated to %s\n", mID, newSegment->GetMedia().c_str());
+      segment->SetMedia(newSegment->GetMedia());
+    }
+    if (segment->GetInitialization() != newSegment->GetInitialization()) {
+      segment->SetInitialization(newSegment->GetInitialization());
+    }
+
+    mStartNumber = segment->GetStartNumber();
+    if (segment->GetTimescale()) {
+      mSegmentDuration = segment->GetDuration() / segment->GetTimescale();
+    }
+    mChunkDuration = mSegmentDuration * 1000;
+  }
+
+  ResyncElement* resync = mRepresentation->GetResync();
+  ResyncElement* newResync = newRep->GetResync();
+  if (resync && newResync) {
+    if (resync->GetChunkDuration() != newResync->GetChunkDuration()) {
+      OMAF_LOG(LOG_INFO, "AdaptationSet %d chunk duration is updated to %s\n", mID, newResync->GetChunkDuration().c_str());
+      resync->SetChunkDuration(newResync->GetChunkDuration());
+    }
+    mChunkDuration = StringToInt(resync->GetChunkDuration());  // ms
+  }
+
+  return ERROR_NONE;
+}
+
 OmafSegment::Ptr OmafAdaptationSet::GetNextSegment() {
   OmafSegment::Ptr seg;
 
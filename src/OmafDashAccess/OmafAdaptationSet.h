@@ -91,6 +91,12 @@ class OmafAdaptationSet {
 
   OmafSegment::Ptr LoadAssignedSegment(std::string assignedSegment);
 
+  //!
+  //! \brief  Set the number of next local segment files to read ahead
+  //!         when a local segment file is assigned, 0 to disable
+  //!
+  void SetLocalPrefetchNum(int num) { mLocalPrefetchNum = num; };
+
   //!
   //! \brief  Get InitializeSegment for reading.
   //!
@@ -116,6 +122,14 @@ class OmafAdaptationSet {
   //!
   int UpdateStartNumberByTime(uint64_t nAvailableStartTime);
 
+  //!
+  //! \brief  update segment information in place with the AdaptationSet
+  //!         in refreshed MPD, the state of segments being downloaded is kept
+  //! \param  pAdaptationSet : the AdaptationSetElement with the same id in refreshed MPD
+  //! \return ERROR_NONE if success, else fail reason
+  //!
+  int UpdateFromMPD(AdaptationSetElement* pAdaptationSet);
+
   void UpdateSegmentNumber(int64_t segnum) { mActiveSegNum = segnum; };
   int64_t GetSegmentNumber(void) const { return mActiveSegNum; };
   std::string GetUrl(const SegmentSyncNode& node) const;
@@ -234,6 +248,12 @@ class OmafAdaptationSet {
 
   void ClearSegList();
 
+  //!
+  //! \brief  Read ahead the next local segment files in the folder of
+  //!         the assigned one, whose names follow the media template
+  //!
+  void PrefetchLocalSegments(const std::string& assignedSegment, int segNum);
+
   friend class RepresentationSelector;
 
  protected:
@@ -266,6 +286,8 @@ class OmafAdaptationSet {
   int mStartChunkId;                 //<! the available start chunk id in the real start segment
   ChunkInfoType mChunkInfoType;      //<! chunk info type
   int mSegNum;                       //<! the segment count
+  int mLocalPrefetchNum;             //<! the number of next local segment files to read ahead
+  int mPrefetchedSegNum;             //<! the last local segment number read ahead
   bool m_bMain;                      //<! whether this AdaptationSet is Main or not. each stream
                                      //<! has one main AdaptationSet
 
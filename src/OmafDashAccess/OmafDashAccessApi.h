@@ -87,6 +87,8 @@ typedef struct _omafDashParams {
   OmafPredictorParams predictor_params;
   long max_parallel_transfers;
   int segment_open_timeout_ms;
+  //for segment parsing
+  int max_parse_workers;
   //for stitch
   uint32_t max_decode_width;
   uint32_t max_decode_height;
@@ -95,6 +97,10 @@ typedef struct _omafDashParams {
   uint32_t max_response_times_in_seg;
   uint32_t max_catchup_width;
   uint32_t max_catchup_height;
+  //for packet output
+  bool enable_packet_release;  //!< DashPacket buf is released by its release callback, not free()
+  //for viewport tiles selection
+  float viewport_cache_resolution;  //!< degrees; head poses within it share one tiles selection, 0 disables the cache
 } OmafParams;
 
 /*
@@ -220,6 +226,18 @@ int OmafAccess_ChangeViewport(Handler hdl, HeadPose* pose);
  */
 int OmafAccess_Statistic(Handler hdl, DashStatisticInfo* info);
 
+/*
+ * description: API to dump the metrics of the process periodically into a file, the
+ * file is replaced atomically on every dump. The metrics are kept for all handles in
+ * the process, so one dump covers all of them.
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         path - [in] the dump file path, NULL to stop dumping
+ *         period_ms - [in] the dump period in millisecond, 0 to stop dumping
+ *         format - [in] JSON or Prometheus text format
+ * return: the error return from the API
+ */
+int OmafAccess_SetMetricsDump(Handler hdl, const char* path, uint32_t period_ms, MetricsFormat format);
+
 /*
  * description: API to Close the Handle and release relative resources after dealing with
  * the media
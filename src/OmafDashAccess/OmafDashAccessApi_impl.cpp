@@ -40,6 +40,7 @@
 #include "OmafMediaSource.h"
 #include "OmafTypes.h"
 #include "general.h"
+#include "OmafDashMetrics.h"
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
 #include "../trace/Bandwidth_tp.h"
@@ -118,6 +119,10 @@ Handler OmafAccess_Init(DashStreamingClient *pCtx) {
   if (omaf_params.segment_open_timeout_ms > 0) {
     omaf_dash_params.segment_open_timeout_ms_ = omaf_params.segment_open_timeout_ms;
   }
+
+  if (omaf_params.max_parse_workers > 0) {
+    omaf_dash_params.max_parse_workers_ = omaf_params.max_parse_workers;
+  }
   // for stitch
   if (omaf_params.max_decode_width > 0) {
     omaf_dash_params.max_decode_width_ = omaf_params.max_decode_width;
@@ -130,6 +135,12 @@ Handler OmafAccess_Init(DashStreamingClient *pCtx) {
   omaf_dash_params.max_response_times_in_seg = omaf_params.max_response_times_in_seg;
   omaf_dash_params.max_catchup_width = omaf_params.max_catchup_width;
   omaf_dash_params.max_catchup_height = omaf_params.max_catchup_height;
+  // for packet output
+  omaf_dash_params.enable_packet_release_ = omaf_params.enable_packet_release;
+  // for viewport tiles selection
+  if (omaf_params.viewport_cache_resolution > 0) {
+    omaf_dash_params.viewport_cache_resolution_ = omaf_params.viewport_cache_resolution;
+  }
 
   OMAF_LOG(LOG_INFO,"Dash parameter %s\n", omaf_dash_params.to_string().c_str());
   pSource->SetOmafDashParams(omaf_dash_params);
@@ -184,8 +195,30 @@ int OmafAccess_GetMediaInfo(Handler hdl, DashMediaInfo *info) {
   return ERROR_NONE;
 }
 
+//!
+//! \brief  hand the payload of the media packet to the dash packet, it is
+//!         shared with the release callback if enabled, or moved out to be
+//!         freed with free()
+//!
+static void outputPayload(MediaPacket *pPkt, DashPacket *packet, bool bufRelease) {
+  packet->release = nullptr;
+  packet->opaque = nullptr;
+  if (bufRelease) {
+    packet->buf = pPkt->SharePayload(&packet->opaque);
+    if (packet->buf) {
+      packet->release = MediaPacket::ReleasePayload;
+      return;
+    }
+  }
+  packet->buf = pPkt->MovePayload();
+}
+
 int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *size, uint64_t *pts, bool needParams,
                          bool clearBuf) {
+  static LatencyHistogram *packetOutLatency = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_PACKET_OUT_LATENCY);
+  static MetricsCounter *outputPackets = MetricsRegistry::GetInstance()->GetCounter(CLIENT_OUTPUT_PACKETS);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
   std::list<MediaPacket *> pkts;
   pSource->GetPacket(stream_id, &pkts, needParams, clearBuf);
@@ -195,6 +228,7 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
   }
 
   *size = pkts.size();
+  bool bufRelease = pSource->IsPacketReleaseEnabled();
 
   int i = 0;
   for (auto it = pkts.begin(); it != pkts.end(); it++) {
@@ -226,7 +260,7 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
             newPrft->mediaTime = pPrft->mediaTime;
           }
           packet[i].rwpk = newRwpk;
-          packet[i].buf = pPkt->MovePayload();
+          outputPayload(pPkt, &packet[i], bufRelease);
           packet[i].size = pPkt->Size();
           packet[i].segID = pPkt->GetSegID();
           packet[i].videoID = pPkt->GetVideoID();
@@ -256,7 +290,7 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
       }
       else if (pPkt->GetMediaType() == MediaType_Audio)
       {
-          packet[i].buf = pPkt->MovePayload();
+          outputPayload(pPkt, &packet[i], bufRelease);
           packet[i].size = pPkt->Size();
           packet[i].segID = pPkt->GetSegID();
           packet[i].pts = pPkt->GetPTS();
@@ -272,6 +306,9 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
     pPkt = NULL;
   }
 
+  outputPackets->Add(*size);
+  packetOutLatency->Record(MetricsElapsedUs(start));
+
   return ERROR_NONE;
 }
 
@@ -292,6 +329,18 @@ int OmafAccess_Statistic(Handler hdl, DashStatisticInfo *info) {
   return pSource->GetStatistic(info);
 }
 
+int OmafAccess_SetMetricsDump(Handler hdl, const char *path, uint32_t period_ms, MetricsFormat format) {
+  if (!hdl) return ERROR_NULL_PTR;
+
+  MetricsRegistry *registry = MetricsRegistry::GetInstance();
+  if (!path || !period_ms) {
+    registry->StopPeriodicDump();
+    return ERROR_NONE;
+  }
+
+  return registry->StartPeriodicDump(path, period_ms, format);
+}
+
 int OmafAccess_Close(Handler hdl) {
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
   delete pSource;
@@ -34,4 +34,4 @@
 #include "OmafDashAccessLog.h"
 
 
-LogFunction logCallBack = GlogFunction;
+LogFunction logCallBack = AsyncLogFunction;
@@ -162,6 +162,7 @@ class OmafDownloadTask : public VCD::NonCopyable {
       case State::READY:
         break;
       case State::RUNNING:
+        running_time_ = std::chrono::steady_clock::now();
         if (perf_counter_) perf_counter_->markStart();
         break;
       case State::STOPPED:
@@ -178,6 +179,10 @@ class OmafDownloadTask : public VCD::NonCopyable {
     state_ = s;
   };
   inline State state() noexcept { return state_; }
+  // microseconds elapsed since the transfer started running
+  inline uint64_t runningTimeUs() const noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - running_time_).count();
+  }
 
   inline void taskDoneCallback(State state) noexcept {
     if (perf_counter_) perf_counter_->markStop();
@@ -247,6 +252,7 @@ class OmafDownloadTask : public VCD::NonCopyable {
   OmafDashSegmentClient::OnChunkData cdcb_;
   OmafDashSegmentClient::OnState scb_;
   State state_ = State::CREATE;
+  std::chrono::steady_clock::time_point running_time_;
   OmafCurlEasyDownloader::Ptr easy_d_downloader_;
   OmafCurlEasyDownloader::Ptr easy_h_downloader_;
   int transfer_times_ = 0;
@@ -33,6 +33,7 @@
 #include "OmafDownloader.h"
 #include "OmafCurlMultiHandler.h"
 #include "performance.h"
+#include "../OmafDashMetrics.h"
 
 #include <chrono>
 #include <list>
@@ -102,6 +103,7 @@ class OmafDashSegmentHttpClientImpl : public OmafDashSegmentHttpClient {
   void threadRunner(void) noexcept;
   OmafDownloadTask::Ptr fetchReadyTask(void) noexcept;
   void processDoneTask(OmafDownloadTask::Ptr task) noexcept;
+  void recordTaskMetrics(OmafDownloadTask::Ptr task, OmafDownloadTask::State state) noexcept;
 
  private:
   const long max_parallel_transfers_;
@@ -449,6 +451,7 @@ void OmafDashSegmentHttpClientImpl::processDoneTask(OmafDownloadTask::Ptr task)
       return;
     }
     OmafDownloadTask::State state = task->state();
+    recordTaskMetrics(task, state);
     task->taskDoneCallback(state);
 
     // remove from downloading list
@@ -475,6 +478,28 @@ void OmafDashSegmentHttpClientImpl::processDoneTask(OmafDownloadTask::Ptr task)
   }
 }
 
+void OmafDashSegmentHttpClientImpl::recordTaskMetrics(OmafDownloadTask::Ptr task, OmafDownloadTask::State state) noexcept {
+  static LatencyHistogram *downloadLatency = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_DOWNLOAD_LATENCY);
+  static MetricsCounter *downloadedSegments = MetricsRegistry::GetInstance()->GetCounter(CLIENT_DOWNLOADED_SEGMENTS);
+  static MetricsCounter *downloadedBytes = MetricsRegistry::GetInstance()->GetCounter(CLIENT_DOWNLOADED_BYTES);
+  static MetricsCounter *downloadFailures = MetricsRegistry::GetInstance()->GetCounter(CLIENT_DOWNLOAD_FAILURES);
+
+  switch (state) {
+    case OmafDownloadTask::State::FINISH:
+      downloadLatency->Record(task->runningTimeUs());
+      downloadedSegments->Add(1);
+      downloadedBytes->Add(task->streamSize());
+      break;
+    case OmafDownloadTask::State::STOPPED:
+    case OmafDownloadTask::State::CONTINUE:
+      // stopped by the client or waiting for the next chunk
+      break;
+    default:
+      downloadFailures->Add(1);
+      break;
+  }
+}
+
 void OmafDashSegmentHttpClientPerf::addTime(OmafDownloadTask::State state,
                                             const std::chrono::milliseconds &duration) noexcept {
   switch (state) {
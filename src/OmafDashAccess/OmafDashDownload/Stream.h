@@ -33,7 +33,11 @@
 #ifndef STREAM_H
 #define STREAM_H
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <fstream>
+#include <memory>
 #include <mutex>  //std::mutex, std::unique_lock
 
 #include "../OmafDashParser/Common.h"
@@ -54,6 +58,14 @@ class StreamBlock {
   StreamBlock() = default;
 
   StreamBlock(char *data, int64_t size) : data_(data), size_(size), capacity_(size) {}
+
+  //!
+  //! \brief Constructor of the view of size bytes at offset in the holder
+  //!        block, the data is shared rather than copied and the holder is
+  //!        kept alive by the view
+  //!
+  StreamBlock(std::shared_ptr<StreamBlock> holder, int64_t offset, int64_t size)
+      : data_(holder->buf() + offset), size_(size), capacity_(size), bOwner_(false), holder_(std::move(holder)) {}
   //!
   //! \brief Destructor
   //!
@@ -101,8 +113,16 @@ private:
   int64_t size_ = 0;
   int64_t capacity_ = 0;
   const bool bOwner_ = true;
+  // the block owning the data of a view
+  std::shared_ptr<StreamBlock> holder_;
 };
 
+//!
+//! \class  StreamBlocks
+//! \brief  Stream made of downloaded blocks, blocks are located by the
+//!         start offset table with binary search, and the last hit block
+//!         is cached as cursor for the sequential reads.
+//!
 class StreamBlocks : public VCD::MP4::StreamIO {
  public:
   StreamBlocks() = default;
@@ -114,34 +134,7 @@ class StreamBlocks : public VCD::MP4::StreamIO {
   offset_t ReadStream(char *buffer, offset_t size) {
     std::lock_guard<std::mutex> lock(stream_mutex_);
 
-    offset_t offset = offset_;
-
-    std::list<std::unique_ptr<StreamBlock>>::const_iterator it = stream_blocks_.cbegin();
-    while (it != stream_blocks_.cend()) {
-      if (offset < (*it)->size()) {
-        break;
-      }
-      offset -= (*it)->size();
-      ++it;
-    }
-
-    offset_t readSize = 0;
-    while (it != stream_blocks_.cend()) {
-      if (readSize >= size) break;
-
-      offset_t copySize = 0;
-      offset_t dataSize = (*it)->size() - offset;
-      if ((size - readSize) >= dataSize) {
-        copySize = dataSize;
-      } else {
-        copySize = size - readSize;
-      }
-
-      memcpy_s(buffer + readSize, copySize, (*it)->cbuf() + offset, copySize);
-      readSize += copySize;
-      offset = 0;  // set offset to 0 for coming blocks
-      ++it;
-    }
+    offset_t readSize = readBlocks(buffer, offset_, size);
 
     offset_ += readSize;
 
@@ -151,41 +144,29 @@ class StreamBlocks : public VCD::MP4::StreamIO {
   offset_t ReadStreamFromOffset(char *buffer, offset_t input_offset, offset_t size) {
     std::lock_guard<std::mutex> lock(stream_mutex_);
 
-    offset_t offset = input_offset;
-
     if (stream_size_ < input_offset + size) {
       OMAF_LOG(LOG_WARNING, "dash stream has not enough data for offset %ld, size %ld\n", input_offset, size);
       return 0;
     }
 
-    std::list<std::unique_ptr<StreamBlock>>::const_iterator it = stream_blocks_.cbegin();
-    while (it != stream_blocks_.cend()) {
-      if (offset < (*it)->size()) {
-        break;
-      }
-      offset -= (*it)->size();
-      ++it;
-    }
-
-    offset_t readSize = 0;
-    while (it != stream_blocks_.cend()) {
-      if (readSize >= size) break;
+    return readBlocks(buffer, input_offset, size);
+  };
 
-      offset_t copySize = 0;
-      offset_t dataSize = (*it)->size() - offset;
-      if ((size - readSize) >= dataSize) {
-        copySize = dataSize;
-      } else {
-        copySize = size - readSize;
-      }
+  const char *GetDataView(offset_t offset, offset_t size) {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
 
-      memcpy_s(buffer + readSize, copySize, (*it)->cbuf() + offset, copySize);
-      readSize += copySize;
-      offset = 0;  // set offset to 0 for coming blocks
-      ++it;
+    size_t idx = locateBlock(offset);
+    if (idx >= stream_blocks_.size()) {
+      return nullptr;
     }
 
-    return readSize;
+    // only the data inside one block can be referenced in place
+    offset_t blockOffset = removed_size_ + offset - block_offsets_[idx];
+    if (blockOffset + size > stream_blocks_[idx]->size()) {
+      return nullptr;
+    }
+    cursor_ = idx;
+    return stream_blocks_[idx]->cbuf() + blockOffset;
   };
 
   bool SeekAbsoluteOffset(offset_t offset) {
@@ -204,6 +185,7 @@ class StreamBlocks : public VCD::MP4::StreamIO {
  public:
   void push_back(std::unique_ptr<StreamBlock> sb) noexcept {
     std::lock_guard<std::mutex> lock(stream_mutex_);
+    block_offsets_.push_back(removed_size_ + stream_size_);
     stream_size_ += sb->size();
     stream_blocks_.push_back(std::move(sb));
   }
@@ -212,30 +194,36 @@ class StreamBlocks : public VCD::MP4::StreamIO {
     std::lock_guard<std::mutex> lock(stream_mutex_);
     std::unique_ptr<StreamBlock> sb = std::move(stream_blocks_.front());
     stream_size_ -= sb->size();
+    removed_size_ += sb->size();
     stream_blocks_.pop_front();
+    block_offsets_.pop_front();
+    cursor_ = 0;
     return sb;
   }
 
   void clear() noexcept {
-    while (!stream_blocks_.empty()) {
-      stream_blocks_.pop_front();
-    }
     std::lock_guard<std::mutex> lock(stream_mutex_);
+    stream_blocks_.clear();
+    block_offsets_.clear();
     stream_size_ = 0;
+    removed_size_ = 0;
     offset_ = 0;
+    cursor_ = 0;
   }
 
   bool cacheToFile(std::string &filename) noexcept {
     std::ofstream of;  //<! file handle for writing
     try {
+      std::lock_guard<std::mutex> lock(stream_mutex_);
       of.open(filename, ios::out | ios::binary);
 
       for (auto &sb : stream_blocks_) {
         of.write(sb->cbuf(), sb->size());
       }
 
+      bool ret = of.good();
       of.close();
-      return true;
+      return ret;
     } catch (const std::exception &ex) {
       OMAF_LOG(LOG_ERROR, "Exception when cache the file: %s, ex: %s\n", filename.c_str(), ex.what());
       if (of.is_open()) {
@@ -247,12 +235,162 @@ class StreamBlocks : public VCD::MP4::StreamIO {
 
   uint32_t GetStreamBlockSize() { return stream_blocks_.size(); }
 
+ private:
+  //!
+  //! \brief  find the index of the block holding the stream offset,
+  //!         called with stream_mutex_ locked
+  //!
+  //! \return size_t
+  //!         block index, or blocks count if offset is out of the stream
+  //!
+  size_t locateBlock(offset_t offset) noexcept {
+    if (offset < 0 || offset >= stream_size_) {
+      return stream_blocks_.size();
+    }
+
+    const offset_t position = removed_size_ + offset;
+
+    // sequential reads mostly hit the cursor block or the next one
+    for (size_t idx = cursor_; idx < cursor_ + 2 && idx < stream_blocks_.size(); idx++) {
+      if (position >= block_offsets_[idx] && position < block_offsets_[idx] + stream_blocks_[idx]->size()) {
+        return idx;
+      }
+    }
+
+    // the last block whose start offset is not larger than the position
+    auto it = std::upper_bound(block_offsets_.cbegin(), block_offsets_.cend(), position);
+    return static_cast<size_t>(it - block_offsets_.cbegin()) - 1;
+  }
+
+  //!
+  //! \brief  copy stream data from offset to buffer, called with
+  //!         stream_mutex_ locked
+  //!
+  //! \return offset_t
+  //!         size of copied data
+  //!
+  offset_t readBlocks(char *buffer, offset_t offset, offset_t size) noexcept {
+    size_t idx = locateBlock(offset);
+    if (idx >= stream_blocks_.size()) {
+      return 0;
+    }
+
+    offset_t blockOffset = removed_size_ + offset - block_offsets_[idx];
+    offset_t readSize = 0;
+    while (idx < stream_blocks_.size() && readSize < size) {
+      cursor_ = idx;
+
+      offset_t copySize = 0;
+      offset_t dataSize = stream_blocks_[idx]->size() - blockOffset;
+      if ((size - readSize) >= dataSize) {
+        copySize = dataSize;
+      } else {
+        copySize = size - readSize;
+      }
+
+      memcpy_s(buffer + readSize, copySize, stream_blocks_[idx]->cbuf() + blockOffset, copySize);
+      readSize += copySize;
+      blockOffset = 0;  // set offset to 0 for coming blocks
+      ++idx;
+    }
+
+    return readSize;
+  }
+
  public:
-  std::list<std::unique_ptr<StreamBlock>> stream_blocks_;
+  std::deque<std::unique_ptr<StreamBlock>> stream_blocks_;
 
   std::mutex stream_mutex_;
   offset_t stream_size_ = 0;
   offset_t offset_ = 0;
+
+ private:
+  std::deque<offset_t> block_offsets_;  //<! start offset of each block, including the popped ones
+  offset_t removed_size_ = 0;           //<! total size of the popped blocks
+  size_t cursor_ = 0;                   //<! index of the block hit by the last read
+};
+
+//!
+//! \class  StreamChunkSlicer
+//! \brief  Slice the blocks received for a CMAF segment into chunks in
+//!         order. Each chunk is made of views into the blocks holding its
+//!         data, and a block is released once the views into it are gone.
+//!         It isn't thread safe, the caller serializes the access.
+//!
+class StreamChunkSlicer {
+ public:
+  //!
+  //! \brief append one received block, it is stamped with the receive time
+  //!
+  void push_back(std::unique_ptr<StreamBlock> sb) noexcept {
+    RecvBlock recv;
+    recv_size_ += sb->size();
+    recv.block = std::shared_ptr<StreamBlock>(std::move(sb));
+    recv.recv_time = std::chrono::steady_clock::now();
+    recv_blocks_.push_back(std::move(recv));
+  }
+
+  //!
+  //! \brief slice the next chunk of chunk_size bytes
+  //!
+  //! \param  [out] chunk
+  //!         the views into the blocks holding the chunk data
+  //! \param  [out] last_recv_time
+  //!         the time the last block of the chunk was received
+  //!
+  //! \return bool
+  //!         false if the chunk isn't received completely yet
+  //!
+  bool slice(int64_t chunk_size, std::vector<std::unique_ptr<StreamBlock>> &chunk,
+             std::chrono::steady_clock::time_point &last_recv_time) noexcept {
+    int64_t chunk_end = chunk_offset_ + chunk_size;
+    if (chunk_size <= 0 || recv_size_ < chunk_end) {
+      return false;
+    }
+
+    chunk.clear();
+    int64_t block_start = recv_offset_;
+    for (auto &recv : recv_blocks_) {
+      int64_t block_end = block_start + recv.block->size();
+      if (block_end > chunk_offset_) {
+        int64_t view_start = std::max(block_start, chunk_offset_);
+        int64_t view_end = std::min(block_end, chunk_end);
+        chunk.push_back(std::unique_ptr<StreamBlock>(
+            new StreamBlock(recv.block, view_start - block_start, view_end - view_start)));
+      }
+      if (block_end >= chunk_end) {
+        last_recv_time = recv.recv_time;
+        break;
+      }
+      block_start = block_end;
+    }
+    chunk_offset_ = chunk_end;
+
+    // the blocks sliced up are only kept alive by the chunk views
+    while (!recv_blocks_.empty() && recv_offset_ + recv_blocks_.front().block->size() <= chunk_offset_) {
+      recv_offset_ += recv_blocks_.front().block->size();
+      recv_blocks_.pop_front();
+    }
+    return true;
+  }
+
+  //!
+  //! \brief total size of the received data
+  //!
+  int64_t size() const noexcept { return recv_size_; }
+
+  void clear() noexcept { recv_blocks_.clear(); }
+
+ private:
+  struct RecvBlock {
+    std::shared_ptr<StreamBlock> block;                //<! the received block
+    std::chrono::steady_clock::time_point recv_time;   //<! the time the block was received
+  };
+
+  std::deque<RecvBlock> recv_blocks_;  //<! received blocks not sliced up completely
+  int64_t recv_offset_ = 0;            //<! stream offset of the first block in recv_blocks_
+  int64_t recv_size_ = 0;              //<! total size of received data
+  int64_t chunk_offset_ = 0;           //<! stream offset of the next chunk
 };
 }  // namespace OMAF
 }  // namespace VCD
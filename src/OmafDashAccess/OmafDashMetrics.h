@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   OmafDashMetrics.h
+//! \brief:  names of always-on metrics of OmafDashAccess
+//! \detail: latency histograms are in microsecond and kept in the
+//!          process wide MetricsRegistry, they are exposed through
+//!          OmafAccess_Statistic and the periodic metrics dump
+//!
+//! Created on April 19, 2021, 6:04 AM
+//!
+
+#ifndef OMAFDASHMETRICS_H
+#define OMAFDASHMETRICS_H
+
+#include "../utils/MetricsRegistry.h"
+
+// from transfer start to the end of one segment download
+#define CLIENT_DOWNLOAD_LATENCY    "omaf_client_download_latency_us"
+// time spent in parsing one downloaded segment
+#define CLIENT_PARSE_LATENCY       "omaf_client_parse_latency_us"
+// from stitching woken up by ready tile packets to merged packets output
+#define CLIENT_STITCH_LATENCY      "omaf_client_stitch_latency_us"
+// time spent in merging tiles of one frame
+#define CLIENT_MERGE_TIME          "omaf_client_merge_time_us"
+// time spent in OmafAccess_GetPacket which outputs packets
+#define CLIENT_PACKET_OUT_LATENCY  "omaf_client_packet_out_latency_us"
+// from the last byte of one CMAF chunk received to the chunk queued for parsing
+#define CLIENT_CHUNK_READY_LATENCY "omaf_client_chunk_ready_latency_us"
+
+#define CLIENT_DOWNLOADED_SEGMENTS "omaf_client_downloaded_segments_total"
+#define CLIENT_DOWNLOADED_BYTES    "omaf_client_downloaded_bytes_total"
+#define CLIENT_DOWNLOAD_FAILURES   "omaf_client_download_failures_total"
+#define CLIENT_PARSED_SEGMENTS     "omaf_client_parsed_segments_total"
+#define CLIENT_PARSE_FAILURES      "omaf_client_parse_failures_total"
+#define CLIENT_STITCHED_FRAMES     "omaf_client_stitched_frames_total"
+#define CLIENT_OUTPUT_PACKETS      "omaf_client_output_packets_total"
+
+#endif  // OMAFDASHMETRICS_H
@@ -53,7 +53,7 @@ void OmafElementBase::AddChildElement(OmafXMLElement* element)
     m_XMLElements.push_back(element);
 }
 
-void OmafElementBase::AddOriginalAttributes(map<string, string>& originalAttributes)
+void OmafElementBase::AddOriginalAttributes(const map<string, string>& originalAttributes)
 {
     m_originalAttributes.insert(originalAttributes.begin(), originalAttributes.end());
 }
@@ -73,7 +73,7 @@ public:
     //!
     //! \return   void
     //!
-    virtual void AddOriginalAttributes(map<string, string>& originalAttributes);
+    virtual void AddOriginalAttributes(const map<string, string>& originalAttributes);
 
     //!
     //! \brief    Get child elements
@@ -84,11 +84,10 @@ ODStatus OmafMPDReader::BuildMPD()
     m_mpd->SetPublishTime(m_rootXMLElement->GetAttributeVal(PUBLISHTIME));
     m_mpd->SetMediaPresentationDuration(m_rootXMLElement->GetAttributeVal(MEDIAPRESENTATIONDURATION));
 
-    map<string, string> attributes = m_rootXMLElement->GetAttributes();
-    m_mpd->AddOriginalAttributes(attributes);
+    m_mpd->AddOriginalAttributes(m_rootXMLElement->GetAttributes());
 
     CheckNullPtr_PrintLog_ReturnStatus(m_rootXMLElement, "Failed to create MPD node.\n", LOG_ERROR, OD_STATUS_OPERATION_FAILED);
-    vector<OmafXMLElement*> childElement = m_rootXMLElement->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = m_rootXMLElement->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -153,8 +152,7 @@ BaseUrlElement* OmafMPDReader::BuildBaseURL(OmafXMLElement* xmlBaseURL)
     auto path = xmlBaseURL->GetPath();
     baseURL->SetPath(path);
 
-    map<string, string> attributes = xmlBaseURL->GetAttributes();
-    baseURL->AddOriginalAttributes(attributes);
+    baseURL->AddOriginalAttributes(xmlBaseURL->GetAttributes());
 
     return baseURL;
 }
@@ -167,10 +165,9 @@ PeriodElement* OmafMPDReader::BuildPeriod(OmafXMLElement* xmlPeriod)
     period->SetStart(xmlPeriod->GetAttributeVal(START));
     period->SetId(xmlPeriod->GetAttributeVal(INDEX));
 
-    map<string, string> attributes = xmlPeriod->GetAttributes();
-    period->AddOriginalAttributes(attributes);
+    period->AddOriginalAttributes(xmlPeriod->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlPeriod->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlPeriod->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -205,10 +202,9 @@ ServiceDescriptionElement* OmafMPDReader::BuildServiceDescription(OmafXMLElement
     CheckNullPtr_PrintLog_ReturnNullPtr(serviceDescription, "Failed to create serviceDescription node.\n", LOG_ERROR);
     serviceDescription->SetId(xmlServiceDescription->GetAttributeVal(INDEX));
 
-    map<string, string> attributes = xmlServiceDescription->GetAttributes();
-    serviceDescription->AddOriginalAttributes(attributes);
+    serviceDescription->AddOriginalAttributes(xmlServiceDescription->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlServiceDescription->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlServiceDescription->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -245,10 +241,9 @@ LatencyElement* OmafMPDReader::BuildLatency(OmafXMLElement* xmlLatency)
 
     latency->SetTarget(xmlLatency->GetAttributeVal(TARGET));
 
-    map<string, string> attributes = xmlLatency->GetAttributes();
-    latency->AddOriginalAttributes(attributes);
+    latency->AddOriginalAttributes(xmlLatency->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlLatency->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlLatency->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -274,10 +269,9 @@ ResyncElement* OmafMPDReader::BuildResync(OmafXMLElement* xmlResync)
 
     resync->SetChunkDuration(xmlResync->GetAttributeVal(DT));
 
-    map<string, string> attributes = xmlResync->GetAttributes();
-    resync->AddOriginalAttributes(attributes);
+    resync->AddOriginalAttributes(xmlResync->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlResync->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlResync->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -305,10 +299,9 @@ ProducerReferenceTimeElement* OmafMPDReader::BuildProducerReferenceTime(OmafXMLE
     producerReferenceTime->SetWallclockTime(xmlProducerReferenceTime->GetAttributeVal(WALLCLOCKTIME));
     producerReferenceTime->SetPresentationTime(xmlProducerReferenceTime->GetAttributeVal(PRESENTATIONTIME));
 
-    map<string, string> attributes = xmlProducerReferenceTime->GetAttributes();
-    producerReferenceTime->AddOriginalAttributes(attributes);
+    producerReferenceTime->AddOriginalAttributes(xmlProducerReferenceTime->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlProducerReferenceTime->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlProducerReferenceTime->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -346,10 +339,9 @@ AdaptationSetElement* OmafMPDReader::BuildAdaptationSet(OmafXMLElement* xml)
     adaptionSet->SetGopSize(xml->GetAttributeVal(GOPSIZE));
     adaptionSet->SetMode(xml->GetAttributeVal(MODE));
 
-    map<string, string> attributes = xml->GetAttributes();
-    adaptionSet->AddOriginalAttributes(attributes);
+    adaptionSet->AddOriginalAttributes(xml->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xml->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xml->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -423,10 +415,9 @@ ViewportElement* OmafMPDReader::BuildViewport(OmafXMLElement* xmlViewport)
 
     viewport->ParseSchemeIdUriAndValue();
 
-    map<string, string> attributes = xmlViewport->GetAttributes();
-    viewport->AddOriginalAttributes(attributes);
+    viewport->AddOriginalAttributes(xmlViewport->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlViewport->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlViewport->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -456,10 +447,9 @@ EssentialPropertyElement* OmafMPDReader::BuildEssentialProperty(OmafXMLElement*
 
     essentialProperty->ParseSchemeIdUriAndValue();
 
-    map<string, string> attributes = xmlEssentialProperty->GetAttributes();
-    essentialProperty->AddOriginalAttributes(attributes);
+    essentialProperty->AddOriginalAttributes(xmlEssentialProperty->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlEssentialProperty->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlEssentialProperty->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -492,10 +482,9 @@ RepresentationElement* OmafMPDReader::BuildRepresentation(OmafXMLElement* xmlRep
     representation->SetBandwidth(StringToInt(xmlRepresentation->GetAttributeVal(BANDWIDTH)));
     representation->SetDependencyID(xmlRepresentation->GetAttributeVal(DEPENDENCYID));
 
-    map<string, string> attributes = xmlRepresentation->GetAttributes();
-    representation->AddOriginalAttributes(attributes);
+    representation->AddOriginalAttributes(xmlRepresentation->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlRepresentation->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlRepresentation->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -551,10 +540,9 @@ AudioChannelConfigurationElement* OmafMPDReader::BuildAudioChannelConfiguration(
 
     audioCfg->ParseSchemeIdUriAndValue();
 
-    map<string, string> attributes = xmlAudioChlCfg->GetAttributes();
-    audioCfg->AddOriginalAttributes(attributes);
+    audioCfg->AddOriginalAttributes(xmlAudioChlCfg->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlAudioChlCfg->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlAudioChlCfg->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -591,10 +579,9 @@ SegmentElement* OmafMPDReader::BuildSegment(OmafXMLElement* xmlSegment)
     else
         segment->SetAvailabilityTimeComplete(false);
 
-    map<string, string> attributes = xmlSegment->GetAttributes();
-    segment->AddOriginalAttributes(attributes);
+    segment->AddOriginalAttributes(xmlSegment->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlSegment->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlSegment->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -621,10 +608,9 @@ SupplementalPropertyElement* OmafMPDReader::BuildSupplementalProperty(OmafXMLEle
 
     supplementalProperty->ParseSchemeIdUriAndValue();
 
-    map<string, string> attributes = xmlSupplementalProperty->GetAttributes();
-    supplementalProperty->AddOriginalAttributes(attributes);
+    supplementalProperty->AddOriginalAttributes(xmlSupplementalProperty->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlSupplementalProperty->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlSupplementalProperty->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -661,10 +647,9 @@ SphRegionQualityElement* OmafMPDReader::BuildSphRegionQuality(OmafXMLElement* xm
     sphRegionQuality->SetQualityRankingLocalFlag((xmlSphRegionQuality->GetAttributeVal(QUALITY_RANKING_LOCAL_FLAG) == "true"));
     sphRegionQuality->SetQualityType(StringToInt(xmlSphRegionQuality->GetAttributeVal(QUALITY_TYPE)));
 
-    map<string, string> attributes = xmlSphRegionQuality->GetAttributes();
-    sphRegionQuality->AddOriginalAttributes(attributes);
+    sphRegionQuality->AddOriginalAttributes(xmlSphRegionQuality->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlSphRegionQuality->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlSphRegionQuality->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -690,7 +675,7 @@ TwoDRegionQualityElement* OmafMPDReader::BuildTwoDRegionQuality(OmafXMLElement*
     TwoDRegionQualityElement* twoDRegionQuality = new TwoDRegionQualityElement();
     CheckNullPtr_PrintLog_ReturnNullPtr(twoDRegionQuality, "Failed to create sphere Region Quality node.\n", LOG_ERROR);
 
-    vector<OmafXMLElement*> childElement = xmlTwoDRegionQuality->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlTwoDRegionQuality->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
@@ -727,10 +712,9 @@ QualityInfoElement* OmafMPDReader::BuildQualityInfo(OmafXMLElement* xmlQualityIn
     qualityInfo->SetRegionWidth(StringToInt(xmlQualityInfo->GetAttributeVal(REGION_WIDTH)));
     qualityInfo->SetRegionHeight(StringToInt(xmlQualityInfo->GetAttributeVal(REGION_HEIGHT)));
 
-    map<string, string> attributes = xmlQualityInfo->GetAttributes();
-    qualityInfo->AddOriginalAttributes(attributes);
+    qualityInfo->AddOriginalAttributes(xmlQualityInfo->GetAttributes());
 
-    vector<OmafXMLElement*> childElement = xmlQualityInfo->GetChildElements();
+    const vector<OmafXMLElement*>& childElement = xmlQualityInfo->GetChildElements();
     for(auto child : childElement)
     {
         if(!child)
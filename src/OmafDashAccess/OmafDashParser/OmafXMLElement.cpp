@@ -54,50 +54,52 @@ OmafXMLElement::~OmafXMLElement()
     }
 }
 
-string OmafXMLElement::GetName()
+const string& OmafXMLElement::GetName()
 {
     return m_name;
 }
 
-string OmafXMLElement::GetText()
+const string& OmafXMLElement::GetText()
 {
     return m_text;
 }
 
-string OmafXMLElement::GetPath()
+const string& OmafXMLElement::GetPath()
 {
     return m_path;
 }
 
-vector<OmafXMLElement*> OmafXMLElement::GetChildElements()
+const vector<OmafXMLElement*>& OmafXMLElement::GetChildElements()
 {
     return m_childElements;
 }
 
-map<string, string> OmafXMLElement::GetAttributes()
+const map<string, string>& OmafXMLElement::GetAttributes()
 {
     return m_attributes;
 }
 
-string OmafXMLElement::GetAttributeVal(string attrKey)
+const string& OmafXMLElement::GetAttributeVal(const string& attrKey)
 {
-    if(m_attributes.find(attrKey) != m_attributes.end())
-        return m_attributes[attrKey];
+    static const string empty;
+    auto it = m_attributes.find(attrKey);
+    if(it != m_attributes.end())
+        return it->second;
 
-    return "";
+    return empty;
 }
 
-void OmafXMLElement::SetName(string name)
+void OmafXMLElement::SetName(const string& name)
 {
     m_name = name;
 }
 
-void OmafXMLElement::SetText(string text)
+void OmafXMLElement::SetText(const string& text)
 {
     m_text = text;
 }
 
-void OmafXMLElement::SetPath(string path)
+void OmafXMLElement::SetPath(const string& path)
 {
     m_path = path;
 }
@@ -107,7 +109,7 @@ void OmafXMLElement::AddChildElement(OmafXMLElement* element)
     m_childElements.push_back(element);
 }
 
-void OmafXMLElement::AddAttribute(string attrKey, string attrVal)
+void OmafXMLElement::AddAttribute(const string& attrKey, const string& attrVal)
 {
     m_attributes.insert(pair<string, string>(attrKey, attrVal));
 }
@@ -61,7 +61,7 @@ public:
     //! \return   string
     //!           name in string
     //!
-    string GetName();
+    const string& GetName();
 
     //!
     //! \brief    Get text of this element
@@ -69,7 +69,7 @@ public:
     //! \return   string
     //!           text in string
     //!
-    string GetText();
+    const string& GetText();
 
     //!
     //! \brief    Get path of this element
@@ -77,23 +77,23 @@ public:
     //! \return   string
     //!           path in string
     //!
-    string GetPath();
+    const string& GetPath();
 
     //!
     //! \brief    Get child elements of this element
     //!
-    //! \return   vector<OmafXMLElement*>
+    //! \return   const vector<OmafXMLElement*>&
     //!           vector of XML elements
     //!
-    vector<OmafXMLElement*>      GetChildElements();
+    const vector<OmafXMLElement*>& GetChildElements();
 
     //!
     //! \brief    Get attributes of this element
     //!
-    //! \return   map<string, string>
+    //! \return   const map<string, string>&
     //!           map of attributes
     //!
-    map<string, string>          GetAttributes();
+    const map<string, string>&  GetAttributes();
 
     //!
     //! \brief    Get attributes of this element with key
@@ -101,10 +101,10 @@ public:
     //! \param    [in] attrKey
     //!           attribute key
     //!
-    //! \return   string
-    //!           attribute value
+    //! \return   const string&
+    //!           attribute value, empty if not found
     //!
-    string                       GetAttributeVal(string attrKey);
+    const string&                GetAttributeVal(const string& attrKey);
 
     //!
     //! \brief    Set name for this element
@@ -114,7 +114,7 @@ public:
     //!
     //! \return   void
     //!
-    void SetName(string name);
+    void SetName(const string& name);
 
     //!
     //! \brief    Set text for this element
@@ -124,7 +124,7 @@ public:
     //!
     //! \return   void
     //!
-    void SetText(string text);
+    void SetText(const string& text);
 
     //!
     //! \brief    Set path for this element
@@ -134,7 +134,7 @@ public:
     //!
     //! \return   void
     //!
-    void SetPath(string path);
+    void SetPath(const string& path);
 
     //!
     //! \brief    Add child element
@@ -156,7 +156,7 @@ public:
     //!
     //! \return   void
     //!
-    void AddAttribute(string attrKey, string attrVal);
+    void AddAttribute(const string& attrKey, const string& attrVal);
 
 private:
 
@@ -33,20 +33,17 @@
 #include "OmafXMLParser.h"
 
 #include <fstream>
+#include <iterator>
 
 VCD_OMAF_BEGIN
 
-using namespace tinyxml2;
-
 OmafXMLParser::OmafXMLParser() {
   m_mpdReader = nullptr;
-  m_xmlDoc = nullptr;
 }
 
 OmafXMLParser::~OmafXMLParser() {
   if (m_mpdReader) m_mpdReader->Close();
   SAFE_DELETE(m_mpdReader);
-  SAFE_DELETE(m_xmlDoc);
 }
 
 size_t OmafXMLParser::WriteData(void* ptr, size_t size, size_t nmemb, FILE* fp) { return fwrite(ptr, size, nmemb, fp); }
@@ -98,29 +95,81 @@ std::string OmafXMLParser::DownloadXMLFile(string url, string cache_dir) {
   return std::string();
 }
 
-ODStatus OmafXMLParser::Generate(string url, string cacheDir) {
-  ODStatus ret = OD_STATUS_SUCCESS;
-
-  m_path = url.substr(0, url.find_last_of('/'));
+std::string OmafXMLParser::DownloadXMLBuffer(string url) {
+  std::string content;
+  OmafCurlEasyDownloader downloader(OmafCurlEasyDownloader::CurlWorkMode::EASY_MODE);
+  int ret = downloader.init(m_curl_params);
+  if (ret == ERROR_NONE) {
+    ret = downloader.open(url);
+  }
+  if (ret == ERROR_NONE) {
+    ret = downloader.start(
+        0, 0, [&content](std::unique_ptr<StreamBlock> sb) { content.append(sb->cbuf(), sb->size()); }, nullptr,
+        [url](OmafCurlEasyDownloader::State s) {
+          OMAF_LOG(LOG_INFO, "Download state: %d for url: %s\n", static_cast<int>(s), url.c_str());
+        });
+  }
+  if (ret != ERROR_NONE) {
+    OMAF_LOG(LOG_ERROR, "Failed to download the mpd with url: %s\n", url.c_str());
+    content.clear();
+  }
+  return content;
+}
 
+bool OmafXMLParser::IsNetworkPath(const string& path) {
   // define the url is local or through network with prefix
   string url_prefix = "http";
-  bool local = m_path.length() < url_prefix.length() || m_path.substr(0, 4) != url_prefix;
+  return !(path.length() < url_prefix.length() || path.substr(0, 4) != url_prefix);
+}
+
+ODStatus OmafXMLParser::ReadXMLContent(string url, string& content) {
+  string path = url.substr(0, url.find_last_of('/'));
+  if (IsNetworkPath(path)) {
+    content = DownloadXMLBuffer(url);
+  } else {
+    std::ifstream mpd_file(url, ios::in | ios::binary);
+    if (!mpd_file.is_open()) {
+      OMAF_LOG(LOG_ERROR, "Failed to open the mpd file: %s\n", url.c_str());
+      return OD_STATUS_OPERATION_FAILED;
+    }
+    content.assign((std::istreambuf_iterator<char>(mpd_file)), std::istreambuf_iterator<char>());
+  }
+  return content.empty() ? OD_STATUS_OPERATION_FAILED : OD_STATUS_SUCCESS;
+}
+
+ODStatus OmafXMLParser::GenerateFromBuffer(string url, const string& content) {
+  m_path = url.substr(0, url.find_last_of('/'));
+
+  ODStatus ret = BuildMPDFromContent(content);
+  if (ret != OD_STATUS_SUCCESS) {
+    OMAF_LOG(LOG_ERROR, "Failed to parse the mpd content from: %s\n", url.c_str());
+  }
+  return ret;
+}
+
+ODStatus OmafXMLParser::Generate(string url, string cacheDir) {
+  m_path = url.substr(0, url.find_last_of('/'));
+
+  bool local = !IsNetworkPath(m_path);
 
   string fileName = local ? url : DownloadXMLFile(url, cacheDir);
   if (!fileName.length()) return OD_STATUS_INVALID;
 
-  m_xmlDoc = new XMLDocument();
-  CheckNullPtr_PrintLog_ReturnStatus(m_xmlDoc, "Failed to create XMLDocument with tinyXML.\n", LOG_ERROR,
-                                     OD_STATUS_OPERATION_FAILED);
   OMAF_LOG(LOG_INFO, "To parse the mpd file: %s\n", fileName.c_str());
-  XMLError result = m_xmlDoc->LoadFile(fileName.c_str());
-  if (result != XML_SUCCESS) return OD_STATUS_OPERATION_FAILED;
+  std::ifstream mpd_file(fileName, ios::in | ios::binary);
+  if (!mpd_file.is_open()) {
+    OMAF_LOG(LOG_ERROR, "Failed to open the mpd file: %s\n", fileName.c_str());
+    return OD_STATUS_OPERATION_FAILED;
+  }
+  string content((std::istreambuf_iterator<char>(mpd_file)), std::istreambuf_iterator<char>());
 
-  XMLElement* elmt = m_xmlDoc->FirstChildElement();
-  CheckNullPtr_PrintLog_ReturnStatus(elmt, "Failed to get element from XML Doc.\n", LOG_ERROR, OD_STATUS_OPERATION_FAILED);
+  return BuildMPDFromContent(content);
+}
 
-  OmafXMLElement* root = BuildXMLElementTree(elmt);
+ODStatus OmafXMLParser::BuildMPDFromContent(const string& content) {
+  ODStatus ret = OD_STATUS_SUCCESS;
+
+  OmafXMLElement* root = BuildXMLElementTree(content);
   if (!root) {
     OMAF_LOG(LOG_ERROR, "Build XML elements tree failed!\n");
     return OD_STATUS_OPERATION_FAILED;
@@ -132,44 +181,12 @@ ODStatus OmafXMLParser::Generate(string url, string cacheDir) {
     return OD_STATUS_OPERATION_FAILED;
   }
 
-  // delete the downloaded mpd file after it's parsed.
-  // if (!local && 0 != remove(fileName.c_str())) {
-  //  LOG(WARNING) << "Failed to delete the downloaded MPD file: " << fileName);
-  //}
-
   return ret;
 }
 
-OmafXMLElement* OmafXMLParser::BuildXMLElementTree(XMLElement* elmt) {
-  CheckNullPtr_PrintLog_ReturnNullPtr(elmt, "Failed to get element from XML Doc.\n", LOG_WARNING);
-
-  const char* name = elmt->Value();
-  if (!name) return nullptr;
-
-  OmafXMLElement* element = new OmafXMLElement();
-  CheckNullPtr_PrintLog_ReturnNullPtr(element, "Failed to create element.\n", LOG_WARNING);
-
-  element->SetName(name);
-  element->SetPath(m_path);
-
-  const char* text = elmt->GetText();
-  if (text) element->SetText(text);
-
-  this->ReadAttributes(element, elmt);
-
-  if (elmt->NoChildren()) return element;
-
-  // read all child element
-  XMLElement* child = elmt->FirstChildElement();
-  while (child) {
-    OmafXMLElement* childElement = this->BuildXMLElementTree(child);
-    // only add valid child element
-    if (childElement) element->AddChildElement(childElement);
-
-    child = child->NextSiblingElement();
-  }
-
-  return element;
+OmafXMLElement* OmafXMLParser::BuildXMLElementTree(const string& content) {
+  OmafXMLStreamParser parser;
+  return parser.Parse(content.c_str(), content.size(), m_path);
 }
 
 ODStatus OmafXMLParser::BuildMPDwithXMLElements(OmafXMLElement* root) {
@@ -183,20 +200,6 @@ ODStatus OmafXMLParser::BuildMPDwithXMLElements(OmafXMLElement* root) {
   return ret;
 }
 
-void OmafXMLParser::ReadAttributes(OmafXMLElement* element, XMLElement* orgElement) {
-  const XMLAttribute* attribute = orgElement->FirstAttribute();
-  if (!attribute) return;
-
-  // read all attributes
-  while (attribute) {
-    const char* attrKey = attribute->Name();
-    const char* attrValue = attribute->Value();
-    element->AddAttribute(attrKey, attrValue);
-
-    attribute = attribute->Next();
-  }
-}
-
 MPDElement* OmafXMLParser::GetGeneratedMPD() {
   if (!m_mpdReader) {
     OMAF_LOG(LOG_ERROR, "please generate MPD tree firstly.\n");
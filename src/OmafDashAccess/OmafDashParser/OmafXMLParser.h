@@ -32,12 +32,12 @@
 #ifndef OMAFXMLPARSER_H
 #define OMAFXMLPARSER_H
 
-#include "../../utils/tinyxml2.h"
 #include "../OmafDashDownload/OmafCurlEasyHandler.h"
 #include "Common.h"
 
 #include "OmafMPDReader.h"
 #include "OmafXMLElement.h"
+#include "OmafXMLStreamParser.h"
 
 VCD_OMAF_BEGIN
 
@@ -84,15 +84,53 @@ class OmafXMLParser {
   std::string DownloadXMLFile(string url, string cacheDir);
 
   //!
-  //! \brief    Generate XML tree
+  //! \brief    Download MPD file into memory
   //!
-  //! \param    [in] elmt
-  //!           root tinyxml element
+  //! \param    [in] url
+  //!           MPD file url
+  //!
+  //! \return   string
+  //!           the content of downloaded file, empty if failed
+  //!
+  std::string DownloadXMLBuffer(string url);
+
+  //!
+  //! \brief    Generate XML tree and MPD tree from MPD content in memory
+  //!
+  //! \param    [in] url
+  //!           MPD file url, used as the base url of MPD tree
+  //!           [in] content
+  //!           MPD file content
+  //!
+  //! \return   ODStatus
+  //!           OD_STATUS_SUCCESS if success, else fail reason
+  //!
+  ODStatus GenerateFromBuffer(string url, const string& content);
+
+  //!
+  //! \brief    Read MPD content into memory, downloaded from
+  //!           network or read from local file
+  //!
+  //! \param    [in] url
+  //!           MPD file url
+  //!           [out] content
+  //!           MPD file content
+  //!
+  //! \return   ODStatus
+  //!           OD_STATUS_SUCCESS if success, else fail reason
+  //!
+  ODStatus ReadXMLContent(string url, string& content);
+
+  //!
+  //! \brief    Generate XML tree in one pass over MPD content
+  //!
+  //! \param    [in] content
+  //!           MPD file content
   //!
   //! \return   OmafXMLElement
-  //!           root OMAF XML element
+  //!           root OMAF XML element, nullptr if the content is malformed
   //!
-  OmafXMLElement* BuildXMLElementTree(tinyxml2::XMLElement* elmt);
+  OmafXMLElement* BuildXMLElementTree(const string& content);
 
   //!
   //! \brief    Generate MPD tree with XML elements
@@ -124,16 +162,26 @@ private:
 
  private:
   //!
-  //! \brief    Read attributes from tinyxml element
+  //! \brief    Generate XML tree and MPD tree from MPD content
+  //!
+  //! \param    [in] content
+  //!           MPD file content
+  //!
+  //! \return   ODStatus
+  //!           OD_STATUS_SUCCESS if success, else fail reason
+  //!
+  ODStatus BuildMPDFromContent(const string& content);
+
+  //!
+  //! \brief    Whether the url is a network one
   //!
-  //! \param    [in] element
-  //!           OMAF XML element
-  //! \param    [in] orgElement
-  //!           tinyxml element
+  //! \param    [in] path
+  //!           url path without file name
   //!
-  //! \return   void
+  //! \return   bool
+  //!           true if MPD is downloaded through network
   //!
-  void ReadAttributes(OmafXMLElement* element, tinyxml2::XMLElement* orgElement);
+  static bool IsNetworkPath(const string& path);
 
   //!
   //! \brief    Write data to file
@@ -152,7 +200,6 @@ private:
   //!
   static size_t WriteData(void* ptr, size_t size, size_t nmemb, FILE* fp);
 
-  tinyxml2::XMLDocument* m_xmlDoc = nullptr;  //!< tinyxml document
   string m_path;                              //!< url path
   OmafReaderBase* m_mpdReader;                //!< MPD reader
   CurlParams m_curl_params;
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafXMLStreamParser.cpp
+//! \brief:  single pass XML parser building OMAF XML elements from buffer
+//!
+
+#include "OmafXMLStreamParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+VCD_OMAF_BEGIN
+
+static inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+static inline bool IsNameEnd(char c) { return IsSpace(c) || c == '/' || c == '>' || c == '='; }
+
+static inline const char* SkipSpace(const char* p, const char* end) {
+  while (p < end && IsSpace(*p)) p++;
+  return p;
+}
+
+static inline bool StartsWith(const char* p, const char* end, const char* str, size_t len) {
+  return (size_t)(end - p) >= len && !memcmp(p, str, len);
+}
+
+// search the terminator of markup, return nullptr if not found
+static const char* FindStr(const char* p, const char* end, const char* str, size_t len) {
+  while (p < end) {
+    const char* q = static_cast<const char*>(memchr(p, str[0], end - p));
+    if (!q || (size_t)(end - q) < len) return nullptr;
+    if (!memcmp(q, str, len)) return q;
+    p = q + 1;
+  }
+  return nullptr;
+}
+
+static void AppendUTF8(uint32_t code, string& out) {
+  if (code < 0x80) {
+    out += static_cast<char>(code);
+  } else if (code < 0x800) {
+    out += static_cast<char>(0xC0 | (code >> 6));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else if (code < 0x10000) {
+    out += static_cast<char>(0xE0 | (code >> 12));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code >> 18));
+    out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  }
+}
+
+OmafXMLStreamParser::OmafXMLStreamParser() {}
+
+OmafXMLStreamParser::~OmafXMLStreamParser() { m_names.clear(); }
+
+const string& OmafXMLStreamParser::InternName(const char* name, size_t len) {
+  m_nameKey.assign(name, len);
+  return *(m_names.insert(m_nameKey).first);
+}
+
+void OmafXMLStreamParser::DecodeText(const char* begin, const char* end, string& out) {
+  out.clear();
+  out.reserve(end - begin);
+  const char* p = begin;
+  while (p < end) {
+    const char* q = p;
+    while (q < end && *q != '&' && *q != '\r') q++;
+    out.append(p, q - p);
+    if (q == end) break;
+
+    if (*q == '\r') {
+      // line ends are normalized to '\n'
+      out += '\n';
+      p = (q + 1 < end && q[1] == '\n') ? q + 2 : q + 1;
+      continue;
+    }
+
+    const char* semi = static_cast<const char*>(memchr(q, ';', end - q));
+    size_t len = semi ? semi - q + 1 : 0;
+    if (len == 5 && !memcmp(q, "&amp;", 5)) {
+      out += '&';
+    } else if (len == 4 && !memcmp(q, "&lt;", 4)) {
+      out += '<';
+    } else if (len == 4 && !memcmp(q, "&gt;", 4)) {
+      out += '>';
+    } else if (len == 6 && !memcmp(q, "&quot;", 6)) {
+      out += '"';
+    } else if (len == 6 && !memcmp(q, "&apos;", 6)) {
+      out += '\'';
+    } else if (len > 3 && len < 12 && q[1] == '#') {
+      bool hex = (q[2] == 'x' || q[2] == 'X');
+      char* numEnd = nullptr;
+      string num(q + (hex ? 3 : 2), semi);
+      uint32_t code = static_cast<uint32_t>(strtoul(num.c_str(), &numEnd, hex ? 16 : 10));
+      if (!num.empty() && numEnd && *numEnd == '\0' && code && code <= 0x10FFFF) {
+        AppendUTF8(code, out);
+      } else {
+        len = 0;
+      }
+    } else {
+      len = 0;
+    }
+
+    if (len) {
+      p = q + len;
+    } else {
+      // unknown entity is kept as it is
+      out += '&';
+      p = q + 1;
+    }
+  }
+}
+
+bool OmafXMLStreamParser::ParseStartTag(const char*& p, const char* end, OmafXMLElement*& element, bool& closed) {
+  const char* name = p;
+  while (p < end && !IsNameEnd(*p)) p++;
+  if (p == name || p == end) return false;
+
+  element = new OmafXMLElement();
+  element->SetName(InternName(name, p - name));
+  element->SetPath(m_path);
+  closed = false;
+
+  string value;
+  while (true) {
+    p = SkipSpace(p, end);
+    if (p == end) return false;
+    if (*p == '>') {
+      p++;
+      return true;
+    }
+    if (*p == '/') {
+      if (p + 1 == end || p[1] != '>') return false;
+      closed = true;
+      p += 2;
+      return true;
+    }
+
+    // attribute name="value"
+    const char* attrName = p;
+    while (p < end && !IsNameEnd(*p)) p++;
+    if (p == attrName) return false;
+    const string& key = InternName(attrName, p - attrName);
+    p = SkipSpace(p, end);
+    if (p == end || *p != '=') return false;
+    p = SkipSpace(p + 1, end);
+    if (p == end || (*p != '"' && *p != '\'')) return false;
+    const char* valueEnd = static_cast<const char*>(memchr(p + 1, *p, end - p - 1));
+    if (!valueEnd) return false;
+    DecodeText(p + 1, valueEnd, value);
+    element->AddAttribute(key, value);
+    p = valueEnd + 1;
+  }
+}
+
+OmafXMLElement* OmafXMLStreamParser::Parse(const char* content, size_t size, const string& path) {
+  CheckNullPtr_PrintLog_ReturnNullPtr(content, "Empty XML content.\n", LOG_ERROR);
+
+  m_path = path;
+  const char* p = content;
+  const char* end = content + size;
+  // skip the UTF-8 BOM
+  if (StartsWith(p, end, "\xEF\xBB\xBF", 3)) p += 3;
+
+  OmafXMLElement* root = nullptr;
+  vector<OmafXMLElement*> openElements;  // elements waiting for end tags
+  vector<bool> hasChildNode;             // whether the open element has got any child node
+  string text;
+  bool ok = true;
+
+  while (ok && p < end) {
+    if (*p != '<') {
+      // text node, the leading white spaces are skipped as tinyxml2 does
+      const char* q = static_cast<const char*>(memchr(p, '<', end - p));
+      if (!q) q = end;
+      p = SkipSpace(p, q);
+      if (p < q && !openElements.empty()) {
+        if (!hasChildNode.back()) {
+          DecodeText(p, q, text);
+          openElements.back()->SetText(text);
+        }
+        hasChildNode.back() = true;
+      }
+      p = q;
+      continue;
+    }
+
+    if (StartsWith(p, end, "<?", 2)) {
+      const char* q = FindStr(p + 2, end, "?>", 2);
+      ok = (q != nullptr);
+      p = ok ? q + 2 : end;
+    } else if (StartsWith(p, end, "<!--", 4)) {
+      const char* q = FindStr(p + 4, end, "-->", 3);
+      ok = (q != nullptr);
+      p = ok ? q + 3 : end;
+      if (ok && !openElements.empty()) hasChildNode.back() = true;
+    } else if (StartsWith(p, end, "<![CDATA[", 9)) {
+      const char* q = FindStr(p + 9, end, "]]>", 3);
+      ok = (q != nullptr && !openElements.empty());
+      if (ok) {
+        if (!hasChildNode.back()) openElements.back()->SetText(string(p + 9, q));
+        hasChildNode.back() = true;
+      }
+      p = ok ? q + 3 : end;
+    } else if (StartsWith(p, end, "<!", 2)) {
+      // DOCTYPE, skip the internal subset in brackets
+      int depth = 0;
+      for (p += 2; p < end; p++) {
+        if (*p == '[') depth++;
+        else if (*p == ']') depth--;
+        else if (*p == '>' && depth <= 0) break;
+      }
+      ok = (p < end);
+      p++;
+    } else if (StartsWith(p, end, "</", 2)) {
+      const char* name = p + 2;
+      const char* q = name;
+      while (q < end && !IsNameEnd(*q)) q++;
+      q = SkipSpace(q, end);
+      ok = (q < end && *q == '>' && !openElements.empty());
+      if (ok) {
+        const string& openName = openElements.back()->GetName();
+        size_t len = 0;
+        while (name + len < end && !IsNameEnd(name[len])) len++;
+        ok = (openName.size() == len && !memcmp(openName.c_str(), name, len));
+      }
+      if (ok) {
+        openElements.pop_back();
+        hasChildNode.pop_back();
+      }
+      p = q + 1;
+    } else {
+      OmafXMLElement* element = nullptr;
+      bool closed = false;
+      p++;
+      ok = ParseStartTag(p, end, element, closed);
+      if (ok) {
+        if (openElements.empty()) {
+          // only one root element is allowed
+          ok = (root == nullptr);
+          if (ok) root = element;
+        } else {
+          openElements.back()->AddChildElement(element);
+          hasChildNode.back() = true;
+        }
+      }
+      if (!ok) {
+        SAFE_DELETE(element);
+      } else if (!closed) {
+        openElements.push_back(element);
+        hasChildNode.push_back(false);
+      }
+    }
+  }
+
+  if (!ok || !root || !openElements.empty()) {
+    OMAF_LOG(LOG_ERROR, "Malformed XML content at offset %ld!\n", (long)(p - content));
+    SAFE_DELETE(root);
+    return nullptr;
+  }
+
+  return root;
+}
+
+VCD_OMAF_END
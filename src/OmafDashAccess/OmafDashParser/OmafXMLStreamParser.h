@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafXMLStreamParser.h
+//! \brief:  single pass XML parser building OMAF XML elements from buffer
+//!
+
+#ifndef OMAFXMLSTREAMPARSER_H
+#define OMAFXMLSTREAMPARSER_H
+
+#include "Common.h"
+#include "OmafXMLElement.h"
+
+#include <unordered_set>
+
+VCD_OMAF_BEGIN
+
+//!
+//! \class:  OmafXMLStreamParser
+//! \brief:  streaming XML parser, elements are built in document order while
+//!          the buffer is scanned once, and the names of elements and
+//!          attributes are interned. The elements copy the interned names,
+//!          so the repeated names share one buffer only with the copy on
+//!          write strings of _GLIBCXX_USE_CXX11_ABI=0 which the library is
+//!          built with. Under the C++11 ABI every element owns its copy and
+//!          the interning saves no memory.
+//!
+class OmafXMLStreamParser {
+ public:
+  //!
+  //! \brief Constructor
+  //!
+  OmafXMLStreamParser();
+
+  //!
+  //! \brief Destructor
+  //!
+  virtual ~OmafXMLStreamParser();
+
+  //!
+  //! \brief    Parse XML content into OMAF XML element tree
+  //!
+  //! \param    [in] content
+  //!           XML content
+  //! \param    [in] size
+  //!           size of XML content
+  //! \param    [in] path
+  //!           path set to every element
+  //!
+  //! \return   OmafXMLElement*
+  //!           root element owned by the caller, nullptr if the content
+  //!           is malformed
+  //!
+  OmafXMLElement* Parse(const char* content, size_t size, const string& path);
+
+ private:
+  OmafXMLStreamParser& operator=(const OmafXMLStreamParser& other) { return *this; };
+  OmafXMLStreamParser(const OmafXMLStreamParser& other) { /* do not create copies */ };
+
+ private:
+  //!
+  //! \brief    Get the interned copy of a name
+  //!
+  //! \param    [in] name
+  //!           name start
+  //! \param    [in] len
+  //!           name length
+  //!
+  //! \return   const string&
+  //!           the interned name
+  //!
+  const string& InternName(const char* name, size_t len);
+
+  //!
+  //! \brief    Parse a start tag with its attributes, the '<' is consumed
+  //!
+  //! \param    [in/out] p
+  //!           current position, moved after the tag
+  //! \param    [in] end
+  //!           end of content
+  //! \param    [out] element
+  //!           the created element
+  //! \param    [out] closed
+  //!           whether it is an empty element tag
+  //!
+  //! \return   bool
+  //!           true if the tag is well formed
+  //!
+  bool ParseStartTag(const char*& p, const char* end, OmafXMLElement*& element, bool& closed);
+
+  //!
+  //! \brief    Decode the entities and line ends in text or attribute value
+  //!
+  //! \param    [in] begin
+  //!           text start
+  //! \param    [in] end
+  //!           text end
+  //! \param    [out] out
+  //!           decoded text
+  //!
+  //! \return   void
+  //!
+  static void DecodeText(const char* begin, const char* end, string& out);
+
+  std::unordered_set<string> m_names;  //!< interned names of elements and attributes, released with the parser
+  string m_nameKey;                    //!< buffer to look up the interned names
+  string m_path;                       //!< path set to every element
+};
+
+VCD_OMAF_END
+
+#endif  // OMAFXMLSTREAMPARSER_H
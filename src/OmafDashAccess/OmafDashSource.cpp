@@ -34,6 +34,7 @@
 #include "OmafReaderManager.h"
 #include "OmafTileTracksSelector.h"
 #include "OmafViewTracksSelector.h"
+#include "OmafDashMetrics.h"
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
 #include <sys/time.h>
@@ -111,7 +112,7 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, void* exter
   if (externalLog)
     logCallBack = (LogFunction)externalLog;
   else
-    logCallBack = GlogFunction;
+    logCallBack = AsyncLogFunction;
 
   DIR* dir = opendir(cacheDir.c_str());
   if (dir) {
@@ -219,7 +220,8 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, void* exter
 
     std::string prefix = mMPDinfo->baseURL[0].substr(pos + 1, mMPDinfo->baseURL[0].length() - (pos + 1));
     pDM->SetFilePrefix(prefix);
-    pDM->SetUseCache((cacheDir == "") ? false : true);
+    // segment urls of live streams never repeat, so only VOD segments are cached
+    pDM->SetUseCache((cacheDir != "") && (mMPDinfo->type == TYPE_STATIC));
 
     // sync local time according to the remote mechine for live mode
     if (mMPDinfo->type == TYPE_LIVE && bSync_time) {
@@ -250,11 +252,13 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, void* exter
     params.mode_ = mode;
     params.proj_fmt_ = projFmt;
     params.segment_timeout_ms_ = mMPDinfo->max_segment_duration;
+    params.max_parse_workers_ = omaf_dash_params_.max_parse_workers_;
 
     OMAF_LOG(LOG_INFO, "media stream type=%s\n", mMPDinfo->type.c_str());
     OMAF_LOG(LOG_INFO, "media stream duration=%lld\n", mMPDinfo->media_presentation_duration);
     OMAF_LOG(LOG_INFO, "media stream extractor=%d\n", enableExtractor);
     OMAF_LOG(LOG_INFO, "media mode=%d\n", params.mode_);
+    OMAF_LOG(LOG_INFO, "segment parse workers=%d\n", params.max_parse_workers_);
 
     OmafReaderManager::Ptr omaf_reader_mgr = std::make_shared<OmafReaderManager>(dash_client_, params);
     ret = omaf_reader_mgr->Initialize(this);
@@ -311,6 +315,7 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, void* exter
   if (enablePredictor) m_selector->EnablePosePrediction(predictPluginName, libPath, enableExtractor);
   m_selector->SetSegmentDuration(mMPDinfo->max_segment_duration);
   m_selector->SetI360SCVPPlugin(i360scvp_plugin);
+  m_selector->SetViewportCacheResolution(omaf_dash_params_.viewport_cache_resolution_);
 
   for (auto it =  mMapStream.begin(); it != mMapStream.end(); it++)
   {
@@ -371,6 +376,10 @@ int OmafDashSource::CloseMedia() {
     stream->Close();
   }
 
+  OMAF_LOG(LOG_INFO, "%s\n", PACKETPOOL::GetInstance()->GetStatistics().to_string().c_str());
+  // drop the cached buffers, the packets alive give theirs back later
+  PACKETPOOL::GetInstance()->Shrink();
+
   return ERROR_NONE;
 }
 
@@ -492,6 +501,17 @@ int OmafDashSource::GetPacket(int streamID, std::list<MediaPacket*>* pkts, bool
   return ERROR_NONE;
 }
 
+static void FillLatencyStatistic(const char* name, LatencyStatistic* stat) {
+  HistogramSnapshot snapshot;
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot(name, &snapshot);
+  stat->count = snapshot.count;
+  stat->avg_us = snapshot.count ? snapshot.sum / snapshot.count : 0;
+  stat->p50_us = snapshot.p50;
+  stat->p90_us = snapshot.p90;
+  stat->p99_us = snapshot.p99;
+  stat->max_us = snapshot.max;
+}
+
 int OmafDashSource::GetStatistic(DashStatisticInfo* dsInfo) {
 #if 0
   DownloadManager *pDM = DOWNLOADMANAGER::GetInstance();
@@ -504,6 +524,23 @@ int OmafDashSource::GetStatistic(DashStatisticInfo* dsInfo) {
       dsInfo->avg_bandwidth = static_cast<int32_t>(perf_stats->download_speed_bps_);
     }
   }
+  if (dsInfo) {
+    MetricsRegistry *registry = MetricsRegistry::GetInstance();
+    FillLatencyStatistic(CLIENT_DOWNLOAD_LATENCY, &(dsInfo->download_latency));
+    FillLatencyStatistic(CLIENT_PARSE_LATENCY, &(dsInfo->parse_latency));
+    FillLatencyStatistic(CLIENT_STITCH_LATENCY, &(dsInfo->stitch_latency));
+    FillLatencyStatistic(CLIENT_MERGE_TIME, &(dsInfo->merge_time));
+    FillLatencyStatistic(CLIENT_PACKET_OUT_LATENCY, &(dsInfo->packet_out_latency));
+    dsInfo->downloaded_segments = registry->GetCounterValue(CLIENT_DOWNLOADED_SEGMENTS);
+    dsInfo->downloaded_bytes = registry->GetCounterValue(CLIENT_DOWNLOADED_BYTES);
+    dsInfo->download_failures = registry->GetCounterValue(CLIENT_DOWNLOAD_FAILURES);
+    dsInfo->output_packets = registry->GetCounterValue(CLIENT_OUTPUT_PACKETS);
+
+    DOWNLOADMANAGER::GetInstance()->GetCacheStatistics(dsInfo->cache_hits, dsInfo->cache_misses,
+                                                       dsInfo->cache_saved_bytes);
+    uint64_t lookups = dsInfo->cache_hits + dsInfo->cache_misses;
+    dsInfo->cache_hit_rate = lookups ? static_cast<float>(dsInfo->cache_hits) / lookups : 0;
+  }
 
 #endif
   return ERROR_NONE;
@@ -1132,7 +1169,21 @@ int OmafDashSource::DownloadAssignedSegments(std::map<uint32_t, TracksMap> addit
   return ret;
 }
 
-int OmafDashSource::UpdateMPD() { return ERROR_NONE; }
+int OmafDashSource::UpdateMPD() {
+  if (nullptr == mMPDParser) return ERROR_NULL_PTR;
+
+  OMAFSTREAMS listStream;
+  for (auto it = mMapStream.begin(); it != mMapStream.end(); it++) {
+    listStream.push_back(it->second);
+  }
+
+  // streams are patched in place, so download and stitch threads keep running
+  int ret = mMPDParser->UpdateMPD(listStream);
+  if (ret != ERROR_NONE) {
+    OMAF_LOG(LOG_WARNING, "Failed to refresh the mpd, keep the current one, err=%d\n", ret);
+  }
+  return ret;
+}
 
 std::map<uint32_t, std::map<int, OmafAdaptationSet*>> OmafDashSource::GetNewTracksFromDownloaded(std::map<uint32_t, std::map<int, OmafAdaptationSet*>> additional_tracks, std::list<pair<uint32_t, int>> downloadedCatchupTracks, map<uint32_t, uint32_t> catchupTimesInSeg)
 {
@@ -104,19 +104,63 @@ class SegmentStream : public VCD::MP4::StreamIO {
     return mSegment->GetStreamSize();
   };
 
+  //!
+  //! \brief Get the data in [offset, offset + size) in place
+  //!
+  //! \return const char*
+  //!         the data pointer, or nullptr if the data should be copied
+  //!         out by ReadStream
+  virtual const char* GetDataView(offset_t offset, offset_t size) {
+    if (nullptr == mSegment) return nullptr;
+
+    return mSegment->GetDataView(offset, size);
+  };
+
  private:
   OmafSegment* mSegment = nullptr;
 };
 
-OmafMP4VRReader::OmafMP4VRReader() { mMP4ReaderImpl = (void*)VCD::MP4::Mp4Reader::Create(); }
+//!
+//! \brief  Guards of the reader lock. Querying the parsed boxes, reading
+//!         samples and reading the boxes of different segments can run in
+//!         parallel, while adding a parsed segment to the reader maps or
+//!         invalidating a segment updates the maps exclusively.
+//!
+class ReaderSharedLock {
+ public:
+  ReaderSharedLock(pthread_rwlock_t& lock) : mLock(lock) { pthread_rwlock_rdlock(&mLock); };
+  ~ReaderSharedLock() { pthread_rwlock_unlock(&mLock); };
+
+ private:
+  pthread_rwlock_t& mLock;
+};
+
+class ReaderExclusiveLock {
+ public:
+  ReaderExclusiveLock(pthread_rwlock_t& lock) : mLock(lock) { pthread_rwlock_wrlock(&mLock); };
+  ~ReaderExclusiveLock() { pthread_rwlock_unlock(&mLock); };
 
-OmafMP4VRReader::OmafMP4VRReader(OmafMP4VRReader&& other) { mMP4ReaderImpl = std::move(other.mMP4ReaderImpl); }
+ private:
+  pthread_rwlock_t& mLock;
+};
+
+OmafMP4VRReader::OmafMP4VRReader() {
+  mMP4ReaderImpl = (void*)VCD::MP4::Mp4Reader::Create();
+  pthread_rwlock_init(&mRWLock, nullptr);
+}
+
+OmafMP4VRReader::OmafMP4VRReader(OmafMP4VRReader&& other) {
+  mMP4ReaderImpl = std::move(other.mMP4ReaderImpl);
+  other.mMP4ReaderImpl = nullptr;
+  pthread_rwlock_init(&mRWLock, nullptr);
+}
 
 OmafMP4VRReader::~OmafMP4VRReader() {
   if (mMP4ReaderImpl) {
     VCD::MP4::Mp4Reader::Destroy((VCD::MP4::Mp4Reader*)mMP4ReaderImpl);
     mMP4ReaderImpl = nullptr;
   }
+  pthread_rwlock_destroy(&mRWLock);
 }
 
 int32_t OmafMP4VRReader::initialize(OmafSegment* pSeg) {
@@ -125,6 +169,7 @@ int32_t OmafMP4VRReader::initialize(OmafSegment* pSeg) {
   }
 
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderExclusiveLock lock(mRWLock);
 
   return pReader->Initialize(new SegmentStream(pSeg));
 }
@@ -135,6 +180,7 @@ void OmafMP4VRReader::close() {
     return;
   }
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderExclusiveLock lock(mRWLock);
 
   pReader->Close();
 }
@@ -142,6 +188,7 @@ void OmafMP4VRReader::close() {
 int32_t OmafMP4VRReader::getMajorBrand(FourCC& majorBrand, uint32_t initializationSegmentId, uint32_t segmentId) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
   VCD::MP4::FourCC brand;
   int ret = pReader->GetMajorBrand(brand, initializationSegmentId, segmentId);
 
@@ -156,6 +203,7 @@ int32_t OmafMP4VRReader::getMinorVersion(uint32_t& minorVersion, uint32_t initia
                                          uint32_t segmentId) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetMinorVersion(minorVersion, initializationSegmentId, segmentId);
 }
@@ -164,6 +212,7 @@ int32_t OmafMP4VRReader::getCompatibleBrands(std::vector<VCD::OMAF::FourCC*>& co
                                              uint32_t initializationSegmentId, uint32_t segmentId) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VarLenArray<VCD::MP4::FourCC> brands;
 
@@ -245,6 +294,7 @@ int32_t OmafMP4VRReader::getTrackInformations(std::vector<VCD::OMAF::TrackInform
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
 #if 1
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   if (trackInfos.size() != 0) trackInfos.clear();
 
@@ -295,6 +345,7 @@ int32_t OmafMP4VRReader::getTrackInformations(std::vector<VCD::OMAF::TrackInform
 int32_t OmafMP4VRReader::getDisplayWidth(uint32_t trackId, uint32_t& displayWidth) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDisplayWidth(trackId, displayWidth);
 }
@@ -302,6 +353,7 @@ int32_t OmafMP4VRReader::getDisplayWidth(uint32_t trackId, uint32_t& displayWidt
 int32_t OmafMP4VRReader::getDisplayHeight(uint32_t trackId, uint32_t& displayHeight) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDisplayHeight(trackId, displayHeight);
 }
@@ -309,6 +361,7 @@ int32_t OmafMP4VRReader::getDisplayHeight(uint32_t trackId, uint32_t& displayHei
 int32_t OmafMP4VRReader::getDisplayWidthFP(uint32_t trackId, uint32_t& displayWidth) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDisplayWidthFP(trackId, displayWidth);
 }
@@ -316,6 +369,7 @@ int32_t OmafMP4VRReader::getDisplayWidthFP(uint32_t trackId, uint32_t& displayWi
 int32_t OmafMP4VRReader::getDisplayHeightFP(uint32_t trackId, uint32_t& displayHeight) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDisplayHeightFP(trackId, displayHeight);
 }
@@ -323,6 +377,7 @@ int32_t OmafMP4VRReader::getDisplayHeightFP(uint32_t trackId, uint32_t& displayH
 int32_t OmafMP4VRReader::getWidth(uint32_t trackId, uint32_t sampleId, uint32_t& width) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetWidth(trackId, sampleId, width);
 }
@@ -330,6 +385,7 @@ int32_t OmafMP4VRReader::getWidth(uint32_t trackId, uint32_t sampleId, uint32_t&
 int32_t OmafMP4VRReader::getHeight(uint32_t trackId, uint32_t sampleId, uint32_t& height) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetHeight(trackId, sampleId, height);
 }
@@ -337,6 +393,7 @@ int32_t OmafMP4VRReader::getHeight(uint32_t trackId, uint32_t sampleId, uint32_t
 int32_t OmafMP4VRReader::getDims(uint32_t trackId, uint32_t sampleId, uint32_t& width, uint32_t& height) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDims(trackId, sampleId, width, height);
 }
@@ -344,6 +401,7 @@ int32_t OmafMP4VRReader::getDims(uint32_t trackId, uint32_t sampleId, uint32_t&
 int32_t OmafMP4VRReader::getPlaybackDurationInSecs(uint32_t trackId, double& durationInSecs) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetPlaybackDurationInSecs(trackId, durationInSecs);
 }
@@ -352,6 +410,7 @@ int32_t OmafMP4VRReader::getTrackSampleListByType(uint32_t trackId, VCD::OMAF::T
                                                   std::vector<uint32_t>& sampleIds) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::SampleFrameType type;
 
@@ -372,6 +431,7 @@ int32_t OmafMP4VRReader::getTrackSampleType(uint32_t trackId, uint32_t sampleId,
                                             VCD::OMAF::FourCC& trackSampleBoxType) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::FourCC cc;
 
@@ -390,6 +450,7 @@ int32_t OmafMP4VRReader::getExtractorTrackSampleData(uint32_t trackId, uint32_t
                                                      uint32_t& memoryBufferSize, bool videoByteStreamHeaders) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
   int ret =
       pReader->GetExtractorTrackSampData(trackId, sampleId, memoryBuffer, memoryBufferSize, videoByteStreamHeaders);
 
@@ -400,6 +461,7 @@ int32_t OmafMP4VRReader::getTrackSampleData(uint32_t trackId, uint32_t sampleId,
                                             uint32_t& memoryBufferSize, bool videoByteStreamHeaders) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
   int ret = pReader->GetSampData(trackId, sampleId, memoryBuffer, memoryBufferSize, videoByteStreamHeaders);
 
   return ret;
@@ -409,14 +471,29 @@ int32_t OmafMP4VRReader::getTrackSampleOffset(uint32_t trackId, uint32_t sampleI
                                               uint32_t& sampleLength) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetSampOffset(trackId, sampleId, sampleOffset, sampleLength);
 }
 
+int32_t OmafMP4VRReader::getSegmentSamples(uint32_t trackId, uint32_t segmentId, std::vector<SegmentSample>& samples) {
+  if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
+  VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
+
+  VCD::MP4::VarLenArray<VCD::MP4::SegSample> segSamples;
+  int32_t ret = pReader->GetSegSamples(trackId, segmentId, segSamples);
+  if (ret != ERROR_NONE) return ret;
+
+  samples.assign(segSamples.GetBegin(), segSamples.GetEnd());
+  return ERROR_NONE;
+}
+
 int32_t OmafMP4VRReader::getDecoderConfiguration(uint32_t trackId, uint32_t sampleId,
                                                  std::vector<VCD::OMAF::DecoderSpecificInfo>& decoderInfos) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VarLenArray<VCD::MP4::MediaCodecSpecInfo>* Infos = new VCD::MP4::VarLenArray<VCD::MP4::MediaCodecSpecInfo>;
 
@@ -437,6 +514,7 @@ int32_t OmafMP4VRReader::getTrackTimestamps(uint32_t trackId,
                                             std::vector<VCD::OMAF::TimestampIDPair>& timestamps) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VarLenArray<VCD::MP4::TStampID> id_pairs;
 
@@ -458,6 +536,7 @@ int32_t OmafMP4VRReader::getTimestampsOfSample(uint32_t trackId, uint32_t sample
                                                std::vector<uint64_t>& timestamps) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VarLenArray<uint64_t> tms;
 
@@ -474,6 +553,7 @@ int32_t OmafMP4VRReader::getSamplesInDecodingOrder(uint32_t trackId,
                                                    std::vector<VCD::OMAF::TimestampIDPair>& sampleDecodingOrder) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VarLenArray<VCD::MP4::TStampID> id_pairs;
 
@@ -495,6 +575,7 @@ int32_t OmafMP4VRReader::getDecoderCodeType(uint32_t trackId, uint32_t sampleId,
                                             VCD::OMAF::FourCC& decoderCodeType) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::FourCC cc;
 
@@ -508,6 +589,7 @@ int32_t OmafMP4VRReader::getDecoderCodeType(uint32_t trackId, uint32_t sampleId,
 int32_t OmafMP4VRReader::getSampleDuration(uint32_t trackId, uint32_t sampleId, uint32_t& sampleDuration) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   return pReader->GetDurOfSamp(trackId, sampleId, sampleDuration);
 }
@@ -516,6 +598,7 @@ int32_t OmafMP4VRReader::getPropertyChnl(uint32_t trackId, uint32_t sampleId,
                                          VCD::OMAF::chnlProperty& chProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::ChnlProperty chProp;
 
@@ -530,6 +613,7 @@ int32_t OmafMP4VRReader::getPropertySpatialAudio(uint32_t trackId, uint32_t samp
                                                  VCD::OMAF::SpatialAudioProperty& spatialaudioproperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::SpatialAudioProperty spProp;
 
@@ -544,6 +628,7 @@ int32_t OmafMP4VRReader::getPropertyStereoScopic3D(uint32_t trackId, uint32_t sa
                                                    VCD::OMAF::StereoScopic3DProperty& stereoscopicproperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::OmniStereoScopic3D ssProp;
 
@@ -562,6 +647,7 @@ int32_t OmafMP4VRReader::getPropertySphericalVideoV2(uint32_t trackId, uint32_t
                                                      VCD::OMAF::SphericalVideoV2Property& sphericalproperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::SphericalVideoV2Property sv2Prop;
 
@@ -576,6 +662,7 @@ int32_t OmafMP4VRReader::getPropertyRegionWisePacking(uint32_t trackId, uint32_t
                                                       RegionWisePacking* rwpk) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::RWPKProperty rwpkProp;
 
@@ -620,6 +707,7 @@ int32_t OmafMP4VRReader::getProducerReferenceTime(uint32_t initSegmentId, uint32
                                                       VCD::OMAF::ProducerReferenceTimePropery& prft) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::PRFTProperty prftProp;
 
@@ -636,6 +724,7 @@ int32_t OmafMP4VRReader::getPropertyCoverageInformation(uint32_t trackId, uint32
                                                         VCD::OMAF::CoverageInformationProperty& coviProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::COVIInformation ccProp;
 
@@ -650,6 +739,7 @@ int32_t OmafMP4VRReader::getPropertyProjectionFormat(
     uint32_t trackId, uint32_t sampleId, VCD::OMAF::ProjectionFormatProperty& projectionFormatProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::ProjFormat pfProp;
 
@@ -664,6 +754,7 @@ int32_t OmafMP4VRReader::getPropertySchemeTypes(uint32_t trackId, uint32_t sampl
                                                 VCD::OMAF::SchemeTypesProperty& schemeTypesProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::SchemeTypesProperty stProp;
 
@@ -678,6 +769,7 @@ int32_t OmafMP4VRReader::getPropertyStereoVideoConfiguration(
     uint32_t trackId, uint32_t sampleId, VCD::OMAF::PodvStereoVideoConfiguration& stereoVideoProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::VideoFramePackingType psConf;
 
@@ -692,6 +784,7 @@ int32_t OmafMP4VRReader::getPropertyRotation(uint32_t trackId, uint32_t sampleId
                                              VCD::OMAF::Rotation& rotationProperty) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderSharedLock lock(mRWLock);
 
   VCD::MP4::Rotation rot;
 
@@ -705,6 +798,7 @@ int32_t OmafMP4VRReader::getPropertyRotation(uint32_t trackId, uint32_t sampleId
 int32_t OmafMP4VRReader::parseInitializationSegment(OmafSegment* streamInterface, uint32_t initSegmentId) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderExclusiveLock lock(mRWLock);
 
   SegmentStream* segment = new SegmentStream(streamInterface);
   if (nullptr == segment) return ERROR_NULL_PTR;
@@ -715,6 +809,7 @@ int32_t OmafMP4VRReader::parseInitializationSegment(OmafSegment* streamInterface
 int32_t OmafMP4VRReader::invalidateInitializationSegment(uint32_t initSegmentId) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderExclusiveLock lock(mRWLock);
 
   return pReader->DisableInitSeg(initSegmentId);
 }
@@ -727,7 +822,17 @@ int32_t OmafMP4VRReader::parseSegment(OmafSegment* streamInterface, uint32_t ini
   SegmentStream* segment = new SegmentStream(streamInterface);
   if (nullptr == segment) return ERROR_NULL_PTR;
 
-  return pReader->ParseSeg(segment, initSegmentId, segmentId, earliestPTSinTS);
+  // reading the boxes only looks up the reader maps, so segments are read
+  // in parallel and only adding them to the maps is exclusive
+  VCD::MP4::ParsedSegment parsedSeg;
+  {
+    ReaderSharedLock lock(mRWLock);
+    int32_t ret = pReader->ReadSeg(segment, initSegmentId, segmentId, parsedSeg);
+    if (ret) return ret;
+  }
+
+  ReaderExclusiveLock lock(mRWLock);
+  return pReader->AddParsedSeg(parsedSeg, earliestPTSinTS);
 }
 
 int32_t OmafMP4VRReader::getSegmentHeaderSize(bool hasSidx, uint32_t ref_cnt, uint64_t& size, uint8_t version) {
@@ -812,6 +917,7 @@ int32_t OmafMP4VRReader::getSegmentIndexRangeFromCloc(char* indexBuf, size_t siz
 int32_t OmafMP4VRReader::invalidateSegment(uint32_t initSegmentId, uint32_t segmentId) {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
   VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+  ReaderExclusiveLock lock(mRWLock);
   return pReader->DisableSeg(initSegmentId, segmentId);
 }
 
@@ -36,13 +36,15 @@
 
 #include "OmafReader.h"
 
+#include <pthread.h>
+
 VCD_OMAF_BEGIN
 
 class OmafMP4VRReader : public OmafReader{
 public:
     OmafMP4VRReader();
     OmafMP4VRReader(OmafMP4VRReader&& other);
-    OmafMP4VRReader& operator=(const OmafMP4VRReader&) = default;
+    OmafMP4VRReader& operator=(const OmafMP4VRReader&) = delete;
     virtual ~OmafMP4VRReader();
 
 public:
@@ -102,6 +104,8 @@ public:
 
     virtual int32_t getTrackSampleOffset(uint32_t trackId, uint32_t sampleId, uint64_t& sampleOffset, uint32_t& sampleLength)  ;
 
+    virtual int32_t getSegmentSamples(uint32_t trackId, uint32_t segmentId, std::vector<SegmentSample>& samples)  ;
+
     virtual int32_t getDecoderConfiguration(uint32_t trackId, uint32_t sampleId, std::vector<VCD::OMAF::DecoderSpecificInfo>& decoderInfos) const  ;
 
     virtual int32_t getTrackTimestamps(uint32_t trackId, std::vector<VCD::OMAF::TimestampIDPair>& timestamps) const  ;
@@ -224,6 +228,7 @@ public:  // MP4VR segment parsing methods (DASH/Streaming)
 
 private:
     void*  mMP4ReaderImpl;
+    mutable pthread_rwlock_t mRWLock;   //!< shared for queries and segment reading, exclusive for map updates
     void SelectedTrackInfos(std::vector<VCD::OMAF::TrackInformation*>& trackInfos, std::vector<VCD::OMAF::TrackInformation*> middleTrackInfos) const;
 };
 
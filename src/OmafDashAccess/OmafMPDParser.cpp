@@ -157,7 +157,99 @@ int OmafMPDParser::ParseMPDInfo() {
   return ERROR_NONE;
 }
 
-int OmafMPDParser::UpdateMPD(OMAFSTREAMS& listStream) { return ParseMPD(this->mMPDURL, listStream); }
+void OmafMPDParser::UpdateMPDInfo(MPDElement* pNewMpd) {
+  if (mMpd->GetPublishTime() != pNewMpd->GetPublishTime()) {
+    OMAF_LOG(LOG_INFO, "MPD publish time is updated to %s\n", pNewMpd->GetPublishTime().c_str());
+    mMpd->SetPublishTime(pNewMpd->GetPublishTime());
+  }
+  if (mMpd->GetType() != pNewMpd->GetType()) {
+    OMAF_LOG(LOG_INFO, "MPD type is updated to %s\n", pNewMpd->GetType().c_str());
+    mMpd->SetType(pNewMpd->GetType());
+    mMPDInfo->type = pNewMpd->GetType();
+  }
+  if (mMpd->GetMinimumUpdatePeriod() != pNewMpd->GetMinimumUpdatePeriod()) {
+    OMAF_LOG(LOG_INFO, "MPD minimum update period is updated to %s\n", pNewMpd->GetMinimumUpdatePeriod().c_str());
+    mMpd->SetMinimumUpdatePeriod(pNewMpd->GetMinimumUpdatePeriod());
+    mMPDInfo->minimum_update_period =
+        pNewMpd->GetMinimumUpdatePeriod().empty() ? 0 : parse_duration(pNewMpd->GetMinimumUpdatePeriod().c_str());
+  }
+  if (mMpd->GetAvailabilityStartTime() != pNewMpd->GetAvailabilityStartTime() &&
+      !pNewMpd->GetAvailabilityStartTime().empty()) {
+    OMAF_LOG(LOG_INFO, "MPD availability start time is updated to %s\n", pNewMpd->GetAvailabilityStartTime().c_str());
+    mMpd->SetAvailabilityStartTime(pNewMpd->GetAvailabilityStartTime());
+    mMPDInfo->availabilityStartTime = parse_date(pNewMpd->GetAvailabilityStartTime().c_str());
+  }
+  if (mMpd->GetAvailabilityEndTime() != pNewMpd->GetAvailabilityEndTime() &&
+      !pNewMpd->GetAvailabilityEndTime().empty()) {
+    mMpd->SetAvailabilityEndTime(pNewMpd->GetAvailabilityEndTime());
+    mMPDInfo->availabilityEndTime = parse_date(pNewMpd->GetAvailabilityEndTime().c_str());
+  }
+  if (mMpd->GetMediaPresentationDuration() != pNewMpd->GetMediaPresentationDuration() &&
+      !pNewMpd->GetMediaPresentationDuration().empty()) {
+    mMpd->SetMediaPresentationDuration(pNewMpd->GetMediaPresentationDuration());
+    mMPDInfo->media_presentation_duration = parse_duration(pNewMpd->GetMediaPresentationDuration().c_str());
+  }
+  if (mMpd->GetMaxSegmentDuration() != pNewMpd->GetMaxSegmentDuration() &&
+      !pNewMpd->GetMaxSegmentDuration().empty()) {
+    mMpd->SetMaxSegmentDuration(pNewMpd->GetMaxSegmentDuration());
+    mMPDInfo->max_segment_duration = parse_duration(pNewMpd->GetMaxSegmentDuration().c_str());
+  }
+  if (mMpd->GetTimeShiftBufferDepth() != pNewMpd->GetTimeShiftBufferDepth() &&
+      !pNewMpd->GetTimeShiftBufferDepth().empty()) {
+    mMpd->SetTimeShiftBufferDepth(pNewMpd->GetTimeShiftBufferDepth());
+    mMPDInfo->time_shift_buffer_depth = parse_duration(pNewMpd->GetTimeShiftBufferDepth().c_str());
+  }
+}
+
+int OmafMPDParser::UpdateMPD(OMAFSTREAMS& listStream) {
+  std::lock_guard<std::mutex> lock(mLock);
+
+  if (nullptr == mMpd || nullptr == mMPDInfo) {
+    OMAF_LOG(LOG_ERROR, "MPD should be parsed before it is updated!\n");
+    return ERROR_INVALID;
+  }
+
+  // the refreshed mpd is parsed in memory with a temporary parser, and its
+  // tree is released after the current tree is patched, so that the elements
+  // referred by the streams keep valid during downloading.
+  OmafXMLParser parser;
+  parser.SetOmafHttpParams(omaf_dash_params_.http_proxy_, omaf_dash_params_.http_params_);
+
+  std::string content;
+  ODStatus st = parser.ReadXMLContent(mMPDURL, content);
+  if (st != OD_STATUS_SUCCESS) {
+    OMAF_LOG(LOG_ERROR, "Failed to fetch refreshed MPD: %s\n", mMPDURL.c_str());
+    return st;
+  }
+
+  st = parser.GenerateFromBuffer(mMPDURL, content);
+  if (st != OD_STATUS_SUCCESS) {
+    OMAF_LOG(LOG_ERROR, "Failed to load refreshed MPD: %s\n", mMPDURL.c_str());
+    return st;
+  }
+
+  MPDElement* pNewMpd = parser.GetGeneratedMPD();
+  if (nullptr == pNewMpd || pNewMpd->GetPeriods().empty()) {
+    OMAF_LOG(LOG_ERROR, "Failed to get the refreshed mpd!\n");
+    return ERROR_PARSE;
+  }
+
+  UpdateMPDInfo(pNewMpd);
+
+  ///only consider one period in this version
+  std::map<int, AdaptationSetElement*> mapAdaptationSets;
+  PeriodElement* pPeriod = pNewMpd->GetPeriods()[0];
+  for (auto pAS : pPeriod->GetAdaptationSets()) {
+    if (pAS->GetId().empty()) continue;
+    mapAdaptationSets[StringToInt(pAS->GetId())] = pAS;
+  }
+
+  for (auto pStream : listStream) {
+    pStream->UpdateFromMPD(mapAdaptationSets);
+  }
+
+  return ERROR_NONE;
+}
 
 MPDInfo* OmafMPDParser::GetMPDInfo() { return this->mMPDInfo; }
 
@@ -80,7 +80,8 @@ class OmafMPDParser {
   int ParseMPD(std::string mpd_file, OMAFSTREAMS& listStream);
 
   //!
-  //! \brief  update MPD and get construct media streams for live if needed.
+  //! \brief  refresh MPD for live, the refreshed MPD is parsed in memory and
+  //!         existing media streams are patched in place with it.
   //!
   int UpdateMPD(OMAFSTREAMS& listStream);
 
@@ -115,6 +116,11 @@ class OmafMPDParser {
   //!
   int ParseMPDInfo();
 
+  //!
+  //! \brief Update MPD information with the refreshed MPD
+  //!
+  void UpdateMPDInfo(MPDElement* pNewMpd);
+
   //!
   //! \brief group all adaptationSet based on the dependency.
   //!
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   OmafMappedFile.cpp
+//! \brief:  memory mapped file stream for local segment playback
+//!
+
+#include "OmafMappedFile.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+VCD_OMAF_BEGIN
+
+bool OmafMappedFile::Open(const std::string &fileName) noexcept {
+  Close();
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    OMAF_LOG(LOG_ERROR, "Failed to open segment file %s\n", fileName.c_str());
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping holds its own reference of the file
+  close(fd);
+  if (data == MAP_FAILED) {
+    OMAF_LOG(LOG_WARNING, "Failed to map segment file %s\n", fileName.c_str());
+    return false;
+  }
+
+  // the segment is parsed from head to tail, then samples are read in order
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+  madvise(data, st.st_size, MADV_WILLNEED);
+
+  data_ = static_cast<char *>(data);
+  size_ = st.st_size;
+  offset_ = 0;
+  return true;
+}
+
+void OmafMappedFile::Close() noexcept {
+  if (data_) {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+  offset_ = 0;
+}
+
+VCD::MP4::StreamIO::offset_t OmafMappedFile::ReadStream(char *buffer, offset_t size) {
+  if (!data_ || size <= 0 || offset_ >= size_) return 0;
+
+  offset_t readSize = (size < size_ - offset_) ? size : (size_ - offset_);
+  memcpy(buffer, data_ + offset_, readSize);
+  offset_ += readSize;
+  return readSize;
+}
+
+bool OmafMappedFile::SeekAbsoluteOffset(offset_t offset) {
+  if (!data_ || offset < 0 || offset > size_) return false;
+
+  offset_ = offset;
+  return true;
+}
+
+const char *OmafMappedFile::GetDataView(offset_t offset, offset_t size) {
+  if (!data_ || offset < 0 || size < 0 || offset + size > size_) return nullptr;
+
+  return data_ + offset;
+}
+
+bool OmafMappedFile::Prefetch(const std::string &fileName) noexcept {
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  // the file isn't mapped yet, so hint the page cache of the file directly
+  int ret = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+  return ret == 0;
+}
+
+VCD_OMAF_END
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   OmafMappedFile.h
+//! \brief:  memory mapped file stream for local segment playback
+//!
+
+#ifndef OMAFMAPPEDFILE_H
+#define OMAFMAPPEDFILE_H
+
+#include "general.h"
+#include "../isolib/dash_parser/Mp4StreamIO.h"
+
+#include <string>
+
+//! the number of next local segment files read ahead by default
+#define LOCAL_SEGMENT_PREFETCH_NUM 2
+
+VCD_OMAF_BEGIN
+
+//!
+//! \class  OmafMappedFile
+//! \brief  Read only stream over a memory mapped segment file, boxes and
+//!         samples are referenced in place from the mapping
+//!
+class OmafMappedFile : public VCD::MP4::StreamIO {
+ public:
+  OmafMappedFile() = default;
+
+  virtual ~OmafMappedFile() { Close(); };
+
+  OmafMappedFile(const OmafMappedFile &) = delete;
+  OmafMappedFile &operator=(const OmafMappedFile &) = delete;
+
+ public:
+  //!
+  //! \brief  map the whole file and hint the kernel for sequential read
+  //!
+  //! \param  [in] fileName
+  //!         the segment file
+  //!
+  //! \return bool
+  //!         true if the file is mapped, empty file can't be mapped
+  //!
+  bool Open(const std::string &fileName) noexcept;
+
+  //!
+  //! \brief  unmap the file
+  //!
+  void Close() noexcept;
+
+  inline bool IsOpen() const noexcept { return data_ != nullptr; };
+
+  offset_t ReadStream(char *buffer, offset_t size) override;
+
+  bool SeekAbsoluteOffset(offset_t offset) override;
+
+  offset_t TellOffset() override { return offset_; };
+
+  offset_t GetStreamSize() override { return size_; };
+
+  const char *GetDataView(offset_t offset, offset_t size) override;
+
+  //!
+  //! \brief  start reading the file into the page cache in background,
+  //!         so that it is ready when the segment is mapped later
+  //!
+  //! \param  [in] fileName
+  //!         the segment file
+  //!
+  //! \return bool
+  //!         true if the read ahead is issued
+  //!
+  static bool Prefetch(const std::string &fileName) noexcept;
+
+ private:
+  char *data_ = nullptr;
+  offset_t size_ = 0;
+  offset_t offset_ = 0;
+};
+
+VCD_OMAF_END
+
+#endif /* OMAFMAPPEDFILE_H */
@@ -230,6 +230,7 @@ class OmafMediaSource {
  public:
   void SetOmafDashParams(OmafDashParams params) { omaf_dash_params_ = params; };
   OmafDashParams GetOmafParams() { return omaf_dash_params_; };
+  bool IsPacketReleaseEnabled() { return omaf_dash_params_.enable_packet_release_; };
 
  protected:
   OmafDashParams omaf_dash_params_;
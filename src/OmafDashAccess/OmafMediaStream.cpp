@@ -32,6 +32,7 @@
 #include "OmafMediaStream.h"
 #include "OmafReader.h"
 #include "OmafMP4VRReader.h"
+#include "OmafDashMetrics.h"
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
 #include "../trace/MtHQ_tp.h"
@@ -158,6 +159,10 @@ void OmafMediaStream::Close() {
   if (m_status != STATUS_STOPPED) {
     m_status = STATUS_STOPPED;
     m_catchup_status = STATUS_STOPPED;
+    {
+      std::lock_guard<std::mutex> lock(mCurrentMutex);
+      m_selectionCond.notify_all();
+    }
     if (m_stitchThread) {
       pthread_join(m_stitchThread, NULL);
       m_stitchThread = 0;
@@ -550,6 +555,32 @@ int OmafMediaStream::UpdateStartNumber(uint64_t nAvailableStartTime) {
   return ret;
 }
 
+int OmafMediaStream::UpdateFromMPD(const std::map<int, AdaptationSetElement*>& mapAdaptationSets) {
+  int updated = 0;
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto it = mMediaAdaptationSet.begin(); it != mMediaAdaptationSet.end(); it++) {
+    OmafAdaptationSet* pAS = (OmafAdaptationSet*)(it->second);
+    auto as_it = mapAdaptationSets.find(pAS->GetID());
+    if (as_it == mapAdaptationSets.end()) {
+      OMAF_LOG(LOG_WARNING, "AdaptationSet %d is not found in refreshed mpd\n", pAS->GetID());
+      continue;
+    }
+    if (pAS->UpdateFromMPD(as_it->second) == ERROR_NONE) updated++;
+  }
+  std::lock_guard<std::mutex> lock_et(mExtractorsMutex);
+  for (auto extrator_it = mExtractors.begin(); extrator_it != mExtractors.end(); extrator_it++) {
+    OmafExtractor* extractor = (OmafExtractor*)(extrator_it->second);
+    auto as_it = mapAdaptationSets.find(extractor->GetID());
+    if (as_it == mapAdaptationSets.end()) {
+      OMAF_LOG(LOG_WARNING, "Extractor %d is not found in refreshed mpd\n", extractor->GetID());
+      continue;
+    }
+    if (extractor->UpdateFromMPD(as_it->second) == ERROR_NONE) updated++;
+  }
+  return updated;
+}
+
 int OmafMediaStream::DownloadInitSegment() {
   std::lock_guard<std::mutex> lock(mMutex);
   for (auto it = mMediaAdaptationSet.begin(); it != mMediaAdaptationSet.end(); it++) {
@@ -807,6 +838,7 @@ int OmafMediaStream::UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> s
       // for the usage of free view
       mCurrentTracks.clear();
       mCurrentTracks = oneSelection;
+      m_selectionCond.notify_all();
     }
   }
 
@@ -892,18 +924,25 @@ int32_t OmafMediaStream::GetSelectedPacketsWithPTS(uint64_t targetPTS, pair<uint
       return ERROR_NULL_PTR;
     }
     // LOG(INFO) << "Target pts is " << targetPTS << " track id " << track.first << endl;
+    uint64_t seen_count = omaf_reader_mgr_->GetParsedSegmentCount();
     ret = omaf_reader_mgr_->GetNextPacketWithPTS(track.first, targetPTS, onePacket, needParams);
 
-    uint32_t wait_time_get_packet = 0;
-    uint32_t wait_timeout_get_packet = 100;
-    while (((onePacket && onePacket->GetEOS()) || (ret == ERROR_NULL_PACKET)) && (wait_time_get_packet < wait_timeout_get_packet) && m_catchup_status != STATUS_STOPPED)
+    std::chrono::steady_clock::time_point deadline;
+    if (m_pStreamInfo) {
+      deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_pStreamInfo->segmentDuration * 1000 / 2);
+    }
+    while (((onePacket && onePacket->GetEOS()) || (ret == ERROR_NULL_PACKET)) && m_catchup_status != STATUS_STOPPED)
     {
       if (!m_pStreamInfo) {
         SAFE_DELETE(onePacket);
         return ERROR_NULL_PTR;
       }
-      usleep((m_pStreamInfo->segmentDuration * 1000000 / 2) / wait_timeout_get_packet);
-      wait_time_get_packet++;
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) break;
+      // woken up by the next parsed segment instead of polling
+      uint32_t remain_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+      if (omaf_reader_mgr_->WaitForParsedSegment(seen_count, remain_ms) == ERROR_INVALID) break;
+      seen_count = omaf_reader_mgr_->GetParsedSegmentCount();
       //OMAF_LOG(LOG_INFO, "To get packet %ld for track %d\n", currFramePTS, trackID);
       ret = omaf_reader_mgr_->GetNextPacketWithPTS(track.first, targetPTS, onePacket, needParams);
     }
@@ -1048,32 +1087,25 @@ int32_t OmafMediaStream::TilesStitching() {
     return OMAF_ERROR_NULL_PTR;
   }
   int ret = ERROR_NONE;
-  bool selectedFlag = false;
-  uint32_t wait_time = 30000;
-  uint32_t current_wait_time = 0;
+  uint32_t wait_time = 3000; // ms
 
-  do
   {
-    {
-      std::lock_guard<std::mutex> lock(mCurrentMutex);
-      selectedFlag = m_hasTileTracksSelected;
-    }
-    usleep(100);
-    current_wait_time++;
-    if (current_wait_time > wait_time)
+    std::unique_lock<std::mutex> lock(mCurrentMutex);
+    if (!m_selectionCond.wait_for(lock, std::chrono::milliseconds(wait_time),
+                                  [this]() { return m_hasTileTracksSelected || m_status == STATUS_STOPPED; }))
     {
       OMAF_LOG(LOG_ERROR, "Time out for tile track select!\n");
       return ERROR_INVALID;
     }
-  }while (!selectedFlag);
+    if (!m_hasTileTracksSelected) return ERROR_NONE;
+  }
 
   uint64_t currFramePTS = 0;
   uint64_t currSegTimeLine = 0;
   std::map<int, OmafAdaptationSet*> mapSelectedAS;
   bool isEOS = false;
   uint32_t waitTimes = 1000;
-  uint32_t waitTimes_GetPacket = 100;
-  uint32_t selectionWaitTimes = 10000;
+  uint32_t selectionWaitTimeout = 500; // ms
   bool prevPoseChanged = false;
   std::map<int, OmafAdaptationSet*> prevSelectedAS;
   bool segmentEnded = false;
@@ -1082,11 +1114,15 @@ int32_t OmafMediaStream::TilesStitching() {
   bool skipFrames = false;
   bool beginNewSeg = false;
 
-  int64_t startOffsetPts = -1;
-  do {
+  int64_t startOffsetPts = omaf_reader_mgr_->GetStartOffsetPts();
+  while (startOffsetPts < 0 && m_status != STATUS_STOPPED) {
+    if (omaf_reader_mgr_->WaitForStartOffsetPts(selectionWaitTimeout) == ERROR_INVALID) break;
     startOffsetPts = omaf_reader_mgr_->GetStartOffsetPts();
-    usleep(50);
-  }while (startOffsetPts < 0);
+  }
+  if (startOffsetPts < 0) {
+    OMAF_LOG(LOG_INFO, "Stop tiles stitching before start offset pts is set!\n");
+    return ERROR_NONE;
+  }
 
   currFramePTS = startOffsetPts;
 
@@ -1117,25 +1153,19 @@ int32_t OmafMediaStream::TilesStitching() {
     {
         if (prevSelectedAS.empty())
         {
-          while (currWaitTimes < selectionWaitTimes)
           {
+            std::unique_lock<std::mutex> lock(mCurrentMutex);
+            if (!m_selectionCond.wait_for(lock, std::chrono::milliseconds(selectionWaitTimeout),
+                                          [this]() { return m_selectedTileTracks.size() >= 2 || m_status == STATUS_STOPPED; }))
             {
-              std::lock_guard<std::mutex> lock(mCurrentMutex);
-              if (m_selectedTileTracks.size() >= 2)
-                  break;
+              OMAF_LOG(LOG_ERROR, "Wait too much time for tiles selection, timed out !\n");
+              break;
+            }
+            if (m_status == STATUS_STOPPED)
+            {
+              OMAF_LOG(LOG_INFO, "Status Stopped !\n");
+              break;
             }
-            usleep(50);
-            currWaitTimes++;
-          }
-          if (currWaitTimes >= selectionWaitTimes)
-          {
-            OMAF_LOG(LOG_ERROR, "Wait too much time for tiles selection, timed out !\n");
-            break;
-          }
-          currWaitTimes = 0;
-
-          {
-            std::lock_guard<std::mutex> lock(mCurrentMutex);
 
             //m_selectedTileTracks.pop_front(); //At the beginning, there are two same tiles selection in m_selectedTileTracks due to previous process in StartReadThread, so remove repeated one
             updatedSelectedAS = m_selectedTileTracks[1]; //At the beginning, there are two same tiles selection in m_selectedTileTracks due to previous process in StartReadThread, so remove repeated one
@@ -1144,41 +1174,26 @@ int32_t OmafMediaStream::TilesStitching() {
         }
         else
         {
-          while (currWaitTimes < selectionWaitTimes)
+          std::unique_lock<std::mutex> lock(mCurrentMutex);
+          bool selected = m_selectionCond.wait_for(lock, std::chrono::milliseconds(m_pStreamInfo->segmentDuration * 1000),
+                                                   [this, currSegTimeLine]() {
+                                                     return m_selectedTileTracks.find(currSegTimeLine) != m_selectedTileTracks.end() ||
+                                                            m_status == STATUS_STOPPED;
+                                                   });
+          if (m_status == STATUS_STOPPED)
           {
-            {
-              std::lock_guard<std::mutex> lock(mCurrentMutex);
-              std::map<uint64_t, std::map<int, OmafAdaptationSet*>>::iterator it;
-              it = m_selectedTileTracks.find(currSegTimeLine);
-              if (it != m_selectedTileTracks.end())
-                  break;
-            }
-
-            usleep((m_pStreamInfo->segmentDuration * 1000000) / selectionWaitTimes);
-            currWaitTimes++;
+            OMAF_LOG(LOG_INFO, "Status Stopped !\n");
+            break;
           }
-
+          if (selected)
           {
-            std::lock_guard<std::mutex> lock(mCurrentMutex);
-            if (currWaitTimes < selectionWaitTimes)
-            {
-              updatedSelectedAS = m_selectedTileTracks[currSegTimeLine];
-            }
-            else
-            {
-              if (m_status == STATUS_STOPPED)
-              {
-                OMAF_LOG(LOG_INFO, "Status Stopped !\n");
-                break;
-              }
-              else
-              {
-                updatedSelectedAS = prevSelectedAS;
-                OMAF_LOG(LOG_WARNING, "Tile tracks selection result for current time line hasn't come, Still use previous selected AS !\n");
-              }
-            }
+            updatedSelectedAS = m_selectedTileTracks[currSegTimeLine];
+          }
+          else
+          {
+            updatedSelectedAS = prevSelectedAS;
+            OMAF_LOG(LOG_WARNING, "Tile tracks selection result for current time line hasn't come, Still use previous selected AS !\n");
           }
-          currWaitTimes = 0;
         }
         mapSelectedAS = updatedSelectedAS;
         OMAF_LOG(LOG_INFO, "For frame next to frame %ld, Use updated viewport !\n", currFramePTS);
@@ -1194,6 +1209,17 @@ int32_t OmafMediaStream::TilesStitching() {
     prevSelectedAS = mapSelectedAS;
     bool hasPktOutdated = false;
     std::map<uint32_t, MediaPacket*> selectedPackets;
+    uint32_t packetWaitTimeout = m_pStreamInfo->segmentDuration * 1000 / 2; // ms
+#ifdef _ANDROID_NDK_OPTION_
+    packetWaitTimeout = m_pStreamInfo->segmentDuration * 1000;
+#endif
+    //wake up once packets of all selected tiles for current PTS are parsed
+    std::vector<uint32_t> selectedTrackIDs;
+    for (auto as_it = mapSelectedAS.begin(); as_it != mapSelectedAS.end(); as_it++) {
+      selectedTrackIDs.push_back(as_it->second->GetTrackNumber());
+    }
+    omaf_reader_mgr_->WaitForPackets(selectedTrackIDs, currFramePTS, packetWaitTimeout);
+    std::chrono::steady_clock::time_point wakeTime = std::chrono::steady_clock::now();
     //2. get selectedPackets according to selectedAS
     for (auto as_it = mapSelectedAS.begin(); as_it != mapSelectedAS.end(); as_it++) {
       OmafAdaptationSet* pAS = (OmafAdaptationSet*)(as_it->second);
@@ -1232,17 +1258,15 @@ int32_t OmafMediaStream::TilesStitching() {
 
           if (pts == 0)
           {
-              while((!pts) && (currWaitTimes < waitTimes) && (m_status != STATUS_STOPPED))
+              if (m_status != STATUS_STOPPED)
               {
-                  usleep(((m_pStreamInfo->segmentDuration * 1000000) / 2) / waitTimes);
-                  currWaitTimes++;
+                  std::vector<uint32_t> waitTrackIDs(1, trackID);
+                  if (omaf_reader_mgr_->WaitForPackets(waitTrackIDs, currFramePTS, m_pStreamInfo->segmentDuration * 1000 / 2) == OMAF_ERROR_TIMED_OUT)
+                  {
+                      OMAF_LOG(LOG_INFO, "Wait times has timed out for frame %ld from track %d\n", currFramePTS, trackID);
+                  }
                   pts = omaf_reader_mgr_->GetOldestPacketPTSForTrack(trackID);
               }
-              if (currWaitTimes >= waitTimes)
-              {
-                  OMAF_LOG(LOG_INFO, "Wait times has timed out for frame %ld from track %d\n", currFramePTS, trackID);
-              }
-              currWaitTimes = 0;
               if (pts > currFramePTS)
               {
                   OMAF_LOG(LOG_INFO, "After wait for a moment, outdated PTS %ld from track %d\n", pts, trackID);
@@ -1326,21 +1350,11 @@ int32_t OmafMediaStream::TilesStitching() {
         }
       }
       //2.2 get one packet according to PTS
-      ret = omaf_reader_mgr_->GetNextPacketWithPTS(trackID, currFramePTS, onePacket, m_needParams);
+      ret = omaf_reader_mgr_->WaitNextPacketWithPTS(trackID, currFramePTS, onePacket, m_needParams,
+                                                    m_status != STATUS_STOPPED ? packetWaitTimeout : 0);
 
       OMAF_LOG(LOG_INFO, "Get next packet !\n");
       currWaitTimes = 0;
-
-      while ((ret == ERROR_NULL_PACKET) && (currWaitTimes < waitTimes_GetPacket) && m_status != STATUS_STOPPED) {
-#ifdef _ANDROID_NDK_OPTION_
-        usleep((m_pStreamInfo->segmentDuration * 1000000) / waitTimes_GetPacket);
-#else
-        usleep((m_pStreamInfo->segmentDuration * 1000000 / 2) / waitTimes_GetPacket);
-#endif
-        currWaitTimes++;
-        //OMAF_LOG(LOG_INFO, "To get packet %ld for track %d\n", currFramePTS, trackID);
-        ret = omaf_reader_mgr_->GetNextPacketWithPTS(trackID, currFramePTS, onePacket, m_needParams);
-      }
       //2.2.1 get packet successfully and insert to selectedPackets
       if (ret == ERROR_NONE) {
         if (onePacket->GetEOS()) {
@@ -1400,7 +1414,7 @@ int32_t OmafMediaStream::TilesStitching() {
               OMAF_LOG(LOG_INFO, "Current frame %ld is key frame but has outdated, drop frames till next key frame !\n", currFramePTS);
               currFramePTS += samplesNumPerSeg;
               skipFrames = true;
-              usleep((m_pStreamInfo->segmentDuration * 1000000) / 2);
+              omaf_reader_mgr_->WaitForPackets(selectedTrackIDs, currFramePTS, m_pStreamInfo->segmentDuration * 1000 / 2);
           }
           else
           {
@@ -1415,7 +1429,7 @@ int32_t OmafMediaStream::TilesStitching() {
                   currFramePTS = aveSamplesNumPerSeg * (currSegTimeLine - 1) + samplesNumPerSeg;
               }
               skipFrames = true;
-              usleep((m_pStreamInfo->segmentDuration * 1000000) / 2);
+              omaf_reader_mgr_->WaitForPackets(selectedTrackIDs, currFramePTS, m_pStreamInfo->segmentDuration * 1000 / 2);
           }
       }
 
@@ -1535,6 +1549,11 @@ int32_t OmafMediaStream::TilesStitching() {
       std::lock_guard<std::mutex> lock(m_packetsMutex);
       m_mergedPackets.push_back(mergedPackets);
     }
+    uint64_t latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wakeTime).count();
+    static LatencyHistogram *stitchLatency = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_STITCH_LATENCY);
+    static MetricsCounter *stitchedFrames = MetricsRegistry::GetInstance()->GetCounter(CLIENT_STITCHED_FRAMES);
+    stitchLatency->Record(latencyUs);
+    stitchedFrames->Add(1);
     std::list<MediaPacket*>::iterator it = mergedPackets.begin();
     if (it == mergedPackets.end())
     {
@@ -45,6 +45,7 @@
 #include "OmafReader.h"
 #include "OmafTilesStitch.h"
 #include <mutex>
+#include <condition_variable>
 
 VCD_OMAF_BEGIN
 
@@ -96,6 +97,11 @@ class OmafMediaStream {
   //! \return
   int UpdateStartNumber(uint64_t nAvailableStartTime);
 
+  //! \brief update all AdaptationSets and extractors in place with refreshed mpd
+  //! \param mapAdaptationSets AdaptationSetElements in refreshed mpd, keyed by id
+  //! \return the number of AdaptationSets which are updated
+  int UpdateFromMPD(const std::map<int, AdaptationSetElement*>& mapAdaptationSets);
+
   uint32_t GetStartChunkId() {
     std::lock_guard<std::mutex> lock(mMutex);
     if (!mMediaAdaptationSet.empty()) {
@@ -384,6 +390,8 @@ private:
   std::mutex mMutex;
   //<! for synchronization of mCurrentExtractors and m_selectedTileTracks
   std::mutex mCurrentMutex;
+  //<! cv for tiles selection update, used with mCurrentMutex
+  std::condition_variable m_selectionCond;
   //<! for synchronization of m_catchupTileTracks
   std::mutex mCatchUpMutex;
 
@@ -39,6 +39,7 @@
 #include "iso_structure.h"
 #include "OmafSegment.h"
 #include "360SCVPAPI.h"
+#include <atomic>
 
 VCD_OMAF_BEGIN
 
@@ -350,6 +351,23 @@ public:
     //!
     virtual int32_t getTrackSampleOffset(uint32_t trackId, uint32_t sampleId, uint64_t& sampleOffset, uint32_t& sampleLength) = 0;
 
+    //!
+    //! \brief  Get offset, length, time stamps and sync flag of
+    //!         all samples of specified track in specified
+    //!         segment in one call
+    //!
+    //! \param  [in]  trackId
+    //!         index of specific track
+    //! \param  [in]  segmentId
+    //!         index of specified segment
+    //! \param  [out] samples
+    //!         output samples in decoding order
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t getSegmentSamples(uint32_t trackId, uint32_t segmentId, std::vector<SegmentSample>& samples) = 0;
+
     //!
     //! \brief  Get media codec related specific information,
     //!         like SPS, PPS and so on, for specified sample in
@@ -813,8 +831,8 @@ public:
 
 private:
     std::map<int, int>  mMapInitTrk;           //!< the map of <initSegmentId, trackId>
-    uint32_t mVideoSegSampleSize = 0;          //!< segment sample size for video track
-    uint32_t mAudioSegSampleSize = 0;          //!< segment sample size for audio track
+    std::atomic<uint32_t> mVideoSegSampleSize{0};   //!< segment sample size for video track
+    std::atomic<uint32_t> mAudioSegSampleSize{0};   //!< segment sample size for audio track
 };
 
 VCD_OMAF_END;
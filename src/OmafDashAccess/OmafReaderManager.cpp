@@ -39,6 +39,7 @@
 #include "OmafMediaSource.h"
 #include "OmafReader.h"
 #include "common.h"
+#include "OmafDashMetrics.h"
 
 #include <math.h>
 #include <functional>
@@ -52,7 +53,7 @@
 
 VCD_OMAF_BEGIN
 
-// not support concurrency
+// shared by the parsing tasks, only read once initialized
 class OmafPacketParams : public VCD::NonCopyable {
   friend OmafSegmentNode;
 
@@ -100,12 +101,17 @@ class OmafAudioPacketParams : public VCD::NonCopyable {
   public:
   int init(std::shared_ptr<OmafReader> reader, uint32_t reader_trackId, uint32_t sampleId) noexcept;
 
-  void writeADTSHdr(uint32_t frameSize);
+  //! the header is written to hdr, so that it can be shared by the
+  //! parsing tasks of the track once initialized
+  void writeADTSHdr(uint32_t frameSize, std::vector<uint8_t> &hdr) const;
+
+  //! the size of the ADTS header without CRC
+  static const uint32_t ADTS_HDR_SIZE = 7;
 
   private:
   int  unPackUnsignedIntValue(uint8_t bitsNum, uint32_t *value);
-  void packOneBit(bool value);
-  void packUnsignedIntValue(uint8_t bitsNum, uint32_t value);
+  static void packOneBit(std::vector<uint8_t> &hdr, int32_t &bitPos, bool value);
+  static void packUnsignedIntValue(std::vector<uint8_t> &hdr, int32_t &bitPos, uint8_t bitsNum, uint32_t value);
 
   std::vector<uint8_t> params_;
 
@@ -206,6 +212,10 @@ class OmafSegmentNode : public VCD::NonCopyable {
     }
     return 0;
   }
+  bool hasPacketUpTo(uint64_t pts) {
+    std::lock_guard<std::mutex> lock(packet_mutex_);
+    return media_packets_.size() && media_packets_.back()->GetPTS() >= pts;
+  }
   void clearPacketByPTS(uint64_t pts) {
     std::lock_guard<std::mutex> lock(packet_mutex_);
     while (media_packets_.size()) {
@@ -354,7 +364,11 @@ OMAF_STATUS OmafReaderManager::Initialize(OmafMediaSource *pSource) noexcept {
       return ERROR_INVALID;
     }
     breader_working_ = true;
-    segment_reader_worker_ = std::thread(&OmafReaderManager::threadRunner, this);
+    int32_t worker_num = work_params_.max_parse_workers_ > 0 ? work_params_.max_parse_workers_ : 1;
+    for (int32_t i = 0; i < worker_num; i++) {
+      segment_reader_workers_.emplace_back(&OmafReaderManager::threadRunner, this);
+    }
+    OMAF_LOG(LOG_INFO, "Start %d segment parse workers\n", worker_num);
 
     return ERROR_NONE;
 
@@ -383,12 +397,16 @@ OMAF_STATUS OmafReaderManager::Close() noexcept {
     {
       std::lock_guard<std::mutex> lock(segment_parsed_mutex_);
       segment_parsed_list_.clear();
+      bclosed_ = true;
+      segment_parsed_cv_.notify_all();
     }
 
-    if (segment_reader_worker_.joinable()) {
-      breader_working_ = false;
-      segment_reader_worker_.join();
+    for (auto &worker : segment_reader_workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
     }
+    segment_reader_workers_.clear();
 
     return ERROR_NONE;
   } catch (const std::exception &ex) {
@@ -694,6 +712,88 @@ OMAF_STATUS OmafReaderManager::GetNextPacketWithPTS(uint32_t trackID, uint64_t p
   }
 }
 
+OMAF_STATUS OmafReaderManager::WaitNextPacketWithPTS(uint32_t trackID, uint64_t pts, MediaPacket *&pPacket, bool requireParams, uint32_t timeout_ms) noexcept {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  OMAF_STATUS ret = ERROR_NULL_PACKET;
+  while (true) {
+    // take the parsed count before reading, so a segment parsed in between still wakes us up
+    uint64_t seen_count = parsed_segment_count_;
+    ret = GetNextPacketWithPTS(trackID, pts, pPacket, requireParams);
+    if (ret != ERROR_NULL_PACKET) {
+      return ret;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return ret;
+    }
+    uint32_t remain_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+    if (WaitForParsedSegment(seen_count, remain_ms) != ERROR_NONE) {
+      return ret;
+    }
+  }
+}
+
+bool OmafReaderManager::isPacketReady(uint32_t trackID, uint64_t pts) noexcept {
+  for (auto &nodeset : segment_parsed_list_) {
+    for (auto &node : nodeset.segment_nodes_) {
+      if (node->getTrackId() == trackID && node->hasPacketUpTo(pts)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+OMAF_STATUS OmafReaderManager::WaitForPackets(const std::vector<uint32_t> &trackIDs, uint64_t pts, uint32_t timeout_ms) noexcept {
+  try {
+    std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
+    bool ready = segment_parsed_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() {
+      if (bclosed_) return true;
+      for (auto trackID : trackIDs) {
+        if (!isPacketReady(trackID, pts)) return false;
+      }
+      return true;
+    });
+    if (bclosed_) return ERROR_INVALID;
+    return ready ? ERROR_NONE : OMAF_ERROR_TIMED_OUT;
+  } catch (const std::exception &ex) {
+    OMAF_LOG(LOG_ERROR, "Failed to wait for packets with pts=%lld, ex: %s\n", pts, ex.what());
+    return ERROR_INVALID;
+  }
+}
+
+OMAF_STATUS OmafReaderManager::WaitForParsedSegment(uint64_t seen_count, uint32_t timeout_ms) noexcept {
+  try {
+    std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
+    bool ready = segment_parsed_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                             [&]() { return bclosed_ || parsed_segment_count_ != seen_count; });
+    if (bclosed_) return ERROR_INVALID;
+    return ready ? ERROR_NONE : OMAF_ERROR_TIMED_OUT;
+  } catch (const std::exception &ex) {
+    OMAF_LOG(LOG_ERROR, "Failed to wait for parsed segment, ex: %s\n", ex.what());
+    return ERROR_INVALID;
+  }
+}
+
+void OmafReaderManager::SetStartOffsetPts(int64_t pts) noexcept {
+  std::lock_guard<std::mutex> lock(segment_parsed_mutex_);
+  offset_pts_ = pts;
+  segment_parsed_cv_.notify_all();
+}
+
+OMAF_STATUS OmafReaderManager::WaitForStartOffsetPts(uint32_t timeout_ms) noexcept {
+  try {
+    std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
+    bool ready = segment_parsed_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                             [&]() { return bclosed_ || offset_pts_ >= 0; });
+    if (bclosed_) return ERROR_INVALID;
+    return ready ? ERROR_NONE : OMAF_ERROR_TIMED_OUT;
+  } catch (const std::exception &ex) {
+    OMAF_LOG(LOG_ERROR, "Failed to wait for start offset pts, ex: %s\n", ex.what());
+    return ERROR_INVALID;
+  }
+}
+
 OMAF_STATUS OmafReaderManager::GetNextPacketArray(vector<uint32_t> trackIDs, list<MediaPacket *>* pPackets, bool requireParams) noexcept {
   //1. input check
   uint32_t sample_size = GetSamplesNumPerSegmentForTimeLine(1);
@@ -756,15 +856,13 @@ OMAF_STATUS OmafReaderManager::GetNextPacketArray(vector<uint32_t> trackIDs, lis
   //4. process waiting packet array
   else if (!no_data_tracks.empty()) {
     uint32_t waitdata_timeout = max(GetSegmentDuration() * 1000, uint64_t(3000));
-    uint32_t curr_waittime = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitdata_timeout);
     for (auto id : no_data_tracks) {
       MediaPacket *pkt = nullptr;
-      int res = GetNextPacketWithPTS(trackIDs[id], fetch_pts_, pkt, requireParams);
-      while (res == ERROR_NULL_PACKET && curr_waittime < waitdata_timeout) {
-        usleep(1000);
-        curr_waittime++;
-        res = GetNextPacketWithPTS(trackIDs[id], fetch_pts_, pkt, requireParams);
-      }
+      // the waiting time is shared by all the tracks without data
+      auto now = std::chrono::steady_clock::now();
+      uint32_t remain_ms = now < deadline ? std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() : 0;
+      int res = WaitNextPacketWithPTS(trackIDs[id], fetch_pts_, pkt, requireParams, remain_ms);
       //4.1 wait and obtain the packet, push into output packets queue(first frame in segment always enters)
       if (res == ERROR_NONE) {
         pkt->SetVideoID(id);
@@ -1133,16 +1231,14 @@ void OmafReaderManager::normalChunkStateChange(std::shared_ptr<OmafSegment> segm
       depends_size = d_it->second.size();
     }
     // 1. get chunk stream block in input segment
-    std::unique_ptr<StreamBlock> chunk_block = segment->PopOneStreamBlock();
-    // LOG(INFO) << "State change chunk stream size " << chunk_block->size() << "track is " << segment->GetTrackId() << "segment is " << segment->GetSegID() << endl;
-
-    if (chunk_block == nullptr) {
+    std::vector<std::unique_ptr<StreamBlock>> chunk_blocks;
+    if (!segment->PopOneChunk(chunk_blocks)) {
       OMAF_LOG(LOG_INFO, "Segment %d, track id %d has not chunk yet!\n", segment->GetSegID(), segment->GetTrackId());
       return;
     }
 
     // 2. create a new opened node according to given chunk stream block
-    OmafSegment::Ptr opened_segment = std::make_shared<OmafSegment>(segment, std::move(chunk_block));
+    OmafSegment::Ptr opened_segment = std::make_shared<OmafSegment>(segment, std::move(chunk_blocks));
     OmafDashMode work_mode = work_params_.mode_;
     if (segment->IsCatchup()) work_mode = OmafDashMode::LATER_BINDING;
 
@@ -1308,91 +1404,131 @@ void OmafReaderManager::threadRunner() noexcept {
 
     while (breader_working_) {
       // 1. find the ready segment/dash_node opend list
-      OmafSegmentNode::Ptr ready_dash_node = findReadySegmentNode();
-
-      // 1.1 no ready dash node, then wait
-      if (ready_dash_node.get() == nullptr) {
+      OmafSegmentNode::Ptr ready_dash_node;
+      {
         std::unique_lock<std::mutex> lock(segment_opened_mutex_);
-        segment_opened_cv_.wait(lock);
-        continue;
+        if (!breader_working_) {
+          break;
+        }
+        ready_dash_node = findReadySegmentNode();
+
+        // 1.1 no ready dash node, then wait
+        if (ready_dash_node.get() == nullptr) {
+          segment_opened_cv_.wait(lock);
+          continue;
+        }
+
+        // 1.2 nodes of one timeline point are parsed concurrently,
+        //     the next timeline point waits until they are all done
+        parsing_timeline_point_ = ready_dash_node->getTimelinePoint();
+        parsing_node_count_++;
       }
 
-      // 2. parse the ready segment/dash_node
-      const int64_t timeline_point = ready_dash_node->getTimelinePoint();
-      // if (ready_dash_node->isCatchup()) OMAF_LOG(LOG_INFO, "Catch up node found! timeline is %lld, track id %d\n", timeline_point, ready_dash_node->getTrackId());
-      //OMAF_LOG(LOG_INFO, "Get ready segment! timeline=%lld\n", timeline_point);
+      parseSegmentNode(std::move(ready_dash_node));
+
+      {
+        std::lock_guard<std::mutex> lock(segment_opened_mutex_);
+        parsing_node_count_--;
+        segment_opened_cv_.notify_all();
+      }
+
+      // 4. clear dash set whose timeline point older than current ready segment/dash_node
+      // we use simple logic to main the dash node sets
+      // we will remove older dash nodes
+      //clearOlderSegmentSet(timeline_point_);
+    }
+  } catch (const std::exception &ex) {
+    OMAF_LOG(LOG_ERROR, "Exception in reader runner, ex: %s\n", ex.what());
+  }
+
+  OMAF_LOG(LOG_INFO, "Exit from the reader runner!\n");
+}
+
+void OmafReaderManager::parseSegmentNode(OmafSegmentNode::Ptr ready_dash_node) noexcept {
+  try {
+    // 2. parse the ready segment/dash_node
+    const int64_t timeline_point = ready_dash_node->getTimelinePoint();
+    // if (ready_dash_node->isCatchup()) OMAF_LOG(LOG_INFO, "Catch up node found! timeline is %lld, track id %d\n", timeline_point, ready_dash_node->getTrackId());
+    //OMAF_LOG(LOG_INFO, "Get ready segment! timeline=%lld\n", timeline_point);
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
-      tracepoint(mthq_tp_provider, T4_parse_start_time, timeline_point);
+    tracepoint(mthq_tp_provider, T4_parse_start_time, timeline_point);
 #endif
 #endif
-      OMAF_STATUS ret = ready_dash_node->parse();
-      // if (ready_dash_node->isCatchup()) OMAF_LOG(LOG_INFO, "Catch up node parsed! timeline is %lld, track id %d\n", timeline_point, ready_dash_node->getTrackId());
+    static LatencyHistogram *parseLatency = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_PARSE_LATENCY);
+    static MetricsCounter *parsedSegments = MetricsRegistry::GetInstance()->GetCounter(CLIENT_PARSED_SEGMENTS);
+    static MetricsCounter *parseFailures = MetricsRegistry::GetInstance()->GetCounter(CLIENT_PARSE_FAILURES);
+    std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
+    OMAF_STATUS ret = ready_dash_node->parse();
+    if (ret == ERROR_NONE) {
+      parseLatency->Record(MetricsElapsedUs(parseStart));
+      parsedSegments->Add(1);
+    } else {
+      parseFailures->Add(1);
+    }
+    // if (ready_dash_node->isCatchup()) OMAF_LOG(LOG_INFO, "Catch up node parsed! timeline is %lld, track id %d\n", timeline_point, ready_dash_node->getTrackId());
 
-      if (ready_dash_node->getMediaType() == MediaType_Video)
-      {
-          std::lock_guard<std::mutex> lock(segment_samples_mutex_);
-          std::map<uint64_t, size_t>::iterator it;
-          it = samples_num_per_seg_.find(ready_dash_node->getTimelinePoint());
-          if (it == samples_num_per_seg_.end())
-          {
-              samples_num_per_seg_.insert(std::make_pair(ready_dash_node->getTimelinePoint(), ready_dash_node->GetSamplesNum()));
-          }
-      }
-      //samples_num_per_seg_ = ready_dash_node->GetSamplesNum();
+    if (ready_dash_node->getMediaType() == MediaType_Video)
+    {
+        std::lock_guard<std::mutex> lock(segment_samples_mutex_);
+        std::map<uint64_t, size_t>::iterator it;
+        it = samples_num_per_seg_.find(ready_dash_node->getTimelinePoint());
+        if (it == samples_num_per_seg_.end())
+        {
+            samples_num_per_seg_.insert(std::make_pair(ready_dash_node->getTimelinePoint(), ready_dash_node->GetSamplesNum()));
+        }
+    }
+    //samples_num_per_seg_ = ready_dash_node->GetSamplesNum();
 
-      // 3. move the parsed segment/dash_node to parsed list
-      if (ret == ERROR_NONE) {
-        //OMAF_LOG(LOG_INFO, "Success to parsed dash segment! timeline=%lld\n", timeline_point);
+    // 3. move the parsed segment/dash_node to parsed list
+    if (ret == ERROR_NONE) {
+      //OMAF_LOG(LOG_INFO, "Success to parsed dash segment! timeline=%lld\n", timeline_point);
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
-      tracepoint(mthq_tp_provider, T5_parse_end_time, timeline_point);
+    tracepoint(mthq_tp_provider, T5_parse_end_time, timeline_point);
 #endif
 #endif
-        std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
-        bool new_timeline_point = true;
-        for (auto &nodeset : segment_parsed_list_) {
-          if (nodeset.timeline_point_ == timeline_point) {
-            // if (ready_dash_node->isCatchup())
-            // LOG(INFO) << "Push parsed node PTS " << nodeset.timeline_point_ << " with track id " << ready_dash_node->getTrackId() << "with chunk id " << ready_dash_node->GetChunkId() << " into parsed list" << endl;
-            nodeset.segment_nodes_.push_back(std::move(ready_dash_node));
-            new_timeline_point = false;
-            break;
-          }
-        }
-        if (new_timeline_point) {
-          OmafSegmentNodeTimedSet nodeset;
-          nodeset.timeline_point_ = timeline_point;
-          nodeset.create_time_ = std::chrono::steady_clock::now();
+      std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
+      bool new_timeline_point = true;
+      for (auto &nodeset : segment_parsed_list_) {
+        if (nodeset.timeline_point_ == timeline_point) {
           // if (ready_dash_node->isCatchup())
           // LOG(INFO) << "Push parsed node PTS " << nodeset.timeline_point_ << " with track id " << ready_dash_node->getTrackId() << "with chunk id " << ready_dash_node->GetChunkId() << " into parsed list" << endl;
           nodeset.segment_nodes_.push_back(std::move(ready_dash_node));
-          segment_parsed_list_.emplace_back(nodeset);
+          new_timeline_point = false;
+          break;
         }
-        segment_parsed_cv_.notify_all();
-      } else {
-        OMAF_LOG(LOG_ERROR, "Failed to parse %s\n", ready_dash_node->to_string().c_str());
       }
-
-      // 4. clear dash set whose timeline point older than current ready segment/dash_node
-      // we use simple logic to main the dash node sets
-      // we will remove older dash nodes
-      //clearOlderSegmentSet(timeline_point_);
+      if (new_timeline_point) {
+        OmafSegmentNodeTimedSet nodeset;
+        nodeset.timeline_point_ = timeline_point;
+        nodeset.create_time_ = std::chrono::steady_clock::now();
+        // if (ready_dash_node->isCatchup())
+        // LOG(INFO) << "Push parsed node PTS " << nodeset.timeline_point_ << " with track id " << ready_dash_node->getTrackId() << "with chunk id " << ready_dash_node->GetChunkId() << " into parsed list" << endl;
+        nodeset.segment_nodes_.push_back(std::move(ready_dash_node));
+        segment_parsed_list_.emplace_back(nodeset);
+      }
+      parsed_segment_count_++;
+      segment_parsed_cv_.notify_all();
+    } else {
+      OMAF_LOG(LOG_ERROR, "Failed to parse %s\n", ready_dash_node->to_string().c_str());
     }
   } catch (const std::exception &ex) {
-    OMAF_LOG(LOG_ERROR, "Exception in reader runner, ex: %s\n", ex.what());
+    OMAF_LOG(LOG_ERROR, "Exception when parse the dash node, ex: %s\n", ex.what());
   }
-
-  OMAF_LOG(LOG_INFO, "Exit from the reader runner!\n");
 }
 
 OmafSegmentNode::Ptr OmafReaderManager::findReadySegmentNode() noexcept {
   try {
     OmafSegmentNode::Ptr ready_dash_node;
-    std::unique_lock<std::mutex> lock(segment_opened_mutex_);
     for (auto &nodeset : segment_opened_list_) {
       //OMAF_LOG(LOG_INFO, "To find the ready node set timeline=%lld\n", nodeset.timeline_point_);
 
+      // 1.0 keep the timeline order, other timeline points wait for the one in parsing
+      if (parsing_node_count_ > 0 && nodeset.timeline_point_ != parsing_timeline_point_) {
+        break;
+      }
+
       // 1.1.1 try to find the ready node
       std::list<OmafSegmentNode::Ptr>::iterator it = nodeset.segment_nodes_.begin();
       while (it != nodeset.segment_nodes_.end()) {
@@ -1621,47 +1757,48 @@ int OmafAudioPacketParams::init(std::shared_ptr<OmafReader> reader, uint32_t rea
   }
 }
 
-void OmafAudioPacketParams::packOneBit(bool value)
+void OmafAudioPacketParams::packOneBit(std::vector<uint8_t> &hdr, int32_t &bitPos, bool value)
 {
-  --curr_bit_pos_;
-  if (curr_bit_pos_ == -1)
+  --bitPos;
+  if (bitPos == -1)
   {
-    curr_bit_pos_ = 7;
-    params_.push_back(0);
+    bitPos = 7;
+    hdr.push_back(0);
   }
-  params_[params_.size() - 1] |= (uint8_t(value) << curr_bit_pos_);
+  hdr[hdr.size() - 1] |= (uint8_t(value) << bitPos);
 }
 
-void OmafAudioPacketParams::packUnsignedIntValue(uint8_t bitsNum, uint32_t value)
+void OmafAudioPacketParams::packUnsignedIntValue(std::vector<uint8_t> &hdr, int32_t &bitPos, uint8_t bitsNum, uint32_t value)
 {
   for (int32_t num = (bitsNum - 1); num >= 0; --num)
   {
-    packOneBit(((value >> num) & 1));
+    packOneBit(hdr, bitPos, ((value >> num) & 1));
   }
 }
 
-void OmafAudioPacketParams::writeADTSHdr(uint32_t frameSize)
+void OmafAudioPacketParams::writeADTSHdr(uint32_t frameSize, std::vector<uint8_t> &hdr) const
 {
-  params_.clear();
-  curr_bit_pos_ = 0;
-
-  packUnsignedIntValue(12, 0xfff);
-  packUnsignedIntValue(1, 0);
-  packUnsignedIntValue(2, 0);
-  packUnsignedIntValue(1, 1);
-  packUnsignedIntValue(2, objType_);
-  packUnsignedIntValue(4, frequencyIdx_);
-  packUnsignedIntValue(1, 0);
-  packUnsignedIntValue(3, channelCfg_);
-  packUnsignedIntValue(1, 0);
-  packUnsignedIntValue(1, 0);
-
-  packUnsignedIntValue(1, 0);
-  packUnsignedIntValue(1, 0);
-  packUnsignedIntValue(13, (frameSize + 7)); //ADTS Header size is 7 bytes
-  packUnsignedIntValue(11, 0x7ff);
-  packUnsignedIntValue(2, 0);
-  OMAF_LOG(LOG_INFO, "ADTS header size %ld bytes\n", params_.size());
+  hdr.clear();
+  hdr.reserve(ADTS_HDR_SIZE);
+  int32_t bitPos = 0;
+
+  packUnsignedIntValue(hdr, bitPos, 12, 0xfff);
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+  packUnsignedIntValue(hdr, bitPos, 2, 0);
+  packUnsignedIntValue(hdr, bitPos, 1, 1);
+  packUnsignedIntValue(hdr, bitPos, 2, objType_);
+  packUnsignedIntValue(hdr, bitPos, 4, frequencyIdx_);
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+  packUnsignedIntValue(hdr, bitPos, 3, channelCfg_);
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+  packUnsignedIntValue(hdr, bitPos, 1, 0);
+  packUnsignedIntValue(hdr, bitPos, 13, (frameSize + ADTS_HDR_SIZE)); //ADTS Header size is 7 bytes
+  packUnsignedIntValue(hdr, bitPos, 11, 0x7ff);
+  packUnsignedIntValue(hdr, bitPos, 2, 0);
+  OMAF_LOG(LOG_INFO, "ADTS header size %ld bytes\n", hdr.size());
 }
 
 int OmafSegmentNode::parse() noexcept {
@@ -1960,10 +2097,10 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
       for (size_t sample = sample_begin; sample < sample_end; sample++) {
         uint32_t reader_track_id = buildReaderTrackId(segment_->GetTrackId(), segment_->GetInitSegID());
 
-        if (packet_params.get() == nullptr) {
+        // params are shared by the parsing tasks of the same quality ranking,
+        // so they are initialized privately and never changed once published
+        if (packet_params.get() == nullptr || !packet_params->binit_) {
           packet_params = std::make_shared<OmafPacketParams>();
-        }
-        if (!packet_params->binit_) {
           ret = packet_params->init(reader, reader_track_id, sample);
           if (ret != ERROR_NONE) {
             OMAF_LOG(LOG_ERROR, "Failed to read the packet params include width/height/vps/sps/pps!\n");
@@ -1987,8 +2124,10 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
           return ERROR_INVALID;
         }
         uint32_t packet_size = ((packet_params->width_ * packet_params->height_ * 3) >> 1) >> 1;
-        // FIXME, we need refine the packet buffer. we may include the vps/pps/sps here
-        packet->ReAllocatePacket(packet_size);
+        // reserve the headroom for vps/sps/pps, extractor track packets go out
+        // to the user directly, so no headroom to avoid moving them at the end
+        size_t headroom = (mode_ == OmafDashMode::EXTRACTOR) ? 0 : packet_params->params_.size();
+        packet->AllocatePayload(packet_size, headroom);
 
         if (mode_ == OmafDashMode::EXTRACTOR) {
           ret = reader->getExtractorTrackSampleData(reader_track_id, sample, static_cast<char *>(packet->Payload()),
@@ -2133,10 +2272,8 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
       for (size_t sample = sample_begin; sample < sample_end; sample++) {
         uint32_t reader_track_id = buildReaderTrackId(segment_->GetTrackId(), segment_->GetInitSegID());
 
-        if (packet_params.get() == nullptr) {
+        if (packet_params.get() == nullptr || !packet_params->binit_) {
           packet_params = std::make_shared<OmafAudioPacketParams>();
-        }
-        if (!packet_params->binit_) {
           ret = packet_params->init(reader, reader_track_id, sample);
           if (ret != ERROR_NONE) {
             OMAF_LOG(LOG_ERROR, "Failed to read the packet params for audio track!\n");
@@ -2155,7 +2292,9 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
         uint32_t chlNum = segment_->GetAudioChlNum();
         uint32_t packet_size = 1024 * chlNum;
 
-        packet->ReAllocatePacket(packet_size);
+        // the ADTS header is always inserted for audio, reserve it as headroom,
+        // the header is written once the real frame size is read
+        packet->AllocatePayload(packet_size, OmafAudioPacketParams::ADTS_HDR_SIZE);
 
         ret = reader->getTrackSampleData(reader_track_id, sample, static_cast<char *>(packet->Payload()), packet_size);
 
@@ -2178,8 +2317,9 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
 
         packet->SetRealSize(packet_size);
 
-        packet_params->writeADTSHdr(packet_size);
-        packet->SetADTSHdr(packet_params->params_);
+        std::vector<uint8_t> adts_hdr;
+        packet_params->writeADTSHdr(packet_size, adts_hdr);
+        packet->SetADTSHdr(std::move(adts_hdr));
 
         packet->SetSegID(track_info->sampleProperties[sample].segmentId);
 
@@ -49,6 +49,7 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 VCD_OMAF_BEGIN
 
@@ -76,6 +77,7 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
     size_t duration_ = 0;
     int32_t segment_timeout_ms_ = 3000;  // ms
     ProjectionFormat proj_fmt_  = ProjectionFormat::PF_ERP;
+    int32_t max_parse_workers_ = DEFAULT_MAX_PARSE_WORKERS;  // segment parse threads
   };
 
   using OmafReaderParams = struct _params;
@@ -114,6 +116,22 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
   //! \brief Get Next packet with assigned track index and PTS from packet queue.
   OMAF_STATUS GetNextPacketWithPTS(uint32_t trackID, uint64_t pts, MediaPacket *&pPacket, bool requireParams) noexcept;
 
+  //! \brief Get Next packet with assigned track index and PTS, wait for it at most timeout_ms.
+  //!        The waiting is woken up by newly parsed segments instead of polling.
+  OMAF_STATUS WaitNextPacketWithPTS(uint32_t trackID, uint64_t pts, MediaPacket *&pPacket, bool requireParams, uint32_t timeout_ms) noexcept;
+
+  //! \brief Wait until each of the tracks has the packet with the PTS parsed, or has
+  //!        parsed packets beyond the PTS which means the PTS is outdated for it.
+  //! \return ERROR_NONE if all tracks are ready, OMAF_ERROR_TIMED_OUT if timed out,
+  //!         ERROR_INVALID if the reader manager is closed
+  OMAF_STATUS WaitForPackets(const std::vector<uint32_t> &trackIDs, uint64_t pts, uint32_t timeout_ms) noexcept;
+
+  //! \brief Wait until the parsed segment count goes beyond seen_count
+  OMAF_STATUS WaitForParsedSegment(uint64_t seen_count, uint32_t timeout_ms) noexcept;
+
+  //! \brief Wait until the start offset pts is set
+  OMAF_STATUS WaitForStartOffsetPts(uint32_t timeout_ms) noexcept;
+
   //! \brief Get multi view packets with the same pts [synchronization]
   OMAF_STATUS GetNextPacketArray(vector<uint32_t> trackIDs, list<MediaPacket *>* pPackets, bool requireParams) noexcept;
 
@@ -129,7 +147,7 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
   int64_t GetStartOffsetPts() { return offset_pts_; };
 
-  void SetStartOffsetPts(int64_t pts) { offset_pts_ = pts; };
+  void SetStartOffsetPts(int64_t pts) noexcept;
 
   DashStreamType GetStreamType() { return work_params_.stream_type_; };
 
@@ -154,6 +172,10 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
   OmafReaderParams GetWorkParams() { return work_params_; };
 
+  //!  \brief get the number of segment nodes parsed since initialized
+  //!
+  uint64_t GetParsedSegmentCount() { return parsed_segment_count_.load(); };
+
   DashStreamInfo* GetVideoStreamInfo() {
     for (int i = 0; i < media_source_->GetStreamCount(); i++) {
       OmafMediaStream *pStream = media_source_->GetStream(i);
@@ -179,10 +201,16 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
  private:
   void threadRunner() noexcept;
+  void parseSegmentNode(std::shared_ptr<OmafSegmentNode> ready_dash_node) noexcept;
+  //!  \brief find the next segment node to parse, caller must hold segment_opened_mutex_
+  //!
   std::shared_ptr<OmafSegmentNode> findReadySegmentNode() noexcept;
   void clearOlderSegmentSet(int64_t timeline_point) noexcept;
   bool checkEOS(int64_t segment_num) noexcept;
   bool isEmpty(std::mutex &mutex, const std::list<OmafSegmentNodeTimedSet> &nodes) noexcept;
+  //!  \brief check whether the track has parsed packets up to pts, caller must hold segment_parsed_mutex_
+  //!
+  bool isPacketReady(uint32_t trackID, uint64_t pts) noexcept;
 
  private:
   inline int initSegParsedCount(void) noexcept { return initSeg_ready_count_.load(); }
@@ -196,23 +224,29 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
   void AddOpenedNode(std::shared_ptr<OmafSegment>, std::shared_ptr<OmafSegmentNode> opened_dash_node) noexcept;
 
   std::shared_ptr<OmafPacketParams> getPacketParams(uint32_t qualityRanking) noexcept {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     return omaf_packet_params_[qualityRanking];
   }
   void setPacketParams(uint32_t qualityRanking, std::shared_ptr<OmafPacketParams> params) {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     omaf_packet_params_[qualityRanking] = std::move(params);
   }
 
   std::shared_ptr<OmafPacketParams> getPacketParamsForExtractors(uint32_t extractorTrackIdx) noexcept {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     return packet_params_for_extractors_[extractorTrackIdx];
   }
   void setPacketParamsForExtractors(uint32_t extractorTrackIdx, std::shared_ptr<OmafPacketParams> params) {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     packet_params_for_extractors_[extractorTrackIdx] = std::move(params);
   }
 
   std::shared_ptr<OmafAudioPacketParams> getPacketParamsForAudio(uint32_t audioTrackIdx) noexcept {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     return packet_params_for_audio_[audioTrackIdx];
   }
   void setPacketParamsForAudio(uint32_t audioTrackIdx, std::shared_ptr<OmafAudioPacketParams> params) {
+    std::lock_guard<std::mutex> lock(packet_params_mutex_);
     packet_params_for_audio_[audioTrackIdx] = std::move(params);
   }
 
@@ -222,8 +256,12 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
   OmafReaderParams work_params_;
   int64_t timeline_point_ = -1;
   // omaf reader
-  std::thread segment_reader_worker_;
-  bool breader_working_ = false;
+  std::vector<std::thread> segment_reader_workers_;
+  std::atomic_bool breader_working_{false};
+  //<! timeline point in parsing and its node count, guarded by segment_opened_mutex_
+  int64_t parsing_timeline_point_ = -1;
+  size_t parsing_node_count_ = 0;
+  std::atomic<uint64_t> parsed_segment_count_{0};
 
   std::mutex segment_samples_mutex_;
   std::map<uint64_t, size_t> samples_num_per_seg_;
@@ -238,8 +276,11 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
   std::mutex segment_parsed_mutex_;
   std::condition_variable segment_parsed_cv_;
   std::list<OmafSegmentNodeTimedSet> segment_parsed_list_;
+  //<! set when closed to release the threads waiting on segment_parsed_cv_
+  std::atomic_bool bclosed_{false};
 
   OmafMediaSource *media_source_ = nullptr;
+  std::mutex packet_params_mutex_;
   std::map<uint32_t, std::shared_ptr<OmafPacketParams>> omaf_packet_params_;
 
   std::map<uint32_t, std::shared_ptr<OmafPacketParams>> packet_params_for_extractors_;
@@ -260,7 +301,7 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
   std::string sBrand_;
 
-  int64_t offset_pts_ = -1;
+  std::atomic<int64_t> offset_pts_{-1};
   uint32_t timeout_for_checkEOS_ = 500;
   uint64_t fetch_pts_ = 0;
   vector<pair<uint32_t, uint32_t>> inactive_tracks_; // first: segment id, second: track id
@@ -55,11 +55,13 @@ OmafSegment::OmafSegment(DashSegmentSourceParams ds_params, int segCnt, bool bIn
   mSampleRate = 0;
 }
 
-OmafSegment::OmafSegment(std::shared_ptr<OmafSegment> seg, std::unique_ptr<StreamBlock> sb) {
+OmafSegment::OmafSegment(std::shared_ptr<OmafSegment> seg, std::vector<std::unique_ptr<StreamBlock>> chunk) {
   dash_client_ = seg->dash_client_;
   state_ = State::OPEN_SUCCES;
   ds_params_ = seg->ds_params_;
-  dash_stream_.push_back(std::move(sb));
+  for (auto& sb : chunk) {
+    dash_stream_.push_back(std::move(sb));
+  }
   buse_stored_file_ = seg->buse_stored_file_;
   cache_file_ = seg->cache_file_;
   seg_id_ = seg->seg_id_;
@@ -80,7 +82,9 @@ OmafSegment::OmafSegment(std::shared_ptr<OmafSegment> seg, std::unique_ptr<Strea
 }
 
 OmafSegment::~OmafSegment() {
-  if (buse_stored_file_ && !cache_file_.empty()) {
+  if (bcached_file_) {
+    DOWNLOADMANAGER::GetInstance()->ReleaseCacheFile(ds_params_.dash_url_);
+  } else if (buse_stored_file_ && !cache_file_.empty()) {
     DOWNLOADMANAGER::GetInstance()->DeleteCacheFile(cache_file_);
   }
   dash_stream_.clear();
@@ -106,6 +110,11 @@ int OmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexce
         [this](OmafDashSegmentClient::State s) {
           switch (s) {
             case OmafDashSegmentClient::State::SUCCESS:
+              if (!this->bInit_segment_ && DOWNLOADMANAGER::GetInstance()->UseCache()) {
+                // the segment is kept alive until its data is written to cache
+                std::shared_ptr<OmafSegment> self = this->shared_from_this();
+                DOWNLOADMANAGER::GetInstance()->PostCacheTask([self]() { self->CacheToFile(); });
+              }
               this->state_ = State::OPEN_SUCCES;
               break;
             case OmafDashSegmentClient::State::STOPPED:
@@ -181,23 +190,38 @@ int OmafSegment::Close() {
   return ERROR_NONE;
 }
 #endif
+void OmafSegment::openStoredFile() noexcept {
+  if (mMappedFile.IsOpen() || mFileStream.is_open()) {
+    return;
+  }
+  if (!mMappedFile.Open(cache_file_)) {
+    mFileStream.open(cache_file_.c_str(), ios_base::binary | ios_base::in);
+  }
+}
+
 int OmafSegment::CacheToFile() noexcept {
+  std::string cacheFile;
   try {
+    DownloadManager *pDM = DOWNLOADMANAGER::GetInstance();
+    if (pDM->IsCached(ds_params_.dash_url_)) {
+      return ERROR_NONE;
+    }
+
     std::string fileName =
         ds_params_.dash_url_.substr(ds_params_.dash_url_.find_last_of('/') + 1,
                                     ds_params_.dash_url_.length() - ds_params_.dash_url_.find_last_of('/') - 1);
-    cache_file_ = DOWNLOADMANAGER::GetInstance()->GetCacheFolder() + "/" +
-                  DOWNLOADMANAGER::GetInstance()->AssignCacheFileName() + fileName;
-    if (!dash_stream_.cacheToFile(cache_file_)) {
-      OMAF_LOG(LOG_ERROR, "Failed to cache the dash to file: %s\n", cache_file_.c_str());
+    cacheFile = pDM->GetCacheFolder() + "/" + pDM->AssignCacheFileName() + fileName;
+    if (!dash_stream_.cacheToFile(cacheFile)) {
+      OMAF_LOG(LOG_ERROR, "Failed to cache the dash to file: %s\n", cacheFile.c_str());
+      remove(cacheFile.c_str());
       return OMAF_ERROR_FILE_WRITE;
     }
 
-    OMAF_LOG(LOG_INFO, "Success to cache dash to file: %s. url=%s\n", cache_file_.c_str(), ds_params_.dash_url_.c_str());
+    OMAF_LOG(LOG_INFO, "Success to cache dash to file: %s. url=%s\n", cacheFile.c_str(), ds_params_.dash_url_.c_str());
     OMAF_LOG(LOG_INFO, "And file size=%ld\n", dash_stream_.GetStreamSize());
-    return ERROR_NONE;
+    return pDM->InsertCache(ds_params_.dash_url_, cacheFile, dash_stream_.GetStreamSize());
   } catch (const std::exception& ex) {
-    OMAF_LOG(LOG_ERROR, "Exception when cache dash to file: %s\n", cache_file_.c_str());
+    OMAF_LOG(LOG_ERROR, "Exception when cache dash to file: %s\n", cacheFile.c_str());
     return ERROR_INVALID;
   }
 }
@@ -39,6 +39,7 @@
 #include "OmafDashParser/Common.h"
 #include "OmafDashDownload/Stream.h"
 #include "OmafDashDownload/OmafDownloader.h"
+#include "OmafMappedFile.h"
 #include "../isolib/dash_parser/Mp4StreamIO.h"
 #include "general.h"
 #include "iso_structure.h"
@@ -46,6 +47,7 @@
 #include <memory>
 #include <atomic>
 #include <fstream>
+#include <vector>
 
 VCD_OMAF_BEGIN
 
@@ -83,7 +85,11 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
   //
   OmafSegment(DashSegmentSourceParams ds_params, int segCnt, bool bInitSegment = false);
 
-  OmafSegment(std::shared_ptr<OmafSegment> seg, std::unique_ptr<StreamBlock> sb);
+  //
+  // @brief constructor of one chunk of the segment, made of the blocks
+  //        holding the chunk data
+  //
+  OmafSegment(std::shared_ptr<OmafSegment> seg, std::vector<std::unique_ptr<StreamBlock>> chunk);
 
   //!
   //! \brief  de-construct
@@ -95,8 +101,9 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
     if (!buse_stored_file_) {
       return dash_stream_.ReadStream(buffer, size);
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
+      openStoredFile();
+      if (mMappedFile.IsOpen()) {
+        return mMappedFile.ReadStream(buffer, size);
       }
       mFileStream.read(buffer, size);
       std::streamsize readCnt = mFileStream.gcount();
@@ -108,8 +115,9 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
     if (!buse_stored_file_) {
       return dash_stream_.SeekAbsoluteOffset(offset);
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
+      openStoredFile();
+      if (mMappedFile.IsOpen()) {
+        return mMappedFile.SeekAbsoluteOffset(offset);
       }
       if (mFileStream.tellg() == -1) {
         mFileStream.clear();
@@ -125,8 +133,9 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
     if (!buse_stored_file_) {
       return dash_stream_.TellOffset();
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
+      openStoredFile();
+      if (mMappedFile.IsOpen()) {
+        return mMappedFile.TellOffset();
       }
       return mFileStream.tellg();
     }
@@ -136,8 +145,9 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
     if (!buse_stored_file_) {
       return dash_stream_.GetStreamSize();
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
+      openStoredFile();
+      if (mMappedFile.IsOpen()) {
+        return mMappedFile.GetStreamSize();
       }
       mFileStream.seekg(0, ios_base::end);
       int64_t size = mFileStream.tellg();
@@ -146,6 +156,15 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
     }
   };
 
+  const char* GetDataView(offset_t offset, offset_t size) override {
+    if (!buse_stored_file_) {
+      return dash_stream_.GetDataView(offset, size);
+    } else {
+      openStoredFile();
+      return mMappedFile.GetDataView(offset, size);
+    }
+  };
+
  public:
   //
   // @brief register state change callback
@@ -212,7 +231,15 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
   // @brief calling success or not
   virtual int Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexcept;
 
-  virtual std::unique_ptr<StreamBlock> PopOneStreamBlock() noexcept { return nullptr; };
+  //
+  // @brief pop the blocks of the first ready chunk
+  //
+  // @param[out] chunk
+  // @brief the blocks holding the chunk data
+  //
+  // @return bool
+  // @brief whether there is a ready chunk
+  virtual bool PopOneChunk(std::vector<std::unique_ptr<StreamBlock>>& chunk) noexcept { return false; };
 
   int Stop() noexcept;
   // int Read(uint8_t* data, size_t len);
@@ -230,6 +257,15 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
   void SetViewId(pair<int32_t, int32_t> id) noexcept { view_id_ = id; };
   pair<int32_t, int32_t> GetViewId() const noexcept { return view_id_; };
   void SetSegStored() noexcept { buse_stored_file_ = true; };
+  //!
+  //!  \brief read the segment from the file got from the download cache,
+  //!         the file is released back to the cache instead of deleted.
+  //!
+  void SetSegCached(std::string cacheFileName) noexcept {
+    cache_file_ = cacheFileName;
+    buse_stored_file_ = true;
+    bcached_file_ = true;
+  };
   int GetSegCount() const noexcept { return seg_count_; };
   void SetSegSize(uint64_t segSize) noexcept { seg_size_ = segSize; };
   uint64_t GetSegSize() const noexcept { return seg_size_; };
@@ -276,10 +312,17 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
 
  private:
   //!
-  //!  \brief save the memory data to file.
+  //!  \brief save the memory data to file, and add it to the download
+  //!         cache keyed by the segment url. It runs on the cache writer
+  //!         thread of DownloadManager.
   //!
   int CacheToFile() noexcept;
 
+  //!
+  //!  \brief open the stored segment file, map it if possible.
+  //!
+  void openStoredFile() noexcept;
+
  protected:
   std::shared_ptr<OmafDashSegmentClient> dash_client_;
   State state_ = State::CREATE;
@@ -298,6 +341,8 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
   //<! flag to indicate whether the segment should be stored
   // in disk
   bool buse_stored_file_ = false;
+  //<! flag to indicate whether the stored file is owned by the download cache
+  bool bcached_file_ = false;
   //<! the file name for downloaded segment file
   std::string cache_file_;
 
@@ -318,6 +363,9 @@ class OmafSegment : public VCD::MP4::StreamIO, public enable_shared_from_this<Om
   QualityRank mQualityRanking;  //<! quality ranking of the segment
   SRDInfo mSRDInfo;             //<! top/left/width/height info for the tile track segment
 
+  //<! the stored segment file is mapped, and read by mFileStream only
+  // if it can't be mapped
+  OmafMappedFile mMappedFile;
   std::ifstream mFileStream;
 
   MediaType mMediaType;
@@ -29,9 +29,88 @@
 #include "OmafTilesStitch.h"
 #include "math.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "common.h"
+#include "OmafDashMetrics.h"
 VCD_OMAF_BEGIN
 
+// slice headers patched without 360SCVP are handled as RBSP, so only those
+// without emulation prevention bytes are patched
+static uint32_t ReadBits(const uint8_t *data, uint32_t pos, uint32_t bitsNum) {
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < bitsNum; i++, pos++) {
+    value = (value << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1);
+  }
+  return value;
+}
+
+static void WriteBits(uint8_t *data, uint32_t pos, uint32_t bitsNum, uint32_t value) {
+  for (uint32_t i = 0; i < bitsNum; i++, pos++) {
+    uint8_t mask = 1 << (7 - (pos & 7));
+    if ((value >> (bitsNum - 1 - i)) & 1) {
+      data[pos >> 3] |= mask;
+    } else {
+      data[pos >> 3] &= ~mask;
+    }
+  }
+}
+
+static uint32_t CeilLog2(uint32_t value) {
+  uint32_t bits = 0;
+  while (value > ((uint32_t)1 << bits)) bits++;
+  return bits;
+}
+
+static bool HasEmulationBytes(const uint8_t *data, uint32_t size) {
+  for (uint32_t i = 2; i < size; i++) {
+    if ((data[i] == 3) && !data[i - 1] && !data[i - 2]) return true;
+  }
+  return false;
+}
+
+// copy RBSP data and insert emulation prevention bytes as 360SCVP writes them
+static uint32_t CopyWithEmulationBytes(const uint8_t *src, uint32_t size, uint8_t *dst) {
+  uint32_t zeroCount = 0;
+  uint32_t len = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    if (zeroCount == 2 && src[i] < 4) {
+      dst[len++] = 3;
+      zeroCount = 0;
+    }
+    zeroCount = src[i] ? 0 : zeroCount + 1;
+    dst[len++] = src[i];
+  }
+  return len;
+}
+
+// parse slice nalu from nalu header to the end of slice segment address,
+// dependent slice segments are not supported, the same as 360SCVP
+static bool ParseSliceAddrEnd(const uint8_t *nalu, uint32_t size, uint32_t addrBits, uint32_t *ppsId,
+                              uint32_t *addrEnd) {
+  uint32_t sizeInBits = size * 8;
+  uint32_t pos = HEVC_NALUHEADER_LEN * 8;
+  if (sizeInBits <= pos + 2) return false;
+  uint8_t naluType = (nalu[0] >> 1) & 0x3f;
+  bool firstSliceInPic = ReadBits(nalu, pos++, 1);
+  // no_output_of_prior_pics_flag of IRAP slices
+  if (naluType >= 16 && naluType <= 23) pos++;
+  uint32_t leadingZeros = 0;
+  while (pos < sizeInBits && !ReadBits(nalu, pos, 1)) {
+    leadingZeros++;
+    pos++;
+  }
+  if (leadingZeros > 31 || pos + 1 + leadingZeros > sizeInBits) return false;
+  pos++;
+  *ppsId = (((uint32_t)1 << leadingZeros) - 1) + ReadBits(nalu, pos, leadingZeros);
+  pos += leadingZeros;
+  if (!firstSliceInPic) pos += addrBits;
+  if (pos > sizeInBits) return false;
+  *addrEnd = pos;
+  return true;
+}
+
 OmafTilesStitch::OmafTilesStitch() {
   m_360scvpParam = nullptr;
   m_360scvpHandle = nullptr;
@@ -51,6 +130,7 @@ OmafTilesStitch::OmafTilesStitch() {
   m_tmpRegionrwpk = nullptr;
   m_maxStitchWidth = 0;
   m_maxStitchHeight = 0;
+  m_paramsLoadedQuality = INVALID_QUALITY_RANKING;
 }
 
 OmafTilesStitch::~OmafTilesStitch() {
@@ -133,23 +213,7 @@ OmafTilesStitch::~OmafTilesStitch() {
     m_fullResVideoHeader = nullptr;
   }
 
-  if (m_mergedVideoHeaders.size()) {
-    std::map<QualityRank, vector<std::map<uint32_t, uint8_t *>>>::iterator itHrd;
-    for (itHrd = m_mergedVideoHeaders.begin(); itHrd != m_mergedVideoHeaders.end();) {
-      vector<std::map<uint32_t, uint8_t *>> oneHeader = itHrd->second;
-      for (uint32_t i = 0; i < oneHeader.size(); i++) {
-        std::map<uint32_t, uint8_t *>::iterator itParam;
-        for (itParam = oneHeader[i].begin(); itParam != oneHeader[i].end();) {
-          uint8_t *headers = itParam->second;
-          DELETE_ARRAY(headers);
-          oneHeader[i].erase(itParam++);
-        }
-        oneHeader[i].clear();
-      }
-      m_mergedVideoHeaders.erase(itHrd++);
-    }
-    m_mergedVideoHeaders.clear();
-  }
+  m_mergePlans.clear();
   m_tmpRegionrwpk = nullptr;
   m_sources.clear();
 }
@@ -275,65 +339,25 @@ int32_t OmafTilesStitch::ParseVideoHeader(MediaPacket *tilePacket) {
     return OMAF_ERROR_NULL_PTR;
   }
 
-  Nalu *oneNalu = new Nalu;
-  if (!oneNalu) return OMAF_ERROR_NULL_PTR;
+  // locate VPS, SPS and PPS in one pass, then parse each of them with its exact size
+  Nalu headerNalus[3];
+  memset(headerNalus, 0, sizeof(headerNalus));
+  uint32_t nalusNum = 0;
+  int32_t ret = I360SCVP_ScanNALUs(m_fullResVideoHeader, fullResHeaderSize, E_NALU_CODEC_HEVC, headerNalus, 3, &nalusNum);
+  if (ret || nalusNum != 3) return OMAF_ERROR_NALU_NOT_FOUND;
 
-  oneNalu->data = m_fullResVideoHeader;
-  oneNalu->dataSize = fullResHeaderSize;
-  int32_t ret = I360SCVP_ParseNAL(oneNalu, m_360scvpHandle);
-  if (ret) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_NALU_NOT_FOUND;
-  }
-
-  if (oneNalu->data != m_fullResVideoHeader) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
-  }
+  uint32_t headerSizes[3] = {m_fullResVPSSize, m_fullResSPSSize, m_fullResPPSSize};
+  uint8_t *headerData = m_fullResVideoHeader;
+  for (uint32_t i = 0; i < 3; i++) {
+    if (headerNalus[i].data != headerData) return OMAF_ERROR_INVALID_HEADER;
+    if ((uint32_t)(headerNalus[i].dataSize) != headerSizes[i]) return OMAF_ERROR_INVALID_HEADER;
 
-  if ((uint32_t)(oneNalu->dataSize) != m_fullResVPSSize) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
-  }
-
-  oneNalu->data += m_fullResVPSSize;
-  oneNalu->dataSize = fullResHeaderSize - m_fullResVPSSize;
-  ret = I360SCVP_ParseNAL(oneNalu, m_360scvpHandle);
-  if (ret) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_NALU_NOT_FOUND;
-  }
-
-  if (oneNalu->data != (m_fullResVideoHeader + m_fullResVPSSize)) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
-  }
+    ret = I360SCVP_ParseNAL(&headerNalus[i], m_360scvpHandle);
+    if (ret) return OMAF_ERROR_NALU_NOT_FOUND;
 
-  if ((uint32_t)(oneNalu->dataSize) != m_fullResSPSSize) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
+    headerData += headerSizes[i];
   }
 
-  oneNalu->data += m_fullResSPSSize;
-  oneNalu->dataSize = fullResHeaderSize - m_fullResVPSSize - m_fullResSPSSize;
-  ret = I360SCVP_ParseNAL(oneNalu, m_360scvpHandle);
-  if (ret) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_NALU_NOT_FOUND;
-  }
-
-  if (oneNalu->data != (m_fullResVideoHeader + m_fullResVPSSize + m_fullResSPSSize)) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
-  }
-
-  if ((uint32_t)(oneNalu->dataSize) != m_fullResPPSSize) {
-    SAFE_DELETE(oneNalu);
-    return OMAF_ERROR_INVALID_HEADER;
-  }
-
-  SAFE_DELETE(oneNalu);
-
   Param_PicInfo *picInfo = new Param_PicInfo;
   if (!picInfo) return OMAF_ERROR_NULL_PTR;
 
@@ -1223,7 +1247,7 @@ int32_t OmafTilesStitch::GenerateTilesMergeArrangement() {
   return ERROR_NONE;
 }
 
-int32_t OmafTilesStitch::IsArrChanged(QualityRank qualityRanking, vector<TilesMergeArrangement *> layOut, vector<TilesMergeArrangement *> initLayOut, bool *isArrChanged, bool *packetLost, bool *arrangeChanged)
+int32_t OmafTilesStitch::IsArrChanged(QualityRank qualityRanking, const vector<TilesMergeArrangement *> &layOut, const vector<TilesMergeArrangement *> &initLayOut, bool *isArrChanged, bool *packetLost, bool *arrangeChanged)
 {
     if (layOut.empty()) {
         OMAF_LOG(LOG_ERROR, " Invalid tile merge arrangement data!\n");
@@ -1275,163 +1299,172 @@ int32_t OmafTilesStitch::IsArrChanged(QualityRank qualityRanking, vector<TilesMe
 }
 
 int32_t OmafTilesStitch::GenerateMergedVideoHeaders(bool arrangeChanged, QualityRank qualityRanking,
-    vector<TilesMergeArrangement *> layOut,
-    vector<TilesMergeArrangement *> initLayOut,
-    std::map<uint32_t, MediaPacket *> packets) {
+    const vector<TilesMergeArrangement *> &layOut,
+    const vector<TilesMergeArrangement *> &initLayOut,
+    const std::map<uint32_t, MediaPacket *> &packets) {
     int32_t ret = ERROR_NONE;
     if (layOut.empty()) {
         OMAF_LOG(LOG_ERROR, "INVALID tile merge arrangement data!\n");
         return OMAF_ERROR_NULL_PTR;
     }
-    // 1. clear all headers
-    std::map<QualityRank, vector<std::map<uint32_t, uint8_t *>>>::iterator itMergeHrd;
-    for (itMergeHrd = m_mergedVideoHeaders.begin(); itMergeHrd != m_mergedVideoHeaders.end(); ) {
-      QualityRank oneQualityRanking = itMergeHrd->first;
-      vector<std::map<uint32_t, uint8_t *>> oneVideoHeaderArr = m_mergedVideoHeaders[oneQualityRanking];
-      for (uint32_t i = 0; i < oneVideoHeaderArr.size(); i++) {
-        std::map<uint32_t, uint8_t *>::iterator itHdr = oneVideoHeaderArr[i].begin();
-        if (itHdr == oneVideoHeaderArr[i].end())
-        {
-            OMAF_LOG(LOG_ERROR, "Video header map is empty!\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        uint8_t *headers = itHdr->second;
-        DELETE_ARRAY(headers);
-        oneVideoHeaderArr[i].clear();
+    QualityMergePlan &qualityPlan = m_mergePlans[qualityRanking];
+    // 1. get original VPS/SPS/PPS, cached plans are dropped once they change
+    const uint8_t *srcHeaders = nullptr;
+    uint32_t vpsLen = 0;
+    uint32_t spsLen = 0;
+    uint32_t ppsLen = 0;
+    if (qualityRanking == HIGHEST_QUALITY_RANKING) {
+      if (!m_fullResVideoHeader) {
+        OMAF_LOG(LOG_ERROR, "nullptr original video headers data !\n");
+        return OMAF_ERROR_NULL_PTR;
       }
-      oneVideoHeaderArr.clear();
-      m_mergedVideoHeaders.erase(itMergeHrd++);
-    }
-    // 2. generate new headers.
-    if ((qualityRanking == HIGHEST_QUALITY_RANKING) && (0 == m_mergedVideoHeaders[qualityRanking].size())) {
-      if (qualityRanking == HIGHEST_QUALITY_RANKING) {
-        if (!m_fullResVideoHeader) {
-          OMAF_LOG(LOG_ERROR, "nullptr original video headers data !\n");
-          return OMAF_ERROR_NULL_PTR;
-        }
-        vector<std::map<uint32_t, uint8_t*>> videoHeaders;
-        for (uint32_t i = 0; i < layOut.size(); i++) {
-          uint32_t headersSize = 0;
-          uint8_t *headers = new uint8_t[1024];
-          if (!headers) return OMAF_ERROR_NULL_PTR;
-
-          memset(headers, 0, 1024);
-          memcpy_s(headers, 1024, m_fullResVideoHeader, m_fullResVPSSize);
-          headersSize += m_fullResVPSSize;
-
-          uint8_t *tmp = headers + m_fullResVPSSize;
-          m_360scvpParam->pInputBitstream = m_fullResVideoHeader + m_fullResVPSSize;
-          m_360scvpParam->inputBitstreamLen = m_fullResSPSSize;
-          m_360scvpParam->destWidth = (arrangeChanged || initLayOut.size() < i + 1 ? layOut[i]->mergedWidth : initLayOut[i]->mergedWidth);
-          m_360scvpParam->destHeight = (arrangeChanged || initLayOut.size() < i + 1 ? layOut[i]->mergedHeight : initLayOut[i]->mergedHeight);
-          m_360scvpParam->pOutputBitstream = tmp;
-          ret = I360SCVP_GenerateSPS(m_360scvpParam, m_360scvpHandle);
-          if (ret) {
-            DELETE_ARRAY(headers);
-            return OMAF_ERROR_SCVP_OPERATION_FAILED;
-          }
-
-          headersSize += m_360scvpParam->outputBitstreamLen;
-          tmp += m_360scvpParam->outputBitstreamLen;
-          m_360scvpParam->pInputBitstream = m_fullResVideoHeader + m_fullResVPSSize + m_fullResSPSSize;
-          m_360scvpParam->inputBitstreamLen = m_fullResPPSSize;
-          m_360scvpParam->pOutputBitstream = tmp;
-          if (arrangeChanged) {
-            ret = I360SCVP_GeneratePPS(m_360scvpParam, &(layOut[i]->tilesLayout), m_360scvpHandle);
-          } else {
-            ret = I360SCVP_GeneratePPS(m_360scvpParam, &(initLayOut[i]->tilesLayout), m_360scvpHandle);
-          }
+      srcHeaders = m_fullResVideoHeader;
+      vpsLen = m_fullResVPSSize;
+      spsLen = m_fullResSPSSize;
+      ppsLen = m_fullResPPSSize;
+    } else {
+      std::map<uint32_t, MediaPacket *>::const_iterator itPacket = packets.begin();
+      if (itPacket == packets.end())
+      {
+          OMAF_LOG(LOG_ERROR, "Packets map is empty!\n");
+          return OMAF_ERROR_INVALID_DATA;
+      }
+      MediaPacket *onePacket = itPacket->second;
+      if (onePacket->GetHasVideoHeader()) {
+        srcHeaders = (uint8_t *)(onePacket->Payload());
+        vpsLen = onePacket->GetVPSLen();
+        spsLen = onePacket->GetSPSLen();
+        ppsLen = onePacket->GetPPSLen();
+      } else if (qualityPlan.srcHeaders.empty()) {
+        OMAF_LOG(LOG_ERROR, "There should be video headers here !\n");
+        return OMAF_ERROR_INVALID_DATA;
+      }
+    }
 
-          if (ret) {
-            DELETE_ARRAY(headers);
-            return OMAF_ERROR_SCVP_OPERATION_FAILED;
-          }
+    if (srcHeaders) {
+      uint32_t hrdSize = vpsLen + spsLen + ppsLen;
+      if ((qualityPlan.srcHeaders.size() != hrdSize) || (qualityPlan.srcVPSLen != vpsLen) ||
+          (qualityPlan.srcSPSLen != spsLen) || memcmp(qualityPlan.srcHeaders.data(), srcHeaders, hrdSize)) {
+        qualityPlan.srcHeaders.assign(srcHeaders, srcHeaders + hrdSize);
+        qualityPlan.srcVPSLen = vpsLen;
+        qualityPlan.srcSPSLen = spsLen;
+        qualityPlan.srcPPSLen = ppsLen;
+        qualityPlan.plans.clear();
+        if (m_paramsLoadedQuality == qualityRanking) m_paramsLoadedQuality = INVALID_QUALITY_RANKING;
+      }
+    }
 
-          headersSize += m_360scvpParam->outputBitstreamLen;
+    // 2. generate new headers only for the merged packets whose arrangement changed
+    qualityPlan.plans.resize(layOut.size());
+    for (uint32_t i = 0; i < layOut.size(); i++) {
+      TilesMergeArrangement *arrange = layOut[i];
+      if ((qualityRanking == HIGHEST_QUALITY_RANKING) && !arrangeChanged && (initLayOut.size() > i)) {
+        arrange = initLayOut[i];
+      }
+      if (!arrange) return OMAF_ERROR_NULL_PTR;
+
+      TilesMergePlan &plan = qualityPlan.plans[i];
+      TileArrangement *tilesLayout = &(arrange->tilesLayout);
+      if (!plan.mergedHeaders.empty() && (plan.hdrWidth == arrange->mergedWidth) &&
+          (plan.hdrHeight == arrange->mergedHeight) &&
+          (plan.tileRowHeight.size() == tilesLayout->tileRowsNum) &&
+          (plan.tileColWidth.size() == tilesLayout->tileColsNum) &&
+          std::equal(plan.tileRowHeight.begin(), plan.tileRowHeight.end(), tilesLayout->tileRowHeight) &&
+          std::equal(plan.tileColWidth.begin(), plan.tileColWidth.end(), tilesLayout->tileColWidth)) {
+        continue;
+      }
 
-          std::map<uint32_t, uint8_t *> oneVideoHeader;
-          oneVideoHeader.insert(std::make_pair(headersSize, headers));
-          videoHeaders.push_back(oneVideoHeader);
-        }
-        m_mergedVideoHeaders[qualityRanking] = std::move(videoHeaders);
+      ret = GenerateMergePlanHeaders(qualityPlan, arrange, plan);
+      if (ret) {
+        qualityPlan.plans.clear();
+        return ret;
       }
+      OMAF_LOG(LOG_INFO, "Regenerate merged video headers for quality ranking %d split %u\n", qualityRanking, i);
     }
+    return ret;
+}
 
-    if ((qualityRanking > HIGHEST_QUALITY_RANKING) && (0 == m_mergedVideoHeaders[qualityRanking].size())) {
-      if (qualityRanking > HIGHEST_QUALITY_RANKING) {
-        std::map<uint32_t, MediaPacket *>::iterator itPacket;
-        itPacket = packets.begin();
-        if (itPacket == packets.end())
-        {
-            OMAF_LOG(LOG_ERROR, "Packets map is empty!\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        MediaPacket *onePacket = itPacket->second;
-        if (!(onePacket->GetHasVideoHeader())) {
-            OMAF_LOG(LOG_ERROR, "There should be video headers here !\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        //get original VPS/SPS/PPS
-        uint32_t hrdSize = onePacket->GetVideoHeaderSize();
-        uint8_t *headersData = new uint8_t[hrdSize];
-        if (!headersData) {
-          return OMAF_ERROR_NULL_PTR;
-        }
-        memcpy_s(headersData, hrdSize, onePacket->Payload(), hrdSize);
-        vector<std::map<uint32_t, uint8_t*>> videoHeaders;
-        for (uint32_t i = 0; i < layOut.size(); i++) {
-        //generate new VPS/SPS/PPS for merged video
-          uint32_t headersSize = 0;
-          uint8_t *headers = new uint8_t[1024];
-          if (!headers)
-          {
-              DELETE_ARRAY(headersData);
-              return OMAF_ERROR_NULL_PTR;
-          }
-          memset(headers, 0, 1024);
-          uint32_t vpsLen = onePacket->GetVPSLen();
-          uint32_t spsLen = onePacket->GetSPSLen();
-          uint32_t ppsLen = onePacket->GetPPSLen();
-          memcpy_s(headers, vpsLen, headersData, vpsLen);
-          headersSize += vpsLen;
-
-          uint8_t *tmp = headers + vpsLen;
-          m_360scvpParam->pInputBitstream = headersData + vpsLen;
-          m_360scvpParam->inputBitstreamLen = spsLen;
-          m_360scvpParam->destWidth = layOut[i]->mergedWidth;
-          m_360scvpParam->destHeight = layOut[i]->mergedHeight;
-          m_360scvpParam->pOutputBitstream = tmp;
-          ret = I360SCVP_GenerateSPS(m_360scvpParam, m_360scvpHandle);
-          if (ret) {
-            DELETE_ARRAY(headersData);
-            DELETE_ARRAY(headers);
-            return OMAF_ERROR_SCVP_OPERATION_FAILED;
-          }
+int32_t OmafTilesStitch::GenerateMergePlanHeaders(QualityMergePlan &qualityPlan,
+    TilesMergeArrangement *arrange, TilesMergePlan &plan) {
+    int32_t ret = ERROR_NONE;
+    uint32_t vpsLen = qualityPlan.srcVPSLen;
+    uint32_t spsLen = qualityPlan.srcSPSLen;
+    uint32_t ppsLen = qualityPlan.srcPPSLen;
+    uint8_t *srcHeaders = qualityPlan.srcHeaders.data();
+    TileArrangement *tilesLayout = &(arrange->tilesLayout);
+    if (!tilesLayout->tileRowHeight || !tilesLayout->tileColWidth) {
+      return OMAF_ERROR_NULL_PTR;
+    }
 
-          headersSize += m_360scvpParam->outputBitstreamLen;
-          tmp += m_360scvpParam->outputBitstreamLen;
-          m_360scvpParam->pInputBitstream = headersData + vpsLen + spsLen;
-          m_360scvpParam->inputBitstreamLen = ppsLen;
-          m_360scvpParam->pOutputBitstream = tmp;
-
-          ret = I360SCVP_GeneratePPS(m_360scvpParam, &(layOut[i]->tilesLayout), m_360scvpHandle);
-          if (ret) {
-            DELETE_ARRAY(headersData);
-            DELETE_ARRAY(headers);
-            return OMAF_ERROR_SCVP_OPERATION_FAILED;
-          }
+    // generated SPS/PPS are written with at most twice of original size
+    std::vector<uint8_t> headers(vpsLen + 2 * (spsLen + ppsLen), 0);
+    memcpy_s(headers.data(), vpsLen, srcHeaders, vpsLen);
+    uint32_t headersSize = vpsLen;
+
+    m_360scvpParam->pInputBitstream = srcHeaders + vpsLen;
+    m_360scvpParam->inputBitstreamLen = spsLen;
+    m_360scvpParam->destWidth = arrange->mergedWidth;
+    m_360scvpParam->destHeight = arrange->mergedHeight;
+    m_360scvpParam->pOutputBitstream = headers.data() + headersSize;
+    ret = I360SCVP_GenerateSPS(m_360scvpParam, m_360scvpHandle);
+    // original SPS/PPS have been parsed into 360SCVP handle
+    m_paramsLoadedQuality = INVALID_QUALITY_RANKING;
+    if (ret) {
+      return OMAF_ERROR_SCVP_OPERATION_FAILED;
+    }
+    headersSize += m_360scvpParam->outputBitstreamLen;
+
+    m_360scvpParam->pInputBitstream = srcHeaders + vpsLen + spsLen;
+    m_360scvpParam->inputBitstreamLen = ppsLen;
+    m_360scvpParam->pOutputBitstream = headers.data() + headersSize;
+    ret = I360SCVP_GeneratePPS(m_360scvpParam, tilesLayout, m_360scvpHandle);
+    if (ret) {
+      return OMAF_ERROR_SCVP_OPERATION_FAILED;
+    }
+    headersSize += m_360scvpParam->outputBitstreamLen;
+    headers.resize(headersSize);
+
+    plan.hdrWidth = arrange->mergedWidth;
+    plan.hdrHeight = arrange->mergedHeight;
+    plan.tileRowHeight.assign(tilesLayout->tileRowHeight, tilesLayout->tileRowHeight + tilesLayout->tileRowsNum);
+    plan.tileColWidth.assign(tilesLayout->tileColWidth, tilesLayout->tileColWidth + tilesLayout->tileColsNum);
+    plan.mergedHeaders = std::move(headers);
+    return ERROR_NONE;
+}
 
-          headersSize += m_360scvpParam->outputBitstreamLen;
+int32_t OmafTilesStitch::LoadSourceParams(QualityRank qualityRanking) {
+    if (m_paramsLoadedQuality == qualityRanking) return ERROR_NONE;
 
-          std::map<uint32_t, uint8_t *> oneVideoHeader;
-          oneVideoHeader.insert(std::make_pair(headersSize, headers));
-          videoHeaders.push_back(oneVideoHeader);
-        }
-        m_mergedVideoHeaders[qualityRanking] = std::move(videoHeaders);
-        DELETE_ARRAY(headersData);
+    std::map<QualityRank, QualityMergePlan>::iterator itPlan = m_mergePlans.find(qualityRanking);
+    if (itPlan == m_mergePlans.end() || itPlan->second.srcHeaders.empty()) {
+      OMAF_LOG(LOG_ERROR, "Original video headers for quality ranking %d are not available !\n", qualityRanking);
+      return OMAF_ERROR_INVALID_DATA;
+    }
+    QualityMergePlan &qualityPlan = itPlan->second;
+    uint32_t paramsLen[3] = { qualityPlan.srcVPSLen, qualityPlan.srcSPSLen, qualityPlan.srcPPSLen };
+    uint8_t *params = qualityPlan.srcHeaders.data();
+    for (uint32_t i = 0; i < 3; i++) {
+      Nalu oneNalu;
+      memset(&oneNalu, 0, sizeof(Nalu));
+      oneNalu.data = params;
+      oneNalu.dataSize = paramsLen[i];
+      if (I360SCVP_ParseNAL(&oneNalu, m_360scvpHandle)) {
+        m_paramsLoadedQuality = INVALID_QUALITY_RANKING;
+        return OMAF_ERROR_NALU_NOT_FOUND;
       }
+      params += paramsLen[i];
     }
-    return ret;
+
+    // bits number of slice segment address is derived as 360SCVP parses it
+    Param_PicInfo picInfo;
+    memset(&picInfo, 0, sizeof(Param_PicInfo));
+    Param_PicInfo *pPicInfo = &picInfo;
+    I360SCVP_GetParameter(m_360scvpHandle, ID_SCVP_PARAM_PICINFO, (void **)(&pPicInfo));
+    uint32_t ctuSize = picInfo.maxCUWidth > 0 ? picInfo.maxCUWidth : LCU_SIZE;
+    uint32_t ctusNum = ((picInfo.picWidth + ctuSize - 1) / ctuSize) * ((picInfo.picHeight + ctuSize - 1) / ctuSize);
+    qualityPlan.srcSliceAddrBits = CeilLog2(ctusNum);
+    m_paramsLoadedQuality = qualityRanking;
+    return ERROR_NONE;
 }
 
 vector<std::unique_ptr<RegionWisePacking>> OmafTilesStitch::GenerateMergedRWPK(QualityRank qualityRanking, bool packetLost, bool arrangeChanged) {
@@ -1447,85 +1480,8 @@ vector<std::unique_ptr<RegionWisePacking>> OmafTilesStitch::GenerateMergedRWPK(Q
     return rwpk;
 }
 
-int32_t OmafTilesStitch::UpdateMergedVideoHeadersForLowQualityRank(bool isEmptyHeader,
-    std::map<uint32_t, MediaPacket *> packets, QualityRank qualityRanking,
-    TilesMergeArrangement *layOut) {
-    int32_t ret = ERROR_NONE;
-    std::map<uint32_t, MediaPacket *>::iterator itPacket;
-    if (isEmptyHeader) {
-        itPacket = packets.begin();
-        if (itPacket == packets.end())
-        {
-            OMAF_LOG(LOG_ERROR, "Packets map is empty!\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        MediaPacket *onePacket = itPacket->second;
-        if (!(onePacket->GetHasVideoHeader())) {
-            OMAF_LOG(LOG_ERROR, "There should be video headers here !\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        //get original VPS/SPS/PPS
-        uint32_t hrdSize = onePacket->GetVideoHeaderSize();
-        uint8_t *headersData = new uint8_t[hrdSize];
-        if (!headersData) {
-          return OMAF_ERROR_NULL_PTR;
-        }
-        memcpy_s(headersData, hrdSize, onePacket->Payload(), hrdSize);
-
-        //generate new VPS/SPS/PPS for merged video
-        uint32_t headersSize = 0;
-        uint8_t *headers = new uint8_t[1024];
-        if (!headers)
-        {
-            DELETE_ARRAY(headersData);
-            return OMAF_ERROR_NULL_PTR;
-        }
-        memset(headers, 0, 1024);
-        uint32_t vpsLen = onePacket->GetVPSLen();
-        uint32_t spsLen = onePacket->GetSPSLen();
-        uint32_t ppsLen = onePacket->GetPPSLen();
-        memcpy_s(headers, vpsLen, headersData, vpsLen);
-        headersSize += vpsLen;
-
-        uint8_t *tmp = headers + vpsLen;
-        m_360scvpParam->pInputBitstream = headersData + vpsLen;
-        m_360scvpParam->inputBitstreamLen = spsLen;
-        m_360scvpParam->destWidth = layOut->mergedWidth;
-        m_360scvpParam->destHeight = layOut->mergedHeight;
-        m_360scvpParam->pOutputBitstream = tmp;
-        ret = I360SCVP_GenerateSPS(m_360scvpParam, m_360scvpHandle);
-        if (ret) {
-          DELETE_ARRAY(headersData);
-          DELETE_ARRAY(headers);
-          return OMAF_ERROR_SCVP_OPERATION_FAILED;
-        }
-
-        headersSize += m_360scvpParam->outputBitstreamLen;
-        tmp += m_360scvpParam->outputBitstreamLen;
-        m_360scvpParam->pInputBitstream = headersData + vpsLen + spsLen;
-        m_360scvpParam->inputBitstreamLen = ppsLen;
-        m_360scvpParam->pOutputBitstream = tmp;
-
-        ret = I360SCVP_GeneratePPS(m_360scvpParam, &(layOut->tilesLayout), m_360scvpHandle);
-        if (ret) {
-          DELETE_ARRAY(headersData);
-          DELETE_ARRAY(headers);
-          return OMAF_ERROR_SCVP_OPERATION_FAILED;
-        }
-
-        headersSize += m_360scvpParam->outputBitstreamLen;
-
-        std::map<uint32_t, uint8_t *> oneVideoHeader;
-        oneVideoHeader.insert(std::make_pair(headersSize, headers));
-        m_mergedVideoHeaders[qualityRanking].push_back(std::move(oneVideoHeader));
-        DELETE_ARRAY(headersData);
-    }
-    return ret;
-}
-
-int32_t OmafTilesStitch::InitMergedDataAndRealSize(QualityRank qualityRanking, std::map<uint32_t, MediaPacket *> packets,
-    char* mergedData, uint64_t* realSize, uint32_t index,
-    TilesMergeArrangement *tilesArr) {
+int32_t OmafTilesStitch::InitMergedDataAndRealSize(QualityRank qualityRanking, const std::map<uint32_t, MediaPacket *> &packets,
+    char* mergedData, uint64_t* realSize, uint32_t index) {
     if (packets.empty()) {
         OMAF_LOG(LOG_ERROR, "packets is empty!\n");
         return OMAF_ERROR_INVALID_DATA;
@@ -1535,45 +1491,27 @@ int32_t OmafTilesStitch::InitMergedDataAndRealSize(QualityRank qualityRanking, s
         return OMAF_ERROR_NULL_PTR;
     }
     if (m_needHeaders) {
-      vector<std::map<uint32_t, uint8_t *>> videoHeaders = m_mergedVideoHeaders[qualityRanking];
-      bool isEmptyHeaders = (videoHeaders.empty() ? true : videoHeaders[index].empty());
-      if (qualityRanking != HIGHEST_QUALITY_RANKING) {
-        if (ERROR_NONE != UpdateMergedVideoHeadersForLowQualityRank(isEmptyHeaders, packets, qualityRanking, tilesArr)) {
-            OMAF_LOG(LOG_ERROR, "Update merged video headers for low quality ranking failed!\n");
-            return OMAF_ERROR_OPERATION;
-        }
-      }
-      if (m_mergedVideoHeaders[qualityRanking].empty()) {
+      std::map<QualityRank, QualityMergePlan>::iterator itPlan = m_mergePlans.find(qualityRanking);
+      if (itPlan == m_mergePlans.end() || itPlan->second.plans.size() <= index) {
         OMAF_LOG(LOG_ERROR, "Video headers for Quality %d is empty!\n", qualityRanking);
         return OMAF_ERROR_INVALID_DATA;
       }
-      if (m_mergedVideoHeaders[qualityRanking][index].empty()) {
+      const std::vector<uint8_t> &headers = itPlan->second.plans[index].mergedHeaders;
+      if (headers.empty()) {
         OMAF_LOG(LOG_ERROR, "Failed to generate merged video headers for quality ranking %d split %d\n", qualityRanking, index);
         return OMAF_ERROR_INVALID_DATA;
       }
-      std::map<uint32_t, uint8_t *> oneVideoHeader = (m_mergedVideoHeaders[qualityRanking][index]);
-      std::map<uint32_t, uint8_t *>::iterator itHdr = oneVideoHeader.begin();
-      if (itHdr == oneVideoHeader.end())
-      {
-          OMAF_LOG(LOG_ERROR, "Video header map is empty!\n");
-          return OMAF_ERROR_INVALID_DATA;
-      }
-      uint8_t *headers = itHdr->second;
-      uint32_t headersLen = itHdr->first;
-      if (!headers) {
-        return OMAF_ERROR_NULL_PTR;
-      }
-      memcpy_s(mergedData, headersLen, headers, headersLen);
-      *realSize += headersLen;
+      memcpy_s(mergedData, headers.size(), headers.data(), headers.size());
+      *realSize += headers.size();
     }
     return ERROR_NONE;
 }
 
 int32_t OmafTilesStitch::UpdateMergedDataAndRealSize(
-    QualityRank qualityRanking, std::map<uint32_t, MediaPacket *> packets,
+    QualityRank qualityRanking, const std::map<uint32_t, MediaPacket *> &packets,
     uint8_t tileColsNum, bool arrangeChanged, uint32_t width, uint32_t height,
     uint32_t initWidth, uint32_t initHeight, char *mergedData, uint64_t *realSize,
-    uint32_t index, vector<uint32_t> needPacketSize, uint64_t layoutNum) {
+    uint32_t index, const vector<uint32_t> &needPacketSize, uint64_t layoutNum) {
 
     uint32_t tilesIdx = 0;
     int32_t tileWidth = 0;
@@ -1586,8 +1524,37 @@ int32_t OmafTilesStitch::UpdateMergedDataAndRealSize(
         OMAF_LOG(LOG_ERROR, "merged data or realSize is null ptr!\n");
         return OMAF_ERROR_NULL_PTR;
     }
+    std::map<uint32_t, SourceInfo>::iterator itSrc;
+    itSrc = m_sources.find(qualityRanking);
+    if (itSrc == m_sources.end())
+    {
+      OMAF_LOG(LOG_ERROR, "Can't find source information corresponding to quality ranking %d\n", qualityRanking);
+      return OMAF_ERROR_INVALID_DATA;
+    }
+    const SourceInfo &srcInfo = itSrc->second;
+    // slices only need to be rewritten when merged resolution differs from the source
+    bool rewriteSlice = (width != (uint32_t)(srcInfo.width)) || (height != (uint32_t)(srcInfo.height));
+    TilesMergePlan *plan = nullptr;
+    uint32_t srcAddrBits = 0;
+    SliceHdrTemplate sliceHdrTmpl;
+    if (rewriteSlice) {
+      std::map<QualityRank, QualityMergePlan>::iterator itPlan = m_mergePlans.find(qualityRanking);
+      if (itPlan == m_mergePlans.end() || itPlan->second.plans.size() <= index) {
+        OMAF_LOG(LOG_ERROR, "There is no merge plan for quality ranking %d split %d\n", qualityRanking, index);
+        return OMAF_ERROR_INVALID_DATA;
+      }
+      plan = &(itPlan->second.plans[index]);
+      int32_t ret = LoadSourceParams(qualityRanking);
+      if (ret) {
+        OMAF_LOG(LOG_ERROR, "Failed to parse original video headers for quality ranking %d\n", qualityRanking);
+        return ret;
+      }
+      srcAddrBits = itPlan->second.srcSliceAddrBits;
+      m_360scvpParam->destWidth = (arrangeChanged ? width : initWidth);
+      m_360scvpParam->destHeight = (arrangeChanged ? height : initHeight);
+    }
     // calculate real size for merged packets
-    std::map<uint32_t, MediaPacket *>::iterator itPacket = packets.begin();
+    std::map<uint32_t, MediaPacket *>::const_iterator itPacket = packets.begin();
     if (index > 0)
       std::advance(itPacket, needPacketSize[index - 1]);
     if (itPacket == packets.end())
@@ -1625,93 +1592,81 @@ int32_t OmafTilesStitch::UpdateMergedDataAndRealSize(
           OMAF_LOG(LOG_ERROR, "Selected media packet is NULL !\n");
           return OMAF_ERROR_NULL_PTR;
       }
-      //if (qualityRanking == HIGHEST_QUALITY_RANKING) {
-      std::map<uint32_t, SourceInfo>::iterator itSrc;
-      itSrc = m_sources.find(qualityRanking);
-      if (itSrc == m_sources.end())
+      char *data = onePacket->Payload();
+      int32_t dataSize = onePacket->Size();
+      if (!data || !dataSize)
       {
-        OMAF_LOG(LOG_ERROR, "Can't find source information corresponding to quality ranking %d\n", qualityRanking);
-        return OMAF_ERROR_INVALID_DATA;
+          OMAF_LOG(LOG_ERROR, "Invalid data in selected media packet !\n");
+          return OMAF_ERROR_INVALID_DATA;
       }
-      SourceInfo srcInfo = itSrc->second;
 
-      OMAF_LOG(LOG_INFO, "Original source width %d, height %d\n", srcInfo.width, srcInfo.height);
-      OMAF_LOG(LOG_INFO, "Merged source width %d, height %d\n", width, height);
-      if ((width != (uint32_t)(srcInfo.width)) || (height != (uint32_t)(srcInfo.height))) {
-        SRDInfo srd = onePacket->GetSRDInfo();
+      if (onePacket->GetHasVideoHeader()) {
+        data += onePacket->GetVideoHeaderSize();
+        dataSize -= onePacket->GetVideoHeaderSize();
+      }
+      if (!data || !dataSize)
+      {
+          OMAF_LOG(LOG_ERROR, "After video headers (VPS/SPS/PPS) are moved, invalid data in selected media packet !\n");
+          return OMAF_ERROR_INVALID_DATA;
+      }
+
+      if (rewriteSlice) {
         if (!tileWidth || !tileHeight) {
+          SRDInfo srd = onePacket->GetSRDInfo();
           tileWidth = srd.width;
           tileHeight = srd.height;
         }
-
-        uint8_t colIdx = tilesIdx % tileColsNum;
-        uint8_t rowIdx = tilesIdx / tileColsNum;
-        uint16_t ctuIdx =
-            rowIdx * (tileHeight / LCU_SIZE) * ((tileWidth / LCU_SIZE) * tileColsNum) + colIdx * (tileWidth / LCU_SIZE);
-        // LOG(INFO)<< "SRD: " << srd.top << " and  "<<srd.left<<endl;
-        // LOG(INFO)<<"New ctuIdx  "<<ctuIdx<<endl;
-        char *data = onePacket->Payload();
-        int32_t dataSize = onePacket->Size();
-        if (!data || !dataSize)
-        {
-            OMAF_LOG(LOG_ERROR, "Invalid data in selected media packet !\n");
-            return OMAF_ERROR_INVALID_DATA;
+        // slice addresses only depend on tiles layout, so they are calculated once
+        if ((plan->sliceTileCols != tileColsNum) || (plan->sliceTileWidth != tileWidth) ||
+            (plan->sliceTileHeight != tileHeight)) {
+          plan->sliceTileCols = tileColsNum;
+          plan->sliceTileWidth = tileWidth;
+          plan->sliceTileHeight = tileHeight;
+          plan->sliceAddr.clear();
         }
-
-        if (onePacket->GetHasVideoHeader()) {
-          data += (onePacket->GetVPSLen() + onePacket->GetSPSLen() + onePacket->GetPPSLen());
-          dataSize -= (onePacket->GetVPSLen() + onePacket->GetSPSLen() + onePacket->GetPPSLen());
+        while (plan->sliceAddr.size() <= tilesIdx) {
+          uint32_t slotIdx = plan->sliceAddr.size();
+          uint8_t colIdx = slotIdx % tileColsNum;
+          uint8_t rowIdx = slotIdx / tileColsNum;
+          uint16_t ctuIdx =
+              rowIdx * (tileHeight / LCU_SIZE) * ((tileWidth / LCU_SIZE) * tileColsNum) + colIdx * (tileWidth / LCU_SIZE);
+          plan->sliceAddr.push_back(ctuIdx);
         }
-        if (!data || !dataSize)
-        {
-            OMAF_LOG(LOG_ERROR, "After video headers (VPS/SPS/PPS) are moved, invalid data in selected media packet !\n");
-            return OMAF_ERROR_INVALID_DATA;
+        uint16_t ctuIdx = plan->sliceAddr[tilesIdx];
+
+        // slice headers of tiles in one frame usually only differ in slice segment
+        // address, so 360SCVP rewrites one of them and others are patched from it
+        const uint8_t *srcNalu = (uint8_t *)data + HEVC_STARTCODES_LEN;
+        uint32_t srcSize = dataSize > HEVC_STARTCODES_LEN ? dataSize - HEVC_STARTCODES_LEN : 0;
+        uint8_t *sliceHdr = (uint8_t *)mergedData + *realSize;
+        uint32_t sliceHdrLen = 0;
+        uint32_t srcHdrLen = 0;
+        if (!PatchSliceHdr(sliceHdrTmpl, srcNalu, srcSize, srcAddrBits, ctuIdx, sliceHdr, &sliceHdrLen, &srcHdrLen)) {
+          Nalu nalu;
+          memset(&nalu, 0, sizeof(Nalu));
+          nalu.data = (uint8_t *)data;
+          nalu.dataSize = dataSize;
+          I360SCVP_ParseNAL(&nalu, m_360scvpHandle);
+
+          m_360scvpParam->pInputBitstream = (uint8_t *)data;
+          m_360scvpParam->inputBitstreamLen = dataSize;
+          m_360scvpParam->pOutputBitstream = sliceHdr;
+          I360SCVP_GenerateSliceHdr(m_360scvpParam, ctuIdx, m_360scvpHandle);
+          sliceHdrLen = m_360scvpParam->outputBitstreamLen;
+          srcHdrLen = nalu.sliceHeaderLen;
+          if (ctuIdx && !sliceHdrTmpl.srcNalu) {
+            SetSliceHdrTemplate(srcNalu, srcHdrLen, srcAddrBits, sliceHdr, sliceHdrLen, ctuIdx, sliceHdrTmpl);
+          }
         }
+        *realSize += sliceHdrLen;
 
-        Nalu *nalu = new Nalu;
-        if (!nalu) {
-          return OMAF_ERROR_NULL_PTR;
-        }
+        uint32_t skipLen = HEVC_STARTCODES_LEN + srcHdrLen;
+        memcpy_s(mergedData + *realSize, (size_t(dataSize) - skipLen), (data + skipLen),
+                 (size_t(dataSize) - skipLen));
 
-        nalu->data = (uint8_t *)data;
-        nalu->dataSize = dataSize;
-        I360SCVP_ParseNAL(nalu, m_360scvpHandle);
-
-        nalu->sliceHeaderLen = nalu->sliceHeaderLen - HEVC_NALUHEADER_LEN;
-
-        m_360scvpParam->destWidth = (arrangeChanged ? width : initWidth);
-        m_360scvpParam->destHeight = (arrangeChanged ? height : initHeight);
-        m_360scvpParam->pInputBitstream = (uint8_t *)data;
-        m_360scvpParam->inputBitstreamLen = dataSize;
-        m_360scvpParam->pOutputBitstream = (uint8_t *)mergedData + *realSize;
-        I360SCVP_GenerateSliceHdr(m_360scvpParam, ctuIdx, m_360scvpHandle);
-        *realSize += m_360scvpParam->outputBitstreamLen;
-        memcpy_s(mergedData + *realSize,
-                 (size_t(nalu->dataSize) - (HEVC_STARTCODES_LEN + HEVC_NALUHEADER_LEN + nalu->sliceHeaderLen)),
-                 (nalu->data + HEVC_STARTCODES_LEN + HEVC_NALUHEADER_LEN + nalu->sliceHeaderLen),
-                 (size_t(nalu->dataSize) - (HEVC_STARTCODES_LEN + HEVC_NALUHEADER_LEN + nalu->sliceHeaderLen)));
-
-        *realSize += nalu->dataSize - (HEVC_STARTCODES_LEN + HEVC_NALUHEADER_LEN + nalu->sliceHeaderLen);
-        SAFE_DELETE(nalu);
+        *realSize += dataSize - skipLen;
         tilesIdx++;
       } else {
-        char *data = onePacket->Payload();
-        int32_t dataSize = onePacket->Size();
-        if (!data || !dataSize)
-        {
-            OMAF_LOG(LOG_ERROR, "Invalid data in selected media packet !\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-
-        if (onePacket->GetHasVideoHeader()) {
-          data += onePacket->GetVideoHeaderSize();
-          dataSize -= onePacket->GetVideoHeaderSize();
-        }
-        if (!data || !dataSize)
-        {
-            OMAF_LOG(LOG_ERROR, "After video headers (VPS/SPS/PPS) are moved, invalid data in selected media packet !\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
         memcpy_s(mergedData + *realSize, dataSize, data, dataSize);
         *realSize += dataSize;
       }
@@ -1719,6 +1674,83 @@ int32_t OmafTilesStitch::UpdateMergedDataAndRealSize(
     return ERROR_NONE;
 }
 
+bool OmafTilesStitch::SetSliceHdrTemplate(const uint8_t *srcNalu, uint32_t srcHdrLen, uint32_t srcAddrBits,
+                                          const uint8_t *rewrittenHdr, uint32_t rewrittenLen, uint16_t sliceAddr,
+                                          SliceHdrTemplate &tmpl) {
+    tmpl.srcNalu = nullptr;
+    if (!srcNalu || !rewrittenHdr || !sliceAddr) return false;
+
+    // original slice header ends with byte alignment, one bit of 1 and then bits of 0
+    if ((srcHdrLen <= HEVC_NALUHEADER_LEN) || !srcNalu[srcHdrLen - 1] || HasEmulationBytes(srcNalu, srcHdrLen)) {
+      return false;
+    }
+    if (!ParseSliceAddrEnd(srcNalu, srcHdrLen, srcAddrBits, &(tmpl.srcPPSId), &(tmpl.srcAddrEnd))) return false;
+    uint32_t alignZeros = 0;
+    while (!((srcNalu[srcHdrLen - 1] >> alignZeros) & 1)) alignZeros++;
+    tmpl.srcHdrEnd = srcHdrLen * 8 - 1 - alignZeros;
+    if (tmpl.srcAddrEnd > tmpl.srcHdrEnd) return false;
+
+    if ((rewrittenLen <= HEVC_STARTCODES_LEN + HEVC_NALUHEADER_LEN) || rewrittenHdr[0] || rewrittenHdr[1] ||
+        rewrittenHdr[2] || (rewrittenHdr[3] != 1)) {
+      return false;
+    }
+    const uint8_t *hdr = rewrittenHdr + HEVC_STARTCODES_LEN;
+    uint32_t hdrLen = rewrittenLen - HEVC_STARTCODES_LEN;
+    if (HasEmulationBytes(hdr, hdrLen)) return false;
+    // 360SCVP writes slice segment address with bits number for merged resolution
+    uint32_t addrBits = CeilLog2(m_360scvpParam->destWidth / LCU_SIZE * m_360scvpParam->destHeight / LCU_SIZE);
+    uint32_t ppsId = 0;
+    uint32_t addrEnd = 0;
+    if (!ParseSliceAddrEnd(hdr, hdrLen, addrBits, &ppsId, &addrEnd)) return false;
+    if (ReadBits(hdr, addrEnd - addrBits, addrBits) != sliceAddr) return false;
+
+    tmpl.hdr.assign(hdr, hdr + hdrLen);
+    tmpl.addrPos = addrEnd - addrBits;
+    tmpl.addrBits = addrBits;
+    tmpl.srcNalu = srcNalu;
+    return true;
+}
+
+bool OmafTilesStitch::PatchSliceHdr(SliceHdrTemplate &tmpl, const uint8_t *srcNalu, uint32_t srcSize,
+                                    uint32_t srcAddrBits, uint16_t sliceAddr, uint8_t *output, uint32_t *outputLen,
+                                    uint32_t *srcHdrLen) {
+    if (!tmpl.srcNalu || !srcNalu || !sliceAddr) return false;
+    if ((srcSize <= HEVC_NALUHEADER_LEN) || memcmp(srcNalu, tmpl.srcNalu, HEVC_NALUHEADER_LEN)) return false;
+
+    uint32_t ppsId = 0;
+    uint32_t addrEnd = 0;
+    if (!ParseSliceAddrEnd(srcNalu, srcSize, srcAddrBits, &ppsId, &addrEnd) || (ppsId != tmpl.srcPPSId)) {
+      return false;
+    }
+    uint8_t naluType = (srcNalu[0] >> 1) & 0x3f;
+    uint32_t noOutputPos = HEVC_NALUHEADER_LEN * 8 + 1;
+    if (naluType >= 16 && naluType <= 23 && (ReadBits(srcNalu, noOutputPos, 1) != ReadBits(tmpl.srcNalu, noOutputPos, 1))) {
+      return false;
+    }
+
+    // the rest of slice header after slice segment address should be the same as template one
+    uint32_t restBits = tmpl.srcHdrEnd - tmpl.srcAddrEnd;
+    uint32_t hdrEnd = addrEnd + restBits;
+    uint32_t hdrLen = hdrEnd / 8 + 1;
+    if (hdrLen > srcSize) return false;
+    uint32_t alignBits = 8 - (hdrEnd & 7);
+    if ((srcNalu[hdrLen - 1] & ((1 << alignBits) - 1)) != (1 << (alignBits - 1))) return false;
+    if (HasEmulationBytes(srcNalu, hdrLen)) return false;
+    for (uint32_t pos = 0; pos < restBits; pos += 32) {
+      uint32_t bitsNum = std::min(restBits - pos, (uint32_t)32);
+      if (ReadBits(srcNalu, addrEnd + pos, bitsNum) != ReadBits(tmpl.srcNalu, tmpl.srcAddrEnd + pos, bitsNum)) {
+        return false;
+      }
+    }
+
+    WriteBits(tmpl.hdr.data(), tmpl.addrPos, tmpl.addrBits, sliceAddr);
+    memset(output, 0, HEVC_STARTCODES_LEN - 1);
+    output[HEVC_STARTCODES_LEN - 1] = 1;
+    *outputLen = HEVC_STARTCODES_LEN + CopyWithEmulationBytes(tmpl.hdr.data(), tmpl.hdr.size(), output + HEVC_STARTCODES_LEN);
+    *srcHdrLen = hdrLen;
+    return true;
+}
+
 int32_t OmafTilesStitch::UpdateInitTilesMergeArr() {
 
     for (auto it = m_initTilesMergeArr.begin(); it != m_initTilesMergeArr.end();) {
@@ -1784,7 +1816,7 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
   int32_t ret = GenerateTilesMergeArrangement();  // GenerateTilesMergeArrAndRwpk();
   if (ret) return ret;
 
-  if (0 == m_mergedVideoHeaders.size()) {
+  if (0 == m_mergePlans.size()) {
     if (m_updatedTilesMergeArr.size()) {
       OMAF_LOG(LOG_ERROR, "Incorrect operation in initialization stage !\n");
       return OMAF_ERROR_OPERATION;
@@ -1805,9 +1837,9 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
     auto qualityRanking = it->first;
     bool packetLost = false;
     bool arrangeChanged = false;
-    vector<TilesMergeArrangement *> layOut = it->second;
+    const vector<TilesMergeArrangement *> &layOut = it->second;
     if (layOut.empty()) return OMAF_ERROR_NULL_PTR;
-    vector<TilesMergeArrangement *> initLayOut = m_initTilesMergeArr[qualityRanking];
+    const vector<TilesMergeArrangement *> &initLayOut = m_initTilesMergeArr[qualityRanking];
 
     // 1. check isArrChanged, packetLost and arrangeChanged flag.
     ret = IsArrChanged(qualityRanking, layOut, initLayOut, &isArrChanged, &packetLost, &arrangeChanged);
@@ -1817,7 +1849,7 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
         return OMAF_ERROR_OPERATION;
     }
 
-    std::map<uint32_t, MediaPacket *> packets = m_selectedTiles[qualityRanking];
+    const std::map<uint32_t, MediaPacket *> &packets = m_selectedTiles[qualityRanking];
     // 2. if arrangeChanged, then generate new merged video headers
     ret = GenerateMergedVideoHeaders(arrangeChanged, qualityRanking, layOut, initLayOut, packets);
     if (ret != ERROR_NONE)
@@ -1832,7 +1864,7 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
         return OMAF_ERROR_GENERATE_RWPK;
     }
     // 4. init mergedData and realSize with headers
-    std::map<uint32_t, MediaPacket *>::iterator itPacket;
+    std::map<uint32_t, MediaPacket *>::const_iterator itPacket;
     std::vector<uint32_t> needAccumPacketSize(layOut.size(), 0);
     for (uint32_t index = 0; index < layOut.size(); index++) {
       uint32_t width = layOut[index]->mergedWidth;
@@ -1845,7 +1877,7 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
       mergedPacket->SetRwpk(std::move(rwpk[index]));
       char *mergedData = mergedPacket->Payload();
       uint64_t realSize = 0;
-      if (ERROR_NONE != InitMergedDataAndRealSize(qualityRanking, packets, mergedData, &realSize, index, layOut[index])) {
+      if (ERROR_NONE != InitMergedDataAndRealSize(qualityRanking, packets, mergedData, &realSize, index)) {
           SAFE_DELETE(mergedPacket);
           OMAF_LOG(LOG_ERROR, "Failed to calculated mergedData and realSize!\n");
           return OMAF_ERROR_OPERATION;
@@ -1927,7 +1959,12 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
 }
 
 std::list<MediaPacket *> OmafTilesStitch::GetTilesMergedPackets() {
-  this->GenerateOutputMergedPackets();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if (ERROR_NONE == this->GenerateOutputMergedPackets()) {
+    uint64_t mergeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    static LatencyHistogram *mergeTime = MetricsRegistry::GetInstance()->GetHistogram(CLIENT_MERGE_TIME);
+    mergeTime->Record(mergeUs);
+  }
   return m_outMergedStream;
 }
 
@@ -64,6 +64,54 @@ typedef struct TilesMergeArrangement {
   TileArrangement tilesLayout;
 } TilesMergeArrangement;
 
+//!
+//! \sturct: TilesMergePlan
+//! \brief:  cached merge plan for one merged packet, including merged
+//!          VPS/SPS/PPS and new slice address of each tile, which is
+//!          only regenerated when tiles merge arrangement changes
+//!
+typedef struct TilesMergePlan {
+  uint32_t hdrWidth = 0;                //<! merged width written into SPS
+  uint32_t hdrHeight = 0;               //<! merged height written into SPS
+  std::vector<uint16_t> tileRowHeight;  //<! tile rows height written into PPS
+  std::vector<uint16_t> tileColWidth;   //<! tile cols width written into PPS
+  std::vector<uint8_t> mergedHeaders;   //<! VPS/SPS/PPS for merged video
+  uint8_t sliceTileCols = 0;            //<! tile cols number slice addresses are calculated with
+  int32_t sliceTileWidth = 0;           //<! tile width slice addresses are calculated with
+  int32_t sliceTileHeight = 0;          //<! tile height slice addresses are calculated with
+  std::vector<uint16_t> sliceAddr;      //<! new slice segment address of each tile in merged video
+} TilesMergePlan;
+
+//!
+//! \sturct: QualityMergePlan
+//! \brief:  cached merge plans for tiles set of one quality ranking
+//!
+typedef struct QualityMergePlan {
+  std::vector<uint8_t> srcHeaders;    //<! source VPS/SPS/PPS which merged headers are generated from
+  uint32_t srcVPSLen = 0;             //<! VPS size in source headers
+  uint32_t srcSPSLen = 0;             //<! SPS size in source headers
+  uint32_t srcPPSLen = 0;             //<! PPS size in source headers
+  uint32_t srcSliceAddrBits = 0;      //<! bits number of slice segment address in source slices
+  std::vector<TilesMergePlan> plans;  //<! merge plan for each merged packet
+} QualityMergePlan;
+
+//!
+//! \sturct: SliceHdrTemplate
+//! \brief:  slice header rewritten by 360SCVP for one tile of current
+//!          frame, other tiles of the frame whose original slice headers
+//!          only differ in slice segment address reuse it with the new
+//!          slice segment address patched
+//!
+typedef struct SliceHdrTemplate {
+  const uint8_t *srcNalu = nullptr;  //<! original slice nalu from nalu header, which template is rewritten from
+  uint32_t srcAddrEnd = 0;           //<! bit position after slice segment address in original slice nalu
+  uint32_t srcHdrEnd = 0;            //<! bit position of byte alignment in original slice nalu
+  uint32_t srcPPSId = 0;             //<! PPS id in original slice header
+  std::vector<uint8_t> hdr;          //<! rewritten slice nalu header and slice header, without start codes
+  uint32_t addrPos = 0;              //<! bit position of slice segment address in hdr
+  uint32_t addrBits = 0;             //<! bits number of slice segment address in hdr
+} SliceHdrTemplate;
+
 //!
 //! \class OmafTilesStitch
 //! \brief The class for tiles stitching
@@ -243,21 +291,93 @@ private:
   OmafTilesStitch& operator=(const OmafTilesStitch& other) { return *this; };
   OmafTilesStitch(const OmafTilesStitch& other) { /* do not create copies */ };
 
-  int32_t IsArrChanged(QualityRank qualityRanking, vector<TilesMergeArrangement *> layOut, vector<TilesMergeArrangement *> initLayOut, bool *isArrChanged, bool *packetLost, bool *arrangeChanged);
+  int32_t IsArrChanged(QualityRank qualityRanking, const vector<TilesMergeArrangement *> &layOut, const vector<TilesMergeArrangement *> &initLayOut, bool *isArrChanged, bool *packetLost, bool *arrangeChanged);
 
-  int32_t GenerateMergedVideoHeaders(bool arrangeChanged, QualityRank qualityRanking, vector<TilesMergeArrangement *> layOut, vector<TilesMergeArrangement *> initLayOut, std::map<uint32_t, MediaPacket *> packets);
+  //!
+  //! \brief  Update cached merge plans for tiles set with specified
+  //!         quality ranking, merged VPS/SPS/PPS are only regenerated
+  //!         for merged packets whose arrangement has changed
+  //!
+  //! \return int32_t
+  //!         ERROR_NONE if success, else failed reason
+  //!
+  int32_t GenerateMergedVideoHeaders(bool arrangeChanged, QualityRank qualityRanking, const vector<TilesMergeArrangement *> &layOut, const vector<TilesMergeArrangement *> &initLayOut, const std::map<uint32_t, MediaPacket *> &packets);
 
-  vector<std::unique_ptr<RegionWisePacking>> GenerateMergedRWPK(QualityRank qualityRanking, bool packetLost, bool arrangeChanged);
+  int32_t GenerateMergePlanHeaders(QualityMergePlan &qualityPlan, TilesMergeArrangement *arrange, TilesMergePlan &plan);
 
-  int32_t UpdateMergedVideoHeadersForLowQualityRank(bool isEmptyHeaders, std::map<uint32_t, MediaPacket *> packets, QualityRank qualityRanking, TilesMergeArrangement *layOut);
+  //!
+  //! \brief  Parse source VPS/SPS/PPS of specified quality ranking into
+  //!         360SCVP library handle, so that slices of this quality
+  //!         ranking can be parsed and rewritten
+  //!
+  //! \return int32_t
+  //!         ERROR_NONE if success, else failed reason
+  //!
+  int32_t LoadSourceParams(QualityRank qualityRanking);
 
-  int32_t InitMergedDataAndRealSize(QualityRank qualityRanking, std::map<uint32_t, MediaPacket *> packets, char* mergedData, uint64_t* realSize, uint32_t index, TilesMergeArrangement *tilesArr);
+  //!
+  //! \brief  Set slice header template from the slice header rewritten
+  //!         by 360SCVP for one tile
+  //!
+  //! \param  [in] srcNalu
+  //!         original slice nalu from nalu header
+  //! \param  [in] srcHdrLen
+  //!         original slice header length including nalu header
+  //! \param  [in] srcAddrBits
+  //!         bits number of slice segment address in original slice
+  //! \param  [in] rewrittenHdr
+  //!         rewritten slice header with start codes
+  //! \param  [in] rewrittenLen
+  //!         rewritten slice header length
+  //! \param  [in] sliceAddr
+  //!         slice segment address in rewritten slice header
+  //! \param  [out] tmpl
+  //!         slice header template
+  //!
+  //! \return bool
+  //!         true if the template can be used to rewrite other tiles
+  //!
+  bool SetSliceHdrTemplate(const uint8_t *srcNalu, uint32_t srcHdrLen, uint32_t srcAddrBits,
+                           const uint8_t *rewrittenHdr, uint32_t rewrittenLen, uint16_t sliceAddr,
+                           SliceHdrTemplate &tmpl);
+
+  //!
+  //! \brief  Write rewritten slice header of one tile through patching
+  //!         slice segment address in the slice header template
+  //!
+  //! \param  [in] tmpl
+  //!         slice header template of current frame
+  //! \param  [in] srcNalu
+  //!         original slice nalu of the tile from nalu header
+  //! \param  [in] srcSize
+  //!         original slice nalu size
+  //! \param  [in] srcAddrBits
+  //!         bits number of slice segment address in original slice
+  //! \param  [in] sliceAddr
+  //!         new slice segment address of the tile
+  //! \param  [out] output
+  //!         buffer for rewritten slice header with start codes
+  //! \param  [out] outputLen
+  //!         rewritten slice header length
+  //! \param  [out] srcHdrLen
+  //!         original slice header length including nalu header
+  //!
+  //! \return bool
+  //!         true if the original slice header only differs from the
+  //!         template one in slice segment address and is rewritten
+  //!
+  bool PatchSliceHdr(SliceHdrTemplate &tmpl, const uint8_t *srcNalu, uint32_t srcSize, uint32_t srcAddrBits,
+                     uint16_t sliceAddr, uint8_t *output, uint32_t *outputLen, uint32_t *srcHdrLen);
+
+  vector<std::unique_ptr<RegionWisePacking>> GenerateMergedRWPK(QualityRank qualityRanking, bool packetLost, bool arrangeChanged);
+
+  int32_t InitMergedDataAndRealSize(QualityRank qualityRanking, const std::map<uint32_t, MediaPacket *> &packets, char* mergedData, uint64_t* realSize, uint32_t index);
 
   int32_t UpdateMergedDataAndRealSize(
-      QualityRank qualityRanking, std::map<uint32_t, MediaPacket *> packets,
+      QualityRank qualityRanking, const std::map<uint32_t, MediaPacket *> &packets,
       uint8_t tileColsNum, bool arrangeChanged, uint32_t width, uint32_t height,
       uint32_t initWidth, uint32_t initHeight, char *mergedData, uint64_t *realSize,
-      uint32_t index, vector<uint32_t> needPacketSize, uint64_t layoutNum);
+      uint32_t index, const vector<uint32_t> &needPacketSize, uint64_t layoutNum);
 
   int32_t UpdateInitTilesMergeArr();
 
@@ -290,8 +410,9 @@ private:
   std::map<QualityRank, vector<TilesMergeArrangement *>>
       m_updatedTilesMergeArr;  //<! updated tiles merge arrangement per frame
 
-  std::map<QualityRank, vector<std::map<uint32_t, uint8_t *>>>
-      m_mergedVideoHeaders;  //<! map of <qualityRanking, <mergedVideoHeadersSize, mergedVideoHeadersData*>>
+  std::map<QualityRank, QualityMergePlan> m_mergePlans;  //<! map of <qualityRanking, cached merge plans>
+
+  QualityRank m_paramsLoadedQuality;  //<! quality ranking whose source VPS/SPS/PPS are parsed in 360SCVP handle
 
   uint32_t m_fullWidth;  //<! the width of original video
 
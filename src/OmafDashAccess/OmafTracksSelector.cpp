@@ -53,6 +53,7 @@ OmafTracksSelector::OmafTracksSelector(int size) {
   mSegmentDur = 0;
   mQualityRanksNum = 0;
   mLastCatchupPTS = 0;
+  mViewportCacheResolution = 0.0f;
   memset_s(&(mI360ScvpPlugin), sizeof(PluginDef), 0);
 }
 
@@ -232,6 +233,14 @@ int OmafTracksSelector::SetInitialViewport(std::vector<Viewport *> &pView, HeadS
   m360ViewPortHandle = I360SCVP_Init(mParamViewport);
   if (!m360ViewPortHandle) return ERROR_NULL_PTR;
 
+  // head poses within the cache resolution share the tiles selection result
+  if (mViewportCacheResolution > 0.0f) {
+    Param_ViewportCache cacheParam;
+    memset_s(&cacheParam, sizeof(Param_ViewportCache), 0);
+    cacheParam.angularResolution = mViewportCacheResolution;
+    I360SCVP_SetParameter(m360ViewPortHandle, ID_SCVP_PARAM_VIEWPORT_CACHE, &cacheParam);
+  }
+
   // set current Pose;
   mPose = new HeadPose;
   if (!mPose) return ERROR_NULL_PTR;
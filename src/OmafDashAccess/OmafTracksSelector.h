@@ -139,6 +139,11 @@ class OmafTracksSelector {
       mI360ScvpPlugin.pluginLibPath = i360scvp_plugin.pluginLibPath;
   };
 
+  //!
+  //! \brief  Set angular resolution in degree of the viewport tiles selection cache, 0 disables it
+  //!
+  void SetViewportCacheResolution(float resolution) { mViewportCacheResolution = resolution; };
+
   //!
   //! \brief  Compare current tracks and prev tracks and get the different tracks.
   //!
@@ -180,6 +185,7 @@ private:
   map<int32_t, int32_t>         mTwoDStreamQualityMap;
   uint32_t                      mSegmentDur;
   PluginDef                     mI360ScvpPlugin;
+  float                         mViewportCacheResolution;
   uint64_t                      mLastCatchupPTS;
   TracksMap                     mCurrSelectedTracksMap;
   std::map<int, OmafAdaptationSet*>  mASMap;
@@ -45,6 +45,7 @@ namespace OMAF {
 
 const long DEFAULT_MAX_PARALLEL_TRANSFERS = 50;
 const int32_t DEFAULT_SEGMENT_OPEN_TIMEOUT = 3000;
+const int32_t DEFAULT_MAX_PARSE_WORKERS = 1;
 
 enum class OmafDashMode { EXTRACTOR = 0, LATER_BINDING = 1, MULTI_VIEW = 2 };
 
@@ -145,6 +146,8 @@ class OmafDashParams {
   OmafDashPredictorParams prediector_params_;
   long max_parallel_transfers_ = DEFAULT_MAX_PARALLEL_TRANSFERS;
   int32_t segment_open_timeout_ms_ = DEFAULT_SEGMENT_OPEN_TIMEOUT;
+  // for segment parsing
+  int32_t max_parse_workers_ = DEFAULT_MAX_PARSE_WORKERS;
   // for stitch
   uint32_t max_decode_width_;
   uint32_t max_decode_height_;
@@ -153,12 +156,19 @@ class OmafDashParams {
   uint32_t max_response_times_in_seg;
   uint32_t max_catchup_width;
   uint32_t max_catchup_height;
+  // for packet output
+  bool enable_packet_release_ = false;
+  // for viewport tiles selection, 0 disables the cache
+  float viewport_cache_resolution_ = 0.0f;
 
   std::string to_string() {
     std::stringstream ss;
     ss << http_proxy_.to_string();
     ss << http_params_.to_string();
     ss << "\tmax parallel transfers: " << max_parallel_transfers_ << ", " << std::endl;
+    ss << "\tmax parse workers: " << max_parse_workers_ << ", " << std::endl;
+    ss << "\tpacket release: " << enable_packet_release_ << ", " << std::endl;
+    ss << "\tviewport cache resolution: " << viewport_cache_resolution_ << ", " << std::endl;
     ss << stats_params_.to_string();
     ss << syncer_params_.to_string();
     ss << prediector_params_.to_string();
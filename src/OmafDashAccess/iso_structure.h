@@ -98,6 +98,8 @@ using SampleType = VCD::MP4::FrameCodecType;
 
 using SampleInformation = VCD::MP4::TrackSampInfo;
 
+using SegmentSample = VCD::MP4::SegSample;
+
 using TrackInformation = VCD::MP4::TrackInformation;
 
 using SchemeTypesProperty = VCD::MP4::SchemeTypesProperty;
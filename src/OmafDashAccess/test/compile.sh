@@ -6,19 +6,39 @@ g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMediaSour
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMPDParser.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafReader.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafReaderManager.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafReaderManagerPerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testDownloader.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testDownloaderPerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testTracksSelector.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testStreamBlocksPerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMediaPacket.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafTilesStitch.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testAsyncLog.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMetricsRegistry.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testSegmentSampleTable.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMappedFilePerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testDownloadCache.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMPDParsePerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 
 LD_FLAGS="-I/usr/local/include/ -lcurl -lstdc++ -lOmafDashAccess -llttng-ust -ldl -lpthread -lglog -l360SCVP -lm -L/usr/local/lib"
-g++ -L/usr/local/lib testDownloaderPerf.o testDownloader.o testMediaSource.o testMPDParser.o testOmafReader.o testOmafReaderManager.o testTracksSelector.o libgtest.a -o testLib ${LD_FLAGS}
+g++ -L/usr/local/lib testDownloaderPerf.o testDownloader.o testMediaSource.o testMPDParser.o testOmafReader.o testOmafReaderManager.o testOmafReaderManagerPerf.o testTracksSelector.o testStreamBlocksPerf.o testMediaPacket.o testOmafTilesStitch.o testAsyncLog.o testMetricsRegistry.o testSegmentSampleTable.o testMappedFilePerf.o testDownloadCache.o testMPDParsePerf.o libgtest.a -o testLib ${LD_FLAGS}
 g++ -L/usr/local/lib testMediaSource.o libgtest.a -o testMediaSource ${LD_FLAGS}
 g++ -L/usr/local/lib testMPDParser.o libgtest.a -o testMPDParser ${LD_FLAGS}
 g++ -L/usr/local/lib testOmafReader.o libgtest.a -o testOmafReader ${LD_FLAGS}
 g++ -L/usr/local/lib testOmafReaderManager.o libgtest.a -o testOmafReaderManager ${LD_FLAGS}
+g++ -L/usr/local/lib testOmafReaderManagerPerf.o libgtest.a -o testOmafReaderManagerPerf ${LD_FLAGS}
 g++ -L/usr/local/lib testDownloader.o libgtest.a -o testDownloader ${LD_FLAGS}
 g++ -L/usr/local/lib testDownloaderPerf.o libgtest.a -o testDownloaderPerf ${LD_FLAGS}
 g++ -L/usr/local/lib testTracksSelector.o libgtest.a -o testTracksSelector ${LD_FLAGS}
+g++ -L/usr/local/lib testStreamBlocksPerf.o libgtest.a -o testStreamBlocksPerf ${LD_FLAGS}
+g++ -L/usr/local/lib testMediaPacket.o libgtest.a -o testMediaPacket ${LD_FLAGS}
+g++ -L/usr/local/lib testOmafTilesStitch.o libgtest.a -o testOmafTilesStitch ${LD_FLAGS}
+g++ -L/usr/local/lib testAsyncLog.o libgtest.a -o testAsyncLog ${LD_FLAGS}
+g++ -L/usr/local/lib testMetricsRegistry.o libgtest.a -o testMetricsRegistry ${LD_FLAGS}
+g++ -L/usr/local/lib testSegmentSampleTable.o libgtest.a -o testSegmentSampleTable ${LD_FLAGS}
+g++ -L/usr/local/lib testMappedFilePerf.o libgtest.a -o testMappedFilePerf ${LD_FLAGS}
+g++ -L/usr/local/lib testDownloadCache.o libgtest.a -o testDownloadCache ${LD_FLAGS}
+g++ -L/usr/local/lib testMPDParsePerf.o libgtest.a -o testMPDParsePerf ${LD_FLAGS}
 
 ./run.sh
 if [ $? -ne 0 ]; then exit 1; fi
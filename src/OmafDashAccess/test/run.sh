@@ -9,9 +9,27 @@ curl -ukang1:AP2hWmPtk4RkLXUn2SMWfocyUq2 -O "https://ubit-artifactory-sh.intel.c
 ./testTracksSelector
 if [ $? -ne 0 ]; then exit 1; fi
 
+./testStreamBlocksPerf
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMediaPacket
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testOmafTilesStitch
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testAsyncLog
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMetricsRegistry
+if [ $? -ne 0 ]; then exit 1; fi
+
 ./testOmafReaderManager
 if [ $? -ne 0 ]; then exit 1; fi
 
+./testOmafReaderManagerPerf
+if [ $? -ne 0 ]; then exit 1; fi
+
 ./testDownloaderPerf
 if [ $? -ne 0 ]; then exit 1; fi
 
@@ -41,6 +59,18 @@ curl -ukang1:AP2hWmPtk4RkLXUn2SMWfocyUq2 -O "https://ubit-artifactory-sh.intel.c
 ./testOmafReader
 if [ $? -ne 0 ]; then exit 1; fi
 
+./testSegmentSampleTable
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMappedFilePerf
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testDownloadCache
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMPDParsePerf
+if [ $? -ne 0 ]; then exit 1; fi
+
 # All caes passed
 ################################
 rm -rf ./segs_for_readertest*
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testAsyncLog.cpp
+//! \brief:  asynchronous log backend unit test and hot path benchmark
+//!
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+// only warning and above are compiled in for this test
+#define OMAF_LOG_MIN_LEVEL LOG_WARNING
+#include "../OmafDashAccessLog.h"
+
+namespace {
+
+typedef struct LogMessage {
+  LogLevel level;
+  std::string file;
+  uint64_t line;
+  uint64_t timeUs;
+  uint32_t tid;
+  std::string msg;
+} LogMessage;
+
+static std::mutex g_mutex;
+static std::vector<LogMessage> g_messages;
+static std::condition_variable g_cond;
+static bool g_blockSink = false;
+static bool g_sinkEntered = false;
+static std::atomic<uint64_t> g_sinkCount(0);
+
+static uint64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+static void CaptureSink(LogLevel logLevel, const char *sourceFile, uint64_t line, uint64_t timeUs, uint32_t tid,
+                        const char *msg) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_messages.push_back({logLevel, sourceFile, line, timeUs, tid, msg});
+}
+
+static void BlockingSink(LogLevel logLevel, const char *sourceFile, uint64_t line, uint64_t timeUs, uint32_t tid,
+                         const char *msg) {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  g_sinkEntered = true;
+  g_cond.notify_all();
+  g_cond.wait(lock, [] { return !g_blockSink; });
+}
+
+static void CountSink(LogLevel logLevel, const char *sourceFile, uint64_t line, uint64_t timeUs, uint32_t tid,
+                      const char *msg) {
+  g_sinkCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+class AsyncLogTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    AsyncLogFlush();
+    AsyncLogSetSink(CaptureSink);
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_messages.clear();
+  }
+
+  virtual void TearDown() {
+    AsyncLogFlush();
+    AsyncLogSetSink(NULL);
+  }
+};
+
+TEST_F(AsyncLogTest, FormatMatchesSnprintf) {
+  const char *str = "tile";
+  int32_t i32 = -12345;
+  uint32_t u32 = 4000000000u;
+  int64_t i64 = -1234567890123ll;
+  uint64_t u64 = 18446744073709551615ull;
+  size_t size = 1920 * 960;
+  double value = 3.1415926;
+  void *ptr = &value;
+  char expected[256];
+
+  AsyncLogFunction(LOG_INFO, "a.cpp", 1, "no args\n");
+  AsyncLogFunction(LOG_INFO, "a.cpp", 2, "%d %u %ld %lu\n", i32, u32, (long)i64, (unsigned long)u64);
+  AsyncLogFunction(LOG_WARNING, "a.cpp", 3, "%lld %llu %zu %x %X %o\n", (long long)i64, (unsigned long long)u64, size,
+                   u32, u32, u32);
+  AsyncLogFunction(LOG_ERROR, "a.cpp", 4, "%s=%-8s|%5.2f %e %g %c 100%%\n", str, str, value, value, value, 'x');
+  AsyncLogFunction(LOG_INFO, "a.cpp", 5, "%.*s|%*.*f\n", 2, str, 8, 3, value);
+  AsyncLogFunction(LOG_INFO, "a.cpp", 6, "%p %hhu %hd\n", ptr, (unsigned char)200, (short)-3);
+  AsyncLogFunction(LOG_INFO, "a.cpp", 7, "%d %d %d %d %d %d %d %d\n", 1, 2, 3, 4, 5, 6, 7, 8);
+  AsyncLogFlush();
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  ASSERT_EQ(g_messages.size(), 7u);
+  EXPECT_EQ(g_messages[0].msg, "no args");
+  EXPECT_EQ(g_messages[0].file, "a.cpp");
+  EXPECT_EQ(g_messages[0].line, 1u);
+  snprintf(expected, sizeof(expected), "%d %u %ld %lu", i32, u32, (long)i64, (unsigned long)u64);
+  EXPECT_EQ(g_messages[1].msg, expected);
+  snprintf(expected, sizeof(expected), "%lld %llu %zu %x %X %o", (long long)i64, (unsigned long long)u64, size, u32,
+           u32, u32);
+  EXPECT_EQ(g_messages[2].msg, expected);
+  EXPECT_EQ(g_messages[2].level, LOG_WARNING);
+  snprintf(expected, sizeof(expected), "%s=%-8s|%5.2f %e %g %c 100%%", str, str, value, value, value, 'x');
+  EXPECT_EQ(g_messages[3].msg, expected);
+  snprintf(expected, sizeof(expected), "%.*s|%*.*f", 2, str, 8, 3, value);
+  EXPECT_EQ(g_messages[4].msg, expected);
+  snprintf(expected, sizeof(expected), "%p %hhu %hd", ptr, (unsigned char)200, (short)-3);
+  EXPECT_EQ(g_messages[5].msg, expected);
+  // arguments beyond ASYNC_LOG_MAX_ARGS are printed as '?'
+  EXPECT_EQ(g_messages[6].msg, "1 2 3 4 5 6 ? ?");
+}
+
+TEST_F(AsyncLogTest, StringArgumentsAreCopied) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%s", "before");
+  AsyncLogFunction(LOG_INFO, "a.cpp", 1, "value %s\n", buffer);
+  snprintf(buffer, sizeof(buffer), "%s", "after");
+  AsyncLogFunction(LOG_INFO, "a.cpp", 2, "null %s\n", (char *)NULL);
+  std::string longStr(ASYNC_LOG_STRING_SIZE * 2, 'a');
+  AsyncLogFunction(LOG_INFO, "a.cpp", 3, "%s\n", longStr.c_str());
+  AsyncLogFlush();
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  ASSERT_EQ(g_messages.size(), 3u);
+  EXPECT_EQ(g_messages[0].msg, "value before");
+  EXPECT_EQ(g_messages[1].msg, "null (null)");
+  EXPECT_EQ(g_messages[2].msg, std::string(ASYNC_LOG_STRING_SIZE - 1, 'a'));
+}
+
+TEST_F(AsyncLogTest, MultiThreadsKeepOrderPerThread) {
+  const int32_t threadsNum = 4;
+  const int32_t logsNum = 5000;
+  std::vector<std::thread> threads;
+  uint64_t droppedBefore = AsyncLogGetDroppedNum();
+  for (int32_t idx = 0; idx < threadsNum; idx++) {
+    threads.emplace_back([idx, logsNum] {
+      for (int32_t cnt = 0; cnt < logsNum; cnt++) {
+        AsyncLogFunction(LOG_INFO, "t.cpp", idx, "%d %d\n", idx, cnt);
+        if ((cnt % 512) == 511) AsyncLogFlush();
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  AsyncLogFlush();
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  uint64_t dropped = AsyncLogGetDroppedNum() - droppedBefore;
+  EXPECT_EQ(g_messages.size() + dropped, (size_t)(threadsNum * logsNum));
+  std::vector<int32_t> last(threadsNum, -1);
+  for (auto &message : g_messages) {
+    int32_t idx = 0, cnt = 0;
+    ASSERT_EQ(sscanf(message.msg.c_str(), "%d %d", &idx, &cnt), 2);
+    ASSERT_TRUE(idx >= 0 && idx < threadsNum);
+    EXPECT_EQ(message.line, (uint64_t)idx);
+    EXPECT_GT(cnt, last[idx]);
+    last[idx] = cnt;
+  }
+}
+
+TEST_F(AsyncLogTest, TimeAndThreadOfCallSite) {
+  uint64_t before = 0, after = 0;
+  uint32_t tid = 0;
+  std::thread logger([&] {
+    tid = (uint32_t)syscall(SYS_gettid);
+    before = NowUs();
+    AsyncLogFunction(LOG_INFO, "a.cpp", 1, "stamped\n");
+    after = NowUs();
+  });
+  logger.join();
+  // output later than the call must still carry the call time
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  AsyncLogFlush();
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  ASSERT_EQ(g_messages.size(), 1u);
+  EXPECT_GE(g_messages[0].timeUs, before);
+  EXPECT_LE(g_messages[0].timeUs, after);
+  EXPECT_EQ(g_messages[0].tid, tid);
+}
+
+TEST_F(AsyncLogTest, FullRingDropsWithoutBlocking) {
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_blockSink = true;
+    g_sinkEntered = false;
+  }
+  AsyncLogSetSink(BlockingSink);
+  uint64_t droppedBefore = AsyncLogGetDroppedNum();
+
+  // the first record holds the consumer in sink
+  AsyncLogFunction(LOG_INFO, "a.cpp", 1, "first\n");
+  std::thread flusher([] { AsyncLogFlush(); });
+  {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    g_cond.wait(lock, [] { return g_sinkEntered; });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int32_t cnt = 0; cnt < ASYNC_LOG_RING_SIZE + 100; cnt++) {
+    AsyncLogFunction(LOG_INFO, "a.cpp", 2, "%d\n", cnt);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_LT(elapsed.count(), 1000);
+  EXPECT_GE(AsyncLogGetDroppedNum() - droppedBefore, 100u);
+
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_blockSink = false;
+  }
+  g_cond.notify_all();
+  flusher.join();
+  AsyncLogFlush();
+}
+
+TEST_F(AsyncLogTest, DisabledLevelsCompiledOut) {
+  LogFunction oldCallBack = logCallBack;
+  logCallBack = AsyncLogFunction;
+  int32_t evaluated = 0;
+  OMAF_LOG(LOG_INFO, "info %d\n", ++evaluated);
+  OMAF_LOG(LOG_WARNING, "warning %d\n", ++evaluated);
+  if (evaluated) OMAF_LOG(LOG_ERROR, "error %d\n", ++evaluated);
+  AsyncLogFlush();
+  logCallBack = oldCallBack;
+
+  // arguments of eliminated log calls are never evaluated
+  EXPECT_EQ(evaluated, 2);
+  std::lock_guard<std::mutex> lock(g_mutex);
+  ASSERT_EQ(g_messages.size(), 2u);
+  EXPECT_EQ(g_messages[0].msg, "warning 1");
+  EXPECT_EQ(g_messages[0].file, "testAsyncLog.cpp");
+  EXPECT_EQ(g_messages[1].msg, "error 2");
+}
+
+TEST_F(AsyncLogTest, HotPathPerf) {
+  AsyncLogSetSink(CountSink);
+  const int32_t rounds = 200;
+  const int32_t batch = ASYNC_LOG_RING_SIZE / 2;
+  const char *str = "viewport";
+  uint64_t droppedBefore = AsyncLogGetDroppedNum();
+  uint64_t asyncNs = 0;
+  uint64_t syncNs = 0;
+  char msg[ASYNC_LOG_MSG_SIZE];
+
+  for (int32_t round = 0; round < rounds; round++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t cnt = 0; cnt < batch; cnt++) {
+      AsyncLogFunction(LOG_INFO, "p.cpp", 1, "Segment %d of %s download %lu bytes in %f ms\n", cnt, str,
+                       (unsigned long)(cnt * 1024), 1.5);
+    }
+    asyncNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    // consumer is not part of the hot path
+    AsyncLogFlush();
+
+    // synchronous formatting which every synchronous backend pays at least
+    start = std::chrono::steady_clock::now();
+    for (int32_t cnt = 0; cnt < batch; cnt++) {
+      snprintf(msg, sizeof(msg), "Segment %d of %s download %lu bytes in %f ms\n", cnt, str,
+               (unsigned long)(cnt * 1024), 1.5);
+      CountSink(LOG_INFO, "p.cpp", 1, NowUs(), 0, msg);
+    }
+    syncNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  uint64_t calls = (uint64_t)rounds * batch;
+  EXPECT_EQ(AsyncLogGetDroppedNum(), droppedBefore);
+  EXPECT_EQ(g_sinkCount.load(), calls * 2);
+  printf("async log: %.1f ns per call, synchronous format: %.1f ns per call\n", (double)asyncNs / calls,
+         (double)syncNs / calls);
+}
+// keep it last, the logger can't be restarted after shutdown
+TEST_F(AsyncLogTest, ShutdownOutputsSynchronously) {
+  AsyncLogFunction(LOG_INFO, "a.cpp", 1, "queued\n");
+  AsyncLogShutdown();
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    ASSERT_EQ(g_messages.size(), 1u);
+    EXPECT_EQ(g_messages[0].msg, "queued");
+  }
+
+  AsyncLogFunction(LOG_INFO, "a.cpp", 2, "after %d\n", 1);
+  std::lock_guard<std::mutex> lock(g_mutex);
+  ASSERT_EQ(g_messages.size(), 2u);
+  EXPECT_EQ(g_messages[1].msg, "after 1");
+  EXPECT_EQ(g_messages[1].tid, (uint32_t)syscall(SYS_gettid));
+}
+}  // namespace
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testDownloadCache.cpp
+//! \brief:  url keyed segment cache of DownloadManager unit test
+//!
+
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../DownloadManager.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+class DownloadCacheTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    m_manager = new DownloadManager;
+    m_manager->SetMaxCacheSize(3000);
+  }
+
+  virtual void TearDown() {
+    for (uint32_t i = 0; i < 10; i++) {
+      remove(fileName(i).c_str());
+    }
+    delete m_manager;
+  }
+
+  std::string url(uint32_t id) { return "http://127.0.0.1:8080/test/Test_track1." + std::to_string(id) + ".mp4"; }
+
+  std::string fileName(uint32_t id) { return "./download_cache_test_" + std::to_string(id) + ".mp4"; }
+
+  // write a segment file of 1000 bytes and add it to cache
+  void cacheSegment(uint32_t id) {
+    FILE *fp = fopen(fileName(id).c_str(), "wb");
+    ASSERT_TRUE(fp != NULL);
+    std::string content(1000, 'a' + id);
+    fwrite(content.data(), 1, content.size(), fp);
+    fclose(fp);
+    EXPECT_TRUE(m_manager->InsertCache(url(id), fileName(id), content.size()) == ERROR_NONE);
+  }
+
+  bool fileExists(uint32_t id) { return access(fileName(id).c_str(), F_OK) == 0; }
+
+  DownloadManager *m_manager;
+};
+
+TEST_F(DownloadCacheTest, LookupByUrl) {
+  std::string cacheFile;
+  EXPECT_FALSE(m_manager->LookupCache(url(1), cacheFile));
+  cacheSegment(1);
+  EXPECT_TRUE(m_manager->IsCached(url(1)));
+  EXPECT_FALSE(m_manager->IsCached(url(2)));
+  EXPECT_TRUE(m_manager->LookupCache(url(1), cacheFile));
+  EXPECT_TRUE(cacheFile == fileName(1));
+  m_manager->ReleaseCacheFile(url(1));
+
+  uint64_t hits = 0, misses = 0, savedBytes = 0;
+  m_manager->GetCacheStatistics(hits, misses, savedBytes);
+  EXPECT_TRUE(hits == 1);
+  EXPECT_TRUE(misses == 1);
+  EXPECT_TRUE(savedBytes == 1000);
+  EXPECT_TRUE(m_manager->GetCachedSize() == 1000);
+}
+
+TEST_F(DownloadCacheTest, EvictLeastRecentlyUsed) {
+  std::string cacheFile;
+  cacheSegment(1);
+  cacheSegment(2);
+  cacheSegment(3);
+  // segment 1 becomes the most recently used one
+  EXPECT_TRUE(m_manager->LookupCache(url(1), cacheFile));
+  m_manager->ReleaseCacheFile(url(1));
+
+  cacheSegment(4);
+  EXPECT_TRUE(m_manager->GetCachedSize() == 3000);
+  EXPECT_FALSE(m_manager->IsCached(url(2)));
+  EXPECT_FALSE(fileExists(2));
+  EXPECT_TRUE(m_manager->IsCached(url(1)));
+  EXPECT_TRUE(m_manager->IsCached(url(3)));
+  EXPECT_TRUE(m_manager->IsCached(url(4)));
+
+  cacheSegment(5);
+  EXPECT_FALSE(m_manager->IsCached(url(3)));
+  EXPECT_FALSE(fileExists(3));
+  EXPECT_TRUE(fileExists(1));
+}
+
+TEST_F(DownloadCacheTest, PinnedFileIsKept) {
+  std::string cacheFile;
+  cacheSegment(1);
+  cacheSegment(2);
+  cacheSegment(3);
+  // segment 1 is in reading but the least recently used one after segment 2 and 3 are read
+  EXPECT_TRUE(m_manager->LookupCache(url(1), cacheFile));
+  EXPECT_TRUE(m_manager->LookupCache(url(2), cacheFile));
+  EXPECT_TRUE(m_manager->LookupCache(url(3), cacheFile));
+  m_manager->ReleaseCacheFile(url(2));
+  m_manager->ReleaseCacheFile(url(3));
+
+  cacheSegment(4);
+  EXPECT_TRUE(m_manager->IsCached(url(1)));
+  EXPECT_TRUE(fileExists(1));
+  EXPECT_FALSE(m_manager->IsCached(url(2)));
+
+  // over size because of pinned file
+  m_manager->SetMaxCacheSize(2000);
+  cacheSegment(5);
+  EXPECT_TRUE(m_manager->IsCached(url(1)));
+  EXPECT_TRUE(m_manager->GetCachedSize() == 2000);
+
+  // evicted once it is released
+  m_manager->SetMaxCacheSize(1000);
+  m_manager->ReleaseCacheFile(url(1));
+  EXPECT_FALSE(m_manager->IsCached(url(1)));
+  EXPECT_FALSE(fileExists(1));
+  EXPECT_TRUE(m_manager->GetCachedSize() == 1000);
+  EXPECT_TRUE(m_manager->IsCached(url(5)));
+}
+
+TEST_F(DownloadCacheTest, DuplicatedUrl) {
+  cacheSegment(1);
+  // the same url cached again by another download
+  FILE *fp = fopen(fileName(2).c_str(), "wb");
+  ASSERT_TRUE(fp != NULL);
+  fclose(fp);
+  EXPECT_TRUE(m_manager->InsertCache(url(1), fileName(2), 1000) == ERROR_NONE);
+  EXPECT_FALSE(fileExists(2));
+  EXPECT_TRUE(fileExists(1));
+  EXPECT_TRUE(m_manager->GetCachedSize() == 1000);
+
+  std::string cacheFile;
+  EXPECT_TRUE(m_manager->LookupCache(url(1), cacheFile));
+  EXPECT_TRUE(cacheFile == fileName(1));
+  m_manager->ReleaseCacheFile(url(1));
+}
+
+TEST_F(DownloadCacheTest, CacheTasksOffCallerThread) {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<uint32_t> order;
+  std::thread::id caller = std::this_thread::get_id();
+  bool onCaller = false;
+  const uint32_t taskNum = 5;
+  for (uint32_t id = 0; id < taskNum; id++) {
+    EXPECT_TRUE(m_manager->PostCacheTask([&, id]() {
+      cacheSegment(id);
+      std::lock_guard<std::mutex> lock(mutex);
+      onCaller |= (std::this_thread::get_id() == caller);
+      order.push_back(id);
+      cond.notify_one();
+    }));
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  EXPECT_TRUE(cond.wait_for(lock, std::chrono::seconds(5), [&]() { return order.size() == taskNum; }));
+  EXPECT_FALSE(onCaller);
+  for (uint32_t id = 0; id < order.size(); id++) {
+    EXPECT_TRUE(order[id] == id);
+  }
+  EXPECT_TRUE(m_manager->IsCached(url(taskNum - 1)));
+}
+}  // namespace
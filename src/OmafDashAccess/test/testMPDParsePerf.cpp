@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testMPDParsePerf.cpp
+//! \brief:  streaming MPD parser correctness and startup performance test
+//!
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "../../utils/tinyxml2.h"
+#include "../OmafDashParser/OmafMPDReader.h"
+#include "../OmafDashParser/OmafXMLParser.h"
+#include "../OmafDashParser/OmafXMLStreamParser.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+class MPDParsePerfTest : public testing::Test {
+ public:
+  virtual void SetUp() { m_content = GenerateMPD(500); }
+
+  virtual void TearDown() {}
+
+  // an 8K static mpd with one main AdaptationSet and tileNum tile AdaptationSets,
+  // each carrying srd, rwpk and region quality descriptors
+  static std::string GenerateMPD(int tileNum) {
+    std::string mpd =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- synthetic 8K tiled mpd -->\n"
+        "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" xmlns:omaf=\"urn:mpeg:mpegI:omaf:2017\" "
+        "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" minBufferTime=\"PT2S\" "
+        "profiles=\"urn:mpeg:dash:profile:full:2011\" type=\"static\" "
+        "mediaPresentationDuration=\"PT0H1M0.000S\" maxSegmentDuration=\"PT1S\">\n"
+        "  <EssentialProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:pf\" omaf:projection_type=\"0\"/>\n"
+        "  <BaseURL>http://127.0.0.1:8080/8k/</BaseURL>\n"
+        "  <Period start=\"PT0S\" id=\"0\">\n";
+    for (int i = 0; i <= tileNum; i++) {
+      std::string id = std::to_string(i);
+      std::string x = std::to_string((i % 40) * 192);
+      std::string y = std::to_string((i / 40 % 10) * 384);
+      mpd += "    <AdaptationSet id=\"" + id +
+             "\" mimeType=\"video/mp4\" codecs=\"resv.podv+ercm.hvc1.2.4.L153.B0\" maxWidth=\"7680\" "
+             "maxHeight=\"3840\" maxFrameRate=\"30\" segmentAlignment=\"true\" subsegmentAlignment=\"true\">\n"
+             "      <Viewport schemeIdUri=\"urn:mpeg:dash:viewpoint:2011\" value=\"vpl\"/>\n"
+             "      <EssentialProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:rwpk\" omaf:packing_type=\"0\"/>\n"
+             "      <SupplementalProperty schemeIdUri=\"urn:mpeg:dash:srd:2014\" value=\"0," + x + "," + y +
+             ",192,384,7680,3840\"/>\n"
+             "      <SupplementalProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:srqr\">\n"
+             "        <omaf:sphRegionQuality shape_type=\"0\" remaining_area_flag=\"false\" "
+             "quality_ranking_local_flag=\"false\" quality_type=\"0\">\n"
+             "          <omaf:qualityInfo quality_ranking=\"1\" orig_width=\"7680\" orig_height=\"3840\" "
+             "centre_azimuth=\"" + std::to_string(i * 7 % 360) + "\" centre_elevation=\"0\" centre_tilt=\"0\" "
+             "azimuth_range=\"9\" elevation_range=\"18\"/>\n"
+             "          <omaf:qualityInfo quality_ranking=\"2\" orig_width=\"3840\" orig_height=\"1920\" "
+             "centre_azimuth=\"0\" centre_elevation=\"0\" centre_tilt=\"0\" azimuth_range=\"9\" "
+             "elevation_range=\"18\"/>\n"
+             "        </omaf:sphRegionQuality>\n"
+             "      </SupplementalProperty>\n"
+             "      <SupplementalProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:2dqr\">\n"
+             "        <omaf:twoDRegionQuality>\n"
+             "          <omaf:qualityInfo quality_ranking=\"1\" orig_width=\"7680\" orig_height=\"3840\" "
+             "region_width=\"192\" region_height=\"384\"/>\n"
+             "        </omaf:twoDRegionQuality>\n"
+             "      </SupplementalProperty>\n"
+             "      <Representation id=\"Test_track" + id + "\" qualityRanking=\"1\" bandwidth=\"520785\" "
+             "width=\"192\" height=\"384\" frameRate=\"30/1\" sar=\"1:1\" startWithSAP=\"1\">\n"
+             "        <SegmentTemplate media=\"Test_track" + id + ".$Number$.mp4\" initialization=\"Test_track" +
+             id + ".init.mp4\" duration=\"30000\" startNumber=\"1\" timescale=\"30000\"/>\n"
+             "      </Representation>\n"
+             "    </AdaptationSet>\n";
+    }
+    mpd += "  </Period>\n</MPD>\n";
+    return mpd;
+  }
+
+  // the XML tree built as before, tinyxml2 DOM copied into OMAF XML elements
+  static OmafXMLElement* BuildTreeWithDOM(tinyxml2::XMLElement* elmt, const std::string& path) {
+    OmafXMLElement* element = new OmafXMLElement();
+    element->SetName(elmt->Value());
+    element->SetPath(path);
+    if (elmt->GetText()) element->SetText(elmt->GetText());
+    for (const tinyxml2::XMLAttribute* attr = elmt->FirstAttribute(); attr; attr = attr->Next()) {
+      element->AddAttribute(attr->Name(), attr->Value());
+    }
+    for (tinyxml2::XMLElement* child = elmt->FirstChildElement(); child; child = child->NextSiblingElement()) {
+      element->AddChildElement(BuildTreeWithDOM(child, path));
+    }
+    return element;
+  }
+
+  static bool SameTree(OmafXMLElement* a, OmafXMLElement* b) {
+    if (a->GetName() != b->GetName() || a->GetText() != b->GetText() || a->GetPath() != b->GetPath() ||
+        a->GetAttributes() != b->GetAttributes() || a->GetChildElements().size() != b->GetChildElements().size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a->GetChildElements().size(); i++) {
+      if (!SameTree(a->GetChildElements()[i], b->GetChildElements()[i])) return false;
+    }
+    return true;
+  }
+
+  std::string m_content;
+};
+
+TEST_F(MPDParsePerfTest, SameTreeAsDOM) {
+  OmafXMLStreamParser parser;
+  OmafXMLElement* root = parser.Parse(m_content.c_str(), m_content.size(), "http://127.0.0.1:8080/8k");
+  ASSERT_TRUE(root != nullptr);
+
+  tinyxml2::XMLDocument doc;
+  ASSERT_TRUE(doc.Parse(m_content.c_str(), m_content.size()) == tinyxml2::XML_SUCCESS);
+  OmafXMLElement* domRoot = BuildTreeWithDOM(doc.FirstChildElement(), "http://127.0.0.1:8080/8k");
+  EXPECT_TRUE(SameTree(root, domRoot));
+  EXPECT_TRUE(root->GetChildElements()[1]->GetText() == "http://127.0.0.1:8080/8k/");
+
+  delete root;
+  delete domRoot;
+}
+
+TEST_F(MPDParsePerfTest, TextAndMarkups) {
+  std::string content =
+      "\xEF\xBB\xBF<?xml version=\"1.0\"?>\r\n<!DOCTYPE MPD [ <!ENTITY e \"x\"> ]>\n"
+      "<MPD a='1 &amp; 2' b=\"&lt;&#65;&#x42;&gt;\" c=\"&unknown;\">\n"
+      "  <BaseURL>  http://a/b?x=1&amp;y=2\r\n</BaseURL>\n"
+      "  <Data><![CDATA[<raw> & text]]></Data>\n"
+      "  <Note><!-- comment -->text after comment</Note>\n"
+      "  <Empty   />\n"
+      "</MPD>\n";
+  OmafXMLStreamParser parser;
+  OmafXMLElement* root = parser.Parse(content.c_str(), content.size(), "path");
+  ASSERT_TRUE(root != nullptr);
+  EXPECT_TRUE(root->GetAttributeVal("a") == "1 & 2");
+  EXPECT_TRUE(root->GetAttributeVal("b") == "<AB>");
+  EXPECT_TRUE(root->GetAttributeVal("c") == "&unknown;");
+  EXPECT_TRUE(root->GetAttributeVal("d").empty());
+  ASSERT_TRUE(root->GetChildElements().size() == 4);
+  EXPECT_TRUE(root->GetChildElements()[0]->GetText() == "http://a/b?x=1&y=2\n");
+  EXPECT_TRUE(root->GetChildElements()[1]->GetText() == "<raw> & text");
+  EXPECT_TRUE(root->GetChildElements()[2]->GetText().empty());
+  EXPECT_TRUE(root->GetChildElements()[3]->GetName() == "Empty");
+  EXPECT_TRUE(root->GetChildElements()[3]->GetPath() == "path");
+  delete root;
+
+  const char* malformed[] = {"<MPD>", "<MPD></Period>", "<MPD a=1/>", "<MPD/><MPD/>", "<MPD><!-- </MPD>", "text", ""};
+  for (auto xml : malformed) {
+    EXPECT_TRUE(parser.Parse(xml, strlen(xml), "") == nullptr);
+  }
+}
+
+TEST_F(MPDParsePerfTest, StartupCost) {
+  const int loopNum = 20;
+  const std::string url = "http://127.0.0.1:8080/8k/Test.mpd";
+  const std::string path = "http://127.0.0.1:8080/8k";
+
+  // tinyxml2 DOM, the copied XML tree, then MPD elements
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loopNum; i++) {
+    tinyxml2::XMLDocument doc;
+    ASSERT_TRUE(doc.Parse(m_content.c_str(), m_content.size()) == tinyxml2::XML_SUCCESS);
+    OmafMPDReader reader(BuildTreeWithDOM(doc.FirstChildElement(), path));
+    EXPECT_TRUE(reader.BuildMPD() == OD_STATUS_SUCCESS);
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  double domCost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (double)loopNum;
+
+  // streaming XML tree, then MPD elements
+  size_t adaptationSetNum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loopNum; i++) {
+    OmafXMLParser parser;
+    ASSERT_TRUE(parser.GenerateFromBuffer(url, m_content) == OD_STATUS_SUCCESS);
+    MPDElement* mpd = parser.GetGeneratedMPD();
+    ASSERT_TRUE(mpd != nullptr);
+    adaptationSetNum = mpd->GetPeriods()[0]->GetAdaptationSets().size();
+  }
+  end = std::chrono::steady_clock::now();
+  double streamCost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (double)loopNum;
+
+  EXPECT_TRUE(adaptationSetNum == 501);
+  printf("MPD of %zu bytes with %zu AdaptationSets: DOM %f ms, streaming %f ms\n", m_content.size(),
+         adaptationSetNum, domCost / 1000, streamCost / 1000);
+}
+}  // namespace
@@ -25,6 +25,7 @@
  */
 
 #include "gtest/gtest.h"
+#include <fstream>
 #include <string>
 #include "../OmafMPDParser.h"
 
@@ -39,6 +40,7 @@ public:
         url_static = "http://10.67.115.92:8080/testOMAFstatic/Test.mpd";
         url_cmaf_live = "http://10.67.115.92:8080/testCMAFlive/Test.mpd";
         url_static_free_view = "http://10.67.115.92:8080/testIINVstatic/Test.mpd";
+        url_local_live = "./local_live_Test.mpd";
     }
 
     virtual void TearDown(){
@@ -48,8 +50,58 @@ public:
     std::string url_static;
     std::string url_static_free_view;
     std::string url_cmaf_live;
+    std::string url_local_live;
 };
 
+// write a dynamic mpd with main AdaptationSet and two tile tracks, as the live
+// mpd refreshed by server
+static bool WriteLiveMPD(const std::string& fileName, int32_t startNumber, int32_t updatePeriod)
+{
+    std::string period = std::to_string(updatePeriod);
+    std::string number = std::to_string(startNumber);
+    std::string mpd =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<MPD xmlns:omaf=\"urn:mpeg:mpegI:omaf:2017\" xmlns=\"urn:mpeg:dash:schema:mpd:2011\" "
+        "minBufferTime=\"PT1.000000S\" maxSegmentDuration=\"PT1.000000S\" "
+        "profiles=\"urn:mpeg:dash:profile:isoff-live:2011\" type=\"dynamic\" "
+        "availabilityStartTime=\"2020-06-01T08:00:00Z\" publishTime=\"2020-06-01T08:00:" + number + "Z\" "
+        "minimumUpdatePeriod=\"PT" + period + "S\" timeShiftBufferDepth=\"PT5S\">\n"
+        "<EssentialProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:pf\" omaf:projection_type=\"0\"/>\n"
+        "<Period start=\"PT0S\" id=\"0\">\n"
+        "<AdaptationSet id=\"0\" mimeType=\"video/mp4\" codecs=\"resv.podv+ercm.hvc1.2.4.L90.80\" "
+        "segmentAlignment=\"1\" maxWidth=\"1920\" maxHeight=\"960\" gopSize=\"25\" bitstreamSwitching=\"false\">\n"
+        "<Viewport schemeIdUri=\"urn:mpeg:dash:viewpoint:2011\" value=\"vpl\"/>\n"
+        "<EssentialProperty schemeIdUri=\"urn:mpeg:dash:srd:2014\" value=\"1,0,0,0,0\"/>\n"
+        "<Representation id=\"0\" mimeType=\"video/mp4\" codecs=\"resv.podv+ercm.hvc1.2.4.L90.80\" width=\"1920\" "
+        "height=\"960\" frameRate=\"25/1\" sar=\"1:1\" startWithSAP=\"1\">\n"
+        "<SegmentTemplate timescale=\"25000\" duration=\"25000\" media=\"track0_$Number$.m4s\" startNumber=\"1\"/>\n"
+        "</Representation>\n"
+        "</AdaptationSet>\n";
+    for (int i = 1; i <= 2; i++)
+    {
+        std::string id = std::to_string(i);
+        std::string x = std::to_string((i - 1) * 960);
+        mpd +=
+            "<AdaptationSet id=\"" + id + "\" mimeType=\"video/mp4\" codecs=\"resv.podv+ercm.hvc1.2.4.L90.80\" "
+            "maxWidth=\"960\" maxHeight=\"960\" maxFramerate=\"25/1\" segmentAlignment=\"1\" subsegmentAlignment=\"1\">\n"
+            "<Viewport schemeIdUri=\"urn:mpeg:dash:viewpoint:2011\" value=\"vpl\"/>\n"
+            "<SupplementalProperty schemeIdUri=\"urn:mpeg:dash:srd:2014\" value=\"1," + x + ",0,960,960\"/>\n"
+            "<EssentialProperty schemeIdUri=\"urn:mpeg:mpegI:omaf:2017:rwpk\" omaf:packing_type=\"0\"/>\n"
+            "<Representation id=\"Test_track" + id + "\" qualityRanking=\"1\" bandwidth=\"520785\" width=\"960\" "
+            "height=\"960\" frameRate=\"25/1\" sar=\"1:1\" startWithSAP=\"1\">\n"
+            "<SegmentTemplate media=\"Test_track" + id + ".$Number$.mp4\" initialization=\"Test_track" + id + ".init.mp4\" "
+            "duration=\"25000\" startNumber=\"" + number + "\" timescale=\"25000\"/>\n"
+            "</Representation>\n"
+            "</AdaptationSet>\n";
+    }
+    mpd += "</Period>\n</MPD>\n";
+
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file << mpd;
+    return file.good();
+}
+
 TEST_F(MPDParserTest, Create)
 {
     OmafMPDParser* MPDParser = new OmafMPDParser();
@@ -158,4 +210,57 @@ TEST_F(MPDParserTest, ParseMPD_cmaf_live)
     delete MPDParser;
 }
 
+TEST_F(MPDParserTest, UpdateMPD_local_live)
+{
+    ASSERT_TRUE(WriteLiveMPD(url_local_live, 10, 2));
+
+    OmafMPDParser* MPDParser = new OmafMPDParser();
+    EXPECT_TRUE(MPDParser != NULL);
+    OmafDashParams params;
+    params.enable_in_time_viewport_update = false;
+    params.max_response_times_in_seg = 0;
+    MPDParser->SetOmafDashParams(params);
+
+    OMAFSTREAMS listStream;
+    int ret = MPDParser->ParseMPD(url_local_live, listStream);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    ASSERT_TRUE(listStream.size() > 0);
+
+    MPDInfo *mpdInfo = MPDParser->GetMPDInfo();
+    ASSERT_TRUE(mpdInfo != nullptr);
+    EXPECT_TRUE(mpdInfo->type == "dynamic");
+    EXPECT_TRUE(mpdInfo->minimum_update_period == 2000);
+
+    auto stream = listStream.front();
+    std::map<int, OmafAdaptationSet*> adaptationSets = stream->GetMediaAdaptationSet();
+    ASSERT_TRUE(adaptationSets.size() == 2);
+    for (auto as : adaptationSets)
+    {
+        if (as.first == 0) continue;
+        EXPECT_TRUE(as.second->GetStartNumber() == 10);
+        EXPECT_TRUE(as.second->GetSegmentDuration() == 1);
+    }
+
+    // server refreshes the mpd with a new start number and update period
+    ASSERT_TRUE(WriteLiveMPD(url_local_live, 25, 4));
+    ret = MPDParser->UpdateMPD(listStream);
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    // same MPDInfo and AdaptationSets are patched in place
+    EXPECT_TRUE(MPDParser->GetMPDInfo() == mpdInfo);
+    EXPECT_TRUE(mpdInfo->minimum_update_period == 4000);
+    std::map<int, OmafAdaptationSet*> updatedSets = stream->GetMediaAdaptationSet();
+    ASSERT_TRUE(updatedSets.size() == 2);
+    for (auto as : updatedSets)
+    {
+        if (as.first == 0) continue;
+        EXPECT_TRUE(as.second == adaptationSets[as.first]);
+        EXPECT_TRUE(as.second->GetStartNumber() == 25);
+        EXPECT_TRUE(as.second->GetSegmentDuration() == 1);
+    }
+
+    delete MPDParser;
+    remove(url_local_live.c_str());
+}
+
 }
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testMappedFilePerf.cpp
+//! \brief:  memory mapped local segment file correctness and throughput test
+//!
+
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../OmafMappedFile.h"
+#include "testSegmentLoader.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+//!
+//! \brief  the stream used by the stored segment file after mapping
+//!
+class MappedFile : public OmafMappedFile {
+ public:
+  MappedFile(const std::string &fileName) { EXPECT_TRUE(Open(fileName)); }
+};
+
+class MappedFilePerfTest : public testing::Test {
+ public:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  // parse the tile track segments and read all samples, return the bytes of samples
+  template <typename T>
+  uint64_t readSegments(std::vector<char> &lastSample) {
+    VCD::MP4::Mp4Reader reader;
+    uint64_t totalSize = 0;
+    EXPECT_TRUE(LoadReaderTestSegments(
+        reader, [](const char *fileName) -> VCD::MP4::StreamIO * { return new T(fileName); }, false));
+
+    VCD::MP4::VarLenArray<VCD::MP4::TrackInformation> trackInfos;
+    reader.GetTrackInformations(trackInfos);
+    for (size_t i = 0; i < trackInfos.size; i++) {
+      for (size_t j = 0; j < trackInfos[i].sampleProperties.size; j++) {
+        uint32_t sampleId = trackInfos[i].sampleProperties[j].sampleId;
+        uint64_t offset = 0;
+        uint32_t size = 0;
+        if (reader.GetSampOffset(trackInfos[i].trackId, sampleId, offset, size) != ERROR_NONE) continue;
+        lastSample.resize(size);
+        EXPECT_TRUE(reader.GetSampData(trackInfos[i].trackId, sampleId, lastSample.data(), size, false) ==
+                    ERROR_NONE);
+        totalSize += size;
+      }
+    }
+    return totalSize;
+  }
+};
+
+TEST_F(MappedFilePerfTest, ReadAndView) {
+  const char *fileName = "./mapped_file_test.bin";
+  std::vector<char> content(100000);
+  for (size_t i = 0; i < content.size(); i++) content[i] = static_cast<char>(i & 0xff);
+  FILE *fp = fopen(fileName, "wb");
+  ASSERT_TRUE(fp != NULL);
+  fwrite(content.data(), 1, content.size(), fp);
+  fclose(fp);
+
+  OmafMappedFile file;
+  EXPECT_FALSE(file.Open("./not_exist_file.bin"));
+  EXPECT_FALSE(OmafMappedFile::Prefetch("./not_exist_file.bin"));
+  EXPECT_TRUE(OmafMappedFile::Prefetch(fileName));
+  ASSERT_TRUE(file.Open(fileName));
+  EXPECT_TRUE(file.GetStreamSize() == (int64_t)content.size());
+
+  char buf[1000];
+  EXPECT_TRUE(file.ReadStream(buf, 1000) == 1000);
+  EXPECT_TRUE(memcmp(buf, content.data(), 1000) == 0);
+  EXPECT_TRUE(file.TellOffset() == 1000);
+
+  // views don't move the offset
+  const char *view = file.GetDataView(5000, 200);
+  ASSERT_TRUE(view != nullptr);
+  EXPECT_TRUE(memcmp(view, content.data() + 5000, 200) == 0);
+  EXPECT_TRUE(file.TellOffset() == 1000);
+  EXPECT_TRUE(file.GetDataView(content.size() - 10, 20) == nullptr);
+
+  // reads stop at the end of file
+  EXPECT_TRUE(file.SeekAbsoluteOffset(content.size() - 100));
+  EXPECT_TRUE(file.ReadStream(buf, 1000) == 100);
+  EXPECT_TRUE(memcmp(buf, content.data() + content.size() - 100, 100) == 0);
+  EXPECT_TRUE(file.ReadStream(buf, 1000) == 0);
+  EXPECT_FALSE(file.SeekAbsoluteOffset(content.size() + 1));
+
+  file.Close();
+  EXPECT_FALSE(file.IsOpen());
+  EXPECT_TRUE(file.ReadStream(buf, 10) == 0);
+  remove(fileName);
+}
+
+TEST_F(MappedFilePerfTest, ThroughputAgainstIfstream) {
+  const uint32_t loopNum = 5;
+  std::vector<char> fileSample;
+  std::vector<char> mappedSample;
+
+  // warm up the page cache, so both paths read from memory
+  uint64_t totalSize = readSegments<SegmentFileStream>(fileSample);
+  ASSERT_TRUE(totalSize > 0);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < loopNum; i++) {
+    EXPECT_TRUE(readSegments<SegmentFileStream>(fileSample) == totalSize);
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  double fileCost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (double)loopNum;
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < loopNum; i++) {
+    EXPECT_TRUE(readSegments<MappedFile>(mappedSample) == totalSize);
+  }
+  end = std::chrono::steady_clock::now();
+  double mappedCost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (double)loopNum;
+
+  EXPECT_TRUE(fileSample == mappedSample);
+  printf("Samples %lu bytes: ifstream %f us (%f MB/s), mmap %f us (%f MB/s)\n", totalSize, fileCost,
+         totalSize / fileCost, mappedCost, totalSize / mappedCost);
+}
+}  // namespace
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testMediaPacket.cpp
+//! \brief:  MediaPacket payload and packet pool unit test
+//!
+
+#include <algorithm>
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "../MediaPacket.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+class MediaPacketTest : public testing::Test {
+ public:
+  virtual void SetUp() { PACKETPOOL::GetInstance()->Shrink(); }
+
+  virtual void TearDown() { PACKETPOOL::GetInstance()->Shrink(); }
+};
+
+TEST_F(MediaPacketTest, InsertParamsInHeadroom) {
+  std::vector<uint8_t> params = {0, 0, 0, 1, 0x40, 0x01, 0, 0, 0, 1, 0x42, 0x01};
+  const char payload[] = "sample payload";
+
+  MediaPacket *packet = new MediaPacket();
+  EXPECT_TRUE(packet->ReAllocatePacket(1000, params.size()) == 1000);
+  char *data = packet->Payload();
+  memcpy(data, payload, sizeof(payload));
+  packet->SetRealSize(sizeof(payload));
+
+  packet->InsertParams(params);
+  // the params are written in the headroom, no payload is moved
+  EXPECT_TRUE(packet->Payload() + params.size() == data);
+  EXPECT_TRUE(packet->Size() == params.size() + sizeof(payload));
+  EXPECT_TRUE(memcmp(packet->Payload(), params.data(), params.size()) == 0);
+  EXPECT_TRUE(memcmp(packet->Payload() + params.size(), payload, sizeof(payload)) == 0);
+
+  // the moved payload starts at the buffer begin, and is freed by free()
+  char *buf = packet->MovePayload();
+  EXPECT_TRUE(buf != nullptr);
+  EXPECT_TRUE(memcmp(buf, params.data(), params.size()) == 0);
+  EXPECT_TRUE(packet->Size() == params.size() + sizeof(payload));
+  free(buf);
+  delete packet;
+
+  PacketPoolStatistics stats = PACKETPOOL::GetInstance()->GetStatistics();
+  EXPECT_TRUE(stats.in_use_bytes_ == 0);
+  EXPECT_TRUE(stats.cached_bytes_ == 0);
+}
+
+TEST_F(MediaPacketTest, InsertParamsWithoutHeadroom) {
+  std::vector<uint8_t> params(64, 0x5a);
+  std::vector<char> payload(1024, 0x11);
+
+  MediaPacket *packet = new MediaPacket();
+  packet->ReAllocatePacket(payload.size());
+  memcpy(packet->Payload(), payload.data(), payload.size());
+  packet->SetRealSize(payload.size());
+
+  packet->InsertParams(params);
+  EXPECT_TRUE(packet->Size() == params.size() + payload.size());
+  EXPECT_TRUE(memcmp(packet->Payload(), params.data(), params.size()) == 0);
+  EXPECT_TRUE(memcmp(packet->Payload() + params.size(), payload.data(), payload.size()) == 0);
+
+  // unused headroom is dropped when the payload moves out
+  MediaPacket *packet2 = new MediaPacket();
+  packet2->ReAllocatePacket(payload.size(), params.size());
+  memcpy(packet2->Payload(), payload.data(), payload.size());
+  packet2->SetRealSize(payload.size());
+  char *buf = packet2->MovePayload();
+  EXPECT_TRUE(memcmp(buf, payload.data(), payload.size()) == 0);
+  free(buf);
+
+  delete packet;
+  delete packet2;
+}
+
+TEST_F(MediaPacketTest, PoolRecycle) {
+  const size_t packetNum = 100;
+  const size_t packetSize = 3840 * 1920 * 3 / 4;
+  PacketPoolStatistics before = PACKETPOOL::GetInstance()->GetStatistics();
+
+  for (size_t i = 0; i < packetNum; i++) {
+    MediaPacket *packet = new MediaPacket();
+    packet->ReAllocatePacket(packetSize, 128);
+    delete packet;
+  }
+
+  PacketPoolStatistics stats = PACKETPOOL::GetInstance()->GetStatistics();
+  printf("%s\n", stats.to_string().c_str());
+  EXPECT_TRUE(stats.acquire_count_ - before.acquire_count_ == packetNum);
+  EXPECT_TRUE(stats.hit_count_ - before.hit_count_ == packetNum - 1);
+  EXPECT_TRUE(stats.in_use_bytes_ == 0);
+  EXPECT_TRUE(stats.peak_bytes_ >= packetSize);
+  EXPECT_TRUE(stats.peak_bytes_ <= 2 * (packetSize + 128));
+}
+TEST_F(MediaPacketTest, PoolSizeClassWaste) {
+  // one 8K packet, 7680x4320 with the packet size estimation of the reader
+  const size_t packet8K = 7680 * 4320 * 3 / 4;
+  const std::vector<size_t> sizes = {1, 1024, 1025, 4000, 100 * 1000, 3840 * 1920 * 3 / 4, packet8K,
+                                     (static_cast<size_t>(1) << PACKET_POOL_MAX_CLASS_SHIFT) + 1};
+
+  for (auto size : sizes) {
+    size_t capacity = 0;
+    char *buf = PACKETPOOL::GetInstance()->Acquire(size, capacity);
+    EXPECT_TRUE(buf != nullptr);
+    EXPECT_TRUE(capacity >= size);
+    EXPECT_TRUE(capacity <= std::max(size + size / 4, static_cast<size_t>(1) << PACKET_POOL_MIN_CLASS_SHIFT));
+    PACKETPOOL::GetInstance()->Release(buf, capacity);
+  }
+
+  // the 8K packet takes the 24MB class instead of 32MB
+  size_t capacity = 0;
+  char *buf = PACKETPOOL::GetInstance()->Acquire(packet8K, capacity);
+  EXPECT_TRUE(capacity == 24 * 1024 * 1024);
+  PACKETPOOL::GetInstance()->Release(buf, capacity);
+  PACKETPOOL::GetInstance()->Shrink();
+}
+
+TEST_F(MediaPacketTest, SharePayloadWithPadding) {
+  std::vector<uint8_t> params(32, 0x5a);
+  std::vector<char> payload(4096, 0x11);
+
+  MediaPacket *packet = new MediaPacket();
+  packet->ReAllocatePacket(payload.size(), params.size() + 16);
+  memcpy(packet->Payload(), payload.data(), payload.size());
+  packet->SetRealSize(payload.size());
+  packet->InsertParams(params);
+  char *data = packet->Payload();
+
+  // the payload is shared in place, the unused headroom is not dropped
+  void *opaque = nullptr;
+  char *buf = packet->SharePayload(&opaque);
+  EXPECT_TRUE(buf == data);
+  EXPECT_TRUE(opaque != nullptr);
+  EXPECT_TRUE(packet->Payload() == nullptr);
+  EXPECT_TRUE(packet->Size() == params.size() + payload.size());
+  EXPECT_TRUE(memcmp(buf, params.data(), params.size()) == 0);
+  EXPECT_TRUE(memcmp(buf + params.size(), payload.data(), payload.size()) == 0);
+  for (size_t i = 0; i < DASH_PACKET_PADDING_SIZE; i++) EXPECT_TRUE(buf[packet->Size() + i] == 0);
+  delete packet;
+
+  // the buffer is still in use until it is released to the pool
+  PacketPoolStatistics stats = PACKETPOOL::GetInstance()->GetStatistics();
+  EXPECT_TRUE(stats.in_use_bytes_ >= payload.size() + params.size() + DASH_PACKET_PADDING_SIZE);
+  MediaPacket::ReleasePayload(opaque, reinterpret_cast<uint8_t *>(buf));
+  stats = PACKETPOOL::GetInstance()->GetStatistics();
+  EXPECT_TRUE(stats.in_use_bytes_ == 0);
+  EXPECT_TRUE(stats.cached_bytes_ > 0);
+}
+
+TEST_F(MediaPacketTest, PayloadHandOffPerf) {
+  // one merged viewport frame of 8K stream at about 100Mbps, 30fps
+  const size_t packetNum = 3000;
+  const size_t packetSize = 100 * 1000 * 1000 / 8 / 30;
+  const size_t headroom = 128;
+  std::vector<char> sample(packetSize, 0x22);
+
+  // 1. moved out of the packet, then copied into the decoder packet
+  uint64_t copiedBytes = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < packetNum; i++) {
+    MediaPacket *packet = new MediaPacket();
+    packet->AllocatePayload(packetSize, headroom);
+    memcpy(packet->Payload(), sample.data(), 4096);
+    packet->SetRealSize(packetSize);
+    char *buf = packet->MovePayload();
+    copiedBytes += packetSize;  // the unused headroom is dropped by memmove
+    char *decoderBuf = static_cast<char *>(malloc(packetSize + DASH_PACKET_PADDING_SIZE));
+    memcpy(decoderBuf, buf, packetSize);
+    copiedBytes += packetSize;
+    free(buf);
+    free(decoderBuf);
+    delete packet;
+  }
+  double moveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  // 2. shared with the release callback, the decoder refers to it directly
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < packetNum; i++) {
+    MediaPacket *packet = new MediaPacket();
+    packet->AllocatePayload(packetSize, headroom);
+    memcpy(packet->Payload(), sample.data(), 4096);
+    packet->SetRealSize(packetSize);
+    void *opaque = nullptr;
+    char *buf = packet->SharePayload(&opaque);
+    delete packet;
+    MediaPacket::ReleasePayload(opaque, reinterpret_cast<uint8_t *>(buf));
+  }
+  double shareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  printf("hand off %zu packets of %zu bytes: move and copy %.1f ms, %.1f MB copied per second of stream; share %.1f ms, 0 copied\n",
+         packetNum, packetSize, moveMs, copiedBytes / 1000000.0 / (packetNum / 30.0), shareMs);
+  EXPECT_TRUE(PACKETPOOL::GetInstance()->GetStatistics().in_use_bytes_ == 0);
+  EXPECT_TRUE(shareMs < moveMs);
+}
+}  // namespace
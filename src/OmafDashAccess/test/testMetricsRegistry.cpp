@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testMetricsRegistry.cpp
+//! \brief:  latency histogram and metrics registry unit test
+//!
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../../utils/MetricsRegistry.h"
+#include "../../utils/error.h"
+
+namespace {
+
+class MetricsRegistryTest : public testing::Test {
+ public:
+  virtual void SetUp() { MetricsRegistry::GetInstance()->Reset(); }
+
+  virtual void TearDown() {
+    MetricsRegistry::GetInstance()->StopPeriodicDump();
+    MetricsRegistry::GetInstance()->Reset();
+  }
+
+  std::string readFile(const char *fileName) {
+    std::ifstream in(fileName);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  }
+};
+
+TEST_F(MetricsRegistryTest, BucketsAreMonotonicWithBoundedError) {
+  uint32_t prevIndex = 0;
+  for (uint64_t value = 0; value < ((uint64_t)1 << 36); value = value * 9 / 8 + 1) {
+    uint32_t index = LatencyHistogram::GetBucketIndex(value);
+    ASSERT_TRUE(index < HISTOGRAM_BUCKETS_NUM);
+    EXPECT_TRUE(index >= prevIndex);
+    uint64_t upper = LatencyHistogram::GetBucketUpperBound(index);
+    EXPECT_TRUE(upper >= value);
+    // upper bound of the bucket is within 1/16 of the value
+    EXPECT_TRUE(upper - value <= value / 16);
+    if (index > 0) {
+      EXPECT_TRUE(LatencyHistogram::GetBucketUpperBound(index - 1) < value);
+    }
+    prevIndex = index;
+  }
+  EXPECT_TRUE(LatencyHistogram::GetBucketIndex(UINT64_MAX) == HISTOGRAM_BUCKETS_NUM - 1);
+}
+
+TEST_F(MetricsRegistryTest, PercentilesOfUniformValues) {
+  LatencyHistogram *histogram = MetricsRegistry::GetInstance()->GetHistogram("test_uniform_us");
+  EXPECT_TRUE(histogram == MetricsRegistry::GetInstance()->GetHistogram("test_uniform_us"));
+  for (uint64_t value = 1; value <= 10000; value++) histogram->Record(value);
+
+  HistogramSnapshot snapshot;
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot("test_uniform_us", &snapshot);
+  EXPECT_TRUE(snapshot.count == 10000);
+  EXPECT_TRUE(snapshot.sum == (uint64_t)10000 * 10001 / 2);
+  EXPECT_TRUE(snapshot.min == 1);
+  EXPECT_TRUE(snapshot.max == 10000);
+  EXPECT_NEAR((double)snapshot.p50, 5000, 5000 * 0.04);
+  EXPECT_NEAR((double)snapshot.p90, 9000, 9000 * 0.04);
+  EXPECT_NEAR((double)snapshot.p99, 9900, 9900 * 0.04);
+  EXPECT_TRUE(snapshot.p999 <= snapshot.max);
+  EXPECT_TRUE(snapshot.p50 <= snapshot.p90 && snapshot.p90 <= snapshot.p99 && snapshot.p99 <= snapshot.p999);
+
+  histogram->Reset();
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot("test_uniform_us", &snapshot);
+  EXPECT_TRUE(snapshot.count == 0 && snapshot.max == 0 && snapshot.p99 == 0);
+}
+
+TEST_F(MetricsRegistryTest, ConcurrentRecordAndAdd) {
+  LatencyHistogram *histogram = MetricsRegistry::GetInstance()->GetHistogram("test_concurrent_us");
+  MetricsCounter *counter = MetricsRegistry::GetInstance()->GetCounter("test_concurrent_total");
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < 4; i++) {
+    threads.push_back(std::thread([histogram, counter, i]() {
+      for (uint64_t j = 0; j < 100000; j++) {
+        histogram->Record(i * 100000 + j);
+        counter->Add(2);
+      }
+    }));
+  }
+  for (auto &thread : threads) thread.join();
+
+  HistogramSnapshot snapshot;
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot("test_concurrent_us", &snapshot);
+  EXPECT_TRUE(snapshot.count == 400000);
+  EXPECT_TRUE(snapshot.min == 0);
+  EXPECT_TRUE(snapshot.max == 399999);
+  EXPECT_TRUE(MetricsRegistry::GetInstance()->GetCounterValue("test_concurrent_total") == 800000);
+  EXPECT_TRUE(MetricsRegistry::GetInstance()->GetCounterValue("test_not_registered_total") == 0);
+}
+
+TEST_F(MetricsRegistryTest, DumpFormats) {
+  MetricsRegistry::GetInstance()->GetCounter("test_dump_total")->Add(7);
+  MetricsRegistry::GetInstance()->GetHistogram("test_dump_us")->Record(100);
+
+  std::string json = MetricsRegistry::GetInstance()->Dump(METRICS_FORMAT_JSON);
+  EXPECT_TRUE(json.find("\"test_dump_total\": 7") != std::string::npos);
+  EXPECT_TRUE(json.find("\"test_dump_us\": {\"count\": 1, \"sum\": 100") != std::string::npos);
+
+  std::string text = MetricsRegistry::GetInstance()->Dump(METRICS_FORMAT_PROMETHEUS);
+  EXPECT_TRUE(text.find("# TYPE test_dump_total counter\ntest_dump_total 7\n") != std::string::npos);
+  EXPECT_TRUE(text.find("# TYPE test_dump_us summary\n") != std::string::npos);
+  EXPECT_TRUE(text.find("test_dump_us{quantile=\"0.99\"} 100\n") != std::string::npos);
+  EXPECT_TRUE(text.find("test_dump_us_count 1\n") != std::string::npos);
+}
+
+TEST_F(MetricsRegistryTest, DumpToFile) {
+  const char *fileName = "./metrics_test.json";
+  remove(fileName);
+  MetricsRegistry::GetInstance()->GetCounter("test_file_total")->Add(3);
+  EXPECT_TRUE(MetricsRegistry::GetInstance()->DumpToFile(fileName, METRICS_FORMAT_JSON) == ERROR_NONE);
+  EXPECT_TRUE(readFile(fileName).find("\"test_file_total\": 3") != std::string::npos);
+  remove(fileName);
+
+  EXPECT_TRUE(MetricsRegistry::GetInstance()->DumpToFile("./not_exist_dir/metrics.json", METRICS_FORMAT_JSON) != ERROR_NONE);
+}
+
+TEST_F(MetricsRegistryTest, PeriodicDump) {
+  const char *fileName = "./metrics_test.prom";
+  remove(fileName);
+  MetricsCounter *counter = MetricsRegistry::GetInstance()->GetCounter("test_periodic_total");
+  counter->Add(1);
+  EXPECT_TRUE(MetricsRegistry::GetInstance()->StartPeriodicDump(fileName, 10, METRICS_FORMAT_PROMETHEUS) == ERROR_NONE);
+  usleep(100000);
+  EXPECT_TRUE(readFile(fileName).find("test_periodic_total 1\n") != std::string::npos);
+
+  // the final dump on stop carries the latest values
+  counter->Add(1);
+  MetricsRegistry::GetInstance()->StopPeriodicDump();
+  EXPECT_TRUE(readFile(fileName).find("test_periodic_total 2\n") != std::string::npos);
+  remove(fileName);
+}
+}  // namespace
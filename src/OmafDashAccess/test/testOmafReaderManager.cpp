@@ -311,4 +311,42 @@ TEST_F(OmafReaderManagerTest, ReaderTrackSegments) {
     fpGen = NULL;
   }
 }
+
+TEST(OmafReaderManagerWaitTest, WokenUpInsteadOfPolling) {
+  OmafReaderManager::OmafReaderParams params;
+  params.duration_ = 1000;
+  params.mode_ = OmafDashMode::LATER_BINDING;
+  params.stream_type_ = DASH_STREAM_DYNMIC;
+  OmafReaderManager::Ptr readerMgr = std::make_shared<OmafReaderManager>(nullptr, params);
+
+  // nothing comes, time out
+  EXPECT_EQ(readerMgr->WaitForStartOffsetPts(10), OMAF_ERROR_TIMED_OUT);
+  std::vector<uint32_t> trackIDs(1, 1);
+  EXPECT_EQ(readerMgr->WaitForPackets(trackIDs, 0, 10), OMAF_ERROR_TIMED_OUT);
+
+  // woken up once the start offset pts is set
+  std::thread setter([&readerMgr]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    readerMgr->SetStartOffsetPts(0);
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(readerMgr->WaitForStartOffsetPts(5000), ERROR_NONE);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2000));
+  EXPECT_EQ(readerMgr->GetStartOffsetPts(), 0);
+  setter.join();
+
+  // released once the reader manager is closed
+  std::thread closer([&readerMgr]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    readerMgr->Close();
+  });
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(readerMgr->WaitForParsedSegment(readerMgr->GetParsedSegmentCount(), 5000), ERROR_INVALID);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2000));
+  closer.join();
+
+  MediaPacket *packet = nullptr;
+  EXPECT_EQ(readerMgr->WaitNextPacketWithPTS(1, 0, packet, false, 5000), ERROR_NULL_PACKET);
+  EXPECT_TRUE(packet == nullptr);
+}
 }  // namespace
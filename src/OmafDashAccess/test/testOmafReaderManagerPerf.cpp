@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testOmafReaderManagerPerf.cpp
+//! \brief:  Omaf reader manager segment parsing performance test
+//!
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../OmafDashSource.h"
+#include "../OmafMP4VRReader.h"
+#include "../OmafReader.h"
+#include "../OmafReaderManager.h"
+#include "gtest/gtest.h"
+
+VCD_USE_VROMAF;
+VCD_USE_VRVIDEO;
+
+namespace {
+class OmafReaderManagerPerfTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    m_clientInfo = new HeadSetInfo;
+    m_clientInfo->pose = new HeadPose;
+    m_clientInfo->pose->yaw = -90;
+    m_clientInfo->pose->pitch = 0;
+    m_clientInfo->viewPort_hFOV = 80;
+    m_clientInfo->viewPort_vFOV = 90;
+    m_clientInfo->viewPort_Width = 1024;
+    m_clientInfo->viewPort_Height = 1024;
+
+    m_source = new OmafDashSource();
+    if (!m_source) return;
+
+    int ret = m_source->SetupHeadSetInfo(m_clientInfo);
+    if (ret) return;
+
+    std::string mpdUrl = "./segs_for_readertest/Test.mpd";
+
+    PluginDef i360ScvpPlugin;
+    i360ScvpPlugin.pluginLibPath = NULL;
+    ret = m_source->OpenMedia(mpdUrl, "./cache", NULL, i360ScvpPlugin, true, false);
+    if (ret) {
+      printf("Failed to open media \n");
+      return;
+    }
+    m_source->StartStreaming();
+  }
+
+  virtual void TearDown() {
+    delete (m_clientInfo->pose);
+    m_clientInfo->pose = NULL;
+
+    delete m_clientInfo;
+    m_clientInfo = NULL;
+
+    m_source->CloseMedia();
+    SAFE_DELETE(m_source);
+  }
+
+  int64_t getFileSize(const char *fileName) {
+    FILE *fp = fopen(fileName, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0L, SEEK_END);
+    int64_t size = ftell(fp);
+    fclose(fp);
+    return size;
+  }
+
+  HeadSetInfo *m_clientInfo;
+  OmafMediaSource *m_source;
+};
+
+// tile tracks of one timeline point are independent in later binding mode,
+// so they are the nodes which the parse workers can handle concurrently
+TEST_F(OmafReaderManagerPerfTest, ParseSegmentsWithWorkers) {
+  const uint32_t segNum = 4;
+  const std::vector<int32_t> workerNums = {1, 2, 4, 8};
+
+  EXPECT_TRUE(m_source->GetStreamCount() == 1);
+  OmafMediaStream *stream = m_source->GetStream(0);
+  EXPECT_TRUE(stream != NULL);
+  if (!stream) return;
+
+  std::map<int, OmafAdaptationSet *> normalAS = stream->GetMediaAdaptationSet();
+  char storedFileName[1024];
+
+  for (auto workerNum : workerNums) {
+    OmafReaderManager::OmafReaderParams params;
+    params.duration_ = 1000;
+    params.mode_ = OmafDashMode::LATER_BINDING;
+    params.stream_type_ = DASH_STREAM_STATIC;
+    params.max_parse_workers_ = workerNum;
+
+    OmafReaderManager::Ptr readerMgr = std::make_shared<OmafReaderManager>(nullptr, params);
+    int ret = readerMgr->Initialize(m_source);
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    for (auto itAS = normalAS.begin(); itAS != normalAS.end(); itAS++) {
+      OmafAdaptationSet *pAS = (OmafAdaptationSet *)(itAS->second);
+      EXPECT_TRUE(pAS != NULL);
+
+      memset(storedFileName, 0, 1024);
+      snprintf(storedFileName, 1024, "./segs_for_readertest/%s.init.mp4", pAS->GetRepresentationId().c_str());
+      int64_t segSize = getFileSize(storedFileName);
+      if (segSize < 0) return;
+
+      ret = pAS->LoadAssignedInitSegment(std::string(storedFileName));
+      EXPECT_TRUE(ret == ERROR_NONE);
+
+      OmafSegment::Ptr initSeg = pAS->GetInitSegment();
+      EXPECT_TRUE(initSeg != NULL);
+
+      initSeg->SetSegSize(segSize);
+      ret = readerMgr->OpenLocalInitSegment(initSeg);
+      EXPECT_TRUE(ret == ERROR_NONE);
+    }
+
+    // init segments are parsed synchronously when opened, so the media
+    // segments can be opened right now
+    uint64_t expectedNum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t segID = 1; segID <= segNum; segID++) {
+      for (auto itAS = normalAS.begin(); itAS != normalAS.end(); itAS++) {
+        OmafAdaptationSet *pAS = (OmafAdaptationSet *)(itAS->second);
+        pAS->Enable(true);
+
+        memset(storedFileName, 0, 1024);
+        snprintf(storedFileName, 1024, "./segs_for_readertest/%s.%d.mp4", pAS->GetRepresentationId().c_str(), segID);
+        int64_t segSize = getFileSize(storedFileName);
+        if (segSize < 0) return;
+
+        OmafSegment::Ptr newSeg = pAS->LoadAssignedSegment(std::string(storedFileName));
+        EXPECT_TRUE(newSeg != NULL);
+        if (!newSeg) break;
+
+        newSeg->SetSegSize(segSize);
+        ret = readerMgr->OpenLocalSegment(newSeg, pAS->IsExtractor());
+        EXPECT_TRUE(ret == ERROR_NONE);
+        expectedNum++;
+      }
+    }
+
+    // wait until all the segments are parsed, 30s at most
+    while (readerMgr->GetParsedSegmentCount() < expectedNum &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(30)) {
+      usleep(1000);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    uint64_t parsedNum = readerMgr->GetParsedSegmentCount();
+    double duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000000.0;
+    EXPECT_TRUE(parsedNum == expectedNum);
+    printf("Parse workers %d: parsed %lu segments in %f s, %f segments/s\n", workerNum, parsedNum, duration,
+           duration > 0 ? parsedNum / duration : 0);
+
+    readerMgr->Close();
+  }
+}
+
+// the reader alone, the boxes of different segments are read in parallel
+// and only adding them to the reader maps is serialized
+TEST_F(OmafReaderManagerPerfTest, ReadSegmentsInParallel) {
+  const uint32_t segNum = 4;
+  const uint32_t rounds = 8;
+  const std::vector<int32_t> workerNums = {1, 2, 4, 8};
+
+  EXPECT_TRUE(m_source->GetStreamCount() == 1);
+  OmafMediaStream *stream = m_source->GetStream(0);
+  EXPECT_TRUE(stream != NULL);
+  if (!stream) return;
+
+  std::map<int, OmafAdaptationSet *> normalAS = stream->GetMediaAdaptationSet();
+  char storedFileName[1024];
+
+  OmafMP4VRReader reader;
+  std::vector<OmafSegment::Ptr> segments;
+  for (auto itAS = normalAS.begin(); itAS != normalAS.end(); itAS++) {
+    OmafAdaptationSet *pAS = (OmafAdaptationSet *)(itAS->second);
+    EXPECT_TRUE(pAS != NULL);
+
+    memset(storedFileName, 0, 1024);
+    snprintf(storedFileName, 1024, "./segs_for_readertest/%s.init.mp4", pAS->GetRepresentationId().c_str());
+    int64_t segSize = getFileSize(storedFileName);
+    if (segSize < 0) return;
+
+    int ret = pAS->LoadAssignedInitSegment(std::string(storedFileName));
+    EXPECT_TRUE(ret == ERROR_NONE);
+    OmafSegment::Ptr initSeg = pAS->GetInitSegment();
+    EXPECT_TRUE(initSeg != NULL);
+    if (!initSeg) return;
+
+    initSeg->SetSegSize(segSize);
+    ret = reader.parseInitializationSegment(initSeg.get(), initSeg->GetInitSegID());
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    pAS->Enable(true);
+    for (uint32_t segID = 1; segID <= segNum; segID++) {
+      memset(storedFileName, 0, 1024);
+      snprintf(storedFileName, 1024, "./segs_for_readertest/%s.%d.mp4", pAS->GetRepresentationId().c_str(), segID);
+      segSize = getFileSize(storedFileName);
+      if (segSize < 0) return;
+
+      OmafSegment::Ptr newSeg = pAS->LoadAssignedSegment(std::string(storedFileName));
+      EXPECT_TRUE(newSeg != NULL);
+      if (!newSeg) return;
+      newSeg->SetSegSize(segSize);
+      segments.push_back(newSeg);
+    }
+  }
+  EXPECT_TRUE(segments.size() > 0);
+
+  for (auto workerNum : workerNums) {
+    std::atomic<uint64_t> failedNum(0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < rounds; round++) {
+      // each segment is parsed and then invalidated, as a segment node does
+      std::atomic<size_t> nextSeg(0);
+      std::vector<std::thread> workers;
+      for (int32_t idx = 0; idx < workerNum; idx++) {
+        workers.push_back(std::thread([&]() {
+          size_t segIdx = 0;
+          while ((segIdx = nextSeg.fetch_add(1)) < segments.size()) {
+            OmafSegment *seg = segments[segIdx].get();
+            if (reader.parseSegment(seg, seg->GetInitSegID(), seg->GetSegID()) != ERROR_NONE) failedNum++;
+          }
+        }));
+      }
+      for (auto &worker : workers) worker.join();
+
+      for (auto &seg : segments) {
+        reader.invalidateSegment(seg->GetInitSegID(), seg->GetSegID());
+      }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    uint64_t parsedNum = (uint64_t)rounds * segments.size();
+    double duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000000.0;
+    EXPECT_TRUE(failedNum == 0);
+    printf("Reader workers %d: parsed %lu segments in %f s, %f segments/s\n", workerNum, parsedNum, duration,
+           duration > 0 ? parsedNum / duration : 0);
+  }
+}
+}  // namespace
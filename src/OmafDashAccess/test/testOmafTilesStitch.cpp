@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testOmafTilesStitch.cpp
+//! \brief:  tiles merge with cached merge plans unit test
+//!
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../OmafTilesStitch.h"
+#include "../OmafDashMetrics.h"
+#include "../../utils/MetricsRegistry.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+#define TILE_SIZE 960
+#define MERGE_PERF_ROUNDS 20
+
+// VPS/SPS/PPS and tile slices of each frame from one tiled HEVC stream
+typedef struct TiledStream {
+  std::vector<uint8_t> headers;
+  uint32_t vpsLen = 0;
+  uint32_t spsLen = 0;
+  uint32_t ppsLen = 0;
+  std::vector<std::vector<std::vector<uint8_t>>> frames;
+} TiledStream;
+
+class OmafTilesStitchTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    ASSERT_TRUE(loadStream("../../VROmafPacking/test/3840x1920_10frames.h265", m_highRes));
+    ASSERT_TRUE(loadStream("../../VROmafPacking/test/1920x960_10frames.h265", m_lowRes));
+    m_sources[HIGHEST_QUALITY_RANKING] = {HIGHEST_QUALITY_RANKING, 3840, 1920};
+    m_sources[SECOND_QUALITY_RANKING] = {SECOND_QUALITY_RANKING, 1920, 960};
+  }
+
+  virtual void TearDown() {}
+
+  // split the stream into nalus, each tile is coded in one slice
+  bool loadStream(const char *fileName, TiledStream &stream) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<size_t> starts;
+    for (size_t i = 0; i + 3 < data.size(); i++) {
+      if (!data[i] && !data[i + 1] && !data[i + 2] && data[i + 3] == 1) {
+        starts.push_back(i);
+        i += 3;
+      }
+    }
+    starts.push_back(data.size());
+    for (size_t i = 0; i + 1 < starts.size(); i++) {
+      std::vector<uint8_t> nalu(data.begin() + starts[i], data.begin() + starts[i + 1]);
+      uint8_t type = (nalu[4] >> 1) & 0x3f;
+      if (type == 32 || type == 33 || type == 34) {
+        stream.headers.insert(stream.headers.end(), nalu.begin(), nalu.end());
+        if (type == 32) stream.vpsLen = nalu.size();
+        if (type == 33) stream.spsLen = nalu.size();
+        if (type == 34) stream.ppsLen = nalu.size();
+      } else if (type < 32) {
+        // first_slice_segment_in_pic_flag
+        if (nalu[6] & 0x80) stream.frames.emplace_back();
+        if (stream.frames.empty()) return false;
+        stream.frames.back().push_back(nalu);
+      }
+    }
+    return stream.frames.size() > 0;
+  }
+
+  MediaPacket *createPacket(TiledStream &stream, uint32_t frame, uint32_t tile, uint32_t tileCols,
+                            QualityRank qualityRanking) {
+    std::vector<uint8_t> &slice = stream.frames[frame][tile];
+    MediaPacket *packet = new MediaPacket();
+    packet->ReAllocatePacket(stream.headers.size() + slice.size());
+    memcpy(packet->Payload(), stream.headers.data(), stream.headers.size());
+    memcpy(packet->Payload() + stream.headers.size(), slice.data(), slice.size());
+    packet->SetRealSize(stream.headers.size() + slice.size());
+    packet->SetVPSLen(stream.vpsLen);
+    packet->SetSPSLen(stream.spsLen);
+    packet->SetPPSLen(stream.ppsLen);
+    packet->SetVideoHeaderSize(stream.headers.size());
+    SRDInfo srd;
+    srd.left = (tile % tileCols) * TILE_SIZE;
+    srd.top = (tile / tileCols) * TILE_SIZE;
+    srd.width = TILE_SIZE;
+    srd.height = TILE_SIZE;
+    packet->SetSRDInfo(srd);
+    packet->SetQualityRanking(qualityRanking);
+    packet->SetCodecType(VideoCodec_HEVC);
+    packet->SetPTS(frame);
+    packet->SetSegID(1);
+    return packet;
+  }
+
+  // parse 4K VPS/SPS/PPS into 360SCVP handle
+  bool parseHeaders(void *handle) {
+    uint32_t paramsLen[3] = {m_highRes.vpsLen, m_highRes.spsLen, m_highRes.ppsLen};
+    uint8_t *params = m_highRes.headers.data();
+    for (uint32_t i = 0; i < 3; i++) {
+      Nalu nalu;
+      memset(&nalu, 0, sizeof(Nalu));
+      nalu.data = params;
+      nalu.dataSize = paramsLen[i];
+      if (I360SCVP_ParseNAL(&nalu, handle)) return false;
+      params += paramsLen[i];
+    }
+    return true;
+  }
+
+  // 7680x3840 stream with 8x4 tiles built from the 3840x1920 one, 360SCVP
+  // rewrites SPS/PPS and slice headers for 8K, and tile i reuses the slice
+  // data of 4K tile (i % 8)
+  bool build8KStream(TiledStream &stream) {
+    param_360SCVP param;
+    memset(&param, 0, sizeof(param_360SCVP));
+    param.usedType = E_PARSER_ONENAL;
+    param.pInputBitstream = m_highRes.headers.data();
+    param.inputBitstreamLen = m_highRes.headers.size();
+    void *handle = I360SCVP_Init(&param);
+    if (!handle) return false;
+    bool ret = parseHeaders(handle);
+
+    uint16_t rowHeight[4] = {TILE_SIZE / 64, TILE_SIZE / 64, TILE_SIZE / 64, TILE_SIZE / 64};
+    uint16_t colWidth[8];
+    for (uint32_t i = 0; i < 8; i++) colWidth[i] = TILE_SIZE / 64;
+    TileArrangement layout = {4, 8, rowHeight, colWidth};
+    std::vector<uint8_t> buffer(2 * m_highRes.headers.size());
+    stream.headers.assign(m_highRes.headers.begin(), m_highRes.headers.begin() + m_highRes.vpsLen);
+    stream.vpsLen = m_highRes.vpsLen;
+    param.destWidth = 7680;
+    param.destHeight = 3840;
+    param.pInputBitstream = m_highRes.headers.data() + m_highRes.vpsLen;
+    param.inputBitstreamLen = m_highRes.spsLen;
+    param.pOutputBitstream = buffer.data();
+    ret = ret && !I360SCVP_GenerateSPS(&param, handle);
+    stream.spsLen = param.outputBitstreamLen;
+    stream.headers.insert(stream.headers.end(), buffer.begin(), buffer.begin() + stream.spsLen);
+    param.pInputBitstream = m_highRes.headers.data() + m_highRes.vpsLen + m_highRes.spsLen;
+    param.inputBitstreamLen = m_highRes.ppsLen;
+    ret = ret && !I360SCVP_GeneratePPS(&param, &layout, handle);
+    stream.ppsLen = param.outputBitstreamLen;
+    stream.headers.insert(stream.headers.end(), buffer.begin(), buffer.begin() + stream.ppsLen);
+    // generating SPS/PPS overwrites the parsed 4K parameter sets
+    ret = ret && parseHeaders(handle);
+
+    for (uint32_t frame = 0; ret && frame < m_highRes.frames.size(); frame++) {
+      stream.frames.emplace_back();
+      for (uint32_t tile = 0; ret && tile < 32; tile++) {
+        std::vector<uint8_t> &slice = m_highRes.frames[frame][tile % 8];
+        Nalu nalu;
+        memset(&nalu, 0, sizeof(Nalu));
+        nalu.data = slice.data();
+        nalu.dataSize = slice.size();
+        ret = !I360SCVP_ParseNAL(&nalu, handle);
+        std::vector<uint8_t> tileSlice(2 * slice.size());
+        param.pInputBitstream = slice.data();
+        param.inputBitstreamLen = slice.size();
+        param.pOutputBitstream = tileSlice.data();
+        uint32_t addr = (tile / 8) * (TILE_SIZE / 64) * (7680 / 64) + (tile % 8) * (TILE_SIZE / 64);
+        ret = ret && !I360SCVP_GenerateSliceHdr(&param, addr, handle);
+        uint32_t skipLen = 4 + nalu.sliceHeaderLen;
+        tileSlice.resize(param.outputBitstreamLen);
+        tileSlice.insert(tileSlice.end(), slice.begin() + skipLen, slice.end());
+        stream.frames.back().push_back(tileSlice);
+      }
+    }
+    I360SCVP_unInit(handle);
+    return ret;
+  }
+
+  // selected high resolution tiles plus all low resolution tiles
+  std::map<uint32_t, MediaPacket *> createPackets(uint32_t frame, const std::vector<uint32_t> &highTiles) {
+    return createPackets(m_highRes, 4, frame, highTiles);
+  }
+
+  std::map<uint32_t, MediaPacket *> createPackets(TiledStream &highRes, uint32_t highTileCols, uint32_t frame,
+                                                  const std::vector<uint32_t> &highTiles) {
+    std::map<uint32_t, MediaPacket *> packets;
+    for (auto tile : highTiles) {
+      packets[tile + 1] = createPacket(highRes, frame, tile, highTileCols, HIGHEST_QUALITY_RANKING);
+    }
+    for (uint32_t tile = 0; tile < 2; tile++) {
+      packets[tile + 100] = createPacket(m_lowRes, frame, tile, 2, SECOND_QUALITY_RANKING);
+    }
+    return packets;
+  }
+
+  // merge one frame, return merged data of each quality ranking
+  std::map<QualityRank, std::vector<uint8_t>> mergeFrame(OmafTilesStitch *stitch, uint32_t frame,
+                                                         const std::vector<uint32_t> &highTiles) {
+    std::map<QualityRank, std::vector<uint8_t>> merged;
+    std::map<uint32_t, MediaPacket *> packets = createPackets(frame, highTiles);
+    int32_t ret = ERROR_NONE;
+    if (!stitch->IsInitialized()) {
+      ret = stitch->Initialize(packets, true, VCD::OMAF::ProjectionFormat::PF_ERP, m_sources);
+    } else {
+      ret = stitch->UpdateSelectedTiles(packets, true);
+    }
+    EXPECT_TRUE(ret == ERROR_NONE);
+    std::list<MediaPacket *> mergedPackets = stitch->GetTilesMergedPackets();
+    for (auto packet : mergedPackets) {
+      merged[packet->GetQualityRanking()].assign(packet->Payload(), packet->Payload() + packet->Size());
+      delete packet;
+    }
+    return merged;
+  }
+
+  // average merge time per frame in microsecond, from the merge time histogram
+  double mergeTimePerFrame(TiledStream &highRes, uint32_t highTileCols, const std::vector<uint32_t> &highTiles) {
+    OmafTilesStitch *stitch = new OmafTilesStitch();
+    stitch->SetMaxStitchResolution(&highRes == &m_highRes ? 3840 : 7680, 3840);
+    HistogramSnapshot before;
+    MetricsRegistry::GetInstance()->GetHistogramSnapshot(CLIENT_MERGE_TIME, &before);
+    for (uint32_t round = 0; round < MERGE_PERF_ROUNDS; round++) {
+      for (uint32_t frame = 0; frame < highRes.frames.size(); frame++) {
+        std::map<uint32_t, MediaPacket *> packets = createPackets(highRes, highTileCols, frame, highTiles);
+        int32_t ret = stitch->IsInitialized() ? stitch->UpdateSelectedTiles(packets, true)
+                                              : stitch->Initialize(packets, true, VCD::OMAF::ProjectionFormat::PF_ERP, m_sources);
+        EXPECT_TRUE(ret == ERROR_NONE);
+        std::list<MediaPacket *> mergedPackets = stitch->GetTilesMergedPackets();
+        EXPECT_FALSE(mergedPackets.empty());
+        for (auto packet : mergedPackets) delete packet;
+      }
+    }
+    delete stitch;
+    HistogramSnapshot after;
+    MetricsRegistry::GetInstance()->GetHistogramSnapshot(CLIENT_MERGE_TIME, &after);
+    if (after.count == before.count) return 0;
+    return double(after.sum - before.sum) / (after.count - before.count);
+  }
+
+  TiledStream m_highRes;
+  TiledStream m_lowRes;
+  std::map<uint32_t, SourceInfo> m_sources;
+};
+
+TEST_F(OmafTilesStitchTest, HeadersReusedInSteadyState) {
+  OmafTilesStitch *stitch = new OmafTilesStitch();
+  stitch->SetMaxStitchResolution(3840, 2560);
+  HistogramSnapshot mergeTimeBefore;
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot(CLIENT_MERGE_TIME, &mergeTimeBefore);
+  std::vector<uint32_t> tiles = {0, 1, 4, 5};
+  std::vector<uint8_t> headers;
+  for (uint32_t frame = 0; frame < m_highRes.frames.size(); frame++) {
+    std::map<QualityRank, std::vector<uint8_t>> merged = mergeFrame(stitch, frame, tiles);
+    ASSERT_TRUE(merged.size() == 2);
+    std::vector<uint8_t> &highMerged = merged[HIGHEST_QUALITY_RANKING];
+    // 2x2 tiles are merged, so SPS/PPS differ from the original ones
+    ASSERT_TRUE(highMerged.size() > m_highRes.headers.size());
+    EXPECT_TRUE(memcmp(highMerged.data(), m_highRes.headers.data(), m_highRes.vpsLen) == 0);
+    EXPECT_FALSE(memcmp(highMerged.data(), m_highRes.headers.data(), m_highRes.headers.size()) == 0);
+    if (headers.empty()) {
+      headers.assign(highMerged.begin(), highMerged.begin() + m_highRes.headers.size());
+    } else {
+      EXPECT_TRUE(memcmp(highMerged.data(), headers.data(), headers.size()) == 0);
+    }
+    // low resolution tiles keep the original resolution, slices are copied as they are
+    std::vector<uint8_t> lowSlices;
+    for (auto &slice : m_lowRes.frames[frame]) lowSlices.insert(lowSlices.end(), slice.begin(), slice.end());
+    std::vector<uint8_t> &lowMerged = merged[SECOND_QUALITY_RANKING];
+    ASSERT_TRUE(lowMerged.size() > lowSlices.size());
+    EXPECT_TRUE(std::equal(lowSlices.begin(), lowSlices.end(), lowMerged.end() - lowSlices.size()));
+  }
+
+  HistogramSnapshot mergeTime;
+  MetricsRegistry::GetInstance()->GetHistogramSnapshot(CLIENT_MERGE_TIME, &mergeTime);
+  EXPECT_TRUE(mergeTime.count - mergeTimeBefore.count == m_highRes.frames.size());
+  EXPECT_TRUE(mergeTime.max * mergeTime.count >= mergeTime.sum);
+  delete stitch;
+}
+
+TEST_F(OmafTilesStitchTest, CachedPlanMatchesFreshMerge) {
+  std::vector<std::vector<uint32_t>> selections = {{0, 1, 4, 5},    {0, 1, 4, 5}, {1, 2, 5, 6},
+                                                   {1, 2, 3, 5, 6, 7}, {2, 3},       {2, 3, 6, 7},
+                                                   {2, 3, 6, 7},    {0, 4},       {0, 1, 4, 5},
+                                                   {0, 1, 4, 5}};
+  OmafTilesStitch *stitch = new OmafTilesStitch();
+  stitch->SetMaxStitchResolution(3840, 2560);
+  for (uint32_t frame = 0; frame < selections.size() && frame < m_highRes.frames.size(); frame++) {
+    std::map<QualityRank, std::vector<uint8_t>> merged = mergeFrame(stitch, frame, selections[frame]);
+
+    // a new stitch instance generates everything from scratch for this frame
+    OmafTilesStitch *freshStitch = new OmafTilesStitch();
+    freshStitch->SetMaxStitchResolution(3840, 2560);
+    std::map<QualityRank, std::vector<uint8_t>> freshMerged = mergeFrame(freshStitch, frame, selections[frame]);
+    delete freshStitch;
+
+    EXPECT_TRUE(merged.size() == freshMerged.size());
+    EXPECT_TRUE(merged[HIGHEST_QUALITY_RANKING] == freshMerged[HIGHEST_QUALITY_RANKING]);
+    EXPECT_TRUE(merged[SECOND_QUALITY_RANKING] == freshMerged[SECOND_QUALITY_RANKING]);
+  }
+  delete stitch;
+}
+TEST_F(OmafTilesStitchTest, MergeTimePerFramePerf) {
+  // 3840x1920 source, all 4x2 tiles are merged
+  std::vector<uint32_t> tiles4K = {0, 1, 2, 3, 4, 5, 6, 7};
+  double merge4K = mergeTimePerFrame(m_highRes, 4, tiles4K);
+
+  // 7680x3840 source, 6x4 tiles of the 8x4 ones are merged
+  TiledStream stream8K;
+  ASSERT_TRUE(build8KStream(stream8K));
+  m_sources[HIGHEST_QUALITY_RANKING] = {HIGHEST_QUALITY_RANKING, 7680, 3840};
+  std::vector<uint32_t> tiles8K;
+  for (uint32_t tile = 0; tile < 32; tile++) {
+    if (tile % 8 < 6) tiles8K.push_back(tile);
+  }
+  double merge8K = mergeTimePerFrame(stream8K, 8, tiles8K);
+
+  printf("Merge time per frame: 4K %zu tiles %.1f us, 8K %zu tiles %.1f us\n", tiles4K.size(), merge4K,
+         tiles8K.size(), merge8K);
+  EXPECT_TRUE(merge4K > 0);
+  EXPECT_TRUE(merge8K > 0);
+}
+}  // namespace
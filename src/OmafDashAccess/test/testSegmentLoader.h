@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testSegmentLoader.h
+//! \brief:  stream adapters and loader of the reader test segments shared
+//!          by the unit tests
+//!
+
+#ifndef TESTSEGMENTLOADER_H
+#define TESTSEGMENTLOADER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../OmafDashDownload/Stream.h"
+#include "../../isolib/dash_parser/Mp4ReaderImpl.h"
+
+#define TEST_SEG_NUM 4                 //!< segments of each track in the reader test content
+#define TEST_EXTRACTOR_FIRST_TRACK 1000  //!< track id of the first extractor track
+
+//!
+//! \brief  the stream of a local segment file, same logic as OmafSegment
+//!         reading the stored file with std::ifstream
+//!
+class SegmentFileStream : public VCD::MP4::StreamIO {
+ public:
+  SegmentFileStream(const std::string &fileName) {
+    mFileStream.open(fileName.c_str(), std::ios_base::binary | std::ios_base::in);
+  }
+
+  bool IsOpen() { return mFileStream.is_open(); }
+
+  offset_t ReadStream(char *buffer, offset_t size) override {
+    mFileStream.read(buffer, size);
+    return (offset_t)mFileStream.gcount();
+  }
+
+  bool SeekAbsoluteOffset(offset_t offset) override {
+    if (mFileStream.tellg() == -1) {
+      mFileStream.clear();
+      mFileStream.seekg(0, std::ios_base::beg);
+    }
+    mFileStream.seekg(offset);
+    return true;
+  }
+
+  offset_t TellOffset() override { return mFileStream.tellg(); }
+
+  offset_t GetStreamSize() override {
+    mFileStream.seekg(0, std::ios_base::end);
+    int64_t size = mFileStream.tellg();
+    mFileStream.seekg(0, std::ios_base::beg);
+    return size;
+  }
+
+ private:
+  std::ifstream mFileStream;
+};
+
+//!
+//! \brief  load the file into a downloaded stream in blocks of blockSize
+//!         bytes, as curl hands the segment over
+//!
+//! \return T*
+//!         the new stream, or nullptr if the file can't be read
+//!
+template <typename T>
+T *LoadFileBlocks(const char *fileName, int64_t blockSize) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file.is_open() || blockSize <= 0) return nullptr;
+  std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  T *stream = new T();
+  for (size_t offset = 0; offset < content.size(); offset += blockSize) {
+    size_t size = std::min((size_t)blockSize, content.size() - offset);
+    std::unique_ptr<VCD::OMAF::StreamBlock> sb(new VCD::OMAF::StreamBlock());
+    memcpy(sb->resize(size), content.data() + offset, size);
+    sb->size(size);
+    stream->push_back(std::move(sb));
+  }
+  return stream;
+}
+
+//!
+//! \brief  parse the init and media segments of the reader test content in
+//!         ./segs_for_readertest, the reader owns the created streams
+//!
+//! \param  [in] createStream
+//!         create the stream of one segment file, nullptr if failed
+//! \param  [in] withExtractors
+//!         whether the extractor track segments are parsed too
+//!
+//! \return bool
+//!         true if any track is found and all its segments are parsed
+//!
+inline bool LoadReaderTestSegments(VCD::MP4::Mp4Reader &reader,
+                                   std::function<VCD::MP4::StreamIO *(const char *)> createStream,
+                                   bool withExtractors) {
+  std::vector<uint32_t> firstTracks = {1};
+  if (withExtractors) firstTracks.push_back(TEST_EXTRACTOR_FIRST_TRACK);
+
+  char fileName[256];
+  uint32_t trackNum = 0;
+  for (auto firstTrack : firstTracks) {
+    for (uint32_t track = firstTrack;; track++) {
+      snprintf(fileName, 256, "./segs_for_readertest/Test_track%u.init.mp4", track);
+      if (access(fileName, R_OK) != 0) break;
+      VCD::MP4::StreamIO *stream = createStream(fileName);
+      if (!stream || reader.ParseInitSeg(stream, track) != ERROR_NONE) return false;
+      for (uint32_t seg = 1; seg <= TEST_SEG_NUM; seg++) {
+        snprintf(fileName, 256, "./segs_for_readertest/Test_track%u.%u.mp4", track, seg);
+        stream = createStream(fileName);
+        if (!stream || reader.ParseSeg(stream, track, seg, UINT64_MAX) != ERROR_NONE) return false;
+      }
+      trackNum++;
+    }
+  }
+  return trackNum > 0;
+}
+
+#endif /* TESTSEGMENTLOADER_H */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testSegmentSampleTable.cpp
+//! \brief:  segment sample table of Mp4Reader correctness and performance test
+//!
+
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "testSegmentLoader.h"
+
+using namespace VCD::MP4;
+
+namespace {
+
+class SegmentSampleTableTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    ASSERT_TRUE(LoadReaderTestSegments(m_reader, createStream, false));
+    m_reader.GetTrackInformations(m_trackInfos);
+  }
+
+  virtual void TearDown() {}
+
+  static StreamIO *createStream(const char *fileName) { return new SegmentFileStream(fileName); }
+
+  Mp4Reader m_reader;
+  VarLenArray<TrackInformation> m_trackInfos;
+};
+
+TEST_F(SegmentSampleTableTest, BatchSamplesMatchPerSampleQueries) {
+  ASSERT_TRUE(m_trackInfos.size > 0);
+
+  uint32_t sampleNum = 0;
+  for (size_t i = 0; i < m_trackInfos.size; i++) {
+    const TrackInformation &trackInfo = m_trackInfos[i];
+    for (size_t j = 0; j < trackInfo.sampleProperties.size; j++) {
+      const TrackSampInfo &sampInfo = trackInfo.sampleProperties[j];
+      VarLenArray<SegSample> samples;
+      ASSERT_TRUE(m_reader.GetSegSamples(trackInfo.trackId, sampInfo.segmentId, samples) == ERROR_NONE);
+      ASSERT_TRUE(samples.size > 0);
+
+      uint32_t index = sampInfo.sampleId - samples[0].sampleId;
+      ASSERT_TRUE(index < samples.size);
+      const SegSample &sample = samples[index];
+      EXPECT_TRUE(sample.sampleId == sampInfo.sampleId);
+      EXPECT_TRUE(sample.durationTS == sampInfo.sampleDurationTS);
+      EXPECT_TRUE(sample.compositionTimeTS == sampInfo.earliestTStampTS);
+      EXPECT_TRUE(sample.isSync == (sampInfo.sampleType == OUTPUT_REF_FRAME));
+      if (index > 0) {
+        EXPECT_TRUE(sample.decodeTimeTS == samples[index - 1].decodeTimeTS + samples[index - 1].durationTS);
+      }
+
+      uint64_t offset = 0;
+      uint32_t length = 0;
+      EXPECT_TRUE(m_reader.GetSampOffset(trackInfo.trackId, sampInfo.sampleId, offset, length) == ERROR_NONE);
+      EXPECT_TRUE(sample.dataOffset == offset);
+      EXPECT_TRUE(sample.dataLength == length);
+
+      std::vector<char> data(length);
+      uint32_t dataSize = length;
+      EXPECT_TRUE(m_reader.GetSampData(trackInfo.trackId, sampInfo.sampleId, data.data(), dataSize, false) ==
+                  ERROR_NONE);
+      EXPECT_TRUE(dataSize == length);
+      sampleNum++;
+    }
+  }
+  EXPECT_TRUE(sampleNum > 0);
+
+  // samples of a released segment are no longer reachable
+  const TrackInformation &trackInfo = m_trackInfos[0];
+  VarLenArray<SegSample> samples;
+  EXPECT_TRUE(m_reader.GetSegSamples(trackInfo.trackId, 1, samples) == ERROR_NONE);
+  EXPECT_TRUE(m_reader.DisableSeg(trackInfo.initSegmentId, 1) == ERROR_NONE);
+  EXPECT_TRUE(m_reader.GetSegSamples(trackInfo.trackId, 1, samples) != ERROR_NONE);
+  uint64_t offset = 0;
+  uint32_t length = 0;
+  EXPECT_TRUE(m_reader.GetSampOffset(trackInfo.trackId, samples.size ? samples[0].sampleId : 0, offset, length) !=
+              ERROR_NONE);
+}
+
+TEST_F(SegmentSampleTableTest, BatchVersusPerSampleCost) {
+  ASSERT_TRUE(m_trackInfos.size > 0);
+  const uint32_t loopNum = 20;
+
+  // per sample queries as OmafSegmentNode::cachePackets does for each packet
+  uint64_t checkSum = 0;
+  uint32_t queryNum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (uint32_t loop = 0; loop < loopNum; loop++) {
+    for (size_t i = 0; i < m_trackInfos.size; i++) {
+      const TrackInformation &trackInfo = m_trackInfos[i];
+      for (size_t j = 0; j < trackInfo.sampleProperties.size; j++) {
+        uint32_t sampleId = trackInfo.sampleProperties[j].sampleId;
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint32_t duration = 0;
+        VarLenArray<uint64_t> timeStamps;
+        FourCC codeType;
+        m_reader.GetSampOffset(trackInfo.trackId, sampleId, offset, length);
+        m_reader.GetDurOfSamp(trackInfo.trackId, sampleId, duration);
+        m_reader.GetSampTStamps(trackInfo.trackId, sampleId, timeStamps);
+        m_reader.GetDecoderCodeType(trackInfo.trackId, sampleId, codeType);
+        checkSum += offset + length;
+        queryNum++;
+      }
+    }
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  double perSampleCost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)queryNum;
+
+  // one batch query for each track in each segment
+  uint64_t batchCheckSum = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t loop = 0; loop < loopNum; loop++) {
+    for (size_t i = 0; i < m_trackInfos.size; i++) {
+      const TrackInformation &trackInfo = m_trackInfos[i];
+      for (uint32_t seg = 1; seg <= TEST_SEG_NUM; seg++) {
+        VarLenArray<SegSample> samples;
+        if (m_reader.GetSegSamples(trackInfo.trackId, seg, samples) != ERROR_NONE) continue;
+        for (size_t j = 0; j < samples.size; j++) {
+          batchCheckSum += samples[j].dataOffset + samples[j].dataLength;
+        }
+      }
+    }
+  }
+  end = std::chrono::steady_clock::now();
+  double batchCost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)queryNum;
+
+  EXPECT_TRUE(checkSum == batchCheckSum);
+  printf("Tracks %zu, samples %u: per sample query %f ns/sample, batch query %f ns/sample\n", m_trackInfos.size,
+         queryNum / loopNum, perSampleCost, batchCost);
+}
+}  // namespace
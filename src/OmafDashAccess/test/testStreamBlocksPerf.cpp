@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testStreamBlocksPerf.cpp
+//! \brief:  StreamBlocks read correctness and performance test
+//!
+
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../MediaPacket.h"
+#include "testSegmentLoader.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+//!
+//! \brief  the downloaded stream without in place views, every read is
+//!         copied out as before
+//!
+class CopyStreamBlocks : public StreamBlocks {
+ public:
+  const char *GetDataView(offset_t offset, offset_t size) override {
+    (void)offset;
+    (void)size;
+    return nullptr;
+  }
+};
+
+class StreamBlocksPerfTest : public testing::Test {
+ public:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  // fill the stream with blockNum blocks of blockSize bytes, the byte value is its offset
+  void fillStream(StreamBlocks &stream, size_t blockNum, int64_t blockSize) {
+    for (size_t i = 0; i < blockNum; i++) {
+      std::unique_ptr<StreamBlock> sb(new StreamBlock());
+      char *data = static_cast<char *>(sb->resize(blockSize));
+      for (int64_t j = 0; j < blockSize; j++) {
+        data[j] = static_cast<char>((i * blockSize + j) & 0xff);
+      }
+      sb->size(blockSize);
+      stream.push_back(std::move(sb));
+    }
+  }
+
+  // parse the tile and extractor track segments of the reader test content
+  // received in blocks of blockSize bytes
+  template <typename T>
+  bool loadSegments(VCD::MP4::Mp4Reader &reader, int64_t blockSize) {
+    return LoadReaderTestSegments(
+        reader,
+        [blockSize](const char *fileName) -> VCD::MP4::StreamIO * { return LoadFileBlocks<T>(fileName, blockSize); },
+        true);
+  }
+
+  bool checkData(const char *data, int64_t offset, int64_t size) {
+    for (int64_t i = 0; i < size; i++) {
+      if (data[i] != static_cast<char>((offset + i) & 0xff)) return false;
+    }
+    return true;
+  }
+};
+
+TEST_F(StreamBlocksPerfTest, ReadCorrectness) {
+  StreamBlocks stream;
+  const int64_t blockSize = 100;
+  fillStream(stream, 50, blockSize);
+  EXPECT_TRUE(stream.GetStreamSize() == 50 * blockSize);
+
+  // sequential reads across the block boundaries
+  char buf[256];
+  int64_t offset = 0;
+  while (offset < stream.GetStreamSize()) {
+    int64_t readSize = stream.ReadStream(buf, 37);
+    EXPECT_TRUE(readSize > 0);
+    EXPECT_TRUE(checkData(buf, offset, readSize));
+    offset += readSize;
+  }
+  EXPECT_TRUE(offset == 50 * blockSize);
+  EXPECT_TRUE(stream.ReadStream(buf, 10) == 0);
+
+  // random reads from offset
+  std::mt19937 gen(1);
+  for (int i = 0; i < 1000; i++) {
+    int64_t size = gen() % 256;
+    int64_t pos = gen() % (stream.GetStreamSize() - size + 1);
+    EXPECT_TRUE(stream.ReadStreamFromOffset(buf, pos, size) == size);
+    EXPECT_TRUE(checkData(buf, pos, size));
+  }
+  EXPECT_TRUE(stream.ReadStreamFromOffset(buf, stream.GetStreamSize() - 10, 20) == 0);
+
+  // data inside one block is referenced in place, and the offset stays
+  int64_t tell = stream.TellOffset();
+  const char *view = stream.GetDataView(210, 50);
+  EXPECT_TRUE(view != nullptr);
+  EXPECT_TRUE(checkData(view, 210, 50));
+  EXPECT_TRUE(stream.TellOffset() == tell);
+  // data across the blocks can't be referenced
+  EXPECT_TRUE(stream.GetDataView(250, 100) == nullptr);
+  EXPECT_TRUE(stream.GetDataView(stream.GetStreamSize(), 1) == nullptr);
+
+  // seek then read
+  stream.SeekAbsoluteOffset(1234);
+  EXPECT_TRUE(stream.ReadStream(buf, 100) == 100);
+  EXPECT_TRUE(checkData(buf, 1234, 100));
+
+  // offsets are relative to the remaining blocks after pop_front
+  std::unique_ptr<StreamBlock> sb = stream.pop_front();
+  EXPECT_TRUE(sb->size() == blockSize);
+  EXPECT_TRUE(stream.ReadStreamFromOffset(buf, 0, 150) == 150);
+  EXPECT_TRUE(checkData(buf, blockSize, 150));
+  view = stream.GetDataView(10, 20);
+  EXPECT_TRUE(view != nullptr);
+  EXPECT_TRUE(checkData(view, blockSize + 10, 20));
+
+  stream.clear();
+  EXPECT_TRUE(stream.GetStreamSize() == 0);
+  EXPECT_TRUE(stream.ReadStreamFromOffset(buf, 0, 1) == 0);
+}
+
+TEST_F(StreamBlocksPerfTest, ReadCostWithBlockNum) {
+  const std::vector<size_t> blockNums = {10, 100, 1000, 10000};
+  const int64_t blockSize = 1024;
+  const size_t readNum = 100000;
+  const int64_t readSize = 16;
+  char buf[readSize];
+
+  for (auto blockNum : blockNums) {
+    StreamBlocks stream;
+    fillStream(stream, blockNum, blockSize);
+    const int64_t streamSize = stream.GetStreamSize();
+
+    // sequential small reads, as Mp4Reader does when parsing the boxes
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < readNum; i++) {
+      if (stream.TellOffset() + readSize > streamSize) stream.SeekAbsoluteOffset(0);
+      stream.ReadStream(buf, readSize);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double seqCost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)readNum;
+
+    // random small reads
+    std::mt19937 gen(1);
+    std::vector<int64_t> positions(readNum);
+    for (auto &pos : positions) pos = gen() % (streamSize - readSize);
+    start = std::chrono::steady_clock::now();
+    for (auto pos : positions) {
+      stream.ReadStreamFromOffset(buf, pos, readSize);
+    }
+    end = std::chrono::steady_clock::now();
+    double randCost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)readNum;
+
+    printf("Blocks %zu: sequential read %f ns/read, random read %f ns/read\n", blockNum, seqCost, randCost);
+  }
+}
+
+TEST_F(StreamBlocksPerfTest, BlockViews) {
+  const int64_t blockSize = 100;
+  std::shared_ptr<StreamBlock> holder;
+  {
+    StreamBlocks stream;
+    fillStream(stream, 1, blockSize);
+    holder = std::shared_ptr<StreamBlock>(stream.pop_front());
+  }
+
+  // views share the data of the holder
+  std::unique_ptr<StreamBlock> view(new StreamBlock(holder, 30, 50));
+  EXPECT_TRUE(view->size() == 50);
+  EXPECT_TRUE(view->cbuf() == holder->cbuf() + 30);
+  EXPECT_TRUE(view->resize(200) == nullptr);
+
+  // the data is alive until the last view is gone
+  std::weak_ptr<StreamBlock> weakHolder = holder;
+  holder.reset();
+  EXPECT_FALSE(weakHolder.expired());
+  EXPECT_TRUE(checkData(view->cbuf(), 30, 50));
+
+  // a stream made of views is read as the original data
+  StreamBlocks chunk;
+  std::shared_ptr<StreamBlock> sharedView(std::move(view));
+  chunk.push_back(std::unique_ptr<StreamBlock>(new StreamBlock(sharedView, 0, 20)));
+  chunk.push_back(std::unique_ptr<StreamBlock>(new StreamBlock(sharedView, 20, 30)));
+  sharedView.reset();
+  char buf[50];
+  EXPECT_TRUE(chunk.ReadStreamFromOffset(buf, 0, 50) == 50);
+  EXPECT_TRUE(checkData(buf, 30, 50));
+  chunk.clear();
+  EXPECT_TRUE(weakHolder.expired());
+}
+
+TEST_F(StreamBlocksPerfTest, ChunkSliceCost) {
+  // 1 MB segment received in 16 KB blocks, sliced up into 30 chunks
+  const size_t blockNum = 64;
+  const int64_t blockSize = 16 * 1024;
+  const int64_t chunkNum = 30;
+  const int64_t chunkSize = blockNum * blockSize / chunkNum;
+  const size_t loopNum = 100;
+
+  // slice by copying out of the stream as CmafSegment did
+  double copyCost = 0;
+  for (size_t loop = 0; loop < loopNum; loop++) {
+    StreamBlocks stream;
+    fillStream(stream, blockNum, blockSize);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<StreamBlock>> chunks;
+    for (int64_t i = 0; i < chunkNum; i++) {
+      int64_t bytesProcessed = 0;
+      for (int64_t j = 0; j < i; j++) bytesProcessed += chunkSize;
+      char *buf = new char[chunkSize];
+      EXPECT_TRUE(stream.ReadStreamFromOffset(buf, bytesProcessed, chunkSize) == chunkSize);
+      chunks.push_back(std::unique_ptr<StreamBlock>(new StreamBlock(buf, chunkSize)));
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    copyCost += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    EXPECT_TRUE(checkData(chunks.back()->cbuf(), (chunkNum - 1) * chunkSize, chunkSize));
+  }
+
+  // slice by views into the received blocks as CmafSegment does
+  double viewCost = 0;
+  for (size_t loop = 0; loop < loopNum; loop++) {
+    StreamBlocks stream;
+    fillStream(stream, blockNum, blockSize);
+    StreamChunkSlicer slicer;
+    while (stream.GetStreamSize()) slicer.push_back(stream.pop_front());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<StreamBlocks> chunks(chunkNum);
+    for (int64_t i = 0; i < chunkNum; i++) {
+      std::vector<std::unique_ptr<StreamBlock>> chunk;
+      std::chrono::steady_clock::time_point recvTime;
+      EXPECT_TRUE(slicer.slice(chunkSize, chunk, recvTime));
+      for (auto &sb : chunk) chunks[i].push_back(std::move(sb));
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    viewCost += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    std::vector<char> buf(chunkSize);
+    EXPECT_TRUE(chunks.back().ReadStreamFromOffset(buf.data(), 0, chunkSize) == chunkSize);
+    EXPECT_TRUE(checkData(buf.data(), (chunkNum - 1) * chunkSize, chunkSize));
+  }
+
+  printf("Slice %ld chunks: copy %f us/segment, view %f us/segment\n", chunkNum, copyCost / loopNum / 1000,
+         viewCost / loopNum / 1000);
+}
+
+TEST_F(StreamBlocksPerfTest, ChunkSliceOrder) {
+  // blocks of irregular sizes, chunks spanning several blocks or ending in the middle of one
+  const int64_t blockSizes[] = {7, 100, 1, 33, 250, 2, 64, 43};
+  const int64_t chunkSizes[] = {50, 3, 151, 1, 200, 75};
+  const size_t blockNum = sizeof(blockSizes) / sizeof(blockSizes[0]);
+  const size_t chunkNum = sizeof(chunkSizes) / sizeof(chunkSizes[0]);
+
+  auto makeBlock = [](int64_t offset, int64_t size) {
+    std::unique_ptr<StreamBlock> sb(new StreamBlock());
+    char *data = static_cast<char *>(sb->resize(size));
+    for (int64_t j = 0; j < size; j++) data[j] = static_cast<char>((offset + j) & 0xff);
+    sb->size(size);
+    return sb;
+  };
+
+  // the index of chunk sizes arrives before the data, with the first blocks, or after all data
+  for (size_t indexAt = 0; indexAt <= blockNum; indexAt++) {
+    StreamChunkSlicer slicer;
+    std::vector<StreamBlocks> chunks(chunkNum);
+    size_t sliced = 0;
+    int64_t offset = 0;
+    for (size_t i = 0; i <= blockNum; i++) {
+      if (i > 0) {
+        slicer.push_back(makeBlock(offset, blockSizes[i - 1]));
+        offset += blockSizes[i - 1];
+      }
+      if (i < indexAt) continue;
+      // slice the chunks received completely, as CmafSegment does on each block
+      while (sliced < chunkNum) {
+        std::vector<std::unique_ptr<StreamBlock>> chunk;
+        std::chrono::steady_clock::time_point recvTime;
+        if (!slicer.slice(chunkSizes[sliced], chunk, recvTime)) break;
+        for (auto &sb : chunk) chunks[sliced].push_back(std::move(sb));
+        sliced++;
+      }
+    }
+    ASSERT_TRUE(sliced == chunkNum);
+
+    int64_t chunkOffset = 0;
+    for (size_t i = 0; i < chunkNum; i++) {
+      std::vector<char> buf(chunkSizes[i]);
+      EXPECT_TRUE(chunks[i].GetStreamSize() == chunkSizes[i]);
+      EXPECT_TRUE(chunks[i].ReadStreamFromOffset(buf.data(), 0, chunkSizes[i]) == chunkSizes[i]);
+      EXPECT_TRUE(checkData(buf.data(), chunkOffset, chunkSizes[i]));
+      chunkOffset += chunkSizes[i];
+    }
+    // the data behind the last chunk isn't sliced
+    std::vector<std::unique_ptr<StreamBlock>> chunk;
+    std::chrono::steady_clock::time_point recvTime;
+    EXPECT_FALSE(slicer.slice(offset - chunkOffset + 1, chunk, recvTime));
+    EXPECT_TRUE(slicer.slice(offset - chunkOffset, chunk, recvTime));
+  }
+}
+
+TEST_F(StreamBlocksPerfTest, ChunkSliceReceiveTime) {
+  StreamChunkSlicer slicer;
+  std::unique_ptr<StreamBlock> first(new StreamBlock());
+  first->resize(100);
+  first->size(100);
+  slicer.push_back(std::move(first));
+  std::chrono::steady_clock::time_point afterFirst = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  std::unique_ptr<StreamBlock> second(new StreamBlock());
+  second->resize(100);
+  second->size(100);
+  slicer.push_back(std::move(second));
+
+  // the chunk ready time is the receive time of its last block
+  std::vector<std::unique_ptr<StreamBlock>> chunk;
+  std::chrono::steady_clock::time_point recvTime;
+  EXPECT_TRUE(slicer.slice(100, chunk, recvTime));
+  EXPECT_TRUE(recvTime <= afterFirst);
+  EXPECT_TRUE(slicer.slice(50, chunk, recvTime));
+  EXPECT_TRUE(recvTime > afterFirst);
+}
+
+TEST_F(StreamBlocksPerfTest, SampleReadBandwidth) {
+  // curl hands over the segment in blocks of at most 16 KB
+  const int64_t blockSize = 16 * 1024;
+  const uint32_t loopNum = 3;
+
+  VCD::MP4::Mp4Reader copyReader;
+  VCD::MP4::Mp4Reader viewReader;
+  if (access("./segs_for_readertest/Test_track1.init.mp4", R_OK) != 0) {
+    printf("No reader test segments, skip the sample read bandwidth test\n");
+    return;
+  }
+  ASSERT_TRUE(loadSegments<CopyStreamBlocks>(copyReader, blockSize));
+  ASSERT_TRUE(loadSegments<StreamBlocks>(viewReader, blockSize));
+
+  VCD::MP4::VarLenArray<VCD::MP4::TrackInformation> trackInfos;
+  viewReader.GetTrackInformations(trackInfos);
+
+  // read every sample into a packet as cachePackets does
+  //   fill: zero filled packet, every read copied out of the blocks as before
+  //   copy: packet written only by the sample data, reads still copied out
+  //   view: packet written only by the sample data, the sample is copied or
+  //         parsed in place when it is in one block
+  enum { FILL = 0, COPY, VIEW, MODE_NUM };
+  const char *modeNames[MODE_NUM] = {"fill", "copy", "view"};
+  const char *kindNames[2] = {"tile", "extractor"};
+  uint64_t frameNum[2] = {0};
+  uint64_t bytes[2][MODE_NUM] = {{0}};
+  double cost[2][MODE_NUM] = {{0}};
+  for (uint32_t loop = 0; loop < loopNum; loop++) {
+    for (size_t i = 0; i < trackInfos.size; i++) {
+      uint32_t trackId = trackInfos[i].trackId;
+      // extractor tracks are read with the tile tracks they refer to
+      int kind = ((trackId >> 16) >= 1000) ? 1 : 0;
+      for (size_t j = 0; j < trackInfos[i].sampleProperties.size; j++) {
+        uint32_t sampleId = trackInfos[i].sampleProperties[j].sampleId;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        if (viewReader.GetDims(trackId, sampleId, width, height) != ERROR_NONE) continue;
+        uint32_t packetSize = ((width * height * 3) >> 1) >> 1;
+
+        MediaPacket packets[MODE_NUM];
+        uint32_t sizes[MODE_NUM];
+        for (int mode = FILL; mode < MODE_NUM; mode++) {
+          VCD::MP4::Mp4Reader &reader = (mode == VIEW) ? viewReader : copyReader;
+          sizes[mode] = packetSize;
+          std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+          if (mode == FILL) {
+            packets[mode].AllocatePacket(packetSize);
+          } else {
+            packets[mode].AllocatePayload(packetSize);
+          }
+          int32_t ret = kind ? reader.GetExtractorTrackSampData(trackId, sampleId, packets[mode].Payload(), sizes[mode])
+                             : reader.GetSampData(trackId, sampleId, packets[mode].Payload(), sizes[mode]);
+          std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+          cost[kind][mode] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+          ASSERT_TRUE(ret == ERROR_NONE);
+          bytes[kind][mode] += sizes[mode] + ((mode == FILL) ? packetSize : 0);
+        }
+        ASSERT_TRUE(sizes[FILL] == sizes[VIEW] && sizes[COPY] == sizes[VIEW]);
+        EXPECT_TRUE(memcmp(packets[FILL].Payload(), packets[VIEW].Payload(), sizes[VIEW]) == 0);
+        EXPECT_TRUE(memcmp(packets[COPY].Payload(), packets[VIEW].Payload(), sizes[VIEW]) == 0);
+        frameNum[kind]++;
+      }
+    }
+  }
+
+  for (int kind = 0; kind < 2; kind++) {
+    ASSERT_TRUE(frameNum[kind] > 0);
+    EXPECT_TRUE(bytes[kind][FILL] >= 2 * bytes[kind][VIEW]);
+    for (int mode = FILL; mode < MODE_NUM; mode++) {
+      printf("%s samples %lu, %s: written %lu bytes/frame, %f ns/frame\n", kindNames[kind], frameNum[kind],
+             modeNames[mode], bytes[kind][mode] / frameNum[kind], cost[kind][mode] / frameNum[kind]);
+    }
+  }
+}
+}  // namespace
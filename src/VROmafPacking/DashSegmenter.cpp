@@ -66,6 +66,8 @@ void DashSegmenter::SetSegmentWriter(VCD::MP4::SegmentWriterBase *segWriter)
 DashSegmenter::~DashSegmenter()
 {
     m_segWriter = NULL;
+    m_fileWriter = NULL;
+    DELETE_MEMORY(m_segBuffer);
 }
 
 int32_t DashSegmenter::SegmentData(TrackSegmentCtx *trackSegCtx)
@@ -160,23 +162,30 @@ int32_t DashSegmenter::WriteSegment(char *baseName)
 {
     if (!m_config.cmafEnabled)
     {
-        std::ostringstream frameStream;
-
-        m_segWriter->WriteSegments(frameStream, &(m_segNum), m_segName, baseName, NULL);
-
-        std::string frameString(frameStream.str());
+        if (!m_fileWriter)
+            return OMAF_ERROR_NULL_PTR;
 
-        if (frameString.size())
+        if (!m_segBuffer)
         {
-            m_file = fopen(m_segName, "wb+");
-            if (!m_file)
+            m_segBuffer = new SegmentBuffer(m_fileWriter);
+            if (!m_segBuffer)
                 return OMAF_ERROR_NULL_PTR;
+        }
+
+        std::ostream frameStream(m_segBuffer);
+        m_segWriter->WriteSegments(frameStream, &(m_segNum), m_segName, baseName, NULL);
+        if (!frameStream)
+            return OMAF_ERROR_FILE_WRITE;
 
-            m_segSize = frameString.size();
-            fwrite(frameString.c_str(), 1, frameString.size(), m_file);
+        if (m_segBuffer->GetSize())
+        {
+            m_segSize = m_segBuffer->GetSize();
 
-            fclose(m_file);
-            m_file = NULL;
+            // segment buffer is owned by file writer from now on
+            int32_t ret = m_fileWriter->WriteFile(m_segBuffer, m_segName);
+            m_segBuffer = NULL;
+            if (ret)
+                return ret;
         }
     }
     else
@@ -50,6 +50,7 @@
 #include "OmafPackingCommon.h"
 #include "MediaStream.h"
 #include "ExtractorTrack.h"
+#include "SegmentFileWriter.h"
 
 VCD_NS_BEGIN
 
@@ -371,6 +372,17 @@ public:
 
     void SetSegmentWriter(VCD::MP4::SegmentWriterBase *segWriter);
 
+    //!
+    //! \brief  Set the writer of segment files
+    //!
+    //! \param  [in] fileWriter
+    //!         pointer to the segment file writer shared
+    //!         by all tracks
+    //!
+    //! \return void
+    //!
+    void SetFileWriter(SegmentFileWriter *fileWriter) { m_fileWriter = fileWriter; };
+
 protected:
 
     //!
@@ -470,7 +482,8 @@ private:
     uint64_t                                                          m_segNum = 0;            //!< current segments number
     uint64_t                                                          m_subSegNum = 0;
     std::ostringstream                                                m_frameStream;
-    FILE                                                              *m_file = NULL;          //!< file pointer to write segments
+    SegmentFileWriter                                                 *m_fileWriter = NULL;    //!< writer of segment files
+    SegmentBuffer                                                     *m_segBuffer = NULL;     //!< buffer of the segment being written
     char                                                              m_segName[1024];           //!< segment file name string
     uint64_t                                                          m_segSize = 0;
     uint64_t                                                          m_prevSegSize = 0;
@@ -52,6 +52,9 @@ VCD_NS_BEGIN
 
 DefaultSegmentation::~DefaultSegmentation()
 {
+    DELETE_MEMORY(m_pipeline);
+    DELETE_MEMORY(m_etTaskPool);
+
     std::map<MediaStream*, TrackSegmentCtx*>::iterator itTrackCtx;
     for (itTrackCtx = m_streamSegCtx.begin();
         itTrackCtx != m_streamSegCtx.end();
@@ -145,21 +148,6 @@ DefaultSegmentation::~DefaultSegmentation()
     }
     m_extractorASCtx.clear();
 
-    if (m_extractorThreadIds.size())
-    {
-        std::map<pthread_t, ExtractorTrack*>::iterator itThreadId;
-        for (itThreadId = m_extractorThreadIds.begin(); itThreadId != m_extractorThreadIds.end(); )
-        {
-            pthread_t oneThread = itThreadId->first;
-            if (oneThread)
-            {
-                pthread_join(oneThread, NULL);
-            }
-            m_extractorThreadIds.erase(itThreadId++);
-        }
-        m_extractorThreadIds.clear();
-    }
-
     DELETE_ARRAY(m_videosBitrate);
 
     if (m_mpdWriterPluginHdl)
@@ -548,6 +536,7 @@ int32_t DefaultSegmentation::ConstructTileTrackSegCtx()
                     return OMAF_ERROR_NULL_PTR;
                 }
                 (trackSegCtxs[i].dashSegmenter)->SetSegmentWriter(trackSegCtxs[i].segWriter);
+                (trackSegCtxs[i].dashSegmenter)->SetFileWriter(m_segFileWriter);
 
                 trackSegCtxs[i].qualityRanking = qualityLevel;
 
@@ -844,6 +833,7 @@ int32_t DefaultSegmentation::ConstructExtractorTrackSegCtx()
                 return OMAF_ERROR_NULL_PTR;
             }
             (trackSegCtx->dashSegmenter)->SetSegmentWriter(trackSegCtx->segWriter);
+            (trackSegCtx->dashSegmenter)->SetFileWriter(m_segFileWriter);
 
             //set up CodedMeta
             trackSegCtx->codedMeta.presIndex = 0;
@@ -1015,6 +1005,7 @@ int32_t DefaultSegmentation::ConstructAudioTrackSegCtx()
                 return OMAF_ERROR_NULL_PTR;
             }
             (trackSegCtx->dashSegmenter)->SetSegmentWriter(trackSegCtx->segWriter);
+            (trackSegCtx->dashSegmenter)->SetFileWriter(m_segFileWriter);
 
             trackSegCtx->qualityRanking = DEFAULT_QUALITY_RANK;
 
@@ -1266,237 +1257,46 @@ int32_t DefaultSegmentation::WriteSegmentForEachExtractorTrack(
     return ERROR_NONE;
 }
 
-int32_t DefaultSegmentation::StartExtractorTrackSegmentation(
-    ExtractorTrack *extractorTrack)
+int32_t DefaultSegmentation::ExtractorTrackSegmentation(ExtractorTrack *extractorTrack)
 {
-    pthread_t threadId;
-    int32_t ret = pthread_create(&threadId, NULL, ExtractorTrackSegThread, this);
+    if (!extractorTrack)
+        return OMAF_ERROR_NULL_PTR;
 
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    extractorTrack->ConstructExtractors();
+    std::chrono::steady_clock::time_point generated = std::chrono::steady_clock::now();
+    int32_t ret = WriteSegmentForEachExtractorTrack(extractorTrack, m_nowKeyFrame, m_isEOS);
     if (ret)
     {
-        OMAF_LOG(LOG_ERROR, "Failed to create extractor track segmentation thread !\n");
-        return OMAF_ERROR_CREATE_THREAD;
+        OMAF_LOG(LOG_ERROR, "Failed to write segment for extractor track, error %d !\n", ret);
+        return ret;
     }
+    m_etGenerateTime += std::chrono::duration_cast<std::chrono::microseconds>(generated - start).count();
+    m_etWriteTime += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - generated).count();
 
-    m_extractorThreadIds.insert(std::make_pair(threadId, extractorTrack));
-    return ERROR_NONE;
-}
-
-int32_t DefaultSegmentation::StartLastExtractorTrackSegmentation(
-    ExtractorTrack *extractorTrack)
-{
-    pthread_t threadId;
-    int32_t ret = pthread_create(&threadId, NULL, LastExtractorTrackSegThread, this);
-
-    if (ret)
+    std::map<ExtractorTrack*, TrackSegmentCtx*>::iterator itET;
+    itET = m_extractorSegCtx.find(extractorTrack);
+    if (itET == m_extractorSegCtx.end())
     {
-        OMAF_LOG(LOG_ERROR, "Failed to create extractor track segmentation thread !\n");
-        return OMAF_ERROR_CREATE_THREAD;
+        OMAF_LOG(LOG_ERROR, "Can't find segmentation context for specified extractor track !\n");
+        return OMAF_ERROR_INVALID_DATA;
     }
+    TrackSegmentCtx *trackSegCtx = itET->second;
 
-    m_extractorThreadIds.insert(std::make_pair(threadId, extractorTrack));
-    return ERROR_NONE;
-}
-
-void *DefaultSegmentation::ExtractorTrackSegThread(void *pThis)
-{
-    DefaultSegmentation *defaultSegmentation = (DefaultSegmentation*)pThis;
-
-    defaultSegmentation->ExtractorTrackSegmentation();
-
-    return NULL;
-}
-
-void *DefaultSegmentation::LastExtractorTrackSegThread(void *pThis)
-{
-    DefaultSegmentation *defaultSegmentation = (DefaultSegmentation*)pThis;
-
-    defaultSegmentation->LastExtractorTrackSegmentation();
-
-    return NULL;
-}
-
-int32_t DefaultSegmentation::ExtractorTrackSegmentation()
-{
-    bool isFrameReady = false;
-    ExtractorTrack *extractorTrack = NULL;
-    pthread_t threadId = pthread_self();
-    if (threadId == 0)
+    if (m_segNum == (m_prevSegNum + 1))
     {
-        OMAF_LOG(LOG_ERROR, "NULL thread id for extractor track segmentation !\n");
-        return OMAF_ERROR_INVALID_THREAD;
+        extractorTrack->DestroyCurrSegNalus();
     }
 
-    while(1)
+    if (trackSegCtx->extractorTrackNalu.data)
     {
-        std::map<pthread_t, ExtractorTrack*>::iterator itETThread;
-        itETThread = m_extractorThreadIds.find(threadId);
-        if (itETThread != m_extractorThreadIds.end())
-        {
-            extractorTrack = itETThread->second;
-            break;
-        }
-        usleep(50);
+        extractorTrack->AddExtractorsNaluToSeg(trackSegCtx->extractorTrackNalu.data);
+        trackSegCtx->extractorTrackNalu.data = NULL;
     }
+    trackSegCtx->extractorTrackNalu.dataSize = 0;
 
-    while(1)
-    {
-
-        std::map<uint16_t, ExtractorTrack*> *extractorTracks = m_extractorTrackMan->GetAllExtractorTracks();
-        std::map<uint16_t, ExtractorTrack*>::iterator itExtractorTrack;
-
-        for (itExtractorTrack = extractorTracks->begin();
-            itExtractorTrack != extractorTracks->end(); itExtractorTrack++)
-        {
-            if (itExtractorTrack->second == extractorTrack)
-                break;
-        }
-        if (itExtractorTrack == extractorTracks->end())
-        {
-            OMAF_LOG(LOG_ERROR, "Can't find specified Extractor Track!\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-        isFrameReady = ((m_currSegedFrmNum == (m_prevSegedFrmNum + 1)) && (extractorTrack->GetProcessedFrmNum() == m_currProcessedFrmNum) && (m_currSegedFrmNum == (m_currProcessedFrmNum + 1)));
-        while (!isFrameReady)
-        {
-            usleep(50);
-            isFrameReady = ((m_currSegedFrmNum == (m_prevSegedFrmNum + 1)) && (extractorTrack->GetProcessedFrmNum() == m_currProcessedFrmNum) && (m_currSegedFrmNum == (m_currProcessedFrmNum + 1)));
-        }
-
-        uint8_t etId = 0;
-        for ( ; etId < m_aveETPerSegThread; etId++)
-        {
-
-            if (itExtractorTrack == extractorTracks->end())
-            {
-                OMAF_LOG(LOG_ERROR, "Can't find specified Extractor Track!\n");
-                return OMAF_ERROR_INVALID_DATA;
-            }
-
-            ExtractorTrack *extractorTrack1 = itExtractorTrack->second;
-
-            extractorTrack1->ConstructExtractors();
-            WriteSegmentForEachExtractorTrack(extractorTrack1, m_nowKeyFrame, m_isEOS);
-
-            std::map<ExtractorTrack*, TrackSegmentCtx*>::iterator itET;
-            itET = m_extractorSegCtx.find(extractorTrack1);
-            if (itET == m_extractorSegCtx.end())
-            {
-                OMAF_LOG(LOG_ERROR, "Can't find segmentation context for specified extractor track !\n");
-                return OMAF_ERROR_INVALID_DATA;
-            }
-            TrackSegmentCtx *trackSegCtx = itET->second;
-
-            if (m_segNum == (m_prevSegNum + 1))
-            {
-                extractorTrack1->DestroyCurrSegNalus();
-            }
-
-            if (trackSegCtx->extractorTrackNalu.data)
-            {
-                extractorTrack1->AddExtractorsNaluToSeg(trackSegCtx->extractorTrackNalu.data);
-                trackSegCtx->extractorTrackNalu.data = NULL;
-            }
-            trackSegCtx->extractorTrackNalu.dataSize = 0;
-
-            extractorTrack1->IncreaseProcessedFrmNum();
-            itExtractorTrack++;
-        }
-        if (m_isEOS)
-            break;
-    }
-
-    return ERROR_NONE;
-}
-
-int32_t DefaultSegmentation::LastExtractorTrackSegmentation()
-{
-    bool isFrameReady = false;
-    ExtractorTrack *extractorTrack = NULL;
-    pthread_t threadId = pthread_self();
-    if (threadId == 0)
-    {
-        OMAF_LOG(LOG_ERROR, "NULL thread id for extractor track segmentation !\n");
-        return OMAF_ERROR_INVALID_THREAD;
-    }
-
-    while(1)
-    {
-        std::map<pthread_t, ExtractorTrack*>::iterator itETThread;
-        itETThread = m_extractorThreadIds.find(threadId);
-        if (itETThread != m_extractorThreadIds.end())
-        {
-            extractorTrack = itETThread->second;
-            break;
-        }
-        usleep(50);
-    }
-
-    while(1)
-    {
-        std::map<uint16_t, ExtractorTrack*> *extractorTracks = m_extractorTrackMan->GetAllExtractorTracks();
-        std::map<uint16_t, ExtractorTrack*>::iterator itExtractorTrack;
-
-        for (itExtractorTrack = extractorTracks->begin();
-            itExtractorTrack != extractorTracks->end(); itExtractorTrack++)
-        {
-            if (itExtractorTrack->second == extractorTrack)
-                break;
-        }
-        if (itExtractorTrack == extractorTracks->end())
-        {
-            OMAF_LOG(LOG_ERROR, "Can't find specified Extractor Track!\n");
-            return OMAF_ERROR_INVALID_DATA;
-        }
-
-        isFrameReady = ((m_currSegedFrmNum == (m_prevSegedFrmNum + 1)) && (extractorTrack->GetProcessedFrmNum() == m_currProcessedFrmNum) && (m_currSegedFrmNum == (m_currProcessedFrmNum + 1)));
-        while (!isFrameReady)
-        {
-            usleep(50);
-            isFrameReady = ((m_currSegedFrmNum == (m_prevSegedFrmNum + 1)) && (extractorTrack->GetProcessedFrmNum() == m_currProcessedFrmNum) && (m_currSegedFrmNum == (m_currProcessedFrmNum + 1)));
-        }
-
-        uint8_t etId = 0;
-        for ( ; etId < m_lastETPerSegThread; etId++)
-        {
-
-            if (itExtractorTrack == extractorTracks->end())
-            {
-                OMAF_LOG(LOG_ERROR, "Can't find specified Extractor Track!\n");
-                return OMAF_ERROR_INVALID_DATA;
-            }
-
-            ExtractorTrack *extractorTrack1 = itExtractorTrack->second;
-            extractorTrack1->ConstructExtractors();
-            WriteSegmentForEachExtractorTrack(extractorTrack1, m_nowKeyFrame, m_isEOS);
-
-            std::map<ExtractorTrack*, TrackSegmentCtx*>::iterator itET;
-            itET = m_extractorSegCtx.find(extractorTrack1);
-            if (itET == m_extractorSegCtx.end())
-            {
-                OMAF_LOG(LOG_ERROR, "Can't find segmentation context for specified extractor track !\n");
-                return OMAF_ERROR_INVALID_DATA;
-            }
-            TrackSegmentCtx *trackSegCtx = itET->second;
-
-            if (m_segNum == (m_prevSegNum + 1))
-            {
-                extractorTrack1->DestroyCurrSegNalus();
-            }
-
-            if (trackSegCtx->extractorTrackNalu.data)
-            {
-                extractorTrack1->AddExtractorsNaluToSeg(trackSegCtx->extractorTrackNalu.data);
-                trackSegCtx->extractorTrackNalu.data = NULL;
-            }
-            trackSegCtx->extractorTrackNalu.dataSize = 0;
-
-            extractorTrack1->IncreaseProcessedFrmNum();
-            itExtractorTrack++;
-        }
-        if (m_isEOS)
-            break;
-    }
+    extractorTrack->IncreaseProcessedFrmNum();
 
     return ERROR_NONE;
 }
@@ -1687,22 +1487,38 @@ int32_t DefaultSegmentation::VideoSegmentation()
     uint16_t extractorTrackNum = m_extractorSegCtx.size();
     if (extractorTrackNum)
     {
-        if (extractorTrackNum % m_segInfo->extractorTracksPerSegThread == 0)
+        if (m_segInfo->segWorkersNum > 0)
         {
-            m_aveETPerSegThread = m_segInfo->extractorTracksPerSegThread;
-            m_lastETPerSegThread = m_segInfo->extractorTracksPerSegThread;
-            m_threadNumForET = extractorTrackNum / m_segInfo->extractorTracksPerSegThread;
+            m_threadNumForET = m_segInfo->segWorkersNum;
         }
         else
         {
-            m_aveETPerSegThread = m_segInfo->extractorTracksPerSegThread;
-            m_lastETPerSegThread = extractorTrackNum % m_segInfo->extractorTracksPerSegThread;
-            m_threadNumForET = extractorTrackNum / m_segInfo->extractorTracksPerSegThread + 1;
+            uint8_t etPerThread = m_segInfo->extractorTracksPerSegThread ? m_segInfo->extractorTracksPerSegThread : 1;
+            m_threadNumForET = (extractorTrackNum + etPerThread - 1) / etPerThread;
         }
 
-        OMAF_LOG(LOG_INFO, "Lanuch %d threads for Extractor Track segmentation!\n", m_threadNumForET);
-        OMAF_LOG(LOG_INFO, "Average Extractor Track number per thread is %d\n", m_aveETPerSegThread);
-        OMAF_LOG(LOG_INFO, "The last thread involves %d Extractor Tracks !\n", m_lastETPerSegThread);
+        m_etTaskPool = new SegmentationTaskPool;
+        if (!m_etTaskPool)
+            return OMAF_ERROR_NULL_PTR;
+
+        ret = m_etTaskPool->Initialize(m_threadNumForET);
+        if (ret)
+            return ret;
+
+        OMAF_LOG(LOG_INFO, "Lanuch %d workers for Extractor Tracks segmentation!\n", m_threadNumForET);
+    }
+
+    if (m_segInfo->pipelineDepth > 0)
+    {
+        m_pipeline = new SegmentationPipeline;
+        if (!m_pipeline)
+            return OMAF_ERROR_NULL_PTR;
+
+        ret = m_pipeline->Initialize(m_streamMap, m_segInfo->pipelineDepth);
+        if (ret)
+            return ret;
+
+        OMAF_LOG(LOG_INFO, "NAL parsing runs up to %d frames ahead of segmentation !\n", m_segInfo->pipelineDepth);
     }
 
 #ifdef _USE_TRACE_
@@ -1738,10 +1554,23 @@ int32_t DefaultSegmentation::VideoSegmentation()
 
             if (m_segInfo->isLive)
             {
+                m_segFileWriter->Flush();
                 m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
             }
         }
 
+        std::map<MediaStream*, ParsedFrame> parsedFrames;
+        if (m_pipeline)
+        {
+            std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+            ret = m_pipeline->PopFrames(parsedFrames);
+            if (ret)
+                return ret;
+            m_stageTiming.parseWaitTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - waitStart).count();
+        }
+
+        std::map<uint8_t, int64_t> framesPts;
         std::map<uint8_t, MediaStream*>::iterator itStream = m_streamMap->begin();
         for ( ; itStream != m_streamMap->end(); itStream++)
         {
@@ -1749,22 +1578,36 @@ int32_t DefaultSegmentation::VideoSegmentation()
             if (stream->GetMediaType() == VIDEOTYPE)
             {
                 VideoStream *vs = (VideoStream*)stream;
-                vs->SetCurrFrameInfo();
-                FrameBSInfo *currFrame = vs->GetCurrFrameInfo();
-
-                while (!currFrame)
+                FrameBSInfo *currFrame = NULL;
+                if (m_pipeline)
+                {
+                    // tiles nalu have been parsed ahead, only hand over the frame
+                    ParsedFrame &parsed = parsedFrames[stream];
+                    vs->SetCurrFrameInfo(parsed.frameInfo, parsed.tilesNalu);
+                    DELETE_ARRAY(parsed.tilesNalu);
+                    parsed.frameInfo = NULL;
+                    currFrame = vs->GetCurrFrameInfo();
+                }
+                else
                 {
-                    usleep(50);
                     vs->SetCurrFrameInfo();
                     currFrame = vs->GetCurrFrameInfo();
-                    if (!currFrame && (vs->GetEOS()))
-                        break;
+
+                    while (!currFrame)
+                    {
+                        usleep(50);
+                        vs->SetCurrFrameInfo();
+                        currFrame = vs->GetCurrFrameInfo();
+                        if (!currFrame && (vs->GetEOS()))
+                            break;
+                    }
                 }
 
                 if (currFrame)
                 {
                     m_framesIsKey[vs] = currFrame->isKeyFrame;
                     m_streamsIsEOS[vs] = false;
+                    framesPts[itStream->first] = currFrame->pts;
 
 #ifdef _USE_TRACE_
                     //trace
@@ -1776,8 +1619,24 @@ int32_t DefaultSegmentation::VideoSegmentation()
                                 &resolution[0], &tileSplit[0], m_framesNum, currFrame->dataSize);
 #endif
 
-                    vs->UpdateTilesNalu();
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    if (!m_pipeline)
+                    {
+                        ret = vs->UpdateTilesNalu();
+                        if (ret)
+                        {
+                            OMAF_LOG(LOG_ERROR, "Failed to parse tiles nalu for frame with pts %ld !\n", currFrame->pts);
+                            return ret;
+                        }
+                    }
+                    std::chrono::steady_clock::time_point parsed = std::chrono::steady_clock::now();
                     WriteSegmentForEachVideo(vs, currFrame->isKeyFrame, false);
+                    if (!m_pipeline)
+                    {
+                        m_stageTiming.parseTime += std::chrono::duration_cast<std::chrono::microseconds>(parsed - start).count();
+                    }
+                    m_stageTiming.tileWriteTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - parsed).count();
                 }
                 else
                 {
@@ -1815,91 +1674,45 @@ int32_t DefaultSegmentation::VideoSegmentation()
         }
         m_isEOS = nowEOS;
 
-        m_currSegedFrmNum++;
-
         std::map<uint16_t, ExtractorTrack*> *extractorTracks = m_extractorTrackMan->GetAllExtractorTracks();
-        if (extractorTracks->size())
+        if (extractorTracks->size() && m_etTaskPool)
         {
+            std::chrono::steady_clock::time_point etStart = std::chrono::steady_clock::now();
+            // each extractor track of current frame is one task, and the
+            // frame is done once the latch is released by all the tasks
+            FrameLatch frameLatch(extractorTracks->size());
+            std::atomic<int32_t> etRet(ERROR_NONE);
             std::map<uint16_t, ExtractorTrack*>::iterator itExtractorTrack = extractorTracks->begin();
-            for ( ; itExtractorTrack != extractorTracks->end(); /*itExtractorTrack++*/)
+            for ( ; itExtractorTrack != extractorTracks->end(); itExtractorTrack++)
             {
                 ExtractorTrack *extractorTrack = itExtractorTrack->second;
-                if (m_extractorThreadIds.size() < m_threadNumForET)
-                {
-                    if (m_aveETPerSegThread == m_lastETPerSegThread)
+                int32_t retET = m_etTaskPool->Submit([this, extractorTrack, &frameLatch, &etRet]() {
+                    int32_t oneRet = ExtractorTrackSegmentation(extractorTrack);
+                    if (oneRet)
                     {
-                        int32_t retET = StartExtractorTrackSegmentation(extractorTrack);
-                        if (retET)
-                            return retET;
-
-                        for (uint16_t num = 0; num < m_aveETPerSegThread; num++)
-                        {
-                            if (itExtractorTrack != extractorTracks->end())
-                            {
-                                itExtractorTrack++;
-                            }
-                        }
+                        int32_t expected = ERROR_NONE;
+                        etRet.compare_exchange_strong(expected, oneRet);
                     }
-                    else
-                    {
-                        if ((uint16_t)(m_extractorThreadIds.size()) < (m_threadNumForET - 1))
-                        {
-                            int32_t retET = StartExtractorTrackSegmentation(extractorTrack);
-                            if (retET)
-                                return retET;
-
-                            for (uint16_t num = 0; num < m_aveETPerSegThread; num++)
-                            {
-                                if (itExtractorTrack != extractorTracks->end())
-                                {
-                                    itExtractorTrack++;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            int32_t retET = StartLastExtractorTrackSegmentation(extractorTrack);
-                            if (retET)
-                                return retET;
-
-                            for ( ; itExtractorTrack != extractorTracks->end(); )
-                            {
-                                itExtractorTrack++;
-                            }
-                        }
-                    }
-                }
-                else
+                    frameLatch.CountDown();
+                });
+                if (retET)
                 {
-                    break;
-                }
-            }
-            if (m_extractorThreadIds.size() != m_threadNumForET)
-            {
-                 OMAF_LOG(LOG_ERROR, "Launched threads number %ld doesn't match calculated threads number %d\n", (m_extractorThreadIds.size()), m_threadNumForET);
-            }
-
-            usleep(2000);
-
-            for (itExtractorTrack = extractorTracks->begin();
-                itExtractorTrack != extractorTracks->end();
-                itExtractorTrack++)
-            {
-                ExtractorTrack *extractorTrack = itExtractorTrack->second;
-                while (extractorTrack->GetProcessedFrmNum() == m_framesNum)
-                {
-                    usleep(1);
-
-                    if (extractorTrack->GetProcessedFrmNum() == (m_framesNum + 1))
+                    // tasks already submitted still count down on the latch
+                    for ( ; itExtractorTrack != extractorTracks->end(); itExtractorTrack++)
                     {
-                        break;
+                        frameLatch.CountDown();
                     }
+                    frameLatch.Wait();
+                    return retET;
                 }
             }
-        }
+            frameLatch.Wait();
+            m_stageTiming.etStageTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - etStart).count();
 
-        m_prevSegedFrmNum++;
-        m_currProcessedFrmNum++;
+            if (etRet != ERROR_NONE)
+                return etRet;
+        }
 
         for (itStream = m_streamMap->begin(); itStream != m_streamMap->end(); itStream++)
         {
@@ -1920,6 +1733,7 @@ int32_t DefaultSegmentation::VideoSegmentation()
         if (m_segNum == (m_prevSegNum + 1))
         {
             m_prevSegNum++;
+            MarkSegmentWritten();
 
             std::chrono::high_resolution_clock clock;
             uint64_t before = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
@@ -1927,6 +1741,7 @@ int32_t DefaultSegmentation::VideoSegmentation()
             currentT = before;
             if (m_isCMAFEnabled && m_segInfo->isLive)
             {
+                m_segFileWriter->Flush();
                 m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
             }
 
@@ -1952,7 +1767,7 @@ int32_t DefaultSegmentation::VideoSegmentation()
                         VCD::MP4::TrackId trackIndex = itOneTrack->first;
                         char rmFile[1024];
                         snprintf(rmFile, 1024, "%s%s_track%d.%d.mp4", m_segInfo->dirName, m_segInfo->outName, trackIndex.GetIndex(), removeCnt);
-                        remove(rmFile);
+                        m_segFileWriter->RemoveFile(rmFile);
                     }
                     if (m_extractorSegCtx.size())
                     {
@@ -1965,15 +1780,23 @@ int32_t DefaultSegmentation::VideoSegmentation()
                             VCD::MP4::TrackId trackIndex = trackSegCtx->trackIdx;
                             char rmFile[1024];
                             snprintf(rmFile, 1024, "%s%s_track%d.%d.mp4", m_segInfo->dirName, m_segInfo->outName, trackIndex.GetIndex(), removeCnt);
-                            remove(rmFile);
+                            m_segFileWriter->RemoveFile(rmFile);
                         }
                     }
                 }
             }
         }
 
+        // frames of this round belong to the segment just started
+        std::map<uint8_t, int64_t>::iterator itPts;
+        for (itPts = framesPts.begin(); itPts != framesPts.end(); itPts++)
+        {
+            MarkFrameSegmented(itPts->first, itPts->second);
+        }
+
         if (m_isEOS)
         {
+            MarkSegmentWritten();
             if (m_segInfo->isLive)
             {
                 if (hasAudio)
@@ -1999,7 +1822,10 @@ int32_t DefaultSegmentation::VideoSegmentation()
                         return OMAF_ERROR_TIMED_OUT;
                     }
                 }
-                int32_t ret = m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
+                int32_t ret = m_segFileWriter->Flush();
+                if (ret)
+                    return ret;
+                ret = m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
                 if (ret)
                     return ret;
             } else {
@@ -2037,11 +1863,20 @@ int32_t DefaultSegmentation::VideoSegmentation()
                     }
                 }
 
-                int32_t ret = m_mpdWriter->WriteMpd(m_framesNum);
+                int32_t ret = m_segFileWriter->Flush();
+                if (ret)
+                    return ret;
+                ret = m_mpdWriter->WriteMpd(m_framesNum);
                 if (ret)
                     return ret;
             }
             OMAF_LOG(LOG_INFO, "Totally write %ld frames into video tracks!\n", m_framesNum);
+
+            SegmentationStageTiming timing;
+            GetStageTiming(&timing);
+            OMAF_LOG(LOG_INFO, "NAL parse time in ms %ld, wait time for parsed frames in ms %ld\n", timing.parseTime / 1000, timing.parseWaitTime / 1000);
+            OMAF_LOG(LOG_INFO, "Tile tracks write time in ms %ld, extractor tracks stage time in ms %ld\n", timing.tileWriteTime / 1000, timing.etStageTime / 1000);
+            OMAF_LOG(LOG_INFO, "Extractors generation time in ms %ld, extractor tracks write time in ms %ld\n", timing.etGenerateTime / 1000, timing.etWriteTime / 1000);
             break;
         }
 #ifdef _USE_TRACE_
@@ -2057,6 +1892,21 @@ int32_t DefaultSegmentation::VideoSegmentation()
     return ERROR_NONE;
 }
 
+void DefaultSegmentation::GetStageTiming(SegmentationStageTiming *timing)
+{
+    if (!timing)
+        return;
+
+    *timing = m_stageTiming;
+    timing->framesNum = m_framesNum;
+    if (m_pipeline)
+    {
+        timing->parseTime = m_pipeline->GetParseTime();
+    }
+    timing->etGenerateTime = m_etGenerateTime;
+    timing->etWriteTime = m_etWriteTime;
+}
+
 int32_t DefaultSegmentation::AudioSegmentation()
 {
     OMAF_LOG(LOG_INFO, "Launch audio segmentation thread !\n");
@@ -2144,6 +1994,7 @@ int32_t DefaultSegmentation::AudioSegmentation()
             {
                 if (m_segInfo->isLive)
                 {
+                    m_segFileWriter->Flush();
                     m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
                 }
             }
@@ -2225,7 +2076,7 @@ int32_t DefaultSegmentation::AudioSegmentation()
                             VCD::MP4::TrackId trackIndex = oneSegCtx->trackIdx;
                             char rmFile[1024];
                             snprintf(rmFile, 1024, "%s%s_track%d.%d.mp4", m_segInfo->dirName, m_segInfo->outName, trackIndex.GetIndex(), removeCnt);
-                            remove(rmFile);
+                            m_segFileWriter->RemoveFile(rmFile);
                         }
                     }
                 }
@@ -2238,11 +2089,17 @@ int32_t DefaultSegmentation::AudioSegmentation()
             {
                 if (m_segInfo->isLive)
                 {
-                    int32_t ret = m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
+                    int32_t ret = m_segFileWriter->Flush();
+                    if (ret)
+                        return ret;
+                    ret = m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
                     if (ret)
                         return ret;
                 } else {
-                    int32_t ret = m_mpdWriter->WriteMpd(m_framesNum);
+                    int32_t ret = m_segFileWriter->Flush();
+                    if (ret)
+                        return ret;
+                    ret = m_mpdWriter->WriteMpd(m_framesNum);
                     if (ret)
                         return ret;
                 }
@@ -38,6 +38,8 @@
 #include <mutex>
 #include "Segmentation.h"
 #include "DashSegmenter.h"
+#include "SegmentationTaskPool.h"
+#include "SegmentationPipeline.h"
 
 VCD_NS_BEGIN
 
@@ -65,14 +67,14 @@ public:
         m_nowKeyFrame = false;
         m_prevSegNum = 0;
         m_isFramesReady = false;
-        m_aveETPerSegThread = 0;
-        m_lastETPerSegThread = 0;
         m_threadNumForET = 0;
+        m_etTaskPool = NULL;
+        m_pipeline = NULL;
+        memset_s(&m_stageTiming, sizeof(SegmentationStageTiming), 0);
+        m_etGenerateTime = 0;
+        m_etWriteTime = 0;
         m_videosNum = 0;
         m_videosBitrate = NULL;
-        m_prevSegedFrmNum = 0;
-        m_currSegedFrmNum = 0;
-        m_currProcessedFrmNum = 0;
         m_mpdWriter = NULL;
         m_isMpdGenInit = false;
     };
@@ -102,14 +104,14 @@ public:
         m_nowKeyFrame = false;
         m_prevSegNum = 0;
         m_isFramesReady = false;
-        m_aveETPerSegThread = 0;
-        m_lastETPerSegThread = 0;
         m_threadNumForET = 0;
+        m_etTaskPool = NULL;
+        m_pipeline = NULL;
+        memset_s(&m_stageTiming, sizeof(SegmentationStageTiming), 0);
+        m_etGenerateTime = 0;
+        m_etWriteTime = 0;
         m_videosNum = 0;
         m_videosBitrate = NULL;
-        m_prevSegedFrmNum = 0;
-        m_currSegedFrmNum = 0;
-        m_currProcessedFrmNum = 0;
         m_mpdWriter = NULL;
         m_isMpdGenInit = false;
     };
@@ -127,14 +129,14 @@ public:
         m_nowKeyFrame = src.m_nowKeyFrame;
         m_prevSegNum = src.m_prevSegNum;
         m_isFramesReady = src.m_isFramesReady;
-        m_aveETPerSegThread = src.m_aveETPerSegThread;
-        m_lastETPerSegThread = src.m_lastETPerSegThread;
         m_threadNumForET = src.m_threadNumForET;
+        m_etTaskPool = NULL;
+        m_pipeline = NULL;
+        memset_s(&m_stageTiming, sizeof(SegmentationStageTiming), 0);
+        m_etGenerateTime = 0;
+        m_etWriteTime = 0;
         m_videosNum = src.m_videosNum;
         m_videosBitrate = std::move(src.m_videosBitrate);
-        m_prevSegedFrmNum = src.m_prevSegedFrmNum;
-        m_currSegedFrmNum = src.m_currSegedFrmNum;
-        m_currProcessedFrmNum = src.m_currProcessedFrmNum;
         m_mpdWriter = std::move(src.m_mpdWriter);
         m_isMpdGenInit = src.m_isMpdGenInit;
     };
@@ -152,14 +154,14 @@ public:
         m_nowKeyFrame = other.m_nowKeyFrame;
         m_prevSegNum = other.m_prevSegNum;
         m_isFramesReady = other.m_isFramesReady;
-        m_aveETPerSegThread = other.m_aveETPerSegThread;
-        m_lastETPerSegThread = other.m_lastETPerSegThread;
         m_threadNumForET = other.m_threadNumForET;
+        m_etTaskPool = NULL;
+        m_pipeline = NULL;
+        memset_s(&m_stageTiming, sizeof(SegmentationStageTiming), 0);
+        m_etGenerateTime = 0;
+        m_etWriteTime = 0;
         m_videosNum = other.m_videosNum;
         m_videosBitrate = NULL;
-        m_prevSegedFrmNum = other.m_prevSegedFrmNum;
-        m_currSegedFrmNum = other.m_currSegedFrmNum;
-        m_currProcessedFrmNum = other.m_currProcessedFrmNum;
         m_mpdWriter = NULL;
         m_isMpdGenInit = other.m_isMpdGenInit;
 
@@ -219,6 +221,16 @@ public:
     //!
     virtual int32_t AudioEndSegmentation();
 
+    //!
+    //! \brief  Get accumulated time of each segmentation stage
+    //!
+    //! \param  [out] timing
+    //!         pointer to the stage timing to be filled
+    //!
+    //! \return void
+    //!
+    void GetStageTiming(SegmentationStageTiming *timing);
+
 private:
 
     //!
@@ -307,7 +319,9 @@ private:
     int32_t EndEachAudio(MediaStream *stream);
 
     //!
-    //! \brief  Start segmentation thread for specified extractor track
+    //! \brief  Generate extractor track segment of current frame
+    //!         for specified extractor track, which runs as one
+    //!         task in extractor track segmentation task pool
     //!
     //! \param  [in] extractorTrack
     //!         pointer to the specified extractor track
@@ -315,59 +329,7 @@ private:
     //! \return int32_t
     //!         ERROR_NONE if success, else failed reason
     //!
-    int32_t StartExtractorTrackSegmentation(ExtractorTrack *extractorTrack);
-
-    //!
-    //! \brief  Start last segmentation thread for rest extractor tracks
-    //!
-    //! \param  [in] extractorTrack
-    //!         pointer to the first extractor track in rest extractor
-    //!         tracks which are not created segmentation thread
-    //!
-    //! \return int32_t
-    //!         ERROR_NONE if success, else failed reason
-    //!
-    int32_t StartLastExtractorTrackSegmentation(ExtractorTrack *extractorTrack);
-
-    //!
-    //! \brief  extractor track segmentation thread function
-    //!
-    //! \param  [in] pThis
-    //!         this DefaultSegmentation
-    //!
-    //! \return void*
-    //!         return NULL
-    //!
-    static void* ExtractorTrackSegThread(void *pThis);
-
-    //!
-    //! \brief  extractor track segmentation thread function for last extractor
-    //!         tracks
-    //!
-    //! \param  [in] pThis
-    //!         this DefaultSegmentation
-    //!
-    //! \return void*
-    //!         return NULL
-    //!
-    static void* LastExtractorTrackSegThread(void *pThis);
-
-    //!
-    //! \brief  Generate extractor track segments
-    //!
-    //! \return int32_t
-    //!         ERROR_NONE if success, else failed reason
-    //!
-    int32_t ExtractorTrackSegmentation();
-
-    //!
-    //! \brief  Generate extractor track segments for last
-    //!         extractor tracks
-    //!
-    //! \return int32_t
-    //!         ERROR_NONE if success, else failed reason
-    //!
-    int32_t LastExtractorTrackSegmentation();
+    int32_t ExtractorTrackSegmentation(ExtractorTrack *extractorTrack);
 
     //!
     //! \brief  Set frames ready status for extractor track
@@ -421,20 +383,19 @@ private:
     uint64_t                                       m_audioPrevSegNum;
     bool                                           m_audioSegCtxsConsted;
     uint64_t                                       m_framesNum;          //!< current written frames number
-    std::map<pthread_t, ExtractorTrack*>           m_extractorThreadIds; //!< map of thread ID for extractor track segmentation and corresponding extractor track
     bool                                           m_isEOS;              //!< whether EOS has been gotten for all media streams
     bool                                           m_nowKeyFrame;        //!< whether current frames are key frames for each corresponding media stream
     uint64_t                                       m_prevSegNum;         //!< previously written segments number
     std::mutex                                     m_mutex;              //!< thread mutex for main segmentation thread
     bool                                           m_isFramesReady;      //!< whether frames are ready for extractor track
-    uint16_t                                       m_aveETPerSegThread;  //!< average extractor tracks number in segmentation thread
-    uint16_t                                       m_lastETPerSegThread; //!< extractor tracks number in last segmentation thread
     uint16_t                                       m_threadNumForET;     //!< threads number for extractor track segmentation
+    SegmentationTaskPool                           *m_etTaskPool;        //!< work-stealing task pool for extractor track segmentation
+    SegmentationPipeline                           *m_pipeline;          //!< NAL parse stage running ahead of segmentation, NULL in serial mode
+    SegmentationStageTiming                        m_stageTiming;        //!< accumulated time of stages run by main segmentation thread
+    std::atomic<uint64_t>                          m_etGenerateTime;     //!< accumulated extractors generation time in us
+    std::atomic<uint64_t>                          m_etWriteTime;        //!< accumulated extractor tracks segment writing time in us
     uint32_t                                       m_videosNum;          //!< video streams number
     uint64_t                                       *m_videosBitrate;     //!< video stream bitrate array
-    uint64_t                                       m_prevSegedFrmNum;    //!< previous number of frames which have been segmented for their tile tracks
-    uint64_t                                       m_currSegedFrmNum;    //!< newest number of frames which have been segmented for their tile tracks
-    uint64_t                                       m_currProcessedFrmNum;//!< newest number of frames which have been segmented for both tiles tracks and extractor tracks
     MPDWriterBase*                                 m_mpdWriter;          //!< MPD file writer created based on plugin
     bool                                           m_isMpdGenInit;       //!< flag for whether MPD writer has been initialized
 };
@@ -616,6 +616,14 @@ int32_t ExtractorTrackGenerator::CalculateViewportNum()
         return OMAF_ERROR_SCVP_INIT_FAILED;
     }
 
+    // Every viewport on the yaw/pitch grid falls into its own cache bucket,
+    // so the selection is unchanged while later initializations with the
+    // same tiles layout skip the viewport geometry calculation
+    Param_ViewportCache cacheParam;
+    memset_s(&cacheParam, sizeof(Param_ViewportCache), 0);
+    cacheParam.angularResolution = ((m_yawStep < m_pitchStep) ? m_yawStep : m_pitchStep) / 4;
+    I360SCVP_SetParameter(m_360scvpHandle, ID_SCVP_PARAM_VIEWPORT_CACHE, &cacheParam);
+
     for (float one_yaw = -180.0; one_yaw <= 180.0; )
     {
         for (float one_pitch = -90.0; one_pitch <= 90.0; )
@@ -282,6 +282,7 @@ int32_t MultiViewSegmentation::ConstructVideoTrackSegCtx()
                 return OMAF_ERROR_NULL_PTR;
             }
             (trackSegCtx->dashSegmenter)->SetSegmentWriter(trackSegCtx->segWriter);
+            (trackSegCtx->dashSegmenter)->SetFileWriter(m_segFileWriter);
 
             trackSegCtx->qualityRanking = qualityLevel;
 
@@ -438,6 +439,7 @@ int32_t MultiViewSegmentation::ConstructAudioTrackSegCtx()
                 return OMAF_ERROR_NULL_PTR;
             }
             (trackSegCtx->dashSegmenter)->SetSegmentWriter(trackSegCtx->segWriter);
+            (trackSegCtx->dashSegmenter)->SetFileWriter(m_segFileWriter);
 
             trackSegCtx->qualityRanking = DEFAULT_QUALITY_RANK;
 
@@ -805,6 +807,7 @@ int32_t MultiViewSegmentation::VideoSegmentation()
 
             if (m_segInfo->isLive)
             {
+                m_segFileWriter->Flush();
                 m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
             }
         }
@@ -899,6 +902,7 @@ int32_t MultiViewSegmentation::VideoSegmentation()
             currentT = before;
             if (m_isCMAFEnabled && m_segInfo->isLive)
             {
+                m_segFileWriter->Flush();
                 m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
             }
 
@@ -928,7 +932,7 @@ int32_t MultiViewSegmentation::VideoSegmentation()
                         {
                             char rmFile[1024];
                             snprintf(rmFile, 1024, "%s%s_track%d.%d.mp4", m_segInfo->dirName, m_segInfo->outName, trackIndex.GetIndex(), removeCnt);
-                            remove(rmFile);
+                            m_segFileWriter->RemoveFile(rmFile);
                         }
                     }
                 }
@@ -962,7 +966,10 @@ int32_t MultiViewSegmentation::VideoSegmentation()
                         return OMAF_ERROR_TIMED_OUT;
                     }
                 }
-                int32_t ret = m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
+                int32_t ret = m_segFileWriter->Flush();
+                if (ret)
+                    return ret;
+                ret = m_mpdWriter->UpdateMpd(m_segNum, m_framesNum);
                 if (ret)
                     return ret;
             } else {
@@ -990,7 +997,13 @@ int32_t MultiViewSegmentation::VideoSegmentation()
                     }
                 }
 
-                int32_t ret = m_mpdWriter->WriteMpd(m_framesNum);
+                int32_t ret = m_segFileWriter->Flush();
+
+                if (ret)
+
+                    return ret;
+
+                ret = m_mpdWriter->WriteMpd(m_framesNum);
                 if (ret)
                     return ret;
             }
@@ -1097,6 +1110,7 @@ int32_t MultiViewSegmentation::AudioSegmentation()
             {
                 if (m_segInfo->isLive)
                 {
+                    m_segFileWriter->Flush();
                     m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
                 }
             }
@@ -1178,7 +1192,7 @@ int32_t MultiViewSegmentation::AudioSegmentation()
                             VCD::MP4::TrackId trackIndex = oneSegCtx->trackIdx;
                             char rmFile[1024];
                             snprintf(rmFile, 1024, "%s%s_track%d.%d.mp4", m_segInfo->dirName, m_segInfo->outName, trackIndex.GetIndex(), removeCnt);
-                            remove(rmFile);
+                            m_segFileWriter->RemoveFile(rmFile);
                         }
                     }
                 }
@@ -1191,11 +1205,17 @@ int32_t MultiViewSegmentation::AudioSegmentation()
             {
                 if (m_segInfo->isLive)
                 {
-                    int32_t ret = m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
+                    int32_t ret = m_segFileWriter->Flush();
+                    if (ret)
+                        return ret;
+                    ret = m_mpdWriter->UpdateMpd(m_audioSegNum, m_framesNum);
                     if (ret)
                         return ret;
                 } else {
-                    int32_t ret = m_mpdWriter->WriteMpd(m_framesNum);
+                    int32_t ret = m_segFileWriter->Flush();
+                    if (ret)
+                        return ret;
+                    ret = m_mpdWriter->WriteMpd(m_framesNum);
                     if (ret)
                         return ret;
                 }
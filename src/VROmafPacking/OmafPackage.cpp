@@ -39,6 +39,7 @@
 #include "AudioStreamPluginAPI.h"
 #include "DefaultSegmentation.h"
 #include "MultiViewSegmentation.h"
+#include "OmafPackingMetrics.h"
 
 VCD_NS_BEGIN
 
@@ -478,7 +479,7 @@ int32_t OmafPackage::SetLogCallBack(LogFunction logFunction)
     return ERROR_NONE;
 }
 
-int32_t OmafPackage::SetFrameInfo(uint8_t streamIdx, FrameBSInfo *frameInfo)
+int32_t OmafPackage::SetFrameInfo(uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque)
 {
     MediaStream *stream = m_streams[streamIdx];
     if (!stream)
@@ -490,14 +491,38 @@ int32_t OmafPackage::SetFrameInfo(uint8_t streamIdx, FrameBSInfo *frameInfo)
     int32_t ret = ERROR_NONE;
     if (stream->GetMediaType() == VIDEOTYPE)
     {
-        ret = ((VideoStream*)stream)->AddFrameInfo(frameInfo);
+        static MetricsCounter *framesIn = MetricsRegistry::GetInstance()->GetCounter(PACKER_FRAMES_IN);
+        if (m_segmentation)
+            m_segmentation->MarkFrameIn(streamIdx, frameInfo->pts);
+
+        if (releaseFunc)
+        {
+            ret = ((VideoStream*)stream)->AddFrameInfo(frameInfo, releaseFunc, opaque);
+        }
+        else
+        {
+            ret = ((VideoStream*)stream)->AddFrameInfo(frameInfo);
+        }
+
+        if (ret && m_segmentation)
+            m_segmentation->CancelFrameIn(streamIdx);
+        if (!ret)
+            framesIn->Add(1);
     }
     else if (stream->GetMediaType() == AUDIOTYPE)
     {
         //OMAF_LOG(LOG_INFO, "To add one audio frame with pts %d\n", frameInfo->pts);
         ret = ((AudioStream*)stream)->AddFrameInfo(frameInfo);
+        // audio frames are small and always copied
+        if (!ret && releaseFunc)
+        {
+            releaseFunc(frameInfo->data, opaque);
+        }
     }
 
+    if (ret == OMAF_ERROR_FRAME_QUEUE_FULL)
+        return ret;
+
     if (ret)
         return OMAF_ERROR_ADD_FRAMEINFO;
 
@@ -579,7 +604,7 @@ void OmafPackage::SegmentAllAudioStreams()
     m_segmentation->AudioSegmentation();
 }
 
-int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo)
+int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque)
 {
     //for (uint32_t index = 0; index < 200; index++)
     //{
@@ -587,7 +612,7 @@ int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo)
     //}
     //printf("\n");
 
-    int32_t ret = SetFrameInfo(streamIdx, frameInfo);
+    int32_t ret = SetFrameInfo(streamIdx, frameInfo, releaseFunc, opaque);
     if (ret)
         return ret;
 
@@ -651,6 +676,43 @@ int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo)
     return ERROR_NONE;
 }
 
+int32_t OmafPackage::GetFrameQueueStats(uint8_t streamIdx, FrameQueueStats *stats)
+{
+    if (!stats)
+        return OMAF_ERROR_NULL_PTR;
+
+    std::map<uint8_t, MediaStream*>::iterator it = m_streams.find(streamIdx);
+    if ((it == m_streams.end()) || !(it->second))
+        return OMAF_ERROR_STREAM_NOT_FOUND;
+
+    if (it->second->GetMediaType() != VIDEOTYPE)
+        return OMAF_ERROR_MEDIA_TYPE;
+
+    ((VideoStream*)(it->second))->GetFrameQueueStats(stats);
+
+    return ERROR_NONE;
+}
+
+int32_t OmafPackage::GetStatistic(PackingStatistic *statistic)
+{
+    if (!statistic)
+        return OMAF_ERROR_NULL_PTR;
+
+    MetricsRegistry *registry = MetricsRegistry::GetInstance();
+    HistogramSnapshot snapshot;
+    registry->GetHistogramSnapshot(PACKER_FRAME_TO_SEGMENT_LATENCY, &snapshot);
+    statistic->frameToSegment.count = snapshot.count;
+    statistic->frameToSegment.avgUs = snapshot.count ? snapshot.sum / snapshot.count : 0;
+    statistic->frameToSegment.p50Us = snapshot.p50;
+    statistic->frameToSegment.p90Us = snapshot.p90;
+    statistic->frameToSegment.p99Us = snapshot.p99;
+    statistic->frameToSegment.maxUs = snapshot.max;
+    statistic->framesIn = registry->GetCounterValue(PACKER_FRAMES_IN);
+    statistic->segmentsWritten = registry->GetCounterValue(PACKER_SEGMENTS_WRITTEN);
+
+    return ERROR_NONE;
+}
+
 int32_t OmafPackage::OmafEndStreams()
 {
     if (m_segmentation)
@@ -96,11 +96,40 @@ public:
     //!         the index of specified stream in whole streams
     //! \param  [in] frameInfo
     //!         frame information for a new frame of specified stream
+    //! \param  [in] releaseFunc
+    //!         callback to release frame data which is queued without
+    //!         being copied, NULL if frame data needs to be copied
+    //! \param  [in] opaque
+    //!         user data passed to releaseFunc
     //!
     //! \return int32_t
     //!         ERROR_NONE if success, else failed reason
     //!
-    int32_t OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo);
+    int32_t OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc = NULL, void *opaque = NULL);
+
+    //!
+    //! \brief  Get frame queue statistics of the specified video stream
+    //!
+    //! \param  [in] streamIdx
+    //!         the index of specified stream in whole streams
+    //! \param  [out] stats
+    //!         pointer to the frame queue statistics
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetFrameQueueStats(uint8_t streamIdx, FrameQueueStats *stats);
+
+    //!
+    //! \brief  Get the always-on packing metrics of the process
+    //!
+    //! \param  [out] statistic
+    //!         pointer to the packing statistic
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetStatistic(PackingStatistic *statistic);
 
     //!
     //! \brief  End the packeting of all streams
@@ -170,11 +199,16 @@ private:
     //!         the index of the stream to be handled
     //! \param  [in] frameInfo
     //!         frame information of new frame of the stream
+    //! \param  [in] releaseFunc
+    //!         callback to release frame data, NULL if frame data
+    //!         needs to be copied
+    //! \param  [in] opaque
+    //!         user data passed to releaseFunc
     //!
     //! \return int32_t
     //!         ERROR_NONE if success, else failed reason
     //!
-    int32_t SetFrameInfo(uint8_t streamIdx, FrameBSInfo *frameInfo);
+    int32_t SetFrameInfo(uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque);
 
     //!
     //! \brief  Segment all video media streams
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   OmafPackingMetrics.h
+//! \brief:  names of always-on metrics of VROmafPacking
+//! \detail: latency histograms are in microsecond and kept in the
+//!          process wide MetricsRegistry, they are exposed through
+//!          VROmafPackingGetStatistic and the periodic metrics dump
+//!
+//! Created on April 19, 2021, 6:04 AM
+//!
+
+#ifndef _OMAFPACKINGMETRICS_H_
+#define _OMAFPACKINGMETRICS_H_
+
+#include "../utils/MetricsRegistry.h"
+
+// from one video frame input to the segment containing it written
+#define PACKER_FRAME_TO_SEGMENT_LATENCY "omaf_packer_frame_to_segment_latency_us"
+
+#define PACKER_FRAMES_IN                "omaf_packer_frames_in_total"
+#define PACKER_SEGMENTS_WRITTEN         "omaf_packer_segments_written_total"
+
+#endif /* _OMAFPACKINGMETRICS_H_ */
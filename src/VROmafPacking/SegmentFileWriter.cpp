@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+//!
+//! \file:   SegmentFileWriter.cpp
+//! \brief:  Implement SegmentBuffer and SegmentFileWriter classes
+//!
+
+#include "SegmentFileWriter.h"
+#include "VROmafPacking_def.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+VCD_NS_BEGIN
+
+SegmentBuffer::SegmentBuffer(SegmentFileWriter *writer)
+{
+    m_writer = writer;
+    m_blockIdx = 0;
+    m_size = 0;
+    setp(NULL, NULL);
+}
+
+SegmentBuffer::~SegmentBuffer()
+{
+    std::vector<uint8_t*>::iterator it;
+    for (it = m_blocks.begin(); it != m_blocks.end(); it++)
+    {
+        m_writer->ReleaseBlock(*it);
+    }
+    m_blocks.clear();
+}
+
+uint64_t SegmentBuffer::GetPutPosition()
+{
+    if (!pbase())
+        return m_blockIdx * SEGMENT_BLOCK_SIZE;
+
+    return m_blockIdx * SEGMENT_BLOCK_SIZE + (uint64_t)(pptr() - pbase());
+}
+
+uint64_t SegmentBuffer::GetSize()
+{
+    uint64_t currPos = GetPutPosition();
+    return (currPos > m_size) ? currPos : m_size;
+}
+
+bool SegmentBuffer::SetPutPosition(uint64_t pos)
+{
+    m_size = GetSize();
+
+    uint64_t blockIdx = pos / SEGMENT_BLOCK_SIZE;
+    while (m_blocks.size() <= blockIdx)
+    {
+        uint8_t *block = m_writer->AcquireBlock();
+        if (!block)
+        {
+            setp(NULL, NULL);
+            return false;
+        }
+        m_blocks.push_back(block);
+    }
+
+    m_blockIdx = blockIdx;
+    char *block = (char*)(m_blocks[blockIdx]);
+    setp(block, block + SEGMENT_BLOCK_SIZE);
+    pbump((int)(pos % SEGMENT_BLOCK_SIZE));
+
+    return true;
+}
+
+SegmentBuffer::int_type SegmentBuffer::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+    if (!SetPutPosition(GetPutPosition()))
+        return traits_type::eof();
+
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+
+    return ch;
+}
+
+std::streamsize SegmentBuffer::xsputn(const char *data, std::streamsize size)
+{
+    std::streamsize written = 0;
+    while (written < size)
+    {
+        if (pptr() == epptr())
+        {
+            if (!SetPutPosition(GetPutPosition()))
+                break;
+        }
+
+        std::streamsize room = (std::streamsize)(epptr() - pptr());
+        std::streamsize copySize = std::min(size - written, room);
+        memcpy_s(pptr(), room, data + written, copySize);
+        pbump((int)copySize);
+        written += copySize;
+    }
+
+    return written;
+}
+
+SegmentBuffer::pos_type SegmentBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::out))
+        return pos_type(off_type(-1));
+
+    int64_t basePos = 0;
+    if (dir == std::ios_base::cur)
+    {
+        basePos = (int64_t)GetPutPosition();
+        if (off == 0)
+            return pos_type(off_type(basePos));
+    }
+    else if (dir == std::ios_base::end)
+    {
+        basePos = (int64_t)GetSize();
+    }
+
+    return seekpos(pos_type(off_type(basePos + off)), which);
+}
+
+SegmentBuffer::pos_type SegmentBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    off_type newPos = off_type(pos);
+    if (!(which & std::ios_base::out) || (newPos < 0))
+        return pos_type(off_type(-1));
+
+    if (!SetPutPosition((uint64_t)newPos))
+        return pos_type(off_type(-1));
+
+    return pos;
+}
+
+SegmentFileWriter::SegmentFileWriter()
+{
+    m_busyNum = 0;
+    m_stop = false;
+    m_error = ERROR_NONE;
+    m_directIO = false;
+}
+
+SegmentFileWriter::~SegmentFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notEmpty.notify_all();
+
+    if (m_writeThread.joinable())
+        m_writeThread.join();
+
+    std::deque<SegmentFileTask>::iterator it;
+    for (it = m_tasks.begin(); it != m_tasks.end(); it++)
+    {
+        DELETE_MEMORY(it->buffer);
+    }
+    m_tasks.clear();
+
+    std::vector<uint8_t*>::iterator itBlock;
+    for (itBlock = m_freeBlocks.begin(); itBlock != m_freeBlocks.end(); itBlock++)
+    {
+        free(*itBlock);
+    }
+    m_freeBlocks.clear();
+}
+
+int32_t SegmentFileWriter::Initialize(bool directIO)
+{
+    if (m_writeThread.joinable())
+        return OMAF_ERROR_INVALID_THREAD;
+
+    m_directIO = directIO;
+
+    for (uint32_t i = 0; i < SEGMENT_PREALLOC_BLOCKS; i++)
+    {
+        void *block = NULL;
+        if (posix_memalign(&block, SEGMENT_IO_ALIGNMENT, SEGMENT_BLOCK_SIZE))
+            return OMAF_ERROR_NULL_PTR;
+
+        m_freeBlocks.push_back((uint8_t*)block);
+    }
+
+    try
+    {
+        m_writeThread = std::thread(&SegmentFileWriter::WriteRun, this);
+    }
+    catch (const std::system_error &ex)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to create segment file writer thread, %s !\n", ex.what());
+        return OMAF_ERROR_CREATE_THREAD;
+    }
+
+    return ERROR_NONE;
+}
+
+uint8_t* SegmentFileWriter::AcquireBlock()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (!m_freeBlocks.empty())
+        {
+            uint8_t *block = m_freeBlocks.back();
+            m_freeBlocks.pop_back();
+            return block;
+        }
+    }
+
+    void *block = NULL;
+    if (posix_memalign(&block, SEGMENT_IO_ALIGNMENT, SEGMENT_BLOCK_SIZE))
+        return NULL;
+
+    return (uint8_t*)block;
+}
+
+void SegmentFileWriter::ReleaseBlock(uint8_t *block)
+{
+    if (!block)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (m_freeBlocks.size() < SEGMENT_MAX_FREE_BLOCKS)
+        {
+            m_freeBlocks.push_back(block);
+            return;
+        }
+    }
+
+    free(block);
+}
+
+int32_t SegmentFileWriter::PushTask(SegmentFileTask &task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop || !m_writeThread.joinable())
+        {
+            OMAF_LOG(LOG_ERROR, "Segment file writer is not running !\n");
+            return OMAF_ERROR_INVALID_THREAD;
+        }
+
+        m_notFull.wait(lock, [this]() { return m_busyNum < SEGMENT_MAX_PENDING_FILES; });
+        m_tasks.push_back(task);
+        m_busyNum++;
+    }
+    m_notEmpty.notify_one();
+
+    return ERROR_NONE;
+}
+
+int32_t SegmentFileWriter::WriteFile(SegmentBuffer *buffer, const char *fileName)
+{
+    if (!buffer || !fileName)
+    {
+        DELETE_MEMORY(buffer);
+        return OMAF_ERROR_NULL_PTR;
+    }
+
+    int32_t ret = m_error;
+    if (ret)
+    {
+        DELETE_MEMORY(buffer);
+        return ret;
+    }
+
+    SegmentFileTask task;
+    task.buffer = buffer;
+    task.fileName = fileName;
+    ret = PushTask(task);
+    if (ret)
+    {
+        DELETE_MEMORY(buffer);
+        return ret;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t SegmentFileWriter::RemoveFile(const char *fileName)
+{
+    if (!fileName)
+        return OMAF_ERROR_NULL_PTR;
+
+    SegmentFileTask task;
+    task.buffer = NULL;
+    task.fileName = fileName;
+
+    return PushTask(task);
+}
+
+int32_t SegmentFileWriter::Flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_busyNum == 0; });
+    }
+
+    return m_error;
+}
+
+void SegmentFileWriter::WriteRun()
+{
+    while (1)
+    {
+        SegmentFileTask task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty())
+                break;
+
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        if (task.buffer)
+        {
+            int32_t ret = WriteOneFile(task.buffer, task.fileName);
+            if (ret)
+            {
+                int32_t noError = ERROR_NONE;
+                m_error.compare_exchange_strong(noError, ret);
+            }
+            DELETE_MEMORY(task.buffer);
+        }
+        else
+        {
+            remove(task.fileName.c_str());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyNum--;
+        }
+        m_notFull.notify_all();
+    }
+}
+
+int32_t SegmentFileWriter::WriteOneFile(SegmentBuffer *buffer, const std::string &fileName)
+{
+    std::string tmpName = fileName + ".tmp";
+    int fd = -1;
+    if (m_directIO)
+    {
+        fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        if ((fd < 0) && (errno == EINVAL))
+        {
+            OMAF_LOG(LOG_WARNING, "Direct I/O is not supported for %s, use buffered I/O instead !\n", tmpName.c_str());
+            m_directIO = false;
+        }
+    }
+    if (!m_directIO)
+    {
+        fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (fd < 0)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to open segment file %s !\n", tmpName.c_str());
+        return OMAF_FILE_OPEN_ERROR;
+    }
+
+    // direct I/O needs aligned size, so the last block is written up to
+    // the alignment and the file is truncated to data size afterwards
+    uint64_t dataSize = buffer->GetSize();
+    uint64_t writeSize = dataSize;
+    if (m_directIO)
+    {
+        writeSize = (dataSize + SEGMENT_IO_ALIGNMENT - 1) / SEGMENT_IO_ALIGNMENT * SEGMENT_IO_ALIGNMENT;
+        // space preallocation is only a hint, ignore the failure
+        if (writeSize)
+            fallocate(fd, 0, 0, writeSize);
+    }
+
+    std::vector<struct iovec> ioVecs;
+    const std::vector<uint8_t*> &blocks = buffer->GetBlocks();
+    uint64_t remainSize = writeSize;
+    for (uint32_t i = 0; (i < blocks.size()) && remainSize; i++)
+    {
+        struct iovec oneVec;
+        oneVec.iov_base = blocks[i];
+        oneVec.iov_len = (size_t)std::min(remainSize, (uint64_t)SEGMENT_BLOCK_SIZE);
+        ioVecs.push_back(oneVec);
+        remainSize -= oneVec.iov_len;
+    }
+
+    int32_t ret = ERROR_NONE;
+    bool directFd = m_directIO;
+    uint32_t vecIdx = 0;
+    while (vecIdx < ioVecs.size())
+    {
+        int vecNum = (int)std::min(ioVecs.size() - vecIdx, (size_t)IOV_MAX);
+        ssize_t written = writev(fd, &(ioVecs[vecIdx]), vecNum);
+        if ((written < 0) && (errno == EINTR))
+            continue;
+        if (written <= 0)
+        {
+            ret = OMAF_ERROR_FILE_WRITE;
+            break;
+        }
+
+        // after a partial write which is not aligned, the rest of the data
+        // and the file offset are not aligned any more, so direct I/O would
+        // fail with EINVAL, write the rest with buffered I/O
+        if (directFd && (written % SEGMENT_IO_ALIGNMENT))
+        {
+            int flags = fcntl(fd, F_GETFL);
+            if ((flags < 0) || fcntl(fd, F_SETFL, flags & ~O_DIRECT))
+            {
+                ret = OMAF_ERROR_FILE_WRITE;
+                break;
+            }
+            directFd = false;
+        }
+
+        while ((written > 0) && (vecIdx < ioVecs.size()))
+        {
+            if ((size_t)written >= ioVecs[vecIdx].iov_len)
+            {
+                written -= ioVecs[vecIdx].iov_len;
+                vecIdx++;
+            }
+            else
+            {
+                ioVecs[vecIdx].iov_base = (uint8_t*)(ioVecs[vecIdx].iov_base) + written;
+                ioVecs[vecIdx].iov_len -= written;
+                written = 0;
+            }
+        }
+    }
+
+    if (!ret && (writeSize != dataSize) && ftruncate(fd, dataSize))
+        ret = OMAF_ERROR_FILE_WRITE;
+
+    if (close(fd) && !ret)
+        ret = OMAF_ERROR_FILE_WRITE;
+
+    if (!ret && rename(tmpName.c_str(), fileName.c_str()))
+        ret = OMAF_ERROR_FILE_WRITE;
+
+    if (ret)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to write segment file %s !\n", fileName.c_str());
+        unlink(tmpName.c_str());
+        return ret;
+    }
+
+    return ERROR_NONE;
+}
+
+VCD_NS_END
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+//!
+//! \file:   SegmentFileWriter.h
+//! \brief:  Segment file writer class definition
+//! \detail: Define the block based buffer which segments are serialized
+//!          into, and the background writer which publishes segment
+//!          files atomically through a temporary file and rename.
+//!
+
+#ifndef _SEGMENTFILEWRITER_H_
+#define _SEGMENTFILEWRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OmafPackingCommon.h"
+
+VCD_NS_BEGIN
+
+#define SEGMENT_BLOCK_SIZE        (64 * 1024)  //!< size of one segment buffer block, multiple of direct I/O alignment
+#define SEGMENT_IO_ALIGNMENT      4096         //!< alignment of buffer address, file offset and size for direct I/O
+#define SEGMENT_PREALLOC_BLOCKS   64           //!< number of blocks allocated when the writer is initialized
+#define SEGMENT_MAX_FREE_BLOCKS   1024         //!< max number of free blocks kept for reuse
+#define SEGMENT_MAX_PENDING_FILES 1024         //!< max number of segment files queued for writing
+
+class SegmentFileWriter;
+
+//!
+//! \class SegmentBuffer
+//! \brief Output stream buffer which keeps segment data in fixed size
+//!        blocks taken from the pool of segment file writer, so that
+//!        boxes are written once and handed to writev without copy.
+//!        Seeking back into written data is supported for box size
+//!        patching.
+//!
+
+class SegmentBuffer : public std::streambuf
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    //! \param  [in] writer
+    //!         pointer to the segment file writer which owns
+    //!         the blocks pool
+    //!
+    SegmentBuffer(SegmentFileWriter *writer);
+
+    //!
+    //! \brief  Destructor, return all blocks to the pool
+    //!
+    virtual ~SegmentBuffer();
+
+    //!
+    //! \brief  Get the size of written data
+    //!
+    //! \return uint64_t
+    //!         the size of written data
+    //!
+    uint64_t GetSize();
+
+    //!
+    //! \brief  Get blocks which hold the written data
+    //!
+    //! \return const std::vector<uint8_t*>&
+    //!         the blocks in order of data position
+    //!
+    const std::vector<uint8_t*>& GetBlocks() { return m_blocks; };
+
+protected:
+    virtual int_type overflow(int_type ch);
+
+    virtual std::streamsize xsputn(const char *data, std::streamsize size);
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+private:
+    //!
+    //! \brief  Set put area to the block which holds the
+    //!         specified position, blocks are taken from
+    //!         the pool when needed
+    //!
+    //! \param  [in] pos
+    //!         the position in segment data
+    //!
+    //! \return bool
+    //!         whether the block is available
+    //!
+    bool SetPutPosition(uint64_t pos);
+
+    //!
+    //! \brief  Get current put position in segment data
+    //!
+    //! \return uint64_t
+    //!         current put position
+    //!
+    uint64_t GetPutPosition();
+
+private:
+    SegmentFileWriter     *m_writer;     //!< segment file writer which owns the blocks pool
+    std::vector<uint8_t*> m_blocks;      //!< blocks which hold segment data
+    uint64_t              m_blockIdx;    //!< index of the block used as current put area
+    uint64_t              m_size;        //!< size of data written before current put area is used
+};
+
+//!
+//! \struct SegmentFileTask
+//! \brief  one queued file operation of segment file writer
+//!
+struct SegmentFileTask
+{
+    SegmentBuffer *buffer;    //!< segment data to be written, NULL means the file is removed
+    std::string   fileName;   //!< segment file name
+};
+
+//!
+//! \class SegmentFileWriter
+//! \brief Write segment files on a background thread. Data is written
+//!        into a temporary file with writev and then renamed to the
+//!        segment file name, so that a segment file is never seen
+//!        partially written. Optionally the file is written with
+//!        O_DIRECT after its space is preallocated with fallocate.
+//!
+
+class SegmentFileWriter
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    SegmentFileWriter();
+
+    //!
+    //! \brief  Destructor, wait for all queued files written
+    //!
+    ~SegmentFileWriter();
+
+    //!
+    //! \brief  Preallocate blocks and launch the writer thread
+    //!
+    //! \param  [in] directIO
+    //!         whether to write files with O_DIRECT and
+    //!         preallocate file space
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Initialize(bool directIO);
+
+    //!
+    //! \brief  Queue the segment data to be written into file,
+    //!         block if too many files are queued
+    //!
+    //! \param  [in] buffer
+    //!         segment data, owned by the writer after the call
+    //! \param  [in] fileName
+    //!         segment file name
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else the failed reason of
+    //!         any earlier file writing
+    //!
+    int32_t WriteFile(SegmentBuffer *buffer, const char *fileName);
+
+    //!
+    //! \brief  Queue the removal of segment file, so that it is
+    //!         done after earlier queued writing of the file
+    //!
+    //! \param  [in] fileName
+    //!         segment file name
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t RemoveFile(const char *fileName);
+
+    //!
+    //! \brief  Wait until all queued files are written
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else the failed reason of
+    //!         any earlier file writing
+    //!
+    int32_t Flush();
+
+    //!
+    //! \brief  Get one block from the pool
+    //!
+    //! \return uint8_t*
+    //!         the block of SEGMENT_BLOCK_SIZE bytes, NULL if failed
+    //!
+    uint8_t* AcquireBlock();
+
+    //!
+    //! \brief  Return one block to the pool
+    //!
+    //! \param  [in] block
+    //!         the block got from AcquireBlock
+    //!
+    //! \return void
+    //!
+    void ReleaseBlock(uint8_t *block);
+
+private:
+    //!
+    //! \brief  Queue one file operation
+    //!
+    //! \param  [in] task
+    //!         the file operation
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t PushTask(SegmentFileTask &task);
+
+    //!
+    //! \brief  Writer thread loop
+    //!
+    //! \return void
+    //!
+    void WriteRun();
+
+    //!
+    //! \brief  Write segment data into temporary file and
+    //!         rename it to segment file name
+    //!
+    //! \param  [in] buffer
+    //!         segment data
+    //! \param  [in] fileName
+    //!         segment file name
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t WriteOneFile(SegmentBuffer *buffer, const std::string &fileName);
+
+private:
+    std::deque<SegmentFileTask> m_tasks;        //!< queued file operations
+    std::mutex                  m_mutex;        //!< mutex for queued file operations
+    std::condition_variable     m_notEmpty;     //!< cv signalled when one file operation is queued
+    std::condition_variable     m_notFull;      //!< cv signalled when one file operation is done
+    uint32_t                    m_busyNum;      //!< number of file operations queued or in progress
+    bool                        m_stop;         //!< whether the writer thread is requested to exit
+    std::thread                 m_writeThread;  //!< writer thread
+    std::atomic<int32_t>        m_error;        //!< failed reason of the first failed file writing
+    bool                        m_directIO;     //!< whether to write files with O_DIRECT
+    std::mutex                  m_poolMutex;    //!< mutex for blocks pool
+    std::vector<uint8_t*>       m_freeBlocks;   //!< free blocks for reuse
+};
+
+VCD_NS_END;
+#endif /* _SEGMENTFILEWRITER_H_ */
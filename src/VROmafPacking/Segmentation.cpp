@@ -33,6 +33,7 @@
 
 #include <dlfcn.h>
 #include "Segmentation.h"
+#include "OmafPackingMetrics.h"
 
 VCD_NS_BEGIN
 
@@ -52,6 +53,7 @@ Segmentation::Segmentation()
     m_mpdWriterPluginPath = NULL;
     m_mpdWriterPluginName = NULL;
     m_mpdWriterPluginHdl  = NULL;
+    m_segFileWriter       = NULL;
 }
 
 Segmentation::Segmentation(
@@ -76,6 +78,7 @@ Segmentation::Segmentation(
     m_mpdWriterPluginPath = initInfo->mpdWriterPluginPath;
     m_mpdWriterPluginName = initInfo->mpdWriterPluginName;
     m_mpdWriterPluginHdl  = NULL;
+    m_segFileWriter       = NULL;
 }
 
 Segmentation::Segmentation(const Segmentation& src)
@@ -95,6 +98,7 @@ Segmentation::Segmentation(const Segmentation& src)
     m_mpdWriterPluginPath = std::move(src.m_mpdWriterPluginPath);
     m_mpdWriterPluginName = std::move(src.m_mpdWriterPluginName);
     m_mpdWriterPluginHdl  = std::move(src.m_mpdWriterPluginHdl);
+    m_segFileWriter       = std::move(src.m_segFileWriter);
 }
 
 Segmentation& Segmentation::operator=(Segmentation&& other)
@@ -114,12 +118,15 @@ Segmentation& Segmentation::operator=(Segmentation&& other)
     m_mpdWriterPluginPath = std::move(other.m_mpdWriterPluginPath);
     m_mpdWriterPluginName = std::move(other.m_mpdWriterPluginName);
     m_mpdWriterPluginHdl  = std::move(other.m_mpdWriterPluginHdl);
+    m_segFileWriter       = std::move(other.m_segFileWriter);
 
     return *this;
 }
 
 Segmentation::~Segmentation()
 {
+    DELETE_MEMORY(m_segFileWriter);
+
     if (m_segWriterPluginHdl)
     {
         dlclose(m_segWriterPluginHdl);
@@ -239,7 +246,69 @@ int32_t Segmentation::Initialize()
     if (ret)
         return ret;
 
+    m_segFileWriter = new SegmentFileWriter();
+    if (!m_segFileWriter)
+        return OMAF_ERROR_NULL_PTR;
+
+    ret = m_segFileWriter->Initialize(m_segInfo->directIO);
+    if (ret)
+        return ret;
+
     return ERROR_NONE;
 }
 
+void Segmentation::MarkFrameIn(uint8_t streamIdx, int64_t pts)
+{
+    std::lock_guard<std::mutex> lock(m_frameInMutex);
+    std::deque<FrameInTime> &framesInTime = m_framesInTime[streamIdx];
+    // bounded for segmentation which doesn't mark segmented frames
+    if (framesInTime.size() >= MAX_FRAMES_IN_TIME_NUM)
+        framesInTime.pop_front();
+    framesInTime.push_back(std::make_pair(pts, std::chrono::steady_clock::now()));
+}
+
+void Segmentation::CancelFrameIn(uint8_t streamIdx)
+{
+    std::lock_guard<std::mutex> lock(m_frameInMutex);
+    std::deque<FrameInTime> &framesInTime = m_framesInTime[streamIdx];
+    if (!framesInTime.empty())
+        framesInTime.pop_back();
+}
+
+void Segmentation::MarkFrameSegmented(uint8_t streamIdx, int64_t pts)
+{
+    std::lock_guard<std::mutex> lock(m_frameInMutex);
+    std::deque<FrameInTime> &framesInTime = m_framesInTime[streamIdx];
+    // frames are segmented in input order, earlier ones which don't
+    // match have been dropped by the frame queue
+    while (!framesInTime.empty())
+    {
+        FrameInTime frame = framesInTime.front();
+        framesInTime.pop_front();
+        if (frame.first == pts)
+        {
+            m_currSegFramesInTime.push_back(frame.second);
+            break;
+        }
+    }
+}
+
+void Segmentation::MarkSegmentWritten()
+{
+    static LatencyHistogram *frameToSegment = MetricsRegistry::GetInstance()->GetHistogram(PACKER_FRAME_TO_SEGMENT_LATENCY);
+    static MetricsCounter *segmentsWritten = MetricsRegistry::GetInstance()->GetCounter(PACKER_SEGMENTS_WRITTEN);
+
+    std::lock_guard<std::mutex> lock(m_frameInMutex);
+    if (m_currSegFramesInTime.empty())
+        return;
+
+    std::vector<std::chrono::steady_clock::time_point>::iterator it;
+    for (it = m_currSegFramesInTime.begin(); it != m_currSegFramesInTime.end(); it++)
+    {
+        frameToSegment->Record(MetricsElapsedUs(*it));
+    }
+    m_currSegFramesInTime.clear();
+    segmentsWritten->Add(1);
+}
+
 VCD_NS_END
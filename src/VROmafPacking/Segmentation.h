@@ -41,9 +41,17 @@
 #include "ExtractorTrackManager.h"
 //#include "MpdGenerator.h"
 #include "DashMPDWriterPluginAPI.h"
+#include "SegmentFileWriter.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
 
 VCD_NS_BEGIN
 
+#define MAX_FRAMES_IN_TIME_NUM 1024 //!< max frames number whose input time is kept for each video stream
+
 //!
 //! \class Segmentation
 //! \brief Define the operation and needed data for segmentation
@@ -124,6 +132,53 @@ public:
     //!
     virtual int32_t AudioEndSegmentation() = 0;
 
+    //!
+    //! \brief  Mark one video frame input into the packing, called
+    //!         on the thread inputting frames before the frame is
+    //!         queued, so that segmentation never sees it unmarked
+    //!
+    //! \param  [in] streamIdx
+    //!         the index of the video stream
+    //! \param  [in] pts
+    //!         the pts of the frame
+    //!
+    //! \return void
+    //!
+    void MarkFrameIn(uint8_t streamIdx, int64_t pts);
+
+    //!
+    //! \brief  Cancel the last frame marked by MarkFrameIn for the
+    //!         video stream when the frame isn't accepted at last
+    //!
+    //! \param  [in] streamIdx
+    //!         the index of the video stream
+    //!
+    //! \return void
+    //!
+    void CancelFrameIn(uint8_t streamIdx);
+
+protected:
+    //!
+    //! \brief  Mark one video frame written into the current
+    //!         segment, called on segmentation thread
+    //!
+    //! \param  [in] streamIdx
+    //!         the index of the video stream
+    //! \param  [in] pts
+    //!         the pts of the frame
+    //!
+    //! \return void
+    //!
+    void MarkFrameSegmented(uint8_t streamIdx, int64_t pts);
+
+    //!
+    //! \brief  Mark the current segment written, latency from input
+    //!         to now is recorded for all frames in the segment
+    //!
+    //! \return void
+    //!
+    void MarkSegmentWritten();
+
 private:
 
     //!
@@ -157,6 +212,14 @@ protected:
     const char                      *m_mpdWriterPluginPath;
     const char                      *m_mpdWriterPluginName;
     void                            *m_mpdWriterPluginHdl;
+    SegmentFileWriter               *m_segFileWriter;       //!< writer of segment files shared by all tracks
+
+private:
+    typedef std::pair<int64_t, std::chrono::steady_clock::time_point> FrameInTime;
+
+    std::mutex                                  m_frameInMutex;      //!< protects m_framesInTime
+    std::map<uint8_t, std::deque<FrameInTime>>  m_framesInTime;      //!< pts and input time of frames not segmented yet for each video stream
+    std::vector<std::chrono::steady_clock::time_point> m_currSegFramesInTime; //!< input time of frames in current segment
 };
 
 VCD_NS_END;
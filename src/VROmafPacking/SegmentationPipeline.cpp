@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   SegmentationPipeline.cpp
+//! \brief:  Implement SegmentationPipeline class
+//!
+
+#include "SegmentationPipeline.h"
+#include "VideoStreamPluginAPI.h"
+#include "VROmafPacking_def.h"
+
+#include <chrono>
+#include <system_error>
+#include <unistd.h>
+
+VCD_NS_BEGIN
+
+SegmentationPipeline::SegmentationPipeline()
+{
+    m_streams = NULL;
+    m_depth = 0;
+    m_stop = false;
+    m_parseDone = false;
+    m_parseRet = ERROR_NONE;
+    m_parseTime = 0;
+}
+
+SegmentationPipeline::~SegmentationPipeline()
+{
+    Stop();
+}
+
+int32_t SegmentationPipeline::Initialize(std::map<uint8_t, MediaStream*> *streams, uint32_t depth)
+{
+    if (!streams || !depth)
+        return OMAF_ERROR_BAD_PARAM;
+
+    if (m_parseThread.joinable())
+        return OMAF_ERROR_INVALID_THREAD;
+
+    m_streams = streams;
+    m_depth = depth;
+
+    try
+    {
+        m_parseThread = std::thread(&SegmentationPipeline::ParseRun, this);
+    }
+    catch (const std::system_error &ex)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to create NAL parse thread, %s !\n", ex.what());
+        return OMAF_ERROR_CREATE_THREAD;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t SegmentationPipeline::PopFrames(std::map<MediaStream*, ParsedFrame> &frames)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return m_stop || m_parseDone || !m_parsedFrames.empty(); });
+        if (m_parsedFrames.empty())
+        {
+            OMAF_LOG(LOG_ERROR, "No more parsed frames from NAL parse stage !\n");
+            if (m_stop)
+                return OMAF_ERROR_INVALID_THREAD;
+            return m_parseRet ? m_parseRet : OMAF_ERROR_END_OF_STREAM;
+        }
+
+        frames.swap(m_parsedFrames.front());
+        m_parsedFrames.pop_front();
+    }
+    m_notFull.notify_one();
+
+    return ERROR_NONE;
+}
+
+void SegmentationPipeline::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+
+    if (m_parseThread.joinable())
+        m_parseThread.join();
+
+    std::deque<std::map<MediaStream*, ParsedFrame>>::iterator it;
+    for (it = m_parsedFrames.begin(); it != m_parsedFrames.end(); it++)
+    {
+        DestroyFrames(*it);
+    }
+    m_parsedFrames.clear();
+}
+
+void SegmentationPipeline::DestroyFrames(std::map<MediaStream*, ParsedFrame> &frames)
+{
+    std::map<MediaStream*, ParsedFrame>::iterator it;
+    for (it = frames.begin(); it != frames.end(); it++)
+    {
+        ParsedFrame &parsed = it->second;
+        if (parsed.frameInfo)
+        {
+            ((VideoStream*)(it->first))->ReleaseFrameInfo(parsed.frameInfo);
+            parsed.frameInfo = NULL;
+        }
+        DELETE_ARRAY(parsed.tilesNalu);
+    }
+    frames.clear();
+}
+
+void SegmentationPipeline::ParseRun()
+{
+    while (1)
+    {
+        std::map<MediaStream*, ParsedFrame> frames;
+        bool hasEOS = false;
+        int32_t parseRet = ERROR_NONE;
+
+        std::map<uint8_t, MediaStream*>::iterator itStream;
+        for (itStream = m_streams->begin(); itStream != m_streams->end(); itStream++)
+        {
+            MediaStream *stream = itStream->second;
+            if (stream->GetMediaType() != VIDEOTYPE)
+                continue;
+
+            VideoStream *vs = (VideoStream*)stream;
+            FrameBSInfo *frameInfo = vs->FetchFrameInfo();
+            while (!frameInfo)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stop)
+                        break;
+                }
+                usleep(50);
+                frameInfo = vs->FetchFrameInfo();
+                if (!frameInfo && (vs->GetEOS()))
+                    break;
+            }
+
+            ParsedFrame parsed;
+            parsed.frameInfo = frameInfo;
+            parsed.tilesNalu = NULL;
+            if (frameInfo)
+            {
+                uint16_t tilesNum = vs->GetTileInRow() * vs->GetTileInCol();
+                parsed.tilesNalu = new Nalu[tilesNum];
+                if (parsed.tilesNalu)
+                {
+                    memset_s(parsed.tilesNalu, tilesNum * sizeof(Nalu), 0);
+
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    parseRet = vs->ParseTilesNalu(frameInfo, parsed.tilesNalu);
+                    m_parseTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                    if (parseRet)
+                    {
+                        OMAF_LOG(LOG_ERROR, "Failed to parse tiles nalu for frame with pts %ld !\n", frameInfo->pts);
+                    }
+                }
+                else
+                {
+                    parseRet = OMAF_ERROR_NULL_PTR;
+                }
+            }
+            else
+            {
+                hasEOS = true;
+            }
+            frames.insert(std::make_pair(stream, parsed));
+            if (parseRet)
+                break;
+        }
+
+        if (parseRet)
+        {
+            // frames with partially parsed tiles are never segmented, the
+            // error is returned once the frames parsed before are popped
+            DestroyFrames(frames);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_parseRet = parseRet;
+                m_parseDone = true;
+            }
+            m_notEmpty.notify_one();
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this]() { return m_stop || (m_parsedFrames.size() < m_depth); });
+            if (m_stop)
+            {
+                lock.unlock();
+                DestroyFrames(frames);
+                return;
+            }
+
+            m_parsedFrames.push_back(std::map<MediaStream*, ParsedFrame>());
+            m_parsedFrames.back().swap(frames);
+            // frames after EOS are never segmented, so stop parsing here
+            if (hasEOS)
+                m_parseDone = true;
+        }
+        m_notEmpty.notify_one();
+
+        if (hasEOS)
+            break;
+    }
+}
+
+VCD_NS_END
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   SegmentationPipeline.h
+//! \brief:  Segmentation pipeline class definition
+//! \detail: Define the NAL parse stage which runs ahead of segmentation,
+//!          frames of all video streams are fetched and parsed on its
+//!          own thread and handed over through a bounded queue.
+//!
+
+#ifndef _SEGMENTATIONPIPELINE_H_
+#define _SEGMENTATIONPIPELINE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "OmafPackingCommon.h"
+#include "MediaStream.h"
+
+VCD_NS_BEGIN
+
+//!
+//! \struct ParsedFrame
+//! \brief  one frame of one video stream which has been parsed
+//!         ahead of segmentation
+//!
+struct ParsedFrame
+{
+    FrameBSInfo *frameInfo;  //!< frame information, NULL if video stream reaches EOS
+    Nalu        *tilesNalu;  //!< nalu information of all tiles parsed from the frame
+};
+
+//!
+//! \struct SegmentationStageTiming
+//! \brief  accumulated time of each segmentation stage
+//!
+struct SegmentationStageTiming
+{
+    uint64_t framesNum;       //!< number of frames segmented
+    uint64_t parseTime;       //!< time of tiles NAL parsing, in us
+    uint64_t parseWaitTime;   //!< time segmentation waited for parsed frames, in us
+    uint64_t tileWriteTime;   //!< time of tile tracks segment writing, in us
+    uint64_t etGenerateTime;  //!< time of extractors generation summed over all extractor tracks, in us
+    uint64_t etWriteTime;     //!< time of extractor tracks segment writing summed over all extractor tracks, in us
+    uint64_t etStageTime;     //!< wall time of extractor tracks stage, in us
+};
+
+//!
+//! \class SegmentationPipeline
+//! \brief Fetch and parse frames of all video streams on a dedicated
+//!        thread, at most 'depth' parsed frames are buffered ahead of
+//!        segmentation
+//!
+
+class SegmentationPipeline
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    SegmentationPipeline();
+
+    //!
+    //! \brief  Destructor
+    //!
+    ~SegmentationPipeline();
+
+    //!
+    //! \brief  Launch the parse stage
+    //!
+    //! \param  [in] streams
+    //!         pointer to the media streams map
+    //! \param  [in] depth
+    //!         max number of parsed frames buffered ahead
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Initialize(std::map<uint8_t, MediaStream*> *streams, uint32_t depth);
+
+    //!
+    //! \brief  Pop the next parsed frames of all video streams,
+    //!         block until they are available
+    //!
+    //! \param  [out] frames
+    //!         parsed frame of each video stream, the caller owns
+    //!         the frame information and tiles nalu array
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason, the parse
+    //!         error is returned once the frames parsed before it
+    //!         are popped
+    //!
+    int32_t PopFrames(std::map<MediaStream*, ParsedFrame> &frames);
+
+    //!
+    //! \brief  Stop the parse stage and destroy frames not popped
+    //!
+    //! \return void
+    //!
+    void Stop();
+
+    //!
+    //! \brief  Get accumulated time of tiles NAL parsing
+    //!
+    //! \return uint64_t
+    //!         parsing time in us
+    //!
+    uint64_t GetParseTime() { return m_parseTime; };
+
+    //!
+    //! \brief  Destroy parsed frames
+    //!
+    //! \param  [in] frames
+    //!         parsed frame of each video stream
+    //!
+    //! \return void
+    //!
+    static void DestroyFrames(std::map<MediaStream*, ParsedFrame> &frames);
+
+private:
+    //!
+    //! \brief  Parse stage thread loop
+    //!
+    //! \return void
+    //!
+    void ParseRun();
+
+private:
+    std::map<uint8_t, MediaStream*>                  *m_streams;      //!< media streams map
+    uint32_t                                         m_depth;         //!< max number of parsed frames buffered
+    std::deque<std::map<MediaStream*, ParsedFrame>>  m_parsedFrames;  //!< parsed frames of all video streams
+    std::mutex                                       m_mutex;         //!< mutex for parsed frames queue
+    std::condition_variable                          m_notEmpty;      //!< cv signalled when one parsed frame is pushed
+    std::condition_variable                          m_notFull;       //!< cv signalled when one parsed frame is popped
+    bool                                             m_stop;          //!< whether the parse stage is stopped
+    bool                                             m_parseDone;     //!< whether the parse stage has pushed its last frame
+    int32_t                                          m_parseRet;      //!< error which stopped the parse stage
+    std::thread                                      m_parseThread;   //!< parse stage thread
+    std::atomic<uint64_t>                            m_parseTime;     //!< accumulated parsing time in us
+};
+
+VCD_NS_END;
+#endif /* _SEGMENTATIONPIPELINE_H_ */
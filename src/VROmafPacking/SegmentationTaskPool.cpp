@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   SegmentationTaskPool.cpp
+//! \brief:  Segmentation task pool class implementation
+//!
+
+#include "SegmentationTaskPool.h"
+#include "VROmafPacking_def.h"
+
+#include <system_error>
+
+VCD_NS_BEGIN
+
+SegmentationTaskPool::SegmentationTaskPool()
+{
+    m_pendingTasks = 0;
+    m_stop = false;
+    m_nextQueue = 0;
+    m_stolenTasks = 0;
+}
+
+SegmentationTaskPool::~SegmentationTaskPool()
+{
+    Stop();
+
+    std::vector<TaskQueue*>::iterator it;
+    for (it = m_queues.begin(); it != m_queues.end(); it++)
+    {
+        TaskQueue *queue = *it;
+        DELETE_MEMORY(queue);
+    }
+    m_queues.clear();
+}
+
+int32_t SegmentationTaskPool::Initialize(uint32_t workersNum)
+{
+    if (!workersNum)
+        return OMAF_ERROR_BAD_PARAM;
+
+    if (m_workers.size())
+        return OMAF_ERROR_INVALID_THREAD;
+
+    for (uint32_t idx = 0; idx < workersNum; idx++)
+    {
+        TaskQueue *queue = new TaskQueue;
+        if (!queue)
+            return OMAF_ERROR_NULL_PTR;
+
+        m_queues.push_back(queue);
+    }
+
+    try
+    {
+        for (uint32_t idx = 0; idx < workersNum; idx++)
+        {
+            m_workers.push_back(std::thread(&SegmentationTaskPool::WorkerRun, this, idx));
+        }
+    }
+    catch (const std::system_error &ex)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to create segmentation worker thread, %s !\n", ex.what());
+        Stop();
+        return OMAF_ERROR_CREATE_THREAD;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t SegmentationTaskPool::Submit(std::function<void()> task)
+{
+    if (!m_queues.size())
+        return OMAF_ERROR_INVALID_THREAD;
+
+    // count the task before it is visible, so the count never drops below zero,
+    // and no task is taken after Stop() since no worker would run it
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        if (m_stop)
+            return OMAF_ERROR_INVALID_THREAD;
+
+        m_pendingTasks++;
+    }
+
+    TaskQueue *queue = m_queues[m_nextQueue++ % m_queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->tasks.push_back(std::move(task));
+    }
+    m_idleCond.notify_one();
+
+    return ERROR_NONE;
+}
+
+void SegmentationTaskPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_stop = true;
+    }
+    m_idleCond.notify_all();
+
+    std::vector<std::thread>::iterator it;
+    for (it = m_workers.begin(); it != m_workers.end(); it++)
+    {
+        if (it->joinable())
+            it->join();
+    }
+    m_workers.clear();
+}
+
+bool SegmentationTaskPool::PopTask(uint32_t workerIdx, std::function<void()> &task)
+{
+    uint32_t queuesNum = m_queues.size();
+    for (uint32_t offset = 0; offset < queuesNum; offset++)
+    {
+        TaskQueue *queue = m_queues[(workerIdx + offset) % queuesNum];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->tasks.empty())
+            continue;
+
+        if (offset == 0)
+        {
+            // own queue, take the newest task which is still hot in cache
+            task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+        else
+        {
+            // steal the oldest task from the other end
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            m_stolenTasks++;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void SegmentationTaskPool::WorkerRun(uint32_t workerIdx)
+{
+    std::function<void()> task;
+    while (1)
+    {
+        if (PopTask(workerIdx, task))
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_idleMutex);
+                m_pendingTasks--;
+            }
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_idleCond.wait(lock, [this]() { return m_pendingTasks > 0 || m_stop; });
+        if (m_stop && !m_pendingTasks)
+            break;
+    }
+}
+
+VCD_NS_END
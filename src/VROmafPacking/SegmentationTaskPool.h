@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   SegmentationTaskPool.h
+//! \brief:  Segmentation task pool class definition
+//! \detail: Define the work-stealing task pool shared by segmentation
+//!          tasks and the per-frame latch to wait for these tasks.
+//!
+
+#ifndef _SEGMENTATIONTASKPOOL_H_
+#define _SEGMENTATIONTASKPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "OmafPackingCommon.h"
+
+VCD_NS_BEGIN
+
+//!
+//! \class FrameLatch
+//! \brief Count down latch which is released once all tasks
+//!        submitted for one frame are done
+//!
+
+class FrameLatch
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    //! \param  [in] count
+    //!         number of tasks to wait for
+    //!
+    FrameLatch(uint32_t count) : m_count(count) {};
+
+    //!
+    //! \brief  Destructor
+    //!
+    ~FrameLatch() {};
+
+    //!
+    //! \brief  Mark one task as done
+    //!
+    //! \return void
+    //!
+    void CountDown()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count && (--m_count == 0))
+            m_cond.notify_all();
+    };
+
+    //!
+    //! \brief  Wait until all tasks are done
+    //!
+    //! \return void
+    //!
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return m_count == 0; });
+    };
+
+private:
+    std::mutex              m_mutex;  //!< mutex for task count
+    std::condition_variable m_cond;   //!< cv signalled when count reaches zero
+    uint32_t                m_count;  //!< number of tasks not yet done
+};
+
+//!
+//! \class SegmentationTaskPool
+//! \brief Work-stealing task pool, each worker pops tasks from its own
+//!        queue and steals from the other queues when its own is empty
+//!
+
+class SegmentationTaskPool
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    SegmentationTaskPool();
+
+    //!
+    //! \brief  Destructor
+    //!
+    ~SegmentationTaskPool();
+
+    //!
+    //! \brief  Launch the workers
+    //!
+    //! \param  [in] workersNum
+    //!         number of worker threads
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Initialize(uint32_t workersNum);
+
+    //!
+    //! \brief  Submit one task to the pool
+    //!
+    //! \param  [in] task
+    //!         task to be run by one of the workers
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason, and the
+    //!         task is dropped if the pool is not launched or stopped
+    //!
+    int32_t Submit(std::function<void()> task);
+
+    //!
+    //! \brief  Stop all workers after pending tasks are done
+    //!
+    //! \return void
+    //!
+    void Stop();
+
+    //!
+    //! \brief  Get number of workers
+    //!
+    //! \return uint32_t
+    //!         number of worker threads
+    //!
+    uint32_t GetWorkersNum() { return m_workers.size(); };
+
+    //!
+    //! \brief  Get number of tasks stolen from other workers' queues
+    //!
+    //! \return uint64_t
+    //!         number of stolen tasks
+    //!
+    uint64_t GetStolenTasksNum() { return m_stolenTasks; };
+
+private:
+    //!
+    //! \struct TaskQueue
+    //! \brief  task queue owned by one worker
+    //!
+    struct TaskQueue
+    {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    //!
+    //! \brief  Worker thread loop
+    //!
+    //! \param  [in] workerIdx
+    //!         index of the worker
+    //!
+    //! \return void
+    //!
+    void WorkerRun(uint32_t workerIdx);
+
+    //!
+    //! \brief  Pop one task from own queue, or steal one from others
+    //!
+    //! \param  [in] workerIdx
+    //!         index of the worker
+    //! \param  [out] task
+    //!         the popped task
+    //!
+    //! \return bool
+    //!         true if one task is popped, else false
+    //!
+    bool PopTask(uint32_t workerIdx, std::function<void()> &task);
+
+private:
+    std::vector<std::thread>     m_workers;      //!< worker threads
+    std::vector<TaskQueue*>      m_queues;       //!< task queue for each worker
+    std::mutex                   m_idleMutex;    //!< mutex for idle workers
+    std::condition_variable      m_idleCond;     //!< cv to wake up idle workers
+    uint64_t                     m_pendingTasks; //!< number of queued tasks, guarded by m_idleMutex
+    bool                         m_stop;         //!< whether workers should exit, guarded by m_idleMutex
+    std::atomic<uint32_t>        m_nextQueue;    //!< queue index for next submitted task
+    std::atomic<uint64_t>        m_stolenTasks;  //!< number of stolen tasks
+};
+
+VCD_NS_END;
+#endif /* _SEGMENTATIONTASKPOOL_H_ */
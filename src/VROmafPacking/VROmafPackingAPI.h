@@ -92,6 +92,87 @@ int32_t VROmafPackingSetLogCallBack(Handler hdl, void* externalLog);
 //!
 int32_t VROmafPackingWriteSegment(Handler hdl, uint8_t streamIdx, FrameBSInfo *frameInfo);
 
+//!
+//! \brief  VR OMAF Packing library writes segment for specified
+//!         media stream like VROmafPackingWriteSegment, but the
+//!         frame bitstream data isn't copied. The library keeps
+//!         the data until the frame is written into segment or
+//!         dropped, then returns it through releaseFunc
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [in] streamIdx
+//!         the index of the specified media stream
+//! \param  [in] frameInfo
+//!         pointer to the frame bitstream information of new frame,
+//!         frameInfo itself can be freed after the call returns,
+//!         while the data must stay writable until it is released
+//!         since NALU start codes may be rewritten in place
+//! \param  [in] releaseFunc
+//!         callback to return the frame bitstream data to the caller,
+//!         it is called exactly once for each queued frame, possibly
+//!         from a different thread
+//! \param  [in] opaque
+//!         user data passed to releaseFunc
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, else failed reason. The frame has
+//!         been queued when OMAF_ERROR_BAD_PARAM or
+//!         OMAF_ERROR_CREATE_THREAD is returned, for other errors
+//!         the caller keeps the ownership of the data and
+//!         releaseFunc won't be called for it
+//!
+int32_t VROmafPackingWriteSegmentNoCopy(Handler hdl, uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque);
+
+//!
+//! \brief  Get statistics of the frame queue of specified video
+//!         stream, the queue depth and policy are set through
+//!         'frameQueueDepth' and 'frameQueuePolicy' in SegmentationInfo
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [in] streamIdx
+//!         the index of the specified video stream
+//! \param  [out] stats
+//!         pointer to the frame queue statistics
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, else failed reason
+//!
+int32_t VROmafPackingGetFrameQueueStats(Handler hdl, uint8_t streamIdx, FrameQueueStats *stats);
+
+//!
+//! \brief  Get always-on packing metrics, the metrics are kept
+//!         for all handles in the process
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [out] statistic
+//!         pointer to the packing statistic
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, else failed reason
+//!
+int32_t VROmafPackingGetStatistic(Handler hdl, PackingStatistic *statistic);
+
+//!
+//! \brief  Dump all metrics of the process periodically into
+//!         a file, the file is replaced atomically on every dump
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [in] path
+//!         the dump file path, NULL to stop dumping
+//! \param  [in] periodMs
+//!         the dump period in millisecond, 0 to stop dumping
+//! \param  [in] format
+//!         JSON or Prometheus text format
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, else failed reason
+//!
+int32_t VROmafPackingSetMetricsDump(Handler hdl, const char *path, uint32_t periodMs, MetricsFormat format);
+
 //!
 //! \brief  VR OMAF Packing library ends the processing
 //!         for all media streams, called when there is
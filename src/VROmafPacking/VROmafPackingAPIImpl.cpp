@@ -33,6 +33,7 @@
 
 #include "VROmafPackingAPI.h"
 #include "OmafPackage.h"
+#include "OmafPackingMetrics.h"
 #include "Log.h"
 #ifdef _USE_TRACE_
 #include "../trace/E2E_latency_tp.h"
@@ -97,6 +98,69 @@ int32_t VROmafPackingWriteSegment(Handler hdl, uint8_t streamIdx, FrameBSInfo *f
     return ERROR_NONE;
 }
 
+int32_t VROmafPackingWriteSegmentNoCopy(Handler hdl, uint8_t streamIdx, FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage || !frameInfo || !releaseFunc)
+        return OMAF_ERROR_NULL_PTR;
+
+#ifdef _USE_TRACE_
+    string tag = "StremIdx:" + to_string(streamIdx);
+    tracepoint(E2E_latency_tp_provider,
+               pre_op_info,
+               frameInfo->pts,
+               tag.c_str());
+#endif
+
+    int32_t ret = omafPackage->OmafPacketStream(streamIdx, frameInfo, releaseFunc, opaque);
+    if (ret)
+        return ret;
+
+    return ERROR_NONE;
+}
+
+int32_t VROmafPackingGetFrameQueueStats(Handler hdl, uint8_t streamIdx, FrameQueueStats *stats)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage)
+        return OMAF_ERROR_NULL_PTR;
+
+    int32_t ret = omafPackage->GetFrameQueueStats(streamIdx, stats);
+    if (ret)
+        return ret;
+
+    return ERROR_NONE;
+}
+
+int32_t VROmafPackingGetStatistic(Handler hdl, PackingStatistic *statistic)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage)
+        return OMAF_ERROR_NULL_PTR;
+
+    int32_t ret = omafPackage->GetStatistic(statistic);
+    if (ret)
+        return ret;
+
+    return ERROR_NONE;
+}
+
+int32_t VROmafPackingSetMetricsDump(Handler hdl, const char *path, uint32_t periodMs, MetricsFormat format)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage)
+        return OMAF_ERROR_NULL_PTR;
+
+    MetricsRegistry *registry = MetricsRegistry::GetInstance();
+    if (!path || !periodMs)
+    {
+        registry->StopPeriodicDump();
+        return ERROR_NONE;
+    }
+
+    return registry->StartPeriodicDump(path, periodMs, format);
+}
+
 int32_t VROmafPackingEndStreams(Handler hdl)
 {
     OmafPackage *omafPackage = (OmafPackage*)hdl;
@@ -265,6 +265,61 @@ public:
         DELETE_MEMORY(m_omafPackage);
     }
 
+    //! push the 5 frames of both videos into specified package,
+    //! and wait for segmentation done by destroying the package
+    void PackAllFrames(OmafPackage *omafPackage)
+    {
+        uint64_t frameSizeLow[5] = { 97161, 39, 544, 44, 1980 };
+        uint64_t frameSizeHigh[5] = { 101531, 159, 613, 170, 1684 };
+        uint64_t offsetLow = 0;
+        uint64_t offsetHigh = 0;
+
+        for (uint8_t frameIdx = 0; frameIdx < 5; frameIdx++)
+        {
+            FrameBSInfo frameLowRes;
+            memset_s(&frameLowRes, sizeof(FrameBSInfo), 0);
+            frameLowRes.data = m_totalDataLow + offsetLow;
+            frameLowRes.dataSize = frameSizeLow[frameIdx];
+            frameLowRes.pts = frameIdx;
+            frameLowRes.isKeyFrame = (frameIdx == 0);
+            offsetLow += frameSizeLow[frameIdx];
+
+            FrameBSInfo frameHighRes;
+            memset_s(&frameHighRes, sizeof(FrameBSInfo), 0);
+            frameHighRes.data = m_totalDataHigh + offsetHigh;
+            frameHighRes.dataSize = frameSizeHigh[frameIdx];
+            frameHighRes.pts = frameIdx;
+            frameHighRes.isKeyFrame = (frameIdx == 0);
+            offsetHigh += frameSizeHigh[frameIdx];
+
+            EXPECT_TRUE(omafPackage->OmafPacketStream(0, &frameLowRes) == ERROR_NONE);
+            EXPECT_TRUE(omafPackage->OmafPacketStream(1, &frameHighRes) == ERROR_NONE);
+        }
+        EXPECT_TRUE(omafPackage->OmafEndStreams() == ERROR_NONE);
+        delete omafPackage;
+    }
+
+    //! check whether two files have the same content
+    bool IsSameFile(const char *fileName1, const char *fileName2)
+    {
+        FILE *file1 = fopen(fileName1, "rb");
+        FILE *file2 = fopen(fileName2, "rb");
+        bool isSame = (file1 != NULL) && (file2 != NULL);
+        while (isSame)
+        {
+            int c1 = fgetc(file1);
+            int c2 = fgetc(file2);
+            isSame = (c1 == c2);
+            if (c1 == EOF)
+                break;
+        }
+        if (file1)
+            fclose(file1);
+        if (file2)
+            fclose(file2);
+        return isSame;
+    }
+
     InitialInfo                     *m_initInfo;
     uint8_t                         *m_highResHeader;
     uint8_t                         *m_lowResHeader;
@@ -366,4 +421,38 @@ TEST_F(DefaultSegmentationTest, AllProcess)
         EXPECT_TRUE(buf.st_size != 0);
     }
 }
+
+TEST_F(DefaultSegmentationTest, PipelineOutputSameAsSerial)
+{
+    // serial mode
+    m_initInfo->segmentationInfo->dirName = "./test_serial/";
+    m_initInfo->segmentationInfo->pipelineDepth = 0;
+    OmafPackage *serialPackage = new OmafPackage();
+    EXPECT_TRUE(serialPackage->InitOmafPackage(m_initInfo) == ERROR_NONE);
+    PackAllFrames(serialPackage);
+
+    // NAL parsing runs ahead of segmentation
+    m_initInfo->segmentationInfo->dirName = "./test_pipeline/";
+    m_initInfo->segmentationInfo->pipelineDepth = 4;
+    m_initInfo->segmentationInfo->segWorkersNum = 3;
+    OmafPackage *pipelinePackage = new OmafPackage();
+    EXPECT_TRUE(pipelinePackage->InitOmafPackage(m_initInfo) == ERROR_NONE);
+    PackAllFrames(pipelinePackage);
+
+    char serialSegName[1024];
+    char pipelineSegName[1024];
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        snprintf(serialSegName, 1024, "./test_serial/Test_track%d.1.mp4", i + 1);
+        snprintf(pipelineSegName, 1024, "./test_pipeline/Test_track%d.1.mp4", i + 1);
+        EXPECT_TRUE(IsSameFile(serialSegName, pipelineSegName));
+    }
+
+    for (uint8_t i = 0; i < 7; i++)
+    {
+        snprintf(serialSegName, 1024, "./test_serial/Test_track%d.1.mp4", i + 1000);
+        snprintf(pipelineSegName, 1024, "./test_pipeline/Test_track%d.1.mp4", i + 1000);
+        EXPECT_TRUE(IsSameFile(serialSegName, pipelineSegName));
+    }
+}
 }
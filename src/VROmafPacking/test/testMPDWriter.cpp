@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testMPDWriter.cpp
+//! \brief:  MPD writer plugin unit test and update latency benchmark
+//!
+
+#include "gtest/gtest.h"
+#include "DashMPDWriterPluginAPI.h"
+
+#include <atomic>
+#include <chrono>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+#define TEST_EXTRACTOR_TRACKS_NUM 144
+#define TEST_REF_TILES_NUM        8
+
+class MPDWriterTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        mkdir("./test_mpdwriter", 0755);
+
+        memset(&m_segInfo, 0, sizeof(SegmentationInfo));
+        m_segInfo.windowSize = 2;
+        m_segInfo.segDuration = 1;
+        m_segInfo.chunkDuration = 200;
+        m_segInfo.dirName = "./test_mpdwriter/";
+        m_segInfo.outName = "Test";
+        m_segInfo.baseUrl = "http://localhost/";
+        m_segInfo.isLive = true;
+        m_segInfo.targetLatency = 3500;
+        m_segInfo.minLatency = 2000;
+        m_segInfo.maxLatency = 10000;
+        m_segInfo.hasMainAS = false;
+
+        // one extractor track per viewport, each refers to several tile tracks
+        for (uint32_t i = 0; i < TEST_EXTRACTOR_TRACKS_NUM; i++)
+        {
+            VCD::MP4::MPDAdaptationSetCtx &asCtx = m_extractorCtxs[i];
+            asCtx.trackIdx = VCD::MP4::TrackId(1000 + i);
+            asCtx.codedMeta.width = 3840;
+            asCtx.codedMeta.height = 2048;
+            VCD::MP4::Quality3d quality;
+            quality.remainingArea = true;
+            for (uint8_t rank = 1; rank <= 2; rank++)
+            {
+                VCD::MP4::QualityInfo info;
+                info.qualityRank = rank;
+                info.origWidth = 7680 / rank;
+                info.origHeight = 3840 / rank;
+                VCD::MP4::Spherical sphere;
+                sphere.cAzimuth = (int32_t)(i * 2500000);
+                sphere.cElevation = 0;
+                sphere.cTilt = 0;
+                sphere.rAzimuth = 90 * 65536;
+                sphere.rElevation = 90 * 65536;
+                info.sphere = sphere;
+                quality.qualityInfo.push_back(info);
+            }
+            asCtx.codedMeta.qualityRankCoverage = quality;
+            for (uint32_t j = 0; j < TEST_REF_TILES_NUM; j++)
+            {
+                asCtx.refTrackIdxs.push_back(VCD::MP4::TrackId(1 + (i + j) % 128));
+            }
+            m_extractorASCtx[i] = &asCtx;
+        }
+
+        m_plugin = dlopen("/usr/local/lib/libMPDWriter.so", RTLD_LAZY);
+        ASSERT_TRUE(m_plugin != NULL);
+        m_create = (CreateMPDWriter*)dlsym(m_plugin, "Create");
+        m_destroy = (DestroyMPDWriter*)dlsym(m_plugin, "Destroy");
+        ASSERT_TRUE(m_create != NULL);
+        ASSERT_TRUE(m_destroy != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_plugin)
+        {
+            dlclose(m_plugin);
+            m_plugin = NULL;
+        }
+    }
+
+    MPDWriterBase* CreateWriter(bool cmafEnabled)
+    {
+        Rational frameRate = { 25, 1 };
+        MPDWriterBase *writer = m_create(&m_streamASCtx, &m_extractorASCtx, &m_segInfo,
+            VCD::OMAF::ProjectionFormat::PF_ERP, frameRate, 2, cmafEnabled);
+        if (writer && writer->Initialize())
+        {
+            m_destroy(writer);
+            writer = NULL;
+        }
+        return writer;
+    }
+
+    static std::string ReadFile(const char *fileName)
+    {
+        std::string content;
+        FILE *fp = fopen(fileName, "rb");
+        if (!fp)
+            return content;
+        char buf[4096];
+        size_t readSize = 0;
+        while ((readSize = fread(buf, 1, sizeof(buf), fp)) > 0)
+        {
+            content.append(buf, readSize);
+        }
+        fclose(fp);
+        return content;
+    }
+
+    static uint32_t CountOf(const std::string &content, const std::string &pattern)
+    {
+        uint32_t count = 0;
+        size_t pos = content.find(pattern);
+        while (pos != std::string::npos)
+        {
+            count++;
+            pos = content.find(pattern, pos + pattern.size());
+        }
+        return count;
+    }
+
+    std::map<MediaStream*, VCD::MP4::MPDAdaptationSetCtx*> m_streamASCtx;
+    std::map<uint32_t, VCD::MP4::MPDAdaptationSetCtx*>     m_extractorASCtx;
+    VCD::MP4::MPDAdaptationSetCtx                          m_extractorCtxs[TEST_EXTRACTOR_TRACKS_NUM];
+    SegmentationInfo                                       m_segInfo;
+    void                                                   *m_plugin = NULL;
+    CreateMPDWriter                                        *m_create = NULL;
+    DestroyMPDWriter                                       *m_destroy = NULL;
+};
+
+TEST_F(MPDWriterTest, StaticMpd)
+{
+    m_segInfo.isLive = false;
+    MPDWriterBase *writer = CreateWriter(false);
+    ASSERT_TRUE(writer != NULL);
+    EXPECT_TRUE(writer->WriteMpd(250) == ERROR_NONE);
+    m_destroy(writer);
+
+    std::string mpd = ReadFile("./test_mpdwriter/Test.mpd");
+    EXPECT_TRUE(mpd.find("type=\"static\"") != std::string::npos);
+    EXPECT_TRUE(mpd.find("mediaPresentationDuration=\"PT00H00M10.000S\"") != std::string::npos);
+    EXPECT_TRUE(mpd.find("<Period duration=\"PT00H00M10.000S\"") != std::string::npos);
+    EXPECT_TRUE(CountOf(mpd, "<AdaptationSet ") == TEST_EXTRACTOR_TRACKS_NUM);
+    EXPECT_TRUE(CountOf(mpd, "startNumber=\"1\"") == TEST_EXTRACTOR_TRACKS_NUM);
+    EXPECT_TRUE(mpd.find("</MPD>") != std::string::npos);
+}
+
+TEST_F(MPDWriterTest, LiveMpdUpdate)
+{
+    MPDWriterBase *writer = CreateWriter(true);
+    ASSERT_TRUE(writer != NULL);
+    EXPECT_TRUE(writer->UpdateMpd(1, 25) == ERROR_NONE);
+    std::string mpd = ReadFile("./test_mpdwriter/Test.mpd");
+    EXPECT_TRUE(CountOf(mpd, "startNumber=\"1\"") == TEST_EXTRACTOR_TRACKS_NUM);
+
+    // not at window boundary, MPD is kept as it is
+    EXPECT_TRUE(writer->UpdateMpd(2, 50) == ERROR_NONE);
+    EXPECT_TRUE(ReadFile("./test_mpdwriter/Test.mpd") == mpd);
+
+    EXPECT_TRUE(writer->UpdateMpd(7, 175) == ERROR_NONE);
+    mpd = ReadFile("./test_mpdwriter/Test.mpd");
+    EXPECT_TRUE(mpd.find("type=\"dynamic\"") != std::string::npos);
+    EXPECT_TRUE(mpd.find("publishTime=\"") != std::string::npos);
+    EXPECT_TRUE(CountOf(mpd, "<AdaptationSet ") == TEST_EXTRACTOR_TRACKS_NUM);
+    EXPECT_TRUE(CountOf(mpd, "startNumber=\"7\"") == TEST_EXTRACTOR_TRACKS_NUM);
+    EXPECT_TRUE(CountOf(mpd, "wallclockTime=\"") == TEST_EXTRACTOR_TRACKS_NUM);
+    EXPECT_TRUE(mpd.find("</MPD>") != std::string::npos);
+
+    m_destroy(writer);
+}
+
+TEST_F(MPDWriterTest, MpdAlwaysCompleteForReaders)
+{
+    MPDWriterBase *writer = CreateWriter(true);
+    ASSERT_TRUE(writer != NULL);
+    EXPECT_TRUE(writer->UpdateMpd(1, 25) == ERROR_NONE);
+
+    // clients polling the MPD should never see it missing or truncated
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> readsNum(0);
+    std::atomic<uint32_t> badReadsNum(0);
+    std::thread reader([&]() {
+        while (!stop)
+        {
+            std::string mpd = ReadFile("./test_mpdwriter/Test.mpd");
+            if (mpd.size() < 8 || mpd.compare(mpd.size() - 7, 7, "</MPD>\n"))
+                badReadsNum++;
+            readsNum++;
+        }
+    });
+
+    for (uint64_t segNum = 2; segNum < 200; segNum++)
+    {
+        EXPECT_TRUE(writer->UpdateMpd(segNum, segNum * 25) == ERROR_NONE);
+    }
+    stop = true;
+    reader.join();
+    m_destroy(writer);
+
+    EXPECT_TRUE(readsNum > 0);
+    EXPECT_TRUE(badReadsNum == 0);
+}
+
+TEST_F(MPDWriterTest, UpdateLatency)
+{
+    MPDWriterBase *writer = CreateWriter(true);
+    ASSERT_TRUE(writer != NULL);
+
+    // the first write generates the whole MPD
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(writer->UpdateMpd(1, 25) == ERROR_NONE);
+    std::chrono::duration<double, std::micro> firstElapsed = std::chrono::steady_clock::now() - start;
+
+    uint32_t updatesNum = 100;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < updatesNum; i++)
+    {
+        // every update is at window boundary
+        uint64_t segNum = 3 + i * 2;
+        EXPECT_TRUE(writer->UpdateMpd(segNum, segNum * 25) == ERROR_NONE);
+    }
+    std::chrono::duration<double, std::micro> updateElapsed = std::chrono::steady_clock::now() - start;
+    m_destroy(writer);
+
+    double avgUpdate = updateElapsed.count() / updatesNum;
+    printf("MPD with %d adaptation sets, first write %.1f us, update %.1f us on average\n",
+        TEST_EXTRACTOR_TRACKS_NUM, firstElapsed.count(), avgUpdate);
+    EXPECT_TRUE(avgUpdate < firstElapsed.count());
+}
+}
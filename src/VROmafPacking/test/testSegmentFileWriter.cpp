@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testSegmentFileWriter.cpp
+//! \brief:  Segment file writer class unit test
+//!
+
+#include "gtest/gtest.h"
+#include "../SegmentFileWriter.h"
+
+#include <chrono>
+#include <sstream>
+#include <sys/stat.h>
+
+VCD_USE_VRVIDEO;
+
+namespace {
+class SegmentFileWriterTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        mkdir("./test_segwriter", 0755);
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    //! write boxes like segment writer does, including patching
+    //! box size after payload is written
+    static void WriteBoxes(std::ostream &outStr, uint32_t payloadSize)
+    {
+        for (uint32_t boxIdx = 0; boxIdx < 3; boxIdx++)
+        {
+            std::streampos boxPos = outStr.tellp();
+            char header[8] = { 0, 0, 0, 0, 'm', 'd', 'a', 't' };
+            outStr.write(header, 8);
+            for (uint32_t i = 0; i < payloadSize; i++)
+            {
+                outStr.put((char)(i * 7 + boxIdx));
+            }
+            std::streampos afterBox = outStr.tellp();
+            uint32_t boxSize = (uint32_t)(afterBox - boxPos);
+            char sizeBytes[4] = { (char)(boxSize >> 24), (char)(boxSize >> 16), (char)(boxSize >> 8), (char)boxSize };
+            outStr.seekp(boxPos);
+            outStr.write(sizeBytes, 4);
+            outStr.seekp(afterBox);
+        }
+    }
+
+    static std::string ReadFile(const char *fileName)
+    {
+        std::string content;
+        FILE *fp = fopen(fileName, "rb");
+        if (!fp)
+            return content;
+        char buf[4096];
+        size_t readSize = 0;
+        while ((readSize = fread(buf, 1, sizeof(buf), fp)) > 0)
+        {
+            content.append(buf, readSize);
+        }
+        fclose(fp);
+        return content;
+    }
+
+    static bool IsFileExist(const char *fileName)
+    {
+        struct stat buf;
+        return (stat(fileName, &buf) == 0);
+    }
+
+    void CheckWriteFile(bool directIO, const char *fileName)
+    {
+        SegmentFileWriter writer;
+        EXPECT_TRUE(writer.Initialize(directIO) == ERROR_NONE);
+
+        // payload crosses several blocks and the last block is partially filled
+        uint32_t payloadSize = SEGMENT_BLOCK_SIZE + 1234;
+        std::ostringstream expected;
+        WriteBoxes(expected, payloadSize);
+
+        SegmentBuffer *buffer = new SegmentBuffer(&writer);
+        std::ostream outStr(buffer);
+        WriteBoxes(outStr, payloadSize);
+        EXPECT_TRUE(outStr.good());
+        EXPECT_TRUE(buffer->GetSize() == expected.str().size());
+
+        EXPECT_TRUE(writer.WriteFile(buffer, fileName) == ERROR_NONE);
+        EXPECT_TRUE(writer.Flush() == ERROR_NONE);
+
+        std::string tmpName = std::string(fileName) + ".tmp";
+        EXPECT_FALSE(IsFileExist(tmpName.c_str()));
+        EXPECT_TRUE(ReadFile(fileName) == expected.str());
+    }
+};
+
+TEST_F(SegmentFileWriterTest, InvalidParams)
+{
+    SegmentFileWriter writer;
+    SegmentBuffer *buffer = new SegmentBuffer(&writer);
+    EXPECT_TRUE(writer.WriteFile(buffer, "./test_segwriter/invalid.mp4") == OMAF_ERROR_INVALID_THREAD);
+    EXPECT_TRUE(writer.WriteFile(NULL, "./test_segwriter/invalid.mp4") == OMAF_ERROR_NULL_PTR);
+    EXPECT_TRUE(writer.Initialize(false) == ERROR_NONE);
+    EXPECT_TRUE(writer.Initialize(false) == OMAF_ERROR_INVALID_THREAD);
+}
+
+TEST_F(SegmentFileWriterTest, WriteFile)
+{
+    CheckWriteFile(false, "./test_segwriter/buffered.mp4");
+}
+
+TEST_F(SegmentFileWriterTest, WriteFileWithDirectIO)
+{
+    CheckWriteFile(true, "./test_segwriter/direct.mp4");
+}
+
+TEST_F(SegmentFileWriterTest, RemoveAfterWrite)
+{
+    const char *fileName = "./test_segwriter/removed.mp4";
+    SegmentFileWriter writer;
+    EXPECT_TRUE(writer.Initialize(false) == ERROR_NONE);
+
+    SegmentBuffer *buffer = new SegmentBuffer(&writer);
+    std::ostream outStr(buffer);
+    WriteBoxes(outStr, 100);
+    EXPECT_TRUE(writer.WriteFile(buffer, fileName) == ERROR_NONE);
+    EXPECT_TRUE(writer.RemoveFile(fileName) == ERROR_NONE);
+    EXPECT_TRUE(writer.Flush() == ERROR_NONE);
+    EXPECT_FALSE(IsFileExist(fileName));
+}
+
+TEST_F(SegmentFileWriterTest, ReportWriteError)
+{
+    SegmentFileWriter writer;
+    EXPECT_TRUE(writer.Initialize(false) == ERROR_NONE);
+
+    SegmentBuffer *buffer = new SegmentBuffer(&writer);
+    std::ostream outStr(buffer);
+    WriteBoxes(outStr, 100);
+    EXPECT_TRUE(writer.WriteFile(buffer, "./test_segwriter/no_dir/error.mp4") == ERROR_NONE);
+    EXPECT_TRUE(writer.Flush() == OMAF_FILE_OPEN_ERROR);
+
+    buffer = new SegmentBuffer(&writer);
+    EXPECT_TRUE(writer.WriteFile(buffer, "./test_segwriter/after_error.mp4") == OMAF_FILE_OPEN_ERROR);
+}
+
+TEST_F(SegmentFileWriterTest, SegmentsPerSecond)
+{
+    uint32_t segmentsNum = 200;
+    uint32_t payloadSize = 256 * 1024;
+    char fileName[1024];
+
+    // previous way: serialize into string stream, copy and write synchronously
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t segIdx = 0; segIdx < segmentsNum; segIdx++)
+    {
+        std::ostringstream outStr;
+        WriteBoxes(outStr, payloadSize);
+        std::string segString(outStr.str());
+        snprintf(fileName, 1024, "./test_segwriter/sync_%u.mp4", segIdx % 16);
+        FILE *fp = fopen(fileName, "wb+");
+        EXPECT_TRUE(fp != NULL);
+        if (fp)
+        {
+            fwrite(segString.c_str(), 1, segString.size(), fp);
+            fclose(fp);
+        }
+    }
+    std::chrono::duration<double> syncElapsed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    double submitTime = 0;
+    {
+        SegmentFileWriter writer;
+        EXPECT_TRUE(writer.Initialize(false) == ERROR_NONE);
+        for (uint32_t segIdx = 0; segIdx < segmentsNum; segIdx++)
+        {
+            SegmentBuffer *buffer = new SegmentBuffer(&writer);
+            std::ostream outStr(buffer);
+            WriteBoxes(outStr, payloadSize);
+            snprintf(fileName, 1024, "./test_segwriter/async_%u.mp4", segIdx % 16);
+            EXPECT_TRUE(writer.WriteFile(buffer, fileName) == ERROR_NONE);
+        }
+        std::chrono::duration<double> submitElapsed = std::chrono::steady_clock::now() - start;
+        submitTime = submitElapsed.count();
+        EXPECT_TRUE(writer.Flush() == ERROR_NONE);
+    }
+    std::chrono::duration<double> asyncElapsed = std::chrono::steady_clock::now() - start;
+
+    printf("sync write: %.1f segments/s, async write: %.1f segments/s, %.1f segments/s seen by segmentation thread\n",
+        segmentsNum / syncElapsed.count(), segmentsNum / asyncElapsed.count(), segmentsNum / submitTime);
+    EXPECT_TRUE(syncElapsed.count() > 0 && asyncElapsed.count() > 0);
+}
+}
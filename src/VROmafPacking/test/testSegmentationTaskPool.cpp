@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   testSegmentationTaskPool.cpp
+//! \brief:  Segmentation task pool class unit test
+//!
+
+#include "gtest/gtest.h"
+#include "../SegmentationTaskPool.h"
+
+#include <chrono>
+
+VCD_USE_VRVIDEO;
+
+namespace {
+class SegmentationTaskPoolTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        m_tracksNum = 64;
+        m_framesNum = 200;
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    //! emulate ConstructExtractors + WriteSegmentForEachExtractorTrack
+    //! of one extractor track for one frame
+    static uint64_t OneTrackWork(uint32_t seed)
+    {
+        uint64_t sum = seed;
+        for (uint32_t i = 0; i < 20000; i++)
+        {
+            sum = sum * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        return sum;
+    }
+
+    double RunFrames(uint32_t workersNum)
+    {
+        SegmentationTaskPool pool;
+        EXPECT_TRUE(pool.Initialize(workersNum) == ERROR_NONE);
+        EXPECT_TRUE(pool.GetWorkersNum() == workersNum);
+
+        std::vector<uint64_t> results(m_tracksNum, 0);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t frameIdx = 0; frameIdx < m_framesNum; frameIdx++)
+        {
+            FrameLatch frameLatch(m_tracksNum);
+            for (uint32_t trackIdx = 0; trackIdx < m_tracksNum; trackIdx++)
+            {
+                int32_t ret = pool.Submit([&results, &frameLatch, trackIdx, frameIdx]() {
+                    results[trackIdx] += OneTrackWork(trackIdx + frameIdx);
+                    frameLatch.CountDown();
+                });
+                EXPECT_TRUE(ret == ERROR_NONE);
+            }
+            frameLatch.Wait();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        for (uint32_t trackIdx = 0; trackIdx < m_tracksNum; trackIdx++)
+        {
+            EXPECT_TRUE(results[trackIdx] != 0);
+        }
+
+        double fps = m_framesNum / elapsed.count();
+        printf("%u workers: %u frames with %u extractor tracks, %.1f fps, %lu tasks stolen\n",
+            workersNum, m_framesNum, m_tracksNum, fps, pool.GetStolenTasksNum());
+        return fps;
+    }
+
+    uint32_t m_tracksNum;
+    uint32_t m_framesNum;
+};
+
+TEST_F(SegmentationTaskPoolTest, InvalidParams)
+{
+    SegmentationTaskPool pool;
+    EXPECT_TRUE(pool.Submit([]() {}) == OMAF_ERROR_INVALID_THREAD);
+    EXPECT_TRUE(pool.Initialize(0) == OMAF_ERROR_BAD_PARAM);
+    EXPECT_TRUE(pool.Initialize(2) == ERROR_NONE);
+    EXPECT_TRUE(pool.Initialize(2) == OMAF_ERROR_INVALID_THREAD);
+}
+
+TEST_F(SegmentationTaskPoolTest, AllTasksDoneBeforeLatchReleased)
+{
+    SegmentationTaskPool pool;
+    EXPECT_TRUE(pool.Initialize(8) == ERROR_NONE);
+
+    for (uint32_t frameIdx = 0; frameIdx < 100; frameIdx++)
+    {
+        std::atomic<uint32_t> doneNum(0);
+        FrameLatch frameLatch(m_tracksNum);
+        for (uint32_t trackIdx = 0; trackIdx < m_tracksNum; trackIdx++)
+        {
+            pool.Submit([&doneNum, &frameLatch]() {
+                doneNum++;
+                frameLatch.CountDown();
+            });
+        }
+        frameLatch.Wait();
+        EXPECT_TRUE(doneNum == m_tracksNum);
+    }
+}
+
+TEST_F(SegmentationTaskPoolTest, StopAfterPendingTasks)
+{
+    std::atomic<uint32_t> doneNum(0);
+    {
+        SegmentationTaskPool pool;
+        EXPECT_TRUE(pool.Initialize(4) == ERROR_NONE);
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            pool.Submit([&doneNum]() { doneNum++; });
+        }
+    }
+    EXPECT_TRUE(doneNum == 1000);
+}
+
+TEST_F(SegmentationTaskPoolTest, SubmitAfterStop)
+{
+    SegmentationTaskPool pool;
+    EXPECT_TRUE(pool.Initialize(2) == ERROR_NONE);
+    pool.Stop();
+
+    bool done = false;
+    EXPECT_TRUE(pool.Submit([&done]() { done = true; }) == OMAF_ERROR_INVALID_THREAD);
+    EXPECT_FALSE(done);
+}
+
+TEST_F(SegmentationTaskPoolTest, FramesPerSecond)
+{
+    double fps1 = RunFrames(1);
+    double fps8 = RunFrames(8);
+    double fps32 = RunFrames(32);
+    EXPECT_TRUE(fps1 > 0 && fps8 > 0 && fps32 > 0);
+}
+}
@@ -32,6 +32,8 @@
 //!
 
 #include <dlfcn.h>
+#include <thread>
+#include <unistd.h>
 #include "gtest/gtest.h"
 #include "VideoStreamPluginAPI.h"
 #include "error.h"
@@ -1103,3 +1105,166 @@ TEST_F(VideoStreamTest, AllProcess)
     fclose(fp);
     fp = NULL;
 }
+
+static void ReleaseFrameData(uint8_t *data, void *opaque)
+{
+    uint32_t *releasedNum = (uint32_t*)opaque;
+    (*releasedNum)++;
+    delete [] data;
+}
+
+TEST_F(VideoStreamTest, FrameQueuePolicy)
+{
+    CreateVideoStream* createVS = (CreateVideoStream*)dlsym(m_vsPlugin, "Create");
+    DestroyVideoStream* destroyVS = (DestroyVideoStream*)dlsym(m_vsPlugin, "Destroy");
+    ASSERT_TRUE(createVS != NULL);
+    ASSERT_TRUE(destroyVS != NULL);
+
+    m_initInfo->segmentationInfo->needBufedFrames = 2;
+    m_initInfo->segmentationInfo->frameQueueDepth = 3;
+
+    E_FrameQueuePolicy policies[3] = { E_FRAME_QUEUE_NONBLOCK, E_FRAME_QUEUE_DROP_OLDEST, E_FRAME_QUEUE_BLOCK };
+    for (uint8_t policyIdx = 0; policyIdx < 3; policyIdx++)
+    {
+        m_initInfo->segmentationInfo->frameQueuePolicy = policies[policyIdx];
+        VideoStream *vs = createVS();
+        ASSERT_TRUE(vs != NULL);
+        ((MediaStream*)vs)->SetMediaType(VIDEOTYPE);
+        ((MediaStream*)vs)->SetCodecId(CODEC_ID_H265);
+        int32_t ret = vs->Initialize(m_lowResStreamIdx, &(m_initInfo->bsBuffers[0]), m_initInfo);
+        EXPECT_TRUE(ret == ERROR_NONE);
+
+        uint32_t releasedNum = 0;
+        uint32_t queuedNum = 0;
+        for (uint8_t idx = 0; idx < 5; idx++)
+        {
+            if ((policies[policyIdx] == E_FRAME_QUEUE_BLOCK) && (idx == 3))
+                break;
+
+            FrameBSInfo frameInfo;
+            memset_s(&frameInfo, sizeof(FrameBSInfo), 0);
+            frameInfo.data = new uint8_t[16];
+            frameInfo.dataSize = 16;
+            frameInfo.pts = idx;
+            frameInfo.isKeyFrame = (idx == 0);
+            ret = vs->AddFrameInfo(&frameInfo, ReleaseFrameData, &releasedNum);
+            if (ret)
+            {
+                // caller keeps the ownership of rejected frame
+                EXPECT_TRUE(ret == OMAF_ERROR_FRAME_QUEUE_FULL);
+                delete [] frameInfo.data;
+            }
+            else
+            {
+                queuedNum++;
+            }
+        }
+
+        FrameQueueStats stats;
+        memset_s(&stats, sizeof(FrameQueueStats), 0);
+        vs->GetFrameQueueStats(&stats);
+        EXPECT_TRUE(stats.capacity == 3);
+        EXPECT_TRUE(stats.depth == 3);
+        EXPECT_TRUE(stats.maxDepth == 3);
+        EXPECT_TRUE(vs->GetBufferedFrameNum() == 3);
+
+        if (policies[policyIdx] == E_FRAME_QUEUE_NONBLOCK)
+        {
+            EXPECT_TRUE(queuedNum == 3);
+            EXPECT_TRUE(stats.rejectedFrames == 2);
+            EXPECT_TRUE(releasedNum == 0);
+        }
+        else if (policies[policyIdx] == E_FRAME_QUEUE_DROP_OLDEST)
+        {
+            EXPECT_TRUE(queuedNum == 5);
+            EXPECT_TRUE(stats.droppedFrames == 2);
+            EXPECT_TRUE(releasedNum == 2);
+
+            FrameBSInfo *oldest = vs->FetchFrameInfo();
+            ASSERT_TRUE(oldest != NULL);
+            EXPECT_TRUE(oldest->pts == 2);
+            vs->ReleaseFrameInfo(oldest);
+            EXPECT_TRUE(releasedNum == 3);
+        }
+        else
+        {
+            // writer is blocked until one frame is consumed
+            std::thread writer([&]() {
+                FrameBSInfo frameInfo;
+                memset_s(&frameInfo, sizeof(FrameBSInfo), 0);
+                frameInfo.data = new uint8_t[16];
+                frameInfo.dataSize = 16;
+                frameInfo.pts = 3;
+                EXPECT_TRUE(vs->AddFrameInfo(&frameInfo, ReleaseFrameData, &releasedNum) == ERROR_NONE);
+            });
+            usleep(20000);
+            EXPECT_TRUE(vs->GetBufferedFrameNum() == 3);
+
+            vs->SetCurrFrameInfo();
+            EXPECT_TRUE(vs->GetCurrFrameInfo()->pts == 0);
+            writer.join();
+            EXPECT_TRUE(vs->GetBufferedFrameNum() == 3);
+
+            vs->DestroyCurrFrameInfo();
+            EXPECT_TRUE(releasedNum == 1);
+
+            vs->GetFrameQueueStats(&stats);
+            EXPECT_TRUE(stats.queuedFrames == 4);
+            EXPECT_TRUE(stats.blockedTimeUs > 0);
+        }
+
+        // frames still queued are released with the video stream
+        destroyVS(vs);
+        EXPECT_TRUE(releasedNum == (queuedNum + ((policies[policyIdx] == E_FRAME_QUEUE_BLOCK) ? 1 : 0)));
+    }
+}
+
+TEST_F(VideoStreamTest, FrameQueueDestroyWithBlockedWriter)
+{
+    CreateVideoStream* createVS = (CreateVideoStream*)dlsym(m_vsPlugin, "Create");
+    DestroyVideoStream* destroyVS = (DestroyVideoStream*)dlsym(m_vsPlugin, "Destroy");
+    ASSERT_TRUE(createVS != NULL);
+    ASSERT_TRUE(destroyVS != NULL);
+
+    m_initInfo->segmentationInfo->needBufedFrames = 2;
+    m_initInfo->segmentationInfo->frameQueueDepth = 3;
+    m_initInfo->segmentationInfo->frameQueuePolicy = E_FRAME_QUEUE_BLOCK;
+
+    VideoStream *vs = createVS();
+    ASSERT_TRUE(vs != NULL);
+    ((MediaStream*)vs)->SetMediaType(VIDEOTYPE);
+    ((MediaStream*)vs)->SetCodecId(CODEC_ID_H265);
+    int32_t ret = vs->Initialize(m_lowResStreamIdx, &(m_initInfo->bsBuffers[0]), m_initInfo);
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    uint32_t releasedNum = 0;
+    for (uint8_t idx = 0; idx < 3; idx++)
+    {
+        FrameBSInfo frameInfo;
+        memset_s(&frameInfo, sizeof(FrameBSInfo), 0);
+        frameInfo.data = new uint8_t[16];
+        frameInfo.dataSize = 16;
+        frameInfo.pts = idx;
+        EXPECT_TRUE(vs->AddFrameInfo(&frameInfo, ReleaseFrameData, &releasedNum) == ERROR_NONE);
+    }
+
+    // writer blocked by full queue gives up once the video stream is destroyed,
+    // and the destruction waits for it to leave
+    int32_t writerRet = ERROR_NONE;
+    std::thread writer([&]() {
+        FrameBSInfo frameInfo;
+        memset_s(&frameInfo, sizeof(FrameBSInfo), 0);
+        frameInfo.data = new uint8_t[16];
+        frameInfo.dataSize = 16;
+        frameInfo.pts = 3;
+        writerRet = vs->AddFrameInfo(&frameInfo, ReleaseFrameData, &releasedNum);
+        if (writerRet)
+            delete [] frameInfo.data;
+    });
+    usleep(20000);
+
+    destroyVS(vs);
+    writer.join();
+    EXPECT_TRUE(writerRet == OMAF_ERROR_OPERATION);
+    EXPECT_TRUE(releasedNum == 3);
+}
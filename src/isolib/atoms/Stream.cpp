@@ -222,6 +222,11 @@ void Stream::WriteArray(const std::vector<std::uint8_t>& bits,
                     bits.begin() + static_cast<std::int64_t>(srcOffset + copyLen));
 }
 
+void Stream::WriteArray(const std::uint8_t* data, const std::uint64_t len)
+{
+    m_storage.insert(m_storage.end(), data, data + len);
+}
+
 void Stream::Write1(std::uint64_t bits, std::uint32_t len)
 {
     if (len == 0)
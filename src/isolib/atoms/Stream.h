@@ -234,6 +234,18 @@ public:
                             std::uint64_t len       = UINT64_MAX,
                             std::uint64_t srcOffset = 0);
 
+    //!
+    //! \brief    Write array 8bit
+    //!
+    //! \param    [in] const std::uint8_t*
+    //!           data
+    //! \param    [in] std::uint64_t
+    //!           len
+    //!
+    //! \return   void
+    //!
+    void WriteArray(const std::uint8_t* data, const std::uint64_t len);
+
     //!
     //! \brief    Write String
     //!
@@ -105,6 +105,7 @@ template struct VarLenArray<TypeToTrackIDs>;
 template struct VarLenArray<TrackSampInfo>;
 template struct VarLenArray<TrackInformation>;
 template struct VarLenArray<SegInfo>;
+template struct VarLenArray<SegSample>;
 template struct VarLenArray<RWPKRegion>;
 template struct VarLenArray<COVIRegion>;
 template struct VarLenArray<SchemeType>;
@@ -403,6 +403,22 @@ struct SegInfo
     uint8_t SAPType;
 };
 
+//!
+//! \brief  Flattened sample information of one track in one
+//!         segment, sampleId is the item index used by
+//!         GetSampData, time stamps are in track time scale
+//!
+struct SegSample
+{
+    uint32_t sampleId;
+    uint64_t dataOffset;
+    uint32_t dataLength;
+    uint32_t durationTS;
+    uint64_t decodeTimeTS;
+    uint64_t compositionTimeTS;
+    bool isSync;
+};
+
 struct SchemeType
 {
     FourCC type;
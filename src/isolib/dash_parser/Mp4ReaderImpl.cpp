@@ -345,6 +345,105 @@ void Mp4Reader::RefreshCompTimes(InitSegmentId initSegId, SegmentId segIndex)
     }
 }
 
+void Mp4Reader::BuildSampTables(InitSegmentId initSegId, SegmentId segIndex)
+{
+    const SegmentProperties& segProps = m_initSegProps.at(initSegId).segPropMap.at(segIndex);
+    for (auto& decInfoPair : segProps.trackDecInfos)
+    {
+        const ContextId ctxId = decInfoPair.first;
+        const TrackDecInfo& trackDecInfo = decInfoPair.second;
+        if (trackDecInfo.samples.empty() || (ctxId.GetIndex() >> 16) != 0)
+        {
+            continue;
+        }
+
+        const InitSegmentTrackId trackIdPair = make_pair(initSegId, ctxId);
+        const uint32_t itemIdBase = trackDecInfo.itemIdBase.GetIndex();
+        SegSampTable& table = m_sampTables[GenTrackId(trackIdPair)][itemIdBase];
+        table.segIndex = segIndex;
+        table.samples.clear();
+        table.codeTypes.clear();
+        table.samples.reserve(trackDecInfo.samples.size());
+        table.codeTypes.reserve(trackDecInfo.samples.size());
+
+        // decode time of the first sample, nextPTSTS has been moved
+        // forward by all sample durations of this segment
+        uint64_t decodeTime = uint64_t(trackDecInfo.nextPTSTS - trackDecInfo.durationTS);
+        for (uint32_t index = 0; index < trackDecInfo.samples.size(); index++)
+        {
+            const SampleInfo& sampInfo = trackDecInfo.samples[index];
+            SegSample sample;
+            sample.sampleId          = itemIdBase + index;
+            sample.dataOffset        = sampInfo.dataOffset;
+            sample.dataLength        = sampInfo.dataLength;
+            sample.durationTS        = sampInfo.sampleDuration;
+            sample.decodeTimeTS      = decodeTime;
+            sample.compositionTimeTS =
+                sampInfo.compositionTimesTS.empty() ? decodeTime : sampInfo.compositionTimesTS.front();
+            sample.isSync            = (sampInfo.sampleType == OUTPUT_REF_FRAME);
+            decodeTime += sampInfo.sampleDuration;
+            table.samples.push_back(sample);
+
+            FourCC codeType;
+            if (GetDecCodeTypeInSeg(trackIdPair, segIndex, sample.sampleId, codeType) != ERROR_NONE)
+            {
+                codeType = FourCC();
+            }
+            table.codeTypes.push_back(codeType);
+        }
+    }
+}
+
+void Mp4Reader::DropSampTables(InitSegmentId initSegId, SegmentId segIndex)
+{
+    const SegmentProperties& segProps = m_initSegProps.at(initSegId).segPropMap.at(segIndex);
+    for (auto& decInfoPair : segProps.trackDecInfos)
+    {
+        if ((decInfoPair.first.GetIndex() >> 16) != 0)
+        {
+            continue;
+        }
+        auto tablesIt = m_sampTables.find(GenTrackId(make_pair(initSegId, decInfoPair.first)));
+        if (tablesIt == m_sampTables.end())
+        {
+            continue;
+        }
+        auto tableIt = tablesIt->second.find(decInfoPair.second.itemIdBase.GetIndex());
+        if (tableIt != tablesIt->second.end() && tableIt->second.segIndex == segIndex)
+        {
+            tablesIt->second.erase(tableIt);
+        }
+        if (tablesIt->second.empty())
+        {
+            m_sampTables.erase(tablesIt);
+        }
+    }
+}
+
+const Mp4Reader::SegSampTable* Mp4Reader::FindSampTable(uint32_t trackId,
+                                                        uint32_t itemIndex,
+                                                        uint32_t& index) const
+{
+    auto tablesIt = m_sampTables.find(trackId);
+    if (tablesIt == m_sampTables.end())
+    {
+        return NULL;
+    }
+    // the last table whose item id base is not larger than itemIndex
+    auto tableIt = tablesIt->second.upper_bound(itemIndex);
+    if (tableIt == tablesIt->second.begin())
+    {
+        return NULL;
+    }
+    --tableIt;
+    index = itemIndex - tableIt->first;
+    if (index >= tableIt->second.samples.size())
+    {
+        return NULL;
+    }
+    return &(tableIt->second);
+}
+
 DashSegGroup Mp4Reader::CreateDashSegs(InitSegmentId initSegId)
 {
     return DashSegGroup(*this, initSegId);
@@ -540,6 +639,10 @@ int32_t Mp4Reader::DisableInitSeg(uint32_t initSegId)
         for (auto& basicTrackInfo : m_initSegProps.at(initSegId).basicTrackInfos)
         {
             m_ctxInfoMap.erase(InitSegmentTrackId(initSegId, basicTrackInfo.first));
+            if ((basicTrackInfo.first.GetIndex() >> 16) == 0)
+            {
+                m_sampTables.erase(GenTrackId(InitSegmentTrackId(initSegId, basicTrackInfo.first)));
+            }
         }
         m_initSegProps.erase(initSegId);
     }
@@ -550,6 +653,21 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
                                           uint32_t initSegId,
                                           uint32_t segIndex,
                                           uint64_t earliestPTSinTS)
+{
+    ParsedSegment parsedSeg;
+    int32_t error = ReadSeg(strIO, initSegId, segIndex, parsedSeg);
+    if (error)
+    {
+        return error;
+    }
+
+    return AddParsedSeg(parsedSeg, earliestPTSinTS);
+}
+
+int32_t Mp4Reader::ReadSeg(StreamIO* strIO,
+                                         uint32_t initSegId,
+                                         uint32_t segIndex,
+                                         ParsedSegment& parsedSeg)
 {
     if (m_initSegProps.count(initSegId) &&
         m_initSegProps.at(initSegId).segPropMap.count(segIndex))
@@ -561,29 +679,22 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
         return OMAF_INVALID_SEGMENT;
     }
 
-    ReaderState prevState = m_readerSte;
-    m_readerSte          = ReaderState::INITIALIZING;
-
-    SegmentProperties& segProps =
-        m_initSegProps.at(initSegId).segPropMap[segIndex];
-    SegmentIO& io = segProps.io;
+    SegmentIO& io = parsedSeg.io;
     io.strIO.reset(new StreamIOInternal(strIO));
     if (io.strIO->PeekEOS())
     {
-        m_readerSte = prevState;
         io.strIO.reset();
         ISO_LOG(LOG_ERROR, "Peek to EOS!!!\n");
         return OMAF_FILE_READ_ERROR;
     }
     io.size = strIO->GetStreamSize();
 
-    segProps.initSegmentId = initSegId;
-    segProps.segmentId     = segIndex;
+    parsedSeg.initSegmentId = initSegId;
+    parsedSeg.segmentId     = segIndex;
 
     bool stypFound       = false;
     bool prftFound       = false;
     bool earliestPTSRead = false;
-    std::map<ContextId, PrestTS> earliestPTSTS;
 
     int32_t error = ERROR_NONE;
     try
@@ -607,8 +718,8 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
 
                         if (stypFound == false)
                         {
-                            segProps.styp = styp;
-                            stypFound     = true;
+                            parsedSeg.styp = styp;
+                            stypFound      = true;
                         }
                     }
                 }
@@ -622,14 +733,9 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
 
                         if (!earliestPTSRead)
                         {
-                            earliestPTSRead = true;
-
-                            for (auto& basicTrackInfo : m_initSegProps.at(initSegId).basicTrackInfos)
-                            {
-                                ContextId ctxId = basicTrackInfo.first;
-                                earliestPTSTS[ctxId] =
-                                    PrestTS(sidx.GetEarliestPresentationTime());
-                            }
+                            earliestPTSRead           = true;
+                            parsedSeg.sidxFound       = true;
+                            parsedSeg.sidxEarliestPTS = sidx.GetEarliestPresentationTime();
                         }
                     }
                 }
@@ -643,8 +749,8 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
 
                         if (prftFound == false)
                         {
-                            segProps.prft = prft;
-                            prftFound     = true;
+                            parsedSeg.prft = prft;
+                            prftFound      = true;
                         }
                     }
                 }
@@ -655,45 +761,13 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
                     error = ReadAtom(io, bitstream);
                     if (!error)
                     {
-                        MovieFragmentAtom moof(
+                        auto moof = MakeUnique<MovieFragmentAtom, MovieFragmentAtom>(
                             m_initSegProps.at(initSegId).moovProperties.fragmentSampleDefaults);
-                        moof.SetMoofFirstByteOffset(static_cast<uint64_t>(moofFirstByte));
-                        moof.FromStream(bitstream);
-
-                        if (!earliestPTSRead)
-                        {
-                            for (auto& basicTrackInfo : m_initSegProps.at(initSegId).basicTrackInfos)
-                            {
-                                ContextId ctxId = basicTrackInfo.first;
-                                if (earliestPTSinTS != UINT64_MAX)
-                                {
-                                    earliestPTSTS[ctxId] = PrestTS(earliestPTSinTS);
-                                }
-                                else if (const TrackDecInfo* precTrackDecInfo = GetPrevTrackDecInfo(
-                                             initSegId, SegmentTrackId(segIndex, ctxId)))
-                                {
-                                    if (precTrackDecInfo)
-                                    {
-                                        earliestPTSTS[ctxId] = precTrackDecInfo->noSidxFallbackPTSTS;
-                                    }
-                                }
-                                else
-                                {
-                                    earliestPTSTS[ctxId] = 0;
-                                }
-                            }
-
-                            earliestPTSRead = true;
-                        }
+                        moof->SetMoofFirstByteOffset(static_cast<uint64_t>(moofFirstByte));
+                        moof->FromStream(bitstream);
 
-                        CtxIdPresentTSMap earliestPTSTSForTrack;
-                        for (auto& trackFragmentAtom : moof.GetTrackFragmentAtoms())
-                        {
-                            auto ctxId = ContextId(trackFragmentAtom->GetTrackFragmentHeaderAtom().GetTrackId());
-                            earliestPTSTSForTrack.insert(make_pair(ctxId, earliestPTSTS.at(ctxId)));
-                        }
-
-                        AddTrackProps(initSegId, segIndex, moof, earliestPTSTSForTrack);
+                        earliestPTSRead = true;
+                        parsedSeg.moofs.push_back(std::move(moof));
                     }
                 }
                 else if (boxType == "mdat")
@@ -723,29 +797,131 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
         error = OMAF_FILE_READ_ERROR;
     }
 
-    if (!error)
+    if (!error && (!io.strIO->IsStreamGood()) && (!io.strIO->IsReachEOS()))
     {
-        for (auto& trackDecInfo : segProps.trackDecInfos)
+        ISO_LOG(LOG_ERROR, "Stream is Good? %d\n", int32_t(io.strIO->IsStreamGood()));
+        ISO_LOG(LOG_ERROR, "Reach to EOS? %d\n", int32_t(io.strIO->IsReachEOS()));
+        error = OMAF_FILE_READ_ERROR;
+    }
+
+    if (error)
+    {
+        io.strIO.reset();
+        parsedSeg.moofs.clear();
+        return error;
+    }
+
+    io.strIO->ClearStatus();
+    return ERROR_NONE;
+}
+
+int32_t Mp4Reader::AddParsedSeg(ParsedSegment& parsedSeg, uint64_t earliestPTSinTS)
+{
+    // the segment has been parsed when it was read
+    if (!parsedSeg.io.strIO)
+    {
+        return ERROR_NONE;
+    }
+
+    InitSegmentId initSegId = parsedSeg.initSegmentId;
+    SegmentId segIndex      = parsedSeg.segmentId;
+    // the init segment may be disabled or the segment may be parsed by
+    // others since the segment was read
+    if (!m_initSegProps.count(initSegId))
+    {
+        return OMAF_INVALID_SEGMENT;
+    }
+    if (m_initSegProps.at(initSegId).segPropMap.count(segIndex))
+    {
+        return ERROR_NONE;
+    }
+
+    SegmentProperties& segProps = m_initSegProps.at(initSegId).segPropMap[segIndex];
+    segProps.io            = std::move(parsedSeg.io);
+    segProps.initSegmentId = initSegId;
+    segProps.segmentId     = segIndex;
+    segProps.styp          = parsedSeg.styp;
+    segProps.prft          = parsedSeg.prft;
+
+    bool earliestPTSRead = false;
+    std::map<ContextId, PrestTS> earliestPTSTS;
+    if (parsedSeg.sidxFound)
+    {
+        earliestPTSRead = true;
+        for (auto& basicTrackInfo : m_initSegProps.at(initSegId).basicTrackInfos)
         {
-            CfgSegSidxFallback(initSegId, make_pair(segIndex, trackDecInfo.first));
+            earliestPTSTS[basicTrackInfo.first] = PrestTS(parsedSeg.sidxEarliestPTS);
         }
+    }
 
-        RefreshCompTimes(initSegId, segIndex);
-
-        if ((!io.strIO->IsStreamGood()) && (!io.strIO->IsReachEOS()))
+    int32_t error = ERROR_NONE;
+    try
+    {
+        for (auto& moof : parsedSeg.moofs)
         {
-            ISO_LOG(LOG_ERROR, "Stream is Good? %d\n", int32_t(io.strIO->IsStreamGood()));
-            ISO_LOG(LOG_ERROR, "Reach to EOS? %d\n", int32_t(io.strIO->IsReachEOS()));
-            return OMAF_FILE_READ_ERROR;
+            if (!earliestPTSRead)
+            {
+                for (auto& basicTrackInfo : m_initSegProps.at(initSegId).basicTrackInfos)
+                {
+                    ContextId ctxId = basicTrackInfo.first;
+                    if (earliestPTSinTS != UINT64_MAX)
+                    {
+                        earliestPTSTS[ctxId] = PrestTS(earliestPTSinTS);
+                    }
+                    else if (const TrackDecInfo* precTrackDecInfo = GetPrevTrackDecInfo(
+                                 initSegId, SegmentTrackId(segIndex, ctxId)))
+                    {
+                        if (precTrackDecInfo)
+                        {
+                            earliestPTSTS[ctxId] = precTrackDecInfo->noSidxFallbackPTSTS;
+                        }
+                    }
+                    else
+                    {
+                        earliestPTSTS[ctxId] = 0;
+                    }
+                }
+
+                earliestPTSRead = true;
+            }
+
+            CtxIdPresentTSMap earliestPTSTSForTrack;
+            for (auto& trackFragmentAtom : moof->GetTrackFragmentAtoms())
+            {
+                auto ctxId = ContextId(trackFragmentAtom->GetTrackFragmentHeaderAtom().GetTrackId());
+                earliestPTSTSForTrack.insert(make_pair(ctxId, earliestPTSTS.at(ctxId)));
+            }
+
+            AddTrackProps(initSegId, segIndex, *moof, earliestPTSTSForTrack);
         }
-        io.strIO->ClearStatus();
-        m_readerSte = ReaderState::READY;
     }
-    else
+    catch (Exception& exc)
     {
-        DisableSeg(initSegId, segIndex);
+        ISO_LOG(LOG_ERROR, "parseSegment Exception Error: %s\n", exc.what());
+        error = OMAF_FILE_READ_ERROR;
     }
-    return error;
+    catch (exception& e)
+    {
+        ISO_LOG(LOG_ERROR, "parseSegment exception Error: %s\n", e.what());
+        error = OMAF_FILE_READ_ERROR;
+    }
+    parsedSeg.moofs.clear();
+
+    if (error)
+    {
+        DisableSeg(initSegId.GetIndex(), segIndex.GetIndex());
+        return error;
+    }
+
+    for (auto& trackDecInfo : segProps.trackDecInfos)
+    {
+        CfgSegSidxFallback(initSegId, make_pair(segIndex, trackDecInfo.first));
+    }
+
+    RefreshCompTimes(initSegId, segIndex);
+    BuildSampTables(initSegId, segIndex);
+    m_readerSte = ReaderState::READY;
+    return ERROR_NONE;
 }
 
 int32_t Mp4Reader::DisableSeg(uint32_t initSegId, uint32_t segIndex)
@@ -769,6 +945,7 @@ int32_t Mp4Reader::DisableSeg(uint32_t initSegId, uint32_t segIndex)
             {
                 seqToSeg.erase(sequence);
             }
+            DropSampTables(initSegId, segIndex);
             SegmentProperties& segProps = m_initSegProps.at(initSegId).segPropMap[segIndex];
             SegmentIO& io = segProps.io;
             io.strIO.reset(NULL);
@@ -798,6 +975,31 @@ int32_t Mp4Reader::GetSegIndex(uint32_t initSegId, VarLenArray<SegInfo>& segInde
     return ERROR_NONE;
 }
 
+int32_t Mp4Reader::GetSegSamples(uint32_t trackId, uint32_t segIndex, VarLenArray<SegSample>& samples) const
+{
+    if (IsInitErr())
+    {
+        return OMAF_MP4READER_NOT_INITIALIZED;
+    }
+
+    auto tablesIt = m_sampTables.find(trackId);
+    if (tablesIt == m_sampTables.end())
+    {
+        return OMAF_INVALID_SEGMENT;
+    }
+
+    for (auto& table : tablesIt->second)
+    {
+        if (table.second.segIndex == SegmentId(segIndex))
+        {
+            samples = VarLenArray<SegSample>(table.second.samples.size());
+            std::copy(table.second.samples.begin(), table.second.samples.end(), samples.arrayElets);
+            return ERROR_NONE;
+        }
+    }
+    return OMAF_INVALID_SEGMENT;
+}
+
 
 int32_t Mp4Reader::ParseSegIndex(StreamIO* strIO,
                                                VarLenArray<SegInfo>& segIndex)
@@ -1326,18 +1528,34 @@ int32_t Mp4Reader::ReadAtom(SegmentIO& io, Stream& bitstream)
         return error;
     }
 
-    std::vector<uint8_t> data((uint64_t) boxSize);
-    io.strIO->ReadStream(reinterpret_cast<char*>(data.data()), boxSize);
-    if (!io.strIO->IsStreamGood())
+    // the box is referenced in the downloaded data if it's in one block
+    std::vector<char> data;
+    const char* boxData = io.strIO->ReadStreamView(boxSize, data);
+    if (!boxData || !io.strIO->IsStreamGood())
     {
         return OMAF_FILE_READ_ERROR;
     }
     bitstream.Clear();
     bitstream.Reset();
-    bitstream.WriteArray(data, uint64_t(boxSize));
+    bitstream.WriteArray(reinterpret_cast<const uint8_t*>(boxData), uint64_t(boxSize));
     return ERROR_NONE;
 }
 
+void Mp4Reader::ReadSampData(SegmentIO& io, int64_t offset, char* buf, uint32_t len) const
+{
+    // copy from the downloaded data directly when the sample is in one block,
+    // this doesn't touch the stream offset
+    const char* sampData = io.strIO->GetDataView(offset, len);
+    if (sampData)
+    {
+        memcpy(buf, sampData, len);
+        return;
+    }
+
+    LocateToOffset(io, offset);
+    io.strIO->ReadStream(buf, len);
+}
+
 int32_t Mp4Reader::SkipAtom(SegmentIO& io)
 {
     const int64_t startLocation = io.strIO->TellOffset();
@@ -3657,12 +3875,63 @@ int32_t Mp4Reader::GetDepedentSampInfo(uint32_t trackId,
     return ERROR_NONE;
 }
 
-bool ParseExtractorNal(const DataVector& NalData,
+//!
+//! \brief  big endian reader of the extractor sample, the sample is parsed
+//!         in place from the data which isn't copied
+//!
+class NalDataReader
+{
+public:
+    NalDataReader(const uint8_t* data, uint64_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_offset(0)
+    {
+    }
+
+    uint64_t BytesRemain() const
+    {
+        return m_size - m_offset;
+    }
+
+    uint32_t ReadBytes(uint32_t num)
+    {
+        if (num > BytesRemain())
+        {
+            ISO_LOG(LOG_ERROR, "Extractor sample is truncated !\n");
+            throw exception();
+        }
+        uint32_t ret = 0;
+        for (uint32_t i = 0; i < num; i++)
+        {
+            ret = (ret << 8) | m_data[m_offset++];
+        }
+        return ret;
+    }
+
+    void SkipBytes(uint64_t num)
+    {
+        if (num > BytesRemain())
+        {
+            ISO_LOG(LOG_ERROR, "Extractor sample is truncated !\n");
+            throw exception();
+        }
+        m_offset += num;
+    }
+
+private:
+    const uint8_t* m_data;    //!< the extractor sample data
+    uint64_t m_size;          //!< the size of the sample
+    uint64_t m_offset;        //!< the read position
+};
+
+bool ParseExtractorNal(const uint8_t* NalData,
+                       uint64_t NalSize,
                        ExtSample& extSamp,
                        uint8_t lenSizeMinus1,
                        uint64_t& extSize)
 {
-    Stream nalus(NalData);
+    NalDataReader nalus(NalData, NalSize);
     ExtNalHdr extNalHdr;
     uint32_t extractors = 0;
     uint64_t inlineSizes = 0;
@@ -3671,17 +3940,9 @@ bool ParseExtractorNal(const DataVector& NalData,
     while (nalus.BytesRemain() > 0)
     {
         size_t readCnt = 0;
-        if (lenSizeMinus1 == 0)
-        {
-            readCnt = nalus.Read8();
-        }
-        else if (lenSizeMinus1 == 1)
+        if (lenSizeMinus1 == 0 || lenSizeMinus1 == 1 || lenSizeMinus1 == 3)
         {
-            readCnt = nalus.Read16();
-        }
-        else if (lenSizeMinus1 == 3)
-        {
-            readCnt = nalus.Read32();
+            readCnt = nalus.ReadBytes(lenSizeMinus1 + 1);
         }
         else
         {
@@ -3689,10 +3950,11 @@ bool ParseExtractorNal(const DataVector& NalData,
             throw exception();
         }
 
-        extNalHdr.forbidden_zero_bit    = (uint8_t) nalus.Read1(1);
-        extNalHdr.nal_unit_type         = (uint8_t) nalus.Read1(6);
-        extNalHdr.nuh_layer_id          = (uint8_t) nalus.Read1(6);
-        extNalHdr.nuh_temporal_id_plus1 = (uint8_t) nalus.Read1(3);
+        uint16_t nalHdr = (uint16_t) nalus.ReadBytes(2);
+        extNalHdr.forbidden_zero_bit    = (uint8_t) (nalHdr >> 15);
+        extNalHdr.nal_unit_type         = (uint8_t) ((nalHdr >> 9) & 0x3f);
+        extNalHdr.nuh_layer_id          = (uint8_t) ((nalHdr >> 3) & 0x3f);
+        extNalHdr.nuh_temporal_id_plus1 = (uint8_t) (nalHdr & 0x7);
 
         readCnt = readCnt - 2;
         if (extNalHdr.nal_unit_type == 49)
@@ -3700,21 +3962,21 @@ bool ParseExtractorNal(const DataVector& NalData,
             ExtSample::Extractor extractor;
             for (; readCnt > 0; readCnt--)
             {
-                uint8_t constType = (uint8_t) nalus.Read1(8);
+                uint8_t constType = (uint8_t) nalus.ReadBytes(1);
 
                 if (constType == 0)
                 {
                     ExtSample::SampleConstruct sampConst;
                     sampConst.order_idx        = (uint8_t) order_idx;
                     sampConst.constructor_type = (uint8_t) constType;
-                    sampConst.track_ref_index  = (uint8_t) nalus.Read1(8);
+                    sampConst.track_ref_index  = (uint8_t) nalus.ReadBytes(1);
                     readCnt--;
                     sampConst.track_ref_index = sampConst.track_ref_index - 1;
-                    sampConst.sample_offset   = (int8_t) nalus.Read1(8);
+                    sampConst.sample_offset   = (int8_t) nalus.ReadBytes(1);
                     readCnt--;
-                    sampConst.data_offset = nalus.Read1((lenSizeMinus1 + 1) * 8);
+                    sampConst.data_offset = nalus.ReadBytes(lenSizeMinus1 + 1);
                     readCnt -= (lenSizeMinus1 + 1);
-                    sampConst.data_length = nalus.Read1((lenSizeMinus1 + 1) * 8);
+                    sampConst.data_length = nalus.ReadBytes(lenSizeMinus1 + 1);
                     readCnt -= (lenSizeMinus1 + 1);
                     if (sampConst.data_length < UINT32_MAX)
                     {
@@ -3728,10 +3990,10 @@ bool ParseExtractorNal(const DataVector& NalData,
                     ExtSample::InlineConstruct inlinConst;
                     inlinConst.order_idx        = (uint8_t) order_idx;
                     inlinConst.constructor_type = (uint8_t) constType;
-                    inlinConst.data_length      = (uint8_t) nalus.Read1(8);
+                    inlinConst.data_length      = (uint8_t) nalus.ReadBytes(1);
                     for (uint8_t i = 0; i < inlinConst.data_length; i++)
                     {
-                        inlinConst.inline_data.push_back((uint8_t) nalus.Read1(8));
+                        inlinConst.inline_data.push_back((uint8_t) nalus.ReadBytes(1));
                     }
                     inlineSizes += inlinConst.data_length;
                     extractor.inlineConstruct.push_back(inlinConst);
@@ -3791,6 +4053,16 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
     {
         return error;
     }
+    FourCC codeType;
+    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
+    if (error)
+    {
+        return error;
+    }
+
+    // extractor samples are parsed in place when they are in one block, only
+    // the referred data is written to the buffer
+    const char* extSampView = nullptr;
     switch (ctxType)
     {
     case CtxType::TRACK:
@@ -3808,8 +4080,14 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
         }
 
         int64_t neededDataOffset = (int64_t) GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset;
-        LocateToOffset(io, neededDataOffset);
-        io.strIO->ReadStream(buf, sampLen);
+        if (codeType == "hvc2")
+        {
+            extSampView = io.strIO->GetDataView(neededDataOffset, sampLen);
+        }
+        if (!extSampView)
+        {
+            ReadSampData(io, neededDataOffset, buf, sampLen);
+        }
         bufSize = sampLen;
 
         if (!io.strIO->IsStreamGood())
@@ -3822,13 +4100,6 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
         return OMAF_INVALID_MP4READER_CONTEXTID;
     }
 
-    FourCC codeType;
-    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
-    if (error)
-    {
-        return error;
-    }
-
     if (codeType == "avc1" || codeType == "avc3")
     {
         if (strHrd)
@@ -3854,7 +4125,9 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
 
     else if (codeType == "hvc2")
     {
-        std::vector<uint8_t> extSampBuffer(buf, buf + bufSize);
+        // the extractors are parsed into extSamp, so the buffer can be
+        // overwritten by the extracted data afterwards
+        const uint8_t* extSampData = reinterpret_cast<const uint8_t*>(extSampView ? extSampView : buf);
 
         uint8_t nalLengthSizeMinus1 = 3;
         ItemId sampId;
@@ -3870,7 +4143,7 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
         uint64_t extSize = 0;
         uint64_t tolerance      = 0;
 
-        if (ParseExtractorNal(extSampBuffer, extSamp, nalLengthSizeMinus1, extSize))
+        if (ParseExtractorNal(extSampData, bufSize, extSamp, nalLengthSizeMinus1, extSize))
         {
             if (extSize == 0)
             {
@@ -3909,6 +4182,9 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
             uint64_t refSampLength = 0;
             uint64_t refSampOffset = 0;
             uint8_t trackRefIndex = UINT8_MAX;
+            // the referred NALs are copied from the downloaded data directly
+            // when they are in one block, so track the read offset here
+            int64_t refReadOffset = 0;
 
             for (auto& extractor : extSamp.extractors)
             {
@@ -3956,9 +4232,10 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
                                 return result;
                             }
                             trackRefIndex = (*sampConst).track_ref_index;
-                            LocateToOffset(ref_io, refSampOffset);
+                            refReadOffset = (int64_t) refSampOffset;
                         }
-                        ref_io.strIO->ReadStream(buffer, (nalLengthSizeMinus1 + 1));
+                        ReadSampData(ref_io, refReadOffset, buffer, (nalLengthSizeMinus1 + 1));
+                        refReadOffset += (nalLengthSizeMinus1 + 1);
                         uint64_t refNalLength = ParseNalLen(buffer);
 
                         uint64_t inputReadOffset = refSampOffset + (*sampConst).data_offset;
@@ -4009,9 +4286,10 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
                         }
                         if (inputReadOffset > 0)
                         {
-                            LocateToOffset(ref_io, (int64_t) inputReadOffset);
+                            refReadOffset = (int64_t) inputReadOffset;
                         }
-                        ref_io.strIO->ReadStream(buffer, bytesToCopy);
+                        ReadSampData(ref_io, refReadOffset, buffer, (uint32_t) bytesToCopy);
+                        refReadOffset += (int64_t) bytesToCopy;
                         buffer += bytesToCopy;
                         extractedBytes += (uint32_t)bytesToCopy;
                         ++sampConst;
@@ -4057,13 +4335,25 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
     InitSegmentId initSegId       = trackIdPair.first;
     SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
-    if (result != ERROR_NONE)
+    ItemId itemId;
+    int32_t result = ERROR_NONE;
+    uint32_t index = 0;
+    const SegSampTable* sampTable = FindSampTable(trackId, itemIndex, index);
+    if (sampTable)
     {
-        return result;
+        segIndex = sampTable->segIndex;
+        itemId   = ItemId(index);
+    }
+    else
+    {
+        result = GetSegIndex(trackIdPair, itemIndex, segIndex);
+        if (result != ERROR_NONE)
+        {
+            return result;
+        }
+        itemId = ItemId(itemIndex) - GetTrackDecInfo(initSegId, make_pair(segIndex, trackIdPair.second)).itemIdBase;
     }
     SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
-    ItemId itemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, segTrackId).itemIdBase;
 
     SegmentIO& io = m_initSegProps.at(initSegId).segPropMap.at(segIndex).io;
     CtxType ctxType;
@@ -4072,24 +4362,51 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     {
         return error;
     }
+    FourCC codeType;
+    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
+    if (error)
+    {
+        return error;
+    }
+
+    // extractor samples are parsed in place when they are in one block, only
+    // the referred data is written to the buffer
+    const char* extSampView = nullptr;
     switch (ctxType)
     {
     case CtxType::TRACK:
     {
-        if (itemId.GetIndex() >= GetTrackDecInfo(initSegId, segTrackId).samples.size())
+        uint32_t sampLen    = 0;
+        uint64_t sampOffset = 0;
+        if (sampTable)
         {
-            return OMAF_INVALID_ITEM_ID;
+            sampLen    = sampTable->samples[index].dataLength;
+            sampOffset = sampTable->samples[index].dataOffset;
+        }
+        else
+        {
+            if (itemId.GetIndex() >= GetTrackDecInfo(initSegId, segTrackId).samples.size())
+            {
+                return OMAF_INVALID_ITEM_ID;
+            }
+            sampLen    = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
+            sampOffset = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset;
         }
 
-        const uint32_t sampLen = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
         if (bufSize < sampLen)
         {
             bufSize = sampLen;
             return OMAF_MEMORY_TOO_SMALL_BUFFER;
         }
 
-        LocateToOffset(io, (int64_t) GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset);
-        io.strIO->ReadStream(buf, sampLen);
+        if (codeType == "hvc2")
+        {
+            extSampView = io.strIO->GetDataView((int64_t) sampOffset, sampLen);
+        }
+        if (!extSampView)
+        {
+            ReadSampData(io, (int64_t) sampOffset, buf, sampLen);
+        }
         bufSize = sampLen;
 
         if (!io.strIO->IsStreamGood())
@@ -4102,13 +4419,6 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
         return OMAF_INVALID_MP4READER_CONTEXTID;
     }
 
-    FourCC codeType;
-    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
-    if (error)
-    {
-        return error;
-    }
-
     if (codeType == "avc1" || codeType == "avc3")
     {
         if (strHrd)
@@ -4133,7 +4443,9 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     }
     else if (codeType == "hvc2")
     {
-        std::vector<uint8_t> extSampBuffer(buf, buf + bufSize);
+        // the extractors are parsed into extSamp, so the buffer can be
+        // overwritten by the extracted data afterwards
+        const uint8_t* extSampData = reinterpret_cast<const uint8_t*>(extSampView ? extSampView : buf);
 
         uint8_t nalLengthSizeMinus1 = 3;
         ItemId sampId;
@@ -4149,7 +4461,7 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
         uint64_t extSize = 0;
         uint64_t tolerance      = 0;
 
-        if (ParseExtractorNal(extSampBuffer, extSamp, nalLengthSizeMinus1, extSize))
+        if (ParseExtractorNal(extSampData, bufSize, extSamp, nalLengthSizeMinus1, extSize))
         {
             if (extSize == 0)
             {
@@ -4188,6 +4500,9 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
             uint64_t refSampLength = 0;
             uint64_t refSampOffset = 0;
             uint8_t trackRefIndex = UINT8_MAX;
+            // the referred NALs are copied from the downloaded data directly
+            // when they are in one block, so track the read offset here
+            int64_t refReadOffset = 0;
 
             for (auto& extractor : extSamp.extractors)
             {
@@ -4219,9 +4534,10 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
                                 return result;
                             }
                             trackRefIndex = (*sampConst).track_ref_index;
-                            LocateToOffset(io, refSampOffset);
+                            refReadOffset = (int64_t) refSampOffset;
                         }
-                        io.strIO->ReadStream(buffer, (nalLengthSizeMinus1 + 1));
+                        ReadSampData(io, refReadOffset, buffer, (nalLengthSizeMinus1 + 1));
+                        refReadOffset += (nalLengthSizeMinus1 + 1);
                         uint64_t refNalLength = ParseNalLen(buffer);
 
                         uint64_t inputReadOffset = refSampOffset + (*sampConst).data_offset;
@@ -4272,9 +4588,10 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
                         }
                         if (inputReadOffset > 0)
                         {
-                            LocateToOffset(io, (int64_t) inputReadOffset);
+                            refReadOffset = (int64_t) inputReadOffset;
                         }
-                        io.strIO->ReadStream(buffer, bytesToCopy);
+                        ReadSampData(io, refReadOffset, buffer, (uint32_t) bytesToCopy);
+                        refReadOffset += (int64_t) bytesToCopy;
                         buffer += bytesToCopy;
                         extractedBytes += (uint32_t)bytesToCopy;
                         ++sampConst;
@@ -4315,6 +4632,15 @@ int32_t Mp4Reader::GetSampOffset(uint32_t trackId,
         return OMAF_MP4READER_NOT_INITIALIZED;
     }
 
+    uint32_t index = 0;
+    const SegSampTable* sampTable = FindSampTable(trackId, itemIndex, index);
+    if (sampTable)
+    {
+        sampLen    = sampTable->samples[index].dataLength;
+        sampOffset = sampTable->samples[index].dataOffset;
+        return ERROR_NONE;
+    }
+
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
     InitSegmentId initSegId       = trackIdPair.first;
     SegmentId segIndex;
@@ -4472,10 +4798,19 @@ int32_t Mp4Reader::GetSampTStamps(
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
     InitSegmentId initSegId       = trackIdPair.first;
     SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
-    if (result != ERROR_NONE)
+    uint32_t index = 0;
+    const SegSampTable* sampTable = FindSampTable(trackId, itemIndex, index);
+    if (sampTable)
     {
-        return result;
+        segIndex = sampTable->segIndex;
+    }
+    else
+    {
+        int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
+        if (result != ERROR_NONE)
+        {
+            return result;
+        }
     }
     ItemId itemId = ItemId(itemIndex) -
                     GetTrackDecInfo(initSegId, SegmentTrackId(segIndex, trackIdPair.second)).itemIdBase;
@@ -4616,14 +4951,30 @@ int32_t Mp4Reader::GetDecoderCodeType(uint32_t trackId, uint32_t itemId, FourCC&
         return OMAF_MP4READER_NOT_INITIALIZED;
     }
 
+    uint32_t index = 0;
+    const SegSampTable* sampTable = FindSampTable(trackId, itemId, index);
+    if (sampTable)
+    {
+        decoderCodeType = sampTable->codeTypes[index];
+        return ERROR_NONE;
+    }
+
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
-    InitSegmentId initSegId       = trackIdPair.first;
     SegmentId segIndex;
     int32_t result = GetSegIndex(trackIdPair, itemId, segIndex);
     if (result != ERROR_NONE)
     {
         return result;
     }
+    return GetDecCodeTypeInSeg(trackIdPair, segIndex, itemId, decoderCodeType);
+}
+
+int32_t Mp4Reader::GetDecCodeTypeInSeg(InitSegmentTrackId trackIdPair,
+                                       SegmentId segIndex,
+                                       uint32_t itemId,
+                                       FourCC& decoderCodeType) const
+{
+    InitSegmentId initSegId   = trackIdPair.first;
     SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
     const auto segPropsIt =
         m_initSegProps.at(initSegId).segPropMap.find(segIndex);
@@ -4673,6 +5024,16 @@ int32_t Mp4Reader::GetDurOfSamp(uint32_t trackId, uint32_t sampleId, uint32_t& s
 
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
     InitSegmentId initSegId       = trackIdPair.first;
+
+    uint32_t index = 0;
+    const SegSampTable* sampTable = FindSampTable(trackId, sampleId, index);
+    if (sampTable)
+    {
+        sampDur = (uint32_t)(uint64_t(sampTable->samples[index].durationTS) * 1000) /
+                  GetTrackBasicInfo(trackIdPair).timeScale;
+        return ERROR_NONE;
+    }
+
     SegmentId segIndex;
     int32_t result = GetSegIndex(trackIdPair, sampleId, segIndex);
     if (result != ERROR_NONE)
@@ -52,6 +52,7 @@
 #include <functional>
 #include <istream>
 #include <memory>
+#include <unordered_map>
 
 using namespace std;
 
@@ -61,6 +62,23 @@ class CleanAperture;
 class AvcDecoderConfigurationRecord;
 class HevcDecoderConfigurationRecord;
 
+//!
+//! \struct ParsedSegment
+//! \brief  Boxes of one segment read by Mp4Reader::ReadSeg, which are
+//!         added to the reader tables by Mp4Reader::AddParsedSeg
+//!
+struct ParsedSegment
+{
+    InitSegmentId initSegmentId;
+    SegmentId segmentId;
+    SegmentIO io;
+    SegmentTypeAtom styp;
+    ProducerReferenceTimeAtom prft;
+    bool sidxFound = false;             //!< whether sidx comes before the first moof
+    uint64_t sidxEarliestPTS = 0;
+    std::vector<UniquePtr<MovieFragmentAtom>> moofs;
+};
+
 //!
 //! \class Mp4Reader
 //! \brief Define the operation and needed data for mp4 segment files reading
@@ -764,6 +782,46 @@ public:
                          uint32_t segIndex,
                          uint64_t earliestPTSinTS = UINT64_MAX);
 
+    //!
+    //! \brief  Read and decode the boxes of specified segment, the
+    //!         reader tables are only looked up, so that different
+    //!         segments can be read in parallel. ParseSeg equals to
+    //!         ReadSeg followed by AddParsedSeg
+    //!
+    //! \param  [in]  strIO
+    //!         pointer to specified segment handler
+    //! \param  [in]  initSegId
+    //!         index of specified initial segment
+    //! \param  [in]  segIndex
+    //!         index of specified segment
+    //! \param  [out] parsedSeg
+    //!         the boxes read from the segment, segment io is
+    //!         empty if the segment has been parsed
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t ReadSeg(StreamIO* strIO,
+                        uint32_t initSegId,
+                        uint32_t segIndex,
+                        ParsedSegment& parsedSeg);
+
+    //!
+    //! \brief  Add the boxes read by ReadSeg to the reader tables
+    //!
+    //! \param  [in]  parsedSeg
+    //!         the boxes read from the segment, segment io is
+    //!         moved into the reader
+    //! \param  [in]  earliestPTSinTS
+    //!         the earliest presentation time in timescale for
+    //!         the specified sample
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t AddParsedSeg(ParsedSegment& parsedSeg,
+                         uint64_t earliestPTSinTS = UINT64_MAX);
+
     //!
     //! \brief  Disable specified segment for specified track
     //!         Disable the data buffer pointer to the specified
@@ -799,6 +857,26 @@ public:
     int32_t GetSegIndex(uint32_t initSegId,
                             VarLenArray<SegInfo>& segIndex);
 
+    //!
+    //! \brief  Get information of all samples of specified
+    //!         track in specified segment in one call, the
+    //!         sample table is built once the segment is parsed
+    //!
+    //! \param  [in]  trackId
+    //!         index of specific track
+    //! \param  [in]  segIndex
+    //!         index of specified segment
+    //! \param  [out] samples
+    //!         array of flattened sample information in
+    //!         decoding order
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetSegSamples(uint32_t trackId,
+                            uint32_t segIndex,
+                            VarLenArray<SegSample>& samples) const;
+
     //!
     //! \brief  Parse segment index information for specified
     //!         stream
@@ -922,6 +1000,30 @@ private:
     };
     std::map<InitSegmentTrackId, CtxInfo> m_ctxInfoMap;
 
+    //! flattened sample table of one track in one segment
+    struct SegSampTable
+    {
+        SegmentId segIndex;
+        std::vector<SegSample> samples;
+        std::vector<FourCC> codeTypes;
+    };
+    //! sample tables of one track, keyed by item id base of segment
+    typedef std::map<uint32_t, SegSampTable> SegSampTableMap;
+    //! sample tables keyed by track id, so that per sample queries
+    //! don't need to walk all segments of the track
+    std::unordered_map<uint32_t, SegSampTableMap> m_sampTables;
+
+    void BuildSampTables(InitSegmentId initSegId, SegmentId segIndex);
+
+    void DropSampTables(InitSegmentId initSegId, SegmentId segIndex);
+
+    const SegSampTable* FindSampTable(uint32_t trackId, uint32_t itemIndex, uint32_t& index) const;
+
+    int32_t GetDecCodeTypeInSeg(InitSegmentTrackId trackIdPair,
+                                SegmentId segIndex,
+                                uint32_t itemId,
+                                FourCC& decoderCodeType) const;
+
     friend class DashSegGroup;
     friend class ConstDashSegGroup;
 
@@ -942,6 +1044,7 @@ private:
 
     int32_t ReadAtomParams(SegmentIO& io, std::string& boxType, int64_t& boxSize);
     int32_t ReadAtom(SegmentIO& io, Stream& bitstream);
+    void ReadSampData(SegmentIO& io, int64_t offset, char* buf, uint32_t len) const;
     int32_t SkipAtom(SegmentIO& io);
 
     int GetImgDims(uint32_t trackId, uint32_t itemId, uint32_t& width, uint32_t& height) const;
@@ -74,6 +74,26 @@ void StreamIOInternal::ReadStream(char* buffer, StreamIO::offset_t size_)
     }
 }
 
+const char* StreamIOInternal::ReadStreamView(StreamIO::offset_t size_, std::vector<char>& buffer)
+{
+    StreamIO::offset_t offset = m_stream->TellOffset();
+    const char* view = m_stream->GetDataView(offset, size_);
+    if (view)
+    {
+        SeekOffset(offset + size_);
+        return view;
+    }
+
+    buffer.resize(size_);
+    ReadStream(buffer.data(), size_);
+    return IsStreamGood() ? buffer.data() : nullptr;
+}
+
+const char* StreamIOInternal::GetDataView(StreamIO::offset_t offset, StreamIO::offset_t size_)
+{
+    return m_stream->GetDataView(offset, size_);
+}
+
 int StreamIOInternal::GetOneByte()
 {
     char ch;
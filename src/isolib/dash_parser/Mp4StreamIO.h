@@ -34,6 +34,7 @@
 #define _MP4STREAMIO_H_
 
 #include <stdint.h>
+#include <vector>
 #include "../include/Common.h"
 #include "../atoms/FormAllocator.h"
 
@@ -58,6 +59,17 @@ public:
     virtual offset_t TellOffset() = 0;
 
     virtual offset_t GetStreamSize() = 0;
+
+    //!
+    //! \brief    Get the data in [offset, offset + size) in place, without
+    //!           moving the stream offset
+    //!
+    //! \return   const char*
+    //!           the data pointer, valid until the stream is changed, or
+    //!           nullptr if the data is not contiguous in memory, then it
+    //!           should be copied out by ReadStream
+    //!
+    virtual const char* GetDataView(offset_t offset, offset_t size) { (void)offset; (void)size; return nullptr; };
 };
 
 class StreamIOInternal
@@ -71,6 +83,17 @@ public:
 
     void ReadStream(char* buffer, StreamIO::offset_t size);
 
+    //!
+    //! \brief    Read size bytes from current offset, the data is referenced
+    //!           in place if possible, or copied into buffer
+    //!
+    //! \return   const char*
+    //!           the data pointer, or nullptr if failed
+    //!
+    const char* ReadStreamView(StreamIO::offset_t size, std::vector<char>& buffer);
+
+    const char* GetDataView(StreamIO::offset_t offset, StreamIO::offset_t size);
+
     int GetOneByte();
 
 
@@ -57,6 +57,7 @@
 #define SAFE_DELETE(x) if(NULL != (x)) { delete (x); (x)=NULL; };
 #define SAFE_FREE(x)   if(NULL != (x)) { free((x));    (x)=NULL; };
 #define SAFE_DELETE_ARRAY(x) if(NULL != (x)) { delete [] (x); (x)=NULL; };
+#define SAFE_RELEASE_PACKET_BUF(x) if(NULL != (x).buf) { if((x).release) (x).release((x).opaque, (uint8_t*)(x).buf); else free((x).buf); (x).buf=NULL; };
 
 static uint64_t GetNtpTimeStamp() {
 	struct timeval currT;
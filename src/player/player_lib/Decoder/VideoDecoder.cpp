@@ -40,6 +40,8 @@
 #define DECODE_THREAD_COUNT 16
 #define MIN_REMAIN_SIZE_IN_FRAME 2
 
+static_assert(DASH_PACKET_PADDING_SIZE >= AV_INPUT_BUFFER_PADDING_SIZE, "packet padding is smaller than FFmpeg requires");
+
 VCD_NS_BEGIN
 
 VideoDecoder::VideoDecoder()
@@ -137,6 +139,7 @@ void VideoDecoder::CloseDecoder()
 {
     if( (m_status == STATUS_STOPPED) || (m_status == STATUS_IDLE) || m_status == STATUS_PENDING){
         m_status = STATUS_STOPPED;
+        mDecCtx->wake_up();
         LOG(INFO)<<" decoder is closed! video id is " << mVideoId<<endl;
         this->Join();
     }
@@ -191,14 +194,33 @@ RenderStatus VideoDecoder::SendPacket(DashPacket* packet)
     if (NULL != packet->buf && packet->size)
     {
         int size = packet->size;
-        if (av_new_packet(mPkt, size) < 0)
+        if (packet->release)
         {
-            SAFE_DELETE(mPktInfo);
-            av_packet_free(&mPkt);
-            SAFE_DELETE(mRwpk);
-            return RENDER_ERROR;
+            // refer to the packet buffer directly, it is released when the AVPacket is unreferenced
+            mPkt->buf = av_buffer_create((uint8_t*)packet->buf, size + DASH_PACKET_PADDING_SIZE, packet->release, packet->opaque, 0);
+            if (NULL == mPkt->buf)
+            {
+                SAFE_DELETE(mPktInfo);
+                av_packet_free(&mPkt);
+                SAFE_DELETE(mRwpk);
+                return RENDER_ERROR;
+            }
+            mPkt->data = mPkt->buf->data;
+            packet->buf = NULL;
+            packet->release = NULL;
+            packet->opaque = NULL;
+        }
+        else
+        {
+            if (av_new_packet(mPkt, size) < 0)
+            {
+                SAFE_DELETE(mPktInfo);
+                av_packet_free(&mPkt);
+                SAFE_DELETE(mRwpk);
+                return RENDER_ERROR;
+            }
+            memcpy_s(mPkt->data, size, packet->buf, size);
         }
-        memcpy_s(mPkt->data, size, packet->buf, size);
         mPkt->size = size;
         if (packet->rwpk != nullptr) {
             *mRwpk = *(packet->rwpk);
@@ -453,8 +475,7 @@ void VideoDecoder::Run()
                 continue;
             }
         }
-        if(0 == mDecCtx->get_size_of_packet()){
-            usleep(1000);
+        if(!mDecCtx->wait_packet()){
             continue;
         }
         PacketInfo* pkt_info = mDecCtx->pop_packet();
@@ -545,6 +566,7 @@ RenderStatus VideoDecoder::GetFrame(uint64_t pts, DecodedFrame *&frame, int64_t
     if( !waitFlag && (mDecCtx->get_size_of_frame() == 0) && (m_status==STATUS_PENDING) ){
         LOG(INFO)<<"frame fifo is empty now! video id is : " << mVideoId<<endl;
         m_status = STATUS_IDLE;
+        mDecCtx->wake_up();
         LOG(INFO)<<"decoder status is set to idle!"<<endl;
     }
 
@@ -579,6 +601,7 @@ void VideoDecoder::Pending()
     mDecCtx->bPacketEOS = true;
     LOG(INFO) << "Set decoder status to PENDING!" << endl;
     m_status = STATUS_PENDING;
+    mDecCtx->wake_up();
 }
 
 RenderStatus VideoDecoder::UpdateFrame(uint64_t pts, int64_t *corr_pts, HeadPose *pose)
@@ -37,7 +37,9 @@
 
 #include "MediaDecoder.h"
 #include "../../../utils/Threadable.h"
+#include <condition_variable>
 #include <list>
+#include <mutex>
 
 VCD_NS_BEGIN
 
@@ -98,6 +100,7 @@ public:
          listPacket.clear();
          listFrameData.clear();
          bPacketEOS     = false;
+         bWakeUp        = false;
      };
      ~DecoderContext(){
           while(get_size_of_frame()>0){
@@ -137,8 +140,38 @@ public:
 
      void push_packet(PacketInfo* pktInfo)
      {
-          ScopeLock lock(PacketLock);
-          listPacket.push_back(pktInfo);
+          {
+               ScopeLock lock(PacketLock);
+               listPacket.push_back(pktInfo);
+          }
+          PacketCond.notify_one();
+     };
+
+     //!
+     //! \brief  wake up the thread blocked in wait_packet, e.g. when the
+     //!         decoder status changes
+     //!
+     void wake_up()
+     {
+          {
+               ScopeLock lock(PacketLock);
+               bWakeUp = true;
+          }
+          PacketCond.notify_all();
+     };
+
+     //!
+     //! \brief  wait until a packet is pushed or wake_up is called
+     //!
+     //! \return bool
+     //!         true if there are packets in the list
+     //!
+     bool wait_packet()
+     {
+          std::unique_lock<ThreadLock> lock(PacketLock);
+          PacketCond.wait(lock, [this] { return !listPacket.empty() || bWakeUp; });
+          bWakeUp = false;
+          return !listPacket.empty();
      };
 
      void push_framedata(FrameData* data)
@@ -255,8 +288,10 @@ public:
 
      ThreadLock                    FrameLock;
      ThreadLock                    PacketLock;
+     std::condition_variable_any   PacketCond;
      ThreadLock                    DataLock;
      bool                          bPacketEOS;
+     bool                          bWakeUp;
 };
 
 
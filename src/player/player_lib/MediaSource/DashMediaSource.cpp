@@ -141,6 +141,7 @@ RenderStatus DashMediaSource::Initialize(struct RenderConfig renderConfig, Rende
   pCtxDashStreaming->omaf_params.max_response_times_in_seg = renderConfig.maxResponseTimesInOneSeg;
   pCtxDashStreaming->omaf_params.max_catchup_width = renderConfig.maxCatchupWidth;
   pCtxDashStreaming->omaf_params.max_catchup_height = renderConfig.maxCatchupHeight;
+  pCtxDashStreaming->omaf_params.enable_packet_release = true;  // packet buffers are referred by the decoders
   m_maxVideoWidth = renderConfig.maxVideoDecodeWidth;
   m_maxVideoHeight = renderConfig.maxVideoDecodeHeight;
   PluginDef def;
@@ -444,7 +445,7 @@ void DashMediaSource::ProcessVideoPacket() {
   }
 #endif
   for (int i = 0; i < dashPktNum; i++) {
-    SAFE_FREE(dashPkt[i].buf);
+    SAFE_RELEASE_PACKET_BUF(dashPkt[i]);
     if (dashPkt[i].rwpk) SAFE_DELETE_ARRAY(dashPkt[i].rwpk->rectRegionPacking);
     SAFE_DELETE(dashPkt[i].rwpk);
     SAFE_DELETE(dashPkt[i].prft);
@@ -470,7 +471,7 @@ void DashMediaSource::ProcessAudioPacket() {
   }
   // delete audio data
   for (int i = 0; i < dashPktNum; i++) {
-    SAFE_FREE(dashPkt[i].buf);
+    SAFE_RELEASE_PACKET_BUF(dashPkt[i]);
     if (dashPkt[i].rwpk) SAFE_DELETE_ARRAY(dashPkt[i].rwpk->rectRegionPacking);
     SAFE_DELETE(dashPkt[i].rwpk);
     SAFE_DELETE_ARRAY(dashPkt[i].qtyResolution);
@@ -549,6 +549,8 @@ bool WebRTCMediaSource::OnVideoPacket(
 
   dashPkt.buf = buf;
   dashPkt.size = bitstream_buf->size();
+  dashPkt.release = NULL;  // freed with free()
+  dashPkt.opaque = NULL;
   dashPkt.pts = m_frame_count++; // TODO: consider how to use the frame->time_stamp propertly in future.
   dashPkt.rwpk = rwpk;
   dashPkt.bEOS = false;
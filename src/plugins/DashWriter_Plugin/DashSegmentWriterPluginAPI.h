@@ -86,7 +86,7 @@ public:
 
     virtual void SetWriteSegmentHeader(bool toWriteHdr) = 0;
 
-    virtual void WriteSegments(std::ostringstream &frameString,
+    virtual void WriteSegments(std::ostream &frameString,
         uint64_t *segNum, char segName[1024], char *baseName, uint64_t *segSize) = 0;
 
 protected:
@@ -40,6 +40,14 @@
 #include "error.h"
 #include "VideoStreamPluginAPI.h"
 
+//! dynamic field in MPD template is marked by its placeholder
+#define FIELD_PLACEHOLDER_PREFIX "@OMAF_MPD_FIELD_"
+
+static std::string GetFieldPlaceholder(MPDDynamicField field)
+{
+    return std::string(FIELD_PLACEHOLDER_PREFIX) + std::to_string((int32_t)field) + "@";
+}
+
 MPDWriter::MPDWriter()
 {
     m_streamASCtx = NULL;
@@ -58,6 +66,7 @@ MPDWriter::MPDWriter()
     m_vsNum = 0;
     m_cmafEnabled = false;
     m_currSegNum = 0;
+    m_mpdSize = 0;
 }
 
 MPDWriter::MPDWriter(
@@ -84,6 +93,7 @@ MPDWriter::MPDWriter(
     m_vsNum = videoNum;
     m_cmafEnabled = cmafEnabled;
     m_currSegNum = 0;
+    m_mpdSize = 0;
 }
 
 MPDWriter::MPDWriter(const MPDWriter& src)
@@ -104,6 +114,12 @@ MPDWriter::MPDWriter(const MPDWriter& src)
     m_vsNum         = src.m_vsNum;
     m_cmafEnabled   = src.m_cmafEnabled;
     m_currSegNum    = src.m_currSegNum;
+    m_mpdTemplate   = src.m_mpdTemplate;
+    for (uint32_t i = 0; i < MPD_FIELD_NUM; i++)
+    {
+        m_fieldValues[i] = src.m_fieldValues[i];
+    }
+    m_mpdSize       = src.m_mpdSize;
 }
 
 MPDWriter& MPDWriter::operator=(MPDWriter&& other)
@@ -124,6 +140,12 @@ MPDWriter& MPDWriter::operator=(MPDWriter&& other)
     m_vsNum         = other.m_vsNum;
     m_cmafEnabled   = other.m_cmafEnabled;
     m_currSegNum    = other.m_currSegNum;
+    m_mpdTemplate   = std::move(other.m_mpdTemplate);
+    for (uint32_t i = 0; i < MPD_FIELD_NUM; i++)
+    {
+        m_fieldValues[i] = std::move(other.m_fieldValues[i]);
+    }
+    m_mpdSize       = other.m_mpdSize;
 
     return *this;
 }
@@ -239,28 +261,7 @@ int32_t MPDWriter::WriteTileTrackAS(XMLElement *periodEle, VCD::MP4::MPDAdaptati
         prftEle->SetAttribute(INDEX, "0");
         prftEle->SetAttribute(INBAND, "true");
         prftEle->SetAttribute(TIMETYPE, "encoder");
-
-        uint32_t sec;
-        time_t gTime;
-        struct tm *t;
-        struct timeval now;
-        struct timeb timeBuffer;
-        ftime(&timeBuffer);
-        now.tv_sec = (long)(timeBuffer.time);
-        now.tv_usec = timeBuffer.millitm * 1000;
-        sec = (uint32_t)(now.tv_sec) + NTP_SEC_1900_TO_1970;
-
-        gTime = sec - NTP_SEC_1900_TO_1970;
-        t = gmtime(&gTime);
-        if (!t)
-            return OMAF_ERROR_INVALID_TIME;
-
-        char currTime[1024];
-        memset_s(currTime, 1024, 0);
-        snprintf(currTime, 1024, "%d-%d-%dT%d:%d:%dZ", 1900 + t->tm_year,
-                t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-
-        prftEle->SetAttribute(WALLCLOCKTIME, currTime);
+        prftEle->SetAttribute(WALLCLOCKTIME, GetFieldPlaceholder(MPD_FIELD_WALLCLOCKTIME).c_str());
         prftEle->SetAttribute(PRESENTATIONTIME, "0");
         asEle->InsertEndChild(prftEle);
 
@@ -308,9 +309,7 @@ int32_t MPDWriter::WriteTileTrackAS(XMLElement *periodEle, VCD::MP4::MPDAdaptati
     }
     else
     {
-        int32_t currSegNum = (int32_t)m_currSegNum;//(int32_t)(trackASCtx->dashSegmenter->GetSegmentsNum());
-        //OMAF_LOG(LOG_INFO, "Write start number %d to MPD \n", currSegNum);
-        sgtTpeEle->SetAttribute(STARTNUMBER, currSegNum);
+        sgtTpeEle->SetAttribute(STARTNUMBER, GetFieldPlaceholder(MPD_FIELD_STARTNUMBER).c_str());
     }
 
     sgtTpeEle->SetAttribute(TIMESCALE, m_timeScale);
@@ -362,28 +361,7 @@ int32_t MPDWriter::WriteExtractorTrackAS(XMLElement *periodEle, VCD::MP4::MPDAda
         prftEle->SetAttribute(INDEX, "0");
         prftEle->SetAttribute(INBAND, "true");
         prftEle->SetAttribute(TIMETYPE, "encoder");
-
-        uint32_t sec;
-        time_t gTime;
-        struct tm *t;
-        struct timeval now;
-        struct timeb timeBuffer;
-        ftime(&timeBuffer);
-        now.tv_sec = (long)(timeBuffer.time);
-        now.tv_usec = timeBuffer.millitm * 1000;
-        sec = (uint32_t)(now.tv_sec) + NTP_SEC_1900_TO_1970;
-
-        gTime = sec - NTP_SEC_1900_TO_1970;
-        t = gmtime(&gTime);
-        if (!t)
-            return OMAF_ERROR_INVALID_TIME;
-
-        char currTime[1024];
-        memset_s(currTime, 1024, 0);
-        snprintf(currTime, 1024, "%d-%d-%dT%d:%d:%dZ", 1900 + t->tm_year,
-                t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-
-        prftEle->SetAttribute(WALLCLOCKTIME, currTime);
+        prftEle->SetAttribute(WALLCLOCKTIME, GetFieldPlaceholder(MPD_FIELD_WALLCLOCKTIME).c_str());
         prftEle->SetAttribute(PRESENTATIONTIME, "0");
         asEle->InsertEndChild(prftEle);
 
@@ -478,7 +456,7 @@ int32_t MPDWriter::WriteExtractorTrackAS(XMLElement *periodEle, VCD::MP4::MPDAda
     }
     else
     {
-        sgtTpeEle->SetAttribute(STARTNUMBER, (int32_t)m_currSegNum);
+        sgtTpeEle->SetAttribute(STARTNUMBER, GetFieldPlaceholder(MPD_FIELD_STARTNUMBER).c_str());
     }
     sgtTpeEle->SetAttribute(TIMESCALE, m_timeScale);
 
@@ -540,7 +518,7 @@ int32_t MPDWriter::WriteAudioTrackAS(XMLElement *periodEle, VCD::MP4::MPDAdaptat
     return ERROR_NONE;
 }
 
-int32_t MPDWriter::WriteMpd(uint64_t totalFramesNum)
+int32_t MPDWriter::GenerateMpdTemplate()
 {
     const char *declaration = "xml version=\"1.0\" encoding=\"UTF-8\"";
     XMLDeclaration *xmlDec = m_xmlDoc->NewDeclaration();
@@ -577,86 +555,17 @@ int32_t MPDWriter::WriteMpd(uint64_t totalFramesNum)
 
     if (m_segInfo->isLive)
     {
-        uint32_t sec;
-        time_t gTime;
-        struct tm *t;
-        struct timeval now;
-        struct timeb timeBuffer;
-        ftime(&timeBuffer);
-        now.tv_sec = (long)(timeBuffer.time);
-        now.tv_usec = timeBuffer.millitm * 1000;
-        sec = (uint32_t)(now.tv_sec) + NTP_SEC_1900_TO_1970;
-
-        gTime = sec - NTP_SEC_1900_TO_1970;
-        t = gmtime(&gTime);
-        if (!t)
-            return OMAF_ERROR_INVALID_TIME;
-
-        char forCmp[1024];
-        memset_s(forCmp, 1024, 0);
-        int32_t cmpRet = 0;
-        memcmp_s(m_availableStartTime, 1024, forCmp, 1024, &cmpRet);
-        if (0 == cmpRet)
-        {
-            snprintf(m_availableStartTime, 1024, "%d-%d-%dT%d:%d:%dZ", 1900 + t->tm_year,
-                t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-        }
-
-        if ((0 != cmpRet) && m_cmafEnabled)
-        {
-            memset_s(m_availableStartTime, 1024, 0);
-            snprintf(m_availableStartTime, 1024, "%d-%d-%dT%d:%d:%dZ", 1900 + t->tm_year,
-                t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-        }
-
-        if (!m_publishTime)
-        {
-            m_publishTime = new char[1024];
-            if (!m_publishTime)
-                return OMAF_ERROR_NULL_PTR;
-        }
-        memset_s(m_publishTime, 1024, 0);
-        snprintf(m_publishTime, 1024, "%d-%02d-%02dT%02d:%02d:%02dZ", 1900+t->tm_year, t->tm_mon+1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-
-        mpdEle->SetAttribute(AVAILABILITYSTARTTIME, m_availableStartTime);
+        mpdEle->SetAttribute(AVAILABILITYSTARTTIME, GetFieldPlaceholder(MPD_FIELD_AVAILABILITYSTARTTIME).c_str());
         mpdEle->SetAttribute(TIMESHIFTBUFFERDEPTH, "PT5M");
 
         memset_s(string, 1024, 0);
         snprintf(string, 1024, "PT%dS", m_miniUpdatePeriod);
         mpdEle->SetAttribute(MINIMUMUPDATEPERIOD, string);
-        mpdEle->SetAttribute(PUBLISHTIME, m_publishTime);
+        mpdEle->SetAttribute(PUBLISHTIME, GetFieldPlaceholder(MPD_FIELD_PUBLISHTIME).c_str());
     }
     else
     {
-        uint32_t fps1000 = (uint32_t) ((double)m_frameRate.num / m_frameRate.den * 1000);
-        uint32_t correctedfps = 0;
-        if (fps1000 == 29970)
-            correctedfps = 30000;
-        else if (fps1000 == 23976)
-            correctedfps = 24000;
-        else if (fps1000 == 59940)
-            correctedfps = 60000;
-        else
-            correctedfps = fps1000;
-        uint32_t totalDur = (uint32_t)((double)totalFramesNum * 1000 / ((double)correctedfps / 1000));
-        uint32_t hour = totalDur / 3600000;
-        totalDur = totalDur % 3600000;
-        uint32_t minute = totalDur / 60000;
-        totalDur = totalDur % 60000;
-        uint32_t second = totalDur / 1000;
-        uint32_t msecond = totalDur % 1000;
-
-        if (!m_presentationDur)
-        {
-            m_presentationDur = new char[1024];
-            if (!m_presentationDur)
-                return OMAF_ERROR_NULL_PTR;
-        }
-        memset_s(m_presentationDur, 1024, 0);
-        snprintf(m_presentationDur, 1024, "PT%02dH%02dM%02d.%03dS",
-            hour, minute, second, msecond);
-
-        mpdEle->SetAttribute(MEDIAPRESENTATIONDURATION, m_presentationDur);
+        mpdEle->SetAttribute(MEDIAPRESENTATIONDURATION, GetFieldPlaceholder(MPD_FIELD_PRESENTATIONDURATION).c_str());
     }
 
     m_xmlDoc->InsertEndChild(mpdEle);
@@ -703,7 +612,7 @@ int32_t MPDWriter::WriteMpd(uint64_t totalFramesNum)
     }
     else
     {
-        periodEle->SetAttribute(DURATION, m_presentationDur);
+        periodEle->SetAttribute(DURATION, GetFieldPlaceholder(MPD_FIELD_PRESENTATIONDURATION).c_str());
     }
 
     mpdEle->InsertEndChild(periodEle);
@@ -886,11 +795,187 @@ int32_t MPDWriter::WriteMpd(uint64_t totalFramesNum)
         }
     }
 
-    m_xmlDoc->SaveFile(m_mpdFileName);
+    XMLPrinter printer;
+    m_xmlDoc->Print(&printer);
+    std::string mpdString(printer.CStr());
+    // DOM isn't needed any more once it is serialized
+    m_xmlDoc->Clear();
+
+    m_mpdTemplate.clear();
+    size_t prefixLen = strlen(FIELD_PLACEHOLDER_PREFIX);
+    size_t pos = 0;
+    while (pos < mpdString.size())
+    {
+        MPDTemplatePiece piece;
+        size_t fieldPos = mpdString.find(FIELD_PLACEHOLDER_PREFIX, pos);
+        if (fieldPos == std::string::npos)
+        {
+            piece.text = mpdString.substr(pos);
+            piece.field = MPD_FIELD_NONE;
+            m_mpdTemplate.push_back(piece);
+            break;
+        }
+
+        size_t fieldEnd = mpdString.find('@', fieldPos + prefixLen);
+        if (fieldEnd == std::string::npos)
+            return OMAF_ERROR_INVALID_DATA;
+
+        int32_t field = atoi(mpdString.substr(fieldPos + prefixLen, fieldEnd - fieldPos - prefixLen).c_str());
+        if ((field < 0) || (field >= MPD_FIELD_NUM))
+            return OMAF_ERROR_INVALID_DATA;
+
+        piece.text = mpdString.substr(pos, fieldPos - pos);
+        piece.field = (MPDDynamicField)field;
+        m_mpdTemplate.push_back(piece);
+        pos = fieldEnd + 1;
+    }
+
+    OMAF_LOG(LOG_INFO, "Generate MPD template with %lu dynamic fields\n", m_mpdTemplate.size() - 1);
 
     return ERROR_NONE;
 }
 
+int32_t MPDWriter::UpdateDynamicFields(uint64_t totalFramesNum)
+{
+    char string[1024];
+
+    if (m_segInfo->isLive)
+    {
+        uint32_t sec;
+        time_t gTime;
+        struct tm *t;
+        struct timeval now;
+        struct timeb timeBuffer;
+        ftime(&timeBuffer);
+        now.tv_sec = (long)(timeBuffer.time);
+        now.tv_usec = timeBuffer.millitm * 1000;
+        sec = (uint32_t)(now.tv_sec) + NTP_SEC_1900_TO_1970;
+
+        gTime = sec - NTP_SEC_1900_TO_1970;
+        t = gmtime(&gTime);
+        if (!t)
+            return OMAF_ERROR_INVALID_TIME;
+
+        memset_s(string, 1024, 0);
+        snprintf(string, 1024, "%d-%d-%dT%d:%d:%dZ", 1900 + t->tm_year,
+            t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+
+        // availability start time is kept unless CMAF is enabled
+        if (!m_availableStartTime[0] || m_cmafEnabled)
+        {
+            memset_s(m_availableStartTime, 1024, 0);
+            snprintf(m_availableStartTime, 1024, "%s", string);
+        }
+        m_fieldValues[MPD_FIELD_AVAILABILITYSTARTTIME] = m_availableStartTime;
+        m_fieldValues[MPD_FIELD_WALLCLOCKTIME] = string;
+
+        if (!m_publishTime)
+        {
+            m_publishTime = new char[1024];
+            if (!m_publishTime)
+                return OMAF_ERROR_NULL_PTR;
+        }
+        memset_s(m_publishTime, 1024, 0);
+        snprintf(m_publishTime, 1024, "%d-%02d-%02dT%02d:%02d:%02dZ", 1900+t->tm_year, t->tm_mon+1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+        m_fieldValues[MPD_FIELD_PUBLISHTIME] = m_publishTime;
+
+        memset_s(string, 1024, 0);
+        snprintf(string, 1024, "%d", (int32_t)m_currSegNum);
+        m_fieldValues[MPD_FIELD_STARTNUMBER] = string;
+    }
+    else
+    {
+        uint32_t fps1000 = (uint32_t) ((double)m_frameRate.num / m_frameRate.den * 1000);
+        uint32_t correctedfps = 0;
+        if (fps1000 == 29970)
+            correctedfps = 30000;
+        else if (fps1000 == 23976)
+            correctedfps = 24000;
+        else if (fps1000 == 59940)
+            correctedfps = 60000;
+        else
+            correctedfps = fps1000;
+        uint32_t totalDur = (uint32_t)((double)totalFramesNum * 1000 / ((double)correctedfps / 1000));
+        uint32_t hour = totalDur / 3600000;
+        totalDur = totalDur % 3600000;
+        uint32_t minute = totalDur / 60000;
+        totalDur = totalDur % 60000;
+        uint32_t second = totalDur / 1000;
+        uint32_t msecond = totalDur % 1000;
+
+        if (!m_presentationDur)
+        {
+            m_presentationDur = new char[1024];
+            if (!m_presentationDur)
+                return OMAF_ERROR_NULL_PTR;
+        }
+        memset_s(m_presentationDur, 1024, 0);
+        snprintf(m_presentationDur, 1024, "PT%02dH%02dM%02d.%03dS",
+            hour, minute, second, msecond);
+        m_fieldValues[MPD_FIELD_PRESENTATIONDURATION] = m_presentationDur;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t MPDWriter::PublishMpd()
+{
+    std::string mpdString;
+    mpdString.reserve(m_mpdSize);
+    std::vector<MPDTemplatePiece>::iterator it;
+    for (it = m_mpdTemplate.begin(); it != m_mpdTemplate.end(); it++)
+    {
+        mpdString.append(it->text);
+        if (it->field != MPD_FIELD_NONE)
+        {
+            mpdString.append(m_fieldValues[it->field]);
+        }
+    }
+    m_mpdSize = mpdString.size();
+
+    std::string tmpName = std::string(m_mpdFileName) + ".tmp";
+    FILE *fp = fopen(tmpName.c_str(), "wb");
+    if (!fp)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to open MPD file %s !\n", tmpName.c_str());
+        return OMAF_FILE_OPEN_ERROR;
+    }
+
+    int32_t ret = ERROR_NONE;
+    if (fwrite(mpdString.c_str(), 1, mpdString.size(), fp) != mpdString.size())
+        ret = OMAF_ERROR_FILE_WRITE;
+    if (fclose(fp))
+        ret = OMAF_ERROR_FILE_WRITE;
+
+    // clients polling MPD see either the previous or the new complete file
+    if (!ret && rename(tmpName.c_str(), m_mpdFileName))
+        ret = OMAF_ERROR_FILE_WRITE;
+
+    if (ret)
+    {
+        OMAF_LOG(LOG_ERROR, "Failed to write MPD file %s !\n", m_mpdFileName);
+        unlink(tmpName.c_str());
+    }
+
+    return ret;
+}
+
+int32_t MPDWriter::WriteMpd(uint64_t totalFramesNum)
+{
+    if (m_mpdTemplate.empty())
+    {
+        int32_t ret = GenerateMpdTemplate();
+        if (ret)
+            return ret;
+    }
+
+    int32_t ret = UpdateDynamicFields(totalFramesNum);
+    if (ret)
+        return ret;
+
+    return PublishMpd();
+}
+
 int32_t MPDWriter::UpdateMpd(uint64_t segNumber, uint64_t framesNumber)
 {
     m_currSegNum = segNumber;
@@ -898,26 +983,6 @@ int32_t MPDWriter::UpdateMpd(uint64_t segNumber, uint64_t framesNumber)
     {
         if (segNumber % m_segInfo->windowSize == 1)
         {
-            char buf[PATH_MAX] = { 0 };
-            char *res = realpath(m_mpdFileName, buf);
-            if (res)
-            {
-                remove(buf);
-                DELETE_MEMORY(m_xmlDoc);
-
-                m_xmlDoc = new XMLDocument;
-                if (!m_xmlDoc)
-                    return OMAF_ERROR_CREATE_XMLFILE_FAILED;
-            }
-            else
-            {
-                if (segNumber > 1)
-                {
-                    perror("realpath");
-                    return OMAF_ERROR_REALPATH_FAILED;
-                }
-            }
-
             int32_t ret = WriteMpd(framesNumber);
             return ret;
         }
@@ -926,23 +991,6 @@ int32_t MPDWriter::UpdateMpd(uint64_t segNumber, uint64_t framesNumber)
     {
         if (framesNumber % (m_segInfo->segDuration * (uint16_t)((double)(m_frameRate.num / m_frameRate.den) + 0.5)) == 0)
         {
-            char buf[PATH_MAX] = { 0 };
-            char *res = realpath(m_mpdFileName, buf);
-            if (res)
-            {
-                remove(buf);
-                DELETE_MEMORY(m_xmlDoc);
-
-                m_xmlDoc = new XMLDocument;
-                if (!m_xmlDoc)
-                    return OMAF_ERROR_CREATE_XMLFILE_FAILED;
-            }
-            else
-            {
-                perror("realpath");
-                return OMAF_ERROR_REALPATH_FAILED;
-            }
-
             int32_t ret = WriteMpd(framesNumber);
             return ret;
         }
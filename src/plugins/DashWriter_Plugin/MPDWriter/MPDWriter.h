@@ -37,6 +37,9 @@
 #include "../DashMPDWriterPluginAPI.h"
 #include "tinyxml2.h"
 #include "../../../utils/safe_mem.h"
+
+#include <string>
+#include <vector>
 //extern "C"
 //{
 //#include "safestringlib/safe_mem_lib.h"
@@ -45,6 +48,33 @@
 using namespace std;
 using namespace tinyxml2;
 
+//!
+//! \enum:   MPDDynamicField
+//! \brief:  MPD attributes which change at each MPD update,
+//!          all other parts of MPD are kept in the template
+//!
+typedef enum
+{
+    MPD_FIELD_NONE = -1,
+    MPD_FIELD_AVAILABILITYSTARTTIME = 0,
+    MPD_FIELD_PUBLISHTIME,
+    MPD_FIELD_PRESENTATIONDURATION,
+    MPD_FIELD_STARTNUMBER,
+    MPD_FIELD_WALLCLOCKTIME,
+    MPD_FIELD_NUM,
+}MPDDynamicField;
+
+//!
+//! \struct: MPDTemplatePiece
+//! \brief:  one piece of serialized MPD template, the literal
+//!          text followed by the value of one dynamic field
+//!
+typedef struct MPDTemplatePiece
+{
+    std::string     text;
+    MPDDynamicField field;
+}MPDTemplatePiece;
+
 class MPDWriter : public MPDWriterBase
 {
 public:
@@ -104,7 +134,10 @@ public:
     int32_t Initialize();
 
     //!
-    //! \brief  Write the MPD file according to segmentation information
+    //! \brief  Write the MPD file according to segmentation information,
+    //!         the MPD template is generated at the first time, then
+    //!         only dynamic fields are filled and the file is replaced
+    //!         atomically
     //!
     //! \param  [in] totalFramesNum
     //!         total number of frames written into segments
@@ -171,6 +204,36 @@ private:
     //!
     int32_t WriteExtractorTrackAS(XMLElement *periodEle, VCD::MP4::MPDAdaptationSetCtx *pTrackASCtx);
 
+    //!
+    //! \brief  Generate the whole MPD with placeholders for dynamic
+    //!         fields, then serialize it into MPD template
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GenerateMpdTemplate();
+
+    //!
+    //! \brief  Update values of all dynamic fields in MPD
+    //!
+    //! \param  [in] totalFramesNum
+    //!         total number of frames written into segments
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t UpdateDynamicFields(uint64_t totalFramesNum);
+
+    //!
+    //! \brief  Fill dynamic fields into MPD template, write it to
+    //!         temporary file and rename to MPD file, so that clients
+    //!         never read missing or partial MPD file
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t PublishMpd();
+
 private:
     std::map<MediaStream*, VCD::MP4::MPDAdaptationSetCtx*>    *m_streamASCtx;        //!< map of media stream and its track MPD adaptation set context
     std::map<uint32_t, VCD::MP4::MPDAdaptationSetCtx*>        *m_extractorASCtx;     //!< map of extractor track index and its track MPD adaptation set context
@@ -188,6 +251,9 @@ private:
     uint8_t                                         m_vsNum;               //!< video streams number
     bool                                            m_cmafEnabled;         //!< flag for whether CMAF compliance is enabled
     uint64_t                                        m_currSegNum;          //!< current segment number
+    std::vector<MPDTemplatePiece>                   m_mpdTemplate;         //!< serialized MPD template split at dynamic fields
+    std::string                                     m_fieldValues[MPD_FIELD_NUM]; //!< current values of dynamic fields
+    size_t                                          m_mpdSize;             //!< size of last written MPD file
 };
 
 extern "C" MPDWriterBase* Create(
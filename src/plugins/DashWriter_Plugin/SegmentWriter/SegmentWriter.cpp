@@ -1797,7 +1797,7 @@ void SegmentWriter::WriteSubSegments(ostream& outStr, const list<Segment> subSeg
 
 }
 
-void SegmentWriter::WriteSegments(std::ostringstream &frameString,
+void SegmentWriter::WriteSegments(std::ostream &frameString,
     uint64_t *segNum,
     char segName[1024],
     char *baseName,
@@ -1811,7 +1811,6 @@ void SegmentWriter::WriteSegments(std::ostringstream &frameString,
             (*segNum)++;
             snprintf(segName, 1024, "%s.%ld.mp4", baseName, *segNum);
             WriteSubSegments(frameString, segment);
-            std::string segString(frameString.str());
         }
     }
 }
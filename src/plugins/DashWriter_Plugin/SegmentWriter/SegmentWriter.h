@@ -110,7 +110,7 @@ public:
 
     void SetWriteSegmentHeader(bool toWriteHdr);
 
-    void WriteSegments(std::ostringstream &frameString,
+    void WriteSegments(std::ostream &frameString,
         uint64_t *segNum, char segName[1024], char *baseName, uint64_t *segSize);
 
 private:
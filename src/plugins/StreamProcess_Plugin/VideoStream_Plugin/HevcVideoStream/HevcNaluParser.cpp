@@ -39,14 +39,27 @@
 
 HevcNaluParser::~HevcNaluParser()
 {
-    DELETE_ARRAY(m_vpsNalu->data);
-    DELETE_MEMORY(m_vpsNalu);
-    DELETE_ARRAY(m_spsNalu->data);
-    DELETE_MEMORY(m_spsNalu);
-    DELETE_ARRAY(m_ppsNalu->data);
-    DELETE_MEMORY(m_ppsNalu);
-    DELETE_ARRAY(m_projNalu->data);
-    DELETE_MEMORY(m_projNalu);
+    // header nalus are absent if the parser is only used for slices
+    if (m_vpsNalu)
+    {
+        DELETE_ARRAY(m_vpsNalu->data);
+        DELETE_MEMORY(m_vpsNalu);
+    }
+    if (m_spsNalu)
+    {
+        DELETE_ARRAY(m_spsNalu->data);
+        DELETE_MEMORY(m_spsNalu);
+    }
+    if (m_ppsNalu)
+    {
+        DELETE_ARRAY(m_ppsNalu->data);
+        DELETE_MEMORY(m_ppsNalu);
+    }
+    if (m_projNalu)
+    {
+        DELETE_ARRAY(m_projNalu->data);
+        DELETE_MEMORY(m_projNalu);
+    }
     DELETE_MEMORY(m_picInfo);
 }
 
@@ -281,49 +294,50 @@ int32_t HevcNaluParser::ParseSliceNalu(
 
     m_360scvpParam->pInputBitstream = frameData;
     m_360scvpParam->inputBitstreamLen = frameDataSize;
-    uint32_t restBSBytes = m_360scvpParam->inputBitstreamLen;
 
-    while (restBSBytes > 0)
+    // locate all nalus of the frame in one pass
+    if (m_frameNalus.size() < (size_t)(tilesNum) + HEVC_FRAME_EXTRA_NALUS)
+        m_frameNalus.resize(tilesNum + HEVC_FRAME_EXTRA_NALUS);
+
+    uint32_t nalusNum = 0;
+    if (I360SCVP_ScanNALUs(frameData, frameDataSize, E_NALU_CODEC_HEVC, m_frameNalus.data(), m_frameNalus.size(), &nalusNum))
+        return OMAF_ERROR_INVALID_FRAME_BITSTREAM;
+
+    if (nalusNum == m_frameNalus.size())
     {
-        Nalu *tempNalu = new Nalu;
-        tempNalu->data = m_360scvpParam->pInputBitstream;
-        tempNalu->dataSize = restBSBytes;
-        I360SCVP_ParseNAL(tempNalu, m_360scvpHandle);
-        if (tempNalu->naluType == 32 || tempNalu->naluType == 33
-        || tempNalu->naluType == 34 || tempNalu->naluType == 39
-        || tempNalu->naluType == 40) // skip VPS/SPS/PPS/SEI
+        I360SCVP_ScanNALUs(frameData, frameDataSize, E_NALU_CODEC_HEVC, NULL, 0, &nalusNum);
+        m_frameNalus.resize(nalusNum);
+        I360SCVP_ScanNALUs(frameData, frameDataSize, E_NALU_CODEC_HEVC, m_frameNalus.data(), m_frameNalus.size(), &nalusNum);
+    }
+
+    uint32_t naluIdx = 0;
+    while (naluIdx < nalusNum)
+    {
+        uint16_t naluType = m_frameNalus[naluIdx].naluType;
+        if (naluType == 32 || naluType == 33
+        || naluType == 34 || naluType == 39
+        || naluType == 40) // skip VPS/SPS/PPS/SEI
         {
-            m_360scvpParam->pInputBitstream = m_360scvpParam->pInputBitstream + tempNalu->dataSize;
-            restBSBytes -= tempNalu->dataSize;
-            delete tempNalu;
-            tempNalu = NULL;
+            naluIdx++;
         }
         else
         {
-            delete tempNalu;
-            tempNalu = NULL;
             break;
         }
     }
 
-    uint32_t restBitstreamLen = restBSBytes;
+    if ((nalusNum - naluIdx) < tilesNum)
+        return OMAF_ERROR_INVALID_FRAME_BITSTREAM;
+
+    m_360scvpParam->pInputBitstream = m_frameNalus[naluIdx].data;
+
     for (uint16_t tileIdx = 0; tileIdx < tilesNum; tileIdx++)
     {
         TileInfo *tileInfo = &(tilesInfo[tileIdx]);
         Nalu *nalu         = tileInfo->tileNalu;
 
-        if (tileIdx == 0)
-        {
-            nalu->data       = m_360scvpParam->pInputBitstream;
-            nalu->dataSize   = restBitstreamLen;
-        }
-        else
-        {
-            TileInfo *tileInfoPrev = &(tilesInfo[tileIdx - 1]);
-            Nalu *naluPrev         = tileInfoPrev->tileNalu;
-            nalu->data             = naluPrev->data + naluPrev->dataSize;
-            nalu->dataSize         = restBitstreamLen;
-        }
+        nalu->data       = m_frameNalus[naluIdx + tileIdx].data;
+        nalu->dataSize   = m_frameNalus[naluIdx + tileIdx].dataSize;
 
         uint8_t *startPos = nalu->data;
 
@@ -334,8 +348,6 @@ int32_t HevcNaluParser::ParseSliceNalu(
 
         nalu->sliceHeaderLen = nalu->sliceHeaderLen - HEVC_NALUHEADER_LEN;
 
-        restBitstreamLen = restBitstreamLen - nalu->dataSize;
-
         uint64_t actualSize = nalu->dataSize - HEVC_STARTCODES_LEN;
         nalu->data[0] = (uint8_t)((0xff000000 & actualSize) >> 24);
         nalu->data[1] = (uint8_t)((0x00ff0000 & actualSize) >> 16);
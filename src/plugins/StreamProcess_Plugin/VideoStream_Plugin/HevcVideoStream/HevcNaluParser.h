@@ -39,6 +39,10 @@
 
 #include "NaluParser.h"
 
+#include <vector>
+
+#define HEVC_FRAME_EXTRA_NALUS 8 //<! expected max number of non-slice nalus in one frame
+
 //!
 //! \class HevcNaluParser
 //! \brief Define the operation and needed data for Hevc nalu parser
@@ -171,6 +175,7 @@ private:
     virtual int16_t ParseProjectionTypeSei();
 
 private:
+    std::vector<Nalu> m_frameNalus;  //!< nalus located in current frame bitstream, reused between frames
 };
 
 #endif /* _HEVCNALUPARSER_H_ */
@@ -61,9 +61,18 @@ HevcVideoStream::HevcVideoStream()
     m_360scvpParam = NULL;
     m_360scvpHandle = NULL;
     m_naluParser = NULL;
+    m_aheadScvpParam = NULL;
+    m_aheadScvpHandle = NULL;
+    m_aheadNaluParser = NULL;
+    m_aheadTilesInfo = NULL;
     m_isEOS = false;
     m_lastKeyFramePTS = 0;
     m_gopSize = 0;
+    m_frameQueueDepth = 0;
+    m_frameQueuePolicy = E_FRAME_QUEUE_BLOCK;
+    memset_s(&m_queueStats, sizeof(FrameQueueStats), 0);
+    m_queueClosed = false;
+    m_activeWriters = 0;
 }
 
 HevcVideoStream::HevcVideoStream(const HevcVideoStream& src)
@@ -92,9 +101,19 @@ HevcVideoStream::HevcVideoStream(const HevcVideoStream& src)
     m_360scvpParam = std::move(src.m_360scvpParam);
     m_360scvpHandle = std::move(src.m_360scvpHandle);
     m_naluParser = std::move(src.m_naluParser);
+    m_aheadScvpParam = std::move(src.m_aheadScvpParam);
+    m_aheadScvpHandle = std::move(src.m_aheadScvpHandle);
+    m_aheadNaluParser = std::move(src.m_aheadNaluParser);
+    m_aheadTilesInfo = std::move(src.m_aheadTilesInfo);
     m_isEOS = src.m_isEOS;
     m_lastKeyFramePTS = 0;
     m_gopSize = 0;
+    m_frameQueueDepth = src.m_frameQueueDepth;
+    m_frameQueuePolicy = src.m_frameQueuePolicy;
+    memset_s(&m_queueStats, sizeof(FrameQueueStats), 0);
+    m_queueStats.capacity = m_frameQueueDepth;
+    m_queueClosed = false;
+    m_activeWriters = 0;
 }
 
 HevcVideoStream& HevcVideoStream::operator=(HevcVideoStream&& other)
@@ -123,13 +142,29 @@ HevcVideoStream& HevcVideoStream::operator=(HevcVideoStream&& other)
     m_360scvpParam = std::move(other.m_360scvpParam);
     m_360scvpHandle = std::move(other.m_360scvpHandle);
     m_naluParser = std::move(other.m_naluParser);
+    m_aheadScvpParam = std::move(other.m_aheadScvpParam);
+    m_aheadScvpHandle = std::move(other.m_aheadScvpHandle);
+    m_aheadNaluParser = std::move(other.m_aheadNaluParser);
+    m_aheadTilesInfo = std::move(other.m_aheadTilesInfo);
     m_isEOS = other.m_isEOS;
+    m_frameQueueDepth = other.m_frameQueueDepth;
+    m_frameQueuePolicy = other.m_frameQueuePolicy;
+    m_queueStats = other.m_queueStats;
 
     return *this;
 }
 
 HevcVideoStream::~HevcVideoStream()
 {
+    // wake up the writers blocked by full queue and wait for all
+    // writers to leave before the members they touch are released
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueClosed = true;
+        m_queueNotFull.notify_all();
+        m_writersDone.wait(lock, [this]() { return m_activeWriters == 0; });
+    }
+
     if (m_srcRwpk)
     {
         DELETE_ARRAY(m_srcRwpk->rectRegionPacking);
@@ -160,33 +195,17 @@ HevcVideoStream::~HevcVideoStream()
 
     DELETE_MEMORY(m_videoSegInfoGen);
 
-    std::list<FrameBSInfo*>::iterator it1;
-    for (it1 = m_frameInfoList.begin(); it1 != m_frameInfoList.end();)
+    std::deque<FrameBSInfo*>::iterator it1;
+    for (it1 = m_frameInfoList.begin(); it1 != m_frameInfoList.end(); it1++)
     {
-        FrameBSInfo *frameInfo = *it1;
-        if (frameInfo)
-        {
-            DELETE_ARRAY(frameInfo->data);
-
-            delete frameInfo;
-            frameInfo = NULL;
-        }
-
-        it1 = m_frameInfoList.erase(it1);
+        ReleaseFrameInfo(*it1);
     }
     m_frameInfoList.clear();
 
     std::list<FrameBSInfo*>::iterator it2;
     for (it2 = m_framesToOneSeg.begin(); it2 != m_framesToOneSeg.end();)
     {
-        FrameBSInfo *frameInfo = *it2;
-        if (frameInfo)
-        {
-            DELETE_ARRAY(frameInfo->data);
-
-            delete frameInfo;
-            frameInfo = NULL;
-        }
+        ReleaseFrameInfo(*it2);
 
         it2 = m_framesToOneSeg.erase(it2);
     }
@@ -200,6 +219,14 @@ HevcVideoStream::~HevcVideoStream()
     }
 
     DELETE_MEMORY(m_naluParser);
+
+    DELETE_MEMORY(m_aheadNaluParser);
+    DELETE_ARRAY(m_aheadTilesInfo);
+    DELETE_MEMORY(m_aheadScvpParam);
+    if (m_aheadScvpHandle)
+    {
+        I360SCVP_unInit(m_aheadScvpHandle);
+    }
 }
 
 int32_t HevcVideoStream::ParseHeader()
@@ -457,6 +484,22 @@ int32_t HevcVideoStream::Initialize(
     m_frameRate = bs->frameRate;
     m_bitRate = bs->bitRate;
 
+    SegmentationInfo *segInfo = initInfo->segmentationInfo;
+    if (segInfo && (segInfo->frameQueueDepth > 0))
+    {
+        m_frameQueueDepth = (uint32_t)(segInfo->frameQueueDepth);
+        // segmentation starts only after 'needBufedFrames' frames
+        // are queued for every video stream, so the queue must be
+        // able to hold more than that
+        if ((segInfo->needBufedFrames > 0) && (m_frameQueueDepth <= (uint32_t)(segInfo->needBufedFrames)))
+        {
+            m_frameQueueDepth = (uint32_t)(segInfo->needBufedFrames) + 1;
+            OMAF_LOG(LOG_WARNING, "Frame queue depth is raised to %d for video stream %d !\n", m_frameQueueDepth, streamIdx);
+        }
+        m_frameQueuePolicy = segInfo->frameQueuePolicy;
+        m_queueStats.capacity = m_frameQueueDepth;
+    }
+
     m_360scvpParam = new param_360SCVP;
     if (!m_360scvpParam)
         return OMAF_ERROR_NULL_PTR;
@@ -575,51 +618,205 @@ int32_t HevcVideoStream::AddFrameInfo(FrameBSInfo *frameInfo)
     if (!frameInfo || !(frameInfo->data))
         return OMAF_ERROR_NULL_PTR;
 
-    if (!frameInfo->dataSize)
+    if (frameInfo->dataSize <= 0)
         return OMAF_ERROR_DATA_SIZE;
 
-    FrameBSInfo *newFrameInfo = new FrameBSInfo;
-    if (!newFrameInfo)
+    QueuedFrameInfo *newFrame = new QueuedFrameInfo;
+    if (!newFrame)
         return OMAF_ERROR_NULL_PTR;
 
-    memset_s(newFrameInfo, sizeof(FrameBSInfo), 0);
+    memset_s(newFrame, sizeof(QueuedFrameInfo), 0);
 
     uint8_t *localData = new uint8_t[frameInfo->dataSize];
     if (!localData)
     {
-        delete newFrameInfo;
-        newFrameInfo = NULL;
+        delete newFrame;
+        newFrame = NULL;
         return OMAF_ERROR_NULL_PTR;
     }
     memcpy_s(localData, frameInfo->dataSize, frameInfo->data, frameInfo->dataSize);
 
-    newFrameInfo->data = localData;
-    newFrameInfo->dataSize = frameInfo->dataSize;
-    newFrameInfo->pts = frameInfo->pts;
-    newFrameInfo->isKeyFrame = frameInfo->isKeyFrame;
+    newFrame->frameInfo.data = localData;
+    newFrame->frameInfo.dataSize = frameInfo->dataSize;
+    newFrame->frameInfo.pts = frameInfo->pts;
+    newFrame->frameInfo.isKeyFrame = frameInfo->isKeyFrame;
+
+    int32_t ret = EnqueueFrame(newFrame);
+    if (ret)
+    {
+        DELETE_ARRAY(localData);
+        delete newFrame;
+        newFrame = NULL;
+        return ret;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t HevcVideoStream::AddFrameInfo(FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque)
+{
+    if (!frameInfo || !(frameInfo->data) || !releaseFunc)
+        return OMAF_ERROR_NULL_PTR;
+
+    if (frameInfo->dataSize <= 0)
+        return OMAF_ERROR_DATA_SIZE;
+
+    QueuedFrameInfo *newFrame = new QueuedFrameInfo;
+    if (!newFrame)
+        return OMAF_ERROR_NULL_PTR;
+
+    newFrame->frameInfo = *frameInfo;
+    newFrame->releaseFunc = releaseFunc;
+    newFrame->opaque = opaque;
 
-    if (m_gopSize == 0 && newFrameInfo->isKeyFrame) {
-        if (m_lastKeyFramePTS != 0) {
-            m_gopSize = (uint32_t)(newFrameInfo->pts - m_lastKeyFramePTS);
+    // ownership of the data goes back to the caller if the frame isn't queued
+    int32_t ret = EnqueueFrame(newFrame);
+    if (ret)
+    {
+        delete newFrame;
+        newFrame = NULL;
+        return ret;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t HevcVideoStream::EnqueueFrame(QueuedFrameInfo *frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queueClosed)
+            return OMAF_ERROR_OPERATION;
+        m_activeWriters++;
+    }
+
+    int32_t ret = PushFrame(frame);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activeWriters--;
+        if (m_activeWriters == 0)
+            m_writersDone.notify_all();
+    }
+
+    return ret;
+}
+
+int32_t HevcVideoStream::PushFrame(QueuedFrameInfo *frame)
+{
+    FrameBSInfo *droppedFrame = NULL;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_frameQueueDepth && (m_frameInfoList.size() >= m_frameQueueDepth))
+        {
+            if (m_frameQueuePolicy == E_FRAME_QUEUE_NONBLOCK)
+            {
+                m_queueStats.rejectedFrames++;
+                return OMAF_ERROR_FRAME_QUEUE_FULL;
+            }
+            else if (m_frameQueuePolicy == E_FRAME_QUEUE_DROP_OLDEST)
+            {
+                droppedFrame = m_frameInfoList.front();
+                m_frameInfoList.pop_front();
+                m_queueStats.droppedFrames++;
+            }
+            else
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                m_queueNotFull.wait(lock, [this]() {
+                    return m_queueClosed || (m_frameInfoList.size() < m_frameQueueDepth);
+                });
+                m_queueStats.blockedTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                if (m_queueClosed)
+                    return OMAF_ERROR_OPERATION;
+            }
+        }
+
+        // the frame may be popped and released as soon as it is queued and
+        // the lock is released, so it is only touched before being queued
+        if (m_gopSize == 0 && frame->frameInfo.isKeyFrame) {
+            if (m_lastKeyFramePTS != 0) {
+                m_gopSize = (uint32_t)(frame->frameInfo.pts - m_lastKeyFramePTS);
+            }
+            else {
+                m_lastKeyFramePTS = frame->frameInfo.pts;
+            }
         }
-        else {
-            m_lastKeyFramePTS = newFrameInfo->pts;
+
+        m_frameInfoList.push_back(&(frame->frameInfo));
+        m_queueStats.queuedFrames++;
+        if (m_frameInfoList.size() > m_queueStats.maxDepth)
+        {
+            m_queueStats.maxDepth = m_frameInfoList.size();
         }
     }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_frameInfoList.push_back(newFrameInfo);
+    if (droppedFrame)
+    {
+        OMAF_LOG(LOG_WARNING, "Frame queue of video stream %d is full, drop frame with pts %ld !\n", m_streamIdx, droppedFrame->pts);
+        ReleaseFrameInfo(droppedFrame);
+    }
 
     return ERROR_NONE;
 }
 
-void HevcVideoStream::SetCurrFrameInfo()
+FrameBSInfo* HevcVideoStream::DequeueFrame()
+{
+    FrameBSInfo *frameInfo = NULL;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_frameInfoList.size() > 0)
+        {
+            frameInfo = m_frameInfoList.front();
+            m_frameInfoList.pop_front();
+        }
+    }
+
+    if (frameInfo)
+    {
+        m_queueNotFull.notify_one();
+    }
+
+    return frameInfo;
+}
+
+void HevcVideoStream::ReleaseFrameInfo(FrameBSInfo *frameInfo)
+{
+    if (!frameInfo)
+        return;
+
+    QueuedFrameInfo *frame = (QueuedFrameInfo*)frameInfo;
+    if (frame->releaseFunc)
+    {
+        frame->releaseFunc(frame->frameInfo.data, frame->opaque);
+        frame->frameInfo.data = NULL;
+    }
+    else
+    {
+        DELETE_ARRAY(frame->frameInfo.data);
+    }
+
+    delete frame;
+    frame = NULL;
+}
+
+void HevcVideoStream::GetFrameQueueStats(FrameQueueStats *stats)
 {
+    if (!stats)
+        return;
+
     std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_frameInfoList.size() > 0)
+    *stats = m_queueStats;
+    stats->depth = m_frameInfoList.size();
+}
+
+void HevcVideoStream::SetCurrFrameInfo()
+{
+    FrameBSInfo *frameInfo = DequeueFrame();
+    if (frameInfo)
     {
-        m_currFrameInfo = m_frameInfoList.front();
-        m_frameInfoList.pop_front();
+        m_currFrameInfo = frameInfo;
     }
 }
 
@@ -636,6 +833,67 @@ int32_t HevcVideoStream::UpdateTilesNalu()
     return ERROR_NONE;
 }
 
+FrameBSInfo* HevcVideoStream::FetchFrameInfo()
+{
+    return DequeueFrame();
+}
+
+int32_t HevcVideoStream::ParseTilesNalu(FrameBSInfo *frameInfo, Nalu *tilesNalu)
+{
+    if (!frameInfo || !tilesNalu)
+        return OMAF_ERROR_NULL_PTR;
+
+    uint16_t tilesNum = m_tileInRow * m_tileInCol;
+    if (!m_aheadNaluParser)
+    {
+        // the parsing state of header data is cloned, so that slice
+        // parsing doesn't touch the handle used by current frame
+        m_aheadScvpHandle = I360SCVP_New(m_360scvpHandle);
+        if (!m_aheadScvpHandle)
+            return OMAF_ERROR_SCVP_INIT_FAILED;
+
+        m_aheadScvpParam = new param_360SCVP;
+        if (!m_aheadScvpParam)
+            return OMAF_ERROR_NULL_PTR;
+
+        memcpy_s(m_aheadScvpParam, sizeof(param_360SCVP), m_360scvpParam, sizeof(param_360SCVP));
+
+        m_aheadTilesInfo = new TileInfo[tilesNum];
+        if (!m_aheadTilesInfo)
+            return OMAF_ERROR_NULL_PTR;
+
+        memset_s(m_aheadTilesInfo, tilesNum * sizeof(TileInfo), 0);
+
+        m_aheadNaluParser = new HevcNaluParser(m_aheadScvpHandle, m_aheadScvpParam);
+        if (!m_aheadNaluParser)
+            return OMAF_ERROR_NULL_PTR;
+    }
+
+    for (uint16_t tileIdx = 0; tileIdx < tilesNum; tileIdx++)
+    {
+        m_aheadTilesInfo[tileIdx].tileNalu = &(tilesNalu[tileIdx]);
+    }
+
+    int32_t ret = m_aheadNaluParser->ParseSliceNalu(frameInfo->data, frameInfo->dataSize, tilesNum, m_aheadTilesInfo);
+    if (ret)
+        return ret;
+
+    return ERROR_NONE;
+}
+
+void HevcVideoStream::SetCurrFrameInfo(FrameBSInfo *frameInfo, Nalu *tilesNalu)
+{
+    m_currFrameInfo = frameInfo;
+    if (!frameInfo || !tilesNalu)
+        return;
+
+    uint16_t tilesNum = m_tileInRow * m_tileInCol;
+    for (uint16_t tileIdx = 0; tileIdx < tilesNum; tileIdx++)
+    {
+        *(m_tilesInfo[tileIdx].tileNalu) = tilesNalu[tileIdx];
+    }
+}
+
 TileInfo* HevcVideoStream::GetAllTilesInfo()
 {
     return m_tilesInfo;
@@ -651,13 +909,7 @@ void HevcVideoStream::DestroyCurrSegmentFrames()
     std::list<FrameBSInfo*>::iterator it;
     for (it = m_framesToOneSeg.begin(); it != m_framesToOneSeg.end(); )
     {
-        FrameBSInfo *frameInfo = *it;
-        if (frameInfo)
-        {
-            DELETE_ARRAY(frameInfo->data);
-            delete frameInfo;
-            frameInfo = NULL;
-        }
+        ReleaseFrameInfo(*it);
 
         //m_framesToOneSeg.erase(it++);
         it = m_framesToOneSeg.erase(it);
@@ -670,9 +922,7 @@ void HevcVideoStream::DestroyCurrFrameInfo()
 {
     if (m_currFrameInfo)
     {
-        DELETE_ARRAY(m_currFrameInfo->data);
-
-        delete m_currFrameInfo;
+        ReleaseFrameInfo(m_currFrameInfo);
         m_currFrameInfo = NULL;
     }
 }
@@ -40,6 +40,22 @@
 #include "HevcNaluParser.h"
 #include "../../../../utils/safe_mem.h"
 
+#include <deque>
+#include <chrono>
+#include <condition_variable>
+
+//!
+//! \struct: QueuedFrameInfo
+//! \brief:  frame information queued in the video stream, together
+//!          with the way to release its bitstream data
+//!
+typedef struct QueuedFrameInfo
+{
+    FrameBSInfo          frameInfo;   //!< frame information, must be the first member
+    FrameReleaseCallback releaseFunc; //!< callback to release data, NULL if data is copied by the video stream
+    void                 *opaque;     //!< user data passed to releaseFunc
+}QueuedFrameInfo;
+
 //!
 //! \class HevcVideoStream
 //! \brief Define the data and data operation for HEVC video stream
@@ -184,6 +200,44 @@ public:
     //!
     int32_t AddFrameInfo(FrameBSInfo *frameInfo);
 
+    //!
+    //! \brief  Add frame information for a new frame into
+    //!         frame information list of the video without
+    //!         copying its bitstream data
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information of the new frame
+    //! \param  [in] releaseFunc
+    //!         callback to return the bitstream data to its owner
+    //! \param  [in] opaque
+    //!         user data passed to releaseFunc
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t AddFrameInfo(FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque);
+
+    //!
+    //! \brief  Release one frame information which is popped
+    //!         by FetchFrameInfo but not set as current frame
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information to be released
+    //!
+    //! \return void
+    //!
+    void ReleaseFrameInfo(FrameBSInfo *frameInfo);
+
+    //!
+    //! \brief  Get statistics of frame information list
+    //!
+    //! \param  [out] stats
+    //!         pointer to the frame queue statistics
+    //!
+    //! \return void
+    //!
+    void GetFrameQueueStats(FrameQueueStats *stats);
+
     //!
     //! \brief  Fetch the front frame information in frame
     //!         information list as current frame information
@@ -201,6 +255,44 @@ public:
     //!
     int32_t UpdateTilesNalu();
 
+    //!
+    //! \brief  Pop the front frame information in frame
+    //!         information list without setting it as
+    //!         current frame information
+    //!
+    //! \return FrameBSInfo*
+    //!         the pointer to the frame information, NULL
+    //!         if no frame is available
+    //!
+    FrameBSInfo* FetchFrameInfo();
+
+    //!
+    //! \brief  Parse tile nalu information of one frame which
+    //!         is fetched ahead with dedicated 360SCVP handle
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information fetched ahead
+    //! \param  [out] tilesNalu
+    //!         nalu information of all tiles
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t ParseTilesNalu(FrameBSInfo *frameInfo, Nalu *tilesNalu);
+
+    //!
+    //! \brief  Set one frame which has been parsed ahead as
+    //!         current frame information
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information parsed ahead
+    //! \param  [in] tilesNalu
+    //!         nalu information of all tiles parsed from the frame
+    //!
+    //! \return void
+    //!
+    void SetCurrFrameInfo(FrameBSInfo *frameInfo, Nalu *tilesNalu);
+
     //!
     //! \brief  Get all tiles information
     //!
@@ -337,6 +429,43 @@ public:
     NovelViewSEI* GetNovelViewSEIInfo() { return NULL; };
 
 private:
+    //!
+    //! \brief  Push one frame into frame information list
+    //!         according to the queue depth and policy
+    //!
+    //! \param  [in] frame
+    //!         pointer to the queued frame information
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason, and
+    //!         the frame isn't queued
+    //!
+    int32_t EnqueueFrame(QueuedFrameInfo *frame);
+
+    //!
+    //! \brief  Push one frame into frame information list,
+    //!         called by EnqueueFrame while the writer is counted
+    //!         as active
+    //!
+    //! \param  [in] frame
+    //!         pointer to the queued frame information
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason, and
+    //!         the frame isn't queued
+    //!
+    int32_t PushFrame(QueuedFrameInfo *frame);
+
+    //!
+    //! \brief  Pop the front frame in frame information list
+    //!         and wake up the writer blocked by full queue
+    //!
+    //! \return FrameBSInfo*
+    //!         the pointer to the frame information, NULL
+    //!         if no frame is available
+    //!
+    FrameBSInfo* DequeueFrame();
+
     //!
     //! \brief  Parse the header data of the video stream,
     //!         including SPS, PPS, ProjectionTypeSei,
@@ -390,12 +519,23 @@ private:
     RegionWisePacking         *m_srcRwpk;         //!< pointer to the region wise packing information of the video
     ContentCoverage           *m_srcCovi;         //!< pointer to the content coverage information of the video
     VideoSegmentInfoGenerator *m_videoSegInfoGen; //!< pointer to the video segment information generator
-    std::list<FrameBSInfo*>   m_frameInfoList;    //!< frame information list of the video
+    std::deque<FrameBSInfo*>  m_frameInfoList;    //!< frame information list of the video
+    uint32_t                  m_frameQueueDepth;  //!< max frames number in frame information list, 0 means unbounded
+    E_FrameQueuePolicy        m_frameQueuePolicy; //!< policy when frame information list is full
+    FrameQueueStats           m_queueStats;       //!< statistics of frame information list
+    bool                      m_queueClosed;      //!< whether writers blocked by full queue should give up
+    std::condition_variable   m_queueNotFull;     //!< notified when one frame is popped from frame information list
+    uint32_t                  m_activeWriters;    //!< number of writers inside EnqueueFrame
+    std::condition_variable   m_writersDone;      //!< notified when the last active writer leaves EnqueueFrame
     std::list<FrameBSInfo*>   m_framesToOneSeg;   //!< frames will be written into one segment
     FrameBSInfo               *m_currFrameInfo;   //!< pointer to the current frame information
     param_360SCVP             *m_360scvpParam;    //!< 360SCVP library initial parameter
     void                      *m_360scvpHandle;   //!< 360SCVP library handle
     NaluParser                *m_naluParser;      //!< NALU parser to parse the header data of the video
+    param_360SCVP             *m_aheadScvpParam;  //!< 360SCVP library parameter for frames parsed ahead
+    void                      *m_aheadScvpHandle; //!< 360SCVP library handle for frames parsed ahead
+    NaluParser                *m_aheadNaluParser; //!< NALU parser for frames parsed ahead
+    TileInfo                  *m_aheadTilesInfo;  //!< tile information used when parsing frames ahead
     Rational                  m_frameRate;        //!< the frame rate of the video stream
     uint64_t                  m_bitRate;          //!< the bit rate of the video stream
     bool                      m_isEOS;            //!< the EOS status of the video stream
@@ -178,6 +178,46 @@ public:
     //!
     virtual int32_t AddFrameInfo(FrameBSInfo *frameInfo) = 0;
 
+    //!
+    //! \brief  Add frame information for a new frame into
+    //!         frame information list of the video without
+    //!         copying its bitstream data
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information of the new frame
+    //! \param  [in] releaseFunc
+    //!         callback to return the bitstream data to its owner
+    //!         once the frame is written into segment or dropped,
+    //!         it is only called when ERROR_NONE is returned
+    //! \param  [in] opaque
+    //!         user data passed to releaseFunc
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t AddFrameInfo(FrameBSInfo *frameInfo, FrameReleaseCallback releaseFunc, void *opaque) = 0;
+
+    //!
+    //! \brief  Release one frame information which is popped
+    //!         by FetchFrameInfo but not set as current frame
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information to be released
+    //!
+    //! \return void
+    //!
+    virtual void ReleaseFrameInfo(FrameBSInfo *frameInfo) = 0;
+
+    //!
+    //! \brief  Get statistics of frame information list
+    //!
+    //! \param  [out] stats
+    //!         pointer to the frame queue statistics
+    //!
+    //! \return void
+    //!
+    virtual void GetFrameQueueStats(FrameQueueStats *stats) = 0;
+
     //!
     //! \brief  Fetch the front frame information in frame
     //!         information list as current frame information
@@ -195,6 +235,49 @@ public:
     //!
     virtual int32_t UpdateTilesNalu() = 0;
 
+    //!
+    //! \brief  Pop the front frame information in frame
+    //!         information list without setting it as
+    //!         current frame information, so that the frame
+    //!         can be parsed ahead of segmentation
+    //!
+    //! \return FrameBSInfo*
+    //!         the pointer to the frame information, NULL
+    //!         if no frame is available
+    //!
+    virtual FrameBSInfo* FetchFrameInfo() = 0;
+
+    //!
+    //! \brief  Parse tile nalu information of one frame which
+    //!         is fetched ahead, it uses a dedicated 360SCVP
+    //!         handle so that it can run on a different thread
+    //!         from the one using current frame information
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information fetched ahead
+    //! \param  [out] tilesNalu
+    //!         nalu information of all tiles, the array size
+    //!         should be tiles number of the video
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t ParseTilesNalu(FrameBSInfo *frameInfo, Nalu *tilesNalu) = 0;
+
+    //!
+    //! \brief  Set one frame which has been parsed ahead as
+    //!         current frame information, and update tile nalu
+    //!         information with the parsed one
+    //!
+    //! \param  [in] frameInfo
+    //!         pointer to the frame information parsed ahead
+    //! \param  [in] tilesNalu
+    //!         nalu information of all tiles parsed from the frame
+    //!
+    //! \return void
+    //!
+    virtual void SetCurrFrameInfo(FrameBSInfo *frameInfo, Nalu *tilesNalu) = 0;
+
     //!
     //! \brief  Get all tiles information
     //!
@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   AsyncLog.cpp
+//! \brief:  Asynchronous log backend implementation
+//!
+//! Created on April 12, 2021, 6:04 AM
+//!
+
+#include "AsyncLog.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+//!
+//! \enum:  LogArgType
+//! \brief: argument types kept in log record, integers are
+//!         widened to 64 bits
+//!
+typedef enum
+{
+    LOG_ARG_SIGNED = 0,
+    LOG_ARG_UNSIGNED,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER,
+}LogArgType;
+
+//!
+//! \struct: LogRecord
+//! \brief:  fixed size binary record of one log call
+//!
+typedef struct LogRecord
+{
+    const char  *fmt;
+    const char  *sourceFile;
+    uint64_t    line;
+    uint64_t    timeUs;   //!< wall clock time of the log call in microseconds
+    uint32_t    tid;      //!< id of the logging thread
+    LogLevel    logLevel;
+    uint8_t     argsNum;
+    uint8_t     argTypes[ASYNC_LOG_MAX_ARGS];
+    union
+    {
+        int64_t     signedValue;
+        uint64_t    unsignedValue;
+        double      doubleValue;
+        const void  *pointerValue;
+        uint32_t    stringOffset;
+    } args[ASYNC_LOG_MAX_ARGS];
+    char        strings[ASYNC_LOG_STRING_SIZE];
+}LogRecord;
+
+//!
+//! \struct: LogRing
+//! \brief:  single producer single consumer ring of log records,
+//!          the producer is the owner thread and the consumer is
+//!          the one holding drain lock of the logger
+//!
+typedef struct LogRing
+{
+    LogRecord             records[ASYNC_LOG_RING_SIZE];
+    std::atomic<uint64_t> head;   //!< next record to write, only updated by producer
+    std::atomic<uint64_t> tail;   //!< next record to read, only updated by consumer
+    std::atomic<bool>     closed; //!< whether the owner thread has exited
+    uint32_t              tid;    //!< id of the owner thread
+}LogRing;
+
+//!
+//! \struct: FormatSpec
+//! \brief:  one conversion specification parsed from format
+//!
+typedef struct FormatSpec
+{
+    const char *begin;     //!< pointer to '%'
+    const char *end;       //!< pointer after conversion character
+    char       conversion; //!< conversion character
+    uint8_t    starsNum;   //!< number of '*' in width and precision
+    LogArgType type;       //!< type of the argument
+}FormatSpec;
+
+// Parse the conversion specification starting at '%', return false
+// for "%%" and incomplete specification
+static bool ParseFormatSpec(const char *pos, FormatSpec *spec)
+{
+    spec->begin = pos;
+    spec->starsNum = 0;
+    pos++;
+    while (*pos && strchr("-+ #0", *pos)) pos++;
+    if (*pos == '*') { spec->starsNum++; pos++; }
+    while (*pos >= '0' && *pos <= '9') pos++;
+    if (*pos == '.')
+    {
+        pos++;
+        if (*pos == '*') { spec->starsNum++; pos++; }
+        while (*pos >= '0' && *pos <= '9') pos++;
+    }
+    while (*pos && strchr("hlLqjzt", *pos)) pos++;
+
+    spec->conversion = *pos;
+    if (!spec->conversion || spec->conversion == '%')
+        return false;
+
+    spec->end = pos + 1;
+    switch (spec->conversion)
+    {
+        case 'd':
+        case 'i':
+        case 'c':
+            spec->type = LOG_ARG_SIGNED;
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            spec->type = LOG_ARG_UNSIGNED;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec->type = LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            spec->type = LOG_ARG_STRING;
+            break;
+        default:
+            spec->type = LOG_ARG_POINTER;
+            break;
+    }
+    return true;
+}
+
+// Length modifier of the specification, used to read the argument
+// with its promoted type
+static char GetLengthModifier(const FormatSpec *spec)
+{
+    const char *pos = spec->end - 2;
+    if (pos <= spec->begin)
+        return 0;
+    if (*pos == 'l' && *(pos - 1) == 'l')
+        return 'q';
+    if (*pos == 'l' || *pos == 'j' || *pos == 'z' || *pos == 't' || *pos == 'q' || *pos == 'L')
+        return (*pos == 'L') ? 'L' : 'l';
+    return 0;
+}
+
+class AsyncLogger
+{
+public:
+    AsyncLogger() : m_sink(NULL), m_dropped(0), m_stop(false), m_started(false) {};
+
+    ~AsyncLogger() {};
+
+    LogRing* GetThreadRing();
+
+    void Start();
+
+    void Stop();
+
+    bool IsStopped() { return m_stop.load(std::memory_order_acquire); };
+
+    void Drain();
+
+    void Output(const LogRecord *record);
+
+    std::atomic<AsyncLogSink>  m_sink;
+    std::atomic<uint64_t>      m_dropped;
+
+private:
+    void Run();
+
+    std::mutex                 m_ringsMutex;  //!< protects m_rings, only locked when one thread logs at first time
+    std::vector<LogRing*>      m_rings;
+    std::mutex                 m_drainMutex;  //!< only one consumer drains rings at one time
+    std::mutex                 m_mutex;
+    std::condition_variable    m_cond;
+    std::atomic<bool>          m_stop;
+    bool                       m_started;
+    std::thread                m_thread;
+};
+
+// never destroyed, so that threads still logging at process exit
+// don't touch a destroyed logger
+static AsyncLogger* GetAsyncLogger()
+{
+    static AsyncLogger *logger = new AsyncLogger();
+    return logger;
+}
+
+// marks ring of the thread closed when the thread exits, then the
+// ring is released by consumer after it is drained
+class LogRingHolder
+{
+public:
+    LogRingHolder() : m_ring(NULL) {};
+    ~LogRingHolder()
+    {
+        if (m_ring)
+            m_ring->closed.store(true, std::memory_order_release);
+    };
+
+    LogRing *m_ring;
+};
+
+static thread_local LogRingHolder t_ringHolder;
+
+static uint32_t GetThreadId()
+{
+    return (uint32_t)syscall(SYS_gettid);
+}
+
+static uint64_t GetTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+LogRing* AsyncLogger::GetThreadRing()
+{
+    if (t_ringHolder.m_ring)
+        return t_ringHolder.m_ring;
+
+    LogRing *ring = new LogRing;
+    if (!ring)
+        return NULL;
+
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->closed.store(false, std::memory_order_relaxed);
+    ring->tid = GetThreadId();
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.push_back(ring);
+    }
+    t_ringHolder.m_ring = ring;
+
+    Start();
+    return ring;
+}
+
+void AsyncLogger::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_started)
+        return;
+
+    m_started = true;
+    m_thread = std::thread(&AsyncLogger::Run, this);
+}
+
+void AsyncLogger::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop)
+            return;
+        m_stop = true;
+        if (!m_started)
+            return;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    Drain();
+}
+
+void AsyncLogger::Run()
+{
+    while (1)
+    {
+        Drain();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop)
+            break;
+        // producers never notify to keep log call cheap, so records
+        // are polled in a short period
+        m_cond.wait_for(lock, std::chrono::milliseconds(5));
+    }
+}
+
+void AsyncLogger::Drain()
+{
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+    std::vector<LogRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        rings = m_rings;
+    }
+
+    std::vector<LogRing*> closedRings;
+    std::vector<LogRing*>::iterator it;
+    for (it = rings.begin(); it != rings.end(); it++)
+    {
+        LogRing *ring = *it;
+        // the owner doesn't write any more once closed is seen
+        bool closed = ring->closed.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+        {
+            Output(&(ring->records[tail & (ASYNC_LOG_RING_SIZE - 1)]));
+            ring->tail.store(tail + 1, std::memory_order_release);
+        }
+        if (closed)
+            closedRings.push_back(ring);
+    }
+
+    if (closedRings.size())
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        for (it = closedRings.begin(); it != closedRings.end(); it++)
+        {
+            std::vector<LogRing*>::iterator itRing;
+            for (itRing = m_rings.begin(); itRing != m_rings.end(); itRing++)
+            {
+                if (*itRing == *it)
+                {
+                    m_rings.erase(itRing);
+                    break;
+                }
+            }
+            delete *it;
+        }
+    }
+}
+
+// Append one argument formatted with its specification
+static int32_t FormatOneArg(char *dst, size_t size, const LogRecord *record, const FormatSpec *spec, uint8_t argIdx)
+{
+    // integers are kept as 64 bits, so length modifier is replaced by "ll"
+    char specStr[32] = { 0 };
+    size_t specLen = spec->end - spec->begin;
+    if (specLen + 2 >= sizeof(specStr))
+        return snprintf(dst, size, "?");
+
+    size_t pos = 0;
+    for (const char *ch = spec->begin; ch < spec->end - 1; ch++)
+    {
+        if (!strchr("hlLqjzt", *ch))
+            specStr[pos++] = *ch;
+    }
+    if ((spec->type == LOG_ARG_SIGNED || spec->type == LOG_ARG_UNSIGNED) && spec->conversion != 'c')
+    {
+        specStr[pos++] = 'l';
+        specStr[pos++] = 'l';
+    }
+    specStr[pos++] = spec->conversion;
+    specStr[pos] = '\0';
+
+    int32_t stars[2] = { 0, 0 };
+    for (uint8_t idx = 0; idx < spec->starsNum; idx++)
+    {
+        stars[idx] = (int32_t)(record->args[argIdx + idx].signedValue);
+    }
+    uint8_t valueIdx = argIdx + spec->starsNum;
+
+#define FORMAT_WITH_STARS(value)                                                  \
+    ((spec->starsNum == 2) ? snprintf(dst, size, specStr, stars[0], stars[1], value) : \
+     ((spec->starsNum == 1) ? snprintf(dst, size, specStr, stars[0], value) :        \
+      snprintf(dst, size, specStr, value)))
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+    int32_t written = 0;
+    switch (spec->type)
+    {
+        case LOG_ARG_SIGNED:
+            if (spec->conversion == 'c')
+                written = FORMAT_WITH_STARS((int)(record->args[valueIdx].signedValue));
+            else
+                written = FORMAT_WITH_STARS((long long)(record->args[valueIdx].signedValue));
+            break;
+        case LOG_ARG_UNSIGNED:
+            written = FORMAT_WITH_STARS((unsigned long long)(record->args[valueIdx].unsignedValue));
+            break;
+        case LOG_ARG_DOUBLE:
+            written = FORMAT_WITH_STARS(record->args[valueIdx].doubleValue);
+            break;
+        case LOG_ARG_STRING:
+            written = FORMAT_WITH_STARS(record->strings + record->args[valueIdx].stringOffset);
+            break;
+        default:
+            written = FORMAT_WITH_STARS(record->args[valueIdx].pointerValue);
+            break;
+    }
+#pragma GCC diagnostic pop
+
+#undef FORMAT_WITH_STARS
+
+    return written;
+}
+
+// Format the record into message buffer
+static void FormatRecord(const LogRecord *record, char *msg, size_t size)
+{
+    size_t len = 0;
+    uint8_t argIdx = 0;
+    const char *pos = record->fmt;
+    while (*pos && (len + 1 < size))
+    {
+        FormatSpec spec;
+        if (*pos != '%')
+        {
+            msg[len++] = *pos++;
+            continue;
+        }
+        if (!ParseFormatSpec(pos, &spec))
+        {
+            if (*(pos + 1) == '%')
+            {
+                msg[len++] = '%';
+                pos += 2;
+            }
+            else
+            {
+                pos++;
+            }
+            continue;
+        }
+
+        int32_t written = 0;
+        if (argIdx + spec.starsNum < record->argsNum)
+        {
+            written = FormatOneArg(msg + len, size - len, record, &spec, argIdx);
+        }
+        else
+        {
+            written = snprintf(msg + len, size - len, "?");
+        }
+        argIdx += spec.starsNum + 1;
+        if (written > 0)
+        {
+            len += written;
+            if (len >= size)
+                len = size - 1;
+        }
+        pos = spec.end;
+    }
+
+    // glog appends new line for every message
+    while (len && (msg[len - 1] == '\n' || msg[len - 1] == '\r'))
+        len--;
+    msg[len] = '\0';
+}
+
+// glog stamps lines with time and thread of the background thread,
+// so time and thread of the log call are put ahead of the message
+static void GlogSink(LogLevel logLevel, const char* sourceFile, uint64_t line, uint64_t timeUs, uint32_t tid, const char* msg)
+{
+    time_t seconds = (time_t)(timeUs / 1000000);
+    struct tm localTime;
+    localtime_r(&seconds, &localTime);
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%06u %5u ",
+        localTime.tm_hour, localTime.tm_min, localTime.tm_sec, (uint32_t)(timeUs % 1000000), tid);
+
+    switch (logLevel)
+    {
+        case LOG_INFO:
+        {
+            LOG(INFO) << prefix << sourceFile << ":" << line << "  " << msg << std::endl;
+            break;
+        }
+        case LOG_WARNING:
+        {
+            LOG(WARNING) << prefix << sourceFile << ":" << line << "  " << msg << std::endl;
+            break;
+        }
+        case LOG_ERROR:
+        {
+            LOG(ERROR) << prefix << sourceFile << ":" << line << "  " << msg << std::endl;
+            break;
+        }
+        case LOG_FATAL:
+        {
+            LOG(FATAL) << prefix << sourceFile << ":" << line << "  " << msg << std::endl;
+            break;
+        }
+        default:
+        {
+            LOG(ERROR) << "Invalid log level !" << std::endl;
+            break;
+        }
+    }
+}
+
+void AsyncLogger::Output(const LogRecord *record)
+{
+    char msg[ASYNC_LOG_MSG_SIZE];
+    FormatRecord(record, msg, ASYNC_LOG_MSG_SIZE);
+
+    AsyncLogSink sink = m_sink.load(std::memory_order_acquire);
+    if (!sink)
+        sink = GlogSink;
+    sink(record->logLevel, record->sourceFile, record->line, record->timeUs, record->tid, msg);
+}
+
+// flushes the records when the library is unloaded or the process
+// exits, a handler registered with atexit() would be left dangling
+// once the library is unloaded by dlclose()
+__attribute__((destructor)) static void AsyncLogUnload()
+{
+    GetAsyncLogger()->Stop();
+}
+
+// Capture arguments according to format, only values and copies of
+// strings are kept, no formatting happens here
+static void CaptureArgs(LogRecord *record, va_list params)
+{
+    uint32_t stringsLen = 0;
+    const char *pos = record->fmt;
+    record->argsNum = 0;
+    while ((pos = strchr(pos, '%')) != NULL)
+    {
+        FormatSpec spec;
+        if (!ParseFormatSpec(pos, &spec))
+        {
+            if (*(pos + 1) == '\0')
+                break;
+            pos += 2;
+            continue;
+        }
+        pos = spec.end;
+
+        for (uint8_t idx = 0; idx < spec.starsNum; idx++)
+        {
+            int32_t star = va_arg(params, int32_t);
+            if (record->argsNum < ASYNC_LOG_MAX_ARGS)
+            {
+                record->argTypes[record->argsNum] = LOG_ARG_SIGNED;
+                record->args[record->argsNum++].signedValue = star;
+            }
+        }
+
+        if (record->argsNum >= ASYNC_LOG_MAX_ARGS)
+            break;
+
+        uint8_t argIdx = record->argsNum++;
+        record->argTypes[argIdx] = spec.type;
+        char length = GetLengthModifier(&spec);
+        switch (spec.type)
+        {
+            case LOG_ARG_SIGNED:
+                if (length == 'q')
+                    record->args[argIdx].signedValue = va_arg(params, long long);
+                else if (length == 'l')
+                    record->args[argIdx].signedValue = va_arg(params, long);
+                else
+                    record->args[argIdx].signedValue = va_arg(params, int);
+                break;
+            case LOG_ARG_UNSIGNED:
+                if (length == 'q')
+                    record->args[argIdx].unsignedValue = va_arg(params, unsigned long long);
+                else if (length == 'l')
+                    record->args[argIdx].unsignedValue = va_arg(params, unsigned long);
+                else
+                    record->args[argIdx].unsignedValue = va_arg(params, unsigned int);
+                break;
+            case LOG_ARG_DOUBLE:
+                if (length == 'L')
+                    record->args[argIdx].doubleValue = (double)va_arg(params, long double);
+                else
+                    record->args[argIdx].doubleValue = va_arg(params, double);
+                break;
+            case LOG_ARG_STRING:
+            {
+                const char *str = va_arg(params, const char*);
+                if (!str)
+                    str = "(null)";
+                record->args[argIdx].stringOffset = stringsLen;
+                while (*str && (stringsLen + 1 < ASYNC_LOG_STRING_SIZE))
+                {
+                    record->strings[stringsLen++] = *str++;
+                }
+                record->strings[stringsLen] = '\0';
+                if (stringsLen + 1 < ASYNC_LOG_STRING_SIZE)
+                    stringsLen++;
+                break;
+            }
+            default:
+                record->args[argIdx].pointerValue = va_arg(params, const void*);
+                break;
+        }
+    }
+}
+
+void AsyncLogFunction(LogLevel logLevel, const char* sourceFile, uint64_t line, const char* fmt, ...)
+{
+    if (!fmt)
+        return;
+
+    AsyncLogger *logger = GetAsyncLogger();
+    va_list params;
+    va_start(params, fmt);
+
+    if (logLevel >= LOG_FATAL || logger->IsStopped())
+    {
+        // process may abort right after fatal log, so everything is
+        // output before returning, and there is no background thread
+        // to output records after shutdown
+        LogRecord record;
+        record.fmt = fmt;
+        record.sourceFile = sourceFile;
+        record.line = line;
+        record.timeUs = GetTimeUs();
+        record.tid = GetThreadId();
+        record.logLevel = logLevel;
+        CaptureArgs(&record, params);
+        va_end(params);
+        logger->Drain();
+        logger->Output(&record);
+        return;
+    }
+
+    LogRing *ring = logger->GetThreadRing();
+    if (!ring)
+    {
+        va_end(params);
+        return;
+    }
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= ASYNC_LOG_RING_SIZE)
+    {
+        // never block the caller for logging
+        logger->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        va_end(params);
+        return;
+    }
+
+    LogRecord *record = &(ring->records[head & (ASYNC_LOG_RING_SIZE - 1)]);
+    record->fmt = fmt;
+    record->sourceFile = sourceFile;
+    record->line = line;
+    record->timeUs = GetTimeUs();
+    record->tid = ring->tid;
+    record->logLevel = logLevel;
+    CaptureArgs(record, params);
+    va_end(params);
+
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void AsyncLogFlush()
+{
+    GetAsyncLogger()->Drain();
+}
+
+void AsyncLogShutdown()
+{
+    GetAsyncLogger()->Stop();
+}
+
+void AsyncLogSetSink(AsyncLogSink sink)
+{
+    GetAsyncLogger()->m_sink.store(sink, std::memory_order_release);
+}
+
+uint64_t AsyncLogGetDroppedNum()
+{
+    return GetAsyncLogger()->m_dropped.load(std::memory_order_relaxed);
+}
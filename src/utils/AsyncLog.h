@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   AsyncLog.h
+//! \brief:  Asynchronous log backend declaration
+//! \detail: Log calls are captured as fixed size binary records, the
+//!          format pointer plus argument values, into a lock-free ring
+//!          owned by the calling thread. One background thread formats
+//!          the records and outputs them through glog, so that neither
+//!          formatting nor file output happens on the calling thread.
+//!
+//! Created on April 12, 2021, 6:04 AM
+//!
+
+#ifndef _ASYNCLOG_H_
+#define _ASYNCLOG_H_
+
+#include "Log.h"
+
+#define ASYNC_LOG_RING_SIZE    1024 //!< records number in ring of each thread, power of 2
+#define ASYNC_LOG_MAX_ARGS     6    //!< max arguments number of one record, extra ones are printed as '?'
+#define ASYNC_LOG_STRING_SIZE  96   //!< bytes to keep string arguments of one record, longer strings are truncated
+#define ASYNC_LOG_MSG_SIZE     1024 //!< max length of one formatted log message
+
+//!
+//! \brief  Output of formatted log messages
+//!
+//! \param  [in] logLevel
+//!         the level of the logging
+//! \param  [in] sourceFile
+//!         the source file name where log information comes from
+//! \param  [in] line
+//!         the line number the output log information in source file
+//! \param  [in] timeUs
+//!         the wall clock time of the log call in microseconds
+//! \param  [in] tid
+//!         the id of the thread making the log call
+//! \param  [in] msg
+//!         the formatted log message without trailing new line
+//!
+//! \return void
+//!
+typedef void (*AsyncLogSink)(LogLevel logLevel, const char* sourceFile, uint64_t line, uint64_t timeUs, uint32_t tid, const char* msg);
+
+//!
+//! \brief  Log function with the same signature as LogFunction, the
+//!         log record is queued and formatted on background thread.
+//!         Format string and source file name must be string literals
+//!         since only their pointers are kept, string arguments are
+//!         copied. LOG_FATAL is formatted and output synchronously.
+//!
+//! \param  [in] logLevel
+//!         the level of the logging
+//! \param  [in] sourceFile
+//!         the source file name where log information comes from
+//! \param  [in] line
+//!         the line number the output log information in source file
+//! \param  [in] fmt
+//!         the log informaion format, printf style
+//!
+//! \return void
+//!
+void AsyncLogFunction(LogLevel logLevel, const char* sourceFile, uint64_t line, const char* fmt, ...);
+
+//!
+//! \brief  Wait until all records queued before by any thread are
+//!         output
+//!
+//! \return void
+//!
+void AsyncLogFlush();
+
+//!
+//! \brief  Stop the background thread after all queued records are
+//!         output, records logged afterwards are output synchronously.
+//!         It is also done when the library is unloaded
+//!
+//! \return void
+//!
+void AsyncLogShutdown();
+
+//!
+//! \brief  Set the output of formatted log messages
+//!
+//! \param  [in] sink
+//!         the output function, NULL to output through glog
+//!
+//! \return void
+//!
+void AsyncLogSetSink(AsyncLogSink sink);
+
+//!
+//! \brief  Get the number of records dropped because ring of the
+//!         calling thread was full
+//!
+//! \return uint64_t
+//!         dropped records number of all threads
+//!
+uint64_t AsyncLogGetDroppedNum();
+
+#endif /* _ASYNCLOG_H_ */
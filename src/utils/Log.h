@@ -41,6 +41,15 @@
 #include <stdarg.h>
 #include <list>
 
+//!
+//! \brief  Minimum log level which is compiled in, log calls through
+//!         PRINT_LOG with lower level are eliminated at compile time,
+//!         can be set by -DOMAF_LOG_MIN_LEVEL=<0 to 3>
+//!
+#ifndef OMAF_LOG_MIN_LEVEL
+#define OMAF_LOG_MIN_LEVEL LOG_INFO
+#endif
+
 union ParamValue
 {
     char charParam;
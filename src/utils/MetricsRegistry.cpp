@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MetricsRegistry.cpp
+//! \brief:  In-process latency histograms and counters registry implementation
+//!
+//! Created on April 19, 2021, 6:04 AM
+//!
+
+#include "MetricsRegistry.h"
+#include "error.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS_NUM)
+        return (uint32_t)value;
+
+    uint64_t maxValue = ((uint64_t)1 << HISTOGRAM_MAX_VALUE_BITS) - 1;
+    if (value > maxValue)
+        value = maxValue;
+
+    // value >> shift lies in [HISTOGRAM_SUB_BUCKETS_NUM / 2, HISTOGRAM_SUB_BUCKETS_NUM)
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t shift = msb - 4;
+    uint32_t halfNum = HISTOGRAM_SUB_BUCKETS_NUM / 2;
+    return HISTOGRAM_SUB_BUCKETS_NUM + (shift - 1) * halfNum + (uint32_t)((value >> shift) - halfNum);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(uint32_t index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS_NUM)
+        return index;
+
+    uint32_t halfNum = HISTOGRAM_SUB_BUCKETS_NUM / 2;
+    uint32_t shift = (index - HISTOGRAM_SUB_BUCKETS_NUM) / halfNum + 1;
+    uint64_t sub = (index - HISTOGRAM_SUB_BUCKETS_NUM) % halfNum + halfNum;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+    m_buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t curr = m_min.load(std::memory_order_relaxed);
+    while (value < curr && !m_min.compare_exchange_weak(curr, value, std::memory_order_relaxed));
+    curr = m_max.load(std::memory_order_relaxed);
+    while (value > curr && !m_max.compare_exchange_weak(curr, value, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::GetSnapshot(HistogramSnapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+
+    memset(snapshot, 0, sizeof(HistogramSnapshot));
+
+    uint64_t counts[HISTOGRAM_BUCKETS_NUM];
+    uint64_t total = 0;
+    for (uint32_t idx = 0; idx < HISTOGRAM_BUCKETS_NUM; idx++)
+    {
+        counts[idx] = m_buckets[idx].load(std::memory_order_relaxed);
+        total += counts[idx];
+    }
+    if (!total)
+        return;
+
+    snapshot->count = total;
+    snapshot->sum = m_sum.load(std::memory_order_relaxed);
+    snapshot->min = m_min.load(std::memory_order_relaxed);
+    snapshot->max = m_max.load(std::memory_order_relaxed);
+
+    // percentile is reported as the largest value of the bucket it
+    // falls into, but never beyond the max recorded value
+    const double percentiles[4] = { 0.5, 0.9, 0.99, 0.999 };
+    uint64_t *values[4] = { &(snapshot->p50), &(snapshot->p90), &(snapshot->p99), &(snapshot->p999) };
+    uint64_t accumulated = 0;
+    uint32_t pIdx = 0;
+    for (uint32_t idx = 0; idx < HISTOGRAM_BUCKETS_NUM && pIdx < 4; idx++)
+    {
+        accumulated += counts[idx];
+        while (pIdx < 4 && accumulated >= (uint64_t)(percentiles[pIdx] * total + 0.5) && accumulated)
+        {
+            uint64_t upper = GetBucketUpperBound(idx);
+            *(values[pIdx]) = (upper < snapshot->max) ? upper : snapshot->max;
+            pIdx++;
+        }
+    }
+}
+
+void LatencyHistogram::Reset()
+{
+    for (uint32_t idx = 0; idx < HISTOGRAM_BUCKETS_NUM; idx++)
+    {
+        m_buckets[idx].store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry* MetricsRegistry::GetInstance()
+{
+    // never destroyed, so that metrics pointers cached by callers
+    // stay valid until process exits
+    static MetricsRegistry *registry = new MetricsRegistry();
+    return registry;
+}
+
+LatencyHistogram* MetricsRegistry::GetHistogram(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<LatencyHistogram> &histogram = m_histograms[name];
+    if (!histogram)
+        histogram.reset(new LatencyHistogram());
+    return histogram.get();
+}
+
+MetricsCounter* MetricsRegistry::GetCounter(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<MetricsCounter> &counter = m_counters[name];
+    if (!counter)
+        counter.reset(new MetricsCounter());
+    return counter.get();
+}
+
+void MetricsRegistry::GetHistogramSnapshot(const std::string &name, HistogramSnapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, std::unique_ptr<LatencyHistogram>>::iterator it = m_histograms.find(name);
+    if (it == m_histograms.end())
+    {
+        memset(snapshot, 0, sizeof(HistogramSnapshot));
+        return;
+    }
+    it->second->GetSnapshot(snapshot);
+}
+
+uint64_t MetricsRegistry::GetCounterValue(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<std::string, std::unique_ptr<MetricsCounter>>::iterator it = m_counters.find(name);
+    if (it == m_counters.end())
+        return 0;
+    return it->second->Get();
+}
+
+std::string MetricsRegistry::Dump(MetricsFormat format)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::stringstream ss;
+
+    if (format == METRICS_FORMAT_PROMETHEUS)
+    {
+        for (auto &counter : m_counters)
+        {
+            ss << "# TYPE " << counter.first << " counter\n";
+            ss << counter.first << " " << counter.second->Get() << "\n";
+        }
+        for (auto &histogram : m_histograms)
+        {
+            HistogramSnapshot snapshot;
+            histogram.second->GetSnapshot(&snapshot);
+            ss << "# TYPE " << histogram.first << " summary\n";
+            ss << histogram.first << "{quantile=\"0.5\"} " << snapshot.p50 << "\n";
+            ss << histogram.first << "{quantile=\"0.9\"} " << snapshot.p90 << "\n";
+            ss << histogram.first << "{quantile=\"0.99\"} " << snapshot.p99 << "\n";
+            ss << histogram.first << "{quantile=\"0.999\"} " << snapshot.p999 << "\n";
+            ss << histogram.first << "_sum " << snapshot.sum << "\n";
+            ss << histogram.first << "_count " << snapshot.count << "\n";
+        }
+        return ss.str();
+    }
+
+    uint64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    ss << "{\n  \"timestamp_ms\": " << timeMs << ",\n  \"counters\": {";
+    bool first = true;
+    for (auto &counter : m_counters)
+    {
+        ss << (first ? "\n" : ",\n") << "    \"" << counter.first << "\": " << counter.second->Get();
+        first = false;
+    }
+    ss << (first ? "},\n" : "\n  },\n") << "  \"histograms\": {";
+    first = true;
+    for (auto &histogram : m_histograms)
+    {
+        HistogramSnapshot snapshot;
+        histogram.second->GetSnapshot(&snapshot);
+        ss << (first ? "\n" : ",\n") << "    \"" << histogram.first << "\": {";
+        ss << "\"count\": " << snapshot.count << ", \"sum\": " << snapshot.sum;
+        ss << ", \"min\": " << snapshot.min << ", \"max\": " << snapshot.max;
+        ss << ", \"p50\": " << snapshot.p50 << ", \"p90\": " << snapshot.p90;
+        ss << ", \"p99\": " << snapshot.p99 << ", \"p999\": " << snapshot.p999 << "}";
+        first = false;
+    }
+    ss << (first ? "}\n}\n" : "\n  }\n}\n");
+    return ss.str();
+}
+
+int32_t MetricsRegistry::DumpToFile(const std::string &path, MetricsFormat format)
+{
+    if (path.empty())
+        return ERROR_INVALID;
+
+    std::string content = Dump(format);
+    std::string tmpPath = path + ".tmp";
+    FILE *fp = fopen(tmpPath.c_str(), "w");
+    if (!fp)
+        return OMAF_FILE_OPEN_ERROR;
+
+    size_t written = fwrite(content.c_str(), 1, content.size(), fp);
+    fclose(fp);
+    if (written != content.size())
+    {
+        remove(tmpPath.c_str());
+        return OMAF_ERROR_FILE_WRITE;
+    }
+
+    if (rename(tmpPath.c_str(), path.c_str()))
+    {
+        remove(tmpPath.c_str());
+        return OMAF_ERROR_FILE_WRITE;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t MetricsRegistry::StartPeriodicDump(const std::string &path, uint32_t periodMs, MetricsFormat format)
+{
+    if (path.empty() || !periodMs)
+        return ERROR_INVALID;
+
+    StopPeriodicDump();
+
+    std::lock_guard<std::mutex> lock(m_dumpMutex);
+    m_dumpPath = path;
+    m_dumpPeriodMs = periodMs;
+    m_dumpFormat = format;
+    m_dumpStop = false;
+    m_dumpThread = std::thread(&MetricsRegistry::DumpThread, this);
+
+    return ERROR_NONE;
+}
+
+void MetricsRegistry::StopPeriodicDump()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_dumpMutex);
+        if (!m_dumpThread.joinable())
+            return;
+        m_dumpStop = true;
+    }
+    m_dumpCond.notify_all();
+    m_dumpThread.join();
+}
+
+void MetricsRegistry::DumpThread()
+{
+    std::unique_lock<std::mutex> lock(m_dumpMutex);
+    while (1)
+    {
+        bool stop = m_dumpCond.wait_for(lock, std::chrono::milliseconds(m_dumpPeriodMs), [this] { return m_dumpStop; });
+
+        // the dump file is only touched by this thread
+        std::string path = m_dumpPath;
+        MetricsFormat format = m_dumpFormat;
+        lock.unlock();
+        DumpToFile(path, format);
+        lock.lock();
+
+        if (stop)
+            break;
+    }
+}
+
+void MetricsRegistry::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &counter : m_counters)
+    {
+        counter.second->Reset();
+    }
+    for (auto &histogram : m_histograms)
+    {
+        histogram.second->Reset();
+    }
+}
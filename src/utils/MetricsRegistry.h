@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2021, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MetricsRegistry.h
+//! \brief:  In-process latency histograms and counters registry
+//! \detail: Histograms use HDR style log-linear buckets, every bucket
+//!          and counter is one atomic integer, so that recording costs
+//!          a few relaxed atomic operations and never locks. Snapshots
+//!          can be dumped as JSON or Prometheus text format, on demand
+//!          or periodically into a file.
+//!
+//! Created on April 19, 2021, 6:04 AM
+//!
+
+#ifndef _METRICSREGISTRY_H_
+#define _METRICSREGISTRY_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common_data.h"
+
+#define HISTOGRAM_SUB_BUCKETS_NUM  32  //!< linear sub buckets in each power of 2 range, about 3% precision
+#define HISTOGRAM_MAX_VALUE_BITS   40  //!< values larger than 2^40 are clamped
+#define HISTOGRAM_BUCKETS_NUM      (HISTOGRAM_SUB_BUCKETS_NUM + (HISTOGRAM_MAX_VALUE_BITS - 5) * (HISTOGRAM_SUB_BUCKETS_NUM / 2))
+
+//!
+//! \struct: HistogramSnapshot
+//! \brief:  summary of one latency histogram
+//!
+typedef struct HistogramSnapshot
+{
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+}HistogramSnapshot;
+
+//!
+//! \class LatencyHistogram
+//! \brief Lock-free histogram of latency values
+//!
+class LatencyHistogram
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    LatencyHistogram();
+
+    //!
+    //! \brief  Destructor
+    //!
+    ~LatencyHistogram() {};
+
+    //!
+    //! \brief  Record one value, thread safe
+    //!
+    //! \param  [in] value
+    //!         the value to record, normally in microsecond
+    //!
+    //! \return void
+    //!
+    void Record(uint64_t value);
+
+    //!
+    //! \brief  Get the summary of all recorded values, thread safe
+    //!         but not atomic as a whole against concurrent Record
+    //!
+    //! \param  [out] snapshot
+    //!         pointer to the summary
+    //!
+    //! \return void
+    //!
+    void GetSnapshot(HistogramSnapshot *snapshot);
+
+    //!
+    //! \brief  Clear all recorded values
+    //!
+    //! \return void
+    //!
+    void Reset();
+
+    //!
+    //! \brief  Get the bucket index of specified value
+    //!
+    //! \param  [in] value
+    //!         the value
+    //!
+    //! \return uint32_t
+    //!         the bucket index
+    //!
+    static uint32_t GetBucketIndex(uint64_t value);
+
+    //!
+    //! \brief  Get the largest value falling into specified bucket
+    //!
+    //! \param  [in] index
+    //!         the bucket index
+    //!
+    //! \return uint64_t
+    //!         the largest value of the bucket
+    //!
+    static uint64_t GetBucketUpperBound(uint32_t index);
+
+private:
+    std::atomic<uint64_t> m_buckets[HISTOGRAM_BUCKETS_NUM];
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+//!
+//! \class MetricsCounter
+//! \brief Lock-free monotonic counter
+//!
+class MetricsCounter
+{
+public:
+    MetricsCounter() : m_value(0) {};
+
+    ~MetricsCounter() {};
+
+    void Add(uint64_t value) { m_value.fetch_add(value, std::memory_order_relaxed); };
+
+    uint64_t Get() { return m_value.load(std::memory_order_relaxed); };
+
+    void Reset() { m_value.store(0, std::memory_order_relaxed); };
+
+private:
+    std::atomic<uint64_t> m_value;
+};
+
+//!
+//! \class MetricsRegistry
+//! \brief Process wide registry of named histograms and counters,
+//!        metrics are created on first use and never destroyed, so
+//!        callers can keep the returned pointers, for example in a
+//!        function local static variable
+//!
+class MetricsRegistry
+{
+public:
+    //!
+    //! \brief  Get the process wide registry
+    //!
+    //! \return MetricsRegistry*
+    //!         the registry
+    //!
+    static MetricsRegistry* GetInstance();
+
+    //!
+    //! \brief  Get or create the histogram with specified name
+    //!
+    //! \param  [in] name
+    //!         metric name, Prometheus naming rules apply
+    //!
+    //! \return LatencyHistogram*
+    //!         the histogram
+    //!
+    LatencyHistogram* GetHistogram(const std::string &name);
+
+    //!
+    //! \brief  Get or create the counter with specified name
+    //!
+    //! \param  [in] name
+    //!         metric name, Prometheus naming rules apply
+    //!
+    //! \return MetricsCounter*
+    //!         the counter
+    //!
+    MetricsCounter* GetCounter(const std::string &name);
+
+    //!
+    //! \brief  Get the summary of the histogram with specified
+    //!         name, all zero if it doesn't exist
+    //!
+    //! \return void
+    //!
+    void GetHistogramSnapshot(const std::string &name, HistogramSnapshot *snapshot);
+
+    //!
+    //! \brief  Get the value of the counter with specified name,
+    //!         0 if it doesn't exist
+    //!
+    //! \return uint64_t
+    //!
+    uint64_t GetCounterValue(const std::string &name);
+
+    //!
+    //! \brief  Dump all metrics as text
+    //!
+    //! \param  [in] format
+    //!         the text format
+    //!
+    //! \return std::string
+    //!         the dumped text
+    //!
+    std::string Dump(MetricsFormat format);
+
+    //!
+    //! \brief  Dump all metrics into file, the file is replaced
+    //!         atomically so that readers never see partial content
+    //!
+    //! \param  [in] path
+    //!         the file path
+    //! \param  [in] format
+    //!         the text format
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t DumpToFile(const std::string &path, MetricsFormat format);
+
+    //!
+    //! \brief  Start dumping all metrics into file periodically
+    //!         on a background thread, replacing previous setting
+    //!
+    //! \param  [in] path
+    //!         the file path
+    //! \param  [in] periodMs
+    //!         dump period in millisecond
+    //! \param  [in] format
+    //!         the text format
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t StartPeriodicDump(const std::string &path, uint32_t periodMs, MetricsFormat format);
+
+    //!
+    //! \brief  Stop periodic dump, the file is dumped one last time
+    //!
+    //! \return void
+    //!
+    void StopPeriodicDump();
+
+    //!
+    //! \brief  Clear values of all metrics
+    //!
+    //! \return void
+    //!
+    void Reset();
+
+private:
+    MetricsRegistry() : m_dumpPeriodMs(0), m_dumpFormat(METRICS_FORMAT_JSON), m_dumpStop(false) {};
+
+    ~MetricsRegistry() {};
+
+    void DumpThread();
+
+    std::mutex                                                m_mutex;      //!< protects creation and iteration of metrics
+    std::map<std::string, std::unique_ptr<LatencyHistogram>>  m_histograms;
+    std::map<std::string, std::unique_ptr<MetricsCounter>>    m_counters;
+
+    std::mutex                                                m_dumpMutex;
+    std::condition_variable                                   m_dumpCond;
+    std::thread                                               m_dumpThread;
+    std::string                                               m_dumpPath;
+    uint32_t                                                  m_dumpPeriodMs;
+    MetricsFormat                                         m_dumpFormat;
+    bool                                                      m_dumpStop;
+};
+
+//!
+//! \brief  Get microseconds elapsed since specified time point
+//!
+inline uint64_t MetricsElapsedUs(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif /* _METRICSREGISTRY_H_ */
@@ -44,6 +44,7 @@ extern "C" {
 #include <stdio.h>
 #include <string.h>
 #include "360SCVPAPI.h"
+#include "common_data.h"
 
 //!
 //! \enum:  MediaType
@@ -80,6 +81,17 @@ typedef enum
     E_CHUNKINFO_SIDX_AND_CLOC,
 }E_ChunkInfoType;
 
+//!
+//! \enum:  E_FrameQueuePolicy
+//! \brief: policy when frame queue of one video stream is full
+//!
+typedef enum
+{
+    E_FRAME_QUEUE_BLOCK = 0,       //wait until segmentation consumes one frame
+    E_FRAME_QUEUE_NONBLOCK,        //return OMAF_ERROR_FRAME_QUEUE_FULL and the frame isn't queued
+    E_FRAME_QUEUE_DROP_OLDEST,     //drop the oldest queued frame to accept the new one
+}E_FrameQueuePolicy;
+
 //!
 //! \struct: Rational
 //! \brief:  rational definition
@@ -161,6 +173,11 @@ typedef struct SegmentationInfo
     int32_t       splitTile;
     bool          hasMainAS;
     E_ChunkInfoType chunkInfoType;    //whether to enable 'sidx' and 'cloc' in segment, effective depending on 'cmafEnabled' in structure 'InitialInfo'
+    int32_t       segWorkersNum;    //workers number for extractor tracks segmentation, 0 means derived from 'extractorTracksPerSegThread'
+    int32_t       pipelineDepth;    //max number of frames NAL parsed ahead of segmentation, 0 means parsing and segmentation run serially
+    bool          directIO;         //whether to write segment files with O_DIRECT and preallocated file space, default is false
+    int32_t       frameQueueDepth;  //max number of frames queued for each video stream before segmentation, 0 means unbounded
+    E_FrameQueuePolicy frameQueuePolicy; //what to do when frame queue is full, effective when 'frameQueueDepth' isn't 0
 }SegmentationInfo;
 
 //!
@@ -242,6 +259,53 @@ typedef struct FrameBSInfo
     bool     isKeyFrame;
 }FrameBSInfo;
 
+//!
+//! \brief: callback to return the frame bitstream buffer to its
+//!          owner once the frame isn't used by the library any more
+//!
+typedef void (*FrameReleaseCallback)(uint8_t *data, void *opaque);
+
+//!
+//! \struct: FrameQueueStats
+//! \brief:  statistics of the frame queue of one video stream
+//!
+typedef struct FrameQueueStats
+{
+    uint32_t depth;           //frames number currently queued
+    uint32_t maxDepth;        //max frames number ever queued
+    uint32_t capacity;        //max frames number can be queued, 0 means unbounded
+    uint64_t queuedFrames;    //total frames number accepted into the queue
+    uint64_t droppedFrames;   //frames dropped by E_FRAME_QUEUE_DROP_OLDEST
+    uint64_t rejectedFrames;  //frames rejected by E_FRAME_QUEUE_NONBLOCK
+    uint64_t blockedTimeUs;   //total time in microsecond writers are blocked by E_FRAME_QUEUE_BLOCK
+}FrameQueueStats;
+
+//!
+//! \struct: LatencyStats
+//! \brief:  summary of one latency histogram, in microsecond,
+//!          percentiles are accurate to about 3%
+//!
+typedef struct LatencyStats
+{
+    uint64_t count;
+    uint64_t avgUs;
+    uint64_t p50Us;
+    uint64_t p90Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+}LatencyStats;
+
+//!
+//! \struct: PackingStatistic
+//! \brief:  always-on packing metrics of the process
+//!
+typedef struct PackingStatistic
+{
+    LatencyStats frameToSegment;  //latency from video frame input to the segment containing it written
+    uint64_t     framesIn;        //video frames accepted
+    uint64_t     segmentsWritten; //video segments written
+}PackingStatistic;
+
 #ifdef __cplusplus
 }
 #endif
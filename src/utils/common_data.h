@@ -31,6 +31,9 @@
 //! Created on April 30, 2019, 6:04 AM
 //!
 
+#ifndef _COMMON_DATA_H_
+#define _COMMON_DATA_H_
+
 #include <stdint.h>
 
 typedef enum
@@ -42,3 +45,15 @@ typedef enum
 }LogLevel;
 
 typedef void (*LogFunction)(LogLevel logLevel, const char* sourceFile, uint64_t line, const char* fmt, ...);
+
+//!
+//! \enum:  MetricsFormat
+//! \brief: text format of the metrics dump
+//!
+typedef enum
+{
+    METRICS_FORMAT_JSON = 0,
+    METRICS_FORMAT_PROMETHEUS,
+}MetricsFormat;
+
+#endif /* _COMMON_DATA_H_ */
@@ -36,6 +36,7 @@
 
 #include <stdint.h>
 #include "360SCVPAPI.h"
+#include "common_data.h"
 #include "ns_def.h"
 
 #ifdef __cplusplus
@@ -108,13 +109,53 @@ typedef struct ProducerReferenceTime {
   uint32_t mediaTime;
 } ProducerReferenceTime;
 
+/*
+ * summary of one latency histogram, values in microsecond, percentiles
+ * are accurate to about 3%
+ */
+typedef struct LATENCYSTATISTIC {
+  uint64_t count;
+  uint64_t avg_us;
+  uint64_t p50_us;
+  uint64_t p90_us;
+  uint64_t p99_us;
+  uint64_t max_us;
+} LatencyStatistic;
+
 /*
  * avg_bandwidth : average bandwidth since the begin of downloading
  * immediate_bandwidth: immediate bandwidth at the moment
+ * download_latency : latency of segment downloads in the process
+ * parse_latency : latency of segment parsing in the process
+ * stitch_latency : latency from tiles stitching woken up by ready tile
+ *                  packets to merged packets output in the process
+ * merge_time : time spent in merging tiles of one frame in the process
+ * packet_out_latency : latency of packets output in the process
+ * downloaded_segments : segments downloaded successfully in the process
+ * downloaded_bytes : bytes of segments downloaded successfully in the process
+ * download_failures : segment downloads failed or timed out in the process
+ * output_packets : packets output in the process
+ * cache_hits : segments read from the download cache instead of downloaded
+ * cache_misses : segments looked up but not found in the download cache
+ * cache_hit_rate : cache_hits / (cache_hits + cache_misses)
+ * cache_saved_bytes : bytes of segments read from the download cache
  */
 typedef struct DASHSTATISTICINFO {
   int32_t avg_bandwidth;
   int32_t immediate_bandwidth;
+  LatencyStatistic download_latency;
+  LatencyStatistic parse_latency;
+  LatencyStatistic stitch_latency;
+  LatencyStatistic merge_time;
+  LatencyStatistic packet_out_latency;
+  uint64_t downloaded_segments;
+  uint64_t downloaded_bytes;
+  uint64_t download_failures;
+  uint64_t output_packets;
+  uint64_t cache_hits;
+  uint64_t cache_misses;
+  float cache_hit_rate;
+  uint64_t cache_saved_bytes;
 } DashStatisticInfo;
 
 /*
@@ -170,6 +211,9 @@ typedef struct DASHMEDIAINFO {
   DashStreamInfo stream_info[16];
 } DashMediaInfo;
 
+//!< zeroed bytes behind DashPacket buf when it carries a release callback
+#define DASH_PACKET_PADDING_SIZE 64
+
 typedef struct DASHPACKET {
   uint32_t videoID;
   Codec_Type video_codec;
@@ -189,6 +233,8 @@ typedef struct DASHPACKET {
   bool bCatchup;
   int32_t hViewID;                  //!< horizontal view id
   int32_t vViewID;                  //!< vertical view id
+  void (*release)(void* opaque, uint8_t* data);  //!< releases buf if set, or buf is freed with free()
+  void* opaque;                     //!< the opaque passed to release
 } DashPacket;
 
 typedef enum {
@@ -114,6 +114,7 @@ typedef int OMAF_STATUS;
 #define OMAF_ERROR_INVALID_CODEC                 -107
 #define OMAF_ERROR_TIMED_OUT                     -108
 #define OMAF_ERROR_NO_PLUGIN_SET                 -109
+#define OMAF_ERROR_FRAME_QUEUE_FULL              -110
 #define SCVP_ERROR_PLUGIN_NOEXIST                -200
 #define OMAF_ERROR_REALPATH_FAILED               -201
 #endif /* ERROR_H */